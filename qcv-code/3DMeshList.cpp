@@ -105,7 +105,7 @@ C3DMeshList::clear ()
     for (std::vector< SMeshData >::const_iterator m = m_mesh_v.begin(); 
          m != last; ++m )
         if (m->created_b)
-            glDeleteLists( m->displayList_ui, 1 );
+            m_deletedLists_v.push_back ( m->displayList_ui );
     
     m_mesh_v.clear();
     return m_mesh_v.empty();
@@ -115,6 +115,11 @@ C3DMeshList::clear ()
 bool
 C3DMeshList::show () 
 {
+    for (unsigned int i = 0; i < m_deletedLists_v.size(); ++i)
+        glDeleteLists( m_deletedLists_v[i], 1 );
+
+    m_deletedLists_v.clear();
+
     std::vector< SMeshData >::iterator last = m_mesh_v.end();
 
     for (std::vector< SMeshData >::iterator m = m_mesh_v.begin(); 
@@ -112,6 +112,10 @@ namespace QCV
     /// Private Members
     private:
         std::vector<SMeshData>    m_mesh_v;
+
+        /// Display lists of cleared meshes. clear() might be called
+        /// without GL context, so they are deleted at the next show().
+        std::vector<unsigned int> m_deletedLists_v;
     };
 } // Namespace QCV
 
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose.
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+#ifndef __3DVIEWERBASE_H
+#define __3DVIEWERBASE_H
+
+/**
+ *******************************************************************************
+ *
+ * @file 3DViewerBase.h
+ *
+ * \class C3DViewerBase
+ * \author Hernan Badino (hernan.badino@gmail.com)
+ *
+ * \brief Drawing interface of the 3D viewer for the operators.
+ *
+ * The operators draw 3D points, lines and meshes through this interface,
+ * so that they do not depend on QGLViewer. CGLViewer implements it.
+ *
+ *******************************************************************************/
+
+/* INCLUDES */
+#include <opencv/cv.h>
+
+#include "3DRowVector.h"
+#include "colors.h"
+
+namespace QCV
+{
+    class C3DViewerBase
+    {
+    public:
+        C3DViewerBase() {}
+        virtual ~C3DViewerBase() {}
+
+    public:
+        /// Clear the list of drawings.
+        virtual void           clear () = 0;
+
+        /// Add a 3D point.
+        virtual void           addPoint ( const C3DVector  f_point,
+                                          const SRgb       f_color  = SRgb ( 255, 255, 255 ),
+                                          const float      f_size_f = -1.f,
+                                          const C3DVector  f_normal = C3DVector (0,0,0) ) = 0;
+
+        /// Add a 3D line.
+        virtual void           addLine  ( const C3DVector   f_point1,
+                                          const C3DVector   f_point2,
+                                          const SRgb        f_color  = SRgb ( 255, 255, 255 ),
+                                          const float       f_lineWidth_f = -1.f ) = 0;
+
+        /// Add a 3D mesh.
+        virtual void           addMesh ( cv::Mat     f_vectorImg,
+                                         cv::Mat     f_dispTexture,
+                                         const float f_maxDist_f,
+                                         const float f_maxInvDist_f  ) = 0;
+
+        virtual bool           setBackgroundColor ( SRgb f_bgColor ) = 0;
+        virtual SRgb           getBackgroundColor (  ) const = 0;
+
+        virtual bool           setPointSize ( float f_pointSize_f ) = 0;
+        virtual float          getPointSize (  ) const = 0;
+
+        virtual bool           setLineWidth ( float f_lineWidth_f ) = 0;
+        virtual float          getLineWidth (  ) const = 0;
+    };
+}
+
+
+#endif // __3DVIEWERBASE_H
@@ -29,23 +29,32 @@
 
 /* INCLUDES */
 #include "clock.h"
+#include "clockHandler.h"
 #include <stdio.h>
 
+#include <QtCore/QElapsedTimer>
+
 using namespace QCV;
 
-//// OpenMP includes.
-#if defined ( _OPENMP )
-#include <omp.h>
-#else
-#include <time.h>
-#endif
+namespace
+{
+    QElapsedTimer startedTimer ( )
+    {
+        QElapsedTimer timer;
+        timer.start();
+        return timer;
+    }
+}
 
 CClock::CClock (  std::string f_name_str )
         : m_on_b (                      false ),
           m_name_str (             f_name_str ),
           m_count_ui (                      0 ),
           m_totalTime_d (                  0. ),
-          m_startTime_d (                   0 )
+          m_startTime_d (                   0 ),
+          m_histogram (                         ),
+          m_handler_p (                  NULL ),
+          m_path_str (                        )
 {
 }
 
@@ -61,11 +70,7 @@ CClock::start()
     }
     m_on_b = true;
     
-#if defined ( _OPENMP )
-    m_startTime_d = omp_get_wtime();
-#else    
-    m_startTime_d = clock();
-#endif
+    m_startTime_d = getTime();
 }
 
 /// Stop measuring.
@@ -79,19 +84,18 @@ CClock::stop()
         return;
     }
 
-    double cycleTime_d;
-
-#if defined ( _OPENMP )
-    cycleTime_d = (omp_get_wtime() - m_startTime_d)*1000;
-#else    
-    cycleTime_d = (clock() - m_startTime_d)*(1000./(double)(CLOCKS_PER_SEC));
-#endif
+    double cycleTime_d = getTime() - m_startTime_d;
 
     m_totalTime_d += cycleTime_d;
     ++m_count_ui;
 
+    m_histogram.add ( cycleTime_d );
+
     m_on_b = false;
 
+    if ( m_handler_p && m_handler_p -> isTracing() )
+        m_handler_p -> addTraceEvent ( this, m_startTime_d, cycleTime_d );
+
 }
 
 /// Reset Clock.
@@ -102,6 +106,8 @@ CClock::reset()
     m_count_ui     = 0 ;
     m_totalTime_d  = 0. ;
     m_startTime_d  = 0 ;
+
+    m_histogram.clear();
 }
 
 
@@ -133,6 +139,78 @@ CClock::getLoopTime() const
     return m_totalTime_d/m_count_ui;
 }
 
+/// Get minimal measured time.
+double
+CClock::getMinTime() const
+{
+    return m_histogram.getMin();
+}
+
+/// Get maximal measured time.
+double
+CClock::getMaxTime() const
+{
+    return m_histogram.getMax();
+}
+
+/// Get last measured time.
+double
+CClock::getLastTime() const
+{
+    return m_histogram.getLast();
+}
+
+/// Get time under which the given percentage of the measurements are.
+double
+CClock::getPercentile ( double f_percent_d ) const
+{
+    return m_histogram.getPercentile ( f_percent_d );
+}
+
+/// Get histogram of the measured times.
+const CLatencyHistogram &
+CClock::getHistogram() const
+{
+    return m_histogram;
+}
+
+/// Set handler.
+void
+CClock::setHandler ( CClockHandler * f_handler_p )
+{
+    m_handler_p = f_handler_p;
+}
+
+/// Get handler.
+CClockHandler *
+CClock::getHandler() const
+{
+    return m_handler_p;
+}
+
+/// Set path of the operator owning the clock.
+void
+CClock::setPath ( const std::string & f_path_str )
+{
+    m_path_str = f_path_str;
+}
+
+/// Get path of the operator owning the clock.
+std::string
+CClock::getPath() const
+{
+    return m_path_str;
+}
+
+/// Monotonic wall time in ms since the first call.
+double
+CClock::getTime()
+{
+    static const QElapsedTimer timer = startedTimer();
+
+    return timer.nsecsElapsed() / 1.e6;
+}
+
 /// Print
 void
 CClock::print() const
@@ -36,6 +36,7 @@
 
 /* INCLUDES */
 #include "clock.h"
+#include "latencyHistogram.h"
 
 #include <vector>
 #include <string>
@@ -45,6 +46,8 @@
 
 namespace QCV
 {
+    class CClockHandler;
+
     class CClock
     {
     /// Data types
@@ -85,6 +88,37 @@ namespace QCV
 
         /// Get loop time.
         double        getLoopTime() const;
+
+        /// Get minimal measured time.
+        double        getMinTime() const;
+
+        /// Get maximal measured time.
+        double        getMaxTime() const;
+
+        /// Get last measured time.
+        double        getLastTime() const;
+
+        /// Get time under which the given percentage of the
+        /// measurements are (approximated to 1/64 of the time).
+        double        getPercentile ( double f_percent_d ) const;
+
+        /// Get histogram of the measured times.
+        const CLatencyHistogram & getHistogram() const;
+
+        /// Set handler that records the measurements when tracing.
+        void          setHandler ( CClockHandler * f_handler_p );
+
+        /// Get handler.
+        CClockHandler * getHandler() const;
+
+        /// Set path of the operator owning the clock.
+        void          setPath ( const std::string & f_path_str );
+
+        /// Get path of the operator owning the clock.
+        std::string   getPath() const;
+
+        /// Monotonic wall time in ms.
+        static double getTime();
         
     /// Print
     public:
@@ -109,6 +143,39 @@ namespace QCV
 
         /// Total current time.
         double       m_startTime_d;
+
+        /// Histogram of the measured times.
+        CLatencyHistogram m_histogram;
+
+        /// Handler (NULL if the measurements are not traced).
+        CClockHandler * m_handler_p;
+
+        /// Path of the operator owning the clock.
+        std::string  m_path_str;
+    };
+
+    /// Starts a clock on construction and stops it when the scope is
+    /// left. A NULL clock is ignored.
+    class CScopedClock
+    {
+    public:
+        explicit CScopedClock ( CClock * f_clock_p )
+                : m_clock_p ( f_clock_p )
+        {
+            if ( m_clock_p ) m_clock_p -> start();
+        }
+
+        ~CScopedClock ( )
+        {
+            if ( m_clock_p ) m_clock_p -> stop();
+        }
+
+    private:
+        /// Not copyable.
+        CScopedClock ( const CScopedClock & );
+        CScopedClock & operator = ( const CScopedClock & );
+
+        CClock *     m_clock_p;
     };
 }
 
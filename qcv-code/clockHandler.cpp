@@ -32,14 +32,57 @@
 #include "clockHandler.h"
 #include "clockTreeNode.h"
 #include <stdio.h>
+#include <algorithm>
+
+#include <QtCore/QMutexLocker>
 
 #define MAX_CONTAINER_LEVELS 256
 
 using namespace QCV;
 
+namespace
+{
+    /// Write a string as JSON string.
+    void writeJsonString ( FILE * f_file_p, const std::string & f_str )
+    {
+        fputc ( '"', f_file_p );
+
+        for (unsigned int i = 0; i < f_str.size(); ++i)
+        {
+            const unsigned char c = f_str[i];
+
+            if ( c == '"' || c == '\\' )
+                fprintf ( f_file_p, "\\%c", c );
+            else if ( c < 0x20 )
+                fprintf ( f_file_p, "\\u%04x", c );
+            else
+                fputc ( c, f_file_p );
+        }
+
+        fputc ( '"', f_file_p );
+    }
+
+    /// Collect the clocks of a node and its children in tree order.
+    void collectClocks ( const CClockOpNode *         f_node_p,
+                         std::vector<const CClock *> & fr_clocks_v )
+    {
+        for (unsigned int i = 0; i < f_node_p -> getClockCount(); ++i)
+            fr_clocks_v.push_back ( f_node_p -> getClockChild ( i ) -> getClock() );
+
+        for (unsigned int i = 0; i < f_node_p -> getOpCount(); ++i)
+            collectClocks ( f_node_p -> getOpChild ( i ), fr_clocks_v );
+    }
+}
+
 CClockHandler::CClockHandler( CNode * f_root_p )
         : m_root_p (                NULL ),
-          m_clockChanged_b (       false )
+          m_clockChanged_b (       false ),
+          m_tracing_b (            false ),
+          m_traceCapacity_ui (         0 ),
+          m_frame_i (                 -1 ),
+          m_traceFile_str (              ),
+          m_traceBuffers_v (             ),
+          m_threadBuffer (               )
 {
     if ( f_root_p )
     {
@@ -51,7 +94,13 @@ CClockHandler::CClockHandler( CNode * f_root_p )
 
 CClockHandler::~CClockHandler()
 {
+    if ( !m_traceFile_str.empty() )
+        writeTrace ( m_traceFile_str );
+
     delete m_root_p;    
+
+    for (unsigned int i = 0; i < m_traceBuffers_v.size(); ++i)
+        delete m_traceBuffers_v[i];
 }
 
 
@@ -61,6 +110,8 @@ CClockHandler::getClock ( std::string  f_name_str,
 {
     if (not f_op_p) return NULL;
 
+    QMutexLocker locker ( &m_mutex );
+
     CNode *  ops_p[MAX_CONTAINER_LEVELS];
     int level_i;
 
@@ -84,6 +135,8 @@ CClockHandler::getClock ( std::string  f_name_str,
 
     --level_i;
 
+    const int topLevel_i = level_i;
+
     //printf("ops_p->name = %s level_i = %i\n", ops_p[level_i]->getName().c_str(), level_i);
     
     if ( not m_root_p )
@@ -121,6 +174,14 @@ CClockHandler::getClock ( std::string  f_name_str,
     {
         CClock * clock_p = new CClock ( f_name_str );
         child_p          = new CClockNode ( clock_p );
+
+        std::string path_str = ops_p[topLevel_i] -> getName();
+
+        for (int i = topLevel_i - 1; i >= 0; --i)
+            path_str += "/" + ops_p[i] -> getName();
+
+        clock_p -> setPath ( path_str );
+        clock_p -> setHandler ( this );
         
         node_p -> appendChild ( child_p );
         return clock_p;
@@ -128,3 +189,212 @@ CClockHandler::getClock ( std::string  f_name_str,
 
      return child_p -> getClock();
 }
+
+void
+CClockHandler::startTracing ( unsigned int f_capacity_ui )
+{
+    QMutexLocker locker ( &m_mutex );
+
+    m_traceCapacity_ui = std::max ( f_capacity_ui, 1u );
+
+    for (unsigned int i = 0; i < m_traceBuffers_v.size(); ++i)
+    {
+        m_traceBuffers_v[i] -> events_v.resize ( m_traceCapacity_ui );
+        m_traceBuffers_v[i] -> written_ui = 0;
+    }
+
+    m_tracing_b = true;
+}
+
+void
+CClockHandler::stopTracing ( )
+{
+    m_tracing_b = false;
+}
+
+void
+CClockHandler::setTraceFile ( const std::string & f_fileName_str )
+{
+    m_traceFile_str = f_fileName_str;
+}
+
+CClockHandler::STraceBuffer *
+CClockHandler::getTraceBuffer ( )
+{
+    STraceBufferRef * ref_p = m_threadBuffer.localData();
+
+    if ( !ref_p )
+    {
+        /// First event of this thread.
+        QMutexLocker locker ( &m_mutex );
+
+        ref_p = new STraceBufferRef;
+        ref_p -> buffer_p = new STraceBuffer;
+        ref_p -> buffer_p -> events_v.resize ( m_traceCapacity_ui );
+        ref_p -> buffer_p -> written_ui = 0;
+        ref_p -> buffer_p -> thread_i   = m_traceBuffers_v.size();
+
+        m_traceBuffers_v.push_back ( ref_p -> buffer_p );
+        m_threadBuffer.setLocalData ( ref_p );
+    }
+
+    return ref_p -> buffer_p;
+}
+
+void
+CClockHandler::addTraceEvent ( const CClock * f_clock_p,
+                               double         f_start_d,
+                               double         f_duration_d )
+{
+    STraceBuffer * buffer_p = getTraceBuffer();
+
+    STraceEvent & event = buffer_p -> events_v[buffer_p -> written_ui % buffer_p -> events_v.size()];
+
+    event.clock_p    = f_clock_p;
+    event.start_d    = f_start_d;
+    event.duration_d = f_duration_d;
+    event.frame_i    = m_frame_i;
+
+    ++buffer_p -> written_ui;
+}
+
+bool
+CClockHandler::writeTrace ( const std::string & f_fileName_str )
+{
+    QMutexLocker locker ( &m_mutex );
+
+    FILE * file_p = fopen ( f_fileName_str.c_str(), "w" );
+
+    if ( !file_p )
+    {
+        printf("%s:%i Trace file %s could not be opened\n", 
+               __FILE__, __LINE__, f_fileName_str.c_str());
+        return false;
+    }
+
+    fprintf ( file_p, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[" );
+
+    bool first_b = true;
+
+    for (unsigned int b = 0; b < m_traceBuffers_v.size(); ++b)
+    {
+        const STraceBuffer & buffer = *m_traceBuffers_v[b];
+
+        fprintf ( file_p, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%i,"
+                  "\"args\":{\"name\":\"Thread %i\"}}",
+                  first_b?"":",", buffer.thread_i, buffer.thread_i );
+        first_b = false;
+
+        /// Oldest event first.
+        const size_t size_ui  = buffer.events_v.size();
+        const size_t count_ui = std::min ( buffer.written_ui, size_ui );
+        const size_t first_ui = buffer.written_ui - count_ui;
+
+        for (size_t i = first_ui; i < buffer.written_ui; ++i)
+        {
+            const STraceEvent & event = buffer.events_v[i % size_ui];
+
+            fprintf ( file_p, ",\n{\"name\":" );
+            writeJsonString ( file_p, event.clock_p -> getName() );
+            fprintf ( file_p, ",\"cat\":" );
+            writeJsonString ( file_p, event.clock_p -> getPath() );
+            fprintf ( file_p, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":0,\"tid\":%i,"
+                      "\"args\":{\"frame\":%i}}",
+                      event.start_d * 1000.,
+                      event.duration_d * 1000.,
+                      buffer.thread_i,
+                      event.frame_i );
+        }
+    }
+
+    fprintf ( file_p, "\n]}\n" );
+    fclose ( file_p );
+
+    return true;
+}
+
+bool
+CClockHandler::writeStatistics ( const std::string & f_fileName_str )
+{
+    QMutexLocker locker ( &m_mutex );
+
+    FILE * file_p = fopen ( f_fileName_str.c_str(), "w" );
+
+    if ( !file_p )
+    {
+        printf("%s:%i Statistics file %s could not be opened\n", 
+               __FILE__, __LINE__, f_fileName_str.c_str());
+        return false;
+    }
+
+    std::vector<const CClock *> clocks_v;
+
+    if ( m_root_p )
+        collectClocks ( m_root_p, clocks_v );
+
+    const bool json_b = ( f_fileName_str.size() >= 5 &&
+                          f_fileName_str.compare ( f_fileName_str.size() - 5, 5, ".json" ) == 0 );
+
+    if ( json_b )
+        fprintf ( file_p, "[" );
+    else
+        fprintf ( file_p, "path,clock,count,total_ms,mean_ms,min_ms,max_ms,last_ms,p50_ms,p95_ms,p99_ms\n" );
+
+    for (unsigned int i = 0; i < clocks_v.size(); ++i)
+    {
+        const CClock * clock_p  = clocks_v[i];
+        const unsigned int n_ui = clock_p -> getCount();
+
+        if ( json_b )
+        {
+            fprintf ( file_p, "%s\n{\"path\":", i?",":"" );
+            writeJsonString ( file_p, clock_p -> getPath() );
+            fprintf ( file_p, ",\"clock\":" );
+            writeJsonString ( file_p, clock_p -> getName() );
+            fprintf ( file_p, ",\"count\":%u,\"total_ms\":%f,\"mean_ms\":%f,"
+                      "\"min_ms\":%f,\"max_ms\":%f,\"last_ms\":%f,"
+                      "\"p50_ms\":%f,\"p95_ms\":%f,\"p99_ms\":%f}",
+                      n_ui,
+                      clock_p -> getTotalTime(),
+                      n_ui?clock_p -> getLoopTime():0.,
+                      clock_p -> getMinTime(),
+                      clock_p -> getMaxTime(),
+                      clock_p -> getLastTime(),
+                      clock_p -> getPercentile ( 50. ),
+                      clock_p -> getPercentile ( 95. ),
+                      clock_p -> getPercentile ( 99. ) );
+        }
+        else
+        {
+            /// Names are quoted since they may contain commas.
+            std::string path_str  = clock_p -> getPath();
+            std::string name_str  = clock_p -> getName();
+
+            for (size_t p = 0; (p = path_str.find ( '"', p )) != std::string::npos; p += 2)
+                path_str.insert ( p, 1, '"' );
+
+            for (size_t p = 0; (p = name_str.find ( '"', p )) != std::string::npos; p += 2)
+                name_str.insert ( p, 1, '"' );
+
+            fprintf ( file_p, "\"%s\",\"%s\",%u,%f,%f,%f,%f,%f,%f,%f,%f\n",
+                      path_str.c_str(),
+                      name_str.c_str(),
+                      n_ui,
+                      clock_p -> getTotalTime(),
+                      n_ui?clock_p -> getLoopTime():0.,
+                      clock_p -> getMinTime(),
+                      clock_p -> getMaxTime(),
+                      clock_p -> getLastTime(),
+                      clock_p -> getPercentile ( 50. ),
+                      clock_p -> getPercentile ( 95. ),
+                      clock_p -> getPercentile ( 99. ) );
+        }
+    }
+
+    if ( json_b )
+        fprintf ( file_p, "\n]\n" );
+
+    fclose ( file_p );
+
+    return true;
+}
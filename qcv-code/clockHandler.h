@@ -32,11 +32,22 @@
  *
  * \brief This class implements a handler for clock.
  *
+ * In tracing mode every measurement of the clocks is recorded as an
+ * event with start time, duration, thread and frame number. Each thread
+ * writes into its own ring buffer without locking, which keeps the last
+ * events. The events can be written in Chrome trace format (JSON) with
+ * writeTrace() or, if a trace file is set, when the handler is
+ * destroyed. Tracing should be started and stopped between frames.
+ *
  *******************************************************************************/
 
 /* INCLUDES */
 #include <string>
 #include <map>
+#include <vector>
+
+#include <QtCore/QMutex>
+#include <QtCore/QThreadStorage>
 
 /* CONSTANTS */
 
@@ -80,6 +91,71 @@ namespace QCV
         /// Get clock-changed flag.
         bool              mustUpdateClock ( ) const;
 
+    /// Statistics.
+    public:
+        /// Write count, total, mean, min, max, last and the 50th, 95th
+        /// and 99th percentiles (ms) of every clock. The file is written
+        /// in JSON if its name ends with ".json", otherwise in CSV.
+        bool              writeStatistics ( const std::string & f_fileName_str );
+
+    /// Tracing.
+    public:
+        /// Start recording the measurements. Each thread keeps the last
+        /// f_capacity_ui events.
+        void              startTracing ( unsigned int f_capacity_ui = 262144 );
+
+        /// Stop recording. The recorded events are kept.
+        void              stopTracing ( );
+
+        /// Are the measurements being recorded?
+        bool              isTracing ( ) const;
+
+        /// Set frame number stored with the next events.
+        void              setFrameNumber ( int f_frame_i );
+
+        /// Get frame number.
+        int               getFrameNumber ( ) const;
+
+        /// Write the recorded events in Chrome trace format. The file
+        /// can be opened with chrome://tracing or Perfetto.
+        bool              writeTrace ( const std::string & f_fileName_str );
+
+        /// Write the trace into the given file when the handler is
+        /// destroyed. An empty name disables it.
+        void              setTraceFile ( const std::string & f_fileName_str );
+
+        /// Record a measurement (called by CClock::stop()).
+        void              addTraceEvent ( const CClock * f_clock_p,
+                                          double         f_start_d,
+                                          double         f_duration_d );
+
+    private:
+        /// Recorded measurement.
+        struct STraceEvent
+        {
+            const CClock *       clock_p;
+            double               start_d;
+            double               duration_d;
+            int                  frame_i;
+        };
+
+        /// Ring buffer of a thread.
+        struct STraceBuffer
+        {
+            std::vector<STraceEvent>  events_v;
+            size_t                    written_ui;
+            int                       thread_i;
+        };
+
+        /// Thread local reference to the buffer of the thread.
+        struct STraceBufferRef
+        {
+            STraceBuffer *       buffer_p;
+        };
+
+        /// Buffer of the calling thread.
+        STraceBuffer *          getTraceBuffer ( );
+
     private:
 
         /// Root node.
@@ -87,6 +163,27 @@ namespace QCV
 
         /// Flag for indicating a change in some clock.
         bool                    m_clockChanged_b;
+
+        /// Protects the tree when operators run concurrently.
+        QMutex                  m_mutex;
+
+        /// Recording?
+        bool                    m_tracing_b;
+
+        /// Events per thread.
+        unsigned int            m_traceCapacity_ui;
+
+        /// Current frame number.
+        int                     m_frame_i;
+
+        /// Trace file written on destruction.
+        std::string             m_traceFile_str;
+
+        /// Buffers of all threads.
+        std::vector<STraceBuffer *>       m_traceBuffers_v;
+
+        /// Buffer of each thread.
+        QThreadStorage<STraceBufferRef *> m_threadBuffer;
     };    
 
 
@@ -107,6 +204,24 @@ namespace QCV
     {
         return m_clockChanged_b;
     }
+
+    inline bool
+    CClockHandler::isTracing ( ) const
+    {
+        return m_tracing_b;
+    }
+
+    inline void
+    CClockHandler::setFrameNumber ( int f_frame_i )
+    {
+        m_frame_i = f_frame_i;
+    }
+
+    inline int
+    CClockHandler::getFrameNumber ( ) const
+    {
+        return m_frame_i;
+    }
 }
 
 #endif // __CLOCKHANDLER_H
@@ -92,6 +92,22 @@ CClockTreeItemModel::data ( const QModelIndex &f_index,
             str.setNum( (double) ( static_cast<CClockNode *>(node_p) -> getLoopTime() ) );
             return ( str );
         }
+
+        if ( f_index.column() >= 4 && f_index.column() <= 6 )
+        {
+            static const double percents_p[3] = { 50., 95., 99. };
+
+            QString str;
+            str.setNum( (double) ( static_cast<CClockNode *>(node_p) -> getPercentile ( percents_p[f_index.column() - 4] ) ) );
+            return ( str );
+        }
+
+        if ( f_index.column() == 7 )
+        {
+            QString str;
+            str.setNum( (double) ( static_cast<CClockNode *>(node_p) -> getMaxTime() ) );
+            return ( str );
+        }
     }
 
     return QVariant();
@@ -129,6 +145,18 @@ CClockTreeItemModel::headerData ( int              f_section_i,
         if (f_section_i == 2)
             return QVariant(tr("Time"));
         
+        if (f_section_i == 4)
+            return QVariant(tr("p50"));
+        
+        if (f_section_i == 5)
+            return QVariant(tr("p95"));
+        
+        if (f_section_i == 6)
+            return QVariant(tr("p99"));
+        
+        if (f_section_i == 7)
+            return QVariant(tr("Max"));
+        
         return QVariant(tr("Time/Loop"));
     }
     
@@ -206,7 +234,7 @@ int
 CClockTreeItemModel::columnCount ( const QModelIndex 
                                    &/*f_parent*/ ) const
 {
-    return 4;
+    return 8;
 }
 
 bool 
@@ -170,6 +170,38 @@ namespace QCV
             return 0.0;
         }
 
+        double getMinTime() const 
+        {
+            if ( m_clock_p )
+                return m_clock_p -> getMinTime();
+
+            return 0.0;
+        }
+
+        double getMaxTime() const 
+        {
+            if ( m_clock_p )
+                return m_clock_p -> getMaxTime();
+
+            return 0.0;
+        }
+
+        double getLastTime() const 
+        {
+            if ( m_clock_p )
+                return m_clock_p -> getLastTime();
+
+            return 0.0;
+        }
+
+        double getPercentile ( double f_percent_d ) const 
+        {
+            if ( m_clock_p )
+                return m_clock_p -> getPercentile ( f_percent_d );
+
+            return 0.0;
+        }
+
         CClock * getClock() const 
         {
             return m_clock_p;
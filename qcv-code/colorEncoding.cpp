@@ -31,8 +31,16 @@
 #include <math.h>
 #include <stdint.h>
 
+#if defined ( __SSE2__ )
+#include <emmintrin.h>
+#endif
+
 using namespace QCV;
 
+/// Number of entries of the lookup table without the last (maximum)
+/// entry.
+static const int CE_LUT_SIZE = 512;
+
 CColorEncoding::CColorEncoding( const EColorEncodingType_t f_type_e,
                                 S2D<float>                 f_range )
         : m_encodingType_e( f_type_e ),
@@ -451,9 +459,11 @@ bool
 CColorEncoding::setMinMaxRange ( S2D<float> f_range )
 {
     if ( m_range != f_range )
+    {
+        m_range = f_range;
         recomputeLut();
+    }
 
-    m_range = f_range;
     return true;    
 }
 
@@ -471,9 +481,11 @@ bool
 CColorEncoding::setMinimum ( float f_min_f )
 {
     if (m_range.min != f_min_f )
+    {
+        m_range.min = f_min_f;
         recomputeLut();
+    }
 
-    m_range.min = f_min_f;
     return true;    
 }
 
@@ -489,9 +501,11 @@ bool
 CColorEncoding::setMaximum ( float f_max_f )
 {
     if (m_range.max != f_max_f )
+    {
+        m_range.max = f_max_f;
         recomputeLut();
+    }
 
-    m_range.max = f_max_f;
     return true;    
 }
 
@@ -506,7 +520,12 @@ CColorEncoding::getMaximum ( ) const
 bool
 CColorEncoding::setLogarithmic ( bool f_log_b )
 {
-    m_logarithmic = f_log_b;
+    if ( m_logarithmic != f_log_b )
+    {
+        m_logarithmic = f_log_b;
+        recomputeLut();
+    }
+
     return true;
 }
 
@@ -521,9 +540,11 @@ bool
 CColorEncoding::setColorEncodingType( EColorEncodingType_t f_newType_e )
 {
     if ( m_encodingType_e !=  f_newType_e )
+    {
+        m_encodingType_e =  f_newType_e;
         recomputeLut();
+    }
 
-    m_encodingType_e =  f_newType_e;
     return true;
 }
 
@@ -533,11 +554,11 @@ CColorEncoding::recomputeLut()
     m_lut.clear();
     
     float val_f = m_range.min;
-    m_dx_f = (m_range.max-m_range.min)/512.f;
+    m_dx_f = (m_range.max-m_range.min)/CE_LUT_SIZE;
     
     SRgb color;
 
-    for (int i = 0; i < 512; ++i, val_f += m_dx_f)
+    for (int i = 0; i < CE_LUT_SIZE; ++i, val_f += m_dx_f)
     {
         colorFromValue ( val_f,
                          m_range.min,
@@ -550,3 +571,172 @@ CColorEncoding::recomputeLut()
 }
 
 
+
+/// Lookup table index of a value. Values below the range and NaNs map
+/// to the first entry, values above the range to the last one.
+static inline int
+lutIndex ( const float f_value_f,
+           const float f_min_f,
+           const float f_dx_f )
+{
+    float idx_f = (f_value_f - f_min_f) / f_dx_f;
+
+    if ( !(idx_f > 0.f) )    return 0;
+    if ( idx_f > CE_LUT_SIZE ) return CE_LUT_SIZE;
+
+    return (int) idx_f;
+}
+
+#if defined ( __SSE2__ )
+/// Load 4 values of a row as floats.
+static inline __m128 load4 ( const float * f_src_p )
+{
+    return _mm_loadu_ps ( f_src_p );
+}
+
+static inline __m128 load4 ( const double * f_src_p )
+{
+    return _mm_movelh_ps ( _mm_cvtpd_ps ( _mm_loadu_pd ( f_src_p ) ),
+                           _mm_cvtpd_ps ( _mm_loadu_pd ( f_src_p + 2 ) ) );
+}
+
+static inline __m128 load4 ( const int * f_src_p )
+{
+    return _mm_cvtepi32_ps ( _mm_loadu_si128 ( (const __m128i *) f_src_p ) );
+}
+
+static inline __m128 load4 ( const short int * f_src_p )
+{
+    const __m128i v = _mm_loadl_epi64 ( (const __m128i *) f_src_p );
+
+    /// Sign extension.
+    return _mm_cvtepi32_ps ( _mm_srai_epi32 ( _mm_unpacklo_epi16 ( v, v ), 16 ) );
+}
+
+static inline __m128 load4 ( const unsigned short int * f_src_p )
+{
+    const __m128i v = _mm_loadl_epi64 ( (const __m128i *) f_src_p );
+    return _mm_cvtepi32_ps ( _mm_unpacklo_epi16 ( v, _mm_setzero_si128 ( ) ) );
+}
+#endif
+
+/// Encode an image with the lookup table (one entry per index).
+template <class Type_>
+static void encodeWithLut ( const cv::Mat &   f_img,
+                            const cv::Vec4b * f_lut_p,
+                            const float       f_min_f,
+                            const float       f_dx_f,
+                            cv::Mat &         fr_rgba )
+{
+    const int w_i = f_img.cols;
+
+#pragma omp parallel for schedule(static) if ( f_img.rows * f_img.cols > 65536 )
+    for (int v = 0; v < f_img.rows; ++v)
+    {
+        const Type_ * src_p = f_img.ptr<Type_>(v);
+        cv::Vec4b *   dst_p = fr_rgba.ptr<cv::Vec4b>(v);
+        int           u     = 0;
+
+#if defined ( __SSE2__ )
+        const __m128 minv = _mm_set1_ps ( f_min_f );
+        const __m128 dxv  = _mm_set1_ps ( f_dx_f );
+        const __m128 zero = _mm_setzero_ps ( );
+        const __m128 last = _mm_set1_ps ( (float) CE_LUT_SIZE );
+
+        int idx_p[4];
+
+        for (; u + 4 <= w_i; u += 4)
+        {
+            __m128 idx = _mm_div_ps ( _mm_sub_ps ( load4 ( src_p + u ), minv ), dxv );
+
+            /// The second operand is returned for NaNs.
+            idx = _mm_max_ps ( idx, zero );
+            idx = _mm_min_ps ( idx, last );
+
+            _mm_storeu_si128 ( (__m128i *) idx_p, _mm_cvttps_epi32 ( idx ) );
+
+            dst_p[u  ] = f_lut_p[idx_p[0]];
+            dst_p[u+1] = f_lut_p[idx_p[1]];
+            dst_p[u+2] = f_lut_p[idx_p[2]];
+            dst_p[u+3] = f_lut_p[idx_p[3]];
+        }
+#endif
+
+        for (; u < w_i; ++u)
+            dst_p[u] = f_lut_p[lutIndex ( (float) src_p[u], f_min_f, f_dx_f )];
+    }
+}
+
+/// Encode an 8 bit image with a table indexed by the pixel values.
+template <class Type_>
+static void encodeWithTable ( const cv::Mat &   f_img,
+                              const cv::Vec4b * f_lut_p,
+                              const float       f_min_f,
+                              const float       f_dx_f,
+                              cv::Mat &         fr_rgba )
+{
+    cv::Vec4b table_p[256];
+
+    for (int i = 0; i < 256; ++i)
+        table_p[(uint8_t) i] = f_lut_p[lutIndex ( (float) (Type_) i, f_min_f, f_dx_f )];
+
+    const int w_i = f_img.cols;
+
+#pragma omp parallel for schedule(static) if ( f_img.rows * f_img.cols > 65536 )
+    for (int v = 0; v < f_img.rows; ++v)
+    {
+        const uint8_t * src_p = f_img.ptr<uint8_t>(v);
+        cv::Vec4b *     dst_p = fr_rgba.ptr<cv::Vec4b>(v);
+
+        for (int u = 0; u < w_i; ++u)
+            dst_p[u] = table_p[src_p[u]];
+    }
+}
+
+bool
+CColorEncoding::encodeImage ( const cv::Mat &  f_img,
+                              cv::Mat &        fr_rgba,
+                              uint8_t          f_alpha_ui ) const
+{
+    if ( f_img.channels() != 1 || m_lut.size() != (size_t) CE_LUT_SIZE + 1 )
+        return false;
+
+    fr_rgba.create ( f_img.size(), CV_8UC4 );
+
+    cv::Vec4b lut_p[CE_LUT_SIZE + 1];
+
+    for (int i = 0; i <= CE_LUT_SIZE; ++i)
+        lut_p[i] = cv::Vec4b ( m_lut[i].r, m_lut[i].g, m_lut[i].b, f_alpha_ui );
+
+    const float min_f = m_range.min;
+    const float dx_f  = m_dx_f;
+
+    switch ( f_img.depth() )
+    {
+        case CV_8S:
+            encodeWithTable<signed char> ( f_img, lut_p, min_f, dx_f, fr_rgba ); break;
+
+        case CV_8U:
+            encodeWithTable<unsigned char> ( f_img, lut_p, min_f, dx_f, fr_rgba ); break;
+
+        case CV_16S:
+            encodeWithLut<short int> ( f_img, lut_p, min_f, dx_f, fr_rgba ); break;
+
+        case CV_16U:
+            encodeWithLut<unsigned short int> ( f_img, lut_p, min_f, dx_f, fr_rgba ); break;
+
+        case CV_32S:
+            encodeWithLut<int> ( f_img, lut_p, min_f, dx_f, fr_rgba ); break;
+
+        case CV_32F:
+            encodeWithLut<float> ( f_img, lut_p, min_f, dx_f, fr_rgba ); break;
+
+        case CV_64F:
+            encodeWithLut<double> ( f_img, lut_p, min_f, dx_f, fr_rgba ); break;
+
+        default:
+            return false;
+    }
+
+    return true;
+}
@@ -100,6 +100,12 @@ namespace QCV
         bool       colorFromValue(    const float      f_value_f,
                                       SRgb            &fr_color ) const;
 
+        // Encode a single channel image into RGBA (CV_8UC4) using the
+        // lookup table. NaNs are encoded with the color of the minimum.
+        bool       encodeImage (      const cv::Mat &  f_img,
+                                      cv::Mat &        fr_rgba,
+                                      uint8_t          f_alpha_ui = 255 ) const;
+
 
     /// Parameters.
     public:
@@ -41,6 +41,7 @@
 
 #include "display.h"
 #include "displayTreeNode.h"
+#include "displayImageList.h"
 
 using namespace QCV;
 
@@ -54,7 +55,8 @@ CDisplay::CDisplay( CDisplayOpNode * const f_rootNode_p,
           m_zoomTL (                              0,0 ),
           m_zoomFactor_f (                        1.f ),
 	  m_initialized_b (                     false ),
-          m_highlightScreen (                  -1, -1 )
+          m_highlightScreen (                  -1, -1 ),
+          m_drawMutex_p (                        NULL )
 {
     /// Just now temporal.
     m_screenSize.width  = 640;
@@ -117,6 +119,11 @@ void CDisplay::paintGL()
     // Can't repaint if window hasn't been displayed yet.
     if ( !m_initialized_b ) return;
 
+    /// The drawing lists might be written by another thread.
+    QMutexLocker locker ( m_drawMutex_p );
+
+    /// Images shown in several lists are uploaded once.
+    CDisplayImageList::beginPaint();
 
     // Reset modelview matrix
     glMatrixMode(GL_MODELVIEW);
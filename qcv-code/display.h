@@ -36,6 +36,8 @@
 #include "events.h"
 //#include "rgbImage.h"
 
+class QMutex;
+
 namespace QCV
 {
 
@@ -81,6 +83,9 @@ namespace QCV
 
         int    getScreenWidth   (  ) const { return m_screenSize.width;  }
         int    getScreenHeight  (  ) const { return m_screenSize.height;  }
+
+        /// Mutex to hold while painting the drawing lists.
+        void   setDrawMutex ( QMutex * f_mutex_p ) { m_drawMutex_p = f_mutex_p; }
         
     public slots:
         bool   showAllScreens ( );
@@ -187,6 +192,9 @@ namespace QCV
 
         /// Highligh screen
         S2D<int>                   m_highlightScreen;
+
+        /// Mutex protecting the drawing lists.
+        QMutex *                   m_drawMutex_p;
     };
 }
 
@@ -29,16 +29,21 @@
 
 /* INCLUDES */
 #include "displayCEImageList.h"
+#include "rasterizer.h"
 
 #include <opencv/highgui.h>
 
-#include "glheader.h"
-
-
 using namespace QCV;
 
+void (* CDisplayColorEncImageList::m_deleteTextures_p) ( int, const unsigned int * ) = NULL;
 
 CDisplayColorEncImageList::CDisplayColorEncImageList() 
+        : m_image_v (             ),
+          m_textureId_v (         ),
+          m_textureSize_v (       ),
+          m_rgba_v (              ),
+          m_dirty_b (        true ),
+          m_encoded_b (     false )
 {
 }
 
@@ -46,15 +51,30 @@ CDisplayColorEncImageList::CDisplayColorEncImageList()
 CDisplayColorEncImageList::~CDisplayColorEncImageList()
 {
     clear();
+
+    if ( !m_textureId_v.empty() )
+        m_deleteTextures_p ( m_textureId_v.size(), &m_textureId_v[0] );
 }
 
 // Add images from other list.
 bool 
 CDisplayColorEncImageList::add ( const CDisplayColorEncImageList & f_otherList )
 {
+    const unsigned int first_ui = m_image_v.size();
+
     m_image_v.insert( m_image_v.end(), 
                       f_otherList.m_image_v.begin(),
                       f_otherList.m_image_v.end() );
+
+    /// Copies are owned by each list (the data is shared).
+    for (unsigned int i = first_ui; i < m_image_v.size(); ++i)
+    {
+        if ( m_image_v[i].copied_b )
+            m_image_v[i].image_p = new cv::Mat ( *m_image_v[i].image_p );
+    }
+
+    m_dirty_b   = true;
+    m_encoded_b = false;
     return true;
     
 }
@@ -93,6 +113,8 @@ CDisplayColorEncImageList::add (  cv::Mat *           f_image_p,
         newImage.encoder     = f_encoder_f;
 
         m_image_v.push_back( newImage );
+        m_dirty_b   = true;
+        m_encoded_b = false;
     }
 
     return res_b;
@@ -110,106 +132,57 @@ CDisplayColorEncImageList::clear ()
     }
     
     m_image_v.clear();
+    m_dirty_b   = true;
+    m_encoded_b = false;
     return true;
 }
 
-// Draw all lines.
+// Reference the images added without copy.
 bool 
-CDisplayColorEncImageList::show () const
+CDisplayColorEncImageList::detach ()
 {
-
-    DisplayColorEncImageList_t::const_iterator last = m_image_v.end();
+    DisplayColorEncImageList_t::iterator it = m_image_v.begin();
     
-    glLineWidth( 0 );
-    for (DisplayColorEncImageList_t::const_iterator i = m_image_v.begin(); 
-         i != last; ++i )
+    for (; it != m_image_v.end(); ++it)
     {
-        switch( (*i).image_p->type() )
-        {
-            case CV_8S:
-                return showWithType<char>((*i));
-
-            case CV_8U:
-                return showWithType<unsigned char>((*i));
-
-            case CV_16S:
-                return showWithType<short int>((*i));
-
-            case CV_16U:
-                return showWithType<unsigned short int>((*i));
-            
-            case CV_32S:
-                return showWithType<int>((*i));
-            
-            //case CV_32U:
-            //    return showWithType<unsigned int>((*i));
-            
-            case CV_32F:
-                return showWithType<float>((*i));
-
-            case CV_64F:
-                return showWithType<double>((*i));
-
-            default:
-                return false;
-        }
+        if ( it -> copied_b )
+            continue;
+
+        /// The data is shared (reference counted), not copied.
+        it -> image_p  = new cv::Mat ( *it -> image_p );
+        it -> copied_b = true;
     }
-    return false;
+
+    return true;
 }
 
-// Draw all lines.
-template <class Type_>
+// Encode the images for the next upload.
 bool 
-CDisplayColorEncImageList::showWithType ( const SDisplayColorEncImage & f_elem ) const
+CDisplayColorEncImageList::encode () const
 {
+    bool success_b = true;
 
-    const unsigned int w_ui = f_elem.image_p->size().width;
-    const int          h_i  = f_elem.image_p->size().height;
-    
-    const float dx_f = f_elem.width_f  / w_ui;
-    const float dy_f = f_elem.height_f / h_i;
-
-    glLineWidth( 0 );    
+    if ( m_rgba_v.size() < m_image_v.size() )
+        m_rgba_v.resize ( m_image_v.size() );
 
-    // OPENMP HERE?
-    for (int v = 0; v < h_i; ++v)
+    for (unsigned int i = 0; i < m_image_v.size(); ++i)
     {
-        Type_ *ptr_p = ((Type_ *)(f_elem.image_p->data)) + v * w_ui;
-        SRgba colorAlpha;
-        SRgb  color;
+        const SDisplayColorEncImage & elem = m_image_v[i];
 
-        float offsetX_f    = f_elem.u_f;
-        float offsetY_f    = f_elem.v_f + v * dy_f;
-        float offsetYpdy_f = offsetY_f + dy_f;
+        const uint8_t alpha_ui = (uint8_t) std::max( 0.f, std::min( 255.f, elem.alpha_f * 255.f + .5f ) );
 
-        for ( unsigned u = 0; u < w_ui; ++u, ++ptr_p )
+        /// Empty images and images that cannot be encoded are not shown.
+        if ( elem.image_p -> empty() ||
+             !elem.encoder.encodeImage ( *elem.image_p, m_rgba_v[i], alpha_ui ) )
         {
-            float offsetXpdx_f = offsetX_f + dx_f;
-            
-            f_elem.encoder.colorFromValue( (float) (*ptr_p), 
-                                           color );
-
-            colorAlpha = color;
-            colorAlpha.a = f_elem.alpha_f;
-            
-
-            glColor4ub( colorAlpha.r, 
-                        colorAlpha.g,
-                        colorAlpha.b,
-                        colorAlpha.a );
-            
-            glBegin(GL_POLYGON);
-            glVertex2f ( offsetX_f,    offsetY_f );
-            glVertex2f ( offsetXpdx_f, offsetY_f );
-            glVertex2f ( offsetXpdx_f, offsetYpdy_f );
-            glVertex2f ( offsetX_f,    offsetYpdy_f );
-            glEnd();
-
-            offsetX_f = offsetXpdx_f;
+            success_b &= elem.image_p -> empty();
+            m_rgba_v[i].release();
         }
     }
 
-    return true;
+    m_encoded_b = true;
+
+    return success_b;
 }
 
 bool
@@ -224,6 +197,52 @@ CDisplayColorEncImageList::write ( FILE*                f_file_p,
                                        f_parameters_str );
 }
 
+// Render all images.
+bool 
+CDisplayColorEncImageList::render ( CRasterTile & fr_tile ) const
+{
+    DisplayColorEncImageList_t::const_iterator last = m_image_v.end();
+
+    bool success_b = true;
+    cv::Mat rgba, bgr;
+
+    for (DisplayColorEncImageList_t::const_iterator i = m_image_v.begin(); 
+         i != last; ++i )
+    {
+        const cv::Mat & img = *(i->image_p);
+
+        /// Only the visible part of the image is encoded.
+        const cv::Rect region = fr_tile.visibleRegion ( img.size(), 
+                                                        i->u_f, 
+                                                        i->v_f, 
+                                                        i->width_f, 
+                                                        i->height_f );
+        
+        if ( region.area() <= 0 )
+            continue;
+
+        if ( !i->encoder.encodeImage ( img ( region ), rgba ) )
+        {
+            success_b = false;
+            continue;
+        }
+
+        cv::cvtColor ( rgba, bgr, CV_RGBA2BGR );
+
+        /// Color encoded images are not blended (see isBlendable()).
+        fr_tile.image ( bgr, 
+                        region, 
+                        img.size(),
+                        i->u_f, 
+                        i->v_f, 
+                        i->width_f, 
+                        i->height_f, 
+                        1.f );
+    }
+
+    return success_b;
+}
+
 /// Return number of elements.
 int
 CDisplayColorEncImageList::getSize () const
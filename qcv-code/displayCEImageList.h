@@ -38,6 +38,13 @@
  *  - display width and height,
  *  - the color encoding object (of type CColorEncoding).
  *
+ * The images are encoded with the lookup table of the color encoding
+ * and uploaded as textures the first time they are shown. encode() can
+ * be called before in another thread, so that only the upload is left
+ * to the thread painting the list. Images added without copy are read
+ * through their pointer until detach() is called, which takes a 
+ * reference of their data.
+ *
  */
 
 /* INCLUDES */
@@ -81,8 +88,14 @@ namespace QCV
         // Clear all lines.
         virtual bool clear ();
 
-        // Draw all lines.
-        virtual bool show () const;
+        // Reference the images added without copy.
+        virtual bool detach ();
+
+        // Encode the images for the next upload. Makes no GL calls.
+        virtual bool encode () const;
+
+        // Draw all images (OpenGL, defined in displayCEImageListGL.cpp).
+        bool show () const;
 
         // Write line in a SVG file.
         virtual bool write ( FILE*              f_file_p,
@@ -90,6 +103,9 @@ namespace QCV
                              const float        f_offsetV_f = 0.0,
                              const std::string  f_parameters_str = "") const;
 
+        // Render images into an image tile.
+        virtual bool render ( CRasterTile &      fr_tile ) const;
+
         // Return number of elements.
         virtual int  getSize () const;
 
@@ -124,8 +140,9 @@ namespace QCV
 
     /// Private Methods
     private:
-        template <class Type_>
-        bool showWithType ( const SDisplayColorEncImage & f_elem ) const;
+        /// Encode the images and upload them as textures. Defined in
+        /// displayCEImageListGL.cpp.
+        bool updateTextures ( ) const;
         
     /// Private Members
     private:
@@ -133,7 +150,28 @@ namespace QCV
         typedef std::vector<SDisplayColorEncImage>  DisplayColorEncImageList_t;
         
         /// Vector of images.
-        DisplayColorEncImageList_t     m_image_v;        
+        DisplayColorEncImageList_t          m_image_v;        
+
+        /// Textures of the images. They are kept across frames and
+        /// reallocated only if the size of the image changes.
+        mutable std::vector<unsigned int>   m_textureId_v;
+
+        /// Size of the textures (empty if the image could not be encoded).
+        mutable std::vector<cv::Size>       m_textureSize_v;
+
+        /// Encoded images. The buffers are kept across frames.
+        mutable std::vector<cv::Mat>        m_rgba_v;
+
+        /// Images have been added or cleared since the last upload.
+        mutable bool                        m_dirty_b;
+
+        /// Images have been added or cleared since the last encoding.
+        mutable bool                        m_encoded_b;
+
+        /// Deletes textures in the GL context of the displays. Set by
+        /// updateTextures(), so it is set whenever a list has textures.
+        static void                      (* m_deleteTextures_p) ( int                  f_count_i,
+                                                                  const unsigned int * f_ids_p );
     };
 } // Namespace QCV
 
@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose. 
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+/*@@@**************************************************************************
+* \file  displayCEImageListGL.cpp
+* \author Hernan Badino
+* \notes 
+*******************************************************************************
+*****             (C) Hernan Badino 2012 - All Rights Reserved            *****
+******************************************************************************/
+
+/* INCLUDES */
+#include <QGLContext>
+
+#include "displayCEImageList.h"
+
+#include "glheader.h"
+
+extern QGLContext * g_QGLContext_p;
+
+using namespace QCV;
+
+/// Delete the textures of a list (see ~CDisplayColorEncImageList()).
+static void deleteTextures ( int f_count_i, const unsigned int * f_ids_p )
+{
+    if ( g_QGLContext_p )
+    {
+        g_QGLContext_p->makeCurrent();
+        glDeleteTextures( f_count_i, f_ids_p );
+    }
+}
+
+// Draw all lines.
+bool 
+CDisplayColorEncImageList::show () const
+{
+    bool success_b = true;
+
+    if ( m_dirty_b )
+        success_b = updateTextures();
+
+    glEnable( GL_TEXTURE_RECTANGLE_NV );
+    glTexEnvf( GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE );
+
+    for (unsigned int i = 0; i < m_image_v.size(); ++i)
+    {
+        const SDisplayColorEncImage & elem = m_image_v[i];
+        const cv::Size &              size = m_textureSize_v[i];
+
+        if ( size.area() <= 0 )
+            continue;
+
+        glBindTexture( GL_TEXTURE_RECTANGLE_NV, m_textureId_v[i] );
+
+        float endX_f = elem.u_f + elem.width_f;
+        float endY_f = elem.v_f + elem.height_f;
+        
+        glBegin(GL_QUADS);
+        
+        glTexCoord2f(0, 0);
+        glVertex2f(elem.u_f, elem.v_f);
+        
+        glTexCoord2f(size.width, 0);
+        glVertex2f(endX_f, elem.v_f);
+
+        glTexCoord2f(size.width, size.height);
+        glVertex2f(endX_f, endY_f);
+
+        glTexCoord2f(0, size.height);
+        glVertex2f(elem.u_f, endY_f);
+
+        glEnd();        
+    }
+
+    glDisable( GL_TEXTURE_RECTANGLE_NV );
+
+    return success_b;
+}
+
+// Encode the images and upload them as textures.
+bool 
+CDisplayColorEncImageList::updateTextures () const
+{
+    bool success_b = true;
+
+    if ( !m_encoded_b )
+        success_b = encode();
+
+    /// Textures of previous frames are reused.
+    if ( m_textureId_v.size() < m_image_v.size() )
+    {
+        const unsigned int prev_ui = m_textureId_v.size();
+
+        m_textureId_v.resize   ( m_image_v.size(), 0 );
+        m_textureSize_v.resize ( m_image_v.size() );
+
+        glGenTextures( m_textureId_v.size() - prev_ui, &m_textureId_v[prev_ui] );
+        m_deleteTextures_p = deleteTextures;
+    }
+
+    glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+    glPixelStorei( GL_UNPACK_ROW_LENGTH, 0 );
+
+    /// The pixel transfer might have been modified by CDisplayImageList.
+    glPixelTransferf ( GL_RED_SCALE,   1.f );
+    glPixelTransferf ( GL_RED_BIAS,    0.f );
+    glPixelTransferf ( GL_GREEN_SCALE, 1.f );
+    glPixelTransferf ( GL_GREEN_BIAS,  0.f );
+    glPixelTransferf ( GL_BLUE_SCALE,  1.f );
+    glPixelTransferf ( GL_BLUE_BIAS,   0.f );
+
+    for (unsigned int i = 0; i < m_image_v.size(); ++i)
+    {
+        const cv::Mat & rgba = m_rgba_v[i];
+        cv::Size &      size = m_textureSize_v[i];
+
+        if ( rgba.empty() )
+        {
+            size = cv::Size();
+            continue;
+        }
+
+        glBindTexture( GL_TEXTURE_RECTANGLE_NV, m_textureId_v[i] );
+
+        if ( size != rgba.size() )
+        {
+            size = rgba.size();
+
+            glTexParameteri( GL_TEXTURE_RECTANGLE_NV, GL_TEXTURE_WRAP_S, GL_CLAMP );
+            glTexParameteri( GL_TEXTURE_RECTANGLE_NV, GL_TEXTURE_WRAP_T, GL_CLAMP );
+            glTexParameteri( GL_TEXTURE_RECTANGLE_NV, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+            glTexParameteri( GL_TEXTURE_RECTANGLE_NV, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+
+            glTexImage2D( GL_TEXTURE_RECTANGLE_NV,
+                          0,
+                          GL_RGBA,
+                          size.width,
+                          size.height,
+                          0,
+                          GL_RGBA,
+                          GL_UNSIGNED_BYTE,
+                          rgba.data );
+        }
+        else
+        {
+            glTexSubImage2D( GL_TEXTURE_RECTANGLE_NV,
+                             0,
+                             0,
+                             0,
+                             size.width,
+                             size.height,
+                             GL_RGBA,
+                             GL_UNSIGNED_BYTE,
+                             rgba.data );
+        }
+    }
+
+    m_dirty_b = false;
+
+    return success_b;
+}
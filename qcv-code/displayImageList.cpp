@@ -28,158 +28,20 @@
 ******************************************************************************/
 
 /* INCLUDES */
-#include <QGLContext>
-
 #include "displayImageList.h"
+#include "rasterizer.h"
 
 #include <opencv/highgui.h>
 
 #include <stdio.h>
 
-#include "glheader.h"
-
-extern QGLContext * g_QGLContext_p;
-
 using namespace QCV;
 
-static int cv2GLDType ( int f_cvFormat_i)
-{    
-    switch (f_cvFormat_i)
-    {
-       case CV_8S: 
-       //case CV_8SC1:
-       case CV_8SC2:
-       case CV_8SC3:
-       case CV_8SC4:
-           return GL_BYTE;
-       case CV_8U:
-       //case CV_8UC1:
-       case CV_8UC2:
-       case CV_8UC3:
-       case CV_8UC4:
-           return GL_UNSIGNED_BYTE;
-       case CV_16S:
-       //case CV_16SC1:
-       case CV_16SC2:
-       case CV_16SC3:
-       case CV_16SC4:
-           return GL_SHORT;
-       case CV_16U:
-       //case CV_16UC1:
-       case CV_16UC2:
-       case CV_16UC3:
-       case CV_16UC4:
-           return GL_UNSIGNED_SHORT;
-       case CV_32S:
-       //case CV_32SC1:
-       case CV_32SC2:
-       case CV_32SC3:
-       case CV_32SC4:
-           return GL_INT;
-       case CV_32F:
-       //case CV_32FC1:
-       case CV_32FC2:
-       case CV_32FC3:
-       case CV_32FC4:
-           return GL_FLOAT;
-       case CV_64F:
-       //case CV_64FC1:
-       case CV_64FC2:
-       case CV_64FC3:
-       case CV_64FC4:
-          return GL_DOUBLE;
-    }
-
-
-    return GL_UNSIGNED_BYTE;    
-}
-
-static int cv2GLFormat ( const cv::Mat &f_mat )
-{
-    if ( f_mat.size().width == 0 || f_mat.size().width == 0 )
-        return GL_LUMINANCE;
-
-    int bytesPerElem_i = 1;
-    
-    switch (f_mat.type())
-    {
-       case CV_8S: 
-       //case CV_8SC1:
-       case CV_8SC2:
-       case CV_8SC3:
-       case CV_8SC4:
-       case CV_8U:
-       //case CV_8UC1:
-       case CV_8UC2:
-       case CV_8UC3:
-       case CV_8UC4:
-           {
-               bytesPerElem_i = 1; break;
-           }
-       case CV_16S:
-       //case CV_16SC1:
-       case CV_16SC2:
-       case CV_16SC3:
-       case CV_16SC4:
-       case CV_16U:
-       //case CV_16UC1:
-       case CV_16UC2:
-       case CV_16UC3:
-       case CV_16UC4:
-           {
-               bytesPerElem_i = 2; break;
-           }
-       case CV_32S:
-       //case CV_32SC1:
-       case CV_32SC2:
-       case CV_32SC3:
-       case CV_32SC4:
-       case CV_32F:
-       //case CV_32FC1:
-       case CV_32FC2:
-       case CV_32FC3:
-       case CV_32FC4:
-           {
-               bytesPerElem_i = 4; break;
-           }
-       case CV_64F:
-       //case CV_64FC1:
-       case CV_64FC2:
-       case CV_64FC3:
-       case CV_64FC4:
-           {
-               bytesPerElem_i = 8; break;
-           }
-    }
-
-    int oneChannelWidth_i = (f_mat.size().width*bytesPerElem_i);
-    int elemsPerPixel     = f_mat.step / oneChannelWidth_i;
-
-    if (elemsPerPixel <= 1)
-        return GL_LUMINANCE;
-    else if (elemsPerPixel <= 2)
-        return GL_LUMINANCE_ALPHA;
-    else if (elemsPerPixel <= 3)
-        return GL_RGB;
-    else if (elemsPerPixel <= 4)
-        return GL_RGBA;
-
-    return GL_LUMINANCE;
-}
-
-static int cv2GLFormat2 ( const cv::Mat &f_mat )
-{
-    int val = cv2GLFormat ( f_mat );
-    
-    if (val == GL_RGB)
-        return GL_BGR;
-    else if (val == GL_RGBA)
-        return GL_BGRA;
-    
-    return val;
-}
+void (* CDisplayImageList::m_releaseTexture_p) ( unsigned int ) = NULL;
 
 CDisplayImageList::CDisplayImageList() 
+        : m_image_v (                ),
+          m_pending_b (        false )
 {
 }
 
@@ -193,15 +55,15 @@ CDisplayImageList::~CDisplayImageList()
 bool 
 CDisplayImageList::add ( const CDisplayImageList & f_otherList )
 {
-    if ( g_QGLContext_p )
-        g_QGLContext_p->makeCurrent();
-
     m_image_v.insert( m_image_v.begin(), 
                       f_otherList.m_image_v.begin(),
                       f_otherList.m_image_v.end() );
 
+    /// The textures are shared again when uploaded.
     for (size_t i = 0; i < f_otherList.m_image_v.size(); ++i)
-      m_image_v[i].ownResources_b = false;
+        m_image_v[i].textureId_ui = 0;
+
+    m_pending_b = m_pending_b || !f_otherList.m_image_v.empty();
 
     return true;    
 }
@@ -217,10 +79,6 @@ bool CDisplayImageList::add ( cv::Mat             f_image,
                               const float         f_alpha_f,
                               const bool          f_makeCopy_b )
 {
-    if ( g_QGLContext_p )
-        g_QGLContext_p->makeCurrent();
-
-    //bool res_b;
     SDisplayImage newImage;
 
     if ( f_makeCopy_b )
@@ -228,72 +86,22 @@ bool CDisplayImageList::add ( cv::Mat             f_image,
     else
         newImage.image = f_image;
 
-    //if (res_b)
-    {
-        newImage.u_f         = f_u_f;
-        newImage.v_f         = f_v_f;
-        newImage.width_f     = f_dispWidth_f;
-        newImage.height_f    = f_dispHeight_f;
-        newImage.alpha_f     = f_alpha_f;
-        newImage.scale_f     = f_scale_f;
-        newImage.bias_f      = f_bias_f;
-
-        // Generate texture.
-        glGenTextures(1, &newImage.textureId_ui);
-        
-	newImage.ownResources_b = true;	
+    newImage.u_f          = f_u_f;
+    newImage.v_f          = f_v_f;
+    newImage.width_f      = f_dispWidth_f;
+    newImage.height_f     = f_dispHeight_f;
+    newImage.alpha_f      = f_alpha_f;
+    newImage.scale_f      = f_scale_f;
+    newImage.bias_f       = f_bias_f;
 
-        m_image_v.push_back(newImage);        
+    /// The texture is uploaded when shown (there is no GL context in
+    /// batch mode or in the processing thread).
+    newImage.textureId_ui = 0;
 
-        //first call transferes the texture to hw
-        glBindTexture( GL_TEXTURE_RECTANGLE_NV, newImage.textureId_ui );
-        
-        glPixelStorei( GL_UNPACK_ALIGNMENT, 1);    
+    m_image_v.push_back(newImage);
+    m_pending_b = true;
 
-        // Interpolation settings ().
-        glTexParameteri( GL_TEXTURE_RECTANGLE_NV, GL_TEXTURE_WRAP_S, GL_CLAMP);
-        glTexParameteri( GL_TEXTURE_RECTANGLE_NV, GL_TEXTURE_WRAP_T, GL_CLAMP);
-        
-        // Interpolation settings (make as parameter).
-        glTexParameteri( GL_TEXTURE_RECTANGLE_NV, GL_TEXTURE_MAG_FILTER, GL_NEAREST); //GL_LINEAR
-        glTexParameteri( GL_TEXTURE_RECTANGLE_NV, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexEnvf( GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
-
-        glPixelTransferf ( GL_RED_SCALE,   newImage.scale_f );
-        glPixelTransferf ( GL_RED_BIAS,    newImage.bias_f  );        
-        glPixelTransferf ( GL_GREEN_SCALE, newImage.scale_f );
-        glPixelTransferf ( GL_GREEN_BIAS,  newImage.bias_f  );        
-        glPixelTransferf ( GL_BLUE_SCALE,  newImage.scale_f );
-        glPixelTransferf ( GL_BLUE_BIAS,   newImage.bias_f  );
-
-        int realWidth_i  = newImage.image.step/newImage.image.elemSize();
-        int realHeight_i = newImage.image.step/newImage.image.elemSize();
-        int offX_i       = realWidth_i - newImage.image.cols;
-        int offY_i       = realHeight_i - newImage.image.rows;
-
-        glTexImage2D( GL_TEXTURE_RECTANGLE_NV,
-                      0,                                        // base level (only 0 allowed for GL_TEXTURE_RECTANGLE_NV).
-                      cv2GLFormat(newImage.image),           // internal format.
-                      realWidth_i,
-                      newImage.image.size().height,
-                      0,                                        // border.
-                      cv2GLFormat2(newImage.image),          // 
-                      cv2GLDType(newImage.image.type()),     // 
-                      newImage.image.ptr<unsigned char>(0) );  // data. 
-
-        glBindTexture(GL_TEXTURE_2D, newImage.textureId_ui);
-        glTexSubImage2D( GL_TEXTURE_RECTANGLE_NV,
-                         0,
-                         offX_i,
-                         offY_i,
-                         realWidth_i,
-                         newImage.image.rows,
-                         cv2GLFormat2(newImage.image),
-                         cv2GLDType(newImage.image.type()),
-                         newImage.image.ptr<unsigned char>(0) );
-   }
-
-    return true; //res_b;
+    return true;
 }
 
 // Clear all lines.
@@ -301,53 +109,12 @@ bool CDisplayImageList::clear ()
 {
     for (unsigned int i = 0; i < m_image_v.size(); ++i)
     {
-      if (m_image_v[i].ownResources_b)
-      {
-         glDeleteTextures( 1, &m_image_v[i].textureId_ui );
-      }
+        if ( m_image_v[i].textureId_ui )
+            m_releaseTexture_p ( m_image_v[i].textureId_ui );
     }
     
     m_image_v.clear();
-    return true;
-}
-
-// Draw all lines.
-bool CDisplayImageList::show () const
-{
-    DisplayImageList_t::const_iterator last = m_image_v.end();
-
-    glEnable( GL_TEXTURE_RECTANGLE_NV);
-
-    for (DisplayImageList_t::const_iterator i = m_image_v.begin(); 
-         i != last; ++i )
-    {
-        glBindTexture( GL_TEXTURE_RECTANGLE_NV,
-                       i->textureId_ui );
-        
-        float endX_f = i->u_f + i->width_f;
-        float endY_f = i->v_f + i->height_f;
-        
-        glBegin(GL_QUADS);
-        
-        glTexCoord2f(0, 0);
-        glVertex2f(i->u_f, i->v_f);
-        
-        glTexCoord2f(i->image.size().width, 0);
-        glVertex2f(endX_f, i->v_f);
-
-        glTexCoord2f(i->image.size().width, i->image.size().height);
-        glVertex2f(endX_f, endY_f);
-
-        glTexCoord2f(0, i->image.size().height);
-        glVertex2f(i->u_f, endY_f);
-
-        glEnd();        
-    }
-
-    glDisable(GL_TEXTURE_RECTANGLE_NV); //  This takes a very long
-                                        //  time. It sould be optimized!
-
-    /// Todo: Check GL status and return value.
+    m_pending_b = false;
     return true;
 }
 
@@ -369,6 +136,90 @@ bool CDisplayImageList::write ( FILE*                f_file_p,
                                        f_parameters_str );
 }
 
+// Convert a region of an image to CV_8UC3 applying the same scale and
+// bias as the OpenGL pixel transfer of the texture upload.
+static void toBgr ( const cv::Mat & f_img,
+                    float           f_scale_f,
+                    float           f_bias_f,
+                    cv::Mat &       fr_bgr )
+{
+    double norm_d;
+
+    switch ( f_img.depth() )
+    {
+        case CV_8U:  norm_d = 255.;        break;
+        case CV_8S:  norm_d = 127.;        break;
+        case CV_16U: norm_d = 65535.;      break;
+        case CV_16S: norm_d = 32767.;      break;
+        case CV_32S: norm_d = 2147483647.; break;
+        default:     norm_d = 1.;          break;
+    }
+
+    cv::Mat img8;
+    f_img.convertTo ( img8, CV_8U, 
+                      255. * f_scale_f / norm_d, 
+                      255. * f_bias_f );
+
+    switch ( img8.channels() )
+    {
+        case 1:
+            cv::cvtColor ( img8, fr_bgr, CV_GRAY2BGR );
+            break;
+
+        case 2:
+        {
+            /// Luminance and alpha.
+            cv::Mat lum ( img8.size(), CV_8U );
+            int fromTo_p[] = { 0, 0 };
+            cv::mixChannels ( &img8, 1, &lum, 1, fromTo_p, 1 );
+            cv::cvtColor ( lum, fr_bgr, CV_GRAY2BGR );
+            break;
+        }
+
+        case 4:
+            cv::cvtColor ( img8, fr_bgr, CV_BGRA2BGR );
+            break;
+
+        default:
+            fr_bgr = img8;
+    }
+}
+
+// Render all images.
+bool CDisplayImageList::render ( CRasterTile & fr_tile ) const
+{
+    DisplayImageList_t::const_iterator last = m_image_v.end();
+
+    cv::Mat bgr;
+
+    for (DisplayImageList_t::const_iterator i = m_image_v.begin(); 
+         i != last; ++i )
+    {
+        /// Only the visible part of the image is converted.
+        const cv::Rect region = fr_tile.visibleRegion ( i->image.size(), 
+                                                        i->u_f, 
+                                                        i->v_f, 
+                                                        i->width_f, 
+                                                        i->height_f );
+        
+        if ( region.area() <= 0 )
+            continue;
+
+        toBgr ( i->image ( region ), i->scale_f, i->bias_f, bgr );
+
+        fr_tile.image ( bgr, 
+                        region, 
+                        i->image.size(),
+                        i->u_f, 
+                        i->v_f, 
+                        i->width_f, 
+                        i->height_f, 
+                        i->alpha_f );
+    }
+
+    return true;
+}
+
 /// Return number of elements.
 int
 CDisplayImageList::getSize () const
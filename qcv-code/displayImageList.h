@@ -38,6 +38,16 @@
  *  - an alpha component for transparency, and 
  *  - scale factor and bias to apply on the data for displaying, 
  *
+ * The images are uploaded as textures the first time they are shown.
+ * Textures are taken from a pool shared by all lists and returned to it
+ * when the list is cleared, so that they are reused in the next frames.
+ * Images with the same data (same cv::Mat buffer, size, type, scale and
+ * bias) uploaded in the same paint pass share the texture.
+ *
+ * Images are added without copy by default, so they share the data of
+ * the operator. Copies of the list (see CDrawingList::copyElements())
+ * share the data as well: it is reference counted and not copied.
+ *
  */
 
 /* INCLUDES */
@@ -83,8 +93,8 @@ namespace QCV
         // Clear all lines.
         virtual bool clear ();
 
-        // Draw all lines.
-        virtual bool show () const;
+        // Draw all images (OpenGL, defined in displayImageListGL.cpp).
+        bool show () const;
 
         // Write line in a SVG file.
         virtual bool write ( FILE*              f_file_p,
@@ -92,12 +102,20 @@ namespace QCV
                              const float        f_offsetV_f = 0.0,
                              const std::string  f_parameters_str = "") const;
 
+        // Render images into an image tile.
+        virtual bool render ( CRasterTile &      fr_tile ) const;
+
         // Return number of elements.
         virtual int  getSize () const;
 
         // Element names.
         virtual std::string  getGroupName() const { return "Images"; };
 
+        // Start a new paint pass. Must be called by the displays before
+        // showing the drawing lists (with the GL context current).
+        // Defined in displayImageListGL.cpp.
+        static void          beginPaint ( );
+
     protected:
         typedef struct
         {
@@ -119,13 +137,15 @@ namespace QCV
             /// Bias
             float          bias_f;
 
-            /// Texture id
-            unsigned int   textureId_ui;
-
-            /// Own resources?
-	    bool           ownResources_b;
+            /// Texture id (0 if not uploaded yet).
+            mutable unsigned int   textureId_ui;
         } SDisplayImage;
 
+    /// Private Methods
+    private:
+        /// Upload the images without texture.
+        void uploadTextures ( ) const;
+
     /// Private Members
     private:
         
@@ -133,6 +153,14 @@ namespace QCV
         
         /// Vector of images.
         DisplayImageList_t     m_image_v;        
+
+        /// Some images have not been uploaded yet.
+        mutable bool           m_pending_b;
+
+        /// Returns a texture to the pool of displayImageListGL.cpp. Set
+        /// by uploadTextures(), so it is set whenever there are textures
+        /// to release.
+        static void         (* m_releaseTexture_p) ( unsigned int f_id_ui );
     };
 } // Namespace QCV
 
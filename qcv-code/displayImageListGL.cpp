@@ -0,0 +1,516 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose. 
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+/*@@@**************************************************************************
+* \file  displayImageList
+* \author Hernan Badino
+* \notes 
+*******************************************************************************
+*****             (C) Hernan Badino 2012 - All Rights Reserved            *****
+******************************************************************************/
+
+/* INCLUDES */
+#include "displayImageList.h"
+
+#include <string.h>
+#include <map>
+
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+
+#include "glheader.h"
+
+using namespace QCV;
+
+static int cv2GLDType ( int f_cvFormat_i)
+{    
+    switch (f_cvFormat_i)
+    {
+       case CV_8S: 
+       //case CV_8SC1:
+       case CV_8SC2:
+       case CV_8SC3:
+       case CV_8SC4:
+           return GL_BYTE;
+       case CV_8U:
+       //case CV_8UC1:
+       case CV_8UC2:
+       case CV_8UC3:
+       case CV_8UC4:
+           return GL_UNSIGNED_BYTE;
+       case CV_16S:
+       //case CV_16SC1:
+       case CV_16SC2:
+       case CV_16SC3:
+       case CV_16SC4:
+           return GL_SHORT;
+       case CV_16U:
+       //case CV_16UC1:
+       case CV_16UC2:
+       case CV_16UC3:
+       case CV_16UC4:
+           return GL_UNSIGNED_SHORT;
+       case CV_32S:
+       //case CV_32SC1:
+       case CV_32SC2:
+       case CV_32SC3:
+       case CV_32SC4:
+           return GL_INT;
+       case CV_32F:
+       //case CV_32FC1:
+       case CV_32FC2:
+       case CV_32FC3:
+       case CV_32FC4:
+           return GL_FLOAT;
+       case CV_64F:
+       //case CV_64FC1:
+       case CV_64FC2:
+       case CV_64FC3:
+       case CV_64FC4:
+          return GL_DOUBLE;
+    }
+
+
+    return GL_UNSIGNED_BYTE;    
+}
+
+static int cv2GLFormat ( const cv::Mat &f_mat )
+{
+    switch ( f_mat.channels() )
+    {
+        case 2:
+            return GL_LUMINANCE_ALPHA;
+        case 3:
+            return GL_RGB;
+        case 4:
+            return GL_RGBA;
+    }
+
+    return GL_LUMINANCE;
+}
+
+static int cv2GLFormat2 ( const cv::Mat &f_mat )
+{
+    int val = cv2GLFormat ( f_mat );
+    
+    if (val == GL_RGB)
+        return GL_BGR;
+    else if (val == GL_RGBA)
+        return GL_BGRA;
+    
+    return val;
+}
+
+namespace
+{
+    /// Size and format of a texture.
+    struct STextureKey
+    {
+        int   width_i;
+        int   height_i;
+        int   format_i;
+
+        bool operator < ( const STextureKey & f_other ) const
+        {
+            if ( width_i  != f_other.width_i  ) return width_i  < f_other.width_i;
+            if ( height_i != f_other.height_i ) return height_i < f_other.height_i;
+            return format_i < f_other.format_i;
+        }
+    };
+
+    /// Data of an image as uploaded.
+    struct SImageKey
+    {
+        const uchar * data_p;
+        int           rows_i;
+        int           cols_i;
+        size_t        step_ui;
+        int           type_i;
+        float         scale_f;
+        float         bias_f;
+
+        bool operator < ( const SImageKey & f_other ) const
+        {
+            if ( data_p  != f_other.data_p  ) return data_p  < f_other.data_p;
+            if ( rows_i  != f_other.rows_i  ) return rows_i  < f_other.rows_i;
+            if ( cols_i  != f_other.cols_i  ) return cols_i  < f_other.cols_i;
+            if ( step_ui != f_other.step_ui ) return step_ui < f_other.step_ui;
+            if ( type_i  != f_other.type_i  ) return type_i  < f_other.type_i;
+            if ( scale_f != f_other.scale_f ) return scale_f < f_other.scale_f;
+            return bias_f < f_other.bias_f;
+        }
+    };
+
+    /// Textures shared by all image lists. Textures are reference 
+    /// counted; unreferenced textures are kept for reuse. GL calls are
+    /// only issued by acquire() and beginPaint(), so release() can be
+    /// called without GL context.
+    class CTexturePool
+    {
+    public:
+        CTexturePool()
+                : m_pbo_ui (                   0 ),
+                  m_pboChecked_b (         false )
+        {
+        }
+
+        /// Texture with the same image data uploaded in this paint pass.
+        unsigned int find ( const SImageKey & f_key )
+        {
+            QMutexLocker locker ( &m_mutex );
+
+            std::map<SImageKey, unsigned int>::const_iterator it = m_uploaded.find ( f_key );
+
+            if ( it == m_uploaded.end() )
+                return 0;
+
+            ++m_refs[it->second].count_i;
+            return it->second;
+        }
+
+        /// Get a texture of the given size and format.
+        unsigned int acquire ( const STextureKey & f_key )
+        {
+            QMutexLocker locker ( &m_mutex );
+
+            unsigned int id_ui;
+            std::multimap<STextureKey, unsigned int>::iterator it = m_free.find ( f_key );
+
+            if ( it != m_free.end() )
+            {
+                id_ui = it->second;
+                m_free.erase ( it );
+            }
+            else
+            {
+                glGenTextures ( 1, &id_ui );
+                glBindTexture ( GL_TEXTURE_RECTANGLE_NV, id_ui );
+
+                glTexParameteri( GL_TEXTURE_RECTANGLE_NV, GL_TEXTURE_WRAP_S, GL_CLAMP);
+                glTexParameteri( GL_TEXTURE_RECTANGLE_NV, GL_TEXTURE_WRAP_T, GL_CLAMP);
+                glTexParameteri( GL_TEXTURE_RECTANGLE_NV, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+                glTexParameteri( GL_TEXTURE_RECTANGLE_NV, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+
+                /// Only allocate the storage.
+                glTexImage2D( GL_TEXTURE_RECTANGLE_NV,
+                              0,
+                              f_key.format_i,
+                              f_key.width_i,
+                              f_key.height_i,
+                              0,
+                              GL_LUMINANCE,
+                              GL_UNSIGNED_BYTE,
+                              NULL );
+            }
+
+            STextureRef & ref = m_refs[id_ui];
+            ref.key     = f_key;
+            ref.count_i = 1;
+
+            return id_ui;
+        }
+
+        /// Register an uploaded texture for find().
+        void share ( const SImageKey & f_key,
+                     unsigned int      f_id_ui )
+        {
+            QMutexLocker locker ( &m_mutex );
+            m_uploaded[f_key] = f_id_ui;
+        }
+
+        /// Release a texture returned by acquire() or find().
+        void release ( unsigned int f_id_ui )
+        {
+            QMutexLocker locker ( &m_mutex );
+
+            std::map<unsigned int, STextureRef>::iterator it = m_refs.find ( f_id_ui );
+
+            if ( it == m_refs.end() || --it->second.count_i > 0 )
+                return;
+
+            /// The content of the texture will be overwritten.
+            for (std::map<SImageKey, unsigned int>::iterator u = m_uploaded.begin(); 
+                 u != m_uploaded.end(); )
+            {
+                if ( u->second == f_id_ui )
+                    m_uploaded.erase ( u++ );
+                else
+                    ++u;
+            }
+
+            m_free.insert ( std::make_pair ( it->second.key, f_id_ui ) );
+            m_refs.erase ( it );
+        }
+
+        /// Start a paint pass: forget the textures uploaded in the
+        /// previous pass and delete the textures that exceed the 
+        /// maximal number of free textures.
+        void beginPaint ( )
+        {
+            QMutexLocker locker ( &m_mutex );
+
+            m_uploaded.clear();
+
+            while ( m_free.size() > MAX_FREE_TEXTURES )
+            {
+                glDeleteTextures ( 1, &m_free.begin()->second );
+                m_free.erase ( m_free.begin() );
+            }
+        }
+
+        /// Upload an image into a texture of acquire(). The data is
+        /// copied into a pixel buffer object if available, so that the 
+        /// transfer to the texture is asynchronous.
+        void upload ( unsigned int      f_id_ui,
+                      const cv::Mat &   f_image,
+                      float             f_scale_f,
+                      float             f_bias_f )
+        {
+            glBindTexture( GL_TEXTURE_RECTANGLE_NV, f_id_ui );
+
+            glPixelTransferf ( GL_RED_SCALE,   f_scale_f );
+            glPixelTransferf ( GL_RED_BIAS,    f_bias_f  );        
+            glPixelTransferf ( GL_GREEN_SCALE, f_scale_f );
+            glPixelTransferf ( GL_GREEN_BIAS,  f_bias_f  );        
+            glPixelTransferf ( GL_BLUE_SCALE,  f_scale_f );
+            glPixelTransferf ( GL_BLUE_BIAS,   f_bias_f  );
+
+            glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+
+            const size_t rowSize_ui = f_image.cols * f_image.elemSize();
+
+#if defined ( GL_PIXEL_UNPACK_BUFFER ) && !defined ( WIN32 )
+            if ( hasPbo() )
+            {
+                glBindBuffer ( GL_PIXEL_UNPACK_BUFFER, m_pbo_ui );
+
+                /// Orphan the previous buffer, which might still be in use.
+                glBufferData ( GL_PIXEL_UNPACK_BUFFER, 
+                               rowSize_ui * f_image.rows, 
+                               NULL, 
+                               GL_STREAM_DRAW );
+
+                uchar * dst_p = (uchar *) glMapBuffer ( GL_PIXEL_UNPACK_BUFFER, 
+                                                        GL_WRITE_ONLY );
+
+                if ( dst_p )
+                {
+                    for (int i = 0; i < f_image.rows; ++i, dst_p += rowSize_ui)
+                        memcpy ( dst_p, f_image.ptr(i), rowSize_ui );
+
+                    glUnmapBuffer ( GL_PIXEL_UNPACK_BUFFER );
+
+                    glPixelStorei( GL_UNPACK_ROW_LENGTH, 0 );
+                    glTexSubImage2D( GL_TEXTURE_RECTANGLE_NV,
+                                     0,
+                                     0,
+                                     0,
+                                     f_image.cols,
+                                     f_image.rows,
+                                     cv2GLFormat2(f_image),
+                                     cv2GLDType(f_image.type()),
+                                     NULL );                   // offset in the buffer.
+
+                    glBindBuffer ( GL_PIXEL_UNPACK_BUFFER, 0 );
+                    return;
+                }
+
+                glBindBuffer ( GL_PIXEL_UNPACK_BUFFER, 0 );
+            }
+#endif
+            /// Rows of ROIs are not contiguous.
+            if ( f_image.step % f_image.elemSize() == 0 )
+            {
+                glPixelStorei( GL_UNPACK_ROW_LENGTH, f_image.step / f_image.elemSize() );
+                glTexSubImage2D( GL_TEXTURE_RECTANGLE_NV,
+                                 0,
+                                 0,
+                                 0,
+                                 f_image.cols,
+                                 f_image.rows,
+                                 cv2GLFormat2(f_image),
+                                 cv2GLDType(f_image.type()),
+                                 f_image.data );
+                glPixelStorei( GL_UNPACK_ROW_LENGTH, 0 );
+            }
+            else
+            {
+                cv::Mat copy = f_image.clone();
+
+                glPixelStorei( GL_UNPACK_ROW_LENGTH, 0 );
+                glTexSubImage2D( GL_TEXTURE_RECTANGLE_NV,
+                                 0,
+                                 0,
+                                 0,
+                                 copy.cols,
+                                 copy.rows,
+                                 cv2GLFormat2(copy),
+                                 cv2GLDType(copy.type()),
+                                 copy.data );
+            }
+        }
+
+    private:
+        /// Check once if pixel buffer objects are supported and create 
+        /// the buffer.
+        bool hasPbo ( )
+        {
+#if defined ( GL_PIXEL_UNPACK_BUFFER ) && !defined ( WIN32 )
+            if ( !m_pboChecked_b )
+            {
+                m_pboChecked_b = true;
+
+                const char * ext_p = (const char *) glGetString ( GL_EXTENSIONS );
+
+                if ( ext_p && strstr ( ext_p, "GL_ARB_pixel_buffer_object" ) )
+                    glGenBuffers ( 1, &m_pbo_ui );
+            }
+#endif
+            return m_pbo_ui != 0;
+        }
+
+        /// Maximal number of unreferenced textures kept for reuse.
+        static const size_t MAX_FREE_TEXTURES = 32;
+
+        struct STextureRef
+        {
+            STextureKey   key;
+            int           count_i;
+        };
+
+        /// Referenced textures.
+        std::map<unsigned int, STextureRef>        m_refs;
+
+        /// Unreferenced textures.
+        std::multimap<STextureKey, unsigned int>   m_free;
+
+        /// Textures uploaded in the current paint pass.
+        std::map<SImageKey, unsigned int>          m_uploaded;
+
+        /// Pixel buffer object for uploads.
+        GLuint                                     m_pbo_ui;
+
+        /// PBO support has been checked.
+        bool                                       m_pboChecked_b;
+
+        /// Lists might be cleared from another thread.
+        QMutex                                     m_mutex;
+    };
+
+    CTexturePool s_texturePool;
+
+    /// Return a texture to the pool (see CDisplayImageList::clear()).
+    void releaseTexture ( unsigned int f_id_ui )
+    {
+        s_texturePool.release ( f_id_ui );
+    }
+}
+
+// Start a new paint pass.
+void 
+CDisplayImageList::beginPaint ( )
+{
+    s_texturePool.beginPaint();
+}
+
+// Upload the images without texture.
+void CDisplayImageList::uploadTextures () const
+{
+    for (DisplayImageList_t::const_iterator i = m_image_v.begin(); 
+         i != m_image_v.end(); ++i )
+    {
+        if ( i->textureId_ui || i->image.empty() )
+            continue;
+
+        SImageKey imgKey;
+        imgKey.data_p  = i->image.data;
+        imgKey.rows_i  = i->image.rows;
+        imgKey.cols_i  = i->image.cols;
+        imgKey.step_ui = i->image.step;
+        imgKey.type_i  = i->image.type();
+        imgKey.scale_f = i->scale_f;
+        imgKey.bias_f  = i->bias_f;
+
+        i->textureId_ui = s_texturePool.find ( imgKey );
+
+        if ( i->textureId_ui )
+            continue;
+
+        STextureKey texKey;
+        texKey.width_i  = i->image.cols;
+        texKey.height_i = i->image.rows;
+        texKey.format_i = cv2GLFormat(i->image);
+
+        i->textureId_ui = s_texturePool.acquire ( texKey );
+        m_releaseTexture_p = releaseTexture;
+        s_texturePool.upload ( i->textureId_ui, i->image, i->scale_f, i->bias_f );
+        s_texturePool.share ( imgKey, i->textureId_ui );
+    }
+
+    m_pending_b = false;
+}
+
+// Draw all lines.
+bool CDisplayImageList::show () const
+{
+    if ( m_pending_b )
+        uploadTextures();
+
+    DisplayImageList_t::const_iterator last = m_image_v.end();
+
+    glEnable( GL_TEXTURE_RECTANGLE_NV);
+    glTexEnvf( GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+
+    for (DisplayImageList_t::const_iterator i = m_image_v.begin(); 
+         i != last; ++i )
+    {
+        if ( !i->textureId_ui )
+            continue;
+
+        glBindTexture( GL_TEXTURE_RECTANGLE_NV,
+                       i->textureId_ui );
+        
+        float endX_f = i->u_f + i->width_f;
+        float endY_f = i->v_f + i->height_f;
+        
+        glBegin(GL_QUADS);
+        
+        glTexCoord2f(0, 0);
+        glVertex2f(i->u_f, i->v_f);
+        
+        glTexCoord2f(i->image.size().width, 0);
+        glVertex2f(endX_f, i->v_f);
+
+        glTexCoord2f(i->image.size().width, i->image.size().height);
+        glVertex2f(endX_f, endY_f);
+
+        glTexCoord2f(0, i->image.size().height);
+        glVertex2f(i->u_f, endY_f);
+
+        glEnd();        
+    }
+
+    glDisable(GL_TEXTURE_RECTANGLE_NV); //  This takes a very long
+                                        //  time. It sould be optimized!
+
+    /// Todo: Check GL status and return value.
+    return true;
+}
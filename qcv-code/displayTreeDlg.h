@@ -69,6 +69,9 @@ namespace QCV
 
     public:
         virtual void update ( );
+
+        /// Mutex to hold while painting the preview.
+        void         setDrawMutex ( QMutex * f_mutex_p ) { m_qtvDisplays_p -> setDrawMutex ( f_mutex_p ); }
         
 
     private:
@@ -62,6 +62,12 @@ CDisplayTreeView::CDisplayTreeView( QWidget *  f_parent_p,
     
 }
 
+void 
+CDisplayTreeView::setDrawMutex ( QMutex * f_mutex_p )
+{
+    m_previewWidget_p -> setDrawMutex ( f_mutex_p );
+}
+
 void 
 CDisplayTreeView::loadParameters()
 {
@@ -39,6 +39,7 @@
 
 class QGLWidget;
 class QTimer;
+class QMutex;
 
 namespace QCV
 {
@@ -57,6 +58,9 @@ namespace QCV
         void     saveParameters();
         void     loadParameters();
 
+        /// Mutex to hold while painting the preview.
+        void     setDrawMutex ( QMutex * f_mutex_p );
+
     /// Public slots.
     public slots:
         
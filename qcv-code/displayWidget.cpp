@@ -86,6 +86,7 @@ CDisplayWidget::CDisplayWidget( QWidget *              f_parent_p,
         m_treeDlg_p = new CDisplayTreeDlg ( NULL,
                                             m_glDisplay_p,
                                             m_drawingListHandler_p -> getRootNode() );
+        m_treeDlg_p -> setDrawMutex ( m_drawingListHandler_p -> getDrawMutex() );
 
         m_drawingListHandler_p -> setScreenSize(m_glDisplay_p->getScreenSize());
         
@@ -262,6 +263,7 @@ void CDisplayWidget::createForm()
     m_dispFrame_p->setFrameShadow(QFrame::Raised);     //(/QFrame::Plain);
     
     m_glDisplay_p = new CDisplay ( m_drawingListHandler_p -> getRootNode(), m_dispFrame_p );
+    m_glDisplay_p -> setDrawMutex ( m_drawingListHandler_p -> getDrawMutex() );
     QGridLayout *dispLayout_p = new QGridLayout ( m_dispFrame_p );
     dispLayout_p->addWidget ( m_glDisplay_p );
     dispLayout_p->setContentsMargins ( 0, 0, 0, 0);
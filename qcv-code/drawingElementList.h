@@ -32,8 +32,10 @@
  *
  * \brief This abstract class provides the base for primitives drawing lists.
  *
- * Concrete child classes must implement the methods clear(), isBlendable(), 
- * show() and getSize().
+ * Concrete child classes must implement the methods clear(), isBlendable()
+ * and getSize(). Their OpenGL drawing method show() is not virtual: it is
+ * defined in the GUI library (see the *GL.cpp files), so that the lists
+ * can be used by programs that do not link OpenGL.
  *
  *******************************************************************************/
 
@@ -45,6 +47,8 @@
 
 namespace QCV
 {
+    class CRasterTile;
+
     class CDrawingElementList
     {
     public:
@@ -62,9 +66,6 @@ namespace QCV
         // Inform if this drawing list is blendable.
         virtual bool isBlendable() = 0;
         
-        // Draw all elements.
-        virtual bool show() const = 0;
-        
         // Number of elements.
         virtual int  getSize() const = 0;
         
@@ -74,6 +75,9 @@ namespace QCV
                              const float          f_offsetY_f = 0.0,
                              const std::string    f_prefix_str = "") const;
 
+        // Render elements into an image tile (see CRasterizer).
+        virtual bool render ( CRasterTile &        fr_tile ) const;
+
         // Number of elements.
         virtual std::string  getGroupName() const { return "DrawingElement"; };
 
@@ -90,6 +94,12 @@ namespace QCV
         //printf("write(...) not implemented for this class.\n");
         return false;
     }
+
+    inline
+    bool CDrawingElementList::render ( CRasterTile &        /* fr_tile */ ) const
+    {
+        return false;
+    }
     
     
 
@@ -29,9 +29,10 @@
 
 /* INCLUDES */
 #include "drawingList.h"
-#include "glheader.h"
+#include "rasterizer.h"
 #include "clipLine.h"
 #include <stdio.h>
+#include <algorithm>
 
 using namespace QCV;
 
@@ -48,7 +49,8 @@ CDrawingList::CDrawingList( std::string f_name_str )
           m_scaleY_d (                            1. ),
           m_offsetX_d (                           0. ),
           m_offsetY_d (                           0. ),
-          m_rotAngle_d (                          0. )
+          m_rotAngle_d (                          0. ),
+          m_published_p (                       NULL )
 {
     m_colorMask_p[0] = true;
     m_colorMask_p[1] = true;
@@ -58,7 +60,9 @@ CDrawingList::CDrawingList( std::string f_name_str )
     m_drawElems_v.push_back( &m_images );
     m_drawElems_v.push_back( &m_colorEncImages );
     m_drawElems_v.push_back( &m_lines );
+    m_drawElems_v.push_back( &m_polylines );
     m_drawElems_v.push_back( &m_rectangles );
+    m_drawElems_v.push_back( &m_squareTrails );
     m_drawElems_v.push_back( &m_polygons );
     m_drawElems_v.push_back( &m_triangles );
     m_drawElems_v.push_back( &m_ellipses );
@@ -67,6 +71,7 @@ CDrawingList::CDrawingList( std::string f_name_str )
 
 CDrawingList::~CDrawingList()
 {
+    delete m_published_p;
 }
 
 /// Add image.
@@ -311,6 +316,20 @@ CDrawingList::addFilledPolygon ( const std::vector< S2D<float> > &vertex_v )
                             m_lineWidth_f );
 }
 
+/// Add polyline
+bool
+CDrawingList::addPolyline ( const CPolyline * f_polyline_p )
+{
+    return m_polylines.add ( f_polyline_p );
+}
+
+/// Add square trail
+bool
+CDrawingList::addSquareTrail ( const CSquareTrail * f_trail_p )
+{
+    return m_squareTrails.add ( f_trail_p );
+}
+
 /// Add Quadrilateral.
 bool
 CDrawingList::addQuadrilateral ( const S2D<float> f_v0, 
@@ -642,46 +661,6 @@ CDrawingList::addCross ( const S2D<float> f_tl,
                       f_br.x, f_br.y );
 }
 
-/// Show all.        
-bool
-CDrawingList::show ()
-{
-    bool resShow_b;
-    bool success_b = true;
-    
-    std::vector< CDrawingElementList * >::const_iterator 
-        last = m_drawElems_v.end();
-
-    glColorMask( m_colorMask_p[0],
-                 m_colorMask_p[1],
-                 m_colorMask_p[2],
-                 m_colorMask_p[3] );
-
-    for (std::vector< CDrawingElementList * >::const_iterator 
-             i = m_drawElems_v.begin(); 
-         i != last; ++i )
-    {
-        if ((*i)->isBlendable())
-        {
-            glEnable(GL_BLEND);
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        }
-        else
-        {
-            glDisable(GL_BLEND);
-        }
-
-        resShow_b = (*i)->show();
-        success_b &= resShow_b;
-    }
-
-    glColorMask( true, true, true, false );
-
-    glDisable(GL_BLEND);
-
-    return success_b;
-}
-
 /// Clear all.        
 bool
 CDrawingList::clear ()
@@ -710,7 +689,9 @@ CDrawingList::addDrawingList ( const CDrawingList &f_other )
     m_images.add          ( f_other.m_images );
     m_colorEncImages.add  ( f_other.m_colorEncImages );
     m_lines.add           ( f_other.m_lines );
+    m_polylines.add       ( f_other.m_polylines );
     m_rectangles.add      ( f_other.m_rectangles );
+    m_squareTrails.add    ( f_other.m_squareTrails );
     m_triangles.add       ( f_other.m_triangles );
     m_ellipses.add        ( f_other.m_ellipses );
     m_strings.add         ( f_other.m_strings );
@@ -725,7 +706,9 @@ CDrawingList::getElementsCount() const
     return ( m_images.getSize () + 
              m_colorEncImages.getSize () + 
              m_lines.getSize () + 
+             m_polylines.getSize () + 
              m_rectangles.getSize () + 
+             m_squareTrails.getSize () + 
              m_triangles.getSize () + 
              m_ellipses.getSize () + 
              m_strings.getSize () +
@@ -804,6 +787,81 @@ CDrawingList::write(  std::string          f_path_str,
     return success_b;    
 }
 
+/// Replace the elements by copies.
+bool
+CDrawingList::copyElements ( const CDrawingList & f_other )
+{
+    clear();
+    addDrawingList ( f_other );
+
+    /// Elements added by pointer might change with the next cycle.
+    bool success_b = m_polylines.detach ( );
+    success_b &= m_squareTrails.detach ( );
+    success_b &= m_colorEncImages.detach ( );
+
+    return success_b;
+}
+
+/// Encode the color encoded images.
+bool
+CDrawingList::prepare ( ) const
+{
+    return m_colorEncImages.encode ( );
+}
+
+/// Show the elements of another list from now on.
+void
+CDrawingList::publish ( CDrawingList * & fr_list_p )
+{
+    std::swap ( m_published_p, fr_list_p );
+}
+
+/// Render all.
+bool
+CDrawingList::render ( CRasterTile & fr_tile ) const
+{
+    bool resRender_b;
+    bool success_b = true;
+
+    const bool masked_b = ( !m_colorMask_p[0] || 
+                            !m_colorMask_p[1] || 
+                            !m_colorMask_p[2] );
+
+    /// Masked channels are restored after rendering.
+    cv::Mat previous;
+
+    if ( masked_b )
+        fr_tile.getImage().copyTo ( previous );
+
+    std::vector< CDrawingElementList * >::const_iterator 
+        last = m_drawElems_v.end();
+
+    for (std::vector< CDrawingElementList * >::const_iterator 
+             i = m_drawElems_v.begin(); 
+         i != last; ++i )
+    {
+        resRender_b = (*i)->render ( fr_tile );
+        success_b &= resRender_b;
+    }
+
+    if ( masked_b )
+    {
+        /// The tile image is BGR.
+        cv::Mat & image = fr_tile.getImage();
+
+        for (int c = 0; c < 3; ++c)
+        {
+            if ( m_colorMask_p[2-c] )
+                continue;
+            
+            int fromTo_p[] = { c, c };
+            cv::mixChannels ( &previous, 1, &image, 1, fromTo_p, 1 );
+        }
+    }
+
+    return success_b;
+}
+
 bool
 CDrawingList::setScreenSize ( const S2D<unsigned int> f_size )
 {
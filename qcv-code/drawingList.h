@@ -36,6 +36,11 @@
  * The drawing list class provides a drawing tool for displaying or storing
  * drawings. Drawing primitives are rectangles, ellipses, lines, images, etc.
  *
+ * Once publish() has been called, show() does not paint the elements
+ * added to the list anymore but the copy last given to publish(), so that
+ * the operators can write the list while the copy is painted in another
+ * thread (see CDrawingListHandler::publish()).
+ *
  *******************************************************************************/
 
 /* INCLUDES */
@@ -46,6 +51,7 @@
 #include "ellipseList.h"
 #include "triangleList.h"
 #include "polygonList.h"
+#include "polylineList.h"
 #include "displayCEImageList.h"
 #include "textList.h"
 
@@ -216,6 +222,16 @@ namespace QCV
         /// Add filled polygon
         virtual bool        addFilledPolygon ( const std::vector< S2D<float> > &vertex_v );
 
+        /// Add polyline. The polyline is not copied and must live until
+        /// the list is cleared. It is drawn with its own color, line width 
+        /// and transformation to screen.
+        virtual bool        addPolyline ( const CPolyline * f_polyline_p );
+
+        /// Add square trail. The trail is not copied and must live until
+        /// the list is cleared. It is drawn with its own line width and
+        /// transformation to screen after the rectangles.
+        virtual bool        addSquareTrail ( const CSquareTrail * f_trail_p );
+
         /// Add Quadrilateral.
         virtual bool        addQuadrilateral ( const S2D<float> f_v0, 
                                                const S2D<float> f_v1,
@@ -364,12 +380,29 @@ namespace QCV
 
     //// Actions
     public:
-        /// Show all.
-        virtual bool          show ();        
+        /// Show the published elements (the elements of this list if
+        /// publish() has not been called). OpenGL, defined in
+        /// drawingListGL.cpp.
+        bool                  show ();
         
         /// Show all.
         virtual bool          clear ();
 
+        /// Replace the elements by copies of the elements of another
+        /// list. Unlike addDrawingList(), polylines, square trails and
+        /// color encoded images added by pointer are copied too, so 
+        /// that the other list can be written while this one is
+        /// painted. The image data is shared.
+        virtual bool          copyElements ( const CDrawingList & f_other );
+
+        /// Encode the color encoded images, so that show() only has to
+        /// upload them. Makes no GL calls.
+        virtual bool          prepare ( ) const;
+
+        /// Show the elements of fr_list_p from now on. fr_list_p gets
+        /// the list shown before (NULL the first time) for reuse.
+        virtual void          publish ( CDrawingList * & fr_list_p );
+
     public:
 
         /// Write in file.
@@ -379,6 +412,10 @@ namespace QCV
                                       const float          f_offsetX_f = 0.0,
                                       const float          f_offsetY_f = 0.0,
                                       const std::string    f_prefix_str = "");
+
+        /// Render in an image tile (see CRasterizer).
+        virtual bool          render ( CRasterTile &        fr_tile ) const;
+
     private:
 
         /// Name of this list.
@@ -413,9 +450,15 @@ namespace QCV
         /// List of lines.
         CLineList                           m_lines;
 
+        /// List of polylines.
+        CPolylineList                       m_polylines;
+
         /// List of rectangles.
         CRectangleList                      m_rectangles;
 
+        /// List of square trails.
+        CSquareTrailList                    m_squareTrails;
+
         /// List of ellipses.
         CEllipseList                        m_ellipses;
 
@@ -451,6 +494,9 @@ namespace QCV
 
         /// Offset Y
         double                              m_rotAngle_d;
+
+        /// Copy shown by show() (see publish()).
+        CDrawingList *                      m_published_p;
         
     };
 
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose. 
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+/*@@@**************************************************************************
+ * \file  drawingList
+ * \author Hernan Badino
+ * \notes 
+ *******************************************************************************
+ *****             (C) Hernan Badino 2012 - All Rights Reserved            *****
+ ******************************************************************************/
+
+/* INCLUDES */
+#include "drawingList.h"
+#include "glheader.h"
+
+using namespace QCV;
+
+/// Set up blending for a list and show it.
+template <class _List>
+static bool showElements ( _List & fr_list )
+{
+    if ( fr_list.isBlendable() )
+    {
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    }
+    else
+    {
+        glDisable(GL_BLEND);
+    }
+
+    return fr_list.show();
+}
+
+/// Show the published elements. The lists are shown in the order of
+/// m_drawElems_v.
+bool
+CDrawingList::show ()
+{
+    bool success_b = true;
+    
+    CDrawingList * list_p = m_published_p ? m_published_p : this;
+
+    glColorMask( m_colorMask_p[0],
+                 m_colorMask_p[1],
+                 m_colorMask_p[2],
+                 m_colorMask_p[3] );
+
+    success_b &= showElements ( list_p -> m_images );
+    success_b &= showElements ( list_p -> m_colorEncImages );
+    success_b &= showElements ( list_p -> m_lines );
+    success_b &= showElements ( list_p -> m_polylines );
+    success_b &= showElements ( list_p -> m_rectangles );
+    success_b &= showElements ( list_p -> m_squareTrails );
+    success_b &= showElements ( list_p -> m_polygons );
+    success_b &= showElements ( list_p -> m_triangles );
+    success_b &= showElements ( list_p -> m_ellipses );
+    success_b &= showElements ( list_p -> m_strings );
+
+    glColorMask( true, true, true, false );
+
+    glDisable(GL_BLEND);
+
+    return success_b;
+}
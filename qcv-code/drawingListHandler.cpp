@@ -31,15 +31,19 @@
 #include "node.h"
 #include "drawingListHandler.h"
 #include "displayTreeNode.h"
+#include "drawingList.h"
 #include <stdio.h>
 
+#include <QtCore/QMutexLocker>
+
 #define MAX_CONTAINER_LEVELS 256
 
 using namespace QCV;
 
 CDrawingListHandler::CDrawingListHandler (  CNode * f_opRoot_p )
         : m_root_p (                NULL ),
-          m_drawingListChanged_b ( false )
+          m_drawingListChanged_b ( false ),
+          m_snapshotTaken_b (      false )
 {
     if ( f_opRoot_p )
     {
@@ -58,6 +62,8 @@ CDrawingListHandler::getDrawingList ( std::string  f_name_str,
 {
     if (not f_op_p) return NULL;
 
+    QMutexLocker locker ( &m_mutex );
+
     CNode *  ops_p[MAX_CONTAINER_LEVELS];
     int level_i;
 
@@ -117,6 +123,14 @@ CDrawingListHandler::getDrawingList ( std::string  f_name_str,
     if (!child_p)
     {
         CDrawingList * drawList_p = new CDrawingList ( f_name_str );
+
+        /// The list might be written while the lists are painted.
+        if ( m_snapshotTaken_b )
+        {
+            CDrawingList * empty_p = new CDrawingList ( f_name_str );
+            drawList_p -> publish ( empty_p );
+        }
+
         child_p    = new CDisplayNode ( drawList_p );
         node_p -> appendChild ( child_p );
         return drawList_p;
@@ -132,3 +146,76 @@ CDrawingListHandler::setScreenSize ( const S2D<unsigned int> f_size )
     m_screenSize = f_size;
     return true;
 }
+
+/// Copy the elements of the lists of a node and its children.
+static void
+copyNode ( CDisplayOpNode *                         f_node_p,
+           std::map<CDrawingList *, CDrawingList *> & fr_copies )
+{
+    if ( f_node_p == NULL ) return;
+
+    for (unsigned int i = 0; i < f_node_p -> getDisplayCount(); ++i)
+    {
+        CDrawingList *   list_p = f_node_p -> getDisplayChild ( i ) -> getDrawingList();
+        CDrawingList * & copy_p = fr_copies[list_p];
+
+        if ( !copy_p )
+            copy_p = new CDrawingList ( list_p -> getName() );
+
+        copy_p -> copyElements ( *list_p );
+    }
+
+    for (unsigned int i = 0; i < f_node_p -> getOpCount(); ++i)
+        copyNode ( f_node_p -> getOpChild ( i ), fr_copies );
+}
+
+void
+CDrawingListHandler::takeSnapshot ( CDrawingListSnapshot & fr_snapshot )
+{
+    QMutexLocker locker ( &m_mutex );
+
+    copyNode ( m_root_p, fr_snapshot.m_copies );
+    m_snapshotTaken_b = true;
+}
+
+void
+CDrawingListHandler::publish ( CDrawingListSnapshot & fr_snapshot )
+{
+    QMutexLocker locker ( &m_drawMutex );
+
+    CDrawingListSnapshot::CopyMap_t::iterator it = fr_snapshot.m_copies.begin();
+
+    for (; it != fr_snapshot.m_copies.end(); ++it)
+        if ( it -> second )
+            it -> first -> publish ( it -> second );
+}
+
+void
+CDrawingListHandler::publish ( )
+{
+    takeSnapshot ( m_snapshot );
+    publish ( m_snapshot );
+}
+
+CDrawingListSnapshot::CDrawingListSnapshot()
+        : m_copies (         )
+{
+}
+
+CDrawingListSnapshot::~CDrawingListSnapshot()
+{
+    for (CopyMap_t::iterator it = m_copies.begin(); it != m_copies.end(); ++it)
+        delete it -> second;
+}
+
+bool
+CDrawingListSnapshot::prepare ( ) const
+{
+    bool success_b = true;
+
+    for (CopyMap_t::const_iterator it = m_copies.begin(); it != m_copies.end(); ++it)
+        if ( it -> second )
+            success_b &= it -> second -> prepare();
+
+    return success_b;
+}
@@ -41,6 +41,8 @@
 #include <string>
 #include <map>
 
+#include <QtCore/QMutex>
+
 #include "standardTypes.h"
 
 /* CONSTANTS */
@@ -58,6 +60,31 @@ namespace QCV
     class CNode;
     class CDrawingList;
     class CDisplayOpNode;
+
+    /// Copies of the elements of the drawing lists of a handler (see
+    /// CDrawingListHandler::takeSnapshot()). The copies are reused by
+    /// the next snapshots.
+    class CDrawingListSnapshot
+    {
+    public:
+        CDrawingListSnapshot();
+        ~CDrawingListSnapshot();
+
+        /// Encode the color encoded images of the copies (see
+        /// CDrawingList::prepare()).
+        bool              prepare ( ) const;
+
+    private:
+        CDrawingListSnapshot ( const CDrawingListSnapshot & );
+        CDrawingListSnapshot & operator = ( const CDrawingListSnapshot & );
+
+        friend class CDrawingListHandler;
+
+        typedef std::map< CDrawingList *, CDrawingList * > CopyMap_t;
+
+        /// Copy of every drawing list.
+        CopyMap_t         m_copies;
+    };
     
     class CDrawingListHandler
     {
@@ -92,6 +119,21 @@ namespace QCV
         /// Get drawing-list-changed flag.
         bool              mustUpdateDisplay ( ) const;
 
+        /// Mutex held while the drawing lists are published or painted.
+        QMutex *          getDrawMutex ( ) { return &m_drawMutex; }
+
+        /// Copy the elements of all drawing lists. Call after show() in
+        /// the thread running the operators.
+        void              takeSnapshot ( CDrawingListSnapshot & fr_snapshot );
+
+        /// Paint the copies of a snapshot from now on. The snapshot gets
+        /// the copies painted before. Holds the draw mutex.
+        void              publish ( CDrawingListSnapshot & fr_snapshot );
+
+        /// Paint the current elements of all drawing lists from now on
+        /// (takeSnapshot() and publish()).
+        void              publish ( );
+
     private:
 
         /// Root node.
@@ -102,6 +144,19 @@ namespace QCV
         
         /// Default screen size
         S2D<unsigned int>         m_screenSize;
+
+        /// Protects the tree when operators run concurrently.
+        QMutex                    m_mutex;
+
+        /// Protects the published drawing lists.
+        QMutex                    m_drawMutex;
+
+        /// Snapshot used by publish().
+        CDrawingListSnapshot      m_snapshot;
+
+        /// A snapshot has been taken. New lists then show only what is 
+        /// published.
+        bool                      m_snapshotTaken_b;
     };    
 
 
@@ -31,9 +31,11 @@
 
 #include <QtGui>
 #include <QtOpenGL>
+#include <QtCore/QMutexLocker>
 
 #include "drawingListPreview.h"
 #include "displayTreeNode.h"
+#include "displayImageList.h"
 
 using namespace QCV;
 
@@ -47,7 +49,8 @@ CDrawingListPreview::CDrawingListPreview( QWidget   *  f_associated_p,
                                              Qt::WindowStaysOnTopHint */ ),
           m_previewNode_p (                                      NULL ),
           m_screenSize (                                     800, 600 ),
-          m_associatedWidget_p (                       f_associated_p )
+          m_associatedWidget_p (                       f_associated_p ),
+          m_drawMutex_p (                                        NULL )
 {
     /// Enable focus on this widget.
     //setFocusPolicy(Qt::StrongFocus);
@@ -100,7 +103,12 @@ void CDrawingListPreview::paintGL()
 {
     if (!m_previewNode_p) 
         return;
+
+    /// The drawing lists might be written by another thread.
+    QMutexLocker locker ( m_drawMutex_p );
     
+    CDisplayImageList::beginPaint();
+
     // Reset modelview matrix
     glMatrixMode(GL_MODELVIEW);
     glLoadIdentity();
@@ -39,6 +39,7 @@
 
 /* INCLUDES */
 #include <QGLWidget>
+#include <QtCore/QMutex>
 #include "drawingList.h"
 
 namespace QCV
@@ -75,6 +76,9 @@ namespace QCV
         /// Set screen size.
         void setScreenSize ( S2D<unsigned int> f_size ) { m_screenSize = f_size; }
 
+        /// Mutex to hold while painting the drawing list.
+        void setDrawMutex ( QMutex * f_mutex_p ) { m_drawMutex_p = f_mutex_p; }
+
     /// Inherited members.
     protected:
         
@@ -100,6 +104,9 @@ namespace QCV
 
         /// Associated widget.
         QWidget *                  m_associatedWidget_p;
+
+        /// Mutex protecting the drawing lists.
+        QMutex *                   m_drawMutex_p;
     };
 }
 
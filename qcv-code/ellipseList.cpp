@@ -29,8 +29,8 @@
 
 /* INCLUDES */
 #include "ellipseList.h"
+#include "rasterizer.h"
 
-#include "glheader.h"
 #include <math.h>
 #include <stdio.h>
 
@@ -121,75 +121,6 @@ bool CEllipseList::clear ()
     return m_ellipse_v.size();
 }
 
-// Draw all ellipses.
-bool CEllipseList::show () const
-{
-    std::vector< SEllipse >::const_iterator last = m_ellipse_v.end();
-
-    for (std::vector< SEllipse >::const_iterator i = m_ellipse_v.begin(); 
-         i != last; ++i )
-    {
-        const int   segments_i  = 36;
-        const float increment_f = M_PI * 2. / segments_i;
-
-        float u_p[segments_i];
-        float v_p[segments_i];
-
-        float t = 0;
-
-        for( int s = 0; s < segments_i; ++s )
-        {
-            u_p[s] = i->radiusU_f * cos(t);
-            v_p[s] = i->radiusV_f * sin(t);
-            t += increment_f;
-        }
-
-        glPushMatrix();
-        glTranslatef ( i->u_f, i->v_f, 0.f );
-        glRotatef    ( i->rotation_f, 0.f, 0.f, 1.f );
-        //glTranslatef ( -i->u_f, -i->v_f, 0.f );
-
-        glLineWidth( i->lineWidth_f );
-
-        /// If not complete transparent.
-        if ( i->fillColor.a != 0 )
-        {
-            glColor4ub( i->fillColor.r, 
-                        i->fillColor.g, 
-                        i->fillColor.b, 
-                        i->fillColor.a );
-            
-            glBegin(GL_POLYGON);
-
-            for( int s = 0; s < segments_i; ++s )
-            {
-                glVertex2f( u_p[s], v_p[s] );
-            }
-
-            glEnd();
-        }       
-
-        glColor4ub( i->outlineColor.r, 
-                    i->outlineColor.g, 
-                    i->outlineColor.b, 
-                    i->outlineColor.a );
-        
-        glBegin ( GL_LINE_LOOP ) ;
-
-        for( int s = 0; s < segments_i; ++s )
-        {
-            glVertex2f( u_p[s], v_p[s] );
-        }
-        
-        glEnd();
-
-        glPopMatrix();
-    }
-
-    /// Todo: Check GL status and return value.
-    return true;
-}
-
 bool CEllipseList::write ( FILE*                f_file_p,
                            const float          f_offsetU_f /* = 0.0 */,
                            const float          f_offsetV_f /* = 0.0 */,
@@ -242,6 +173,44 @@ bool CEllipseList::write ( FILE*                f_file_p,
     return true;
 }
 
+// Render all ellipses.
+bool CEllipseList::render ( CRasterTile & fr_tile ) const
+{
+    /// Same polygonal approximation as show().
+    const int   segments_i  = 36;
+    const float increment_f = M_PI * 2. / segments_i;
+
+    std::vector< SEllipse >::const_iterator last = m_ellipse_v.end();
+    std::vector< S2D<float> > vertex_v ( segments_i );
+
+    for (std::vector< SEllipse >::const_iterator i = m_ellipse_v.begin(); 
+         i != last; ++i )
+    {
+        const float cos_f = cos ( i->rotation_f * M_PI / 180. );
+        const float sin_f = sin ( i->rotation_f * M_PI / 180. );
+
+        float t = 0;
+
+        for( int s = 0; s < segments_i; ++s )
+        {
+            const float u_f = i->radiusU_f * cos(t);
+            const float v_f = i->radiusV_f * sin(t);
+
+            vertex_v[s].x = i->u_f + cos_f * u_f - sin_f * v_f;
+            vertex_v[s].y = i->v_f + sin_f * u_f + cos_f * v_f;
+
+            t += increment_f;
+        }
+
+        fr_tile.polygon ( vertex_v, 
+                          i->outlineColor, 
+                          i->fillColor, 
+                          i->lineWidth_f );
+    }
+
+    return true;
+}
+
 /// Return number of elements.
 int
 CEllipseList::getSize () const
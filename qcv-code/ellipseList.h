@@ -95,8 +95,8 @@ namespace QCV
         // Clear all ellipses.
         virtual bool clear ();
 
-        // Draw all ellipses.
-        virtual bool show () const;
+        // Draw all ellipses (OpenGL, defined in ellipseListGL.cpp).
+        bool show () const;
 
         // Write ellipse in a SVG file.
         virtual bool write ( FILE*                f_file_p,
@@ -104,6 +104,9 @@ namespace QCV
                              const float          f_offsetV_f = 0.0,
                              const std::string    f_parameters_str = "") const;
 
+        // Render ellipses into an image tile.
+        virtual bool render ( CRasterTile &      fr_tile ) const;
+
         // Return number of elements.
         virtual int  getSize () const;
 
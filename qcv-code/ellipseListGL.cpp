@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose. 
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+/*@@@**************************************************************************
+ * \file  ellipseListGL.cpp
+ * \author Hernan Badino
+ * \notes 
+ *******************************************************************************
+ *****             (C) Hernan Badino 2012 - All Rights Reserved            *****
+ ******************************************************************************/
+
+/* INCLUDES */
+#include "ellipseList.h"
+#include "glheader.h"
+#include <math.h>
+
+using namespace QCV;
+
+// Draw all ellipses.
+bool CEllipseList::show () const
+{
+    std::vector< SEllipse >::const_iterator last = m_ellipse_v.end();
+
+    for (std::vector< SEllipse >::const_iterator i = m_ellipse_v.begin(); 
+         i != last; ++i )
+    {
+        const int   segments_i  = 36;
+        const float increment_f = M_PI * 2. / segments_i;
+
+        float u_p[segments_i];
+        float v_p[segments_i];
+
+        float t = 0;
+
+        for( int s = 0; s < segments_i; ++s )
+        {
+            u_p[s] = i->radiusU_f * cos(t);
+            v_p[s] = i->radiusV_f * sin(t);
+            t += increment_f;
+        }
+
+        glPushMatrix();
+        glTranslatef ( i->u_f, i->v_f, 0.f );
+        glRotatef    ( i->rotation_f, 0.f, 0.f, 1.f );
+        //glTranslatef ( -i->u_f, -i->v_f, 0.f );
+
+        glLineWidth( i->lineWidth_f );
+
+        /// If not complete transparent.
+        if ( i->fillColor.a != 0 )
+        {
+            glColor4ub( i->fillColor.r, 
+                        i->fillColor.g, 
+                        i->fillColor.b, 
+                        i->fillColor.a );
+            
+            glBegin(GL_POLYGON);
+
+            for( int s = 0; s < segments_i; ++s )
+            {
+                glVertex2f( u_p[s], v_p[s] );
+            }
+
+            glEnd();
+        }       
+
+        glColor4ub( i->outlineColor.r, 
+                    i->outlineColor.g, 
+                    i->outlineColor.b, 
+                    i->outlineColor.a );
+        
+        glBegin ( GL_LINE_LOOP ) ;
+
+        for( int s = 0; s < segments_i; ++s )
+        {
+            glVertex2f( u_p[s], v_p[s] );
+        }
+        
+        glEnd();
+
+        glPopMatrix();
+    }
+
+    /// Todo: Check GL status and return value.
+    return true;
+}
@@ -37,15 +37,19 @@
  *******************************************************************************/
 
 /* INCLUDES */
-#include <QtGui/QMouseEvent>
-#include <QtGui/QRegion>
-#include <QtGui/QKeyEvent>
-#include <QtGui/QWheelEvent>
-
 #include "standardTypes.h"
 
 /* CONSTANTS */
 
+/* PROTOTYPES */
+/// The Qt events are only declared, so that the operators can be built
+/// without QtGui. Include the Qt headers to access the events.
+class QMouseEvent;
+class QRegion;
+class QKeyEvent;
+class QWheelEvent;
+class QTimerEvent;
+
 /* TYPE DEFINITION */
 namespace QCV
 {
@@ -53,7 +57,7 @@ namespace QCV
     {
     public:
         QMouseEvent * mouseEvent;
-        QRegion       region;
+        QRegion *     region_p;
     };
     
     class CMouseEvent
@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose. 
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+
+/**
+ * Processes a sequence with a root operator without GUI and prints the
+ * computation times of all operators.
+ *
+ * Usage: batchRunner sequence [--op stereo|stereoTracker] [--params file]
+ *                             [--frames N] [--show] [--video file]
+ *                             [--screens WxH] [--trace file]
+ *                             [--stats file]
+ *
+ * The sequence can be a sequence XML file, a packed sequence (.qseq) or
+ * a video. The parameters are loaded from the given file (default
+ * params_stereo.xml or params_stereoTracker.xml) but not saved.
+ * --show calls show() after every cycle so that the drawing lists are
+ * generated as well. --video renders the drawing lists of every frame
+ * in software (see CRasterizer) and writes them in a video file; the
+ * screens are arranged as given with --screens (default 2x2).
+ * --trace records every clock measurement and writes them in Chrome
+ * trace format (chrome://tracing, Perfetto) into the given file.
+ * --stats writes count, total, mean, min, max and the 50th, 95th and
+ * 99th percentile times of every clock into the given file (JSON if
+ * the name ends with .json, otherwise CSV).
+ * The exit status is 1 if the device could not be initialized or a
+ * frame could not be processed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+#include <QCoreApplication>
+
+#include "batchRunner.h"
+#include "clockHandler.h"
+#include "stereoOp.h"
+#include "stereoTrackerOp.h"
+#include "seqDevHDImg.h"
+#include "seqDevPackedSeq.h"
+#include "seqDevVideoCapture.h"
+#include "paramIOXmlFile.h"
+
+using namespace QCV;
+
+static bool endsWith ( const std::string & f_str, 
+                       const std::string & f_end_str )
+{
+    return ( f_str.size() > f_end_str.size() && 
+             f_str.substr ( f_str.size() - f_end_str.size() ) == f_end_str );
+}
+
+static void usage ( const char * f_name_p )
+{
+    printf("Usage %s sequence [--op stereo|stereoTracker] [--params file] [--frames N] [--show] [--video file] [--screens WxH] [--trace file] [--stats file]\n", f_name_p);
+    exit(1);
+}
+
+int main(int f_argc_i, char *f_argv_p[])
+{
+    if ( f_argc_i < 2 )
+        usage ( f_argv_p[0] );
+
+    std::string seqFile_str   = f_argv_p[1];
+    std::string op_str        = "stereoTracker";
+    std::string paramFile_str = "";
+    int         frames_i      = 0;
+    bool        show_b        = false;
+    std::string video_str     = "";
+    int         screensX_i    = 2;
+    int         screensY_i    = 2;
+    std::string trace_str     = "";
+    std::string stats_str     = "";
+
+    for (int i = 2; i < f_argc_i; ++i)
+    {
+        std::string arg_str = f_argv_p[i];
+
+        if ( arg_str == "--show" )
+            show_b = true;
+        else if ( arg_str == "--op" && i+1 < f_argc_i )
+            op_str = f_argv_p[++i];
+        else if ( arg_str == "--params" && i+1 < f_argc_i )
+            paramFile_str = f_argv_p[++i];
+        else if ( arg_str == "--frames" && i+1 < f_argc_i )
+            frames_i = atoi ( f_argv_p[++i] );
+        else if ( arg_str == "--video" && i+1 < f_argc_i )
+            video_str = f_argv_p[++i];
+        else if ( arg_str == "--trace" && i+1 < f_argc_i )
+            trace_str = f_argv_p[++i];
+        else if ( arg_str == "--stats" && i+1 < f_argc_i )
+            stats_str = f_argv_p[++i];
+        else if ( arg_str == "--screens" && i+1 < f_argc_i )
+        {
+            if ( sscanf ( f_argv_p[++i], "%ix%i", &screensX_i, &screensY_i ) != 2 ||
+                 screensX_i < 1 || screensY_i < 1 )
+                usage ( f_argv_p[0] );
+        }
+        else
+            usage ( f_argv_p[0] );
+    }
+
+    /// No QApplication: there are no widgets and no GL context.
+    QCoreApplication app (f_argc_i, f_argv_p);
+
+    /// Create root operator
+    COperator * rootOp_p = NULL;
+
+    if ( op_str == "stereo" )
+        rootOp_p = new CStereoOp( );
+    else if ( op_str == "stereoTracker" )
+        rootOp_p = new CStereoTrackerOp( );
+    else
+        usage ( f_argv_p[0] );
+
+    if ( paramFile_str == "" )
+        paramFile_str = "params_" + op_str + ".xml";
+
+    /// Load parameters
+    CParamIOXmlFile pio ( paramFile_str );
+    rootOp_p->getParameterSet() -> load ( pio );
+
+    CSeqDeviceControl * device_p;
+
+    if ( endsWith ( seqFile_str, ".xml" ) )
+        device_p = new CSeqDevHDImg ( seqFile_str );
+    else if ( endsWith ( seqFile_str, ".qseq" ) )
+        device_p = new CSeqDevPackedSeq ( seqFile_str );
+    else
+        device_p = new CSeqDevVideoCapture ( seqFile_str );
+
+    CBatchRunner runner ( device_p, rootOp_p );
+
+    runner.setShow ( show_b );
+    runner.setMaxFrames ( frames_i );
+    runner.setVideoOutput ( video_str );
+    runner.getRasterizer().setScreenCount ( S2D<unsigned int> ( screensX_i, screensY_i ) );
+
+    if ( !trace_str.empty() )
+        COperator::getClockHandler() -> startTracing();
+
+    bool success_b = runner.run();
+
+    if ( runner.getProcessedFrames() > 0 )
+        runner.printStatistics();
+
+    if ( !trace_str.empty() )
+    {
+        COperator::getClockHandler() -> stopTracing();
+        COperator::getClockHandler() -> writeTrace ( trace_str );
+    }
+
+    if ( !stats_str.empty() )
+        COperator::getClockHandler() -> writeStatistics ( stats_str );
+
+    delete rootOp_p;
+    delete device_p;
+
+    return success_b?0:1;
+}
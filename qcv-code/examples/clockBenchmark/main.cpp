@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose. 
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+/**
+ * Benchmark of the overhead of starting and stopping an operator clock.
+ *
+ * Usage: clockBenchmark [depth [iterations]]
+ *
+ * Builds a chain of depth operators (default 4) with several clocks
+ * each and measures the mean time of a start/stop pair of a clock of
+ * the deepest operator:
+ *  - lookup:  the clock is looked up in the clock handler at start and
+ *             at stop (what COperator::startClock/stopClock did before),
+ *  - string:  COperator::startClock/stopClock,
+ *  - handle:  start/stop of the clock returned by registerClock,
+ *  - scoped:  CScopedClock with the same clock.
+ * The difference to "handle" is the cost of finding the clock.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "operator.h"
+#include "clock.h"
+#include "clockHandler.h"
+
+using namespace QCV;
+
+/// Mean time in ns of a start/stop pair.
+static double perPair ( double f_start_d, int f_iterations_i )
+{
+    return ( CClock::getTime() - f_start_d ) * 1.e6 / f_iterations_i;
+}
+
+int main(int f_argc_i, char *f_argv_p[])
+{
+    int depth_i      = 4;
+    int iterations_i = 1000000;
+
+    if ( f_argc_i >= 2 )
+        depth_i = std::max(atoi(f_argv_p[1]), 1);
+
+    if ( f_argc_i >= 3 )
+        iterations_i = std::max(atoi(f_argv_p[2]), 1);
+
+    const char * names_p[] = { "Pre-filtering", "Pyramid construction", 
+                               "First Correlation", "Refinement level 0",
+                               "Disparity Image Generation" };
+    const int numNames_i = sizeof(names_p) / sizeof(names_p[0]);
+
+    /// Chain of operators with some clocks each.
+    std::vector<COperator *> ops_v;
+    ops_v.push_back ( new COperator ( NULL, "Root" ) );
+
+    for (int i = 1; i < depth_i; ++i)
+    {
+        char name_str[64];
+        sprintf ( name_str, "Operator %i", i );
+
+        COperator * op_p = new COperator ( ops_v.back(), name_str );
+        ops_v.back() -> addChild ( op_p );
+        ops_v.push_back ( op_p );
+    }
+
+    for (int i = 0; i < depth_i; ++i)
+        for (int j = 0; j < numNames_i; ++j)
+            ops_v[i] -> registerClock ( names_p[j] );
+
+    COperator *         op_p      = ops_v.back();
+    const std::string   name_str  = names_p[numNames_i-1];
+    CClockHandler *     handler_p = COperator::getClockHandler();
+    CClock *            clock_p   = op_p -> registerClock ( name_str );
+
+    double start_d = CClock::getTime();
+    for (int i = 0; i < iterations_i; ++i)
+    {
+        handler_p -> getClock ( name_str, op_p ) -> start();
+        handler_p -> getClock ( name_str, op_p ) -> stop();
+    }
+    const double lookup_d = perPair ( start_d, iterations_i );
+
+    start_d = CClock::getTime();
+    for (int i = 0; i < iterations_i; ++i)
+    {
+        op_p -> startClock ( name_str );
+        op_p -> stopClock  ( name_str );
+    }
+    const double string_d = perPair ( start_d, iterations_i );
+
+    start_d = CClock::getTime();
+    for (int i = 0; i < iterations_i; ++i)
+    {
+        clock_p -> start();
+        clock_p -> stop();
+    }
+    const double handle_d = perPair ( start_d, iterations_i );
+
+    start_d = CClock::getTime();
+    for (int i = 0; i < iterations_i; ++i)
+    {
+        CScopedClock clock ( clock_p );
+    }
+    const double scoped_d = perPair ( start_d, iterations_i );
+
+    printf("Depth %i, %i clocks per operator, %i iterations\n", 
+           depth_i, numNames_i, iterations_i);
+    printf("%8s %14s\n", "", "start/stop [ns]");
+    printf("%8s %14.1f\n", "lookup", lookup_d);
+    printf("%8s %14.1f\n", "string", string_d);
+    printf("%8s %14.1f\n", "handle", handle_d);
+    printf("%8s %14.1f\n", "scoped", scoped_d);
+
+    delete ops_v[0];
+
+    return 0;
+}
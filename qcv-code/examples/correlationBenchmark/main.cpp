@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose. 
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+/**
+ * Benchmark of the ZSSD correlation kernels of CFeatureStereoOp.
+ *
+ * Usage: correlationBenchmark [left_image right_image [runs]]
+ *
+ * Defaults to imgs/left.pgm and imgs/right.pgm. For several mask sizes
+ * and disparity ranges, correlates a grid of left windows with all
+ * right windows in the range. The scalar float loop that was used
+ * before is compared with CZssdCorrelation: mean time per run, speedup
+ * and the number of ZSSD or SSD scores that differ (must be 0).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <opencv/cv.h>
+#include <opencv/highgui.h>
+
+#include "zssdCorrelation.h"
+
+using namespace QCV;
+
+/// Window centers of the benchmark.
+struct SWindow
+{
+    int u_i;
+    int v_i;
+    int uMin_i;
+    int uMax_i;
+};
+
+/// Previous scalar correlation of CFeatureStereoOp.
+static void correlateScalar ( const cv::Mat &      f_imgL,
+                              const cv::Mat &      f_imgR,
+                              const SWindow &      f_win,
+                              S2D<int>             f_hMask,
+                              float *              fr_zssd_p,
+                              float *              fr_ssd_p )
+{
+    const int maskSize_i = (2*f_hMask.width+1) * (2*f_hMask.height+1);
+
+    for (int colrPos = f_win.uMin_i; colrPos <= f_win.uMax_i; ++colrPos)
+    {
+        float sumL_f    = 0.f;
+        float sumR_f    = 0.f;
+        float sumSq_f   = 0.f;
+
+        for (int i = f_win.v_i - f_hMask.height; i <= f_win.v_i + f_hMask.height; ++i)
+        {
+            const uint8_t *ptrL_p = &f_imgL.at<uint8_t>(i, f_win.u_i - f_hMask.width);
+            const uint8_t *ptrR_p = &f_imgR.at<uint8_t>(i, colrPos   - f_hMask.width);
+
+            for (int j = 0; j < 2*f_hMask.width+1; ++j, ++ptrL_p, ++ptrR_p)
+            {
+                float diff_f = (float)*ptrL_p - (float)*ptrR_p;
+                sumL_f  += *ptrL_p;
+                sumR_f  += *ptrR_p;
+                sumSq_f += diff_f * diff_f;
+            }
+        }
+
+        float avgDiff_f = (sumL_f - sumR_f);
+        float sqDiff_f  = avgDiff_f * avgDiff_f / maskSize_i;
+
+        fr_zssd_p[colrPos - f_win.uMin_i] = sumSq_f - sqDiff_f;
+        fr_ssd_p [colrPos - f_win.uMin_i] = sumSq_f;
+    }
+}
+
+/// Same scores with CZssdCorrelation.
+static void correlateKernel ( CZssdCorrelation &   fr_corr,
+                              const cv::Mat &      f_imgL,
+                              const cv::Mat &      f_imgR,
+                              const SWindow &      f_win,
+                              S2D<int>             f_hMask,
+                              float *              fr_zssd_p,
+                              float *              fr_ssd_p )
+{
+    const int maskSize_i = (2*f_hMask.width+1) * (2*f_hMask.height+1);
+
+    fr_corr.setLeftWindow ( f_imgL, f_win.u_i, f_win.v_i, f_hMask );
+    fr_corr.compute ( f_imgR, f_win.uMin_i, f_win.uMax_i );
+
+    const float sumL_f = fr_corr.getSumL();
+
+    for (int k = 0; k <= f_win.uMax_i - f_win.uMin_i; ++k)
+    {
+        float sumR_f    = fr_corr.getSumR(k);
+        float sumSq_f   = fr_corr.getSumSqDiff(k);
+        float avgDiff_f = (sumL_f - sumR_f);
+        float sqDiff_f  = avgDiff_f * avgDiff_f / maskSize_i;
+
+        fr_zssd_p[k] = sumSq_f - sqDiff_f;
+        fr_ssd_p [k] = sumSq_f;
+    }
+}
+
+int main(int f_argc_i, char *f_argv_p[])
+{
+    std::string left_str  = "imgs/left.pgm";
+    std::string right_str = "imgs/right.pgm";
+    int         runs_i    = 5;
+
+    if ( f_argc_i >= 3 )
+    {
+        left_str  = f_argv_p[1];
+        right_str = f_argv_p[2];
+    }
+
+    if ( f_argc_i >= 4 )
+        runs_i = std::max(atoi(f_argv_p[3]), 1);
+
+    cv::Mat left  = cv::imread ( left_str,  0 );
+    cv::Mat right = cv::imread ( right_str, 0 );
+
+    if ( left.empty() || right.empty() || left.size() != right.size() )
+    {
+        printf("Usage %s [left_image right_image [runs]]\n", f_argv_p[0]);
+        exit(1);
+    }
+
+    const int masks_p[]  = { 3, 5, 7, 11, 15, 17, 21 };
+    const int ranges_p[] = { 4, 16, 32, 64, 128 };
+    const int numMasks_i  = sizeof(masks_p)  / sizeof(masks_p[0]);
+    const int numRanges_i = sizeof(ranges_p) / sizeof(ranges_p[0]);
+
+    printf("Image size %ix%i, %i runs\n", left.cols, left.rows, runs_i);
+    printf("%5s %6s %8s %12s %12s %8s %10s\n",
+           "mask", "range", "windows", "scalar [ms]", "kernel [ms]", "speedup", "mismatches");
+
+    CZssdCorrelation corr;
+
+    for (int m = 0; m < numMasks_i; ++m)
+    {
+        for (int r = 0; r < numRanges_i; ++r)
+        {
+            const S2D<int> hMask ( masks_p[m]/2, masks_p[m]/2 );
+            const int      range_i = ranges_p[r];
+
+            /// Grid of left windows with all right windows inside the image.
+            std::vector<SWindow> windows_v;
+
+            for (int v = hMask.height; v < left.rows - hMask.height; v += 8)
+            {
+                for (int u = hMask.width + range_i; u < left.cols - hMask.width; u += 8)
+                {
+                    SWindow win;
+                    win.u_i    = u;
+                    win.v_i    = v;
+                    win.uMin_i = u - range_i;
+                    win.uMax_i = u;
+                    windows_v.push_back ( win );
+                }
+            }
+
+            if ( windows_v.empty() )
+                continue;
+
+            std::vector<float> zssdRef_v ( range_i + 1 ), ssdRef_v ( range_i + 1 );
+            std::vector<float> zssd_v    ( range_i + 1 ), ssd_v    ( range_i + 1 );
+
+            int64 start_i = cv::getTickCount();
+            for (int run = 0; run < runs_i; ++run)
+                for (size_t w = 0; w < windows_v.size(); ++w)
+                    correlateScalar ( left, right, windows_v[w], hMask, &zssdRef_v[0], &ssdRef_v[0] );
+            const double scalar_d = ( cv::getTickCount() - start_i ) * 1000. / ( cv::getTickFrequency() * runs_i );
+
+            start_i = cv::getTickCount();
+            for (int run = 0; run < runs_i; ++run)
+                for (size_t w = 0; w < windows_v.size(); ++w)
+                    correlateKernel ( corr, left, right, windows_v[w], hMask, &zssd_v[0], &ssd_v[0] );
+            const double kernel_d = ( cv::getTickCount() - start_i ) * 1000. / ( cv::getTickFrequency() * runs_i );
+
+            int mismatches_i = 0;
+
+            for (size_t w = 0; w < windows_v.size(); ++w)
+            {
+                correlateScalar ( left, right, windows_v[w], hMask, &zssdRef_v[0], &ssdRef_v[0] );
+                correlateKernel ( corr, left, right, windows_v[w], hMask, &zssd_v[0], &ssd_v[0] );
+
+                for (int k = 0; k <= range_i; ++k)
+                    if ( zssd_v[k] != zssdRef_v[k] || ssd_v[k] != ssdRef_v[k] )
+                        ++mismatches_i;
+            }
+
+            printf("%2ix%-2i %6i %8i %12.2f %12.2f %8.2f %10i\n",
+                   masks_p[m], masks_p[m], range_i, (int) windows_v.size(),
+                   scalar_d, kernel_d, kernel_d > 0?scalar_d / kernel_d:0., mismatches_i );
+        }
+    }
+
+    return 0;
+}
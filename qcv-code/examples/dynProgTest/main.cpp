@@ -0,0 +1,252 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose.
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+/**
+ * Test of the solver modes of CDynamicProgrammingOp.
+ *
+ * Usage: dynProgTest [frames [seed]]
+ *
+ * Runs SM_BRUTE_FORCE and SM_LOWER_ENVELOPE on the same random cost
+ * images, with and without expected gradient, distance cost vector,
+ * follow path and path tolerance vector. Costs are random floats,
+ * integers (many ties) or constant rows, with some invalid cells. The
+ * node images (costs and parents) and the paths must be identical.
+ * Returns 1 if any of them differs.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+#include <opencv/cv.h>
+
+#include "dynProgOp.h"
+#include "clock.h"
+
+using namespace QCV;
+
+/// Test configuration.
+struct SConfig
+{
+    const char * name_p;
+    bool         gradient_b;
+    bool         distCostVector_b;
+    bool         followPath_b;
+    bool         pathTolVector_b;
+};
+
+/// Random float in [f_min_f, f_max_f].
+static float random ( float f_min_f, float f_max_f )
+{
+    return f_min_f + (f_max_f - f_min_f) * (rand() / (float) RAND_MAX);
+}
+
+/// Fills a cost image. Type 0: random floats, 1: integers, 2:
+/// constant rows. Costs <= 0 are invalid.
+static void randomCosts ( cv::Mat & fr_img, int f_type_i )
+{
+    for (int i = 0; i < fr_img.rows; ++i)
+    {
+        const float rowCost_f = (float) (1 + rand() % 4);
+
+        for (int j = 0; j < fr_img.cols; ++j)
+        {
+            float cost_f;
+
+            if ( f_type_i == 0 )
+                cost_f = random ( 0.f, 100.f );
+            else if ( f_type_i == 1 )
+                cost_f = (float) (1 + rand() % 8);
+            else
+                cost_f = rowCost_f;
+
+            /// Some invalid cells.
+            if ( rand() % 20 == 0 )
+                cost_f = -1.f;
+
+            fr_img.at<float>(i,j) = cost_f;
+        }
+    }
+}
+
+/// Number of different nodes.
+static int compareNodes ( const cv::Mat & f_nodes1,
+                          const cv::Mat & f_nodes2 )
+{
+    typedef CDynamicProgrammingOp::Node Node;
+
+    const int width_i = f_nodes1.cols / sizeof(Node);
+    int       diff_i  = 0;
+
+    for (int i = 0; i < f_nodes1.rows; ++i)
+    {
+        for (int j = 0; j < width_i; ++j)
+        {
+            const Node & n1 = f_nodes1.at<Node>(i,j);
+            const Node & n2 = f_nodes2.at<Node>(i,j);
+
+            if ( memcmp ( &n1.m_nodCost_f, &n2.m_nodCost_f, sizeof(float) ) ||
+                 memcmp ( &n1.m_accCost_f, &n2.m_accCost_f, sizeof(float) ) ||
+                 n1.m_parNode_i != n2.m_parNode_i )
+                ++diff_i;
+        }
+    }
+
+    return diff_i;
+}
+
+int main(int f_argc_i, char *f_argv_p[])
+{
+    int frames_i = 20;
+    int seed_i   = 1;
+
+    if ( f_argc_i >= 2 )
+        frames_i = std::max(atoi(f_argv_p[1]), 1);
+
+    if ( f_argc_i >= 3 )
+        seed_i = atoi(f_argv_p[2]);
+
+    srand ( seed_i );
+
+    const int width_i  = 320;
+    const int height_i = 120;
+
+    const SConfig configs_p[] = {
+        { "plain",                  false, false, false, false },
+        { "gradient",               true,  false, false, false },
+        { "gradient+distcost",      true,  true,  false, false },
+        { "follow path",            false, false, true,  false },
+        { "all",                    true,  true,  true,  true  } };
+
+    const int numConfigs_i = sizeof(configs_p) / sizeof(configs_p[0]);
+
+    bool success_b = true;
+
+    for (int c = 0; c < numConfigs_i; ++c)
+    {
+        const SConfig & config = configs_p[c];
+
+        CDynamicProgrammingOp bruteForce ( width_i, height_i );
+        CDynamicProgrammingOp envelope   ( width_i, height_i );
+
+        bruteForce.setSolverMode ( CDynamicProgrammingOp::SM_BRUTE_FORCE );
+        envelope.setSolverMode   ( CDynamicProgrammingOp::SM_LOWER_ENVELOPE );
+
+        std::vector<float> gradient_v       ( height_i, 0.f );
+        std::vector<float> distCost_v       ( std::max(width_i, height_i), 0.f );
+        std::vector<int>   followPath_v     ( 0 );
+        std::vector<int>   pathTol_v        ( 0 );
+
+        if ( config.gradient_b )
+        {
+            bruteForce.setExpectedGradient ( &gradient_v[0] );
+            envelope.setExpectedGradient   ( &gradient_v[0] );
+        }
+
+        /// The vector must be at least as long as the width.
+        if ( config.distCostVector_b )
+        {
+            bruteForce.setDistCostVector ( &distCost_v );
+            envelope.setDistCostVector   ( &distCost_v );
+        }
+
+        std::vector<int> pathBF_v  ( height_i, -1 );
+        std::vector<int> pathEnv_v ( height_i, -1 );
+
+        cv::Mat costs ( height_i, width_i, CV_32FC1 );
+
+        int    nodeDiffs_i = 0;
+        int    pathDiffs_i = 0;
+        CClock bfClock, envClock;
+
+        for (int f = 0; f < frames_i; ++f)
+        {
+            const int type_i = f % 3;
+
+            randomCosts ( costs, type_i );
+
+            /// Parameters that make rounding ties likely.
+            const float distCost_f = (type_i == 0)?random(0.f, 10.f):(float) (1 + rand() % 4);
+            const float distTh_f   = (type_i == 0)?random(0.f, 20.f):(float) (rand() % 6);
+
+            bruteForce.setDistanceCost ( distCost_f );
+            envelope.setDistanceCost   ( distCost_f );
+            bruteForce.setDistanceTh   ( distTh_f );
+            envelope.setDistanceTh     ( distTh_f );
+
+            for (int i = 0; i < height_i; ++i)
+            {
+                gradient_v[i] = (type_i == 0)?random(-2.f, 2.f):(float) (rand() % 5 - 2);
+                distCost_v[i] = (type_i == 0)?random(0.f, 10.f):(float) (1 + rand() % 4);
+            }
+
+            if ( config.followPath_b )
+            {
+                followPath_v.resize ( height_i );
+                followPath_v[0] = rand() % width_i;
+
+                for (int i = 1; i < height_i; ++i)
+                    followPath_v[i] = std::min(std::max(followPath_v[i-1] + rand() % 11 - 5, 0), width_i-1);
+            }
+
+            if ( config.pathTolVector_b )
+            {
+                pathTol_v.resize ( height_i );
+
+                for (int i = 0; i < height_i; ++i)
+                    pathTol_v[i] = 2 + rand() % 40;
+            }
+
+            bfClock.start();
+            const bool bfOk_b = bruteForce.compute ( costs, pathBF_v, followPath_v, pathTol_v );
+            bfClock.stop();
+
+            envClock.start();
+            const bool envOk_b = envelope.compute ( costs, pathEnv_v, followPath_v, pathTol_v );
+            envClock.stop();
+
+            if ( bfOk_b != envOk_b )
+                ++pathDiffs_i;
+
+            nodeDiffs_i += compareNodes ( bruteForce.getGraphImage(),
+                                          envelope.getGraphImage() );
+
+            for (int i = 0; i < height_i; ++i)
+                if ( pathBF_v[i] != pathEnv_v[i] )
+                    ++pathDiffs_i;
+        }
+
+        printf("%-20s brute force %8.3f ms lower envelope %8.3f ms "
+               "different nodes %i different path rows %i\n",
+               config.name_p,
+               bfClock.getTotalTime()  / frames_i,
+               envClock.getTotalTime() / frames_i,
+               nodeDiffs_i, pathDiffs_i );
+
+        success_b &= ( nodeDiffs_i == 0 && pathDiffs_i == 0 );
+    }
+
+    printf("%s\n", success_b?"OK":"FAILED");
+
+    return success_b?0:1;
+}
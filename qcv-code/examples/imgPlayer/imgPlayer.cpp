@@ -20,6 +20,7 @@
  */
 
 #include <QApplication>
+#include <QKeyEvent>
 
 #include "cinterface.h"
 
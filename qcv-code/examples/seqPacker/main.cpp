@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose. 
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+
+/**
+ * Converts an image sequence described by a sequence XML file (as read
+ * by CSeqDevHDImg) into a packed sequence file (see packedSequence.h)
+ * that can be played with CSeqDevPackedSeq.
+ *
+ * Usage: seqPacker sequence.xml output.qseq [--lz4]
+ *
+ * Only the file names of the images are stored. Files that the
+ * operators search in the image directory (camera.xml, etc.) must be
+ * copied next to the output file.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+#include <QCoreApplication>
+
+#include "seqDevHDImg.h"
+#include "packedSequence.h"
+
+using namespace QCV;
+
+int main(int f_argc_i, char *f_argv_p[])
+{
+    if ( f_argc_i < 3 || 
+         ( f_argc_i == 4 && std::string(f_argv_p[3]) != "--lz4" ) ||
+         f_argc_i > 4 )
+    {
+        printf("Usage %s sequence.xml output.qseq [--lz4]\n", f_argv_p[0]);
+        exit(1);
+    }
+
+    QCoreApplication app (f_argc_i, f_argv_p);
+
+    EPackedSeqCompression compression_e = (f_argc_i == 4)?PSC_LZ4:PSC_NONE;
+
+    CSeqDevHDImg device;
+
+    if ( !device.loadNewSequence ( f_argv_p[1] ) || 
+         !device.isInitialized() )
+    {
+        printf("Sequence %s could not be loaded\n", f_argv_p[1]);
+        return 1;
+    }
+
+    /// Decode following images while packing.
+    device.setPrefetchWindow ( 8 );
+    device.initialize();
+
+    std::map< std::string, CIOBase * > outputs;
+    device.registerOutputs ( outputs );
+
+    CInpImgFromFileVector * data_p = 
+        static_cast< CIO<CInpImgFromFileVector> * >( outputs["Device Images"] ) -> getPtr();
+
+    CPackedSeqWriter writer;
+
+    if ( !writer.open ( f_argv_p[2], compression_e ) )
+        return 1;
+
+    const int frames_i = device.getNumberOfFrames();
+
+    std::vector<std::string>  paths_v;
+    std::vector<cv::Mat>      images_v;
+    std::vector<double>       timeStamps_v;
+    std::vector<std::string>  names_v;
+
+    bool ok_b = true;
+    
+    for (int f = 0; ok_b && f < frames_i; ++f)
+    {
+        device.goToFrame ( f + 1 );
+        device.getFramePaths ( f, paths_v );
+
+        images_v.resize     ( paths_v.size() );
+        timeStamps_v.resize ( paths_v.size() );
+        names_v.resize      ( paths_v.size() );
+
+        for (unsigned int i = 0; i < paths_v.size(); ++i)
+        {
+            /// No image for this camera: the device keeps the last one.
+            if ( paths_v[i].empty() || i >= data_p->size() )
+            {
+                images_v[i]     = cv::Mat();
+                timeStamps_v[i] = -1;
+                names_v[i]      = "";
+                continue;
+            }
+
+            images_v[i]     = (*data_p)[i].image;
+            timeStamps_v[i] = (*data_p)[i].timeStamp_d;
+
+            int pos_i = paths_v[i].find_last_of ("/\\");
+            names_v[i] = paths_v[i].substr ( pos_i + 1 );
+        }
+
+        ok_b = writer.addFrame ( images_v, timeStamps_v, names_v );
+
+        if ( (f+1) % 100 == 0 || f+1 == frames_i )
+        {
+            printf("\r%i/%i frames packed", f+1, frames_i);
+            fflush(stdout);
+        }
+    }
+
+    printf("\n");
+
+    ok_b = writer.close() && ok_b;
+
+    std::map< std::string, CIOBase * >::iterator it;
+    for (it = outputs.begin(); it != outputs.end(); ++it)
+        delete it->second;
+
+    return ok_b?0:1;
+}
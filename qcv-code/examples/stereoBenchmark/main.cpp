@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose. 
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+/**
+ * Benchmark of the native SGM engine against the OpenCV stereo
+ * algorithms used by CStereoOp.
+ *
+ * Usage: stereoBenchmark [left_image right_image [runs]]
+ *
+ * Defaults to imgs/left.pgm and imgs/right.pgm. Prints the mean
+ * computation time, the density of the disparity image and the 
+ * agreement with OpenCV SGBM (both valid and within 1px).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <string>
+
+#include <opencv/cv.h>
+#include <opencv/highgui.h>
+
+#include "stereoOp.h"
+#include "semiGlobalMatching.h"
+
+using namespace QCV;
+
+template <class _Alg>
+static double timeAlgorithm ( _Alg &         f_alg,
+                              const cv::Mat & f_left,
+                              const cv::Mat & f_right,
+                              cv::Mat &       fr_disp,
+                              int             f_runs_i )
+{
+    /// Warm up (buffer allocation).
+    f_alg ( f_left, f_right, fr_disp );
+
+    const int64 start_i = cv::getTickCount();
+
+    for (int i = 0; i < f_runs_i; ++i)
+        f_alg ( f_left, f_right, fr_disp );
+
+    return ( cv::getTickCount() - start_i ) * 1000. / ( cv::getTickFrequency() * f_runs_i );
+}
+
+static void printResult ( const char *    f_name_p,
+                          double          f_time_d,
+                          const cv::Mat & f_disp,
+                          const cv::Mat & f_refDisp )
+{
+    int valid_i = 0, agree_i = 0, both_i = 0;
+
+    for (int i = 0; i < f_disp.rows; ++i)
+    {
+        for (int j = 0; j < f_disp.cols; ++j)
+        {
+            const short d_s = f_disp.at<short>(i,j);
+            const short r_s = f_refDisp.at<short>(i,j);
+
+            if ( d_s < 0 ) continue;
+
+            ++valid_i;
+
+            if ( r_s < 0 ) continue;
+
+            ++both_i;
+
+            if ( abs ( d_s - r_s ) <= 16 ) ++agree_i;
+        }
+    }
+
+    printf("%-12s %10.2f ms %9.2f %% valid %9.2f %% agree\n",
+           f_name_p,
+           f_time_d,
+           100. * valid_i / (f_disp.rows * f_disp.cols),
+           both_i?100. * agree_i / both_i:0.);
+}
+
+int main(int f_argc_i, char *f_argv_p[])
+{
+    std::string left_str  = "imgs/left.pgm";
+    std::string right_str = "imgs/right.pgm";
+    int         runs_i    = 10;
+
+    if ( f_argc_i >= 3 )
+    {
+        left_str  = f_argv_p[1];
+        right_str = f_argv_p[2];
+    }
+
+    if ( f_argc_i >= 4 )
+        runs_i = std::max(atoi(f_argv_p[3]), 1);
+
+    cv::Mat left  = cv::imread ( left_str,  0 );
+    cv::Mat right = cv::imread ( right_str, 0 );
+
+    if ( left.empty() || right.empty() || left.size() != right.size() )
+    {
+        printf("Usage %s [left_image right_image [runs]]\n", f_argv_p[0]);
+        exit(1);
+    }
+
+    printf("Image size %ix%i, 64 disparities, %i runs\n", 
+           left.cols, left.rows, runs_i);
+
+    /// OpenCV SGBM with the default parameters of CStereoOp.
+    CMyStereoSGBM sgbm;
+    sgbm.setNumberOfDisparities ( 64 );
+    sgbm.setMinDisparity ( 0 );
+    sgbm.setSADWindowSize ( 9 );
+    sgbm.setUniquenessRatio ( 5 );
+    sgbm.setDisp12MaxDiff ( 1 );
+    sgbm.setP1 ( 100 );
+    sgbm.setP2 ( 1000 );
+
+    /// OpenCV BM with the default parameters of CStereoOp.
+    cv::StereoBM sbm;
+    sbm.init ( CV_STEREO_BM_BASIC, 64, 9 );
+    sbm.state->uniquenessRatio = 5;
+    sbm.state->disp12MaxDiff   = 1;
+
+    /// Native SGM with 4 and 8 paths.
+    CSemiGlobalMatching sgm8;
+    sgm8.setNumberOfDisparities ( 64 );
+
+    CSemiGlobalMatching sgm4;
+    sgm4.setNumberOfDisparities ( 64 );
+    sgm4.setNumberOfPaths ( 4 );
+
+    cv::Mat refDisp, disp;
+
+    double time_d = timeAlgorithm ( sgbm, left, right, refDisp, runs_i );
+    printResult ( "OpenCV SGBM", time_d, refDisp, refDisp );
+
+    time_d = timeAlgorithm ( sbm, left, right, disp, runs_i );
+    printResult ( "OpenCV BM", time_d, disp, refDisp );
+
+    time_d = timeAlgorithm ( sgm8, left, right, disp, runs_i );
+    printResult ( "SGM 8 paths", time_d, disp, refDisp );
+
+    time_d = timeAlgorithm ( sgm4, left, right, disp, runs_i );
+    printResult ( "SGM 4 paths", time_d, disp, refDisp );
+
+    return 0;
+}
@@ -25,6 +25,7 @@
 #include "stereoOp.h"
 #include "mainWindow.h"
 #include "seqDevHDImg.h"
+#include "seqDevPackedSeq.h"
 #include "paramIOXmlFile.h"
 
 using namespace QCV;
@@ -46,12 +47,23 @@ int main(int f_argc_i, char *f_argv_p[])
     CParamIOXmlFile pio ( "params_stereo.xml" );
     rootOp_p->getParameterSet() -> load ( pio );
 
-    /// Create hard disk device
-    CSeqDevHDImg device;
-    device.loadNewSequence ( seqFile_str );
+    /// Create hard disk device. Packed sequences are read with the
+    /// packed sequence device.
+    CSeqDevHDImg     hdDevice;
+    CSeqDevPackedSeq packedDevice;
+    CSeqDeviceControl * device_p = &hdDevice;
+
+    if ( seqFile_str.size() > 5 && 
+         seqFile_str.substr(seqFile_str.size()-5) == ".qseq" )
+    {
+        packedDevice.loadNewSequence ( seqFile_str );
+        device_p = &packedDevice;
+    }
+    else
+        hdDevice.loadNewSequence ( seqFile_str );
 
     /// Create the main window passing the connector. 2x2 default screen count.
-    CMainWindow *mwind = new CMainWindow ( &device, 
+    CMainWindow *mwind = new CMainWindow ( device_p, 
                                            rootOp_p,
                                            2, 2 );
     
@@ -28,8 +28,12 @@
 ******************************************************************************/
 
 /* INCLUDES */
+#include <QtCore/QMutexLocker>
+
 #include "glViewer.h"
 
+#include <algorithm>
+
 using namespace QCV;
 
 CGLViewer::CGLViewer()
@@ -39,15 +43,27 @@ CGLViewer::CGLViewer()
 
           m_gridLength_f (         100.f ),
           m_gridWidth_f (          100.f ),
-          m_sceneRadius_f (        10.f )
+          m_sceneRadius_f (        10.f ),
+          m_published_p (          NULL ),
+          m_spare_p (              NULL ),
+          m_drawMutex_p (          NULL )
 {
     setWindowTitle("3D GL Viewer");
     setObjectName ( windowTitle() );
 }
 
+CGLViewer::~CGLViewer()
+{
+    delete m_published_p;
+    delete m_spare_p;
+}
+
 
 void CGLViewer::draw()
 {
+    /// The lists might be published by another thread.
+    QMutexLocker locker ( m_drawMutex_p );
+
     glMatrixMode(GL_MODELVIEW);
     glPushMatrix();
 
@@ -76,14 +92,23 @@ void CGLViewer::draw()
     
     /////////// Draw figures /////////
 
-    /// Points
-    m_pointList.show();
+    if ( m_published_p )
+    {
+        /// Points
+        m_published_p -> points.show();
 
-    /// Points
-    m_lineList.show();
+        /// Points
+        m_published_p -> lines.show();
     
-    /// Meshes
-    m_meshList.show();
+        /// Meshes
+        m_published_p -> meshes.show();
+    }
+    else
+    {
+        m_pointList.show();
+        m_lineList.show();
+        m_meshList.show();
+    }
 
     /////////// End drawing figures /////////
 
@@ -195,3 +220,29 @@ void CGLViewer::clear ()
     m_lineList.clear();
     m_meshList.clear();
 }
+
+void CGLViewer::copyLists ( SLists & fr_lists ) const
+{
+    fr_lists.points.clear();
+    fr_lists.lines.clear();
+    fr_lists.meshes.clear();
+
+    fr_lists.points.add ( m_pointList );
+    fr_lists.lines.add  ( m_lineList );
+    fr_lists.meshes.add ( m_meshList );
+}
+
+void CGLViewer::publish ( SLists * & fr_lists_p )
+{
+    QMutexLocker locker ( m_drawMutex_p );
+    std::swap ( m_published_p, fr_lists_p );
+}
+
+void CGLViewer::publish ( )
+{
+    if ( !m_spare_p )
+        m_spare_p = new SLists;
+
+    copyLists ( *m_spare_p );
+    publish ( m_spare_p );
+}
@@ -42,46 +42,59 @@
 #include "3DPointList.h"
 #include "3DLineList.h"
 #include "3DMeshList.h"
+#include "3DViewerBase.h"
 #include "colors.h"
 
+class QMutex;
+
 namespace QCV
 {
-    class CGLViewer : public QGLViewer
+    class CGLViewer : public QGLViewer, public C3DViewerBase
     {
 
+    public:
+        /// Copies of the lists of drawings (see copyLists()).
+        struct SLists
+        {
+            C3DPointList           points;
+            C3DLineList            lines;
+            C3DMeshList            meshes;
+        };
+
     public:
         CGLViewer();
+        virtual ~CGLViewer();
 
     public:
         /// Clear the list of drawings.
-        void                   clear ();
+        virtual void           clear ();
 
         /// Add a 3D point.
-        void                   addPoint ( const C3DVector  f_point,
+        virtual void           addPoint ( const C3DVector  f_point,
                                           const SRgb       f_color  = SRgb ( 255, 255, 255 ),
                                           const float      f_size_f = -1.f,
                                           const C3DVector  f_normal = C3DVector (0,0,0) );
         
         /// Add a 3D point.
-        void                   addLine  ( const C3DVector   f_point1,
+        virtual void           addLine  ( const C3DVector   f_point1,
                                           const C3DVector   f_point2,
                                           const SRgb        f_color  = SRgb ( 255, 255, 255 ),
                                           const float       f_lineWidth_f = -1.f );
         
         /// Add a 3D mesh.
-        void                   addMesh ( cv::Mat     f_vectorImg,
+        virtual void           addMesh ( cv::Mat     f_vectorImg,
                                          cv::Mat     f_dispTexture,
                                          const float f_maxDist_f,
                                          const float f_maxInvDist_f  );
         
-        bool                   setBackgroundColor ( SRgb f_bgColor ) { m_bgColor = f_bgColor; return true; }
-        SRgb                   getBackgroundColor (  ) const { return m_bgColor; }
+        virtual bool           setBackgroundColor ( SRgb f_bgColor ) { m_bgColor = f_bgColor; return true; }
+        virtual SRgb           getBackgroundColor (  ) const { return m_bgColor; }
         
-        bool                   setPointSize ( float f_pointSize_f ) { m_pointSize_f = f_pointSize_f; return true; }
-        float                  getPointSize (  ) const { return m_pointSize_f; }
+        virtual bool           setPointSize ( float f_pointSize_f ) { m_pointSize_f = f_pointSize_f; return true; }
+        virtual float          getPointSize (  ) const { return m_pointSize_f; }
         
-        bool                   setLineWidth ( float f_lineWidth_f ) { m_lineWidth_f = f_lineWidth_f; return true; }
-        float                  getLineWidth (  ) const { return m_lineWidth_f; }
+        virtual bool           setLineWidth ( float f_lineWidth_f ) { m_lineWidth_f = f_lineWidth_f; return true; }
+        virtual float          getLineWidth (  ) const { return m_lineWidth_f; }
 
         bool                   setGridLength ( float f_gridLength_f ) { m_gridLength_f = f_gridLength_f; return true; }
         float                  getGridLength (  ) const { return m_gridLength_f; }
@@ -92,6 +105,21 @@ namespace QCV
         bool                   setRadiusOfScene ( float f_sceneRadius_f ) { m_sceneRadius_f = f_sceneRadius_f; return true; }
         float                  getRadiusOfScene (  ) const { return m_sceneRadius_f; }
 
+        /// Mutex to hold while publishing or drawing the lists.
+        void                   setDrawMutex ( QMutex * f_mutex_p ) { m_drawMutex_p = f_mutex_p; }
+
+        /// Copy the lists of drawings. Call after the operators have
+        /// added their drawings, in the thread running them.
+        void                   copyLists ( SLists & fr_lists ) const;
+
+        /// Draw the given lists from now on instead of the lists of
+        /// drawings. fr_lists_p gets the lists drawn before (NULL the
+        /// first time) for reuse.
+        void                   publish ( SLists * & fr_lists_p );
+
+        /// Draw the current lists of drawings from now on.
+        void                   publish ( );
+
     protected :
         /// Draw
         virtual void           preDraw();
@@ -139,6 +167,15 @@ namespace QCV
 
         /// Scene radius
         float                      m_sceneRadius_f;
+
+        /// Lists drawn (see publish()).
+        SLists *                   m_published_p;
+
+        /// Lists reused by publish().
+        SLists *                   m_spare_p;
+
+        /// Mutex protecting the published lists.
+        QMutex *                   m_drawMutex_p;
         
     };
 }
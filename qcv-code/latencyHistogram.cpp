@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose. 
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+/*@@@**************************************************************************
+* \file  latencyHistogram.cpp
+* \author Hernan Badino
+* \notes 
+*******************************************************************************
+*****          (C) COPYRIGHT Hernan Badino - All Rights Reserved          *****
+******************************************************************************/
+
+/* INCLUDES */
+#include "latencyHistogram.h"
+
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+using namespace QCV;
+
+CLatencyHistogram::CLatencyHistogram ( )
+{
+    clear();
+}
+
+void
+CLatencyHistogram::clear ( )
+{
+    memset ( m_buckets_p, 0, sizeof(m_buckets_p) );
+
+    m_count_ui = 0;
+    m_min_d    = 0.;
+    m_max_d    = 0.;
+    m_last_d   = 0.;
+}
+
+void
+CLatencyHistogram::add ( double f_time_d )
+{
+    const unsigned long long time_ull = 
+        (unsigned long long) ( std::max ( f_time_d, 0. ) * 1000. + .5 );
+
+    ++m_buckets_p[getBucket ( time_ull )];
+
+    if ( !m_count_ui || f_time_d < m_min_d ) m_min_d = f_time_d;
+    if ( !m_count_ui || f_time_d > m_max_d ) m_max_d = f_time_d;
+
+    m_last_d = f_time_d;
+    ++m_count_ui;
+}
+
+double
+CLatencyHistogram::getPercentile ( double f_percent_d ) const
+{
+    if ( !m_count_ui )
+        return 0.;
+
+    /// Rank of the time in the sorted list (1 based).
+    const unsigned int rank_ui = 
+        std::max ( 1u, (unsigned int) ceil ( std::min ( std::max ( f_percent_d, 0. ), 100. ) / 100. * m_count_ui ) );
+
+    unsigned int count_ui = 0;
+
+    for (int i = 0; i < NUM_BUCKETS; ++i)
+    {
+        count_ui += m_buckets_p[i];
+
+        if ( count_ui >= rank_ui )
+            return std::min ( std::max ( getBucketTime ( i ), m_min_d ), m_max_d );
+    }
+
+    return m_max_d;
+}
+
+int
+CLatencyHistogram::getBucket ( unsigned long long f_time_ull )
+{
+    if ( f_time_ull < LINEAR_BUCKETS )
+        return (int) f_time_ull;
+
+    /// Position of the highest bit.
+    int msb_i = 0;
+    while ( f_time_ull >> ( msb_i + 1 ) )
+        ++msb_i;
+
+    /// The 5 bits under the highest one select the bucket in the range.
+    const int shift_i = msb_i - 5;
+
+    if ( shift_i > RANGES )
+        return NUM_BUCKETS - 1;
+
+    return ( LINEAR_BUCKETS + 
+             ( shift_i - 1 ) * SUB_BUCKETS + 
+             (int) ( f_time_ull >> shift_i ) - SUB_BUCKETS );
+}
+
+double
+CLatencyHistogram::getBucketTime ( int f_bucket_i )
+{
+    if ( f_bucket_i < LINEAR_BUCKETS )
+        return f_bucket_i / 1000.;
+
+    const int shift_i    = ( f_bucket_i - LINEAR_BUCKETS ) / SUB_BUCKETS + 1;
+    const int mantissa_i = ( f_bucket_i - LINEAR_BUCKETS ) % SUB_BUCKETS + SUB_BUCKETS;
+
+    const double low_d   = ldexp ( (double) mantissa_i, shift_i );
+    const double width_d = ldexp ( 1., shift_i );
+
+    return ( low_d + width_d / 2. ) / 1000.;
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose. 
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+#ifndef __LATENCYHISTOGRAM_H
+#define __LATENCYHISTOGRAM_H
+
+/**
+ *******************************************************************************
+ *
+ * @file latencyHistogram.h
+ *
+ * \class CLatencyHistogram
+ * \author Hernan Badino (hernan.badino@gmail.com)
+ *
+ * \brief Log-linear histogram of measured times.
+ *
+ * Times are counted in microseconds. Times under 64 us have one bucket
+ * each. Every larger power of two range is split into 32 buckets, so
+ * that a percentile is off by less than 1/64 of its value. The memory
+ * is fixed (about 4.6 KB) and times over 2^41 us are counted in the
+ * last bucket. The exact minimum, maximum and last time are kept as
+ * well.
+ *
+ *******************************************************************************/
+
+/* INCLUDES */
+
+/* CONSTANTS */
+
+namespace QCV
+{
+    class CLatencyHistogram
+    {
+    /// Constructors/Destructor.
+    public:
+        CLatencyHistogram ( );
+
+    /// Handling.
+    public:
+        /// Add a time in ms.
+        void          add ( double f_time_d );
+
+        /// Remove all times.
+        void          clear ( );
+
+    /// Gets.
+    public:
+        /// Number of times.
+        unsigned int  getCount ( ) const { return m_count_ui; }
+
+        /// Minimal time in ms.
+        double        getMin ( ) const { return m_min_d; }
+
+        /// Maximal time in ms.
+        double        getMax ( ) const { return m_max_d; }
+
+        /// Last time in ms.
+        double        getLast ( ) const { return m_last_d; }
+
+        /// Time in ms under which the given percentage [0,100] of the
+        /// times are. 0 if there are no times.
+        double        getPercentile ( double f_percent_d ) const;
+
+    /// Private data types.
+    private:
+        enum
+        {
+            /// Buckets per power of two range.
+            SUB_BUCKETS     = 32,
+
+            /// Linear buckets of 1 us.
+            LINEAR_BUCKETS  = 2 * SUB_BUCKETS,
+
+            /// Power of two ranges above the linear buckets.
+            RANGES          = 35,
+
+            NUM_BUCKETS     = LINEAR_BUCKETS + RANGES * SUB_BUCKETS
+        };
+
+    /// Private methods.
+    private:
+        /// Bucket of a time in us.
+        static int    getBucket ( unsigned long long f_time_ull );
+
+        /// Time in ms at the center of a bucket.
+        static double getBucketTime ( int f_bucket_i );
+
+    /// Private members.
+    private:
+        /// Counts.
+        unsigned int  m_buckets_p[NUM_BUCKETS];
+
+        /// Number of times.
+        unsigned int  m_count_ui;
+
+        /// Minimal time.
+        double        m_min_d;
+
+        /// Maximal time.
+        double        m_max_d;
+
+        /// Last time.
+        double        m_last_d;
+    };
+}
+
+#endif // __LATENCYHISTOGRAM_H
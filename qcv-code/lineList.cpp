@@ -28,15 +28,12 @@
  ******************************************************************************/
 
 /* INCLUDES */
-#include <QGLContext>
 #include "lineList.h"
-#include "glheader.h"
+#include "rasterizer.h"
 #include <stdio.h>
 
 using namespace QCV;
 
-extern QGLContext * g_QGLContext_p;
-
 CLineList::CLineList( int /* f_bufferSize_i */ )
 {}
 
@@ -86,29 +83,6 @@ CLineList::clear ()
     return m_line_v.size();
 }
 
-// Draw all lines.
-bool
-CLineList::show () const
-{
-    //printf("g_QGLContext_p  = %p\n",g_QGLContext_p);
-    std::vector< SLine >::const_iterator last = m_line_v.end();
-
-    for (std::vector< SLine >::const_iterator i = m_line_v.begin(); 
-         i != last; ++i )
-    {   
-        glLineWidth( i->lineWidth_f );
-        glColor4ub(i->color.r, i->color.g, i->color.b, i->color.a);
-
-        glBegin(GL_LINES);
-        glVertex2f(i->u1_f, i->v1_f);
-        glVertex2f(i->u2_f, i->v2_f);
-        glEnd();
-    }
-
-    /// Todo: Check GL status and return value.
-    return true;
-}
-
 bool
 CLineList::write ( FILE*                f_file_p,
                    const float          f_offsetU_f /* = 0.0 */,
@@ -139,6 +113,24 @@ CLineList::write ( FILE*                f_file_p,
     return true;
 }
 
+// Render all lines.
+bool
+CLineList::render ( CRasterTile & fr_tile ) const
+{
+    std::vector< SLine >::const_iterator last = m_line_v.end();
+
+    for (std::vector< SLine >::const_iterator i = m_line_v.begin(); 
+         i != last; ++i )
+    {
+        fr_tile.line ( i->u1_f, i->v1_f, 
+                       i->u2_f, i->v2_f,
+                       i->color, 
+                       i->lineWidth_f );
+    }
+
+    return true;
+}
+
 /// Return number of elements.
 int
 CLineList::getSize () const
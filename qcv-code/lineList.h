@@ -81,8 +81,8 @@ namespace QCV
         // Clear all lines.
         virtual bool clear ();
 
-        // Draw all lines.
-        virtual bool show () const;
+        // Draw all lines (OpenGL, defined in lineListGL.cpp).
+        bool show () const;
 
         // Write line in a SVG file.
         virtual bool write ( FILE*                f_file_p,
@@ -90,6 +90,9 @@ namespace QCV
                              const float          f_offsetV_f = 0.0,
                              const std::string    f_parameters_str = "") const;
 
+        // Render lines into an image tile.
+        virtual bool render ( CRasterTile &      fr_tile ) const;
+
         // Return number of elements.
         virtual int  getSize () const;
 
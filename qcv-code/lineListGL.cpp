@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose. 
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+/*@@@**************************************************************************
+ * \file  lineListGL.cpp
+ * \author Hernan Badino
+ * \notes 
+ *******************************************************************************
+ *****             (C) Hernan Badino 2012 - All Rights Reserved            *****
+ ******************************************************************************/
+
+/* INCLUDES */
+#include "lineList.h"
+#include "glheader.h"
+
+using namespace QCV;
+
+// Draw all lines.
+bool
+CLineList::show () const
+{
+    std::vector< SLine >::const_iterator last = m_line_v.end();
+
+    for (std::vector< SLine >::const_iterator i = m_line_v.begin(); 
+         i != last; ++i )
+    {   
+        glLineWidth( i->lineWidth_f );
+        glColor4ub(i->color.r, i->color.g, i->color.b, i->color.a);
+
+        glBegin(GL_LINES);
+        glVertex2f(i->u1_f, i->v1_f);
+        glVertex2f(i->u2_f, i->v2_f);
+        glEnd();
+    }
+
+    /// Todo: Check GL status and return value.
+    return true;
+}
@@ -30,11 +30,303 @@
 
 /* INCLUDES */
 #include <stdio.h>
+#include <algorithm>
 #include "doubleParam.h"
 #include "camera.h"
+#include "simd4.h"
+
+#if defined ( _OPENMP )
+#include <omp.h>
+#endif
+
+/* CONSTANTS */
+/// Minimum number of points per thread of the batched transformations.
+#define QCV_CAMERA_MIN_POINTS_PER_THREAD 4096
 
 using namespace QCV;
 
+/// Parameters of the batched kernels.
+struct SCameraKernelParams
+{
+    double fu_d, fv_d, u0_d, v0_d, fuB_d;
+
+    bool   rotate_b, translate_b;
+
+    /// Row major rotation and translation.
+    double r_p[9], t_p[3];
+};
+
+#if defined ( __SSE2__ )
+/// R * p + t with the operation order of C3DMatrix::operator *.
+static inline void transform4 ( const TDouble4 * f_r_p,
+                                const TDouble4 * f_t_p,
+                                const SCameraKernelParams & f_par,
+                                TDouble4 & fr_x, TDouble4 & fr_y, TDouble4 & fr_z )
+{
+    TDouble4 x = fr_x, y = fr_y, z = fr_z;
+
+    if ( f_par.rotate_b )
+    {
+        x = add4 ( add4 ( mul4 ( f_r_p[0], fr_x ), mul4 ( f_r_p[1], fr_y ) ), mul4 ( f_r_p[2], fr_z ) );
+        y = add4 ( add4 ( mul4 ( f_r_p[3], fr_x ), mul4 ( f_r_p[4], fr_y ) ), mul4 ( f_r_p[5], fr_z ) );
+        z = add4 ( add4 ( mul4 ( f_r_p[6], fr_x ), mul4 ( f_r_p[7], fr_y ) ), mul4 ( f_r_p[8], fr_z ) );
+    }
+
+    if ( f_par.translate_b )
+    {
+        x = add4 ( x, f_t_p[0] );
+        y = add4 ( y, f_t_p[1] );
+        z = add4 ( z, f_t_p[2] );
+    }
+
+    fr_x = x; fr_y = y; fr_z = z;
+}
+
+/// Store the valid flags of four lanes and return how many are set.
+static inline int storeValid4 ( int f_mask_i, unsigned char * fr_valid_p )
+{
+    if ( fr_valid_p )
+        for (int k = 0; k < 4; ++k)
+            fr_valid_p[k] = ( f_mask_i >> k ) & 1;
+
+    return ( f_mask_i & 1 ) + ( ( f_mask_i >> 1 ) & 1 ) + ( ( f_mask_i >> 2 ) & 1 ) + ( f_mask_i >> 3 );
+}
+#endif
+
+/// R * p + t with the operation order of C3DMatrix::operator *.
+static inline void transform ( const SCameraKernelParams & f_par,
+                               double & fr_x_d, double & fr_y_d, double & fr_z_d )
+{
+    double x_d = fr_x_d, y_d = fr_y_d, z_d = fr_z_d;
+
+    if ( f_par.rotate_b )
+    {
+        const double * r_p = f_par.r_p;
+        x_d = r_p[0] * fr_x_d + r_p[1] * fr_y_d + r_p[2] * fr_z_d;
+        y_d = r_p[3] * fr_x_d + r_p[4] * fr_y_d + r_p[5] * fr_z_d;
+        z_d = r_p[6] * fr_x_d + r_p[7] * fr_y_d + r_p[8] * fr_z_d;
+    }
+
+    if ( f_par.translate_b )
+    {
+        x_d += f_par.t_p[0];
+        y_d += f_par.t_p[1];
+        z_d += f_par.t_p[2];
+    }
+
+    fr_x_d = x_d; fr_y_d = y_d; fr_z_d = z_d;
+}
+
+/// Project the points [f_first_i, f_last_i). fr_d_p can be NULL.
+template <class _Type>
+static int projectBlock ( const SCameraKernelParams & f_par,
+                          int             f_first_i,
+                          int             f_last_i,
+                          const _Type *   f_x_p,
+                          const _Type *   f_y_p,
+                          const _Type *   f_z_p,
+                          _Type *         fr_u_p,
+                          _Type *         fr_v_p,
+                          _Type *         fr_d_p,
+                          unsigned char * fr_valid_p )
+{
+    int valid_i = 0;
+    int i       = f_first_i;
+
+#if defined ( __SSE2__ )
+    TDouble4 r_p[9], t_p[3];
+    for (int k = 0; k < 9; ++k) r_p[k] = set4 ( f_par.r_p[k] );
+    for (int k = 0; k < 3; ++k) t_p[k] = set4 ( f_par.t_p[k] );
+
+    const TDouble4 fu_v  = set4 ( f_par.fu_d );
+    const TDouble4 fv_v  = set4 ( f_par.fv_d );
+    const TDouble4 u0_v  = set4 ( f_par.u0_d );
+    const TDouble4 v0_v  = set4 ( f_par.v0_d );
+    const TDouble4 fuB_v = set4 ( f_par.fuB_d );
+
+    for (; i + 4 <= f_last_i; i += 4)
+    {
+        TDouble4 x_v = load4 ( f_x_p + i );
+        TDouble4 y_v = load4 ( f_y_p + i );
+        TDouble4 z_v = load4 ( f_z_p + i );
+
+        transform4 ( r_p, t_p, f_par, x_v, y_v, z_v );
+
+        store4 ( fr_u_p + i, add4 ( mul4 ( div4 ( x_v, z_v ), fu_v ), u0_v ) );
+        store4 ( fr_v_p + i, sub4 ( v0_v, mul4 ( div4 ( y_v, z_v ), fv_v ) ) );
+
+        if ( fr_d_p )
+            store4 ( fr_d_p + i, div4 ( fuB_v, z_v ) );
+
+        valid_i += storeValid4 ( maskBits4 ( greaterZero4 ( z_v ) ),
+                                 fr_valid_p?fr_valid_p + i:NULL );
+    }
+#endif
+
+    for (; i < f_last_i; ++i)
+    {
+        double x_d = f_x_p[i];
+        double y_d = f_y_p[i];
+        double z_d = f_z_p[i];
+
+        transform ( f_par, x_d, y_d, z_d );
+
+        fr_u_p[i] = x_d / z_d * f_par.fu_d + f_par.u0_d;
+        fr_v_p[i] = f_par.v0_d - y_d / z_d * f_par.fv_d;
+
+        if ( fr_d_p )
+            fr_d_p[i] = f_par.fuB_d / z_d;
+
+        const bool valid_b = z_d > 0;
+
+        if ( fr_valid_p )
+            fr_valid_p[i] = valid_b;
+
+        valid_i += valid_b;
+    }
+
+    return valid_i;
+}
+
+/// Back-project the points [f_first_i, f_last_i). Points with disparity
+/// <= 0 are set to zero.
+template <class _Type>
+static int backProjectBlock ( const SCameraKernelParams & f_par,
+                              int             f_first_i,
+                              int             f_last_i,
+                              const _Type *   f_u_p,
+                              const _Type *   f_v_p,
+                              const _Type *   f_d_p,
+                              _Type *         fr_x_p,
+                              _Type *         fr_y_p,
+                              _Type *         fr_z_p,
+                              unsigned char * fr_valid_p )
+{
+    int valid_i = 0;
+    int i       = f_first_i;
+
+#if defined ( __SSE2__ )
+    TDouble4 r_p[9], t_p[3];
+    for (int k = 0; k < 9; ++k) r_p[k] = set4 ( f_par.r_p[k] );
+    for (int k = 0; k < 3; ++k) t_p[k] = set4 ( f_par.t_p[k] );
+
+    const TDouble4 fu_v  = set4 ( f_par.fu_d );
+    const TDouble4 fv_v  = set4 ( f_par.fv_d );
+    const TDouble4 u0_v  = set4 ( f_par.u0_d );
+    const TDouble4 v0_v  = set4 ( f_par.v0_d );
+    const TDouble4 fuB_v = set4 ( f_par.fuB_d );
+
+    for (; i + 4 <= f_last_i; i += 4)
+    {
+        const TDouble4 d_v = load4 ( f_d_p + i );
+
+        TDouble4 z_v = div4 ( fuB_v, d_v );
+        TDouble4 x_v = mul4 ( div4 ( sub4 ( load4 ( f_u_p + i ), u0_v ), fu_v ), z_v );
+        TDouble4 y_v = mul4 ( div4 ( sub4 ( v0_v, load4 ( f_v_p + i ) ), fv_v ), z_v );
+
+        transform4 ( r_p, t_p, f_par, x_v, y_v, z_v );
+
+        const TDouble4 mask_v = greaterZero4 ( d_v );
+
+        store4 ( fr_x_p + i, and4 ( mask_v, x_v ) );
+        store4 ( fr_y_p + i, and4 ( mask_v, y_v ) );
+        store4 ( fr_z_p + i, and4 ( mask_v, z_v ) );
+
+        valid_i += storeValid4 ( maskBits4 ( mask_v ),
+                                 fr_valid_p?fr_valid_p + i:NULL );
+    }
+#endif
+
+    for (; i < f_last_i; ++i)
+    {
+        const double d_d = f_d_p[i];
+        const bool valid_b = d_d > 0;
+
+        if ( valid_b )
+        {
+            double z_d = f_par.fuB_d / d_d;
+            double x_d = (f_u_p[i] - f_par.u0_d) / f_par.fu_d * z_d;
+            double y_d = (f_par.v0_d - f_v_p[i]) / f_par.fv_d * z_d;
+
+            transform ( f_par, x_d, y_d, z_d );
+
+            fr_x_p[i] = x_d;
+            fr_y_p[i] = y_d;
+            fr_z_p[i] = z_d;
+        }
+        else
+            fr_x_p[i] = fr_y_p[i] = fr_z_p[i] = 0;
+
+        if ( fr_valid_p )
+            fr_valid_p[i] = valid_b;
+
+        valid_i += valid_b;
+    }
+
+    return valid_i;
+}
+
+/// Run a block kernel over contiguous blocks of points, one per thread.
+template <class _Type>
+static int runBlocks ( int (*f_kernel_p) ( const SCameraKernelParams &, int, int,
+                                           const _Type *, const _Type *, const _Type *,
+                                           _Type *, _Type *, _Type *, unsigned char * ),
+                       const SCameraKernelParams & f_par,
+                       int             f_size_i,
+                       const _Type *   f_a_p,
+                       const _Type *   f_b_p,
+                       const _Type *   f_c_p,
+                       _Type *         fr_a_p,
+                       _Type *         fr_b_p,
+                       _Type *         fr_c_p,
+                       unsigned char * fr_valid_p )
+{
+    int numThreads_i = 1;
+    int valid_i      = 0;
+
+#if defined ( _OPENMP )
+    numThreads_i = std::max ( 1, std::min ( omp_get_max_threads(),
+                                            f_size_i / QCV_CAMERA_MIN_POINTS_PER_THREAD ) );
+#pragma omp parallel for num_threads(numThreads_i) schedule(static,1) reduction(+:valid_i)
+#endif
+    for (int t = 0; t < numThreads_i; ++t)
+    {
+        const int first_i = (int)(( t    * (long long) f_size_i) / numThreads_i);
+        const int last_i  = (int)(((t+1) * (long long) f_size_i) / numThreads_i);
+
+        valid_i += f_kernel_p ( f_par, first_i, last_i,
+                                f_a_p, f_b_p, f_c_p,
+                                fr_a_p, fr_b_p, fr_c_p,
+                                fr_valid_p );
+    }
+
+    return valid_i;
+}
+
+/// Fill the kernel parameters.
+static void setKernelParams ( SCameraKernelParams & fr_par,
+                              double f_fu_d, double f_fv_d,
+                              double f_u0_d, double f_v0_d,
+                              double f_fuB_d,
+                              const C3DMatrix * f_rotation_p,
+                              const C3DVector * f_translation_p )
+{
+    fr_par.fu_d  = f_fu_d;
+    fr_par.fv_d  = f_fv_d;
+    fr_par.u0_d  = f_u0_d;
+    fr_par.v0_d  = f_v0_d;
+    fr_par.fuB_d = f_fuB_d;
+
+    fr_par.rotate_b    = f_rotation_p    != NULL;
+    fr_par.translate_b = f_translation_p != NULL;
+
+    for (int i = 0; i < 9; ++i)
+        fr_par.r_p[i] = f_rotation_p?f_rotation_p->at(i/3, i%3):(i%4==0);
+
+    for (int i = 0; i < 3; ++i)
+        fr_par.t_p[i] = f_translation_p?f_translation_p->at(i):0.;
+}
+
 CCamera::CCamera ( ) 
         : m_focalLength_d (         1 ),
           m_fu_d (                  1 ),
@@ -338,6 +630,136 @@ CCamera::imageAndDistance2Local( double  f_u_d,
     return true;
 }
 
+/// Local 3D points to image points.
+int
+CCamera::local2Image ( int              f_size_i,
+                       const double *   f_x_p,
+                       const double *   f_y_p,
+                       const double *   f_z_p,
+                       double *         fr_u_p,
+                       double *         fr_v_p,
+                       const C3DMatrix *f_rotation_p,
+                       const C3DVector *f_translation_p,
+                       unsigned char *  fr_valid_p ) const
+{
+    return projectPoints ( f_size_i, f_x_p, f_y_p, f_z_p,
+                           fr_u_p, fr_v_p, NULL, 0.,
+                           f_rotation_p, f_translation_p, fr_valid_p );
+}
+
+/// Local 3D points to image points.
+int
+CCamera::local2Image ( int              f_size_i,
+                       const float *    f_x_p,
+                       const float *    f_y_p,
+                       const float *    f_z_p,
+                       float *          fr_u_p,
+                       float *          fr_v_p,
+                       const C3DMatrix *f_rotation_p,
+                       const C3DVector *f_translation_p,
+                       unsigned char *  fr_valid_p ) const
+{
+    return projectPoints ( f_size_i, f_x_p, f_y_p, f_z_p,
+                           fr_u_p, fr_v_p, NULL, 0.,
+                           f_rotation_p, f_translation_p, fr_valid_p );
+}
+
+/// Batched projection.
+int
+CCamera::projectPoints ( int              f_size_i,
+                         const double *   f_x_p,
+                         const double *   f_y_p,
+                         const double *   f_z_p,
+                         double *         fr_u_p,
+                         double *         fr_v_p,
+                         double *         fr_d_p,
+                         double           f_fuB_d,
+                         const C3DMatrix *f_rotation_p,
+                         const C3DVector *f_translation_p,
+                         unsigned char *  fr_valid_p ) const
+{
+    SCameraKernelParams par;
+    setKernelParams ( par, m_fu_d, m_fv_d, m_u0_d, m_v0_d, f_fuB_d,
+                      f_rotation_p, f_translation_p );
+
+    return runBlocks<double> ( projectBlock<double>, par, f_size_i,
+                               f_x_p, f_y_p, f_z_p,
+                               fr_u_p, fr_v_p, fr_d_p,
+                               fr_valid_p );
+}
+
+/// Batched projection.
+int
+CCamera::projectPoints ( int              f_size_i,
+                         const float *    f_x_p,
+                         const float *    f_y_p,
+                         const float *    f_z_p,
+                         float *          fr_u_p,
+                         float *          fr_v_p,
+                         float *          fr_d_p,
+                         double           f_fuB_d,
+                         const C3DMatrix *f_rotation_p,
+                         const C3DVector *f_translation_p,
+                         unsigned char *  fr_valid_p ) const
+{
+    SCameraKernelParams par;
+    setKernelParams ( par, m_fu_d, m_fv_d, m_u0_d, m_v0_d, f_fuB_d,
+                      f_rotation_p, f_translation_p );
+
+    return runBlocks<float> ( projectBlock<float>, par, f_size_i,
+                              f_x_p, f_y_p, f_z_p,
+                              fr_u_p, fr_v_p, fr_d_p,
+                              fr_valid_p );
+}
+
+/// Batched back-projection.
+int
+CCamera::backProjectPoints ( int              f_size_i,
+                             const double *   f_u_p,
+                             const double *   f_v_p,
+                             const double *   f_d_p,
+                             double *         fr_x_p,
+                             double *         fr_y_p,
+                             double *         fr_z_p,
+                             double           f_fuB_d,
+                             const C3DMatrix *f_rotation_p,
+                             const C3DVector *f_translation_p,
+                             unsigned char *  fr_valid_p ) const
+{
+    SCameraKernelParams par;
+    setKernelParams ( par, m_fu_d, m_fv_d, m_u0_d, m_v0_d, f_fuB_d,
+                      f_rotation_p, f_translation_p );
+
+    return runBlocks<double> ( backProjectBlock<double>, par, f_size_i,
+                               f_u_p, f_v_p, f_d_p,
+                               fr_x_p, fr_y_p, fr_z_p,
+                               fr_valid_p );
+}
+
+/// Batched back-projection.
+int
+CCamera::backProjectPoints ( int              f_size_i,
+                             const float *    f_u_p,
+                             const float *    f_v_p,
+                             const float *    f_d_p,
+                             float *          fr_x_p,
+                             float *          fr_y_p,
+                             float *          fr_z_p,
+                             double           f_fuB_d,
+                             const C3DMatrix *f_rotation_p,
+                             const C3DVector *f_translation_p,
+                             unsigned char *  fr_valid_p ) const
+{
+    SCameraKernelParams par;
+    setKernelParams ( par, m_fu_d, m_fv_d, m_u0_d, m_v0_d, f_fuB_d,
+                      f_rotation_p, f_translation_p );
+
+    return runBlocks<float> ( backProjectBlock<float>, par, f_size_i,
+                              f_u_p, f_v_p, f_d_p,
+                              fr_x_p, fr_y_p, fr_z_p,
+                              fr_valid_p );
+}
+
 /// Image position to world position.
 void
 CCamera::scale ( double f_scale_d )
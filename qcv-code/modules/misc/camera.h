@@ -138,6 +138,87 @@ namespace QCV
                                                 double &fr_x_d,
                                                 double &fr_y_d ) const;
 
+    /// Batched transformations. Points are given as structure of
+    /// arrays. If a rotation is given the points are first transformed
+    /// with R * p + t (t is optional). fr_valid_p (optional) is set to 1
+    /// for points in front of the camera and 0 otherwise. The number of
+    /// valid points is returned.
+    public:
+        /// Local 3D points to image points.
+        int            local2Image ( int              f_size_i,
+                                     const double *   f_x_p,
+                                     const double *   f_y_p,
+                                     const double *   f_z_p,
+                                     double *         fr_u_p,
+                                     double *         fr_v_p,
+                                     const C3DMatrix *f_rotation_p    = NULL,
+                                     const C3DVector *f_translation_p = NULL,
+                                     unsigned char *  fr_valid_p      = NULL ) const;
+
+        /// Local 3D points to image points.
+        int            local2Image ( int              f_size_i,
+                                     const float *    f_x_p,
+                                     const float *    f_y_p,
+                                     const float *    f_z_p,
+                                     float *          fr_u_p,
+                                     float *          fr_v_p,
+                                     const C3DMatrix *f_rotation_p    = NULL,
+                                     const C3DVector *f_translation_p = NULL,
+                                     unsigned char *  fr_valid_p      = NULL ) const;
+
+    /// Batched kernels for derived classes. Disparities are computed
+    /// with f_fuB_d if fr_d_p is not NULL.
+    protected:
+        int            projectPoints ( int              f_size_i,
+                                       const double *   f_x_p,
+                                       const double *   f_y_p,
+                                       const double *   f_z_p,
+                                       double *         fr_u_p,
+                                       double *         fr_v_p,
+                                       double *         fr_d_p,
+                                       double           f_fuB_d,
+                                       const C3DMatrix *f_rotation_p,
+                                       const C3DVector *f_translation_p,
+                                       unsigned char *  fr_valid_p ) const;
+
+        int            projectPoints ( int              f_size_i,
+                                       const float *    f_x_p,
+                                       const float *    f_y_p,
+                                       const float *    f_z_p,
+                                       float *          fr_u_p,
+                                       float *          fr_v_p,
+                                       float *          fr_d_p,
+                                       double           f_fuB_d,
+                                       const C3DMatrix *f_rotation_p,
+                                       const C3DVector *f_translation_p,
+                                       unsigned char *  fr_valid_p ) const;
+
+        /// Image points and disparities to 3D points (z = f_fuB_d / d).
+        /// Points with disparity <= 0 are set to zero.
+        int            backProjectPoints ( int              f_size_i,
+                                           const double *   f_u_p,
+                                           const double *   f_v_p,
+                                           const double *   f_d_p,
+                                           double *         fr_x_p,
+                                           double *         fr_y_p,
+                                           double *         fr_z_p,
+                                           double           f_fuB_d,
+                                           const C3DMatrix *f_rotation_p,
+                                           const C3DVector *f_translation_p,
+                                           unsigned char *  fr_valid_p ) const;
+
+        int            backProjectPoints ( int              f_size_i,
+                                           const float *    f_u_p,
+                                           const float *    f_v_p,
+                                           const float *    f_d_p,
+                                           float *          fr_x_p,
+                                           float *          fr_y_p,
+                                           float *          fr_z_p,
+                                           double           f_fuB_d,
+                                           const C3DMatrix *f_rotation_p,
+                                           const C3DVector *f_translation_p,
+                                           unsigned char *  fr_valid_p ) const;
+
     /// Operations on the camera
     public:       
         virtual void   scale ( double f_scale_d );
@@ -33,3 +33,243 @@
 using namespace QCV;
 
 const char * SFeature::FeatureStateName_v[] = {"Uninitialized", "New", "Tracked", "Lost"};
+
+void
+CFeatureVector::resize ( size_t f_size_ui )
+{
+    const size_t prevSize_ui = size();
+
+    if ( f_size_ui < prevSize_ui )
+    {
+        dropChanges ( m_newList_v,     f_size_ui );
+        dropChanges ( m_lostList_v,    f_size_ui );
+        dropChanges ( m_changedList_v, f_size_ui );
+    }
+
+    const SFeature feat;
+
+    m_u_v.resize     ( f_size_ui, feat.u );
+    m_v_v.resize     ( f_size_ui, feat.v );
+    m_d_v.resize     ( f_size_ui, feat.d );
+    m_t_v.resize     ( f_size_ui, feat.t );
+    m_e_v.resize     ( f_size_ui, feat.e );
+    m_f_v.resize     ( f_size_ui, 0 );
+    m_idx_v.resize   ( f_size_ui, feat.idx );
+    m_state_v.resize ( f_size_ui, (unsigned char) feat.state );
+    m_change_v.resize( f_size_ui, 0 );
+
+    m_live_v.resize  ( ( f_size_ui + 31 ) / 32, 0 );
+
+    /// Clear the bits of removed features in the last word.
+    if ( f_size_ui % 32 )
+        m_live_v.back() &= ( 1u << ( f_size_ui % 32 ) ) - 1;
+}
+
+void
+CFeatureVector::setState ( int f_idx_i, SFeature::EFeatureState f_state )
+{
+    const unsigned int bit_ui = 1u << ( f_idx_i & 31 );
+
+    m_state_v[f_idx_i] = (unsigned char) f_state;
+
+    /// A word of the bitmap is shared by 32 features.
+    unsigned int & word_ui = m_live_v[f_idx_i >> 5];
+
+    if ( f_state == SFeature::FS_NEW || f_state == SFeature::FS_TRACKED )
+    {
+#if defined ( _OPENMP )
+#pragma omp atomic
+#endif
+        word_ui |= bit_ui;
+    }
+    else
+    {
+#if defined ( _OPENMP )
+#pragma omp atomic
+#endif
+        word_ui &= ~bit_ui;
+    }
+
+    if ( f_state == SFeature::FS_NEW )
+        record ( f_idx_i, CF_NEW, m_newList_v );
+    else if ( f_state == SFeature::FS_LOST )
+        record ( f_idx_i, CF_LOST, m_lostList_v );
+
+    touch ( f_idx_i );
+}
+
+void
+CFeatureVector::appendChange ( int f_idx_i, std::vector<int> & fr_list_v )
+{
+#if defined ( _OPENMP )
+#pragma omp critical ( QCVFeatureVectorChanges )
+#endif
+    fr_list_v.push_back ( f_idx_i );
+}
+
+void
+CFeatureVector::reserve ( size_t f_size_ui )
+{
+    m_u_v.reserve     ( f_size_ui );
+    m_v_v.reserve     ( f_size_ui );
+    m_d_v.reserve     ( f_size_ui );
+    m_t_v.reserve     ( f_size_ui );
+    m_e_v.reserve     ( f_size_ui );
+    m_f_v.reserve     ( f_size_ui );
+    m_idx_v.reserve   ( f_size_ui );
+    m_state_v.reserve ( f_size_ui );
+    m_change_v.reserve( f_size_ui );
+    m_live_v.reserve  ( ( f_size_ui + 31 ) / 32 );
+}
+
+void
+CFeatureVector::clear ( )
+{
+    m_u_v.clear();
+    m_v_v.clear();
+    m_d_v.clear();
+    m_t_v.clear();
+    m_e_v.clear();
+    m_f_v.clear();
+    m_idx_v.clear();
+    m_state_v.clear();
+    m_change_v.clear();
+    m_live_v.clear();
+
+    m_newList_v.clear();
+    m_lostList_v.clear();
+    m_changedList_v.clear();
+}
+
+void
+CFeatureVector::push_back ( const SFeature & f_feature )
+{
+    resize ( size() + 1 );
+    set ( size() - 1, f_feature );
+}
+
+void
+CFeatureVector::append ( const CFeatureVector & f_other )
+{
+    const int offset_i = size();
+
+    m_u_v.insert     ( m_u_v.end(),     f_other.m_u_v.begin(),     f_other.m_u_v.end() );
+    m_v_v.insert     ( m_v_v.end(),     f_other.m_v_v.begin(),     f_other.m_v_v.end() );
+    m_d_v.insert     ( m_d_v.end(),     f_other.m_d_v.begin(),     f_other.m_d_v.end() );
+    m_t_v.insert     ( m_t_v.end(),     f_other.m_t_v.begin(),     f_other.m_t_v.end() );
+    m_e_v.insert     ( m_e_v.end(),     f_other.m_e_v.begin(),     f_other.m_e_v.end() );
+    m_f_v.insert     ( m_f_v.end(),     f_other.m_f_v.begin(),     f_other.m_f_v.end() );
+    m_idx_v.insert   ( m_idx_v.end(),   f_other.m_idx_v.begin(),   f_other.m_idx_v.end() );
+    m_state_v.insert ( m_state_v.end(), f_other.m_state_v.begin(), f_other.m_state_v.end() );
+    m_change_v.resize ( size(), 0 );
+    m_live_v.resize ( ( size() + 31 ) / 32, 0 );
+
+    /// Live bits and changes of the appended features.
+    for (int i = offset_i; i < (signed)size(); ++i)
+    {
+        const int j = i - offset_i;
+
+        if ( f_other.isLive ( j ) )
+            m_live_v[i >> 5] |= 1u << ( i & 31 );
+
+        const unsigned char change_uc = f_other.m_change_v[j];
+
+        if ( change_uc & CF_NEW )     record ( i, CF_NEW,     m_newList_v );
+        if ( change_uc & CF_LOST )    record ( i, CF_LOST,    m_lostList_v );
+        if ( change_uc & CF_CHANGED ) record ( i, CF_CHANGED, m_changedList_v );
+    }
+}
+
+void
+CFeatureVector::copyColumns ( const CFeatureVector & f_other )
+{
+    m_u_v     = f_other.m_u_v;
+    m_v_v     = f_other.m_v_v;
+    m_d_v     = f_other.m_d_v;
+    m_t_v     = f_other.m_t_v;
+    m_e_v     = f_other.m_e_v;
+    m_f_v     = f_other.m_f_v;
+    m_idx_v   = f_other.m_idx_v;
+    m_state_v = f_other.m_state_v;
+    m_live_v  = f_other.m_live_v;
+
+    m_change_v.assign ( size(), 0 );
+    m_newList_v.clear();
+    m_lostList_v.clear();
+    m_changedList_v.clear();
+}
+
+int
+CFeatureVector::nextLive ( int f_idx_i ) const
+{
+    const int size_i = size();
+    int       i      = f_idx_i + 1;
+
+    if ( i >= size_i )
+        return size_i;
+
+    int          w_i     = i >> 5;
+    unsigned int word_ui = m_live_v[w_i] & ( ~0u << ( i & 31 ) );
+
+    while ( !word_ui )
+    {
+        if ( ++w_i >= (signed)m_live_v.size() )
+            return size_i;
+
+        word_ui = m_live_v[w_i];
+    }
+
+    i = w_i << 5;
+
+    while ( !( word_ui & 1 ) )
+    {
+        word_ui >>= 1;
+        ++i;
+    }
+
+    return i;
+}
+
+int
+CFeatureVector::getLiveCount ( ) const
+{
+    int count_i = 0;
+
+    for (unsigned int w = 0; w < m_live_v.size(); ++w)
+        for (unsigned int word_ui = m_live_v[w]; word_ui; word_ui &= word_ui - 1)
+            ++count_i;
+
+    return count_i;
+}
+
+void
+CFeatureVector::clearChanges ( )
+{
+    /// Only the listed features have flags.
+    for (unsigned int i = 0; i < m_changedList_v.size(); ++i)
+        m_change_v[m_changedList_v[i]] = 0;
+
+    for (unsigned int i = 0; i < m_newList_v.size(); ++i)
+        m_change_v[m_newList_v[i]] = 0;
+
+    for (unsigned int i = 0; i < m_lostList_v.size(); ++i)
+        m_change_v[m_lostList_v[i]] = 0;
+
+    m_newList_v.clear();
+    m_lostList_v.clear();
+    m_changedList_v.clear();
+}
+
+/// Remove the indices of removed features from a change list.
+void
+CFeatureVector::dropChanges ( std::vector<int> & fr_list_v,
+                              size_t             f_size_ui )
+{
+    unsigned int n = 0;
+
+    for (unsigned int i = 0; i < fr_list_v.size(); ++i)
+        if ( fr_list_v[i] < (signed)f_size_ui )
+            fr_list_v[n++] = fr_list_v[i];
+
+    fr_list_v.resize ( n );
+}
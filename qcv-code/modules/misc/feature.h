@@ -32,12 +32,14 @@
  *
  * \brief Implements a data struct for modeling features.
  *
- * Implements a data struct for modeling features.
+ * Implements a data struct for modeling features and CFeatureVector,
+ * a column-wise container of them.
  *
  *******************************************************************************/
 
 /* INCLUDES */
 #include <vector>
+#include <algorithm>
 #include <stdio.h>
 
 /* CONSTANTS */
@@ -112,7 +114,365 @@ namespace QCV
         EFeatureState state;
     };
 
-    typedef std::vector<SFeature> CFeatureVector;
+    /**
+     ***************************************************************************
+     *
+     * \class CFeatureVector
+     *
+     * \brief Vector of features stored in columns.
+     *
+     * Each field of the features is stored in its own column. A bitmap
+     * marks the live features (new or tracked), so that consumers can
+     * skip the rest with firstLive() and nextLive(). The indices of the
+     * features that became new, became lost or were modified since the
+     * last clearChanges() are kept in change lists.
+     *
+     * The SFeature interface is kept through the element proxy returned
+     * by operator []: vec[i].u, vec[i].state = SFeature::FS_LOST, etc.
+     * Writes through the proxy are recorded in the change lists. 
+     * Distinct features can be written concurrently (e.g. in an OpenMP 
+     * loop over the features), the order of the change lists is 
+     * unspecified in that case. A feature must not be written by two 
+     * threads at the same time.
+     *
+     ***************************************************************************/
+    class CFeatureVector
+    {
+    public:
+        /// Reference to one field of a feature.
+        template <class _Type>
+        class CFieldRef
+        {
+        public:
+            CFieldRef ( CFeatureVector * f_vec_p, _Type * f_val_p, int f_idx_i )
+                    : m_vec_p (               f_vec_p ),
+                      m_val_p (               f_val_p ),
+                      m_idx_i (               f_idx_i ) {}
+
+            operator _Type ( ) const { return *m_val_p; }
+
+            CFieldRef & operator = ( _Type f_val )
+            {
+                *m_val_p = f_val;
+                m_vec_p -> touch ( m_idx_i );
+                return *this;
+            }
+
+            CFieldRef & operator = ( const CFieldRef & f_other )
+            {
+                return *this = (_Type) f_other;
+            }
+
+            CFieldRef & operator += ( _Type f_val ) { return *this = *m_val_p + f_val; }
+            CFieldRef & operator -= ( _Type f_val ) { return *this = *m_val_p - f_val; }
+            CFieldRef & operator ++ ( )             { return *this = *m_val_p + 1; }
+            CFieldRef & operator -- ( )             { return *this = *m_val_p - 1; }
+
+        private:
+            CFeatureVector * m_vec_p;
+            _Type *          m_val_p;
+            int              m_idx_i;
+        };
+
+        /// Reference to the state of a feature.
+        class CStateRef
+        {
+        public:
+            CStateRef ( CFeatureVector * f_vec_p, int f_idx_i )
+                    : m_vec_p (               f_vec_p ),
+                      m_idx_i (               f_idx_i ) {}
+
+            operator SFeature::EFeatureState ( ) const
+            {
+                return (SFeature::EFeatureState) m_vec_p -> getState()[m_idx_i];
+            }
+
+            CStateRef & operator = ( SFeature::EFeatureState f_state )
+            {
+                m_vec_p -> setState ( m_idx_i, f_state );
+                return *this;
+            }
+
+            CStateRef & operator = ( const CStateRef & f_other )
+            {
+                return *this = (SFeature::EFeatureState) f_other;
+            }
+
+        private:
+            CFeatureVector * m_vec_p;
+            int              m_idx_i;
+        };
+
+        /// Reference to a feature with the fields of SFeature.
+        class CFeatureRef
+        {
+        public:
+            CFeatureRef ( CFeatureVector * f_vec_p, int f_idx_i )
+                    : u (                     f_vec_p, &f_vec_p->m_u_v[f_idx_i],   f_idx_i ),
+                      v (                     f_vec_p, &f_vec_p->m_v_v[f_idx_i],   f_idx_i ),
+                      d (                     f_vec_p, &f_vec_p->m_d_v[f_idx_i],   f_idx_i ),
+                      t (                     f_vec_p, &f_vec_p->m_t_v[f_idx_i],   f_idx_i ),
+                      e (                     f_vec_p, &f_vec_p->m_e_v[f_idx_i],   f_idx_i ),
+                      f (                     f_vec_p, &f_vec_p->m_f_v[f_idx_i],   f_idx_i ),
+                      idx (                   f_vec_p, &f_vec_p->m_idx_v[f_idx_i], f_idx_i ),
+                      state (                 f_vec_p,                             f_idx_i ),
+                      m_vec_p (               f_vec_p ),
+                      m_idx_i (               f_idx_i ) {}
+
+            operator SFeature ( ) const
+            {
+                return m_vec_p -> get ( m_idx_i );
+            }
+
+            CFeatureRef & operator = ( const SFeature & f_feature )
+            {
+                m_vec_p -> set ( m_idx_i, f_feature );
+                return *this;
+            }
+
+            CFeatureRef & operator = ( const CFeatureRef & f_other )
+            {
+                return *this = (SFeature) f_other;
+            }
+
+            void clear ( )
+            {
+                m_vec_p -> set ( m_idx_i, SFeature() );
+            }
+
+            void print ( ) const
+            {
+                m_vec_p -> get ( m_idx_i ).print();
+            }
+
+        public:
+            CFieldRef<double>        u;
+            CFieldRef<double>        v;
+            CFieldRef<double>        d;
+            CFieldRef<int>           t;
+            CFieldRef<double>        e;
+            CFieldRef<size_t>        f;
+            CFieldRef<int>           idx;
+            CStateRef                state;
+
+        private:
+            CFeatureVector *         m_vec_p;
+            int                      m_idx_i;
+        };
+
+        friend class CFeatureRef;
+
+    public:
+        CFeatureVector ( ) {}
+
+        /// Vector sizes.
+        size_t         size  ( ) const { return m_state_v.size(); }
+        bool           empty ( ) const { return m_state_v.empty(); }
+
+        /// Resize the vector. New features are uninitialized.
+        void           resize  ( size_t f_size_ui );
+        void           reserve ( size_t f_size_ui );
+
+        /// Remove all features and changes.
+        void           clear ( );
+
+        /// Add a feature at the end.
+        void           push_back ( const SFeature & f_feature );
+
+        /// Add the features of another vector at the end.
+        void           append ( const CFeatureVector & f_other );
+
+        /// Copy the columns of another vector without its change lists.
+        void           copyColumns ( const CFeatureVector & f_other );
+
+        /// Element access.
+        CFeatureRef    operator [] ( size_t f_idx_ui )
+        {
+            return CFeatureRef ( this, (int) f_idx_ui );
+        }
+
+        SFeature       operator [] ( size_t f_idx_ui ) const
+        {
+            return get ( (int) f_idx_ui );
+        }
+
+        SFeature       get ( int f_idx_i ) const
+        {
+            SFeature feat;
+
+            feat.u     = m_u_v[f_idx_i];
+            feat.v     = m_v_v[f_idx_i];
+            feat.d     = m_d_v[f_idx_i];
+            feat.t     = m_t_v[f_idx_i];
+            feat.e     = m_e_v[f_idx_i];
+            feat.f     = m_f_v[f_idx_i];
+            feat.idx   = m_idx_v[f_idx_i];
+            feat.state = (SFeature::EFeatureState) m_state_v[f_idx_i];
+
+            return feat;
+        }
+
+        void           set ( int f_idx_i, const SFeature & f_feature )
+        {
+            m_u_v[f_idx_i]   = f_feature.u;
+            m_v_v[f_idx_i]   = f_feature.v;
+            m_d_v[f_idx_i]   = f_feature.d;
+            m_t_v[f_idx_i]   = f_feature.t;
+            m_e_v[f_idx_i]   = f_feature.e;
+            m_f_v[f_idx_i]   = f_feature.f;
+            m_idx_v[f_idx_i] = f_feature.idx;
+
+            setState ( f_idx_i, f_feature.state );
+        }
+
+        /// Set the state of a feature and record the transition.
+        void           setState ( int f_idx_i, SFeature::EFeatureState f_state );
+
+        /// Record a modification of a feature.
+        void           touch ( int f_idx_i )
+        {
+            record ( f_idx_i, CF_CHANGED, m_changedList_v );
+        }
+
+        /// Columns.
+        const std::vector<double> &        getU ( )     const { return m_u_v; }
+        const std::vector<double> &        getV ( )     const { return m_v_v; }
+        const std::vector<double> &        getD ( )     const { return m_d_v; }
+        const std::vector<double> &        getE ( )     const { return m_e_v; }
+        const std::vector<int> &           getAge ( )   const { return m_t_v; }
+        const std::vector<size_t> &        getFrame ( ) const { return m_f_v; }
+        const std::vector<int> &           getIdx ( )   const { return m_idx_v; }
+        const std::vector<unsigned char> & getState ( ) const { return m_state_v; }
+
+        /// Is the feature new or tracked?
+        bool           isLive ( int f_idx_i ) const
+        {
+            return ( m_live_v[f_idx_i >> 5] >> ( f_idx_i & 31 ) ) & 1;
+        }
+
+        /// First live feature or size() if none.
+        int            firstLive ( ) const { return nextLive ( -1 ); }
+
+        /// Next live feature after f_idx_i or size() if none.
+        int            nextLive ( int f_idx_i ) const;
+
+        /// Number of live features.
+        int            getLiveCount ( ) const;
+
+        /// Features that became new, became lost or were modified since
+        /// the last call to clearChanges().
+        const std::vector<int> &  getNewList ( )     const { return m_newList_v; }
+        const std::vector<int> &  getLostList ( )    const { return m_lostList_v; }
+        const std::vector<int> &  getChangedList ( ) const { return m_changedList_v; }
+
+        /// Start a new frame of change tracking.
+        void           clearChanges ( );
+
+    private:
+        typedef enum
+        {
+            CF_CHANGED = 1,
+            CF_NEW     = 2,
+            CF_LOST    = 4
+        } EChangeFlag;
+
+        /// The flags are per feature, only the first change of a 
+        /// feature in a frame appends it to a list.
+        void           record ( int f_idx_i, EChangeFlag f_flag, std::vector<int> & fr_list_v )
+        {
+            if ( !( m_change_v[f_idx_i] & f_flag ) )
+            {
+                m_change_v[f_idx_i] |= f_flag;
+                appendChange ( f_idx_i, fr_list_v );
+            }
+        }
+
+        /// Append to a change list. Serialized between threads.
+        void           appendChange ( int f_idx_i, std::vector<int> & fr_list_v );
+
+        void           dropChanges ( std::vector<int> & fr_list_v,
+                                     size_t             f_size_ui );
+
+    private:
+        /// Columns.
+        std::vector<double>          m_u_v;
+        std::vector<double>          m_v_v;
+        std::vector<double>          m_d_v;
+        std::vector<int>             m_t_v;
+        std::vector<double>          m_e_v;
+        std::vector<size_t>          m_f_v;
+        std::vector<int>             m_idx_v;
+        std::vector<unsigned char>   m_state_v;
+
+        /// One bit per feature: new or tracked.
+        std::vector<unsigned int>    m_live_v;
+
+        /// Change flags per feature and change lists.
+        std::vector<unsigned char>   m_change_v;
+        std::vector<int>             m_newList_v;
+        std::vector<int>             m_lostList_v;
+        std::vector<int>             m_changedList_v;
+    };
+
+    /**
+     ***************************************************************************
+     *
+     * \class CFeatureHistory
+     *
+     * \brief Ring buffer with the last feature vectors.
+     *
+     * push() copies the columns of a feature vector into the slot of the
+     * oldest entry, so that the storage is reused from frame to frame.
+     * Entry 0 is the newest one.
+     *
+     ***************************************************************************/
+    class CFeatureHistory
+    {
+    public:
+        CFeatureHistory ( int f_length_i = 2 )
+                : m_entries_v (                   std::max(f_length_i, 1) ),
+                  m_newest_i (                                         0 ),
+                  m_count_i (                                          0 ) {}
+
+        /// Number of entries that can be stored.
+        int            getLength ( ) const { return m_entries_v.size(); }
+
+        /// Number of stored entries.
+        int            getCount ( ) const { return m_count_i; }
+
+        /// Store a copy of the columns of a vector as newest entry.
+        void           push ( const CFeatureVector & f_vector )
+        {
+            m_newest_i = ( m_newest_i + 1 ) % getLength();
+            m_entries_v[m_newest_i].copyColumns ( f_vector );
+            m_count_i = std::min ( m_count_i + 1, getLength() );
+        }
+
+        /// Entry of the given age (0: newest).
+        CFeatureVector &       operator [] ( int f_age_i )
+        {
+            return m_entries_v[( m_newest_i - f_age_i + getLength() ) % getLength()];
+        }
+
+        const CFeatureVector & operator [] ( int f_age_i ) const
+        {
+            return m_entries_v[( m_newest_i - f_age_i + getLength() ) % getLength()];
+        }
+
+        /// Remove all entries.
+        void           clear ( )
+        {
+            for (int i = 0; i < getLength(); ++i)
+                m_entries_v[i].clear();
+
+            m_count_i = 0;
+        }
+
+    private:
+        std::vector<CFeatureVector>   m_entries_v;
+        int                           m_newest_i;
+        int                           m_count_i;
+    };
 }
 
 
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose. 
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+#ifndef __PARALLELREDUCTION_H
+#define __PARALLELREDUCTION_H
+
+/**
+ *******************************************************************************
+ *
+ * @file parallelReduction.h
+ *
+ * \class CParallelReduction
+ * \author Hernan Badino (hernan.badino@gmail.com)
+ *
+ * \brief Per-thread accumulators for OpenMP reductions.
+ *
+ * Each thread of a parallel region adds into its own accumulator
+ * (getLocal()) and the accumulators are summed with reduce() after the
+ * region. Every accumulator starts at a cache line boundary and is padded
+ * to a multiple of the cache line size, so that threads never write
+ * into the same line. The accumulated type must provide clear() and
+ * operator +=.
+ *
+ *******************************************************************************/
+
+/* INCLUDES */
+#include <vector>
+#include <new>
+#include <algorithm>
+
+#if defined ( _OPENMP )
+#include <omp.h>
+#endif
+
+/* CONSTANTS */
+#define QCV_CACHE_LINE_SIZE 64
+
+namespace QCV
+{
+    template <class _Type, int _MaxThreads = 32>
+    class CParallelReduction
+    {
+    public:
+        CParallelReduction ( )
+        {
+            allocate();
+        }
+
+        /// The accumulators are scratch data: copies get their own.
+        CParallelReduction ( const CParallelReduction & )
+        {
+            allocate();
+        }
+
+        CParallelReduction & operator = ( const CParallelReduction & )
+        {
+            return *this;
+        }
+
+        ~CParallelReduction ( )
+        {
+            for (int i = 0; i < _MaxThreads; ++i)
+                at(i).~_Type();
+        }
+
+        /// Clear the accumulators and set the number of threads of the
+        /// next parallel region. Returns the number of threads.
+        int      reset ( )
+        {
+#if defined ( _OPENMP )
+            m_numThreads_i = std::min ( omp_get_max_threads(), _MaxThreads );
+#else
+            m_numThreads_i = 1;
+#endif
+            for (int i = 0; i < m_numThreads_i; ++i)
+                at(i).clear();
+
+            return m_numThreads_i;
+        }
+
+        /// Number of threads set with the last reset().
+        int      getNumThreads ( ) const
+        {
+            return m_numThreads_i;
+        }
+
+        /// Accumulator of the given thread.
+        _Type &  at ( int f_thread_i )
+        {
+            return *reinterpret_cast<_Type *>(m_base_p + f_thread_i * m_stride_ui);
+        }
+
+        /// Accumulator of the calling thread.
+        _Type &  getLocal ( )
+        {
+#if defined ( _OPENMP )
+            return at ( omp_get_thread_num() );
+#else
+            return at ( 0 );
+#endif
+        }
+
+        /// Sum of the accumulators in thread order.
+        void     reduce ( _Type & fr_result )
+        {
+            fr_result = at(0);
+
+            for (int i = 1; i < m_numThreads_i; ++i)
+                fr_result += at(i);
+        }
+
+    private:
+        void     allocate ( )
+        {
+            m_stride_ui = ( ( sizeof(_Type) + QCV_CACHE_LINE_SIZE - 1 ) /
+                            QCV_CACHE_LINE_SIZE ) * QCV_CACHE_LINE_SIZE;
+
+            m_buffer_v.resize ( _MaxThreads * m_stride_ui + QCV_CACHE_LINE_SIZE );
+
+            const size_t offset_ui = reinterpret_cast<size_t>(&m_buffer_v[0]) % QCV_CACHE_LINE_SIZE;
+
+            m_base_p = &m_buffer_v[0] + (offset_ui?QCV_CACHE_LINE_SIZE - offset_ui:0);
+
+            for (int i = 0; i < _MaxThreads; ++i)
+                new ( m_base_p + i * m_stride_ui ) _Type();
+
+            m_numThreads_i = 1;
+        }
+
+        /// Raw storage of the accumulators.
+        std::vector<unsigned char>    m_buffer_v;
+
+        /// First cache line aligned byte of the storage.
+        unsigned char *               m_base_p;
+
+        /// Bytes between two accumulators.
+        size_t                        m_stride_ui;
+
+        /// Number of threads of the current reduction.
+        int                           m_numThreads_i;
+    };
+}
+
+#endif // __PARALLELREDUCTION_H
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose.
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+#ifndef __SIMD4_H
+#define __SIMD4_H
+
+/**
+ *******************************************************************************
+ *
+ * @file simd4.h
+ *
+ * \author Hernan Badino (hernan.badino@gmail.com)
+ *
+ * \brief Four double lanes for the SIMD kernels.
+ *
+ * TDouble4 is one AVX register or two SSE2 registers. Float data is
+ * converted to double lanes when loaded, so that the kernels compute in
+ * double precision as the scalar code. Nothing is defined without SSE2;
+ * users must keep a scalar path for that case.
+ *
+ *******************************************************************************/
+
+/* INCLUDES */
+#if defined ( __AVX2__ )
+#include <immintrin.h>
+#elif defined ( __SSE2__ )
+#include <emmintrin.h>
+#endif
+
+namespace QCV
+{
+#if defined ( __AVX2__ )
+    typedef __m256d TDouble4;
+
+    static inline TDouble4 zero4 ( ) { return _mm256_setzero_pd(); }
+    static inline TDouble4 set4 ( double f_val_d ) { return _mm256_set1_pd ( f_val_d ); }
+    static inline TDouble4 add4 ( TDouble4 f_a, TDouble4 f_b ) { return _mm256_add_pd ( f_a, f_b ); }
+    static inline TDouble4 sub4 ( TDouble4 f_a, TDouble4 f_b ) { return _mm256_sub_pd ( f_a, f_b ); }
+    static inline TDouble4 mul4 ( TDouble4 f_a, TDouble4 f_b ) { return _mm256_mul_pd ( f_a, f_b ); }
+    static inline TDouble4 div4 ( TDouble4 f_a, TDouble4 f_b ) { return _mm256_div_pd ( f_a, f_b ); }
+    static inline TDouble4 and4 ( TDouble4 f_a, TDouble4 f_b ) { return _mm256_and_pd ( f_a, f_b ); }
+    static inline TDouble4 greaterZero4 ( TDouble4 f_a ) { return _mm256_cmp_pd ( f_a, _mm256_setzero_pd(), _CMP_GT_OQ ); }
+    static inline int      maskBits4 ( TDouble4 f_a ) { return _mm256_movemask_pd ( f_a ); }
+
+    static inline TDouble4 toDouble4 ( __m128 f_a ) { return _mm256_cvtps_pd ( f_a ); }
+    static inline __m128   toFloat4 ( TDouble4 f_a ) { return _mm256_cvtpd_ps ( f_a ); }
+
+    /// Extend a float comparison mask to the double lanes.
+    static inline TDouble4 mask4 ( __m128 f_mask )
+    {
+        return _mm256_castsi256_pd ( _mm256_cvtepi32_epi64 ( _mm_castps_si128 ( f_mask ) ) );
+    }
+
+    static inline TDouble4 load4 ( const double * f_src_p ) { return _mm256_loadu_pd ( f_src_p ); }
+    static inline TDouble4 load4 ( const float * f_src_p )  { return _mm256_cvtps_pd ( _mm_loadu_ps ( f_src_p ) ); }
+    static inline void store4 ( double * fr_dst_p, TDouble4 f_a ) { _mm256_storeu_pd ( fr_dst_p, f_a ); }
+    static inline void store4 ( float * fr_dst_p, TDouble4 f_a )  { _mm_storeu_ps ( fr_dst_p, _mm256_cvtpd_ps ( f_a ) ); }
+
+#elif defined ( __SSE2__ )
+    struct TDouble4 { __m128d lo, hi; };
+
+    static inline TDouble4 make4 ( __m128d f_lo, __m128d f_hi ) { TDouble4 r; r.lo = f_lo; r.hi = f_hi; return r; }
+    static inline TDouble4 zero4 ( ) { return make4 ( _mm_setzero_pd(), _mm_setzero_pd() ); }
+    static inline TDouble4 set4 ( double f_val_d ) { return make4 ( _mm_set1_pd ( f_val_d ), _mm_set1_pd ( f_val_d ) ); }
+    static inline TDouble4 add4 ( TDouble4 f_a, TDouble4 f_b ) { return make4 ( _mm_add_pd ( f_a.lo, f_b.lo ), _mm_add_pd ( f_a.hi, f_b.hi ) ); }
+    static inline TDouble4 sub4 ( TDouble4 f_a, TDouble4 f_b ) { return make4 ( _mm_sub_pd ( f_a.lo, f_b.lo ), _mm_sub_pd ( f_a.hi, f_b.hi ) ); }
+    static inline TDouble4 mul4 ( TDouble4 f_a, TDouble4 f_b ) { return make4 ( _mm_mul_pd ( f_a.lo, f_b.lo ), _mm_mul_pd ( f_a.hi, f_b.hi ) ); }
+    static inline TDouble4 div4 ( TDouble4 f_a, TDouble4 f_b ) { return make4 ( _mm_div_pd ( f_a.lo, f_b.lo ), _mm_div_pd ( f_a.hi, f_b.hi ) ); }
+    static inline TDouble4 and4 ( TDouble4 f_a, TDouble4 f_b ) { return make4 ( _mm_and_pd ( f_a.lo, f_b.lo ), _mm_and_pd ( f_a.hi, f_b.hi ) ); }
+    static inline TDouble4 greaterZero4 ( TDouble4 f_a ) { return make4 ( _mm_cmpgt_pd ( f_a.lo, _mm_setzero_pd() ), _mm_cmpgt_pd ( f_a.hi, _mm_setzero_pd() ) ); }
+    static inline int      maskBits4 ( TDouble4 f_a ) { return _mm_movemask_pd ( f_a.lo ) | ( _mm_movemask_pd ( f_a.hi ) << 2 ); }
+
+    static inline TDouble4 toDouble4 ( __m128 f_a ) { return make4 ( _mm_cvtps_pd ( f_a ), _mm_cvtps_pd ( _mm_movehl_ps ( f_a, f_a ) ) ); }
+    static inline __m128   toFloat4 ( TDouble4 f_a ) { return _mm_movelh_ps ( _mm_cvtpd_ps ( f_a.lo ), _mm_cvtpd_ps ( f_a.hi ) ); }
+
+    /// Extend a float comparison mask to the double lanes.
+    static inline TDouble4 mask4 ( __m128 f_mask )
+    {
+        const __m128i mask_i = _mm_castps_si128 ( f_mask );
+        return make4 ( _mm_castsi128_pd ( _mm_unpacklo_epi32 ( mask_i, mask_i ) ),
+                       _mm_castsi128_pd ( _mm_unpackhi_epi32 ( mask_i, mask_i ) ) );
+    }
+
+    static inline TDouble4 load4 ( const double * f_src_p ) { return make4 ( _mm_loadu_pd ( f_src_p ), _mm_loadu_pd ( f_src_p + 2 ) ); }
+    static inline TDouble4 load4 ( const float * f_src_p )  { return toDouble4 ( _mm_loadu_ps ( f_src_p ) ); }
+    static inline void store4 ( double * fr_dst_p, TDouble4 f_a ) { _mm_storeu_pd ( fr_dst_p, f_a.lo ); _mm_storeu_pd ( fr_dst_p + 2, f_a.hi ); }
+    static inline void store4 ( float * fr_dst_p, TDouble4 f_a )  { _mm_storeu_ps ( fr_dst_p, toFloat4 ( f_a ) ); }
+#endif
+}
+
+#endif // __SIMD4_H
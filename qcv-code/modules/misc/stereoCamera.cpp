@@ -30,12 +30,42 @@
 
 /* INCLUDES */
 #include <stdio.h>
+#include <vector>
 
 #include "doubleParam.h"
 #include "stereoCamera.h"
 
 using namespace QCV;
 
+/// Back-projection of a row of disparities. Invalid disparities give
+/// null points.
+template <class _Type>
+static inline void
+disparityRow2Local ( const _Type *  f_disp_p,
+                     const int      f_width_i,
+                     const float    f_dispFactor_f,
+                     const double * f_xFactor_p,
+                     const double   f_yFactor_d,
+                     const double   f_fuB_d,
+                     C3DVector *    fr_dst_p )
+{
+    for (int j = 0; j < f_width_i; ++j)
+    {
+        const double d_d = f_disp_p[j] / f_dispFactor_f;
+
+        if ( d_d > 0 )
+        {
+            const double z_d = f_fuB_d / d_d;
+
+            fr_dst_p[j].set ( f_xFactor_p[j] * z_d,
+                              f_yFactor_d    * z_d,
+                              z_d );
+        }
+        else
+            fr_dst_p[j].clear();
+    }
+}
+
 
 CStereoCamera::CStereoCamera ( ) 
         : CCamera ( ),
@@ -172,6 +202,34 @@ CStereoCamera::local2Image ( C3DVector  f_point,
     return res_b && f_point.z() > 0;
 }
 
+bool
+CStereoCamera::local2Image ( C3DVector  f_point,
+                             C3DVector &fr_projection,
+                             C3DMatrix &fr_jacobian ) const
+{
+    const double iz_d = 1. / f_point.z();
+    const double x_d  = f_point.x() * iz_d;
+    const double y_d  = f_point.y() * iz_d;
+
+    fr_projection.set ( x_d * m_fu_d + m_u0_d,
+                        m_v0_d - y_d * m_fv_d,
+                        m_fuB_d * iz_d );
+
+    fr_jacobian.at(0,0) = m_fu_d * iz_d;
+    fr_jacobian.at(0,1) = 0.;
+    fr_jacobian.at(0,2) = -m_fu_d * x_d * iz_d;
+
+    fr_jacobian.at(1,0) = 0.;
+    fr_jacobian.at(1,1) = -m_fv_d * iz_d;
+    fr_jacobian.at(1,2) = m_fv_d * y_d * iz_d;
+
+    fr_jacobian.at(2,0) = 0.;
+    fr_jacobian.at(2,1) = 0.;
+    fr_jacobian.at(2,2) = -m_fuB_d * iz_d * iz_d;
+
+    return f_point.z() > 0;
+}
+
 inline bool
 CStereoCamera::local2Image ( double  f_x_d, 
                              double  f_y_d,
@@ -303,6 +361,150 @@ CStereoCamera::image2Local ( C3DVector  f_imgPoint,
                          f_wPoint );
 }
 
+/// Local 3D points to image points and disparities.
+int
+CStereoCamera::local2Image ( int              f_size_i,
+                             const double *   f_x_p,
+                             const double *   f_y_p,
+                             const double *   f_z_p,
+                             double *         fr_u_p,
+                             double *         fr_v_p,
+                             double *         fr_d_p,
+                             const C3DMatrix *f_rotation_p,
+                             const C3DVector *f_translation_p,
+                             unsigned char *  fr_valid_p ) const
+{
+    return projectPoints ( f_size_i, f_x_p, f_y_p, f_z_p,
+                           fr_u_p, fr_v_p, fr_d_p, m_fuB_d,
+                           f_rotation_p, f_translation_p, fr_valid_p );
+}
+
+/// Local 3D points to image points and disparities.
+int
+CStereoCamera::local2Image ( int              f_size_i,
+                             const float *    f_x_p,
+                             const float *    f_y_p,
+                             const float *    f_z_p,
+                             float *          fr_u_p,
+                             float *          fr_v_p,
+                             float *          fr_d_p,
+                             const C3DMatrix *f_rotation_p,
+                             const C3DVector *f_translation_p,
+                             unsigned char *  fr_valid_p ) const
+{
+    return projectPoints ( f_size_i, f_x_p, f_y_p, f_z_p,
+                           fr_u_p, fr_v_p, fr_d_p, m_fuB_d,
+                           f_rotation_p, f_translation_p, fr_valid_p );
+}
+
+/// Image positions and disparities to local 3D points.
+int
+CStereoCamera::image2Local ( int              f_size_i,
+                             const double *   f_u_p,
+                             const double *   f_v_p,
+                             const double *   f_d_p,
+                             double *         fr_x_p,
+                             double *         fr_y_p,
+                             double *         fr_z_p,
+                             const C3DMatrix *f_rotation_p,
+                             const C3DVector *f_translation_p,
+                             unsigned char *  fr_valid_p ) const
+{
+    return backProjectPoints ( f_size_i, f_u_p, f_v_p, f_d_p,
+                               fr_x_p, fr_y_p, fr_z_p, m_fuB_d,
+                               f_rotation_p, f_translation_p, fr_valid_p );
+}
+
+/// Image positions and disparities to local 3D points.
+int
+CStereoCamera::image2Local ( int              f_size_i,
+                             const float *    f_u_p,
+                             const float *    f_v_p,
+                             const float *    f_d_p,
+                             float *          fr_x_p,
+                             float *          fr_y_p,
+                             float *          fr_z_p,
+                             const C3DMatrix *f_rotation_p,
+                             const C3DVector *f_translation_p,
+                             unsigned char *  fr_valid_p ) const
+{
+    return backProjectPoints ( f_size_i, f_u_p, f_v_p, f_d_p,
+                               fr_x_p, fr_y_p, fr_z_p, m_fuB_d,
+                               f_rotation_p, f_translation_p, fr_valid_p );
+}
+
+/// Disparity image to an image of local 3D points.
+bool
+CStereoCamera::disparityImage2Local ( const cv::Mat &  f_dispImg,
+                                      cv::Mat &        fr_pointImg,
+                                      float            f_dispFactor_f,
+                                      const C3DMatrix *f_rotation_p,
+                                      const C3DVector *f_translation_p ) const
+{
+    if ( f_dispImg.type() != CV_16S &&
+         f_dispImg.type() != CV_32F )
+    {
+        printf("%s:%i Disparity image must be of type CV_16S or CV_32F\n",
+               __FILE__, __LINE__ );
+        return false;
+    }
+
+    const int w_i = f_dispImg.cols;
+    const int h_i = f_dispImg.rows;
+
+    fr_pointImg.create ( h_i, w_i, CV_64FC3 );
+
+    if ( w_i <= 0 || h_i <= 0 )
+        return true;
+
+    /// x = (u - u0) / fu * z is computed with the factor of the column.
+    std::vector<double> xFactor_v ( w_i );
+
+    for (int j = 0; j < w_i; ++j)
+        xFactor_v[j] = (j - m_u0_d) / m_fu_d;
+
+    C3DMatrix rotation;
+    C3DVector translation;
+
+    if ( f_rotation_p )
+        rotation = *f_rotation_p;
+    else
+        rotation.loadIdentity();
+
+    if ( f_translation_p )
+        translation = *f_translation_p;
+    else
+        translation.clear();
+
+    const bool transform_b = f_rotation_p || f_translation_p;
+    const bool short_b     = f_dispImg.type() == CV_16S;
+
+#if defined ( _OPENMP )
+#pragma omp parallel for schedule(static)
+#endif
+    for (int i = 0; i < h_i; ++i)
+    {
+        const double yFactor_d = (m_v0_d - i) / m_fv_d;
+        C3DVector *  dst_p     = fr_pointImg.ptr<C3DVector>(i);
+
+        if ( short_b )
+            disparityRow2Local ( f_dispImg.ptr<short int>(i), w_i, f_dispFactor_f,
+                                 &xFactor_v[0], yFactor_d, m_fuB_d, dst_p );
+        else
+            disparityRow2Local ( f_dispImg.ptr<float>(i), w_i, f_dispFactor_f,
+                                 &xFactor_v[0], yFactor_d, m_fuB_d, dst_p );
+
+        if ( transform_b )
+        {
+            for (int j = 0; j < w_i; ++j)
+                if ( dst_p[j].z() > 0 )
+                    dst_p[j] = rotation * dst_p[j] + translation;
+        }
+    }
+
+    return true;
+}
+
 /// In local coordinate system
 inline double
 CStereoCamera::getDisparityFromDistance ( double f_dist_d ) const
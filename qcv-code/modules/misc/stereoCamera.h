@@ -119,6 +119,12 @@ namespace QCV
         virtual bool   local2Image ( C3DVector  f_point,
                                      C3DVector &fr_projection ) const;
 
+        /// Local 3D point to image projection point with the Jacobian
+        /// of (u, v, d) with respect to (x, y, z).
+        virtual bool   local2Image ( C3DVector  f_point,
+                                     C3DVector &fr_projection,
+                                     C3DMatrix &fr_jacobian ) const;
+
         /// Local 3D point to image point.
         virtual bool   local2Image ( double  f_x_d, 
                                      double  f_y_d,
@@ -169,6 +175,68 @@ namespace QCV
         virtual bool   image2Local ( C3DVector   f_imgPoint,
                                      C3DVector  &f_point ) const;
 
+    /// Batched transformations (see CCamera::local2Image).
+    public:
+        /// Local 3D points to image points and disparities.
+        int            local2Image ( int              f_size_i,
+                                     const double *   f_x_p,
+                                     const double *   f_y_p,
+                                     const double *   f_z_p,
+                                     double *         fr_u_p,
+                                     double *         fr_v_p,
+                                     double *         fr_d_p,
+                                     const C3DMatrix *f_rotation_p    = NULL,
+                                     const C3DVector *f_translation_p = NULL,
+                                     unsigned char *  fr_valid_p      = NULL ) const;
+
+        /// Local 3D points to image points and disparities.
+        int            local2Image ( int              f_size_i,
+                                     const float *    f_x_p,
+                                     const float *    f_y_p,
+                                     const float *    f_z_p,
+                                     float *          fr_u_p,
+                                     float *          fr_v_p,
+                                     float *          fr_d_p,
+                                     const C3DMatrix *f_rotation_p    = NULL,
+                                     const C3DVector *f_translation_p = NULL,
+                                     unsigned char *  fr_valid_p      = NULL ) const;
+
+        /// Image positions and disparities to local 3D points. The
+        /// rotation and translation are applied to the local points.
+        /// Points with disparity <= 0 are invalid and set to zero.
+        int            image2Local ( int              f_size_i,
+                                     const double *   f_u_p,
+                                     const double *   f_v_p,
+                                     const double *   f_d_p,
+                                     double *         fr_x_p,
+                                     double *         fr_y_p,
+                                     double *         fr_z_p,
+                                     const C3DMatrix *f_rotation_p    = NULL,
+                                     const C3DVector *f_translation_p = NULL,
+                                     unsigned char *  fr_valid_p      = NULL ) const;
+
+        /// Image positions and disparities to local 3D points.
+        int            image2Local ( int              f_size_i,
+                                     const float *    f_u_p,
+                                     const float *    f_v_p,
+                                     const float *    f_d_p,
+                                     float *          fr_x_p,
+                                     float *          fr_y_p,
+                                     float *          fr_z_p,
+                                     const C3DMatrix *f_rotation_p    = NULL,
+                                     const C3DVector *f_translation_p = NULL,
+                                     unsigned char *  fr_valid_p      = NULL ) const;
+
+        /// Disparity image (CV_16S or CV_32F) to an image of local 3D
+        /// points (CV_64FC3, one C3DVector per pixel). Disparities are
+        /// divided by f_dispFactor_f (e.g. 16 for fixed point disparities).
+        /// Pixels without disparity are set to zero.
+        bool           disparityImage2Local ( const cv::Mat &  f_dispImg,
+                                              cv::Mat &        fr_pointImg,
+                                              float            f_dispFactor_f  = 1.f,
+                                              const C3DMatrix *f_rotation_p    = NULL,
+                                              const C3DVector *f_translation_p = NULL ) const;
+
     /// Copy operator.
     public:       
         CStereoCamera & operator = ( const CCamera other );
@@ -32,6 +32,7 @@
 #include <math.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <float.h>
 
 #include "paramMacros.h" 
 #include "dynProgOp.h"
@@ -76,6 +77,22 @@ CDynamicProgrammingOp::CDynamicProgrammingOp( const int f_width_i,
           m_applyMedianFilter_b  (                             true ),
           m_medFiltHKSize_i (                                     9 ),
           m_pathTol_i (                                           5 ),
+          m_solver_e (                                SM_BRUTE_FORCE ),
+          m_envAccCost_v (                                          ),
+          m_envLeft_v (                                             ),
+          m_envLeftIdx_v (                                          ),
+          m_envLeft2_v (                                            ),
+          m_envRight_v (                                            ),
+          m_envRightIdx_v (                                         ),
+          m_envRight2_v (                                           ),
+          m_envTruncIdx_i (                                       0 ),
+          m_envTrunc2_d (                                        0. ),
+          m_envStartCol_i (                                       0 ),
+          m_envMaxAbsCost_d (                                    0. ),
+          m_leftTree (                                              ),
+          m_rightTree (                                             ),
+          m_truncTree (                                             ),
+          m_candidates_v (                                          ),
           m_paramSet_p (                                       NULL )
 {
     createParamSet();
@@ -98,6 +115,22 @@ CDynamicProgrammingOp::CDynamicProgrammingOp( )
           m_applyMedianFilter_b  (                             true ),
           m_medFiltHKSize_i (                                     9 ),
           m_pathTol_i (                                           5 ),
+          m_solver_e (                                SM_BRUTE_FORCE ),
+          m_envAccCost_v (                                          ),
+          m_envLeft_v (                                             ),
+          m_envLeftIdx_v (                                          ),
+          m_envLeft2_v (                                            ),
+          m_envRight_v (                                            ),
+          m_envRightIdx_v (                                         ),
+          m_envRight2_v (                                           ),
+          m_envTruncIdx_i (                                       0 ),
+          m_envTrunc2_d (                                        0. ),
+          m_envStartCol_i (                                       0 ),
+          m_envMaxAbsCost_d (                                    0. ),
+          m_leftTree (                                              ),
+          m_rightTree (                                             ),
+          m_truncTree (                                             ),
+          m_candidates_v (                                          ),
           m_paramSet_p (                                       NULL )
 {
     createParamSet();
@@ -182,7 +215,18 @@ CDynamicProgrammingOp::createParamSet()
                        this,
                        FollowPathTolerance,
                        CDynamicProgrammingOp );
-    
+
+    CEnumParameter<ESolverMode> * solverParam_p = static_cast<CEnumParameter<ESolverMode> * > (
+        ADD_ENUM_PARAMETER( "Solver",
+                            "Method for finding the best parent node of every node.",
+                            ESolverMode,
+                            getSolverMode(),
+                            this,
+                            SolverMode,
+                            CDynamicProgrammingOp ) );
+
+    solverParam_p -> addDescription ( SM_BRUTE_FORCE,    "Brute force O(W^2) search" );
+    solverParam_p -> addDescription ( SM_LOWER_ENVELOPE, "Lower envelope O(W) search" );
 }
 
 /* *************************** METHOD ************************************** */
@@ -510,8 +554,20 @@ CDynamicProgrammingOp::compute (  const cv::Mat          & f_costImg,
             endCol_i = f_followPath[i] + tolerance_i;
             if (endCol_i < 0 || endCol_i >= m_width_i) endCol_i = m_width_i - 1;
         }
-        
-        //printf("Starting in col %i ending in col %i (prev start: %i prev end: %i)\n", 
+
+        if (jumpCostVec.size())
+            jumpCost_f = jumpCostVec[i-1];
+
+        // The lower envelope is built once per row from the previous one.
+        // Rows for which it cannot be applied fall back to brute force.
+        const bool useEnvelope_b = ( m_solver_e == SM_LOWER_ENVELOPE &&
+                                     isfinite(currGrad_f) &&
+                                     prepareLowerEnvelope ( i-1,
+                                                            startColPrevRow_i,
+                                                            endColPrevRow_i,
+                                                            jumpCost_f ) );
+
+        //printf("Starting in col %i ending in col %i (prev start: %i prev end: %i)\n",
         //       startCol_i, endCol_i, startColThisRow_i, endColThisRow_i );
 
         // Let set a flag indicating that the first row has not stil been found.
@@ -548,7 +604,18 @@ CDynamicProgrammingOp::compute (  const cv::Mat          & f_costImg,
                 {
                     node2nodeDist_f = fabs(fr_vecRes[i] - j);
                     m_nodesImg.at<Node>(i,j).m_nodCost_f += m_predCost_f * std::min(node2nodeDist_f, m_predTh_f);
-                }                    
+                }
+
+                if ( useEnvelope_b )
+                {
+                    m_nodesImg.at<Node>(i,j).m_parNode_i =
+                        searchLowerEnvelope ( j,
+                                              m_nodesImg.at<Node>(i,j).m_nodCost_f,
+                                              currGrad_f,
+                                              jumpCost_f,
+                                              m_nodesImg.at<Node>(i,j).m_accCost_f );
+                    continue;
+                }
 
                 // Per default the parent node is the first one, i.e.
                 // the node corresponding to first valid cell in the 
@@ -703,3 +770,361 @@ CDynamicProgrammingOp::compute (  const cv::Mat          & f_costImg,
     return true;
 }
 
+/* *************************** METHOD ************************************** */
+/**
+ * Prepares the lower envelope of the previous row for the linear
+ * time search of the best parent nodes.
+ *
+ * \brief          Prepares the lower envelope of a row.
+ * \author         Hernan Badino
+ *
+ * \note           The smoothness cost jumpCost * min(|j-k-grad|, distTh)
+ *                 is the minimum of a linear term and a constant
+ *                 (truncation) term. The best parent of every node is
+ *                 then the minimum of the left branch (acc - jumpCost*k)
+ *                 up to the node, the right branch (acc + jumpCost*k)
+ *                 after the node and the truncation term (acc). A
+ *                 forward sweep stores the running minimum of the left
+ *                 branch and a backward sweep the one of the right
+ *                 branch, so the row is prepared in O(W). The sweeps 
+ *                 also keep the second lowest value. The three terms 
+ *                 are stored in minimum trees for collecting the 
+ *                 parents close to the minimum when there are several.
+ *
+ * \param[in]      f_row_i      - Row of the parent nodes.
+ * \param[in]      f_startCol_i - First valid column of the row.
+ * \param[in]      f_endCol_i   - Last valid column of the row.
+ * \param[in]      f_jumpCost_f - Distance cost of the row.
+ * \return         false if the envelope cannot be applied to this row.
+ *
+ *************************************************************************** */
+bool
+CDynamicProgrammingOp::prepareLowerEnvelope ( const int   f_row_i,
+                                              const int   f_startCol_i,
+                                              const int   f_endCol_i,
+                                              const float f_jumpCost_f )
+{
+    /// The envelope requires a non-decreasing smoothness term.
+    if ( !(f_jumpCost_f >= 0.f) || !isfinite(f_jumpCost_f) ||
+         !(m_distTh_f   >= 0.f) || !isfinite(m_distTh_f) )
+        return false;
+
+    const int size_i = f_endCol_i - f_startCol_i + 1;
+
+    if ( size_i <= 0 )
+        return false;
+
+    m_envAccCost_v.resize  ( size_i );
+    m_envLeft_v.resize     ( size_i );
+    m_envLeftIdx_v.resize  ( size_i );
+    m_envLeft2_v.resize    ( size_i );
+    m_envRight_v.resize    ( size_i );
+    m_envRightIdx_v.resize ( size_i );
+    m_envRight2_v.resize   ( size_i );
+
+    m_leftTree.init  ( size_i );
+    m_rightTree.init ( size_i );
+    m_truncTree.init ( size_i );
+
+    m_envMaxAbsCost_d = 0.;
+
+    for (int k = 0; k < size_i; ++k)
+    {
+        m_envAccCost_v[k] = m_nodesImg.at<Node>(f_row_i, f_startCol_i + k).m_accCost_f;
+
+        if ( !isfinite(m_envAccCost_v[k]) )
+            return false;
+
+        m_envMaxAbsCost_d = std::max( m_envMaxAbsCost_d, (double) fabs(m_envAccCost_v[k]) );
+    }
+
+    const double jc_d = f_jumpCost_f;
+
+    /// Forward sweep.
+    m_envTruncIdx_i = 0;
+    m_envTrunc2_d   = HUGE_VAL;
+
+    for (int k = 0; k < size_i; ++k)
+    {
+        const double left_d = m_envAccCost_v[k] - jc_d * (f_startCol_i + k);
+
+        if ( k == 0 )
+        {
+            m_envLeft_v[k]    = left_d;
+            m_envLeftIdx_v[k] = k;
+            m_envLeft2_v[k]   = HUGE_VAL;
+        }
+        else if ( left_d < m_envLeft_v[k-1] )
+        {
+            m_envLeft_v[k]    = left_d;
+            m_envLeftIdx_v[k] = k;
+            m_envLeft2_v[k]   = m_envLeft_v[k-1];
+        }
+        else
+        {
+            m_envLeft_v[k]    = m_envLeft_v[k-1];
+            m_envLeftIdx_v[k] = m_envLeftIdx_v[k-1];
+            m_envLeft2_v[k]   = std::min( m_envLeft2_v[k-1], left_d );
+        }
+
+        if ( k > 0 )
+        {
+            if ( m_envAccCost_v[k] < m_envAccCost_v[m_envTruncIdx_i] )
+            {
+                m_envTrunc2_d   = m_envAccCost_v[m_envTruncIdx_i];
+                m_envTruncIdx_i = k;
+            }
+            else
+                m_envTrunc2_d   = std::min( m_envTrunc2_d, (double) m_envAccCost_v[k] );
+        }
+
+        m_leftTree[k]  = left_d;
+        m_truncTree[k] = m_envAccCost_v[k];
+    }
+
+    /// Backward sweep.
+    for (int k = size_i - 1; k >= 0; --k)
+    {
+        const double right_d = m_envAccCost_v[k] + jc_d * (f_startCol_i + k);
+
+        if ( k == size_i - 1 )
+        {
+            m_envRight_v[k]    = right_d;
+            m_envRightIdx_v[k] = k;
+            m_envRight2_v[k]   = HUGE_VAL;
+        }
+        else if ( right_d <= m_envRight_v[k+1] )
+        {
+            m_envRight_v[k]    = right_d;
+            m_envRightIdx_v[k] = k;
+            m_envRight2_v[k]   = m_envRight_v[k+1];
+        }
+        else
+        {
+            m_envRight_v[k]    = m_envRight_v[k+1];
+            m_envRightIdx_v[k] = m_envRightIdx_v[k+1];
+            m_envRight2_v[k]   = std::min( m_envRight2_v[k+1], right_d );
+        }
+
+        m_rightTree[k] = right_d;
+    }
+
+    m_leftTree.build();
+    m_rightTree.build();
+    m_truncTree.build();
+
+    m_envStartCol_i = f_startCol_i;
+
+    return true;
+}
+
+/* *************************** METHOD ************************************** */
+/**
+ * Searches the best parent node using the lower envelope of the
+ * previous row.
+ *
+ * \brief          Searches the best parent node of a node.
+ * \author         Hernan Badino
+ *
+ * \note           The minimum of the envelope is taken from the sweeps
+ *                 in double precision. All parent nodes whose cost is 
+ *                 within the rounding error of the float costs are then
+ *                 scored with the same expression as the brute force 
+ *                 search, keeping the first lowest one. Usually this is
+ *                 only the minimum of a term, otherwise they are 
+ *                 collected from the trees. The result is
+ *                 therefore identical to the brute force search. If 
+ *                 too many parents are within the rounding error (flat
+ *                 costs), all parents are scored as in the brute force
+ *                 search.
+ *
+ * \param[in]      f_col_i      - Column of the node.
+ * \param[in]      f_nodCost_f  - Cost of the node.
+ * \param[in]      f_grad_f     - Expected gradient.
+ * \param[in]      f_jumpCost_f - Distance cost of the row.
+ * \param[out]     fr_accCost_f - Accumulated cost of the node.
+ * \return         Best parent node.
+ *
+ *************************************************************************** */
+int
+CDynamicProgrammingOp::searchLowerEnvelope ( const int   f_col_i,
+                                             const float f_nodCost_f,
+                                             const float f_grad_f,
+                                             const float f_jumpCost_f,
+                                             float &     fr_accCost_f )
+{
+    const int    size_i   = (int) m_envAccCost_v.size();
+    const double jc_d     = f_jumpCost_f;
+    const double distTh_d = m_distTh_f;
+
+    /// Column of the previous row with zero smoothness cost.
+    const double center_d = f_col_i - (double) f_grad_f;
+
+    /// Last index of the left branch.
+    const double split_d = floor ( center_d ) - m_envStartCol_i;
+    const int    split_i = split_d < -1.?-1:(split_d > size_i-1?size_i-1:(int)split_d);
+
+    double min_d = m_envAccCost_v[m_envTruncIdx_i] + jc_d * distTh_d;
+
+    if ( split_i >= 0 )
+        min_d = std::min( min_d, m_envLeft_v[split_i] + jc_d * center_d );
+
+    if ( split_i + 1 < size_i )
+        min_d = std::min( min_d, m_envRight_v[split_i + 1] - jc_d * center_d );
+
+    /// Bound of the rounding error of the float costs.
+    const double tol_d = 4. * FLT_EPSILON * ( m_envMaxAbsCost_d + fabs(f_nodCost_f) +
+                                              jc_d * ( m_width_i + fabs(f_grad_f) + 1. ) );
+    const double th_d = min_d + 2. * tol_d;
+
+    /// Scoring more candidates is not cheaper than the brute force.
+    const int maxCandidates_i = 8 + size_i / 8;
+
+    /// Thresholds of the three terms.
+    const double truncTh_d = th_d - jc_d * distTh_d;
+    const double leftTh_d  = th_d - jc_d * center_d;
+    const double rightTh_d = th_d + jc_d * center_d;
+
+    /// The trees are only searched if the second lowest value of a 
+    /// term is within the threshold.
+    m_candidates_v.clear();
+
+    bool found_b = isfinite(th_d);
+
+    if ( found_b )
+    {
+        if ( m_envTrunc2_d <= truncTh_d )
+            found_b = m_truncTree.collect ( 0, size_i-1, truncTh_d,
+                                            maxCandidates_i, m_candidates_v );
+        else if ( m_envAccCost_v[m_envTruncIdx_i] <= truncTh_d )
+            m_candidates_v.push_back ( m_envTruncIdx_i );
+    }
+
+    if ( found_b && split_i >= 0 )
+    {
+        if ( m_envLeft2_v[split_i] <= leftTh_d )
+            found_b = m_leftTree.collect ( 0, split_i, leftTh_d,
+                                           maxCandidates_i, m_candidates_v );
+        else if ( m_envLeft_v[split_i] <= leftTh_d )
+            m_candidates_v.push_back ( m_envLeftIdx_v[split_i] );
+    }
+
+    if ( found_b && split_i + 1 < size_i )
+    {
+        if ( m_envRight2_v[split_i + 1] <= rightTh_d )
+            found_b = m_rightTree.collect ( split_i + 1, size_i-1, rightTh_d,
+                                            maxCandidates_i, m_candidates_v );
+        else if ( m_envRight_v[split_i + 1] <= rightTh_d )
+            m_candidates_v.push_back ( m_envRightIdx_v[split_i + 1] );
+    }
+
+    if ( !found_b || m_candidates_v.empty() )
+    {
+        m_candidates_v.clear();
+
+        for (int k = 0; k < size_i; ++k)
+            m_candidates_v.push_back ( k );
+    }
+
+    int bestNode_i = -1;
+
+    for (unsigned int c = 0; c < m_candidates_v.size(); ++c)
+    {
+        const int   k               = m_envStartCol_i + m_candidates_v[c];
+        const float node2nodeDist_f = fabs(f_col_i - k - f_grad_f);
+
+        const float newCost_f = ( // Accumulated Cost.
+            m_envAccCost_v[m_candidates_v[c]] +
+                // Local Cost.
+            f_nodCost_f +
+                // Smoothness cost with saturation.
+            f_jumpCost_f * std::min(node2nodeDist_f, m_distTh_f) );
+
+        /// Same as the brute force search: the first lowest one.
+        if ( bestNode_i == -1 ||
+             newCost_f < fr_accCost_f ||
+             ( newCost_f == fr_accCost_f && k < bestNode_i ) )
+        {
+            fr_accCost_f = newCost_f;
+            bestNode_i   = k;
+        }
+    }
+
+    return bestNode_i;
+}
+
+/* *************************** METHOD ************************************** */
+/**
+ * Minimum tree for collecting the values below a threshold.
+ *
+ * \brief          Minimum tree.
+ * \author         Hernan Badino
+ *
+ * \note           The leaves hold the values, every inner node the 
+ *                 minimum of its children. Building the tree is O(n) 
+ *                 and collecting r values is O((r+1) log n).
+ *
+ *************************************************************************** */
+void
+CDynamicProgrammingOp::CMinTree::init ( const int f_size_i )
+{
+    m_leaves_i = 1;
+
+    while ( m_leaves_i < f_size_i )
+        m_leaves_i *= 2;
+
+    m_min_v.assign ( 2 * m_leaves_i, HUGE_VAL );
+}
+
+void
+CDynamicProgrammingOp::CMinTree::build ( )
+{
+    for (int n = m_leaves_i - 1; n >= 1; --n)
+        m_min_v[n] = std::min ( m_min_v[2*n], m_min_v[2*n+1] );
+}
+
+bool
+CDynamicProgrammingOp::CMinTree::collect ( const int          f_first_i,
+                                           const int          f_last_i,
+                                           const double       f_th_d,
+                                           const int          f_max_i,
+                                           std::vector<int> & fr_idx_v )
+{
+    /// Triplets of node, first and last leaf.
+    m_stack_v.clear();
+    m_stack_v.push_back ( 1 );
+    m_stack_v.push_back ( 0 );
+    m_stack_v.push_back ( m_leaves_i - 1 );
+
+    while ( !m_stack_v.empty() )
+    {
+        const int last_i  = m_stack_v.back(); m_stack_v.pop_back();
+        const int first_i = m_stack_v.back(); m_stack_v.pop_back();
+        const int n       = m_stack_v.back(); m_stack_v.pop_back();
+
+        if ( last_i < f_first_i || first_i > f_last_i || !(m_min_v[n] <= f_th_d) )
+            continue;
+
+        if ( n >= m_leaves_i )
+        {
+            if ( (int) fr_idx_v.size() >= f_max_i )
+                return false;
+
+            fr_idx_v.push_back ( n - m_leaves_i );
+            continue;
+        }
+
+        const int mid_i = ( first_i + last_i ) / 2;
+
+        m_stack_v.push_back ( 2*n+1 );
+        m_stack_v.push_back ( mid_i + 1 );
+        m_stack_v.push_back ( last_i );
+
+        m_stack_v.push_back ( 2*n );
+        m_stack_v.push_back ( first_i );
+        m_stack_v.push_back ( mid_i );
+    }
+
+    return true;
+}
+
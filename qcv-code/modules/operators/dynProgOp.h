@@ -49,6 +49,8 @@
 
 namespace QCV
 {    
+    class CParameterSet;
+
     class CDynamicProgrammingOp
     {
     public:
@@ -68,6 +70,19 @@ namespace QCV
             short int m_parNode_i;
         };
 
+        /// Solver used to find the best parent of every node.
+        typedef enum 
+        {
+            /// Compare every node against every valid node of 
+            /// the previous row.
+            SM_BRUTE_FORCE,
+
+            /// Use the lower envelope of the truncated linear 
+            /// smoothness term (O(W) per row). Same paths as 
+            /// SM_BRUTE_FORCE.
+            SM_LOWER_ENVELOPE
+        } ESolverMode;
+
     public:
     
         /******************************/
@@ -133,6 +148,9 @@ namespace QCV
 
         bool  setFollowPathTolerance ( const int f_tol_i ) { m_pathTol_i = f_tol_i<1?1:f_tol_i; return true;}
         int   getFollowPathTolerance ( ) const { return m_pathTol_i; }
+
+        bool  setSolverMode ( const ESolverMode f_mode_e ) { m_solver_e = f_mode_e; return true;}
+        ESolverMode getSolverMode ( ) const { return m_solver_e; }
     
         bool  setCostImageSize( const int f_width_i, 
                                 const int f_height_i );
@@ -157,6 +175,54 @@ namespace QCV
         void  reinitialize();
         void  createParamSet();
 
+        bool  prepareLowerEnvelope ( const int   f_row_i,
+                                     const int   f_startCol_i,
+                                     const int   f_endCol_i,
+                                     const float f_jumpCost_f );
+
+        int   searchLowerEnvelope ( const int   f_col_i,
+                                    const float f_nodCost_f,
+                                    const float f_grad_f,
+                                    const float f_jumpCost_f,
+                                    float &     fr_accCost_f );
+
+        /******************************/
+        /*    PROTECTED DATA TYPES    */
+        /******************************/
+    protected:
+
+        /// Minimum tree for collecting all values below a threshold.
+        class CMinTree
+        {
+        public:
+            /// Resizes the tree and sets all values to infinity.
+            void     init ( const int f_size_i );
+
+            /// Value of a leaf. Call build() after setting all values.
+            double & operator [] ( const int f_idx_i ) { return m_min_v[m_leaves_i + f_idx_i]; }
+
+            /// Computes the minimum of the inner nodes (O(n)).
+            void     build ( );
+
+            /// Appends all indices in [f_first_i, f_last_i] with a 
+            /// value lower or equal than f_th_d. Returns false if there 
+            /// are more than f_max_i of them.
+            bool     collect ( const int          f_first_i,
+                               const int          f_last_i,
+                               const double       f_th_d,
+                               const int          f_max_i,
+                               std::vector<int> & fr_idx_v );
+
+        private:
+            /// Number of leaves (power of 2).
+            int                               m_leaves_i;
+
+            /// Minimum of every node. Node n has children 2n and 2n+1.
+            std::vector<double>               m_min_v;
+
+            /// Nodes pending to be visited by collect.
+            std::vector<int>                  m_stack_v;
+        };
 
         /******************************/
         /*    PROTECTED MEMBERS       */
@@ -212,6 +278,54 @@ namespace QCV
         /// around the path to follow. For pyramidal implementation.
         int                               m_pathTol_i;
 
+        /// Solver mode.
+        ESolverMode                       m_solver_e;
+
+        /// Accumulated cost of the valid nodes of the previous row.
+        std::vector<float>                m_envAccCost_v;
+
+        /// Forward sweep: minimum of (acc - jumpCost*k) over [0, p].
+        std::vector<double>               m_envLeft_v;
+
+        /// Index of the minimum of m_envLeft_v.
+        std::vector<int>                  m_envLeftIdx_v;
+
+        /// Second lowest value of the forward sweep.
+        std::vector<double>               m_envLeft2_v;
+
+        /// Backward sweep: minimum of (acc + jumpCost*k) over [p, end].
+        std::vector<double>               m_envRight_v;
+
+        /// Index of the minimum of m_envRight_v.
+        std::vector<int>                  m_envRightIdx_v;
+
+        /// Second lowest value of the backward sweep.
+        std::vector<double>               m_envRight2_v;
+
+        /// Index of the minimum acc cost (truncated distance cost).
+        int                               m_envTruncIdx_i;
+
+        /// Second lowest acc cost.
+        double                            m_envTrunc2_d;
+
+        /// First column of the previous row in the envelope.
+        int                               m_envStartCol_i;
+
+        /// Maximum absolute acc cost of the previous row.
+        double                            m_envMaxAbsCost_d;
+
+        /// Previous row acc cost minus the linear distance cost.
+        CMinTree                          m_leftTree;
+
+        /// Previous row acc cost plus the linear distance cost.
+        CMinTree                          m_rightTree;
+
+        /// Previous row acc cost (truncated distance cost).
+        CMinTree                          m_truncTree;
+
+        /// Candidate parent nodes of the current node.
+        std::vector<int>                  m_candidates_v;
+
         /// Parameter set.
         CParameterSet *                   m_paramSet_p;
 
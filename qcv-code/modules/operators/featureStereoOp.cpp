@@ -28,7 +28,7 @@
 #include "stereoCamera.h"
 
 #if defined HAVE_QGLVIEWER
-#include "glViewer.h"
+#include "3DViewerBase.h"
 #endif
 
 /// Dependeing on the parameters might be better not to use OPENMP here.
@@ -69,7 +69,8 @@ CFeatureStereoOp::CFeatureStereoOp ( COperator * const f_parent_p,
      m_show3DPoints_b (                           false ),
      m_preFilter_b (                              false ),
      m_showLeftImage_b (                           true ),
-     m_showRightImage_b (                          true )
+     m_showRightImage_b (                          true ),
+     m_refinementClocks_v (                            )
 
 {
    registerDrawingLists();
@@ -248,6 +249,24 @@ CFeatureStereoOp::~CFeatureStereoOp ()
 {
 }
 
+/// I/O accessed by cycle().
+bool
+CFeatureStereoOp::getCycleIO ( std::vector<std::string> & fr_inputs_v,
+                               std::vector<std::string> & fr_outputs_v ) const
+{
+    fr_inputs_v.push_back ( m_featPointVector_str );
+    fr_inputs_v.push_back ( m_idLeftImage_str );
+    fr_inputs_v.push_back ( m_idRightImage_str );
+    fr_inputs_v.push_back ( "Rectified Camera" );
+
+    /// The disparity of the features is stored in the input vector.
+    fr_outputs_v.push_back ( m_featPointVector_str );
+    fr_outputs_v.push_back ( "Sparse Disparity Image" );
+    fr_outputs_v.push_back ( "Stereo Triangulated 3D Points" );
+
+    return true;
+}
+
 /// Cycle event.
 bool
 CFeatureStereoOp::cycle()
@@ -309,16 +328,12 @@ CFeatureStereoOp::cycle()
             
             stopClock("First Correlation");
             
-            char clockId_str[256];
-            
            /// 3.- Iterate for all levels.
             for (int i = startLevel_i-1; i >=0; --i)
             {
-               sprintf(clockId_str, "Refinement level %i", i);               
-               startClock(clockId_str);
+               CScopedClock clock ( getRefinementClock ( i ) );
                /// a.- Transfer level.
                transferLevel( i );
-               stopClock(clockId_str);
             }
             
             startClock("Disparity Image Generation");
@@ -338,6 +353,22 @@ CFeatureStereoOp::cycle()
    return COperator::cycle();
 }
 
+CClock *
+CFeatureStereoOp::getRefinementClock ( int f_level_i )
+{
+   if ( f_level_i >= (int) m_refinementClocks_v.size() )
+      m_refinementClocks_v.resize ( f_level_i + 1, NULL );
+
+   if ( !m_refinementClocks_v[f_level_i] )
+   {
+      char clockId_str[256];
+      sprintf(clockId_str, "Refinement level %i", f_level_i);
+      m_refinementClocks_v[f_level_i] = registerClock ( clockId_str );
+   }
+
+   return m_refinementClocks_v[f_level_i];
+}
+
 void 
 CFeatureStereoOp::generateDispImage( const CFeatureVector *f_vec_p )
 {
@@ -426,9 +457,12 @@ CFeatureStereoOp::computeFirstCorrelation( int f_fromLevel_i )
    S2D<int> hMask (mask.width/2, mask.height/2);
     
    CFeatureVector &vec = *featureVector_p;
+
+   m_disp_v.assign ( vec.getD().begin(), vec.getD().end() );
     
 #if not defined ( _OPENMP )
    float * const scores_p = m_scoresACTUAL_p[0] + FSO_MAX_WIDTH;
+   CZssdCorrelation & correlation = m_correlations_p[0];
 #else
    const unsigned int numThreads_ui = std::min(omp_get_max_threads(), FSO_MAX_CORES);
 #pragma omp parallel for num_threads(numThreads_ui) schedule(dynamic)
@@ -438,6 +472,7 @@ CFeatureStereoOp::computeFirstCorrelation( int f_fromLevel_i )
 #if defined ( _OPENMP )
       const unsigned int threadNum_ui = omp_get_thread_num();
       float * const scores_p = m_scoresACTUAL_p[threadNum_ui] + FSO_MAX_WIDTH;
+      CZssdCorrelation & correlation = m_correlations_p[threadNum_ui];
 #endif
       S2D<int> featPos ( vec[f].u / scale_i + .5, 
                          vec[f].v / scale_i + .5 );
@@ -449,7 +484,7 @@ CFeatureStereoOp::computeFirstCorrelation( int f_fromLevel_i )
       {
          if ( !disp.at<float>(featPos.y,featPos.x) )
          {
-            vec[f].d = INVALID_DISP;
+            m_disp_v[f] = INVALID_DISP;
               
             /// Row limits.
             S2D<int> vlimit ( featPos.y - hMask.height, 
@@ -477,48 +512,24 @@ CFeatureStereoOp::computeFirstCorrelation( int f_fromLevel_i )
                      int   bestDisp_i     = INVALID_DISP;
                      float maskVar_f      = std::numeric_limits<float>::max();
                                 
+                     correlation.setLeftWindow ( imgL, featPos.x, featPos.y, hMask );
+                     correlation.compute ( imgR, rlimit.min, rlimit.max );
+
+                     const float sumL_f = correlation.getSumL();
+
                      for (int colrPos = rlimit.min; colrPos <= rlimit.max; ++colrPos)
                      {
                         int d = featPos.x - colrPos;
-                        /// Column limits for current disparity.
-                        S2D<int> uRlimit ( colrPos - hMask.width, 
-                                           colrPos + hMask.width );
+                        int k = colrPos - rlimit.min;
 
-                        /// The following should never happen.
-                        if ( uRlimit.min < 0 ||
-                             uRlimit.max >= imgSize.width )
-                        {
-                           printf("%s:%i Invalid right limits\n", __FILE__, __LINE__);
-                           continue;
-                        }                            
-                            
-                        float sumL_f    = 0.f;
-                        float sumR_f    = 0.f;
-                        float sumSqR_f  = 0.f;
-                        float sumSq_f   = 0.f;
+                        float sumR_f    = correlation.getSumR(k);
+                        float sumSq_f   = correlation.getSumSqDiff(k);
                         float varR_f    = 0.f;
                                   
-                       /// Correlate windows now.
-                        for (int i = vlimit.min; i <= vlimit.max; ++i)
-                        {
-                           uint8_t *ptrL_p = &imgL.at<uint8_t>(i,uLlimit.x);
-                           uint8_t *ptrR_p = &imgR.at<uint8_t>(i,uRlimit.x);;
-                                
-                           for (int j = 0; j < mask.width; ++j, ++ptrL_p, ++ptrR_p)
-                           {
-                              float diff_f = (float)*ptrL_p - (float)*ptrR_p;
-                              sumL_f  += *ptrL_p;
-                              sumR_f  += *ptrR_p;
-                              sumSq_f += diff_f * diff_f;
-                                    
-                               if ( m_checkVars_b )
-                                 sumSqR_f += (float)( *ptrR_p * *ptrR_p);
-                           }
-                        }
-
                         if ( m_checkVars_b )
                         {
-                           float sqR_f  = sumR_f * sumR_f / maskSize_i;
+                           float sumSqR_f = correlation.getSumSqR(k);
+                           float sqR_f    = sumR_f * sumR_f / maskSize_i;
                            varR_f = (sumSqR_f - sqR_f) / maskSize_i;
                         }
 
@@ -549,7 +560,7 @@ CFeatureStereoOp::computeFirstCorrelation( int f_fromLevel_i )
                           ( !m_checkVars_b || 
                             ( maskVar_f > m_minVar_f ) ) )
                      {
-                        vec[f].d = bestDisp_i;
+                        m_disp_v[f] = bestDisp_i;
 
                         if ( subPixel_i == 1 )
                         {
@@ -561,11 +572,11 @@ CFeatureStereoOp::computeFirstCorrelation( int f_fromLevel_i )
 
                            if (correction_f <= 0.5 && correction_f >= -0.5)
                            {
-                              vec[f].d += nom_f / denom_f;
+                              m_disp_v[f] += nom_f / denom_f;
                            }
                         }
 
-                        disp.at<float>(featPos.y,featPos.x) = vec[f].d;
+                        disp.at<float>(featPos.y,featPos.x) = m_disp_v[f];
                      }
                      else
                      {
@@ -579,38 +590,40 @@ CFeatureStereoOp::computeFirstCorrelation( int f_fromLevel_i )
                         else 
                            m_rejCause_v[f] = ERC_LOWVARIANCE;
 
-                        vec[f].d = INVALID_DISP;
+                        m_disp_v[f] = INVALID_DISP;
                      }
                   }
                   else
                   {
                      m_rejCause_v[f] = ERC_OTHER;
-                     vec[f].d = INVALID_DISP;
+                     m_disp_v[f] = INVALID_DISP;
                   }
                }
                else // Correlation not possible because feature is at border of image
                {
-                  vec[f].d = INVALID_DISP;
+                  m_disp_v[f] = INVALID_DISP;
                   m_rejCause_v[f] = ERC_ATBORDER;
                }                
             }
             else // Correlation not possible because feature is at border of image
             {
-               vec[f].d  = INVALID_DISP;
+               m_disp_v[f]  = INVALID_DISP;
                m_rejCause_v[f] = ERC_ATBORDER;
             }                
          }                       
          else // Correlation has already been computed.
          {
-            vec[f].d = disp.at<float>(featPos.y,featPos.x);
+            m_disp_v[f] = disp.at<float>(featPos.y,featPos.x);
          }                
       }
       else // Outside bounds.
       {
          m_rejCause_v[f] = ERC_OTHER;
-         vec[f].d  = INVALID_DISP;
+         m_disp_v[f]  = INVALID_DISP;
       }                
    }
+
+   storeDisparities ( vec );
    
    return true;
 }
@@ -646,9 +659,11 @@ CFeatureStereoOp::transferLevel( int f_level_i )
 
    CFeatureVector &vec = *featureVector_p;
 
+   m_disp_v.assign ( vec.getD().begin(), vec.getD().end() );
 
 #if not defined ( _OPENMP )
    float * const scores_p = m_scoresACTUAL_p[0] + FSO_MAX_WIDTH;
+   CZssdCorrelation & correlation = m_correlations_p[0];
 #else
    const unsigned int numThreads_ui = std::min(omp_get_max_threads(), FSO_MAX_CORES);
 #pragma omp parallel for num_threads(numThreads_ui) schedule(dynamic)
@@ -658,11 +673,12 @@ CFeatureStereoOp::transferLevel( int f_level_i )
 #if defined ( _OPENMP )
       const unsigned int threadNum_ui = omp_get_thread_num();
       float * const scores_p = m_scoresACTUAL_p[threadNum_ui] + FSO_MAX_WIDTH;
+      CZssdCorrelation & correlation = m_correlations_p[threadNum_ui];
 #endif        
       S2D<int> featPos ( vec[f].u / scale_i + .5, 
                          vec[f].v / scale_i + .5 );
 
-      if ( vec[f].d >= 0 )
+      if ( m_disp_v[f] >= 0 )
       {
          if ( featPos.x >= 0 && featPos.y >= 0 &&
               featPos.x < imgSize.width && featPos.y < imgSize.height )
@@ -685,8 +701,8 @@ CFeatureStereoOp::transferLevel( int f_level_i )
                      /// Hard-encode left limit to 1
                      const int leftDeltaDisp_i = 1;
                      
-                     S2D<int> rlimit ( std::max(featPos.x - ((int)vec[f].d)*2 - leftDeltaDisp_i - subPixel_i, hMask.width), 
-                                       std::min(featPos.x - ((int)vec[f].d)*2 + m_deltaDisp_i + subPixel_i, imgSize.width - 1 - hMask.width ) );
+                     S2D<int> rlimit ( std::max(featPos.x - ((int)m_disp_v[f])*2 - leftDeltaDisp_i - subPixel_i, hMask.width), 
+                                       std::min(featPos.x - ((int)m_disp_v[f])*2 + m_deltaDisp_i + subPixel_i, imgSize.width - 1 - hMask.width ) );
 
                      if (rlimit.max - rlimit.min > 1)
                      {
@@ -698,46 +714,24 @@ CFeatureStereoOp::transferLevel( int f_level_i )
                         int   bestDisp_i     = INVALID_DISP;
                         float maskVar_f      = std::numeric_limits<float>::max();
                         
+                        correlation.setLeftWindow ( imgL, featPos.x, featPos.y, hMask );
+                        correlation.compute ( imgR, rlimit.min, rlimit.max );
+
+                        const float sumL_f = correlation.getSumL();
+
                         for (int colrPos_i = rlimit.min; colrPos_i <= rlimit.max; ++colrPos_i)
                         {
                            int d = featPos.x - colrPos_i;
-                           /// Column limits for current disparity.
-                           S2D<int> uRlimit ( colrPos_i - hMask.width, 
-                                              colrPos_i + hMask.width );
-                            
-                           if ( uRlimit.min < 0 ||
-                                uRlimit.max >= imgSize.width )
-                           {
-                              //getchar();
-                           }                            
-                            
-                           float sumL_f    = 0.f;
-                           float sumR_f    = 0.f;
-                           float sumSqR_f  = 0.f;
-                           float sumSq_f   = 0.f;
+                           int k = colrPos_i - rlimit.min;
+
+                           float sumR_f    = correlation.getSumR(k);
+                           float sumSq_f   = correlation.getSumSqDiff(k);
                            float varR_f    = 0.f;
                             
-                           /// Correlate windows now.
-                           for (int i = vlimit.min; i <= vlimit.max; ++i)
-                           {
-                              uint8_t *ptrL_p = &imgL.at<uint8_t>(i,uLlimit.x);
-                              uint8_t *ptrR_p = &imgR.at<uint8_t>(i,uRlimit.x);
-                                
-                              for (int j = 0; j < mask.width; ++j, ++ptrL_p, ++ptrR_p)
-                              {
-                                 float diff_f = (float)*ptrL_p - (float)*ptrR_p;
-                                 sumL_f  += *ptrL_p;
-                                 sumR_f  += *ptrR_p;
-                                 sumSq_f += diff_f * diff_f;
-                                    
-                                 if ( m_checkVars_b )
-                                    sumSqR_f += (float)( *ptrR_p * *ptrR_p);
-                              }
-                           }
-                            
                            if ( m_checkVars_b )
                            {
-                              float sqR_f  = sumR_f * sumR_f / maskSize_i;
+                              float sumSqR_f = correlation.getSumSqR(k);
+                              float sqR_f    = sumR_f * sumR_f / maskSize_i;
                               varR_f = (sumSqR_f - sqR_f) / maskSize_i;
                            }
 
@@ -772,7 +766,7 @@ CFeatureStereoOp::transferLevel( int f_level_i )
                              ( !m_checkVars_b || 
                                ( maskVar_f > m_minVar_f ) ) )
                         {
-                           vec[f].d = bestDisp_i;
+                           m_disp_v[f] = bestDisp_i;
 
                            if ( f_level_i == 0 )
                            {
@@ -785,21 +779,21 @@ CFeatureStereoOp::transferLevel( int f_level_i )
                                 
                               if (correction_f <= 0.5 && correction_f >= -0.5)
                               {
-                                 vec[f].d += correction_f + m_dispOffset_f;
+                                 m_disp_v[f] += correction_f + m_dispOffset_f;
                               }
                               else
                               {
                                  m_rejCause_v[f] = ERC_OTHER;
-                                 vec[f].d = INVALID_DISP;
+                                 m_disp_v[f] = INVALID_DISP;
                               }                              
                            }
 
-                           disp.at<float>(featPos.y,featPos.x) = vec[f].d;     
+                           disp.at<float>(featPos.y,featPos.x) = m_disp_v[f];     
                         }
                         else
                         {
 
-                         vec[f].d = INVALID_DISP;
+                         m_disp_v[f] = INVALID_DISP;
                            if (!( bestDisp_i     > dlimit.min - (1-subPixel_i) &&
                                   bestDisp_i     < dlimit.max + (1-subPixel_i)) )
                               m_rejCause_v[f] = ERC_LIMIT;
@@ -814,39 +808,53 @@ CFeatureStereoOp::transferLevel( int f_level_i )
                      else
                      {   
                         m_rejCause_v[f] = ERC_INVALIDDISP;
-                        vec[f].d = INVALID_DISP;
+                        m_disp_v[f] = INVALID_DISP;
                      }  
 
                   }
                   else // Correlation not possible because feature is at border of image
                   {
                      m_rejCause_v[f] = ERC_ATBORDER;
-                     vec[f].d = INVALID_DISP;
+                     m_disp_v[f] = INVALID_DISP;
                   }                
                }
                else // Correlation not possible because feature is at border of image
                {
-                  vec[f].d = INVALID_DISP;
+                  m_disp_v[f] = INVALID_DISP;
                   m_rejCause_v[f] = ERC_ATBORDER;
                }                
             }                       
             else // Correlation has already been computed.
             {
-               vec[f].d = disp.at<float>(featPos.y,featPos.x);
+               m_disp_v[f] = disp.at<float>(featPos.y,featPos.x);
             }   
          }
          else // Outside bounds.
          {
             m_rejCause_v[f] = ERC_OTHER;
-            vec[f].d  = INVALID_DISP;
+            m_disp_v[f]  = INVALID_DISP;
          }                
       }
    }
 
+   storeDisparities ( vec );
 
    return true;
 }
 
+void
+CFeatureStereoOp::storeDisparities( CFeatureVector &fr_vec )
+{
+   const std::vector<double> &d_v = fr_vec.getD();
+
+   for (int f = 0; f < (int)m_disp_v.size(); ++f)
+   {
+      if ( m_disp_v[f] != d_v[f] )
+         fr_vec[f].d = m_disp_v[f];
+   }
+}
+
+
 /// Show event.
 bool CFeatureStereoOp::show()
 {
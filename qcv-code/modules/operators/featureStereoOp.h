@@ -45,6 +45,7 @@
 #include "colorEncoding.h"
 #include "3DPointVector.h"
 #include "feature.h"
+#include "zssdCorrelation.h"
 
 /* PROTOTYPES */
 
@@ -84,6 +85,10 @@ namespace QCV
         /// Exit event.
         virtual bool exit();
 
+        /// I/O accessed by cycle().
+        virtual bool getCycleIO ( std::vector<std::string> & fr_inputs_v,
+                                  std::vector<std::string> & fr_outputs_v ) const;
+
     /// User Operation Events
     public:
         /// Key pressed in display.
@@ -134,6 +139,14 @@ namespace QCV
 
         void generateDispImage( const CFeatureVector *f_vec );
 
+        /// Write the disparities of m_disp_v that differ into the
+        /// feature vector. Called after the parallel loops, so that the
+        /// changed list keeps the order of the features.
+        void storeDisparities( CFeatureVector &fr_vec );
+
+        /// Clock of a refinement level.
+        CClock * getRefinementClock ( int f_level_i );
+
        //void generate3DPointList( const CStereoFeaturePointVector *f_vec );
 
     private:
@@ -223,15 +236,25 @@ namespace QCV
 
         /// Rejection cause
         std::vector<ERejectionCause> m_rejCause_v;
+
+        /// Disparities computed by the parallel loops.
+        std::vector<double>          m_disp_v;
+
         /// Show left image
         bool                         m_showLeftImage_b;
        
         /// Show right image
         bool                         m_showRightImage_b;
+
+        /// Clocks of the refinement levels (NULL if not used yet).
+        std::vector<CClock *>        m_refinementClocks_v;
        
     private:
         /// Data structure to store scores.
         float m_scoresACTUAL_p[FSO_MAX_CORES][2*FSO_MAX_WIDTH];
+
+        /// Correlation kernels.
+        CZssdCorrelation m_correlations_p[FSO_MAX_CORES];
     };
 }
 #endif // __FEATURESTEREOOP_H
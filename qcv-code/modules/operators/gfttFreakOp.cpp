@@ -33,6 +33,8 @@
 /* INCLUDES */
 #include <limits>
 
+#include <QtGui/QMouseEvent>
+
 #include "gfttFreakOp.h"
 #include "paramMacros.h"
 #include "drawingList.h"
@@ -46,12 +48,39 @@
 
 using namespace QCV;
 
+static inline int
+popCount ( unsigned int f_val_ui )
+{
+#if defined ( __GNUC__ )
+    return __builtin_popcount ( f_val_ui );
+#else
+    f_val_ui = f_val_ui - ((f_val_ui >> 1) & 0x55555555);
+    f_val_ui = (f_val_ui & 0x33333333) + ((f_val_ui >> 2) & 0x33333333);
+    return (((f_val_ui + (f_val_ui >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+#endif
+}
+
+/// Cell of coordinate f_val_d clamped to [0, f_cells_i-1].
+static inline int
+cellIndex ( double f_val_d, float f_cellSize_f, int f_cells_i )
+{
+    const double cell_d = floor ( f_val_d / f_cellSize_f );
+
+    if ( !(cell_d > 0) )
+        return 0;
+
+    if ( cell_d > f_cells_i - 1 )
+        return f_cells_i - 1;
+
+    return (int) cell_d;
+}
+
 /// Constructors.
 CGfttFreakOp::CGfttFreakOp ( COperator * const f_parent_p,
                              const std::string f_name_str )
     : COperator (             f_parent_p, f_name_str ),
       m_inpImageId_str (                   "Image 0" ),
-      m_featPointVector_str (       "Feature Vector" ),
+      m_featPointVector_str ("Detected Feature Vector" ),
       m_compute_b (                             true ),
       m_numFeatures_i (                         4096 ),
       m_img (                                        ),
@@ -59,7 +88,6 @@ CGfttFreakOp::CGfttFreakOp ( COperator * const f_parent_p,
                                S2D<float> ( 0, 200 ) ),
       m_gftt_p (                                NULL ),
       m_freak_p (                               NULL ),
-      m_matcher_p (                             NULL ),
       m_cnt_i (                                    0 ),
 
       m_subPixBlockSize_i (                        3 ), 
@@ -76,10 +104,18 @@ CGfttFreakOp::CGfttFreakOp ( COperator * const f_parent_p,
       m_maxDescriptorDistance_f (               1000 ),
       m_correlation_b (                        false ),
       m_normalizedCorr_b (                     false ),
-      m_maxFeatPerTile_i (                         2 )
+      m_maxFeatPerTile_i (                         2 ),
+      m_imagePort (                                  ),
+      m_frameNumberPort (                            ),
+      m_motionPort (                                 ),
+      m_cameraPort (                                 )
 {
     registerDrawingLists(  );
     registerParameters (  );
+
+    m_frameNumberPort.bind ( this, "Frame Number" );
+    m_motionPort.bind      ( this, "Predicted Motion" );
+    m_cameraPort.bind      ( this, "Rectified Camera" );
 }
 
 void
@@ -256,6 +292,21 @@ CGfttFreakOp::~CGfttFreakOp ()
 {
 }
 
+/// I/O accessed by cycle().
+bool
+CGfttFreakOp::getCycleIO ( std::vector<std::string> & fr_inputs_v,
+                           std::vector<std::string> & fr_outputs_v ) const
+{
+    fr_inputs_v.push_back ( m_inpImageId_str );
+    fr_inputs_v.push_back ( "Frame Number" );
+    fr_inputs_v.push_back ( "Predicted Motion" );
+    fr_inputs_v.push_back ( "Rectified Camera" );
+
+    fr_outputs_v.push_back ( m_featPointVector_str );
+
+    return true;
+}
+
 /// Cycle event.
 bool
 CGfttFreakOp::cycle()
@@ -263,13 +314,16 @@ CGfttFreakOp::cycle()
    m_img.copyTo(m_prevImg);
 
    if ( m_compute_b )
-      m_img = getInput<cv::Mat>(m_inpImageId_str, cv::Mat() ); 
+   {
+      m_imagePort.bind ( this, m_inpImageId_str );
+      m_img = m_imagePort.get ( cv::Mat() ); 
+   }
 
    if ( m_compute_b && m_img.cols > 0)
    {
       ++m_cnt_i;
       
-      size_t imgNr_u = getInput<int> ("Frame Number", 0 );     
+      size_t imgNr_u = m_frameNumberPort.get ( 0 );     
       
       /// \todo: check if image is grayscale
       /// \todo: apply gaussian filter if required.
@@ -455,7 +509,8 @@ CGfttFreakOp::cycle()
       stopClock ("Extractor");
 
       // For visualization
-      m_prevFeatureVector = m_featureVector;
+      m_prevFeatureVector.copyColumns ( m_featureVector );
+      m_featureVector.clearChanges();
       
       if ( imgNr_u == 0 )
       {
@@ -479,20 +534,11 @@ CGfttFreakOp::cycle()
       {
          startClock ("Matcher");
          
-         startClock ("Matcher - Create Mask");
-
-         // Create mask based on distances
-         cv::Mat match_mask ( prevFeatures.keypoints_v.size(),
-                              currFeatures.keypoints_v.size(),
-                              CV_8UC1,
-                              cv::Scalar(0) );
-      
-         // use integer value for reducing the processing time of generating masks
          size_t prevSize_ui = prevFeatures.keypoints_v.size();
          size_t currSize_ui = currFeatures.keypoints_v.size();	      
 
-         SRigidMotion *   motion_p = getInput<SRigidMotion>  ( "Predicted Motion" );
-         CStereoCamera *  camera_p = getInput<CStereoCamera> ( "Rectified Camera" );
+         SRigidMotion *   motion_p = m_motionPort.get();
+         CStereoCamera *  camera_p = m_cameraPort.get();
          
          // \todo: do parameter
          float xyRatio_f = camera_p?camera_p->getFu()/camera_p->getFv():1;
@@ -502,76 +548,200 @@ CGfttFreakOp::cycle()
          if (motion_p)
             motion = *motion_p;         
 
+         startClock ("Matcher - Create Grid");
+
+         // The cells are as large as the largest search window so that 
+         // few cells are visited per key point.
+         float maxDist_f = m_maxDistance_f;
+         if (camera_p && motion_p)
+            maxDist_f = std::max(maxDist_f, m_maxDistanceForPred_f);
+
+         const float cellWidth_f = sqrt(std::max(maxDist_f, 0.f)) + 1.f;
+
+         buildKeyPointGrid ( currFeatures.keypoints_v,
+                             cellWidth_f,
+                             xyRatio_f > 0?cellWidth_f / xyRatio_f:m_img.rows );
+
+         stopClock ("Matcher - Create Grid");
+
+         // Matching from the previous frame to the current frame. Only
+         // the current key points inside the (predicted) search window
+         // are compared.
+         startClock ("Forward Matching");
+
+         prevFeatures.radius_matches_v.assign ( prevSize_ui, std::vector<cv::DMatch>() );
+         m_candidates_v.resize ( prevSize_ui );
+
+         // Predicted positions of the previous key points with a known
+         // disparity, computed in one batch.
+         const bool predict_b = camera_p && motion_p && prevSize_ui > 0;
+
+         if ( predict_b )
+         {
+            m_predU_v.resize ( prevSize_ui );
+            m_predV_v.resize ( prevSize_ui );
+            m_predD_v.resize ( prevSize_ui );
+            m_predX_v.resize ( prevSize_ui );
+            m_predY_v.resize ( prevSize_ui );
+            m_predZ_v.resize ( prevSize_ui );
+            m_predValid_v.resize ( prevSize_ui );
+
+            for(unsigned i = 0; i < prevSize_ui; i ++)
+            {
+               int idx_i = i < prevFeatures.idx_feature_v.size()?prevFeatures.idx_feature_v[i]:-1;
+
+               if (idx_i >= 0)
+               {
+                  m_predU_v[i] = m_prevFeatureVector[idx_i].u;
+                  m_predV_v[i] = m_prevFeatureVector[idx_i].v;
+                  m_predD_v[i] = m_prevFeatureVector[idx_i].d;
+               }
+               else
+               {
+                  m_predU_v[i] = prevFeatures.keypoints_v[i].pt.x;
+                  m_predV_v[i] = prevFeatures.keypoints_v[i].pt.y;
+                  m_predD_v[i] = -1;
+               }
+            }
+
+            camera_p->image2Local ( prevSize_ui,
+                                    &m_predU_v[0], &m_predV_v[0], &m_predD_v[0],
+                                    &m_predX_v[0], &m_predY_v[0], &m_predZ_v[0],
+                                    &motion.rotation, &motion.translation,
+                                    &m_predValid_v[0] );
+
+            camera_p->local2Image ( prevSize_ui,
+                                    &m_predX_v[0], &m_predY_v[0], &m_predZ_v[0],
+                                    &m_predU_v[0], &m_predV_v[0], &m_predD_v[0] );
+         }
+
 #if defined ( _OPENMP )
          const unsigned int numThreads_ui = omp_get_max_threads();
 #pragma omp parallel for num_threads(numThreads_ui) schedule(dynamic)
 #endif
          for(unsigned i = 0; i < prevSize_ui; i ++)
          {
-            int idx_i = prevFeatures.idx_feature_v[i];
+            std::vector<SCandidate> &candidates_v = m_candidates_v[i];
+            candidates_v.clear();
+
+            cv::KeyPoint *k1 = &prevFeatures.keypoints_v[i];
+
+            int idx_i = i < prevFeatures.idx_feature_v.size()?prevFeatures.idx_feature_v[i]:-1;
 
             int    maxDist_i   = static_cast<int>(m_maxDistance_f);
 
-            C3DVector prediction ( m_prevFeatureVector[idx_i].u,
-                                   m_prevFeatureVector[idx_i].v,
-                                   m_prevFeatureVector[idx_i].d );
+            C3DVector prediction ( k1->pt.x, k1->pt.y, -1 );
 
-            if (camera_p && prediction.z() > 0 && motion_p)
+            if (idx_i >= 0)
+               prediction = C3DVector ( m_prevFeatureVector[idx_i].u,
+                                        m_prevFeatureVector[idx_i].v,
+                                        m_prevFeatureVector[idx_i].d );
+
+            if ( predict_b && m_predValid_v[i] )
             {
-               C3DVector p;
-               camera_p->image2Local ( prediction,
-                                       p );
-               C3DVector p2 = motion.rotation * p + motion.translation;
-               camera_p->local2Image ( p2, p );
-               prediction = p;
+               prediction = C3DVector ( m_predU_v[i],
+                                        m_predV_v[i],
+                                        m_predD_v[i] );
                maxDist_i  = m_maxDistanceForPred_f;
             }
 
-            cv::KeyPoint *k1 = &prevFeatures.keypoints_v[i];
-            uchar *p1 = &match_mask.data[i*match_mask.step];
-            cv::Point2f refPnt = k1->pt;
-            cv::KeyPoint *k2 = &currFeatures.keypoints_v[0];
+            if (maxDist_i <= 0)
+               continue;
+
+            // Conservative window: |dx| and |dy*xyRatio| are truncated 
+            // below before being compared.
+            const double halfWidth_d  = sqrt((double)maxDist_i) + 1.;
+            const double halfHeight_d = xyRatio_f > 0?halfWidth_d / xyRatio_f:m_img.rows;
+
+            const int cx1_i = cellIndex ( prediction.x() - halfWidth_d,  m_grid.cellWidth_f,  m_grid.cols_i );
+            const int cx2_i = cellIndex ( prediction.x() + halfWidth_d,  m_grid.cellWidth_f,  m_grid.cols_i );
+            const int cy1_i = cellIndex ( prediction.y() - halfHeight_d, m_grid.cellHeight_f, m_grid.rows_i );
+            const int cy2_i = cellIndex ( prediction.y() + halfHeight_d, m_grid.cellHeight_f, m_grid.rows_i );
+
+            const cv::Mat &desc1 = prevFeatures.descriptors;
+            const cv::Mat &desc2 = currFeatures.descriptors;
+            
+            int   best_i      = -1;
+            float bestDist_f  = 0;
 
-            for(unsigned j = 0; j < currSize_ui; j++, ++p1, ++k2) 
+            for (int cy = cy1_i; cy <= cy2_i; ++cy)
             {
-               int dx=static_cast<int>(prediction.x() - k2->pt.x);
-               int dy=static_cast<int>((prediction.y() - k2->pt.y)*xyRatio_f);
-               *p1 = (dx*dx+dy*dy < maxDist_i);
+               for (int cx = cx1_i; cx <= cx2_i; ++cx)
+               {
+                  const int cell_i = cy * m_grid.cols_i + cx;
+                  
+                  for (int c = m_grid.cellStart_v[cell_i]; c < m_grid.cellStart_v[cell_i+1]; ++c)
+                  {
+                     const int j = m_grid.idx_v[c];
+                     const cv::KeyPoint *k2 = &currFeatures.keypoints_v[j];
+
+                     int dx=static_cast<int>(prediction.x() - k2->pt.x);
+                     int dy=static_cast<int>((prediction.y() - k2->pt.y)*xyRatio_f);
+
+                     if (dx*dx+dy*dy >= maxDist_i)
+                        continue;
+
+                     SCandidate cand;
+                     cand.idx_i  = j;
+                     cand.dist_f = descriptorDistance ( desc1, i, desc2, j );
+                     candidates_v.push_back ( cand );
+
+                     // Ties are resolved as cv::BFMatcher does: lowest index.
+                     if ( best_i == -1 || 
+                          cand.dist_f < bestDist_f || 
+                          ( cand.dist_f == bestDist_f && j < best_i ) )
+                     {
+                        best_i     = j;
+                        bestDist_f = cand.dist_f;
+                     }
+                  }
+               }
             }
+
+            if (best_i != -1)
+               prevFeatures.radius_matches_v[i].push_back ( cv::DMatch ( i, best_i, bestDist_f ) );
          }
-         stopClock ("Matcher - Create Mask");
 
-         // Matching from the previous frame to the current frame
-         startClock ("Forward Matching");
-         m_matcher_p->knnMatch( prevFeatures.descriptors, 
-                                currFeatures.descriptors, 
-                                prevFeatures.radius_matches_v,
-                                1,
-                                match_mask);//m_featureMatchTh_f);
          stopClock ("Forward Matching");
-
       
-         // Matching from the current frame to the previous frame
+         // Matching from the current frame to the previous frame reusing
+         // the distances of the forward matching.
          startClock ("Backward Matching");
-         m_matcher_p->knnMatch( currFeatures.descriptors, 
-                                prevFeatures.descriptors, 
-                                currFeatures.radius_matches_v,
-                                1,
-                                match_mask.t());//m_featureMatchTh_f);
+
+         std::vector<int>   bestPrev_v ( currSize_ui, -1 );
+         std::vector<float> bestDist_v ( currSize_ui, 0.f );
+
+         for(size_t i = 0; i < prevSize_ui; i ++) 
+         {
+            const std::vector<SCandidate> &candidates_v = m_candidates_v[i];
+            
+            for (size_t c = 0; c < candidates_v.size(); ++c)
+            {
+               const int j = candidates_v[c].idx_i;
+
+               if ( bestPrev_v[j] == -1 || candidates_v[c].dist_f < bestDist_v[j] )
+               {
+                  bestPrev_v[j] = i;
+                  bestDist_v[j] = candidates_v[c].dist_f;
+               }
+            }
+         }
+
          stopClock ("Backward Matching");
       
          startClock ("Check consistency");      
          // Check the consistency of the matches.
-         for(size_t i = 0; i < currFeatures.radius_matches_v.size(); i ++) 
+         currFeatures.radius_matches_v.assign ( currSize_ui, std::vector<cv::DMatch>() );
+
+         for(size_t i = 0; i < currSize_ui; i ++) 
          {
-            if(currFeatures.radius_matches_v[i].size() != 0)  
+            const int prev_i = bestPrev_v[i];
+            
+            if( prev_i != -1 &&
+                !prevFeatures.radius_matches_v[prev_i].empty() &&
+                prevFeatures.radius_matches_v[prev_i].at(0).trainIdx == (signed)i ) 
             {
-               if( prevFeatures.radius_matches_v[currFeatures.radius_matches_v[i].at(0).trainIdx].empty() ||
-                   prevFeatures.radius_matches_v[currFeatures.radius_matches_v[i].at(0).trainIdx].at(0).trainIdx != (signed)i) 
-               {
-                  currFeatures.radius_matches_v[i].clear();
-               }
-
+               currFeatures.radius_matches_v[i].push_back ( cv::DMatch ( i, prev_i, bestDist_v[i] ) );
             }
          }
          stopClock ("Check consistency");
@@ -696,6 +866,81 @@ CGfttFreakOp::cycle()
    return COperator::cycle();
 }
 
+void
+CGfttFreakOp::buildKeyPointGrid ( const std::vector<cv::KeyPoint> & f_keypoints_v,
+                                  float                             f_cellWidth_f,
+                                  float                             f_cellHeight_f )
+{
+   /// Do not create more than 256 cells per dimension.
+   m_grid.cellWidth_f  = std::max(f_cellWidth_f,  std::max(4.f, m_img.cols / 256.f));
+   m_grid.cellHeight_f = std::max(f_cellHeight_f, std::max(4.f, m_img.rows / 256.f));
+   m_grid.cols_i       = (int)(m_img.cols / m_grid.cellWidth_f)  + 1;
+   m_grid.rows_i       = (int)(m_img.rows / m_grid.cellHeight_f) + 1;
+
+   const int cells_i = m_grid.cols_i * m_grid.rows_i;
+
+   std::vector<int> cellIdx_v ( f_keypoints_v.size() );
+
+   m_grid.cellStart_v.assign ( cells_i + 1, 0 );
+   m_grid.idx_v.resize ( f_keypoints_v.size() );
+   
+   /// Counting sort by cell keeping the key point order in each cell.
+   for (size_t i = 0; i < f_keypoints_v.size(); ++i)
+   {
+      cellIdx_v[i] = ( cellIndex ( f_keypoints_v[i].pt.y, m_grid.cellHeight_f, m_grid.rows_i ) * m_grid.cols_i + 
+                       cellIndex ( f_keypoints_v[i].pt.x, m_grid.cellWidth_f,  m_grid.cols_i ) );
+      ++m_grid.cellStart_v[cellIdx_v[i]+1];
+   }
+
+   for (int c = 0; c < cells_i; ++c)
+      m_grid.cellStart_v[c+1] += m_grid.cellStart_v[c];
+
+   std::vector<int> pos_v ( m_grid.cellStart_v.begin(), m_grid.cellStart_v.end() - 1 );
+
+   for (size_t i = 0; i < f_keypoints_v.size(); ++i)
+      m_grid.idx_v[pos_v[cellIdx_v[i]]++] = i;
+}
+
+float
+CGfttFreakOp::descriptorDistance ( const cv::Mat & f_desc1,
+                                   int             f_row1_i,
+                                   const cv::Mat & f_desc2,
+                                   int             f_row2_i ) const
+{
+   const uchar * d1_p = f_desc1.ptr<uchar>(f_row1_i);
+   const uchar * d2_p = f_desc2.ptr<uchar>(f_row2_i);
+   const int     n_i  = f_desc1.cols;
+
+   if ( m_correlation_b )
+   {
+      int sum_i = 0;
+      
+      for (int k = 0; k < n_i; ++k)
+      {
+         const int diff_i = d1_p[k] - d2_p[k];
+         sum_i += diff_i * diff_i;
+      }
+
+      return sqrt((float)sum_i);
+   }
+
+   int dist_i = 0;
+   int k      = 0;
+
+   for (; k + 4 <= n_i; k += 4)
+   {
+      unsigned int w1_ui, w2_ui;
+      memcpy ( &w1_ui, d1_p + k, 4 );
+      memcpy ( &w2_ui, d2_p + k, 4 );
+      dist_i += popCount ( w1_ui ^ w2_ui );
+   }
+
+   for (; k < n_i; ++k)
+      dist_i += popCount ( d1_p[k] ^ d2_p[k] );
+
+   return (float) dist_i;
+}
+
 /// Show event.
 bool CGfttFreakOp::show()
 {
@@ -829,9 +1074,6 @@ bool CGfttFreakOp::initialize()
     if (m_freak_p) delete m_freak_p;
     m_freak_p = new cv::FREAK (false, false, 18.0, 0);
    
-    if (m_matcher_p) delete m_matcher_p;
-    m_matcher_p = new cv::BFMatcher(m_correlation_b?cv::NORM_L2:cv::NORM_HAMMING, false); //
-
     m_featureVector.clear();
     m_featureVector.resize( m_numFeatures_i );
     m_prevFeatureVector = m_featureVector;
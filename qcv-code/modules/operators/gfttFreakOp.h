@@ -56,6 +56,10 @@
 
 namespace QCV
 {
+    class CCamera;
+    class CStereoCamera;
+    class SRigidMotion;
+
     class CGfttFreakOp: public COperator
     {
     public:       
@@ -87,6 +91,10 @@ namespace QCV
         /// Exit event.
         virtual bool exit();
 
+        /// I/O accessed by cycle().
+        virtual bool getCycleIO ( std::vector<std::string> & fr_inputs_v,
+                                  std::vector<std::string> & fr_outputs_v ) const;
+
         /// Mouse moved.
         virtual void mouseMoved (     CMouseEvent * f_event_p );
 
@@ -129,6 +137,18 @@ namespace QCV
 
         void registerParameters(  );
 
+        /// Sort the current key points into m_grid.
+        void buildKeyPointGrid ( const std::vector<cv::KeyPoint> & f_keypoints_v,
+                                 float                             f_cellWidth_f,
+                                 float                             f_cellHeight_f );
+
+        /// Distance between row f_row1_i of f_desc1 and row f_row2_i of
+        /// f_desc2 as computed by cv::BFMatcher (Hamming or L2).
+        float descriptorDistance ( const cv::Mat & f_desc1,
+                                   int             f_row1_i,
+                                   const cv::Mat & f_desc2,
+                                   int             f_row2_i ) const;
+
     /// Protected data types
     protected:
         struct SFeatureData
@@ -151,6 +171,27 @@ namespace QCV
            
         };
 
+        /// Uniform grid over the key points of the current frame. The
+        /// key points of cell c are idx_v[cellStart_v[c]] to
+        /// idx_v[cellStart_v[c+1]-1] in increasing order.
+        struct SKeyPointGrid
+        {
+            float                                    cellWidth_f;
+            float                                    cellHeight_f;
+            int                                      cols_i;
+            int                                      rows_i;
+            std::vector<int>                         cellStart_v;
+            std::vector<int>                         idx_v;
+        };
+
+        /// Key point of the current frame in the search window of a key
+        /// point of the previous frame.
+        struct SCandidate
+        {
+            int                                      idx_i;
+            float                                    dist_f;
+        };
+
     private:
         
         /// Input image Id.
@@ -180,11 +221,28 @@ namespace QCV
         /// Freak extractor
         cv::FREAK *                         m_freak_p;
 
-        /// Matcher
- 	cv::BFMatcher *                     m_matcher_p;
-
         /// Feature data
         SFeatureData                        m_featData[2];
+
+        /// Spatial index of the current key points
+        SKeyPointGrid                       m_grid;
+
+        /// Candidates of each previous key point
+        std::vector< std::vector<SCandidate> > m_candidates_v;
+
+        /// Image position and disparity of the previous key points,
+        /// replaced by their predicted position.
+        std::vector<double>                 m_predU_v;
+        std::vector<double>                 m_predV_v;
+        std::vector<double>                 m_predD_v;
+
+        /// 3D position of the previous key points after the motion.
+        std::vector<double>                 m_predX_v;
+        std::vector<double>                 m_predY_v;
+        std::vector<double>                 m_predZ_v;
+
+        /// Previous key points with a valid prediction.
+        std::vector<unsigned char>          m_predValid_v;
        
         /// Counter
         int                                 m_cnt_i;
@@ -214,6 +272,18 @@ namespace QCV
        bool m_normalizedCorr_b;
 
        int m_maxFeatPerTile_i;
+
+       /// Input image.
+       CIOPort<cv::Mat>                      m_imagePort;
+
+       /// Frame number.
+       CIOPort<int>                          m_frameNumberPort;
+
+       /// Predicted motion.
+       CIOPort<SRigidMotion>                 m_motionPort;
+
+       /// Rectified stereo camera.
+       CIOPort<CStereoCamera>                m_cameraPort;
        
     };
 }
@@ -55,7 +55,9 @@ CGTMapOp::CGTMapOp ( COperator * const f_parent_p,
      m_pitch_v (                                            ),
      m_yaw_v (                                              ),
     m_roll_v (                                             ),
-    m_maxPoses_i (                                    4096 )
+    m_maxPoses_i (                                    4096 ),
+    m_gtPolyline (               SRgba( 255, 255, 255 ), 1 ),
+    m_voTrail (                                       2, 2 )
 {
    registerDrawingList( "Poses Overlay",
                         S2D<int> (0, 0),
@@ -138,6 +140,9 @@ bool CGTMapOp::initialize()
 {
     m_idx_i = 0;
    m_voPoses_v.clear();
+   m_voTrail.clear();
+   m_voRangeX = S2D<float>(1.e20, -1.e20);
+   m_voRangeY = S2D<float>(1.e20, -1.e20);
    /// Load only if not already initialized.
    if ( m_poses_v.size() == 0 )
    {
@@ -211,9 +216,24 @@ bool CGTMapOp::cycle()
                 m_voPoses_v[i] = m_voPoses_v[i*2];
 
             m_voPoses_v.resize(newSize_i);
+
+            /// Dropped poses might have defined the range.
+            m_voRangeX = S2D<float>(1.e20, -1.e20);
+            m_voRangeY = S2D<float>(1.e20, -1.e20);
+            m_voTrail.clear();
+
+            for (size_t i = 0 ; i < newSize_i; ++i)
+            {
+                extendVORange ( m_voPoses_v[i] );
+                m_voTrail.addVertex ( m_voPoses_v[i][0], m_voPoses_v[i][1] );
+            }
         }
         else
-      m_voPoses_v.push_back( newPos );
+        {
+            m_voPoses_v.push_back( newPos );
+            extendVORange ( newPos );
+            m_voTrail.addVertex ( newPos[0], newPos[1] );
+        }
 
         //if (m_x_v.size() != m_maxPoses_i);
         {
@@ -281,31 +301,11 @@ bool CGTMapOp::show()
    {      
       if (!m_voPoses_v.empty())
       {
-         CColorEncoding colorEnc ( CColorEncoding::CET_HUE,S2D<float>(0,m_voPoses_v.size()));    
-         
-            S2D<float> newVisRangeX;
-            S2D<float> newVisRangeY;
-         newVisRangeX.min = 1.e20;
-         newVisRangeX.max = -1.e20;
-         newVisRangeY.min = 1.e20;
-         newVisRangeY.max = -1.e20;
-         
-         for (unsigned int i = 0; i < m_voPoses_v.size(); ++i)
-         {
-                S2D<float> pos = S2D<float> ( m_voPoses_v[i][0], 
-                                            m_voPoses_v[i][1] );
-            
-            newVisRangeX.min = std::min(newVisRangeX.min, m_voPoses_v[i][0]);
-            newVisRangeX.max = std::max(newVisRangeX.max, m_voPoses_v[i][0]);
-            newVisRangeY.min = std::min(newVisRangeY.min, m_voPoses_v[i][1]);
-            newVisRangeY.max = std::max(newVisRangeY.max, m_voPoses_v[i][1]);
-         }
-      
-            m_mapper.visRangeX.min = std::min(m_mapper.visRangeX.min, (double)newVisRangeX.min);
-            m_mapper.visRangeX.max = std::max(m_mapper.visRangeX.max, (double)newVisRangeX.max);
+            m_mapper.visRangeX.min = std::min(m_mapper.visRangeX.min, (double)m_voRangeX.min);
+            m_mapper.visRangeX.max = std::max(m_mapper.visRangeX.max, (double)m_voRangeX.max);
          
-            m_mapper.visRangeY.min = std::min(m_mapper.visRangeY.min, (double)newVisRangeY.min);
-            m_mapper.visRangeY.max = std::max(m_mapper.visRangeY.max, (double)newVisRangeY.max);
+            m_mapper.visRangeY.min = std::min(m_mapper.visRangeY.min, (double)m_voRangeY.min);
+            m_mapper.visRangeY.max = std::max(m_mapper.visRangeY.max, (double)m_voRangeY.max);
          
          m_mapper.visScale_d = 0.9 * std::min(getScreenSize().width /(m_mapper.visRangeX.max-m_mapper.visRangeX.min),
                                               getScreenSize().height/(m_mapper.visRangeY.max-m_mapper.visRangeY.min) );
@@ -322,17 +322,16 @@ bool CGTMapOp::show()
          list_p->addLine ( pos.x-20, pos.y-20, pos.x+20, pos.y+20 );
          list_p->addLine ( pos.x+20, pos.y-20, pos.x-20, pos.y+20 );
       
-         for (unsigned int i = 0; i < m_voPoses_v.size(); ++i)
-         {
-            SRgb color;
-            colorEnc.colorFromValue ( i, color);
-            list_p->setLineColor ( color );
-
-            S2D<double> pos = m_mapper.world2Screen ( S2D<double> ( m_voPoses_v[i][0], 
-                                                                    m_voPoses_v[i][1] ) );
-           
-            list_p->addSquare ( pos.x, pos.y, 2 );
-         }             
+         /// The squares are hue encoded by their index. Only the
+         /// mapping to screen is updated here.
+         m_voTrail.setTransformation (  m_mapper.visScale_d, 
+                                       -m_mapper.visScale_d,
+                                        m_mapper.visRangeX.min, 
+                                        m_mapper.visRangeY.max,
+                                        m_mapper.offset.x, 
+                                        m_mapper.offset.y );
+
+         list_p->addSquareTrail ( &m_voTrail );
          
          S2D<double> base = m_mapper.world2Screen ( S2D<double> ( m_voPoses_v.back()[0], 
                                                                   m_voPoses_v.back()[1] ) );
@@ -361,20 +360,16 @@ bool CGTMapOp::show()
       
       if (!m_poses_v.empty() )
       {
-         list_p->setLineWidth ( 1 );
-         list_p -> setLineColor ( SRgb( 255, 255, 255 ) );
-         
-         S2D<double> prevpos = m_mapper.world2Screen ( S2D<double> ( m_poses_v[0][0], 
-                                                                     m_poses_v[0][1] ) );
-         
-         for (unsigned int i = 1; i < m_poses_v.size(); ++i)
-         {
-            S2D<double> pos = m_mapper.world2Screen ( S2D<double> ( m_poses_v[i][0], 
-                                                                    m_poses_v[i][1] ) );
-            
-            list_p->addLine ( pos.x, pos.y, prevpos.x, prevpos.y );
-            prevpos=pos;
-         }
+         /// Only the mapping to screen can change, the vertices are
+         /// added when loading the poses.
+         m_gtPolyline.setTransformation (  m_mapper.visScale_d, 
+                                          -m_mapper.visScale_d,
+                                           m_mapper.visRangeX.min, 
+                                           m_mapper.visRangeY.max,
+                                           m_mapper.offset.x, 
+                                           m_mapper.offset.y );
+
+         list_p->addPolyline ( &m_gtPolyline );
       }
 
       std::vector<std::string> names_v;
@@ -418,6 +413,15 @@ bool CGTMapOp::show()
    return COperator::show();
 }
 
+void
+CGTMapOp::extendVORange ( const Data & f_pose )
+{
+   m_voRangeX.min = std::min(m_voRangeX.min, f_pose[0]);
+   m_voRangeX.max = std::max(m_voRangeX.max, f_pose[0]);
+   m_voRangeY.min = std::min(m_voRangeY.min, f_pose[1]);
+   m_voRangeY.max = std::max(m_voRangeY.max, f_pose[1]);
+}
+
 void 
 CGTMapOp::keyPressed ( CKeyEvent * f_event_p )
 {
@@ -458,6 +462,7 @@ CGTMapOp::loadFromFile ( )
    char *strData_p = (char *)malloc(strDataSize_i);
     
    m_poses_v.clear();
+   m_gtPolyline.clear();
     
    while (!feof(file_p))
    {
@@ -478,6 +483,7 @@ CGTMapOp::loadFromFile ( )
       if ( fieldsRead_i == 2 )
       {
          m_poses_v.push_back(data);
+         m_gtPolyline.addVertex ( data[0], data[1] );
             m_mapper.visRangeX.min = std::min(m_mapper.visRangeX.min,(double)data[0]);
             m_mapper.visRangeX.max = std::max(m_mapper.visRangeX.max,(double)data[0]);
             m_mapper.visRangeY.min = std::min(m_mapper.visRangeY.min,(double)data[1]);
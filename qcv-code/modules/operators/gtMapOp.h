@@ -38,6 +38,7 @@
 #include "3DPointVector.h"
 #include "rigidMotion.h"
 #include "pose2ScreenMapper.h"
+#include "polylineList.h"
 
 /* PROTOTYPES */
 
@@ -98,6 +99,9 @@ namespace QCV
         
         bool loadFromFile (  );
 
+        /// Extend the range of the visual odometry poses.
+        void extendVORange ( const Data & f_pose );
+
     /// Private Data Types
     private:
        
@@ -109,6 +113,21 @@ namespace QCV
         /// Visual odometry poses
         std::vector<Data>         m_voPoses_v;
 
+        /// Range in X of the visual odometry poses.
+        S2D<float>                m_voRangeX;
+
+        /// Range in Y of the visual odometry poses.
+        S2D<float>                m_voRangeY;
+
+        /// Ground truth trajectory. Vertices are added when the poses are
+        /// loaded, only the transformation to screen changes per frame.
+        CPolyline                 m_gtPolyline;
+
+        /// Visual odometry poses drawn as squares. Vertices are added
+        /// with the poses, the colors and the transformation to screen
+        /// are applied when drawing.
+        CSquareTrail              m_voTrail;
+
         /// Output String
         std::string               m_filePath_str;
 
@@ -32,6 +32,8 @@
  *******************************************************************************/
 
 /* INCLUDES */
+#include <QtGui/QMouseEvent>
+
 #include "houghTransformOp.h"
 #include "drawingList.h"
 #include "ceParameter.h"
@@ -230,8 +232,8 @@ bool CHoughTransformOp::cycle()
         cv::Size size = m_houghTransOp.getAccumulatorImage().size();
         if ( size != m_gradHX.size() )
         {
-            m_gradHX = cv::Mat(size, CV_32FC1);
-            m_gradHY = cv::Mat(size, CV_32FC1);
+            getPooledMat ( m_gradHX, size, CV_32FC1 );
+            getPooledMat ( m_gradHY, size, CV_32FC1 );
         }
         
         m_houghTransOp.clear();
@@ -245,10 +247,10 @@ bool CHoughTransformOp::cycle()
 
         if ( m_srcImg.size() != m_gradX.size() )
         {
-            m_gradX    = cv::Mat(m_srcImg.size(), CV_32FC1);
-            m_gradY    = cv::Mat(m_srcImg.size(), CV_32FC1);
-            m_binImg   = cv::Mat(m_srcImg.size(), CV_8UC1);
-            m_gradient = cv::Mat(m_srcImg.size(), CV_32FC1);
+            getPooledMat ( m_gradX,    m_srcImg.size(), CV_32FC1 );
+            getPooledMat ( m_gradY,    m_srcImg.size(), CV_32FC1 );
+            getPooledMat ( m_binImg,   m_srcImg.size(), CV_8UC1 );
+            getPooledMat ( m_gradient, m_srcImg.size(), CV_32FC1 );
         }
 
         stopClock ("Cycle: Reallocation and initialization");
@@ -283,6 +285,11 @@ bool CHoughTransformOp::cycle()
             tl.y = std::min(std::max(tl.y, 1), size.height-2 );            
             
             double th_d = m_gradThreshold_f * m_gradThreshold_f;
+
+            m_pointX_v.clear();
+            m_pointY_v.clear();
+            m_pointWeight_v.clear();
+            m_pointTheta_v.clear();
             
             for (int i = tl.y; i <= br.y; ++i)
             {
@@ -302,12 +309,12 @@ bool CHoughTransformOp::cycle()
                         double y = i-m_gradX.size().height/2.;
 
                         double weight_d = sqrt(magnitude_d)/m_magnitudeNorm_d;
+
+                        m_pointX_v.push_back ( x );
+                        m_pointY_v.push_back ( y );
+                        m_pointWeight_v.push_back ( weight_d );
                         
-                        if ( m_deltaTheta_d <= 0 )
-                            m_houghTransOp.addPoint ( x, 
-                                                      y, 
-                                                      weight_d );
-                        else
+                        if ( m_deltaTheta_d > 0 )
                         {
                             double theta = atan( gY_p[j] / gX_p[j] );
                             
@@ -317,16 +324,27 @@ bool CHoughTransformOp::cycle()
                             if (theta > M_PI)
                                 theta-=M_PI;
                         
-                            m_houghTransOp.addPoint ( x, 
-                                                      y, 
-                                                      weight_d,
-                                                      theta, 
-                                                      m_deltaTheta_d/180. * M_PI );
+                            m_pointTheta_v.push_back ( theta );
                         }
                     }
                 }
             }
 
+            startClock ("Cycle: Accumulation: Voting");
+
+            if ( m_deltaTheta_d <= 0 )
+                m_houghTransOp.addPoints ( m_pointX_v, 
+                                           m_pointY_v, 
+                                           m_pointWeight_v );
+            else
+                m_houghTransOp.addPoints ( m_pointX_v, 
+                                           m_pointY_v, 
+                                           m_pointWeight_v,
+                                           m_pointTheta_v,
+                                           m_deltaTheta_d/180. * M_PI );
+
+            stopClock ("Cycle: Accumulation: Voting");
+
             stopClock ("Cycle: Accumulation");
 
             startClock ("Cycle: Line Extraction");
@@ -705,15 +723,15 @@ bool CHoughTransformOp::initialize()
         return  COperator::initialize();
     }
 
-    m_gradX    = cv::Mat(m_srcImg.size(), CV_32FC1 ); 
-    m_gradY    = cv::Mat(m_srcImg.size(), CV_32FC1 ); 
-    m_binImg   = cv::Mat(m_srcImg.size(), CV_8UC1 );
-    m_gradient = cv::Mat(m_srcImg.size(), CV_32FC1 ); 
+    getPooledMat ( m_gradX,    m_srcImg.size(), CV_32FC1 );
+    getPooledMat ( m_gradY,    m_srcImg.size(), CV_32FC1 );
+    getPooledMat ( m_binImg,   m_srcImg.size(), CV_8UC1 );
+    getPooledMat ( m_gradient, m_srcImg.size(), CV_32FC1 );
     
     if ( m_houghTransOp.getAccumulatorImage().size() != m_gradHX.size() )
     {
-        m_gradHX = cv::Mat(m_houghTransOp.getAccumulatorImage().size(), CV_32FC1 );
-        m_gradHY = cv::Mat(m_houghTransOp.getAccumulatorImage().size(), CV_32FC1 );
+        getPooledMat ( m_gradHX, m_houghTransOp.getAccumulatorImage().size(), CV_32FC1 );
+        getPooledMat ( m_gradHY, m_houghTransOp.getAccumulatorImage().size(), CV_32FC1 );
     }
     
     return COperator::initialize();
@@ -890,7 +908,7 @@ CHoughTransformOp::getInput  (  )
     {
         if ( inpimg.type() == CV_8UC3 )
         {
-            m_srcImg      = cv::Mat(inpimg.size(), CV_32F);
+            getPooledMat ( m_srcImg, inpimg.size(), CV_32F );
             float *dst_p  = &m_srcImg.at<float>(0,0);
             const SRgb *s = &inpimg.at<SRgb>(0,0);            
             const SRgb *e = s + inpimg.size().width * inpimg.size().height;
@@ -899,7 +917,7 @@ CHoughTransformOp::getInput  (  )
         }
         else if ( inpimg.type() == CV_8U )
         {
-            m_srcImg       = cv::Mat(inpimg.size(), CV_32F);
+            getPooledMat ( m_srcImg, inpimg.size(), CV_32F );
             float *dst_p   = &m_srcImg.at<float>(0,0);
             const uint8_t *s  = &inpimg.at<uint8_t>(0,0);            
             const uint8_t *e  = s + inpimg.size().width * inpimg.size().height;
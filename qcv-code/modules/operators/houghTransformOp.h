@@ -214,6 +214,18 @@ namespace QCV
 
         /// ROI
         S2D<float>                 m_minHoughDistance;
+
+        /// Edge points of the current cycle.
+        std::vector<double>        m_pointX_v;
+
+        /// Edge points of the current cycle.
+        std::vector<double>        m_pointY_v;
+
+        /// Weights of the edge points.
+        std::vector<double>        m_pointWeight_v;
+
+        /// Gradient orientation of the edge points.
+        std::vector<double>        m_pointTheta_v;
      };
 }
 
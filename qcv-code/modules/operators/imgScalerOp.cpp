@@ -220,6 +220,7 @@ CImageScalerOp::resize()
                 m_scaledImgs_v[i] = m_img_v[i];
             else
             {
+                getPooledMat ( m_scaledImgs_v[i], size, m_img_v[i].type() );
                 cv::resize(m_img_v[i], m_scaledImgs_v[i], size, 0, 0, m_interpolMode_i);
             }
         }
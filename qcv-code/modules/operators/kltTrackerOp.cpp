@@ -32,6 +32,10 @@
 
 /* INCLUDES */
 #include <limits>
+#include <algorithm>
+
+#include <QtGui/QMouseEvent>
+#include <QtGui/QKeyEvent>
 
 #include "kltTrackerOp.h"
 #include "paramMacros.h"
@@ -46,6 +50,22 @@
 #endif
 using namespace QCV;
 
+/// Cell of a value in a grid dimension. Values outside the grid are 
+/// clamped to the border cells.
+static inline int
+cellIndex ( double f_val_d, float f_cellSize_f, int f_cells_i )
+{
+    const double cell_d = floor ( f_val_d / f_cellSize_f );
+
+    if ( !(cell_d > 0) )
+        return 0;
+
+    if ( cell_d > f_cells_i - 1 )
+        return f_cells_i - 1;
+
+    return (int) cell_d;
+}
+
 /// Constructors.
 CKltTrackerOp::CKltTrackerOp ( COperator * const f_parent_p,
                              const std::string f_name_str )
@@ -78,11 +98,21 @@ CKltTrackerOp::CKltTrackerOp ( COperator * const f_parent_p,
       m_detectGFTT_b (                          true ),
       m_harrisK_d (                             0.04 ),
       m_minHarrisResponse_d (                  0.001 ),
-      m_selectedIdx_i (                           -1 )
+      m_selectedIdx_i (                           -1 ),
+      m_imagePort (                                  ),
+      m_frameNumberPort (                            ),
+      m_motionPort (                                 ),
+      m_stereoCameraPort (                           ),
+      m_monoCameraPort (                             )
 
 {
     registerDrawingLists(  );
     registerParameters (  );
+
+    m_frameNumberPort.bind  ( this, "Frame Number" );
+    m_motionPort.bind       ( this, "Predicted Motion" );
+    m_stereoCameraPort.bind ( this, "Rectified Camera" );
+    m_monoCameraPort.bind   ( this, "Rectified Camera" );
 }
 
 void
@@ -316,6 +346,22 @@ CKltTrackerOp::~CKltTrackerOp ()
 {
 }
 
+/// I/O accessed by cycle().
+bool CKltTrackerOp::getCycleIO ( std::vector<std::string> & fr_inputs_v,
+                                 std::vector<std::string> & fr_outputs_v ) const
+{
+    fr_inputs_v.push_back ( m_inpImageId_str );
+    fr_inputs_v.push_back ( "Frame Number" );
+    fr_inputs_v.push_back ( "Predicted Motion" );
+    fr_inputs_v.push_back ( "Rectified Camera" );
+
+    fr_outputs_v.push_back ( "KltTrackerOp Previous Image" );
+    fr_outputs_v.push_back ( "KltTrackerOp Current Image" );
+    fr_outputs_v.push_back ( m_featPointVector_str );
+
+    return true;
+}
+
 /// Cycle event.
 bool CKltTrackerOp::cycle()
 {
@@ -325,11 +371,14 @@ bool CKltTrackerOp::cycle()
    cv::Mat img;
 
    if ( m_compute_b )
-      img = getInput<cv::Mat>(m_inpImageId_str, cv::Mat() ); 
+   {
+      m_imagePort.bind ( this, m_inpImageId_str );
+      img = m_imagePort.get ( cv::Mat() ); 
+   }
 
    if ( m_compute_b && img.cols > 0)
    {
-      size_t imgNr_u = getInput<int> ("Frame Number", 0 );     
+      size_t imgNr_u = m_frameNumberPort.get ( 0 );     
 
       if (m_preFilter_b)
       {
@@ -349,7 +398,8 @@ bool CKltTrackerOp::cycle()
 
       startClock ("Copy Feature Vector");
 
-      m_prevFeatureVector = m_featureVector;
+      m_prevFeatureVector.copyColumns ( m_featureVector );
+      m_featureVector.clearChanges();
 
       stopClock ("Copy Feature Vector");
 
@@ -359,43 +409,10 @@ bool CKltTrackerOp::cycle()
       if ( m_prevImg.cols > 0  )
       {
          startClock ("Collision Detection");            
-           
-         for (int i = 0; i < m_numFeatures_i; ++i)
-         {
-            if ( m_featureVector[i].state == SFeature::FS_TRACKED || 
-                 m_featureVector[i].state == SFeature::FS_NEW )
-            {
-               if (m_checkCollisions_b)
-               {
-                  int j;
-                  for (j = i+1; j < m_numFeatures_i; ++j)
-                  {
-                     if ( m_featureVector[j].state == SFeature::FS_TRACKED || 
-                          m_featureVector[j].state == SFeature::FS_NEW )
-                     {
-                        float diffx_f = m_featureVector[i].u - m_featureVector[j].u;
-                        float diffy_f = m_featureVector[i].v - m_featureVector[j].v;
-                        float sqDiff_f = diffx_f * diffx_f + diffy_f * diffy_f;
-                        
-                        if ( sqDiff_f <= m_maxSqDist4Collision_f )
-                        {
-			  m_featureVector[i].clear();
-                          
-                          const bool removeByAge_b = true;
-                          
-                          if ( (removeByAge_b && m_featureVector[i].t < m_featureVector[j].t) ||
-                               (!removeByAge_b && m_featureVector[i].e < m_featureVector[j].e ) )
-                             m_featureVector[i].clear();
-                          else
-                             m_featureVector[j].clear();
-
-                          break;
-                       }
-                     }
-                  }
-               }
-            }
-         }
+
+         if (m_checkCollisions_b)
+            checkCollisions();
+
          stopClock ("Collision Detection");
 
          startClock ("Build tracking list");
@@ -403,12 +420,12 @@ bool CKltTrackerOp::cycle()
          std::vector<cv::Point2f> featcurr_ocv;
          std::vector<size_t>      mapping_v;
 
-         SRigidMotion *   motion_p     = getInput<SRigidMotion>  ( "Predicted Motion" );
-         CStereoCamera *  stCamera_p   = getInput<CStereoCamera> ( "Rectified Camera" );
+         SRigidMotion *   motion_p     = m_motionPort.get();
+         CStereoCamera *  stCamera_p   = m_stereoCameraPort.get();
          CCamera *        monoCamera_p = NULL;
 
          if (!stCamera_p)
-            monoCamera_p = getInput<CCamera> ( "Rectified Camera" );
+            monoCamera_p = m_monoCameraPort.get();
 
          bool predict_b = m_usePrediction_b && (stCamera_p || monoCamera_p) && motion_p;
          
@@ -587,11 +604,8 @@ CKltTrackerOp::selectGoodFeatures()
    /// First pass: update occupancy mask.
     m_featureMask = cv::Mat(m_currImg.rows/downScale_i, m_currImg.cols/downScale_i, CV_8U, cv::Scalar(0));
 
-   for (int i = 0; i < m_featureVector.size(); ++i)
+   for (int i = m_featureVector.firstLive(); i < (signed)m_featureVector.size(); i = m_featureVector.nextLive(i))
    {
-      if ( m_featureVector[i].state == SFeature::FS_TRACKED || 
-           m_featureVector[i].state == SFeature::FS_NEW )
-        {
             int minDist_i;
             if  ( m_adaptiveDistance_b )
       {
@@ -620,7 +634,6 @@ CKltTrackerOp::selectGoodFeatures()
             for (int l = minL; l<=maxL; ++l, ++ptr)
                *ptr = 255;
          }
-      }
    }
 
    stopClock ("Select Good Features - Occupancy Mask Update");
@@ -632,6 +645,7 @@ CKltTrackerOp::selectGoodFeatures()
     }
     else
         currImg = m_currImg;
+    stopClock ("Select Good Features - Scale Image");
         
    startClock ("Select Good Features - Build corner reponse image");
 
@@ -653,8 +667,7 @@ CKltTrackerOp::selectGoodFeatures()
       
    stopClock ("Select Good Features - Build corner reponse image");
 
-   startClock ("Select Good Features - Sort Eigenvalues");
-   /// Order eigenvalues now.
+   startClock ("Select Good Features - Collect Eigenvalues");
    m_eigenvalueVector.clear();
 
    float threshold_f = m_detectGFTT_b?m_minEigenvalue_f:m_minHarrisResponse_d;
@@ -673,17 +686,23 @@ CKltTrackerOp::selectGoodFeatures()
          }
       }            
    }
-        
-   sort (m_eigenvalueVector.begin(), m_eigenvalueVector.end());
 
-   stopClock ("Select Good Features - Sort Eigenvalues");
-
-   startClock ("Select Good Features - New Feature Selection");
+   stopClock ("Select Good Features - Collect Eigenvalues");
 
    if (m_featureVector.size() != m_numFeatures_i)
       m_featureVector.resize(m_numFeatures_i);   
 
-   const size_t imgNr_u = getInput<int> ("Frame Number", 0 );     
+   /// Number of vector spaces to fill with new features.
+   int emptySlots_i = m_numFeatures_i - m_featureVector.getLiveCount();
+
+   startClock ("Select Good Features - Partial Sort");
+   /// Eigenvalues from sorted_u to the end of the vector are sorted.
+   size_t sorted_u = sortStrongestEigenvalues ( emptySlots_i );
+   stopClock ("Select Good Features - Partial Sort");
+
+   startClock ("Select Good Features - New Feature Selection");
+
+   const size_t imgNr_u = m_frameNumberPort.get ( 0 );     
 
    /// Second pass: fill empty vector spaces with new features.
    std::vector<cv::Point2f> addedPts_v;
@@ -704,6 +723,9 @@ CKltTrackerOp::selectGoodFeatures()
                 
          while (m_eigenvalueVector.size() > 0)
          {
+            if ( m_eigenvalueVector.size() == sorted_u )
+               sorted_u = sortStrongestEigenvalues ( emptySlots_i );
+
             eigenvalue = m_eigenvalueVector.back();
             mask_i = m_featureMask.at<uint8_t>(eigenvalue.y,eigenvalue.x);
             m_eigenvalueVector.pop_back();
@@ -748,6 +770,7 @@ CKltTrackerOp::selectGoodFeatures()
 
                 addedPts_v.push_back(cv::Point2f(m_featureVector[i].u, m_featureVector[i].v));
             addedIdx_v.push_back (i);
+            --emptySlots_i;
          }
          else
          {
@@ -791,6 +814,144 @@ CKltTrackerOp::selectGoodFeatures()
    stopClock ("Select Good Features - New Feature Selection");
 }    
 
+/// Sort the strongest eigenvalues (at least the double of the given
+/// number) in increasing order at the end of the vector and return the
+/// index of the first sorted one. The rest of the vector is left 
+/// unsorted.
+size_t
+CKltTrackerOp::sortStrongestEigenvalues ( int f_count_i )
+{
+   const size_t size_u  = m_eigenvalueVector.size();
+
+   /// Candidates are also rejected by the min distance constraint, 
+   /// therefore more than the requested number are sorted.
+   const size_t count_u = std::min ( size_u, std::max ( (size_t) 256, 2 * (size_t) std::max ( f_count_i, 0 ) ) );
+
+   std::vector<SEigenvalue>::iterator first = m_eigenvalueVector.end() - count_u;
+   
+   std::nth_element ( m_eigenvalueVector.begin(), first, m_eigenvalueVector.end() );
+   std::sort ( first, m_eigenvalueVector.end() );
+
+   return size_u - count_u;
+}
+
+/// Remove colliding features. For every active feature i, the first
+/// active feature j > i closer than the collision distance is searched
+/// in the cells of the grid around it. 
+void
+CKltTrackerOp::checkCollisions()
+{
+   /// No pair of features can collide.
+   if ( !(m_maxSqDist4Collision_f >= 0) )
+      return;
+
+   const int numFeatures_i = std::min ( m_numFeatures_i, (int) m_featureVector.size() );
+
+   startClock ("Collision Detection - Build Grid");
+   buildFeatureGrid ( );
+   stopClock ("Collision Detection - Build Grid");
+
+   /// Conservative window: the squared distance is computed in float.
+   const double halfSize_d = sqrt ( (double) m_maxSqDist4Collision_f ) + 1.;
+   
+   for (int i = 0; i < numFeatures_i; ++i)
+   {
+      if ( m_featureVector[i].state != SFeature::FS_TRACKED && 
+           m_featureVector[i].state != SFeature::FS_NEW )
+         continue;
+
+      const int cx1_i = cellIndex ( m_featureVector[i].u - halfSize_d, m_grid.cellSize_f, m_grid.cols_i );
+      const int cx2_i = cellIndex ( m_featureVector[i].u + halfSize_d, m_grid.cellSize_f, m_grid.cols_i );
+      const int cy1_i = cellIndex ( m_featureVector[i].v - halfSize_d, m_grid.cellSize_f, m_grid.rows_i );
+      const int cy2_i = cellIndex ( m_featureVector[i].v + halfSize_d, m_grid.cellSize_f, m_grid.rows_i );
+
+      int j = numFeatures_i;
+      
+      for (int cy = cy1_i; cy <= cy2_i; ++cy)
+      {
+         for (int cx = cx1_i; cx <= cx2_i; ++cx)
+         {
+            const int c_i = cy * m_grid.cols_i + cx;
+
+            std::vector<int>::const_iterator it  = std::upper_bound ( m_grid.idx_v.begin() + m_grid.cellStart_v[c_i],
+                                                                      m_grid.idx_v.begin() + m_grid.cellStart_v[c_i+1], 
+                                                                      i );
+            std::vector<int>::const_iterator end = m_grid.idx_v.begin() + m_grid.cellStart_v[c_i+1];
+            
+            for (; it != end && *it < j; ++it)
+            {
+               const SFeature &feat = m_featureVector[*it];
+
+               if ( feat.state == SFeature::FS_TRACKED || 
+                    feat.state == SFeature::FS_NEW )
+               {
+                  float diffx_f = m_featureVector[i].u - feat.u;
+                  float diffy_f = m_featureVector[i].v - feat.v;
+                  float sqDiff_f = diffx_f * diffx_f + diffy_f * diffy_f;
+                  
+                  if ( sqDiff_f <= m_maxSqDist4Collision_f )
+                  {
+                     j = *it;
+                     break;
+                  }
+               }
+            }
+         }
+      }
+
+      if ( j < numFeatures_i )
+      {
+         m_featureVector[i].clear();
+         
+         const bool removeByAge_b = true;
+         
+         if ( (removeByAge_b && m_featureVector[i].t < m_featureVector[j].t) ||
+              (!removeByAge_b && m_featureVector[i].e < m_featureVector[j].e ) )
+            m_featureVector[i].clear();
+         else
+            m_featureVector[j].clear();
+      }
+   }
+}
+
+/// Build the grid over the active features of the vector.
+void
+CKltTrackerOp::buildFeatureGrid ( )
+{
+   const int numFeatures_i = std::min ( m_numFeatures_i, (int) m_featureVector.size() );
+
+   /// Do not create more than 256 cells per dimension.
+   m_grid.cellSize_f = std::max ( (float) sqrt ( m_maxSqDist4Collision_f ), 
+                                  std::max ( 4.f, std::max ( m_currImg.cols, m_currImg.rows ) / 256.f ) );
+   m_grid.cols_i     = (int)(m_currImg.cols / m_grid.cellSize_f) + 1;
+   m_grid.rows_i     = (int)(m_currImg.rows / m_grid.cellSize_f) + 1;
+
+   const int cells_i = m_grid.cols_i * m_grid.rows_i;
+
+   std::vector<int> cellIdx_v ( numFeatures_i, -1 );
+
+   m_grid.cellStart_v.assign ( cells_i + 1, 0 );
+   
+   /// Counting sort by cell keeping the feature order in each cell.
+   for (int i = m_featureVector.firstLive(); i < numFeatures_i; i = m_featureVector.nextLive(i))
+   {
+      cellIdx_v[i] = ( cellIndex ( m_featureVector[i].v, m_grid.cellSize_f, m_grid.rows_i ) * m_grid.cols_i + 
+                       cellIndex ( m_featureVector[i].u, m_grid.cellSize_f, m_grid.cols_i ) );
+      ++m_grid.cellStart_v[cellIdx_v[i]+1];
+   }
+
+   for (int c = 0; c < cells_i; ++c)
+      m_grid.cellStart_v[c+1] += m_grid.cellStart_v[c];
+
+   m_grid.idx_v.resize ( m_grid.cellStart_v[cells_i] );
+
+   std::vector<int> pos_v ( m_grid.cellStart_v.begin(), m_grid.cellStart_v.end() - 1 );
+
+   for (int i = 0; i < numFeatures_i; ++i)
+      if ( cellIdx_v[i] >= 0 )
+         m_grid.idx_v[pos_v[cellIdx_v[i]]++] = i;
+}
+
 
 /// Show event.
 bool CKltTrackerOp::show()
@@ -56,6 +56,10 @@
 
 namespace QCV
 {
+    class CCamera;
+    class CStereoCamera;
+    class SRigidMotion;
+
     class CKltTrackerOp: public COperator
     {
     public:       
@@ -87,6 +91,10 @@ namespace QCV
         /// Exit event.
         virtual bool exit();
 
+        /// I/O accessed by cycle().
+        virtual bool getCycleIO ( std::vector<std::string> & fr_inputs_v,
+                                  std::vector<std::string> & fr_outputs_v ) const;
+
         /// Mouse moved.
         virtual void mouseMoved (  CMouseEvent * f_event_p );
 
@@ -147,6 +155,12 @@ namespace QCV
         void registerParameters(  );
 
         void selectGoodFeatures();
+
+        size_t sortStrongestEigenvalues ( int f_count_i );
+
+        void checkCollisions();
+
+        void buildFeatureGrid();
        
     /// Protected data types
     protected:
@@ -187,6 +201,18 @@ namespace QCV
 
         };
 
+        /// Uniform grid over the active features. The features of cell c
+        /// are idx_v[cellStart_v[c]] to idx_v[cellStart_v[c+1]-1] in 
+        /// increasing order.
+        struct SFeatureGrid
+        {
+            float                                    cellSize_f;
+            int                                      cols_i;
+            int                                      rows_i;
+            std::vector<int>                         cellStart_v;
+            std::vector<int>                         idx_v;
+        };
+
     private:
         
         /// Input image Id.
@@ -276,6 +302,9 @@ namespace QCV
         /// Vector of selected eigenvalues.
         std::vector< SEigenvalue >           m_eigenvalueVector;
 
+        /// Grid for the collision check.
+        SFeatureGrid                         m_grid;
+
        /// Search good fatures to track (thresholding min eigenvalue) or harris detector
        bool                                  m_detectGFTT_b;
 
@@ -287,6 +316,21 @@ namespace QCV
 
        /// For display purposes
        int                                   m_selectedIdx_i;
+
+       /// Input image.
+       CIOPort<cv::Mat>                      m_imagePort;
+
+       /// Frame number.
+       CIOPort<int>                          m_frameNumberPort;
+
+       /// Predicted motion.
+       CIOPort<SRigidMotion>                 m_motionPort;
+
+       /// Rectified stereo camera.
+       CIOPort<CStereoCamera>                m_stereoCameraPort;
+
+       /// Rectified mono camera.
+       CIOPort<CCamera>                      m_monoCameraPort;
     };
 }
 #endif // __KLTTRACKER_H
@@ -40,6 +40,18 @@
 #include "linearHoughTransform.h"
  
 #include <math.h>
+#include <stdio.h>
+#include <algorithm>
+
+#if defined ( _OPENMP )
+#include <omp.h>
+#endif
+
+#if defined ( __AVX2__ )
+#include <immintrin.h>
+#elif defined ( __SSE2__ )
+#include <emmintrin.h>
+#endif
 
 #define NORMALIZE_ANGLE(d) (d)+((d)<0?(((int)(1-(d)/(M_PI)))*(M_PI)):(d)>M_PI?-(((int)((d)/(M_PI)))*(M_PI)):0)
 
@@ -316,6 +328,7 @@ CLinearHoughTransform::allocateAccumulator()
 
     m_cosLUV.resize(m_accumImg.size().width);
     m_sinLUV.resize(m_accumImg.size().width);
+    m_rows_v.resize(m_accumImg.size().width+1);
 
     for (int j = 0; j < m_accumImg.size().width; ++j)
     {
@@ -393,73 +406,163 @@ CLinearHoughTransform::addPoint ( double f_x_d,
                                   double f_y_d,
                                   double f_weight_d )
 {
-    cv::Size size = m_accumImg.size();
+    const int width_i = m_accumImg.size().width;
+
+    vote ( f_x_d, f_y_d, f_weight_d, 
+           0, width_i-1, 
+           0, width_i-1, 
+           &m_rows_v[0] );
+    
+    return true;
+}
 
-    S2D<float> p1, p2;
-    for (int j = 0; j < size.width; ++j)
+bool
+CLinearHoughTransform::addPoint ( double f_x_d, 
+                                  double f_y_d,
+                                  double f_weight_d,
+                                  double f_expTheta_d,
+                                  double f_deltaTheta_d )
+{
+    const int width_i = m_accumImg.size().width;
+
+    int minJ[2];
+    int maxJ[2];
+    int cycles_i = getThetaColumns ( f_expTheta_d, f_deltaTheta_d, minJ, maxJ );
+
+    for (int l = 0; l < cycles_i; ++l)
+        vote ( f_x_d, f_y_d, f_weight_d, 
+               minJ[l], maxJ[l], 
+               0, width_i-1, 
+               &m_rows_v[0] );
+    
+    return true;
+}
+
+bool
+CLinearHoughTransform::addPoints ( const std::vector<double> & f_x_v, 
+                                   const std::vector<double> & f_y_v,
+                                   const std::vector<double> & f_weight_v )
+{
+    if ( f_x_v.size() != f_y_v.size() || 
+         f_x_v.size() != f_weight_v.size() )
     {
-        float value_f = f_weight_d;
+        printf("%s:%i Point vectors have different sizes\n", __FILE__, __LINE__ );
+        return false;
+    }
 
-        double range_d = f_x_d * m_cosLUV[j] + f_y_d * m_sinLUV[j];
+    const int width_i = m_accumImg.size().width;
+    const int tiles_i = getTileCount();
+    const int size_i  = f_x_v.size();
 
-        float i_f = (range_d - m_range.min) / m_scale.y;
-        p1 = S2D<float>(j, i_f);
+    /// Every tile owns a range of columns of the accumulator. Each cell
+    /// receives its votes in the same order than with addPoint().
+#if defined ( _OPENMP )
+#pragma omp parallel for num_threads(tiles_i) schedule(static,1)
+#endif
+    for (int t = 0; t < tiles_i; ++t)
+    {
+        const int firstCol_i = ( t    * width_i) / tiles_i;
+        const int lastCol_i  = ((t+1) * width_i) / tiles_i - 1;
 
-        //printf("p1.x = %f p1.y = %f (p2.x = %f p2.y = %f) i_f = %f range_d = %f m_range.min = %f, m_scale.y = %f\n",
-        //       p1.x, p1.y, p2.x, p2.y, i_f, range_d, m_range.min, m_scale.y );
+        std::vector<float> rows_v ( width_i + 1 );
 
-        if (j != 0 && i_f >= 0 && i_f < size.height )
-        {   
-            int dist_i = (int)fabs(p1.y-p2.y)+1;
-            S2D<float> d ((p2.x-p1.x)/dist_i, 
-                          (p2.y-p1.y)/dist_i);
+        for (int p = 0; p < size_i; ++p)
+            vote ( f_x_v[p], f_y_v[p], f_weight_v[p], 
+                   0, width_i-1, 
+                   firstCol_i, lastCol_i, 
+                   &rows_v[0] );
+    }
 
-            for (int i = 0; i < dist_i; ++i)
-            {                
-                float pointx = p1.x + (i) * d.x;
-                float pointy = p1.y + (i) * d.y;
-                
-                int intPx = (int)(pointx);
-                int intPy = (int)(pointy);
-                
-                float f1  = (pointx-(int)intPx);
-                float f2  = (pointy-(int)intPy);
+    return true;
+}
 
-                float w11 = (1.-f1) * (1.-f2);
-                float w12 = (f1) * (1.-f2);
-                float w21 = (1.-f1) * (f2);
-                float w22 = (f1) * (f2);                
+bool
+CLinearHoughTransform::addPoints ( const std::vector<double> & f_x_v, 
+                                   const std::vector<double> & f_y_v,
+                                   const std::vector<double> & f_weight_v,
+                                   const std::vector<double> & f_expTheta_v,
+                                   double                      f_deltaTheta_d )
+{
+    if ( f_x_v.size() != f_y_v.size() || 
+         f_x_v.size() != f_weight_v.size() ||
+         f_x_v.size() != f_expTheta_v.size() )
+    {
+        printf("%s:%i Point vectors have different sizes\n", __FILE__, __LINE__ );
+        return false;
+    }
 
-              if ( intPy < (int) size.height-1 && intPy >= 0 && 
-                   intPx < (int) size.width-1 && intPx >= 0 )
-                {
-                    if (i == 0)
-                    {
-                        m_accumImg.at<float>(intPy,intPx  ) += value_f * w11;
-                        m_accumImg.at<float>(intPy,intPx+1) += value_f * w12;
-                    }
-                    m_accumImg.at<float>(intPy+1, intPx  ) += value_f * w21;
-                    m_accumImg.at<float>(intPy+1, intPx+1) += value_f * w22;
-                }
-            }
+    const int width_i = m_accumImg.size().width;
+    const int tiles_i = getTileCount();
+    const int size_i  = f_x_v.size();
+
+    /// Column intervals of every point: min and max of the first 
+    /// interval followed by min and max of the second one.
+    std::vector<int> cycles_v  ( size_i );
+    std::vector<int> columns_v ( 4 * size_i );
+
+#if defined ( _OPENMP )
+#pragma omp parallel for num_threads(tiles_i) schedule(static)
+#endif
+    for (int p = 0; p < size_i; ++p)
+    {
+        int minJ[2];
+        int maxJ[2];
+        
+        cycles_v[p] = getThetaColumns ( f_expTheta_v[p], f_deltaTheta_d, minJ, maxJ );
+
+        columns_v[4*p  ] = minJ[0];
+        columns_v[4*p+1] = maxJ[0];
+        columns_v[4*p+2] = minJ[1];
+        columns_v[4*p+3] = maxJ[1];
+    }
+
+#if defined ( _OPENMP )
+#pragma omp parallel for num_threads(tiles_i) schedule(static,1)
+#endif
+    for (int t = 0; t < tiles_i; ++t)
+    {
+        const int firstCol_i = ( t    * width_i) / tiles_i;
+        const int lastCol_i  = ((t+1) * width_i) / tiles_i - 1;
+
+        std::vector<float> rows_v ( width_i + 1 );
+
+        for (int p = 0; p < size_i; ++p)
+        {
+            for (int l = 0; l < cycles_v[p]; ++l)
+                vote ( f_x_v[p], f_y_v[p], f_weight_v[p], 
+                       columns_v[4*p+2*l], columns_v[4*p+2*l+1], 
+                       firstCol_i, lastCol_i, 
+                       &rows_v[0] );
         }
-        p2=p1;
     }
-    
+
     return true;
 }
 
-bool
-CLinearHoughTransform::addPoint ( double f_x_d, 
-                                  double f_y_d,
-                                  double f_weight_d,
-                                  double f_expTheta_d,
-                                  double f_deltaTheta_d )
+/// Number of column tiles for addPoints().
+int
+CLinearHoughTransform::getTileCount ( ) const
 {
-    cv::Size size = m_accumImg.size();
+#if defined ( _OPENMP )
+    /// Tiles of less than 16 columns do not pay off.
+    return std::max(1, std::min( omp_get_max_threads(), 
+                                 m_accumImg.size().width / 16 ) );
+#else
+    return 1;
+#endif
+}
 
-    S2D<float> p1, p2;
+int
+CLinearHoughTransform::getThetaColumns ( double f_expTheta_d,
+                                         double f_deltaTheta_d,
+                                         int    fr_minJ_p[2],
+                                         int    fr_maxJ_p[2] ) const
+{
+    cv::Size size = m_accumImg.size();
 
+    int * minJ = fr_minJ_p;
+    int * maxJ = fr_maxJ_p;
+    
     //f_expTheta_d = NORMALIZE_ANGLE( f_expTheta_d );
 
     /// Determine the limits of the image to update. Determine also
@@ -468,26 +571,21 @@ CLinearHoughTransform::addPoint ( double f_x_d,
     double t1_d = f_expTheta_d - f_deltaTheta_d;
     double t2_d = f_expTheta_d + f_deltaTheta_d;
 
-    //printf("x: %f y: %f f_expTheta_d = %f t1_d = %f t2_d = %f (violation t1: %i t2: %i)\n",
-    //       f_x_d, f_y_d, f_expTheta_d, t1_d, t2_d, (int)(m_theta.min > t1_d), (int)(m_theta.max < t2_d) );    
-
-    int minJ[2];
-    int maxJ[2];
     int cycles_i = 1;
+
+    /// Empty second interval.
+    minJ[1] =  0;
+    maxJ[1] = -1;
     
     minJ[0] = (std::max(t1_d, m_theta.min) - m_theta.min) / m_scale.x;
     maxJ[0] = (std::min(t2_d, m_theta.max) - m_theta.min) / m_scale.x + .5;
     
-    //printf("\tminJ[0] = %i maxJ[0] = %i\n", minJ[0], maxJ[0] );    
-
     if ( (m_theta.min > t1_d && m_theta.max >= t2_d) ||
          (m_theta.min <= t1_d && m_theta.max < t2_d) )
     {
         double nt1_d = NORMALIZE_ANGLE(t1_d);
         double nt2_d = NORMALIZE_ANGLE(t2_d);
         
-        //printf("\tnt1_d = %f nt2_d = %f\n", nt1_d, nt2_d );
-        
         if ( m_theta.min >  t1_d  &&
              m_theta.max >= t2_d  &&
              m_theta.max >= nt1_d &&
@@ -498,8 +596,6 @@ CLinearHoughTransform::addPoint ( double f_x_d,
             if (minJ[1] < 0 )
                 minJ[1] = 0;
             maxJ[1] = size.width-1;
-
-            //printf("\tcase 1 minJ[1] = %i maxJ[1] = %i\n", minJ[1], maxJ[1] );    
         }
         else if ( m_theta.min <= t1_d  &&
                   m_theta.max <  t2_d  &&
@@ -512,10 +608,8 @@ CLinearHoughTransform::addPoint ( double f_x_d,
             
             if (maxJ[1] >= (signed) size.width )
                 maxJ[1] = size.width-1;
-            //printf("\tcase 2 minJ[1] = %i maxJ[1] = %i\n", minJ[1], maxJ[1] );    
         }
     }
-    
 
     if (minJ[0] < 0 )
         minJ[0] = 0;
@@ -523,71 +617,145 @@ CLinearHoughTransform::addPoint ( double f_x_d,
     if (maxJ[0] >= (signed) size.width )
         maxJ[0] = size.width-1;
 
-    //printf("\tminJ[0] %i maxJ[0] %i diff = %i\n", minJ[0], maxJ[0], maxJ[0]-minJ[0]  );
+    return cycles_i;
+}
 
-    
-    
-    for (int l = 0; l < cycles_i; ++l)
+void
+CLinearHoughTransform::computeRows ( double  f_x_d,
+                                     double  f_y_d,
+                                     int     f_firstJ_i,
+                                     int     f_lastJ_i,
+                                     float * fr_rows_p ) const
+{
+    const double * cos_p = &m_cosLUV[0];
+    const double * sin_p = &m_sinLUV[0];
+    float *        row_p = fr_rows_p - f_firstJ_i;
+
+    int j = f_firstJ_i;
+
+    /// The range is computed in double precision as in the scalar 
+    /// version so that the rows are exactly the same.
+#if defined ( __AVX2__ )
     {
-        for (int j = minJ[l]; j <= maxJ[l]; ++j)
+        const __m256d x_v     = _mm256_set1_pd ( f_x_d );
+        const __m256d y_v     = _mm256_set1_pd ( f_y_d );
+        const __m256d min_v   = _mm256_set1_pd ( m_range.min );
+        const __m256d scale_v = _mm256_set1_pd ( m_scale.y );
+
+        for (; j + 3 <= f_lastJ_i; j += 4)
         {
-            //printf("l= %i j=%i\n",
-            //       l, j);
-            double range_d = f_x_d * m_cosLUV[j] + f_y_d * m_sinLUV[j];
+            __m256d range_v = _mm256_add_pd ( _mm256_mul_pd ( x_v, _mm256_loadu_pd ( cos_p + j ) ),
+                                              _mm256_mul_pd ( y_v, _mm256_loadu_pd ( sin_p + j ) ) );
             
-            float i_f = (range_d - m_range.min) / m_scale.y;
-            p1 = S2D<float>(j, i_f);
-
-            if (j != minJ[l] && i_f >= 0 && i_f < size.height )
-            {   
-                int dist_i = (int)fabs(p1.y-p2.y)+1;
-                S2D<float> d ((p2.x-p1.x)/dist_i, 
-                              (p2.y-p1.y)/dist_i);
+            _mm_storeu_ps ( row_p + j, 
+                            _mm256_cvtpd_ps ( _mm256_div_pd ( _mm256_sub_pd ( range_v, min_v ), 
+                                                              scale_v ) ) );
+        }
+    }
+#endif
+#if defined ( __SSE2__ )
+    {
+        const __m128d x_v     = _mm_set1_pd ( f_x_d );
+        const __m128d y_v     = _mm_set1_pd ( f_y_d );
+        const __m128d min_v   = _mm_set1_pd ( m_range.min );
+        const __m128d scale_v = _mm_set1_pd ( m_scale.y );
 
+        for (; j + 1 <= f_lastJ_i; j += 2)
+        {
+            __m128d range_v = _mm_add_pd ( _mm_mul_pd ( x_v, _mm_loadu_pd ( cos_p + j ) ),
+                                           _mm_mul_pd ( y_v, _mm_loadu_pd ( sin_p + j ) ) );
+            
+            _mm_storel_pi ( (__m64 *) (row_p + j), 
+                            _mm_cvtpd_ps ( _mm_div_pd ( _mm_sub_pd ( range_v, min_v ), 
+                                                        scale_v ) ) );
+        }
+    }
+#endif
 
-                float value_f = f_weight_d;
+    for (; j <= f_lastJ_i; ++j)
+    {
+        double range_d = f_x_d * cos_p[j] + f_y_d * sin_p[j];
         
-                for (int i = 0; i < dist_i; ++i)
-                {
-                    float pointx = p1.x + (i) * d.x;
-                    float pointy = p1.y + (i) * d.y;
+        row_p[j] = (range_d - m_range.min) / m_scale.y;
+    }
+}
+
+void
+CLinearHoughTransform::vote ( double  f_x_d,
+                              double  f_y_d,
+                              float   f_value_f,
+                              int     f_minJ_i,
+                              int     f_maxJ_i,
+                              int     f_firstCol_i,
+                              int     f_lastCol_i,
+                              float * fr_rows_p )
+{
+    cv::Size size = m_accumImg.size();
+
+    /// Column j splats into the columns j-1 to j+1. The first column 
+    /// of the interval only provides the start of the first segment.
+    const int j1_i = std::max ( f_minJ_i + 1, f_firstCol_i - 1 );
+    const int j2_i = std::min ( f_maxJ_i,     f_lastCol_i  + 1 );
+
+    if ( j1_i > j2_i )
+        return;
 
-                    int intPx = (int)(pointx);
-                    int intPy = (int)(pointy);
+    computeRows ( f_x_d, f_y_d, j1_i - 1, j2_i, fr_rows_p );
 
-                    float f1  = (pointx-(int)intPx);
-                    float f2  = (pointy-(int)intPy);
+    const float * rows_p = fr_rows_p - (j1_i - 1);
+
+    float value_f = f_value_f;
+
+    for (int j = j1_i; j <= j2_i; ++j)
+    {
+        float i_f = rows_p[j];
+
+        if ( i_f >= 0 && i_f < size.height )
+        {   
+            S2D<float> p1 ( j,   i_f );
+            S2D<float> p2 ( j-1, rows_p[j-1] );
 
-                    float w11 = (1.-f1) * (1.-f2);
-                    float w12 = (f1) * (1.-f2);
-                    float w21 = (1.-f1) * (f2);
-                    float w22 = (f1) * (f2);
+            int dist_i = (int)fabs(p1.y-p2.y)+1;
+            S2D<float> d ((p2.x-p1.x)/dist_i, 
+                          (p2.y-p1.y)/dist_i);
+
+            for (int i = 0; i < dist_i; ++i)
+            {                
+                float pointx = p1.x + (i) * d.x;
+                float pointy = p1.y + (i) * d.y;
                 
-                    if ( intPy < (int) size.height-1 && intPy >= 0 && 
-                         intPx < (int) size.width-1  && intPx >= 0 )
+                int intPx = (int)(pointx);
+                int intPy = (int)(pointy);
+                
+                float f1  = (pointx-(int)intPx);
+                float f2  = (pointy-(int)intPy);
+
+                float w11 = (1.-f1) * (1.-f2);
+                float w12 = (f1) * (1.-f2);
+                float w21 = (1.-f1) * (f2);
+                float w22 = (f1) * (f2);                
+
+                if ( intPy < (int) size.height-1 && intPy >= 0 && 
+                     intPx < (int) size.width-1 && intPx >= 0 )
+                {
+                    float * row0_p = m_accumImg.ptr<float>(intPy);
+                    float * row1_p = m_accumImg.ptr<float>(intPy+1);
+
+                    const bool left_b  = intPx   >= f_firstCol_i && intPx   <= f_lastCol_i;
+                    const bool right_b = intPx+1 >= f_firstCol_i && intPx+1 <= f_lastCol_i;
+
+                    if (i == 0)
                     {
-                        if (i == 0)
-                        {
-                            //printf("settting (%i, %i) and (%i, %i)\n",
-                            //       intPy, intPx, intPy, intPx+1 );
-                            
-                            m_accumImg.at<float>(intPy,  intPx  ) += value_f * w11;
-                            m_accumImg.at<float>(intPy,  intPx+1) += value_f * w12;
-                        }
-                        //printf("settting (%i, %i) and (%i, %i)\n",
-                        //           intPy+1, intPx, intPy+1, intPx+1 );
-
-                        m_accumImg.at<float>(intPy+1,  intPx  ) += value_f * w21;
-                        m_accumImg.at<float>(intPy+1,  intPx+1) += value_f * w22;
+                        if ( left_b )  row0_p[intPx  ] += value_f * w11;
+                        if ( right_b ) row0_p[intPx+1] += value_f * w12;
                     }
+
+                    if ( left_b )  row1_p[intPx  ] += value_f * w21;
+                    if ( right_b ) row1_p[intPx+1] += value_f * w22;
                 }
-            
             }
-            p2=p1;
         }
     }
-    
-    return true;
 }
 
 CParameterSet *   
@@ -85,6 +85,20 @@ namespace QCV
                            double f_expTheta_d,
                            double f_deltaTheta_d );
 
+        /// Add a batch of points. The accumulator is split in column
+        /// tiles that are updated in parallel.
+        bool    addPoints ( const std::vector<double> & f_x_v, 
+                            const std::vector<double> & f_y_v,
+                            const std::vector<double> & f_weight_v );
+
+        /// Add a batch of points voting only around the expected
+        /// orientation of each of them.
+        bool    addPoints ( const std::vector<double> & f_x_v, 
+                            const std::vector<double> & f_y_v,
+                            const std::vector<double> & f_weight_v,
+                            const std::vector<double> & f_expTheta_v,
+                            double                      f_deltaTheta_d );
+
         bool    compute ( );
 
     /// Coordinate transformations.
@@ -163,6 +177,34 @@ namespace QCV
 
         /// Allocate acumulator
         void    allocateAccumulator();
+
+        /// Number of column tiles for addPoints().
+        int     getTileCount ( ) const;
+
+        /// Column intervals to vote for an orientation interval. Returns
+        /// the number of intervals (1 or 2).
+        int     getThetaColumns ( double f_expTheta_d,
+                                  double f_deltaTheta_d,
+                                  int    fr_minJ_p[2],
+                                  int    fr_maxJ_p[2] ) const;
+
+        /// Accumulator rows of a point for the given columns.
+        void    computeRows ( double  f_x_d,
+                              double  f_y_d,
+                              int     f_firstJ_i,
+                              int     f_lastJ_i,
+                              float * fr_rows_p ) const;
+
+        /// Vote for a point from column f_minJ_i to f_maxJ_i writing only
+        /// into accumulator columns f_firstCol_i to f_lastCol_i.
+        void    vote ( double  f_x_d,
+                       double  f_y_d,
+                       float   f_value_f,
+                       int     f_minJ_i,
+                       int     f_maxJ_i,
+                       int     f_firstCol_i,
+                       int     f_lastCol_i,
+                       float * fr_rows_p );
         
     private:
         /// Accumulator image.
@@ -176,6 +218,9 @@ namespace QCV
 
         /// Look up vector for sinus.
         std::vector<double>  m_sinLUV;
+
+        /// Row buffer for addPoint().
+        std::vector<float>   m_rows_v;
  
         /// Theta range
         S2D<double>          m_theta;
@@ -268,12 +268,10 @@ CMonoTrackerOp::cycle()
        m_unifiedFeatureVector.clear();
        
        if (featVec1)
-          m_unifiedFeatureVector.insert(m_unifiedFeatureVector.begin()+m_unifiedFeatureVector.size(), 
-                                        featVec1->begin(), featVec1->end() );
+          m_unifiedFeatureVector.append ( *featVec1 );
        
        if (featVec2)
-          m_unifiedFeatureVector.insert(m_unifiedFeatureVector.begin()+m_unifiedFeatureVector.size(), 
-                                        featVec2->begin(), featVec2->end() );
+          m_unifiedFeatureVector.append ( *featVec2 );
        
        registerOutput <CFeatureVector> ( "Unified Feature Vector", 
                                          &m_unifiedFeatureVector );
@@ -37,12 +37,39 @@
 #include "drawingList.h"
 #include <opencv2/imgproc/imgproc.hpp>
 
-#if defined ( _OPENMP )
- #undef _OPENMP
-#endif
+#include "simd4.h"
 
 using namespace QCV;
 
+#if defined ( __SSE2__ )
+/// Sum of the four lanes.
+static inline double sum4 ( TDouble4 f_a )
+{
+    double val_p[4];
+    store4 ( val_p, f_a );
+    return (val_p[0] + val_p[1]) + (val_p[2] + val_p[3]);
+}
+
+/// Mask of the samples whose row is closer than f_residuum_v to the
+/// predicted row. The prediction is computed in double precision as
+/// in the scalar version. Returns also the absolute residuals.
+static inline __m128 inliers4 ( TDouble4 f_px_v, TDouble4 f_py_v, TDouble4 f_pz_v,
+                                __m128 f_u_v, __m128 f_v_v, __m128 f_d_v,
+                                __m128 f_residuum_v,
+                                __m128 & fr_diff_v )
+{
+    const TDouble4 pred_v = add4 ( add4 ( mul4 ( f_px_v, toDouble4 ( f_u_v ) ), 
+                                          mul4 ( f_py_v, toDouble4 ( f_d_v ) ) ), 
+                                   f_pz_v );
+
+    const __m128 absMask_v = _mm_castsi128_ps ( _mm_set1_epi32 ( 0x7fffffff ) );
+    
+    fr_diff_v = _mm_and_ps ( _mm_sub_ps ( toFloat4 ( pred_v ), f_v_v ), absMask_v );
+
+    return _mm_cmplt_ps ( fr_diff_v, f_residuum_v );
+}
+#endif
+
 /// Constructors.
 CRoadPlaneDetectionOp::CRoadPlaneDetectionOp ( COperator * const f_parent_p )
     : COperator (     f_parent_p, "Road Plane Detector" ),
@@ -522,6 +549,10 @@ CRoadPlaneDetectionOp::calculateRoadPlane( const cv::Mat       & f_dispImg,
     
     bool debug_b = false;
     
+    startClock ("cycle() - calculateRoadPlane - compact samples");
+    compactSamples ( f_dispImg );
+    stopClock ("cycle() - calculateRoadPlane - compact samples");
+
     startClock ("cycle() - calculateRoadPlane - Iteration");
 
     //debug_b=true;
@@ -531,8 +562,7 @@ CRoadPlaneDetectionOp::calculateRoadPlane( const cv::Mat       & f_dispImg,
             printf("%s:%i Calculating matrices in iteration %i\n", __FILE__, __LINE__, it);
         
         startClock ("cycle() - calculateRoadPlane - calculateMatrices");
-        calculateMatrices( f_dispImg, 
-                           prediction, 
+        calculateMatrices( prediction, 
                            residuum_f, 
                            AtA, Atb);
         stopClock ("cycle() - calculateRoadPlane - calculateMatrices");
@@ -560,34 +590,14 @@ CRoadPlaneDetectionOp::calculateRoadPlane( const cv::Mat       & f_dispImg,
             return false;
         }
 
-        int w_i = f_dispImg.cols;
-        int h_i = f_dispImg.rows;
-
-        count_i  = 0;
-        double sum_d    = 0.;
+        double sum_d;
         
         startClock ("cycle() - calculateRoadPlane - recompute residuum");
         /// Recompute average residuum.
-        for (int i = m_rowStart_i; i < h_i; ++i)
-        {
-            const float * d_p = &f_dispImg.at<float>(i,0);
-
-            for (int j = 0; j < w_i; ++j, ++d_p)
-            {                
-                if ( *d_p > m_minDisp_f )
-                {
-                    float predRow_f = (j*m_imgResult.x() + *d_p * m_imgResult.y() + m_imgResult.z());
-                    /// Evaluate if the point is approximatelly on the road.
-                    float diff_f = fabsf ( i - predRow_f );
-                    
-                    if ( diff_f < residuum_f )
-                    {
-                        ++count_i;
-                        sum_d += diff_f;
-                    }
-                }
-            }
-        }
+        calculateResiduum ( m_imgResult,
+                            residuum_f,
+                            count_i,
+                            sum_d );
         stopClock ("cycle() - calculateRoadPlane - recompute residuum");
 
         if (debug_b)
@@ -633,107 +643,236 @@ CRoadPlaneDetectionOp::calculateRoadPlane( const cv::Mat       & f_dispImg,
     return true;
 }
 
-bool
-CRoadPlaneDetectionOp::calculateMatrices( const cv::Mat       & f_dispImg,
-                                          const C3DVector     & f_prediction,
-                                          const float           f_residuum_f,
-                                          C3DMatrix           & fr_AtA,
-                                          C3DVector           & fr_Atb)
-{   
+/// Store the valid disparities below the start row in the sample
+/// vectors. The iterations of calculateRoadPlane() work only over them.
+void
+CRoadPlaneDetectionOp::compactSamples ( const cv::Mat & f_dispImg )
+{
     int w_i = f_dispImg.cols;
     int h_i = f_dispImg.rows;
 
-#ifdef _OPENMP
-    const int numThreads_i = (int) std::min(omp_get_max_threads(),32);
+    m_sampleU_v.clear();
+    m_sampleV_v.clear();
+    m_sampleD_v.clear();
 
-    C3DMatrix matrices_p[32];
-    C3DVector bvecs_p[32];
-    int       counters_p[32];
-
-    for (int i = 0; i < 32; ++i)
+    for (int i = std::max(m_rowStart_i, 0); i < h_i; ++i)
     {
-        matrices_p[i].clear();
-        bvecs_p[i].clear();
-        counters_p[i] = 0;
+        const float * d_p = &f_dispImg.at<float>(i,0);
+
+        for (int j = 0; j < w_i; ++j, ++d_p)
+        {
+            if ( *d_p > m_minDisp_f )
+            {
+                m_sampleU_v.push_back ( j );
+                m_sampleV_v.push_back ( i );
+                m_sampleD_v.push_back ( *d_p );
+            }
+        }
     }
-#else
-    C3DMatrix m;
-    int       c_i = 0;
-    C3DVector bvec;
-        
-    m.clear();
-    bvec.clear();
-#endif
+}
+
+bool
+CRoadPlaneDetectionOp::calculateMatrices( const C3DVector     & f_prediction,
+                                          const float           f_residuum_f,
+                                          C3DMatrix           & fr_AtA,
+                                          C3DVector           & fr_Atb)
+{
+    const int numThreads_i = m_normalEquations.reset();
+    const int size_i       = m_sampleD_v.size();
+
+    const float * u_p = size_i?&m_sampleU_v[0]:NULL;
+    const float * v_p = size_i?&m_sampleV_v[0]:NULL;
+    const float * d_p = size_i?&m_sampleD_v[0]:NULL;
 
 #if defined ( _OPENMP )
-#pragma omp parallel for num_threads(numThreads_i) schedule(static)
+#pragma omp parallel for num_threads(numThreads_i) schedule(static,1)
 #endif
-    for (int i = m_rowStart_i; i < h_i; ++i)
+    for (int t = 0; t < numThreads_i; ++t)
     {
-#if defined ( _OPENMP )
-        const unsigned int threadNum_ui = omp_get_thread_num();
-        C3DMatrix &m    = matrices_p[threadNum_ui];
-        int       &c_i  = counters_p[threadNum_ui];
-        C3DVector &bvec = bvecs_p[threadNum_ui];
+        SNormalEquations &eqs  = m_normalEquations.at(t);
+        C3DMatrix        &m    = eqs.AtA;
+        C3DVector        &bvec = eqs.Atb;
+        int              &c_i  = eqs.count_i;
+
+        const int first_i = (int)(( t    * (long long) size_i) / numThreads_i);
+        const int last_i  = (int)(((t+1) * (long long) size_i) / numThreads_i);
+
+        int k = first_i;
+
+#if defined ( __SSE2__ )
+        const TDouble4 px_v       = set4 ( f_prediction.x() );
+        const TDouble4 py_v       = set4 ( f_prediction.y() );
+        const TDouble4 pz_v       = set4 ( f_prediction.z() );
+        const __m128   residuum_v = _mm_set1_ps ( f_residuum_f );
+        const TDouble4 one_v      = set4 ( 1. );
+
+        TDouble4 m00_v = zero4(), m01_v = zero4(), m02_v = zero4();
+        TDouble4 m11_v = zero4(), m12_v = zero4();
+        TDouble4 b0_v  = zero4(), b1_v  = zero4(), b2_v  = zero4();
+        TDouble4 c_v   = zero4();
+
+        for (; k + 4 <= last_i; k += 4)
+        {
+            const __m128 u_v = _mm_loadu_ps ( u_p + k );
+            const __m128 v_v = _mm_loadu_ps ( v_p + k );
+            const __m128 d_v = _mm_loadu_ps ( d_p + k );
+
+            __m128 diff_v;
+            const TDouble4 in_v = mask4 ( inliers4 ( px_v, py_v, pz_v,
+                                                     u_v, v_v, d_v,
+                                                     residuum_v, diff_v ) );
+
+            const TDouble4 uD_v = toDouble4 ( u_v );
+            const TDouble4 vD_v = toDouble4 ( v_v );
+
+            /// Products of a disparity are float products as in the
+            /// scalar version.
+            m00_v = add4 ( m00_v, and4 ( in_v, mul4 ( uD_v, uD_v ) ) );
+            m01_v = add4 ( m01_v, and4 ( in_v, toDouble4 ( _mm_mul_ps ( d_v, u_v ) ) ) );
+            m02_v = add4 ( m02_v, and4 ( in_v, uD_v ) );
+            m11_v = add4 ( m11_v, and4 ( in_v, toDouble4 ( _mm_mul_ps ( d_v, d_v ) ) ) );
+            m12_v = add4 ( m12_v, and4 ( in_v, toDouble4 ( d_v ) ) );
+
+            b0_v  = add4 ( b0_v,  and4 ( in_v, mul4 ( uD_v, vD_v ) ) );
+            b1_v  = add4 ( b1_v,  and4 ( in_v, toDouble4 ( _mm_mul_ps ( d_v, v_v ) ) ) );
+            b2_v  = add4 ( b2_v,  and4 ( in_v, vD_v ) );
+
+            c_v   = add4 ( c_v,   and4 ( in_v, one_v ) );
+        }
+
+        m.at(0,0)   += sum4 ( m00_v );
+        m.at(0,1)   += sum4 ( m01_v );
+        m.at(0,2)   += sum4 ( m02_v );
+        m.at(1,1)   += sum4 ( m11_v );
+        m.at(1,2)   += sum4 ( m12_v );
+
+        bvec.at(0)  += sum4 ( b0_v );
+        bvec.at(1)  += sum4 ( b1_v );
+        bvec.at(2)  += sum4 ( b2_v );
+
+        c_i         += (int) sum4 ( c_v );
 #endif
-        const float * d_p = &f_dispImg.at<float>(i,0);
 
-        for (int j = 0; j < w_i; ++j, ++d_p)
+        for (; k < last_i; ++k)
         {
-            if ( *d_p > m_minDisp_f )
+            const int   j   = (int) u_p[k];
+            const int   i   = (int) v_p[k];
+            const float d_f = d_p[k];
+
+            /// Evaluate if the point is approximatelly on the road.
+            float vtest_d = ( f_prediction.x() * j +
+                              f_prediction.y() * d_f +
+                              f_prediction.z() );
+
+            if (fabsf(vtest_d - i) < f_residuum_f)
             {
-                /// Evaluate if the point is approximatelly on the road.
-                float vtest_d = ( f_prediction.x() * j + 
-                                  f_prediction.y() * *d_p + 
-                                  f_prediction.z() );
+                m.at(0,0) += j*j;
+                m.at(0,1) += d_f * j;
+                m.at(0,2) += j;
+                m.at(1,1) += d_f * d_f;
+                m.at(1,2) += d_f;
 
-                if (fabsf(vtest_d - i) < f_residuum_f)
-                {
-                    m.at(0,0) += j*j;
-                    m.at(0,1) += *d_p * j;
-                    m.at(0,2) += j;
-                    m.at(1,1) += *d_p * *d_p;
-                    m.at(1,2) += *d_p;
-                    
-                    bvec.at(0) += j * i;
-                    bvec.at(1) += *d_p * i;
-                    bvec.at(2) += i;
-                    
-                    ++c_i;
-                }
-            }                
+                bvec.at(0) += j * i;
+                bvec.at(1) += d_f * i;
+                bvec.at(2) += i;
+
+                ++c_i;
+            }
         }
     }
 
-    C3DMatrix AtA;
-    C3DVector Atb;
-    int count_i;
-
-#if defined ( _OPENMP )
-    fr_AtA.clear();
-    fr_Atb.clear();
-    count_i = 0;
+    SNormalEquations eqs;
+    m_normalEquations.reduce ( eqs );
 
-    for (int i = 0; i < numThreads_i; ++i)
-    {
-        fr_AtA  += matrices_p[i];
-        count_i += counters_p[i];
-        fr_Atb  += bvecs_p[i];
-    }
-#else
-    fr_AtA  = m;
-    count_i = c_i;
-    fr_Atb  = bvec;
-#endif
+    fr_AtA = eqs.AtA;
+    fr_Atb = eqs.Atb;
 
-    fr_AtA.at(2,2) = count_i;
+    fr_AtA.at(2,2) = eqs.count_i;
     fr_AtA.at(1,0) = fr_AtA.at(0,1);
     fr_AtA.at(2,0) = fr_AtA.at(0,2);
     fr_AtA.at(2,1) = fr_AtA.at(1,2);
-    
-    return true;    
+
+    return true;
 }
 
+/// Number and sum of the residuals of the samples under the given
+/// residuum.
+void
+CRoadPlaneDetectionOp::calculateResiduum( const C3DVector     & f_imgResult,
+                                          const float           f_residuum_f,
+                                          int                 & fr_count_i,
+                                          double              & fr_sum_d )
+{
+    const int numThreads_i = m_residuumSums.reset();
+    const int size_i       = m_sampleD_v.size();
+
+    const float * u_p = size_i?&m_sampleU_v[0]:NULL;
+    const float * v_p = size_i?&m_sampleV_v[0]:NULL;
+    const float * d_p = size_i?&m_sampleD_v[0]:NULL;
+
+#if defined ( _OPENMP )
+#pragma omp parallel for num_threads(numThreads_i) schedule(static,1)
+#endif
+    for (int t = 0; t < numThreads_i; ++t)
+    {
+        SResiduumSum &sum = m_residuumSums.at(t);
+
+        const int first_i = (int)(( t    * (long long) size_i) / numThreads_i);
+        const int last_i  = (int)(((t+1) * (long long) size_i) / numThreads_i);
+
+        int k = first_i;
+
+#if defined ( __SSE2__ )
+        const TDouble4 px_v       = set4 ( f_imgResult.x() );
+        const TDouble4 py_v       = set4 ( f_imgResult.y() );
+        const TDouble4 pz_v       = set4 ( f_imgResult.z() );
+        const __m128   residuum_v = _mm_set1_ps ( f_residuum_f );
+        const TDouble4 one_v      = set4 ( 1. );
+
+        TDouble4 sum_v = zero4();
+        TDouble4 c_v   = zero4();
+
+        for (; k + 4 <= last_i; k += 4)
+        {
+            __m128 diff_v;
+            const TDouble4 in_v = mask4 ( inliers4 ( px_v, py_v, pz_v,
+                                                     _mm_loadu_ps ( u_p + k ),
+                                                     _mm_loadu_ps ( v_p + k ),
+                                                     _mm_loadu_ps ( d_p + k ),
+                                                     residuum_v, diff_v ) );
+
+            sum_v = add4 ( sum_v, and4 ( in_v, toDouble4 ( diff_v ) ) );
+            c_v   = add4 ( c_v,   and4 ( in_v, one_v ) );
+        }
+
+        sum.sum_d   += sum4 ( sum_v );
+        sum.count_i += (int) sum4 ( c_v );
+#endif
+
+        for (; k < last_i; ++k)
+        {
+            const int   j   = (int) u_p[k];
+            const int   i   = (int) v_p[k];
+            const float d_f = d_p[k];
+
+            float predRow_f = (j*f_imgResult.x() + d_f * f_imgResult.y() + f_imgResult.z());
+            /// Evaluate if the point is approximatelly on the road.
+            float diff_f = fabsf ( i - predRow_f );
+
+            if ( diff_f < f_residuum_f )
+            {
+                ++sum.count_i;
+                sum.sum_d += diff_f;
+            }
+        }
+    }
+
+    SResiduumSum sum;
+    m_residuumSums.reduce ( sum );
+
+    fr_count_i = sum.count_i;
+    fr_sum_d   = sum.sum_d;
+}
 
 
 /// Show event.
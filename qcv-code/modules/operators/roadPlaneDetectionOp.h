@@ -44,6 +44,7 @@
 #include "operator.h"
 #include "stereoCamera.h"
 #include "3DPointVector.h"
+#include "parallelReduction.h"
 
 /* PROTOTYPES */
 
@@ -177,11 +178,64 @@ namespace QCV
                                  const CStereoCamera & f_camera,
                                  float               & fr_residuum_f );
 
-        bool calculateMatrices( const cv::Mat       & f_dispImg,
-                                const C3DVector     & f_prediction,
+        void compactSamples ( const cv::Mat       & f_dispImg );
+
+        bool calculateMatrices( const C3DVector     & f_prediction,
                                 const float           f_residuum_f,
                                 C3DMatrix           & fr_AtA,
                                 C3DVector           & fr_Atb);
+
+        void calculateResiduum( const C3DVector     & f_imgResult,
+                                const float           f_residuum_f,
+                                int                 & fr_count_i,
+                                double              & fr_sum_d );
+
+    /// Protected data types
+    protected:
+
+        /// Normal equations of the image plane fit.
+        struct SNormalEquations
+        {
+            C3DMatrix        AtA;
+            C3DVector        Atb;
+            int              count_i;
+
+            void clear()
+            {
+                AtA.clear();
+                Atb.clear();
+                count_i = 0;
+            }
+
+            SNormalEquations & operator += ( const SNormalEquations & f_other )
+            {
+                AtA     += f_other.AtA;
+                Atb     += f_other.Atb;
+                count_i += f_other.count_i;
+                return *this;
+            }
+        };
+
+        /// Number and sum of the residuals under the threshold.
+        struct SResiduumSum
+        {
+            int              count_i;
+            double           sum_d;
+
+            void clear()
+            {
+                count_i = 0;
+                sum_d   = 0.;
+            }
+
+            SResiduumSum & operator += ( const SResiduumSum & f_other )
+            {
+                count_i += f_other.count_i;
+                sum_d   += f_other.sum_d;
+                return *this;
+            }
+        };
+
         /// Private members
     private:
         
@@ -301,6 +355,21 @@ namespace QCV
 
         /// Initial pose from camera?
         bool                 m_iniPoseFromCamera_b;
+
+        /// Column of the valid disparities of the current frame.
+        std::vector<float>   m_sampleU_v;
+
+        /// Row of the valid disparities of the current frame.
+        std::vector<float>   m_sampleV_v;
+
+        /// Valid disparities of the current frame.
+        std::vector<float>   m_sampleD_v;
+
+        /// Per-thread normal equations.
+        CParallelReduction<SNormalEquations>  m_normalEquations;
+
+        /// Per-thread residuum sums.
+        CParallelReduction<SResiduumSum>      m_residuumSums;
         
     };
 }
@@ -0,0 +1,581 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose.
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+/**
+*******************************************************************************
+*
+* @file semiGlobalMatching.cpp
+*
+* \class CSemiGlobalMatching
+* \author Hernan Badino (hernan.badino@gmail.com)
+* \brief Multi-threaded semi-global matching stereo.
+*
+*******************************************************************************/
+
+/* INCLUDES */
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits>
+#include <algorithm>
+
+#if defined ( __AVX2__ )
+#include <immintrin.h>
+#elif defined ( __SSE2__ )
+#include <emmintrin.h>
+#endif
+
+#include <opencv2/imgproc/imgproc.hpp>
+#include <opencv2/calib3d/calib3d.hpp>
+
+#include "semiGlobalMatching.h"
+
+using namespace QCV;
+
+/// Maximum census cost (5x5 window without center pixel).
+static const int   SGM_MAX_CENSUS_COST = 24;
+
+/// Saturation value of the path costs.
+static const short SGM_MAX_PATH_COST   = std::numeric_limits<short>::max();
+
+/// Width of the column stripes of the vertical paths.
+static const int   SGM_STRIPE_WIDTH    = 16;
+
+static inline int
+popCount ( unsigned int f_val_ui )
+{
+#if defined ( __GNUC__ )
+    return __builtin_popcount ( f_val_ui );
+#else
+    f_val_ui = f_val_ui - ((f_val_ui >> 1) & 0x55555555);
+    f_val_ui = (f_val_ui & 0x33333333) + ((f_val_ui >> 2) & 0x33333333);
+    return (((f_val_ui + (f_val_ui >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+#endif
+}
+
+static inline short
+saturatedAdd ( int f_a_i, int f_b_i )
+{
+    return (short) std::min( f_a_i + f_b_i, (int) SGM_MAX_PATH_COST );
+}
+
+/// Computes the path cost of one pixel:
+///
+///   Lr(p,d) = C(p,d) + min( Lr(p-r,d), Lr(p-r,d-1) + P1,
+///                           Lr(p-r,d+1) + P1, min_k Lr(p-r,k) + P2 )
+///             - min_k Lr(p-r,k)
+///
+/// and stores (f_init_b) or adds it to the aggregated cost. f_prev_p
+/// and fr_curr_p point to the first disparity of a path cost vector
+/// padded with SGM_MAX_PATH_COST at positions -1 and f_numDisps_i.
+/// Returns the minimum path cost of the pixel.
+static inline short
+aggregatePixel ( const unsigned char * const f_cost_p,
+                 const short *         const f_prev_p,
+                 const short                 f_prevMin_s,
+                 short *               const fr_curr_p,
+                 short *               const fr_sum_p,
+                 const int                   f_numDisps_i,
+                 const short                 f_p1_s,
+                 const short                 f_p2_s,
+                 const bool                  f_init_b )
+{
+    const short jump_s = saturatedAdd ( f_prevMin_s, f_p2_s );
+    short       min_s  = SGM_MAX_PATH_COST;
+
+#if defined ( __AVX2__ )
+    const __m256i p1   = _mm256_set1_epi16 ( f_p1_s );
+    const __m256i pmin = _mm256_set1_epi16 ( f_prevMin_s );
+    const __m256i jump = _mm256_set1_epi16 ( jump_s );
+    __m256i       minv = _mm256_set1_epi16 ( SGM_MAX_PATH_COST );
+
+    for (int d = 0; d < f_numDisps_i; d += 16)
+    {
+        const __m256i c  = _mm256_cvtepu8_epi16 ( _mm_loadu_si128 ( (const __m128i *) (f_cost_p + d) ) );
+        const __m256i l0 = _mm256_loadu_si256 ( (const __m256i *) (f_prev_p + d) );
+        const __m256i lm = _mm256_adds_epi16 ( _mm256_loadu_si256 ( (const __m256i *) (f_prev_p + d - 1) ), p1 );
+        const __m256i lp = _mm256_adds_epi16 ( _mm256_loadu_si256 ( (const __m256i *) (f_prev_p + d + 1) ), p1 );
+        const __m256i m  = _mm256_min_epi16 ( _mm256_min_epi16 ( l0, jump ),
+                                              _mm256_min_epi16 ( lm, lp ) );
+        const __m256i lr = _mm256_adds_epi16 ( c, _mm256_subs_epi16 ( m, pmin ) );
+
+        _mm256_storeu_si256 ( (__m256i *) (fr_curr_p + d), lr );
+
+        __m256i * const sum_p = (__m256i *) (fr_sum_p + d);
+        _mm256_storeu_si256 ( sum_p, f_init_b?lr:_mm256_adds_epi16 ( _mm256_loadu_si256 ( sum_p ), lr ) );
+
+        minv = _mm256_min_epi16 ( minv, lr );
+    }
+
+    __m128i minh = _mm_min_epi16 ( _mm256_castsi256_si128 ( minv ), _mm256_extracti128_si256 ( minv, 1 ) );
+    minh = _mm_min_epi16 ( minh, _mm_srli_si128 ( minh, 8 ) );
+    minh = _mm_min_epi16 ( minh, _mm_srli_si128 ( minh, 4 ) );
+    minh = _mm_min_epi16 ( minh, _mm_srli_si128 ( minh, 2 ) );
+    min_s = (short) _mm_extract_epi16 ( minh, 0 );
+
+#elif defined ( __SSE2__ )
+    const __m128i zero = _mm_setzero_si128 ( );
+    const __m128i p1   = _mm_set1_epi16 ( f_p1_s );
+    const __m128i pmin = _mm_set1_epi16 ( f_prevMin_s );
+    const __m128i jump = _mm_set1_epi16 ( jump_s );
+    __m128i       minv = _mm_set1_epi16 ( SGM_MAX_PATH_COST );
+
+    for (int d = 0; d < f_numDisps_i; d += 8)
+    {
+        const __m128i c  = _mm_unpacklo_epi8 ( _mm_loadl_epi64 ( (const __m128i *) (f_cost_p + d) ), zero );
+        const __m128i l0 = _mm_loadu_si128 ( (const __m128i *) (f_prev_p + d) );
+        const __m128i lm = _mm_adds_epi16 ( _mm_loadu_si128 ( (const __m128i *) (f_prev_p + d - 1) ), p1 );
+        const __m128i lp = _mm_adds_epi16 ( _mm_loadu_si128 ( (const __m128i *) (f_prev_p + d + 1) ), p1 );
+        const __m128i m  = _mm_min_epi16 ( _mm_min_epi16 ( l0, jump ),
+                                           _mm_min_epi16 ( lm, lp ) );
+        const __m128i lr = _mm_adds_epi16 ( c, _mm_subs_epi16 ( m, pmin ) );
+
+        _mm_storeu_si128 ( (__m128i *) (fr_curr_p + d), lr );
+
+        __m128i * const sum_p = (__m128i *) (fr_sum_p + d);
+        _mm_storeu_si128 ( sum_p, f_init_b?lr:_mm_adds_epi16 ( _mm_loadu_si128 ( sum_p ), lr ) );
+
+        minv = _mm_min_epi16 ( minv, lr );
+    }
+
+    minv = _mm_min_epi16 ( minv, _mm_srli_si128 ( minv, 8 ) );
+    minv = _mm_min_epi16 ( minv, _mm_srli_si128 ( minv, 4 ) );
+    minv = _mm_min_epi16 ( minv, _mm_srli_si128 ( minv, 2 ) );
+    min_s = (short) _mm_extract_epi16 ( minv, 0 );
+
+#else
+    for (int d = 0; d < f_numDisps_i; ++d)
+    {
+        short m_s = std::min ( f_prev_p[d], jump_s );
+        m_s = std::min ( m_s, saturatedAdd ( f_prev_p[d-1], f_p1_s ) );
+        m_s = std::min ( m_s, saturatedAdd ( f_prev_p[d+1], f_p1_s ) );
+
+        const short lr_s = saturatedAdd ( f_cost_p[d], m_s - f_prevMin_s );
+
+        fr_curr_p[d] = lr_s;
+        fr_sum_p[d]  = f_init_b?lr_s:saturatedAdd ( fr_sum_p[d], lr_s );
+
+        min_s = std::min ( min_s, lr_s );
+    }
+#endif
+
+    return min_s;
+}
+
+/// Constructors.
+CSemiGlobalMatching::CSemiGlobalMatching ( )
+    : m_numDisps_i (                   64 ),
+      m_minDisp_i (                     0 ),
+      m_numPaths_i (                    8 ),
+      m_p1_i (                          8 ),
+      m_p2_i (                         96 ),
+      m_uniquenessRatio_i (             5 ),
+      m_disp12MaxDiff_i (               1 ),
+      m_speckleWinSize_i (              0 ),
+      m_speckleRange_i (                1 ),
+      m_width_i (                       0 ),
+      m_height_i (                      0 )
+{
+}
+
+/// Virtual destructor.
+CSemiGlobalMatching::~CSemiGlobalMatching ( )
+{
+}
+
+bool
+CSemiGlobalMatching::toGray ( const cv::Mat & f_img,
+                              cv::Mat &       fr_gray ) const
+{
+    if ( f_img.type() == CV_8UC1 )
+        fr_gray = f_img;
+    else if ( f_img.type() == CV_8UC3 )
+        cv::cvtColor ( f_img, fr_gray, CV_RGB2GRAY );
+    else
+    {
+        printf("%s:%i Required image format is CV_8UC1 or CV_8UC3\n", __FILE__, __LINE__);
+        return false;
+    }
+
+    return true;
+}
+
+/// Compute the disparity image.
+bool
+CSemiGlobalMatching::compute ( const cv::Mat & f_left,
+                               const cv::Mat & f_right,
+                               cv::Mat       & fr_disp )
+{
+    if ( f_left.size() != f_right.size() ||
+         f_left.type() != f_right.type() ||
+         f_left.cols < 5 || f_left.rows < 5 )
+    {
+        printf("%s:%i Invalid input images.\n", __FILE__, __LINE__ );
+        return false;
+    }
+
+    if ( !toGray ( f_left,  m_leftGray ) ||
+         !toGray ( f_right, m_rightGray ) )
+        return false;
+
+    m_width_i  = f_left.cols;
+    m_height_i = f_left.rows;
+
+    const size_t volSize_ui = (size_t) m_width_i * m_height_i * m_numDisps_i;
+
+    /// Buffers are only reallocated if the size or disparity range changes.
+    m_cost_v.resize ( volSize_ui );
+    m_sum_v.resize  ( volSize_ui );
+
+    m_pathStart_v.assign ( m_numDisps_i + 2, 0 );
+    m_pathStart_v.front() = m_pathStart_v.back() = SGM_MAX_PATH_COST;
+
+    computeCensus ( m_leftGray,  m_leftCensus_v );
+    computeCensus ( m_rightGray, m_rightCensus_v );
+
+    computeCost ( );
+
+    aggregateHorizontal ( );
+    aggregateVertical ( );
+
+    if ( m_numPaths_i == 8 )
+        aggregateDiagonal ( );
+
+    fr_disp.create ( m_height_i, m_width_i, CV_16S );
+
+    selectDisparities ( fr_disp );
+
+    if ( m_speckleWinSize_i > 0 )
+        cv::filterSpeckles ( fr_disp, getInvalidDisparity(), m_speckleWinSize_i, 16 * m_speckleRange_i );
+
+    return true;
+}
+
+/// 5x5 census transform. Border pixels get a zero signature.
+void
+CSemiGlobalMatching::computeCensus ( const cv::Mat &              f_img,
+                                     std::vector<unsigned int> &  fr_census_v ) const
+{
+    fr_census_v.assign ( m_width_i * m_height_i, 0 );
+
+#pragma omp parallel for schedule(static)
+    for (int i = 2; i < m_height_i - 2; ++i)
+    {
+        unsigned int * const census_p = &fr_census_v[i * m_width_i];
+
+        for (int j = 2; j < m_width_i - 2; ++j)
+        {
+            const unsigned char center_uc = f_img.at<unsigned char>(i, j);
+            unsigned int        code_ui   = 0;
+
+            for (int dy = -2; dy <= 2; ++dy)
+            {
+                const unsigned char * const row_p = f_img.ptr<unsigned char>(i + dy);
+
+                for (int dx = -2; dx <= 2; ++dx)
+                {
+                    if ( dx || dy )
+                        code_ui = (code_ui << 1) | ( row_p[j + dx] < center_uc );
+                }
+            }
+
+            census_p[j] = code_ui;
+        }
+    }
+}
+
+/// Hamming distance of the census signatures for every disparity.
+void
+CSemiGlobalMatching::computeCost ( )
+{
+    const int numDisps_i = m_numDisps_i;
+
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < m_height_i; ++i)
+    {
+        const unsigned int * const left_p  = &m_leftCensus_v[i * m_width_i];
+        const unsigned int * const right_p = &m_rightCensus_v[i * m_width_i];
+        unsigned char *            cost_p  = &m_cost_v[(size_t) i * m_width_i * numDisps_i];
+
+        for (int j = 0; j < m_width_i; ++j, cost_p += numDisps_i)
+        {
+            const unsigned int code_ui = left_p[j];
+
+            for (int d = 0; d < numDisps_i; ++d)
+            {
+                const int r = j - m_minDisp_i - d;
+
+                cost_p[d] = ( r >= 0 && r < m_width_i )?
+                    popCount ( code_ui ^ right_p[r] ) : SGM_MAX_CENSUS_COST;
+            }
+        }
+    }
+}
+
+/// Left to right and right to left paths. Rows are independent.
+/// The first path initializes the aggregated cost.
+void
+CSemiGlobalMatching::aggregateHorizontal ( )
+{
+    const int     numDisps_i = m_numDisps_i;
+    const int     stride_i   = numDisps_i + 2;
+    const short   p1_s       = (short) m_p1_i;
+    const short   p2_s       = (short) m_p2_i;
+
+#pragma omp parallel
+    {
+        std::vector<short> buffer_v ( 2 * stride_i, SGM_MAX_PATH_COST );
+        short * prev_p = &buffer_v[1];
+        short * curr_p = &buffer_v[1 + stride_i];
+
+#pragma omp for schedule(static)
+        for (int i = 0; i < m_height_i; ++i)
+        {
+            const size_t rowOffset_ui = (size_t) i * m_width_i * numDisps_i;
+
+            for (int dir = 0; dir < 2; ++dir)
+            {
+                const short * last_p  = &m_pathStart_v[1];
+                short         lastMin_s = 0;
+
+                for (int k = 0; k < m_width_i; ++k)
+                {
+                    const int    j           = dir?m_width_i - 1 - k:k;
+                    const size_t offset_ui = rowOffset_ui + (size_t) j * numDisps_i;
+
+                    lastMin_s = aggregatePixel ( &m_cost_v[offset_ui],
+                                                 last_p,
+                                                 lastMin_s,
+                                                 curr_p,
+                                                 &m_sum_v[offset_ui],
+                                                 numDisps_i, p1_s, p2_s,
+                                                 dir == 0 );
+                    last_p = curr_p;
+                    std::swap ( prev_p, curr_p );
+                }
+            }
+        }
+    }
+}
+
+/// Top to bottom and bottom to top paths. Columns are independent,
+/// the image is split in stripes of SGM_STRIPE_WIDTH columns.
+void
+CSemiGlobalMatching::aggregateVertical ( )
+{
+    const int     numDisps_i = m_numDisps_i;
+    const int     stride_i   = numDisps_i + 2;
+    const short   p1_s       = (short) m_p1_i;
+    const short   p2_s       = (short) m_p2_i;
+    const int     numStripes_i = (m_width_i + SGM_STRIPE_WIDTH - 1) / SGM_STRIPE_WIDTH;
+
+#pragma omp parallel
+    {
+        std::vector<short> buffer_v ( 2 * SGM_STRIPE_WIDTH * stride_i, SGM_MAX_PATH_COST );
+        std::vector<short> mins_v   ( 2 * SGM_STRIPE_WIDTH, 0 );
+
+#pragma omp for schedule(dynamic)
+        for (int s = 0; s < numStripes_i; ++s)
+        {
+            const int first_i = s * SGM_STRIPE_WIDTH;
+            const int last_i  = std::min ( first_i + SGM_STRIPE_WIDTH, m_width_i );
+
+            for (int dir = 0; dir < 2; ++dir)
+            {
+                short * prev_p    = &buffer_v[1];
+                short * curr_p    = &buffer_v[1 + SGM_STRIPE_WIDTH * stride_i];
+                short * prevMin_p = &mins_v[0];
+                short * currMin_p = &mins_v[SGM_STRIPE_WIDTH];
+
+                for (int k = 0; k < m_height_i; ++k)
+                {
+                    const int i = dir?m_height_i - 1 - k:k;
+
+                    for (int j = first_i; j < last_i; ++j)
+                    {
+                        const int    c         = j - first_i;
+                        const size_t offset_ui = ((size_t) i * m_width_i + j) * numDisps_i;
+
+                        currMin_p[c] = aggregatePixel ( &m_cost_v[offset_ui],
+                                                        k?prev_p + c * stride_i:&m_pathStart_v[1],
+                                                        k?prevMin_p[c]:0,
+                                                        curr_p + c * stride_i,
+                                                        &m_sum_v[offset_ui],
+                                                        numDisps_i, p1_s, p2_s,
+                                                        false );
+                    }
+
+                    std::swap ( prev_p,    curr_p );
+                    std::swap ( prevMin_p, currMin_p );
+                }
+            }
+        }
+    }
+}
+
+/// The four diagonal paths. Rows are processed sequentially, the
+/// columns of each row in parallel.
+void
+CSemiGlobalMatching::aggregateDiagonal ( )
+{
+    const int     numDisps_i = m_numDisps_i;
+    const int     stride_i   = numDisps_i + 2;
+    const short   p1_s       = (short) m_p1_i;
+    const short   p2_s       = (short) m_p2_i;
+
+    m_pathRows_v.assign ( 2 * m_width_i * stride_i, SGM_MAX_PATH_COST );
+    m_pathMins_v.assign ( 2 * m_width_i, 0 );
+
+    short * prev_p    = &m_pathRows_v[1];
+    short * curr_p    = &m_pathRows_v[1 + m_width_i * stride_i];
+    short * prevMin_p = &m_pathMins_v[0];
+    short * currMin_p = &m_pathMins_v[m_width_i];
+
+    static const int dirs_p[4][2] = { { 1, 1 }, { -1, 1 }, { 1, -1 }, { -1, -1 } };
+
+#pragma omp parallel
+    {
+        for (int dir = 0; dir < 4; ++dir)
+        {
+            const int dx = dirs_p[dir][0];
+            const int dy = dirs_p[dir][1];
+
+            for (int k = 0; k < m_height_i; ++k)
+            {
+                const int i = dy > 0?k:m_height_i - 1 - k;
+
+#pragma omp for schedule(static)
+                for (int j = 0; j < m_width_i; ++j)
+                {
+                    const int    p         = j - dx;
+                    const bool   start_b   = ( k == 0 || p < 0 || p >= m_width_i );
+                    const size_t offset_ui = ((size_t) i * m_width_i + j) * numDisps_i;
+
+                    currMin_p[j] = aggregatePixel ( &m_cost_v[offset_ui],
+                                                    start_b?&m_pathStart_v[1]:prev_p + p * stride_i,
+                                                    start_b?0:prevMin_p[p],
+                                                    curr_p + j * stride_i,
+                                                    &m_sum_v[offset_ui],
+                                                    numDisps_i, p1_s, p2_s,
+                                                    false );
+                }
+
+#pragma omp single
+                {
+                    std::swap ( prev_p,    curr_p );
+                    std::swap ( prevMin_p, currMin_p );
+                }
+            }
+        }
+    }
+}
+
+/// Winner takes all with uniqueness check, sub-pixel refinement and
+/// left-right consistency check (same criteria as cv::StereoSGBM).
+void
+CSemiGlobalMatching::selectDisparities ( cv::Mat & fr_disp ) const
+{
+    const int   numDisps_i = m_numDisps_i;
+    const short invalid_s  = getInvalidDisparity();
+
+#pragma omp parallel
+    {
+        std::vector<int>   disp2Cost_v ( m_width_i );
+        std::vector<short> disp2_v     ( m_width_i );
+
+#pragma omp for schedule(static)
+        for (int i = 0; i < m_height_i; ++i)
+        {
+            short * const disp_p = fr_disp.ptr<short>(i);
+
+            std::fill ( disp2Cost_v.begin(), disp2Cost_v.end(), std::numeric_limits<int>::max() );
+            std::fill ( disp2_v.begin(),     disp2_v.end(),     invalid_s );
+
+            for (int j = 0; j < m_width_i; ++j)
+            {
+                const short * const sum_p = &m_sum_v[((size_t) i * m_width_i + j) * numDisps_i];
+
+                int best_i = 0;
+                int minS_i = sum_p[0];
+
+                for (int d = 1; d < numDisps_i; ++d)
+                {
+                    if ( sum_p[d] < minS_i )
+                    {
+                        minS_i = sum_p[d];
+                        best_i = d;
+                    }
+                }
+
+                disp_p[j] = invalid_s;
+
+                int d;
+                for (d = 0; d < numDisps_i; ++d)
+                {
+                    if ( sum_p[d] * (100 - m_uniquenessRatio_i) < minS_i * 100 &&
+                         abs( best_i - d ) > 1 )
+                        break;
+                }
+
+                if ( d < numDisps_i )
+                    continue;
+
+                const int r = j - best_i - m_minDisp_i;
+
+                if ( r >= 0 && r < m_width_i && disp2Cost_v[r] > minS_i )
+                {
+                    disp2Cost_v[r] = minS_i;
+                    disp2_v[r]     = (short) (best_i + m_minDisp_i);
+                }
+
+                if ( best_i > 0 && best_i < numDisps_i - 1 )
+                {
+                    const int denom2_i = std::max ( sum_p[best_i-1] + sum_p[best_i+1] - 2 * sum_p[best_i], 1 );
+                    disp_p[j] = (short) ( ( best_i + m_minDisp_i ) * 16 +
+                                          ( ( sum_p[best_i-1] - sum_p[best_i+1] ) * 16 + denom2_i ) / ( denom2_i * 2 ) );
+                }
+                else
+                    disp_p[j] = (short) ( ( best_i + m_minDisp_i ) * 16 );
+            }
+
+            if ( m_disp12MaxDiff_i >= 0 )
+            {
+                for (int j = 0; j < m_width_i; ++j)
+                {
+                    const int d1_i = disp_p[j];
+
+                    if ( d1_i == invalid_s )
+                        continue;
+
+                    const int lo_i = d1_i >> 4;
+                    const int hi_i = ( d1_i + 15 ) >> 4;
+                    const int rlo  = j - lo_i;
+                    const int rhi  = j - hi_i;
+
+                    if ( 0 <= rlo && rlo < m_width_i && disp2_v[rlo] >= m_minDisp_i &&
+                         abs ( disp2_v[rlo] - lo_i ) > m_disp12MaxDiff_i &&
+                         0 <= rhi && rhi < m_width_i && disp2_v[rhi] >= m_minDisp_i &&
+                         abs ( disp2_v[rhi] - hi_i ) > m_disp12MaxDiff_i )
+                        disp_p[j] = invalid_s;
+                }
+            }
+        }
+    }
+}
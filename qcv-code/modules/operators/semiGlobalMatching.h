@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose.
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+#ifndef __SEMIGLOBALMATCHING_H
+#define __SEMIGLOBALMATCHING_H
+
+/**
+*******************************************************************************
+*
+* @file semiGlobalMatching.h
+*
+* \class CSemiGlobalMatching
+* \author Hernan Badino (hernan.badino@gmail.com)
+* \brief Multi-threaded semi-global matching stereo.
+*
+* Census (5x5) matching cost with 4 or 8 path semi-global aggregation.
+* Path costs are 16-bit saturated values computed with SSE2 or AVX2
+* (selected at compile time) or with a scalar fallback. Horizontal
+* paths are parallelized over rows, vertical paths over column stripes
+* and diagonal paths over the columns of each row.
+*
+* Memory is bounded by the disparity range: one byte of matching cost
+* and two bytes of aggregated cost per pixel and disparity, plus a few
+* rows of path costs.
+*
+* The output has the same format as cv::StereoSGBM: CV_16S disparity
+* image in 1/16 pixel units with (minDisparity-1)*16 for invalid pixels.
+*
+*******************************************************************************/
+
+/* INCLUDES */
+#include <vector>
+
+#include <opencv/cv.h>
+
+#include "paramMacros.h"
+
+/* PROTOTYPES */
+
+/* CONSTANTS */
+
+namespace QCV
+{
+    class CSemiGlobalMatching
+    {
+    /// Parameter access
+    public:
+        bool setNumberOfDisparities ( int f_num_i )
+        {
+            if ( f_num_i <= 0 || f_num_i % 16 )
+                return false;
+            m_numDisps_i = f_num_i;
+            return true;
+        }
+        int getNumberOfDisparities ( ) const { return m_numDisps_i; }
+
+        bool setNumberOfPaths ( int f_num_i )
+        {
+            if ( f_num_i != 4 && f_num_i != 8 )
+                return false;
+            m_numPaths_i = f_num_i;
+            return true;
+        }
+        int getNumberOfPaths ( ) const { return m_numPaths_i; }
+
+        ADD_PARAM_ACCESS         (int,  m_minDisp_i,         MinDisparity );
+        ADD_PARAM_ACCESS_BOUNDED (int,  m_p1_i,              P1, 0, 4096 );
+        ADD_PARAM_ACCESS_BOUNDED (int,  m_p2_i,              P2, 0, 4096 );
+        ADD_PARAM_ACCESS_BOUNDED (int,  m_uniquenessRatio_i, UniquenessRatio, 0, 99 );
+        ADD_PARAM_ACCESS         (int,  m_disp12MaxDiff_i,   Disp12MaxDiff );
+        ADD_PARAM_ACCESS         (int,  m_speckleWinSize_i,  SpeckleWindowSize );
+        ADD_PARAM_ACCESS         (int,  m_speckleRange_i,    SpeckleRange );
+
+    /// Constructor, Desctructors
+    public:
+        CSemiGlobalMatching ( );
+        virtual ~CSemiGlobalMatching ( );
+
+    /// Operations
+    public:
+        /// Compute the disparity image of a rectified pair (CV_8UC1
+        /// or CV_8UC3). Output is CV_16S with 4 fractional bits.
+        bool compute ( const cv::Mat & f_left,
+                       const cv::Mat & f_right,
+                       cv::Mat       & fr_disp );
+
+        /// Same as compute.
+        bool operator() ( const cv::Mat & f_left,
+                          const cv::Mat & f_right,
+                          cv::Mat       & fr_disp )
+        {
+            return compute ( f_left, f_right, fr_disp );
+        }
+
+        /// Value of invalid disparities in the output image.
+        short getInvalidDisparity() const { return (short)((m_minDisp_i - 1) * 16); }
+
+    protected:
+        bool toGray ( const cv::Mat & f_img,
+                      cv::Mat &       fr_gray ) const;
+
+        void computeCensus ( const cv::Mat &              f_img,
+                             std::vector<unsigned int> &  fr_census_v ) const;
+
+        void computeCost ( );
+
+        void aggregateHorizontal ( );
+
+        void aggregateVertical ( );
+
+        void aggregateDiagonal ( );
+
+        void selectDisparities ( cv::Mat & fr_disp ) const;
+
+    private:
+        /// Number of disparities (multiple of 16).
+        int                         m_numDisps_i;
+
+        /// Minimum disparity.
+        int                         m_minDisp_i;
+
+        /// Number of aggregation paths (4 or 8).
+        int                         m_numPaths_i;
+
+        /// Penalty for disparity changes of 1px.
+        int                         m_p1_i;
+
+        /// Penalty for larger disparity changes.
+        int                         m_p2_i;
+
+        /// Uniqueness ratio in percent.
+        int                         m_uniquenessRatio_i;
+
+        /// Left-right check tolerance [px]. Negative disables it.
+        int                         m_disp12MaxDiff_i;
+
+        /// Speckle filter window size. 0 disables it.
+        int                         m_speckleWinSize_i;
+
+        /// Speckle filter disparity range [px].
+        int                         m_speckleRange_i;
+
+        /// Width and height of the current images.
+        int                         m_width_i;
+        int                         m_height_i;
+
+        /// Gray images.
+        cv::Mat                     m_leftGray;
+        cv::Mat                     m_rightGray;
+
+        /// Census images.
+        std::vector<unsigned int>   m_leftCensus_v;
+        std::vector<unsigned int>   m_rightCensus_v;
+
+        /// Matching cost [H x W x D].
+        std::vector<unsigned char>  m_cost_v;
+
+        /// Aggregated cost [H x W x D].
+        std::vector<short>          m_sum_v;
+
+        /// Path costs of two rows for the diagonal paths [2 x W x (D+2)].
+        std::vector<short>          m_pathRows_v;
+
+        /// Minimum path cost of two rows for the diagonal paths [2 x W].
+        std::vector<short>          m_pathMins_v;
+
+        /// Path costs of the first pixel of a path [D+2].
+        std::vector<short>          m_pathStart_v;
+    };
+}
+#endif // __SEMIGLOBALMATCHING_H
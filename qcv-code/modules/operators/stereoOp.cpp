@@ -42,6 +42,10 @@
 #include "matVector.h"
 #include "stereoCamera.h"
 
+#ifdef HAVE_QGLVIEWER
+#include "3DViewerBase.h"
+#endif
+
 using namespace QCV;
 
 static const char g_scalerName_str[] = "Stereo Image Scaler";
@@ -57,6 +61,7 @@ CStereoOp::CStereoOp ( COperator * const f_parent_p,
       m_alg_e (                                SA_BM ),
       m_sgbm (                                       ),
       m_sbm (                                        ),
+      m_sgm (                                        ),
       m_leftImg (                                    ),
       m_rightImg (                                   ),
       m_dispImg (                                    ),
@@ -125,6 +130,7 @@ CStereoOp::registerParameters()
     
     algParam_p -> addDescription ( SA_SGBM, "Semi global block matching (SGBM)" );
     algParam_p -> addDescription ( SA_BM,   "Block matching (BM)" );
+    algParam_p -> addDescription ( SA_SGM,  "Native multi-threaded semi global matching (SGM)" );
     
 
     ADD_INT_PARAMETER ( "Downscale factor",
@@ -310,6 +316,77 @@ CStereoOp::registerParameters()
     
     END_PARAMETER_GROUP;
 
+    BEGIN_PARAMETER_GROUP("Native SGM", false, SRgb(220,0,0));
+
+      ADD_INT_PARAMETER ( "Number Of Disparities SGM",
+                          "This is maximum disparity minus minimum disparity. Must be a multiple of 16.",
+                          64,
+                          &m_sgm,
+                          NumberOfDisparities,
+                          CSemiGlobalMatching );
+
+      ADD_INT_PARAMETER ( "Min Disparity SGM",
+                          "Minimum possible disparity value.",
+                          0,
+                          &m_sgm,
+                          MinDisparity,
+                          CSemiGlobalMatching );
+
+      ADD_INT_PARAMETER ( "Number Of Paths",
+                          "Number of aggregation paths (4 or 8).",
+                          8,
+                          &m_sgm,
+                          NumberOfPaths,
+                          CSemiGlobalMatching );
+
+      ADD_INT_PARAMETER ( "P1 SGM",
+                          "Penalty for disparity changes of 1 px. Costs are census Hamming "
+                          "distances in the range [0, 24].",
+                          8,
+                          &m_sgm,
+                          P1,
+                          CSemiGlobalMatching );
+
+      ADD_INT_PARAMETER ( "P2 SGM",
+                          "Penalty for disparity changes larger than 1 px.",
+                          96,
+                          &m_sgm,
+                          P2,
+                          CSemiGlobalMatching );
+
+      ADD_INT_PARAMETER ( "Uniqueness Ratio SGM",
+                          "The margin in percents by which the best (minimum) aggregated cost "
+                          "should win the second best value to consider the match correct.",
+                          5,
+                          &m_sgm,
+                          UniquenessRatio,
+                          CSemiGlobalMatching );
+
+      ADD_INT_PARAMETER ( "Disp LR Max Diff SGM",
+                          "Maximum allowed difference (in integer pixel units) in the left-right "
+                          "disparity check. Set it to a negative value to disable the check.",
+                          1,
+                          &m_sgm,
+                          Disp12MaxDiff,
+                          CSemiGlobalMatching );
+
+      ADD_INT_PARAMETER ( "Speckle Window Size SGM",
+                          "Maximum size of smooth disparity regions to consider them noise speckles and "
+                          "invalidate. Set it to 0 to disable speckle filtering.",
+                          0,
+                          &m_sgm,
+                          SpeckleWindowSize,
+                          CSemiGlobalMatching );
+
+      ADD_INT_PARAMETER ( "Speckle Range SGM",
+                          "Maximum disparity variation [px] within each connected component.",
+                          1,
+                          &m_sgm,
+                          SpeckleRange,
+                          CSemiGlobalMatching );
+
+    END_PARAMETER_GROUP;
+
     BEGIN_PARAMETER_GROUP("Display", false, SRgb(220,0,0));
 
       addDrawingListParameter ( "Left Image" );
@@ -409,9 +486,11 @@ CStereoOp::cycle()
                 size.width  /= m_scale_i;
                 size.height /= m_scale_i;
  
+                getPooledMat ( tmpLeft,  size, vec[0].type() );
+                getPooledMat ( tmpRight, size, vec[1].type() );
                 cv::resize(vec[0], tmpLeft, size);
                 cv::resize(vec[1], tmpRight, size);
-                m_auxImg = cv::Mat(size, CV_16S );
+                getPooledMat ( m_auxImg, size, CV_16S );
             }
             else
             {
@@ -426,6 +505,13 @@ CStereoOp::cycle()
                 else
                     m_sgbm(tmpLeft, tmpRight, m_dispImg);
             }
+            else if ( m_alg_e == SA_SGM )
+            {
+                if (m_scale_i > 1)
+                    m_sgm(tmpLeft, tmpRight, m_auxImg);
+                else
+                    m_sgm(tmpLeft, tmpRight, m_dispImg);
+            }
             else
             {
                //static int oldScale_i = -1;
@@ -447,14 +533,14 @@ CStereoOp::cycle()
                     {
                         {
                             IplImage src = (IplImage)tmpLeft;
-                            l = cv::Mat( tmpLeft.size(), CV_8UC1);
+                            getPooledMat ( l, tmpLeft.size(), CV_8UC1 );
                             IplImage dst = (IplImage)l;
                             cvCvtColor ( &src, &dst, CV_RGB2GRAY);
                         }
                     
                         {
                             IplImage src = (IplImage)tmpRight;
-                            r = cv::Mat( tmpLeft.size(), CV_8UC1);
+                            getPooledMat ( r, tmpLeft.size(), CV_8UC1 );
                             IplImage dst = (IplImage)r;
                             cvCvtColor ( &src, &dst, CV_RGB2GRAY);
                         }
@@ -484,6 +570,7 @@ CStereoOp::cycle()
                 registerOutput<cv::Mat> ( std::string("Downscaled " + m_dispImgId_str), 
                                           &m_auxImg );
 
+                getPooledMat ( m_dispImg, vec[0].size(), m_auxImg.type() );
                 cv::resize(m_auxImg, m_dispImg, vec[0].size(), 0, 0, cv::INTER_NEAREST );
                 m_dispImg *= m_scale_i;
             }
@@ -495,7 +582,7 @@ CStereoOp::cycle()
             if ( m_convert2Float_b )
             {
                 /// Convert to float output
-                m_dispImgFloat = cv::Mat(m_dispImg.size(), CV_32FC1);
+                getPooledMat ( m_dispImgFloat, m_dispImg.size(), CV_32FC1 );
                 
                 float *t     = (float *)    m_dispImgFloat.data;
                 short int *s = (short int *)m_dispImg.data;
@@ -562,8 +649,6 @@ void CStereoOp::show3D()
 
     m_3dViewer_p -> clear(); /// This might clear 3D added by other operators.
 
-    m_3DPointImg = cv::Mat::zeros( m_dispImg.size(), CV_64FC3 );
-        
     // Let set just some approximate calibration params
     CStereoCamera tcam;    
     tcam.setBaseline(0.15);
@@ -580,19 +665,8 @@ void CStereoOp::show3D()
             textureImg = vec[0];
     }
 
-    for (int i = 0; i < m_dispImg.rows; ++i)
-    {
-        short int *p     = &m_dispImg.at<short int>(i, 0);
-        C3DVector *img_p = &m_3DPointImg.at<C3DVector>(i, 0);
-            
-        for (int j = 0; j < m_dispImg.cols; ++j, ++p, ++img_p)
-        {
-            if (*p > 0)
-            {
-                cam.image2Local ( j, i, *p/16.f, *img_p);
-            }
-        }
-    }   
+    /// Disparities are fixed point with 4 fractional bits.
+    cam.disparityImage2Local ( m_dispImg, m_3DPointImg, 16.f );
 
     m_3dViewer_p -> addMesh ( m_3DPointImg, textureImg, 2, 1000);
 #endif // HAVE_QGLVIEWER
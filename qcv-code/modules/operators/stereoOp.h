@@ -43,6 +43,7 @@
 #include "matVector.h"
 #include "operator.h"
 #include "colorEncoding.h"
+#include "semiGlobalMatching.h"
 
 /* PROTOTYPES */
 
@@ -141,7 +142,8 @@ namespace QCV
     public:    
         typedef enum {
             SA_SGBM,
-            SA_BM
+            SA_BM,
+            SA_SGM
         } EStereoAlgorithm;            
 
     /// Parameter access
@@ -233,6 +235,9 @@ namespace QCV
         /// BM struct
         CMyStereoBMState            m_sbmState;
 
+        /// Native multi-threaded SGM
+        CSemiGlobalMatching         m_sgm;
+
         /// Left image
         cv::Mat                     m_leftImg;
 
@@ -70,6 +70,7 @@ CStereoTrackerOp::CStereoTrackerOp ( COperator * const f_parent_p,
       m_unifiedFeatureVector (                       ),
       m_cropTopLeft (                         -1, -1 ),
       m_cropBottomRight (                     -1, -1 ),
+      m_parallel_b (                           false ),
       m_registerDL_b (                          true )
       
 {
@@ -156,6 +157,14 @@ CStereoTrackerOp::registerParameters(  )
                           CropBottomRight,
                           CStereoTrackerOp );
 
+    ADD_BOOL_PARAMETER ( "Parallel Execution",
+                         "Run the feature detector and the tracker concurrently. "
+                         "They run one after the other if their \"Output Feature "
+                         "Vector Id\" parameters are equal.",
+                         m_parallel_b,
+                         this,
+                         ParallelExecution,
+                         CStereoTrackerOp );
 
     END_PARAMETER_GROUP;
 
@@ -172,6 +181,12 @@ CStereoTrackerOp::registerParameters(  )
     END_PARAMETER_GROUP;
 }
 
+void
+CStereoTrackerOp::updateExecutionMode(  )
+{
+    setExecutionMode ( m_parallel_b?EM_PARALLEL:EM_SEQUENTIAL );
+}
+
 /// Virtual destructor.
 CStereoTrackerOp::~CStereoTrackerOp ()
 {
@@ -317,8 +332,14 @@ CStereoTrackerOp::cycle()
        m_camera.setV0( m_camera.getV0() + m_centralPointOffset.y );
        registerOutput<CStereoCamera> ( "Rectified Camera", &m_camera );
 
-       COperator::cycle(m_gftt_p);
-       COperator::cycle(m_kltTracker_p);
+       /// Detection and tracking do not depend on each other. They
+       /// run concurrently if "Parallel Execution" is set and their
+       /// output ids differ.
+       std::vector<COperator *> ops_v;
+       ops_v.push_back ( m_gftt_p );
+       ops_v.push_back ( m_kltTracker_p );
+
+       cycleChildren ( ops_v );
 
        /// Join feature vectors
        const CFeatureVector *featVec1 = m_gftt_p      ->getFeatureVector();
@@ -327,12 +348,10 @@ CStereoTrackerOp::cycle()
        m_unifiedFeatureVector.clear();
        
        if (featVec1)
-          m_unifiedFeatureVector.insert(m_unifiedFeatureVector.begin()+m_unifiedFeatureVector.size(), 
-                                        featVec1->begin(), featVec1->end() );
+          m_unifiedFeatureVector.append ( *featVec1 );
        
        if (featVec2)
-          m_unifiedFeatureVector.insert(m_unifiedFeatureVector.begin()+m_unifiedFeatureVector.size(), 
-                                        featVec2->begin(), featVec2->end() );
+          m_unifiedFeatureVector.append ( *featVec2 );
        
        registerOutput <CFeatureVector> ( "Unified Feature Vector", 
                                          &m_unifiedFeatureVector );
@@ -74,6 +74,8 @@ namespace QCV
         ADD_PARAM_ACCESS         (S2D<int>,    m_cropTopLeft,        CropTopLeft );
         ADD_PARAM_ACCESS         (S2D<int>,    m_cropBottomRight,    CropBottomRight );
 
+        ADD_PARAM_ACCESS_NOTIFIER(bool,        m_parallel_b,         ParallelExecution, updateExecutionMode );
+
         ADD_PARAM_ACCESS         (bool,        m_registerDL_b,       RegisterDrawingLists );
        
     /// Constructor, Desctructors
@@ -107,6 +109,9 @@ namespace QCV
 
         void registerParameters( );
 
+        /// Set the execution mode of the children from m_parallel_b.
+        void updateExecutionMode( );
+
     private:
         /// Scaler
         CImageScalerOp *            m_scaler_p;
@@ -168,6 +173,9 @@ namespace QCV
         /// Bottom-Right crop coordinate.
         S2D<int>                    m_cropBottomRight;
 
+        /// Run the feature detector and tracker concurrently.
+        bool                        m_parallel_b;
+
         /// Register drawing lists?
         bool                        m_registerDL_b;
     };
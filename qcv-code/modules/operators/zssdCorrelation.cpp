@@ -0,0 +1,302 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose.
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+/**
+*******************************************************************************
+*
+* @file zssdCorrelation.cpp
+*
+* \class CZssdCorrelation
+* \author Hernan Badino (hernan.badino@gmail.com)
+* \brief Window sums for ZSSD and SSD correlation along an image row.
+*
+*******************************************************************************/
+
+/* INCLUDES */
+#include <algorithm>
+
+#if defined ( __AVX2__ )
+#include <immintrin.h>
+#elif defined ( __SSE2__ )
+#include <emmintrin.h>
+#endif
+
+#include "zssdCorrelation.h"
+
+using namespace QCV;
+
+CZssdCorrelation::CZssdCorrelation ( )
+        : m_hMask (           0, 0 ),
+          m_v_i (                0 ),
+          m_u_i (                0 ),
+          m_uMin_i (             0 ),
+          m_count_i (            0 ),
+          m_sumL_f (            0.f )
+{
+}
+
+CZssdCorrelation::~CZssdCorrelation ( )
+{
+}
+
+void
+CZssdCorrelation::setLeftWindow ( const cv::Mat & f_imgL,
+                                  int             f_u_i,
+                                  int             f_v_i,
+                                  S2D<int>        f_hMask )
+{
+    m_hMask = f_hMask;
+    m_u_i   = f_u_i;
+    m_v_i   = f_v_i;
+
+    const int w_i = 2 * m_hMask.width  + 1;
+    const int h_i = 2 * m_hMask.height + 1;
+
+    m_left_v.resize ( w_i * h_i );
+
+    unsigned char * dst_p = &m_left_v[0];
+
+    for (int i = 0; i < h_i; ++i, dst_p += w_i)
+    {
+        const unsigned char * src_p = f_imgL.ptr<unsigned char>(m_v_i - m_hMask.height + i) + m_u_i - m_hMask.width;
+        std::copy ( src_p, src_p + w_i, dst_p );
+    }
+
+    /// Float accumulation in row-major order (exact unless the window
+    /// has more than 65793 pixels).
+    m_sumL_f = 0.f;
+    for (int k = 0; k < w_i * h_i; ++k)
+        m_sumL_f += m_left_v[k];
+}
+
+void
+CZssdCorrelation::compute ( const cv::Mat & f_imgR,
+                            int             f_uMin_i,
+                            int             f_uMax_i )
+{
+    m_uMin_i  = f_uMin_i;
+    m_count_i = std::max(f_uMax_i - f_uMin_i + 1, 0);
+
+    if ( (int) m_sumR_v.size() < m_count_i )
+    {
+        m_sumR_v.resize      ( m_count_i );
+        m_sumSqR_v.resize    ( m_count_i );
+        m_sumSqDiff_v.resize ( m_count_i );
+        m_sqDiff_v.resize    ( m_count_i );
+    }
+
+    if ( !m_count_i )
+        return;
+
+    if ( !isExact ( (int) m_left_v.size() ) )
+    {
+        computeFloat ( f_imgR );
+        return;
+    }
+
+    computeRightSums ( f_imgR );
+    computeSqDiff    ( f_imgR );
+
+    for (int k = 0; k < m_count_i; ++k)
+        m_sumSqDiff_v[k] = (float) m_sqDiff_v[k];
+}
+
+void
+CZssdCorrelation::computeRightSums ( const cv::Mat & f_imgR )
+{
+    const int w_i     = 2 * m_hMask.width  + 1;
+    const int h_i     = 2 * m_hMask.height + 1;
+    const int cols_i  = m_count_i + w_i - 1;
+    const int first_i = m_uMin_i - m_hMask.width;
+
+    m_colSum_v.assign   ( cols_i, 0 );
+    m_colSumSq_v.assign ( cols_i, 0 );
+
+    for (int i = 0; i < h_i; ++i)
+    {
+        const unsigned char * r_p = f_imgR.ptr<unsigned char>(m_v_i - m_hMask.height + i) + first_i;
+
+        for (int j = 0; j < cols_i; ++j)
+        {
+            m_colSum_v[j]   += r_p[j];
+            m_colSumSq_v[j] += r_p[j] * r_p[j];
+        }
+    }
+
+    /// Sliding window over the column sums.
+    int sum_i = 0, sumSq_i = 0;
+
+    for (int j = 0; j < w_i - 1; ++j)
+    {
+        sum_i   += m_colSum_v[j];
+        sumSq_i += m_colSumSq_v[j];
+    }
+
+    for (int k = 0; k < m_count_i; ++k)
+    {
+        sum_i   += m_colSum_v[k + w_i - 1];
+        sumSq_i += m_colSumSq_v[k + w_i - 1];
+
+        m_sumR_v[k]   = (float) sum_i;
+        m_sumSqR_v[k] = (float) sumSq_i;
+
+        sum_i   -= m_colSum_v[k];
+        sumSq_i -= m_colSumSq_v[k];
+    }
+}
+
+void
+CZssdCorrelation::computeSqDiff ( const cv::Mat & f_imgR )
+{
+    const int w_i     = 2 * m_hMask.width  + 1;
+    const int h_i     = 2 * m_hMask.height + 1;
+    const int first_i = m_uMin_i - m_hMask.width;
+
+    int k = 0;
+
+    /// Only full batches are vectorized so that no pixel right of the
+    /// last window is read.
+#if defined ( __AVX2__ )
+    const __m256i zero = _mm256_setzero_si256();
+
+    for (; k + 16 <= m_count_i; k += 16)
+    {
+        __m256i accLo = _mm256_setzero_si256();
+        __m256i accHi = _mm256_setzero_si256();
+
+        for (int i = 0; i < h_i; ++i)
+        {
+            const unsigned char * l_p = &m_left_v[i * w_i];
+            const unsigned char * r_p = f_imgR.ptr<unsigned char>(m_v_i - m_hMask.height + i) + first_i + k;
+
+            for (int j = 0; j < w_i; ++j)
+            {
+                const __m256i r    = _mm256_cvtepu8_epi16 ( _mm_loadu_si128 ( (const __m128i *) ( r_p + j ) ) );
+                const __m256i diff = _mm256_sub_epi16 ( _mm256_set1_epi16 ( l_p[j] ), r );
+
+                /// diff^2 as 32 bit with madd of (diff, 0) pairs.
+                const __m256i lo = _mm256_unpacklo_epi16 ( diff, zero );
+                const __m256i hi = _mm256_unpackhi_epi16 ( diff, zero );
+
+                accLo = _mm256_add_epi32 ( accLo, _mm256_madd_epi16 ( lo, lo ) );
+                accHi = _mm256_add_epi32 ( accHi, _mm256_madd_epi16 ( hi, hi ) );
+            }
+        }
+
+        /// Unpacking works on 128 bit lanes: accLo holds disparities 
+        /// 0-3 and 8-11, accHi holds 4-7 and 12-15.
+        int lo_p[8], hi_p[8];
+        _mm256_storeu_si256 ( (__m256i *) lo_p, accLo );
+        _mm256_storeu_si256 ( (__m256i *) hi_p, accHi );
+
+        for (int l = 0; l < 4; ++l)
+        {
+            m_sqDiff_v[k +      l] = lo_p[l];
+            m_sqDiff_v[k +  4 + l] = hi_p[l];
+            m_sqDiff_v[k +  8 + l] = lo_p[4 + l];
+            m_sqDiff_v[k + 12 + l] = hi_p[4 + l];
+        }
+    }
+#endif
+
+#if defined ( __SSE2__ )
+    const __m128i zero8 = _mm_setzero_si128();
+
+    for (; k + 8 <= m_count_i; k += 8)
+    {
+        __m128i accLo = _mm_setzero_si128();
+        __m128i accHi = _mm_setzero_si128();
+
+        for (int i = 0; i < h_i; ++i)
+        {
+            const unsigned char * l_p = &m_left_v[i * w_i];
+            const unsigned char * r_p = f_imgR.ptr<unsigned char>(m_v_i - m_hMask.height + i) + first_i + k;
+
+            for (int j = 0; j < w_i; ++j)
+            {
+                const __m128i r    = _mm_unpacklo_epi8 ( _mm_loadl_epi64 ( (const __m128i *) ( r_p + j ) ), zero8 );
+                const __m128i diff = _mm_sub_epi16 ( _mm_set1_epi16 ( l_p[j] ), r );
+
+                const __m128i lo = _mm_unpacklo_epi16 ( diff, zero8 );
+                const __m128i hi = _mm_unpackhi_epi16 ( diff, zero8 );
+
+                accLo = _mm_add_epi32 ( accLo, _mm_madd_epi16 ( lo, lo ) );
+                accHi = _mm_add_epi32 ( accHi, _mm_madd_epi16 ( hi, hi ) );
+            }
+        }
+
+        _mm_storeu_si128 ( (__m128i *) &m_sqDiff_v[k],     accLo );
+        _mm_storeu_si128 ( (__m128i *) &m_sqDiff_v[k + 4], accHi );
+    }
+#endif
+
+    for (; k < m_count_i; ++k)
+    {
+        int sum_i = 0;
+
+        for (int i = 0; i < h_i; ++i)
+        {
+            const unsigned char * l_p = &m_left_v[i * w_i];
+            const unsigned char * r_p = f_imgR.ptr<unsigned char>(m_v_i - m_hMask.height + i) + first_i + k;
+
+            for (int j = 0; j < w_i; ++j)
+            {
+                const int diff_i = l_p[j] - r_p[j];
+                sum_i += diff_i * diff_i;
+            }
+        }
+
+        m_sqDiff_v[k] = sum_i;
+    }
+}
+
+void
+CZssdCorrelation::computeFloat ( const cv::Mat & f_imgR )
+{
+    const int w_i     = 2 * m_hMask.width  + 1;
+    const int h_i     = 2 * m_hMask.height + 1;
+    const int first_i = m_uMin_i - m_hMask.width;
+
+    for (int k = 0; k < m_count_i; ++k)
+    {
+        float sumR_f   = 0.f;
+        float sumSqR_f = 0.f;
+        float sumSq_f  = 0.f;
+
+        for (int i = 0; i < h_i; ++i)
+        {
+            const unsigned char * l_p = &m_left_v[i * w_i];
+            const unsigned char * r_p = f_imgR.ptr<unsigned char>(m_v_i - m_hMask.height + i) + first_i + k;
+
+            for (int j = 0; j < w_i; ++j)
+            {
+                float diff_f = (float)l_p[j] - (float)r_p[j];
+                sumR_f   += r_p[j];
+                sumSq_f  += diff_f * diff_f;
+                sumSqR_f += (float)( r_p[j] * r_p[j] );
+            }
+        }
+
+        m_sumR_v[k]      = sumR_f;
+        m_sumSqR_v[k]    = sumSqR_f;
+        m_sumSqDiff_v[k] = sumSq_f;
+    }
+}
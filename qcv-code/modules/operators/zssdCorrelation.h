@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose.
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+#ifndef __ZSSDCORRELATION_H
+#define __ZSSDCORRELATION_H
+
+/**
+*******************************************************************************
+*
+* @file zssdCorrelation.h
+*
+* \class CZssdCorrelation
+* \author Hernan Badino (hernan.badino@gmail.com)
+* \brief Window sums for ZSSD and SSD correlation along an image row.
+*
+* The statistics of the left window are computed once. The sum of
+* squared differences is then computed for many right windows at once
+* with 16 (AVX2) or 8 (SSE2) disparities per instruction, or with a
+* scalar fallback. The sums of the right windows are obtained from
+* column sums.
+*
+* The sums are exact integers. For windows with more than 258 pixels
+* the squared sums can exceed the float mantissa; in that case the
+* sums are accumulated in float in row-major order instead, as the
+* original correlation loops of CFeatureStereoOp did. In both cases
+* the float results are identical to those loops.
+*
+*******************************************************************************/
+
+/* INCLUDES */
+#include <vector>
+
+#include <opencv/cv.h>
+
+#include "s2d.h"
+
+/* PROTOTYPES */
+
+/* CONSTANTS */
+
+namespace QCV
+{
+    class CZssdCorrelation
+    {
+    /// Constructor, Desctructors
+    public:
+        CZssdCorrelation ( );
+        virtual ~CZssdCorrelation ( );
+
+    /// Operations
+    public:
+        /// Set the left window centered at (f_u_i, f_v_i) with half
+        /// size f_hMask. The window must be inside the image (CV_8UC1).
+        void setLeftWindow ( const cv::Mat & f_imgL,
+                             int             f_u_i,
+                             int             f_v_i,
+                             S2D<int>        f_hMask );
+
+        /// Correlate the left window with the right windows centered 
+        /// at columns f_uMin_i to f_uMax_i of the same row. All windows
+        /// must be inside the image (CV_8UC1).
+        void compute ( const cv::Mat & f_imgR,
+                       int             f_uMin_i,
+                       int             f_uMax_i );
+
+        /// Sum of the left window.
+        float getSumL ( ) const { return m_sumL_f; }
+
+        /// Sum of the right window centered at column f_uMin_i + f_idx_i.
+        float getSumR ( int f_idx_i ) const { return m_sumR_v[f_idx_i]; }
+
+        /// Sum of squares of the right window centered at column
+        /// f_uMin_i + f_idx_i.
+        float getSumSqR ( int f_idx_i ) const { return m_sumSqR_v[f_idx_i]; }
+
+        /// Sum of squared differences between the left window and the
+        /// right window centered at column f_uMin_i + f_idx_i.
+        float getSumSqDiff ( int f_idx_i ) const { return m_sumSqDiff_v[f_idx_i]; }
+
+        /// Are the sums of a window with f_maskSize_i pixels computed 
+        /// with integers?
+        static bool isExact ( int f_maskSize_i )
+        {
+            return f_maskSize_i * 255 * 255 <= (1 << 24);
+        }
+
+    protected:
+        void computeRightSums ( const cv::Mat & f_imgR );
+
+        void computeSqDiff ( const cv::Mat & f_imgR );
+
+        void computeFloat ( const cv::Mat & f_imgR );
+
+    private:
+        /// Half mask size.
+        S2D<int>                    m_hMask;
+
+        /// Row of the windows.
+        int                         m_v_i;
+
+        /// Column of the left window.
+        int                         m_u_i;
+
+        /// First right column and number of right windows.
+        int                         m_uMin_i;
+        int                         m_count_i;
+
+        /// Left window [(2*hMask.height+1) x (2*hMask.width+1)].
+        std::vector<unsigned char>  m_left_v;
+
+        /// Sum of the left window.
+        float                       m_sumL_f;
+
+        /// Column sums of the right image over the window rows.
+        std::vector<int>            m_colSum_v;
+        std::vector<int>            m_colSumSq_v;
+
+        /// Integer sums of squared differences.
+        std::vector<int>            m_sqDiff_v;
+
+        /// Results.
+        std::vector<float>          m_sumR_v;
+        std::vector<float>          m_sumSqR_v;
+        std::vector<float>          m_sumSqDiff_v;
+    };
+}
+#endif // __ZSSDCORRELATION_H
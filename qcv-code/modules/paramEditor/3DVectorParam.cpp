@@ -32,7 +32,6 @@
 #include <limits>
 #include <stdio.h>
 #include "3DVectorParam.h"
-#include "3DVectorParamEditor.h"
 #include "stringOp.h"
 
 using namespace QCV;
@@ -116,8 +115,3 @@ C3DVectorParameter::setValue ( cv::Vec3d   f_value,
     return true;
 }
 
-::QWidget *
-C3DVectorParameter::createEditor ( )
-{
-    return  (m_qtEditor_p = new C3DVectorParamEditor ( this ));
-}
@@ -69,8 +69,6 @@ namespace QCV
             return m_names_p;
         }
 
-        /// Get editor.
-        virtual QWidget *       createEditor ( );
 
     /// Protected members
     protected:
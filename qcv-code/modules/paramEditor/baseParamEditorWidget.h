@@ -34,12 +34,14 @@
 /* INCLUDES */
 #include <QtGui/QWidget>
 
+#include "parameter.h"
+
 /* CONSTANTS */
 namespace QCV
 {
     /* PROTOTYPES */
 
-    class CBaseParamEditorWidget: public QWidget
+    class CBaseParamEditorWidget: public QWidget, public CParameterEditor
     {
         Q_OBJECT
 
@@ -54,7 +56,11 @@ namespace QCV
         
 
     public:
+        virtual QWidget * getWidget() { return this; }
+
         virtual bool updateWidget() { return false; }
+
+        virtual void repaintWidget() { update(); }
     };
 }
 
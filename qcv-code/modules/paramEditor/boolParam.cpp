@@ -31,7 +31,6 @@
 /* INCLUDES */
 #include "boolParam.h"
 #include "stringOp.h"
-#include "boolParamEditor.h"
 
 #include <math.h>
 #include <errno.h>
@@ -132,8 +131,3 @@ bool CBoolParameter::setValue ( bool f_value_b,
     return true;    
 }
 
-::QWidget *
-CBoolParameter::createEditor ( )
-{
-    return  (m_qtEditor_p = new CBoolParameterEditor ( this ));
-}
@@ -61,8 +61,6 @@ namespace QCV
                                            bool f_shouldUpdate_b = true );
 
 
-        /// Get editor.
-        virtual QWidget *       createEditor ( );
 
     /// Protected members
     protected:
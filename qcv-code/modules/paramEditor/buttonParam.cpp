@@ -31,7 +31,6 @@
 /* INCLUDES */
 #include "buttonParam.h"
 #include "stringOp.h"
-#include "buttonParamEditor.h"
 #include "paramBaseConnector.h"
 
 #include <math.h>
@@ -63,12 +62,6 @@ CButtonParameter::setValueFromString ( std::string /*f_val_str*/ )
     return false;
 }
 
-::QWidget *
-CButtonParameter::createEditor ( )
-{
-    return  (m_qtEditor_p = new CButtonParameterEditor ( this ));
-}
-
 void
 CButtonParameter::clicked()
 {
@@ -60,8 +60,6 @@ namespace QCV
         virtual std::string     getStringFromValue ( ) const;
         virtual bool            setValueFromString ( std::string f_val_str );
 
-        /// Get editor.
-        virtual QWidget *       createEditor ( );
 
 
         /// Should this parameter have an associated label in the GUI?
@@ -31,7 +31,6 @@
 /* INCLUDES */
 #include "colorParam.h"
 #include "stringOp.h"
-#include "colorParamEditor.h"
 
 using namespace QCV;
 
@@ -114,8 +113,3 @@ CColorParameter::setValue ( SRgba f_color,
     return true;
 }
 
-::QWidget *
-CColorParameter::createEditor ( )
-{
-    return  (m_qtEditor_p = new CColorParameterEditor ( this ));
-}
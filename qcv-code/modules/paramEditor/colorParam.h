@@ -65,8 +65,6 @@ namespace QCV
 
         virtual bool            useAlpha() const { return m_useAlpha_b; }
         
-        /// Get editor.
-        virtual QWidget *       createEditor ( );
 
     /// Protected members
     protected:
@@ -30,7 +30,6 @@
 
 /* INCLUDES */
 #include "dbl2DParam.h"
-#include "dbl2DParamEditor.h"
 #include "stringOp.h"
 #include <stdio.h>
 
@@ -108,8 +107,3 @@ CDbl2DParameter::setValue ( S2D<double> f_value,
     return true;
 }
 
-::QWidget *
-CDbl2DParameter::createEditor ( )
-{
-    return  (m_qtEditor_p = new CDbl2DParameterEditor ( this ));
-}
@@ -30,7 +30,6 @@
 
 /* INCLUDES */
 #include "dirPathParam.h"
-#include "filePathParamEditor.h"
 
 using namespace QCV;
 
@@ -41,13 +40,3 @@ CDirPathParameter::CDirPathParameter (  std::string               f_name_str,
         : CStringParameter( f_name_str, f_comment_str, f_value_str, f_connector_p )
 {
 }
-
-        
-
-
-::QWidget *
-CDirPathParameter::createEditor ( )
-{
-    return  (m_qtEditor_p = new CFilePathParameterEditor ( this, 
-                                                           CFilePathParameterEditor::FT_DIRECTORY ));
-}
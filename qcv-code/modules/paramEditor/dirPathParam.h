@@ -48,11 +48,6 @@ namespace QCV
                              std::string               f_value_str = "",
                              CParameterBaseConnector * f_connector_p = NULL );
         
-    public:
-        
-        /// Get editor.
-        virtual QWidget *       createEditor ( );
-        
         /// Protected members
     protected:
         
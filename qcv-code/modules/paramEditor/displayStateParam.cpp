@@ -31,7 +31,6 @@
 /* INCLUDES */
 #include "displayStateParam.h"
 #include "stringOp.h"
-#include "displayStateParamEditor.h"
 #include <stdio.h>
 
 using namespace QCV;
@@ -107,8 +106,3 @@ CDisplayStateParameter::setValue ( SDisplayState f_displayState,
     
 }
 
-::QWidget *
-CDisplayStateParameter::createEditor ( )
-{
-    return  (m_qtEditor_p = new CDisplayStateParameterEditor ( this ));
-}
@@ -61,8 +61,6 @@ namespace QCV
         virtual bool          setValue ( SDisplayState f_displayState,
                                          bool          f_shouldUpdate_b = true );
         
-        /// Get editor.
-        virtual QWidget *       createEditor ( );
 
     /// Protected members
     protected:
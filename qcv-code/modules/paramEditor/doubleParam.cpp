@@ -31,7 +31,6 @@
 /* INCLUDES */
 #include "doubleParam.h"
 #include "stringOp.h"
-#include "doubleParamEditor.h"
 
 #include <math.h>
 #include <errno.h>
@@ -103,16 +102,10 @@ CDoubleParameter::setValue ( double f_value_d,
     m_value_d = f_value_d;
 
     if ( getEditor() )
-        ((::QWidget*)getEditor()) -> update();
+        getEditor() -> repaintWidget();
 
     if ( f_shouldUpdate_b )
         return update();
     return true;
 }
 
-::QWidget *
-CDoubleParameter::createEditor ( )
-{
-    return  (m_qtEditor_p = new CDoubleParameterEditor ( this ));
-}
-
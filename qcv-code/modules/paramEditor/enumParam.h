@@ -63,8 +63,6 @@ namespace QCV
         virtual std::string     getStringFromValue ( ) const;
         virtual bool            setValueFromString ( std::string f_val_str ); 
 
-        /// Get editor.
-        virtual QWidget *       createEditor ( );
 
     public:
         /// Get and set bool value
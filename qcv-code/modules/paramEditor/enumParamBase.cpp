@@ -55,11 +55,3 @@ CEnumParameterBase::setValueFromString ( std::string /*f_val_str*/ )
 { 
     return false; 
 }
-
-/// Get editor.
-QWidget *
-CEnumParameterBase::createEditor ( )
-{ 
-    return NULL; 
-}
-
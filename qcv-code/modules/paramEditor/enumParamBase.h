@@ -65,8 +65,6 @@ namespace QCV
                 
         virtual bool            setValueFromString ( std::string f_val_str );        
  
-        /// Get editor.
-        virtual QWidget *       createEditor ( );
 
 
     /// Protected members.
@@ -29,10 +29,8 @@
  ******************************************************************************/
 
 /* INCLUDES */
-#include <QtGui/QWidget>
 #include "enumParam.h"
 #include "stringOp.h"
-#include "enumParamEditor.h"
 
 #include <math.h>
 #include <errno.h>
@@ -113,7 +111,7 @@ bool CEnumParameter<_EnumType>::setValue ( _EnumType f_value_e,
     m_value_e = f_value_e;
 
     if ( getEditor() )
-        ((::QWidget*)getEditor()) -> update();
+        getEditor() -> repaintWidget();
 
     if (f_shouldUpdate_b )
         return update();
@@ -138,14 +136,6 @@ void CEnumParameter<_EnumType>::removeDescription ( _EnumType   f_value_e  )
     }
 }
 
-template < class _EnumType >
-::QWidget *
-CEnumParameter<_EnumType>::createEditor ( )
-{
-    return  (m_qtEditor_p = new CEnumParameterEditor ( this ));
-}
-
-
 /// Get number of descriptions.
 template < class _EnumType >
 int
@@ -214,7 +204,8 @@ template < class _EnumType >
 void
 CEnumParameter<_EnumType>::updateWidgetContent()
 {
-    ((CEnumParameterEditor*) m_qtEditor_p)->updateContent();    
+    if ( m_qtEditor_p )
+        m_qtEditor_p -> updateContent();
 }
 
 
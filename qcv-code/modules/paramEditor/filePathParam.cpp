@@ -30,7 +30,6 @@
 
 /* INCLUDES */
 #include "filePathParam.h"
-#include "filePathParamEditor.h"
 
 using namespace QCV;
 
@@ -41,13 +40,3 @@ CFilePathParameter::CFilePathParameter (  std::string               f_name_str,
         : CStringParameter( f_name_str, f_comment_str, f_value_str, f_connector_p )
 {
 }
-
-        
-
-
-::QWidget *
-CFilePathParameter::createEditor ( )
-{
-    return  (m_qtEditor_p = new CFilePathParameterEditor ( this, 
-                                                           CFilePathParameterEditor::FT_FILE ));
-}
@@ -29,10 +29,8 @@
  ******************************************************************************/
 
 /* INCLUDES */
-#include <QtGui/QWidget>
 #include "floatParam.h"
 #include "stringOp.h"
-#include "floatParamEditor.h"
 
 #include <math.h>
 #include <errno.h>
@@ -107,8 +105,3 @@ bool CFloatParameter::setValue ( float f_value_f,
     return true;
 }
 
-::QWidget *
-CFloatParameter::createEditor ( )
-{
-    return  (m_qtEditor_p = new CFloatParameterEditor ( this ));
-}
@@ -30,7 +30,6 @@
 
 /* INCLUDES */
 #include "flt2DParam.h"
-#include "flt2DParamEditor.h"
 #include "stringOp.h"
 #include <stdio.h>
 
@@ -109,8 +108,3 @@ CFlt2DParameter::setValue ( S2D<float> f_value,
     return true;
 }
 
-::QWidget *
-CFlt2DParameter::createEditor ( )
-{
-    return  (m_qtEditor_p = new CFlt2DParameterEditor ( this ));
-}
@@ -30,7 +30,6 @@
 
 /* INCLUDES */
 #include "int2DParam.h"
-#include "int2DParamEditor.h"
 #include <stdio.h>
 
 using namespace QCV;
@@ -108,8 +107,3 @@ CInt2DParameter::setValue ( S2D<int> f_value,
     return true;    
 }
 
-::QWidget *
-CInt2DParameter::createEditor ( )
-{
-    return  (m_qtEditor_p = new CInt2DParameterEditor ( this ));
-}
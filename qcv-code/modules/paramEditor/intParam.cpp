@@ -31,7 +31,6 @@
 /* INCLUDES */
 #include "intParam.h"
 #include "stringOp.h"
-#include "intParamEditor.h"
 
 #include <math.h>
 #include <errno.h>
@@ -113,8 +112,3 @@ bool CIntParameter::setValue ( int  f_value_i,
     return true;    
 }
 
-::QWidget *
-CIntParameter::createEditor ( )
-{
-    return  (m_qtEditor_p = new CIntParameterEditor ( this ));
-}
@@ -50,10 +50,80 @@
 #include "paramGroup.h"
 #include "paramGroupEnd.h"
 
+#include "3DVectorParamEditor.h"
+#include "boolParamEditor.h"
+#include "buttonParamEditor.h"
+#include "colorParamEditor.h"
+#include "dbl2DParamEditor.h"
+#include "displayStateParamEditor.h"
+#include "doubleParamEditor.h"
+#include "enumParamEditor.h"
+#include "filePathParamEditor.h"
+#include "floatParamEditor.h"
+#include "flt2DParamEditor.h"
+#include "int2DParamEditor.h"
+#include "intParamEditor.h"
+#include "stringParamEditor.h"
+#include "uint2DParamEditor.h"
+#include "uintParamEditor.h"
+#include "dirPathParam.h"
+
 //#include "displayTreeNode.h"
 
 using namespace QCV;
 
+typedef CBaseParamEditorWidget * (* EditorCreator_t) ( CParameter * f_param_p );
+
+/// Editor of type _Editor if the parameter is of type _Param.
+template < class _Param, class _Editor >
+static CBaseParamEditorWidget * editorFor ( CParameter * f_param_p )
+{
+    _Param * param_p = dynamic_cast<_Param *> ( f_param_p );
+    return param_p ? new _Editor ( param_p ) : NULL;
+}
+
+/// Path editors.
+template < class _Param, CFilePathParameterEditor::EFileType_t _Type >
+static CBaseParamEditorWidget * pathEditorFor ( CParameter * f_param_p )
+{
+    _Param * param_p = dynamic_cast<_Param *> ( f_param_p );
+    return param_p ? new CFilePathParameterEditor ( param_p, _Type ) : NULL;
+}
+
+/// Create the editor of a parameter (NULL if the parameter has no 
+/// editor). Derived parameter classes must be listed before their base.
+static CBaseParamEditorWidget * createEditor ( CParameter * f_param_p )
+{
+    static const EditorCreator_t creators_p[] = {
+        pathEditorFor < CDirPathParameter,  CFilePathParameterEditor::FT_DIRECTORY >,
+        pathEditorFor < CFilePathParameter, CFilePathParameterEditor::FT_FILE >,
+        editorFor < CStringParameter,       CStringParameterEditor >,
+        editorFor < CEnumParameterBase,     CEnumParameterEditor >,
+        editorFor < C3DVectorParameter,     C3DVectorParamEditor >,
+        editorFor < CBoolParameter,         CBoolParameterEditor >,
+        editorFor < CButtonParameter,       CButtonParameterEditor >,
+        editorFor < CColorParameter,        CColorParameterEditor >,
+        editorFor < CDbl2DParameter,        CDbl2DParameterEditor >,
+        editorFor < CDisplayStateParameter, CDisplayStateParameterEditor >,
+        editorFor < CDoubleParameter,       CDoubleParameterEditor >,
+        editorFor < CFloatParameter,        CFloatParameterEditor >,
+        editorFor < CFlt2DParameter,        CFlt2DParameterEditor >,
+        editorFor < CInt2DParameter,        CInt2DParameterEditor >,
+        editorFor < CIntParameter,          CIntParameterEditor >,
+        editorFor < CUInt2DParameter,       CUInt2DParameterEditor >,
+        editorFor < CUIntParameter,         CUIntParameterEditor > };
+
+    for (unsigned int i = 0; i < sizeof(creators_p) / sizeof(creators_p[0]); ++i)
+    {
+        CBaseParamEditorWidget * editor_p = creators_p[i] ( f_param_p );
+
+        if ( editor_p )
+            return editor_p;
+    }
+
+    return NULL;
+}
+
 CParameterEditorDlg::CParameterEditorDlg  ( CParameterSet *    f_rootNode_p,
                                             QWidget *          f_parent_p,
                                             CParamIOHandling * f_parser_p )
@@ -291,11 +361,12 @@ CParameterEditorDlg::reloadParameterPage ( const QModelIndex & f_index  )
         }
         else
         {
-            QWidget * paramEditor_p;
+            CBaseParamEditorWidget * paramEditor_p;
         
             param_p -> updateFromContainer();
 
-            paramEditor_p = param_p -> createEditor();
+            paramEditor_p = createEditor ( param_p );
+            param_p -> setEditor ( paramEditor_p );
             //printf("Editor %p created\n", paramEditor_p);
 
             if ( paramEditor_p )
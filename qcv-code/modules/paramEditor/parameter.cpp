@@ -29,7 +29,6 @@
 ******************************************************************************/
 
 /* INCLUDES */
-#include <QtGui/QWidget>
 #include "parameter.h"
 #include "paramBaseConnector.h"
 
@@ -39,21 +39,44 @@
  * Concrete subclasses must implement getStringFromValue and setValueFromString 
  * methods.
  *
+ * The editors are Qt widgets created by the parameter editor dialog (see
+ * CParameterEditorDlg), so that the parameters do not depend on QtGui.
+ * A parameter only knows its editor through the CParameterEditor
+ * interface.
+ *
  ******************************************************************************/
 
 /* INCLUDES */
-#include "baseParamEditorWidget.h"
 #include <string>
 
 /* CONSTANTS */
 
 /* PROTOTYPES */
+class QWidget;
 
 namespace QCV
 {
     /* PROTOTYPES */
     class CParameterBaseConnector;
     
+    class CParameterEditor
+    {
+    public:
+        virtual ~CParameterEditor ( ) {}
+
+        /// Widget of the editor.
+        virtual QWidget *       getWidget ( ) = 0;
+
+        /// Update the widget from the value of the parameter.
+        virtual bool            updateWidget ( ) = 0;
+
+        /// Update the content of the widget (e.g. the enum descriptions).
+        virtual void            updateContent ( ) {}
+
+        /// Schedule a repaint of the widget.
+        virtual void            repaintWidget ( ) = 0;
+    };
+
     class CParameter
     {
     /// Constructors/Destructor
@@ -83,14 +106,15 @@ namespace QCV
         CParameterBaseConnector *
                                 getConnector ( ) const;
         
-        /// Create editor.
-        virtual QWidget *       createEditor ( ) { return ( m_qtEditor_p = 0 ); }
+        /// Set the editor created for this parameter.
+        virtual void            setEditor ( CParameterEditor * f_editor_p ) { m_qtEditor_p = f_editor_p; }
 
         /// Create editor.
         virtual void            notifyEditorsDeletion ( ) { m_qtEditor_p = 0; }
         
          /// Get editor.
-        virtual QWidget *       getEditor ( ) const { return m_qtEditor_p; }
+        virtual CParameterEditor *
+                                getEditor ( ) const { return m_qtEditor_p; }
         
         /// Update initial value.
         void                    updateInitialValue();
@@ -125,7 +149,7 @@ namespace QCV
         std::string                 m_initialValue_str;
 
         /// Corresponding editor.
-        CBaseParamEditorWidget *    m_qtEditor_p;
+        CParameterEditor *          m_qtEditor_p;
 
         /// Connector with class get/set methods.
         CParameterBaseConnector *   m_connector_p;
@@ -31,7 +31,6 @@
 /* INCLUDES */
 #include "stringParam.h"
 #include "stringOp.h"
-#include "stringParamEditor.h"
 
 using namespace QCV;
 
@@ -92,8 +91,3 @@ CStringParameter::setValue ( std::string f_value_str,
     return true;
 }
 
-::QWidget *
-CStringParameter::createEditor ( )
-{
-    return  (m_qtEditor_p = new CStringParameterEditor ( this ));
-}
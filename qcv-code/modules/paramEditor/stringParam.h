@@ -67,8 +67,6 @@ namespace QCV
                                            bool        f_shouldUpdate_b = true );
 
 
-        /// Get editor.
-        virtual QWidget *       createEditor ( );
 
     /// Protected members
     protected:
@@ -30,7 +30,6 @@
 
 /* INCLUDES */
 #include "uint2DParam.h"
-#include "uint2DParamEditor.h"
 #include <stdio.h>
 
 using namespace QCV;
@@ -108,8 +107,3 @@ CUInt2DParameter::setValue ( S2D<unsigned int> f_value,
     return true;    
 }
 
-::QWidget *
-CUInt2DParameter::createEditor ( )
-{
-    return  (m_qtEditor_p = new CUInt2DParameterEditor ( this ));
-}
@@ -31,7 +31,6 @@
 /* INCLUDES */
 #include "uintParam.h"
 #include "stringOp.h"
-#include "uintParamEditor.h"
 
 #include <math.h>
 #include <errno.h>
@@ -114,8 +113,3 @@ CUIntParameter::setValue ( unsigned int f_value_b,
     return true;
 }
 
-::QWidget *
-CUIntParameter::createEditor ( )
-{
-    return  (m_qtEditor_p = new CUIntParameterEditor ( this ));
-}
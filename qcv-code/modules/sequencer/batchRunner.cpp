@@ -0,0 +1,248 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose.
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+/*@@@**************************************************************************
+* \file  batchRunner.cpp
+* \author Hernan Badino
+* \notes
+*******************************************************************************
+*****             (C) Hernan Badino 2012 - All Rights Reserved            *****
+******************************************************************************/
+
+/* INCLUDES */
+#include <map>
+#include <string>
+
+#include <QtCore/QTime>
+
+#include "batchRunner.h"
+#include "operator.h"
+#include "seqDeviceControl.h"
+#include "clockHandler.h"
+#include "clockTreeNode.h"
+#include "drawingListHandler.h"
+#include "io.h"
+
+using namespace QCV;
+
+namespace
+{
+    void printClocks ( FILE *                 f_file_p,
+                       const CClockOpNode *   f_node_p,
+                       const std::string &    f_prefix_str )
+    {
+        if ( !f_node_p -> getChildCount() )
+            return;
+
+        fprintf( f_file_p, "%s* %s\n", 
+                 f_prefix_str.c_str(), 
+                 f_node_p -> getName().c_str() );
+
+        for (unsigned int i = 0; i < f_node_p -> getClockCount(); ++i)
+        {
+            const CClockNode * clock_p = f_node_p -> getClockChild ( i );
+            const unsigned int count_ui = clock_p -> getCount();
+
+            fprintf( f_file_p, "%s  %-32s %8u cycles %12.3lf ms total %10.3lf ms/cycle\n",
+                     f_prefix_str.c_str(),
+                     clock_p -> getName().c_str(),
+                     count_ui,
+                     clock_p -> getTotalTime(),
+                     count_ui?clock_p -> getTotalTime() / count_ui:0. );
+        }
+
+        for (unsigned int i = 0; i < f_node_p -> getOpCount(); ++i)
+            printClocks ( f_file_p, f_node_p -> getOpChild ( i ), f_prefix_str + "  " );
+    }
+}
+
+CBatchRunner::CBatchRunner ( CSeqDeviceControl * f_device_p,
+                             COperator *         f_rootOp_p )
+        : m_device_p (        f_device_p ),
+          m_rootOp_p (        f_rootOp_p ),
+          m_show_b (               false ),
+          m_maxFrames_i (              0 ),
+          m_frames_i (                 0 ),
+          m_time_d (                  0. ),
+          m_rasterizer (                 ),
+          m_videoPath_str (              ),
+          m_fps_d (                  10. ),
+          m_writer (                     ),
+          m_frame (                      )
+{
+    m_device_p -> registerClocks ( m_rootOp_p -> getClockHandler(),
+                                   m_rootOp_p );
+}
+
+CBatchRunner::~CBatchRunner()
+{
+}
+
+bool
+CBatchRunner::run ( )
+{
+    m_frames_i = 0;
+    m_time_d   = 0.;
+
+    m_device_p -> initializeDevice();
+
+    if ( not m_device_p -> isInitialized() ||
+         not m_device_p -> initialize() )
+    {
+        printf("%s:%i Device %s not initialized\n", __FILE__, __LINE__, m_device_p ->getName().c_str());
+        return false;
+    }
+
+    QTime timer;
+    timer.start();
+
+    bool success_b = process ( true );
+
+    while ( success_b )
+    {
+        ++m_frames_i;
+
+        if ( m_maxFrames_i > 0 && m_frames_i >= m_maxFrames_i )
+            break;
+
+        /// Sequence devices stay at the last frame.
+        const int frame_i = m_device_p -> getCurrentFrame();
+
+        if ( not m_device_p -> nextFrame() ||
+             m_device_p -> getCurrentFrame() == frame_i )
+            break;
+
+        success_b = process ( false );
+    }
+
+    m_time_d = timer.elapsed();
+
+    m_rootOp_p -> exit();
+
+    m_writer.release();
+
+    if ( not success_b )
+        printf("%s:%i Frame %i could not be processed\n", 
+               __FILE__, __LINE__, m_device_p -> getCurrentFrame());
+
+    return success_b;
+}
+
+bool
+CBatchRunner::process ( bool f_initialize_b )
+{
+    std::map< std::string, CIOBase * > devOutput;
+
+    if ( not m_device_p -> registerOutputs ( devOutput ) )
+    {
+        printf("%s:%i Outputs of device %s could not be registered\n", 
+               __FILE__, __LINE__, m_device_p ->getName().c_str());
+        return false;
+    }
+
+    m_rootOp_p -> clearIOMap();
+    m_rootOp_p -> registerOutputs ( devOutput );
+
+    m_rootOp_p -> getClockHandler() -> setFrameNumber ( m_device_p -> getCurrentFrame() );
+
+    if ( f_initialize_b )
+    {
+        m_rootOp_p -> startClock ( "Initialize" );
+        m_rootOp_p -> initialize();
+        m_rootOp_p -> stopClock ( "Initialize" );
+    }
+
+    m_rootOp_p -> startClock ( "Cycle" );
+    m_rootOp_p -> cycle();
+    m_rootOp_p -> stopClock ( "Cycle" );
+
+    if ( m_show_b || !m_videoPath_str.empty() )
+    {
+        m_rootOp_p -> startClock ( "Show" );
+        m_rootOp_p -> show();
+        m_rootOp_p -> stopClock ( "Show" );
+    }
+
+    if ( !m_videoPath_str.empty() )
+    {
+        m_rootOp_p -> startClock ( "Render" );
+        writeVideoFrame();
+        m_rootOp_p -> stopClock ( "Render" );
+    }
+
+    m_rootOp_p -> startClock ( "Device output update" );
+    m_rootOp_p -> getOutputMap ( devOutput );
+    m_device_p -> updateOutput ( devOutput );
+    m_rootOp_p -> stopClock ( "Device output update" );
+
+    return true;
+}
+
+void
+CBatchRunner::setVideoOutput ( const std::string & f_path_str,
+                               double              f_fps_d )
+{
+    m_writer.release();
+
+    m_videoPath_str = f_path_str;
+    m_fps_d         = f_fps_d;
+}
+
+bool
+CBatchRunner::writeVideoFrame ( )
+{
+    m_rasterizer.setScreenSize ( m_rootOp_p -> getScreenSize() );
+    m_rasterizer.render ( *m_rootOp_p -> getDrawingListHandler(), m_frame );
+
+    if ( !m_writer.isOpened() )
+    {
+        if ( !m_writer.open ( m_videoPath_str, 
+                              CV_FOURCC('M','J','P','G'), 
+                              m_fps_d, 
+                              m_frame.size() ) )
+        {
+            printf("%s:%i Video file %s could not be opened\n", 
+                   __FILE__, __LINE__, m_videoPath_str.c_str());
+
+            /// Do not try again.
+            m_videoPath_str = "";
+            return false;
+        }
+    }
+
+    m_writer << m_frame;
+
+    return true;
+}
+
+void
+CBatchRunner::printStatistics ( FILE * f_file_p ) const
+{
+    fprintf( f_file_p, "Processed frames: %i in %.3lf s (%.2lf fps)\n",
+             m_frames_i,
+             m_time_d / 1000.,
+             m_time_d > 0?m_frames_i * 1000. / m_time_d:0. );
+
+    const CClockOpNode * root_p = m_rootOp_p -> getClockHandler() -> getRootNode();
+
+    if ( root_p )
+        printClocks ( f_file_p, root_p, "" );
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose.
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+
+#ifndef __BATCHRUNNER_H
+#define __BATCHRUNNER_H
+
+/**
+ *******************************************************************************
+ *
+ * @file batchRunner.h
+ *
+ * \class CBatchRunner
+ * \author Hernan Badino (hernan.badino@gmail.com)
+ *
+ * \brief Runs a root operator over all frames of a device without GUI.
+ *
+ * The frames are processed as fast as possible in the calling thread:
+ * there is no event loop, no timer, no display and no GL context. Only
+ * cycle() is called for every frame. show(), and therefore the
+ * generation of the drawing lists, is called only if requested with
+ * setShow(). Images added to drawing lists are then kept in memory
+ * without generating textures.
+ *
+ * The drawing lists can be rendered without OpenGL (see CRasterizer) and
+ * written to a video file with setVideoOutput(). show() is then called
+ * for every frame.
+ *
+ * The clocks of the operators are measured as in CMainWindow and can
+ * be printed with printStatistics() once run() returns.
+ *
+ *******************************************************************************/
+
+/* INCLUDES */
+#include <stdio.h>
+#include <string>
+
+#include <opencv/cv.h>
+#include <opencv/highgui.h>
+
+#include "rasterizer.h"
+
+/* CONSTANTS */
+
+namespace QCV
+{
+    /* PROTOTYPES */
+    class COperator;
+    class CSeqDeviceControl;
+
+    class CBatchRunner
+    {
+    /// Constructors, Destructors
+    public:
+        CBatchRunner ( CSeqDeviceControl * f_device_p,
+                       COperator *         f_rootOp_p );
+
+        virtual ~CBatchRunner();
+
+    /// Operations.
+    public:
+        /// Initialize the device and the root operator and process
+        /// all frames. Returns false if the device could not be
+        /// initialized or a frame could not be processed. The
+        /// processing stops at the first failing frame.
+        bool        run ( );
+
+        /// Print the number of frames, the frame rate and the clocks
+        /// of all operators.
+        void        printStatistics ( FILE * f_file_p = stdout ) const;
+
+    /// Get/Set
+    public:
+        /// Call show() after every cycle (default: false).
+        void        setShow ( bool f_show_b ) { m_show_b = f_show_b; }
+        bool        getShow ( ) const { return m_show_b; }
+
+        /// Maximal number of frames to process. 0 processes all frames
+        /// of the device.
+        void        setMaxFrames ( int f_frames_i ) { m_maxFrames_i = f_frames_i; }
+        int         getMaxFrames ( ) const { return m_maxFrames_i; }
+
+        /// Render the drawing lists of every frame into a video file.
+        /// An empty path disables the video output.
+        void        setVideoOutput ( const std::string & f_path_str,
+                                     double              f_fps_d = 10. );
+        std::string getVideoOutput ( ) const { return m_videoPath_str; }
+
+        /// Rasterizer used for the video output (screen count,
+        /// background, etc.). The screen size is taken from the root
+        /// operator.
+        CRasterizer &  getRasterizer ( ) { return m_rasterizer; }
+
+        /// Number of frames processed by the last call to run().
+        int         getProcessedFrames ( ) const { return m_frames_i; }
+
+    /// Private methods
+    private:
+        /// Register the device outputs and cycle the root operator.
+        bool        process ( bool f_initialize_b );
+
+        /// Render the drawing lists and write them in the video.
+        bool        writeVideoFrame ( );
+
+    /// Private members
+    private:
+        /// Device.
+        CSeqDeviceControl *       m_device_p;
+
+        /// Root operator.
+        COperator *               m_rootOp_p;
+
+        /// Call show().
+        bool                      m_show_b;
+
+        /// Maximal number of frames.
+        int                       m_maxFrames_i;
+
+        /// Processed frames.
+        int                       m_frames_i;
+
+        /// Wall time of the last run in ms.
+        double                    m_time_d;
+
+        /// Rasterizer for the video output.
+        CRasterizer               m_rasterizer;
+
+        /// Video output path.
+        std::string               m_videoPath_str;
+
+        /// Frame rate of the video output.
+        double                    m_fps_d;
+
+        /// Video writer (opened with the first frame).
+        cv::VideoWriter           m_writer;
+
+        /// Rendered frame.
+        cv::Mat                   m_frame;
+    };
+}
+
+#endif // __BATCHRUNNER_H
@@ -0,0 +1,495 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose.
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+/*@@@**************************************************************************
+* \file  framePipeline.cpp
+* \author Hernan Badino
+* \notes
+*******************************************************************************
+*****             (C) Hernan Badino 2012 - All Rights Reserved            *****
+******************************************************************************/
+
+/* INCLUDES */
+#include <QtCore/QMutexLocker>
+
+#include "framePipeline.h"
+#include "operator.h"
+#include "clockHandler.h"
+#include "clock.h"
+#include "drawingListHandler.h"
+#include "seqDeviceControl.h"
+#include "imageFromFile.h"
+#include "matVector.h"
+#include "io.h"
+
+#if defined HAVE_QGLVIEWER
+#include "glViewer.h"
+#endif
+
+#include <algorithm>
+
+using namespace QCV;
+
+#if defined HAVE_QGLVIEWER
+/// The 3D viewer of the main window (NULL without viewer).
+static CGLViewer * glViewer ( )
+{
+    return dynamic_cast<CGLViewer *> ( COperator::get3DViewer() );
+}
+#endif
+
+namespace
+{
+    /// Copy of a device output.
+    template <class _T>
+    class CValue: public CIOBase
+    {
+    public:
+        CValue ( const _T & f_value )
+                : m_value ( f_value )
+        {
+        }
+
+        _T    m_value;
+    };
+
+    /// Clones of the images of a frame indexed by the source data.
+    /// Outputs sharing an image share the clone as well.
+    typedef std::map<const uchar *, cv::Mat> MatCache_t;
+
+    cv::Mat cloneMat ( const cv::Mat & f_img,
+                       MatCache_t &    fr_cache )
+    {
+        if ( !f_img.data )
+            return f_img;
+
+        MatCache_t::const_iterator it = fr_cache.find ( f_img.data );
+
+        if ( it != fr_cache.end() &&
+             it -> second.size() == f_img.size() &&
+             it -> second.type() == f_img.type() )
+            return it -> second;
+
+        cv::Mat clone = f_img.clone();
+        fr_cache[f_img.data] = clone;
+        return clone;
+    }
+
+    template <class _T>
+    void deepCopy ( _T & /* fr_value */, MatCache_t & /* fr_cache */ )
+    {
+    }
+
+    void deepCopy ( cv::Mat & fr_img, MatCache_t & fr_cache )
+    {
+        fr_img = cloneMat ( fr_img, fr_cache );
+    }
+
+    void deepCopy ( CMatVector & fr_images_v, MatCache_t & fr_cache )
+    {
+        for (unsigned int i = 0; i < fr_images_v.size(); ++i)
+            fr_images_v[i] = cloneMat ( fr_images_v[i], fr_cache );
+    }
+
+    void deepCopy ( CInpImgFromFileVector & fr_images_v, MatCache_t & fr_cache )
+    {
+        for (unsigned int i = 0; i < fr_images_v.size(); ++i)
+            fr_images_v[i].image = cloneMat ( fr_images_v[i].image, fr_cache );
+    }
+
+    /// Copy an output if it is of type _T. Images are deep copied
+    /// only if fr_cache_p is not NULL.
+    template <class _T>
+    bool copyIO ( const std::string &                  f_id_str,
+                  CIOBase *                            f_src_p,
+                  std::map< std::string, CIOBase * > & fr_outputs,
+                  std::vector<CIOBase *> &             fr_values_v,
+                  MatCache_t *                         fr_cache_p )
+    {
+        CIO<_T> * io_p = dynamic_cast< CIO<_T> * > ( f_src_p );
+
+        if ( !io_p || !io_p -> getPtr() )
+            return false;
+
+        CValue<_T> * value_p = new CValue<_T> ( *io_p -> getPtr() );
+
+        if ( fr_cache_p )
+            deepCopy ( value_p -> m_value, *fr_cache_p );
+
+        fr_values_v.push_back ( value_p );
+        fr_outputs[f_id_str] = new CIO<_T> ( &value_p -> m_value );
+
+        return true;
+    }
+}
+
+/// Frame processed and waiting to be published.
+struct CFramePipeline::SDisplayFrame
+{
+    SDisplayFrame()
+#if defined HAVE_QGLVIEWER
+            : lists3D_p (        NULL )
+#endif
+    {
+    }
+
+    /// Copies of the drawing lists.
+    CDrawingListSnapshot      lists;
+
+#if defined HAVE_QGLVIEWER
+    /// Copies of the lists of the 3D viewer.
+    CGLViewer::SLists *       lists3D_p;
+#endif
+
+    /// Copies of the outputs of the root operator.
+    SFrame                    outputs;
+};
+
+CFramePipeline::CFramePipeline ( COperator *         f_rootOp_p,
+                                 CSeqDeviceControl * f_device_p,
+                                 int                 f_queueSize_i )
+        : QThread (                      ),
+          m_rootOp_p (        f_rootOp_p ),
+          m_device_p (        f_device_p ),
+          m_queue (                      ),
+          m_current (                    ),
+          m_displayQueue (               ),
+          m_freeFrames_v (               ),
+          m_published (                  ),
+          m_queueSize_i (              1 ),
+          m_busy_b (               false ),
+          m_publishing_b (         false ),
+          m_signalPending_b (      false ),
+          m_quit_b (               false ),
+          m_publisher (             this ),
+          m_publishClock_p (        NULL )
+{
+    m_publishClock_p = m_rootOp_p -> getClockHandler() -> getClock ( "Publish Drawing Lists", 
+                                                                     m_rootOp_p );
+    setQueueSize ( f_queueSize_i );
+    start();
+    m_publisher.start();
+}
+
+CFramePipeline::~CFramePipeline()
+{
+    m_mutex.lock();
+    m_quit_b = true;
+    m_queueChanged.wakeAll();
+    m_mutex.unlock();
+
+    wait();
+    m_publisher.wait();
+
+    for (unsigned int i = 0; i < m_queue.size(); ++i)
+        deleteFrame ( m_queue[i] );
+
+    m_freeFrames_v.insert ( m_freeFrames_v.end(), 
+                            m_displayQueue.begin(), 
+                            m_displayQueue.end() );
+
+    for (unsigned int i = 0; i < m_freeFrames_v.size(); ++i)
+    {
+        deleteFrame ( m_freeFrames_v[i] -> outputs );
+#if defined HAVE_QGLVIEWER
+        delete m_freeFrames_v[i] -> lists3D_p;
+#endif
+        delete m_freeFrames_v[i];
+    }
+
+    deleteFrame ( m_published );
+
+    /// The root operator might still reference the current copies.
+    m_rootOp_p -> clearIOMap();
+    deleteFrame ( m_current );
+}
+
+bool
+CFramePipeline::setQueueSize ( int f_size_i )
+{
+    if ( f_size_i < 1 )
+        return false;
+
+    QMutexLocker locker ( &m_mutex );
+    m_queueSize_i = f_size_i;
+    m_queueChanged.wakeAll();
+
+    return true;
+}
+
+bool
+CFramePipeline::push ( )
+{
+    IOMap_t devOutput;
+
+    if ( !m_device_p -> registerOutputs ( devOutput ) )
+        return false;
+
+    SFrame frame;
+    bool success_b = copyOutputs ( devOutput, frame, true );
+
+    for (IOMap_t::iterator it = devOutput.begin(); it != devOutput.end(); ++it)
+        delete it -> second;
+
+    if ( !success_b )
+    {
+        deleteFrame ( frame );
+        return false;
+    }
+
+    QMutexLocker locker ( &m_mutex );
+
+    while ( (int) m_queue.size() >= m_queueSize_i )
+        m_queueChanged.wait ( &m_mutex );
+
+    m_queue.push_back ( frame );
+    m_queueChanged.wakeAll();
+
+    return true;
+}
+
+void
+CFramePipeline::flush ( )
+{
+    QMutexLocker locker ( &m_mutex );
+
+    while ( !m_queue.empty() || m_busy_b || 
+            !m_displayQueue.empty() || m_publishing_b )
+        m_queueChanged.wait ( &m_mutex );
+}
+
+void
+CFramePipeline::updateDeviceOutput ( )
+{
+    SFrame outputs;
+
+    m_mutex.lock();
+    std::swap ( outputs, m_published );
+    m_signalPending_b = false;
+    m_mutex.unlock();
+
+    if ( !outputs.outputs.empty() )
+        m_device_p -> updateOutput ( outputs.outputs );
+
+    deleteFrame ( outputs );
+}
+
+void
+CFramePipeline::run()
+{
+    m_mutex.lock();
+
+    while ( 1 )
+    {
+        /// The display queue must have room for the frame.
+        while ( !m_quit_b && 
+                ( m_queue.empty() || (int) m_displayQueue.size() >= m_queueSize_i ) )
+            m_queueChanged.wait ( &m_mutex );
+
+        if ( m_quit_b )
+            break;
+
+        SFrame frame = m_queue.front();
+        m_queue.pop_front();
+
+        SDisplayFrame * display_p;
+
+        if ( m_freeFrames_v.empty() )
+            display_p = new SDisplayFrame;
+        else
+        {
+            display_p = m_freeFrames_v.back();
+            m_freeFrames_v.pop_back();
+        }
+
+        m_busy_b = true;
+        m_queueChanged.wakeAll();
+        m_mutex.unlock();
+
+        process ( frame, *display_p );
+
+        m_mutex.lock();
+        m_displayQueue.push_back ( display_p );
+        m_busy_b = false;
+        m_queueChanged.wakeAll();
+    }
+
+    m_mutex.unlock();
+}
+
+void
+CFramePipeline::process ( SFrame &        fr_frame,
+                          SDisplayFrame & fr_display )
+{
+    QMutexLocker locker ( &m_operatorMutex );
+
+    /// The previous copies are released once they are not referenced
+    /// by the root operator anymore.
+    m_rootOp_p -> clearIOMap();
+    deleteFrame ( m_current );
+
+    m_current = fr_frame;
+
+    m_rootOp_p -> registerOutputs ( m_current.outputs );
+
+    /// Frame number of the trace events.
+    IOMap_t::const_iterator frame_it = m_current.outputs.find ( "Frame Number" );
+    const CIO<int> * frame_p = ( frame_it == m_current.outputs.end() ? NULL :
+                                 dynamic_cast<const CIO<int> *>( frame_it -> second ) );
+
+    COperator::getClockHandler() -> setFrameNumber ( frame_p?*frame_p -> getPtr():-1 );
+
+    /// The root operator owns the registered I/O elements now.
+    m_current.outputs.clear();
+
+    m_rootOp_p -> startClock ( "Cycle" );
+    m_rootOp_p -> cycle();
+    m_rootOp_p -> stopClock ( "Cycle" );
+
+    /// The drawing lists are written, not painted: no draw mutex.
+    m_rootOp_p -> startClock ( "Show" );
+    m_rootOp_p -> show();
+    m_rootOp_p -> stopClock ( "Show" );
+
+    /// The next cycle may change the lists while they are published
+    /// and painted.
+    m_rootOp_p -> startClock ( "Copy Drawing Lists" );
+    m_rootOp_p -> getDrawingListHandler() -> takeSnapshot ( fr_display.lists );
+
+#if defined HAVE_QGLVIEWER
+    if ( glViewer() )
+    {
+        if ( !fr_display.lists3D_p )
+            fr_display.lists3D_p = new CGLViewer::SLists;
+
+        glViewer() -> copyLists ( *fr_display.lists3D_p );
+    }
+#endif
+
+    IOMap_t outputs;
+    m_rootOp_p -> getOutputMap ( outputs );
+
+    deleteFrame ( fr_display.outputs );
+    copyOutputs ( outputs, fr_display.outputs, false );
+    m_rootOp_p -> stopClock ( "Copy Drawing Lists" );
+}
+
+void
+CFramePipeline::publishFrames ( )
+{
+    m_mutex.lock();
+
+    while ( 1 )
+    {
+        while ( !m_quit_b && m_displayQueue.empty() )
+            m_queueChanged.wait ( &m_mutex );
+
+        if ( m_quit_b )
+            break;
+
+        SDisplayFrame * display_p = m_displayQueue.front();
+        m_displayQueue.pop_front();
+
+        m_publishing_b = true;
+        m_queueChanged.wakeAll();
+        m_mutex.unlock();
+
+        m_publishClock_p -> start();
+
+        /// Only the texture upload is left to the GUI thread.
+        display_p -> lists.prepare();
+        m_rootOp_p -> getDrawingListHandler() -> publish ( display_p -> lists );
+
+#if defined HAVE_QGLVIEWER
+        if ( glViewer() && display_p -> lists3D_p )
+            glViewer() -> publish ( display_p -> lists3D_p );
+#endif
+
+        m_publishClock_p -> stop();
+
+        m_mutex.lock();
+
+        /// The outputs replaced are deleted when the frame is reused.
+        std::swap ( m_published, display_p -> outputs );
+
+        m_freeFrames_v.push_back ( display_p );
+        m_publishing_b = false;
+
+        const bool emit_b = !m_signalPending_b;
+        m_signalPending_b = true;
+
+        m_queueChanged.wakeAll();
+        m_mutex.unlock();
+
+        if ( emit_b )
+            emit frameProcessed();
+
+        m_mutex.lock();
+    }
+
+    m_mutex.unlock();
+}
+
+bool
+CFramePipeline::copyOutputs ( const IOMap_t & f_src,
+                              SFrame &        fr_frame,
+                              bool            f_clone_b )
+{
+    MatCache_t   cache;
+    MatCache_t * cache_p = f_clone_b?&cache:NULL;
+    bool         success_b = true;
+
+    for (IOMap_t::const_iterator it = f_src.begin(); it != f_src.end(); ++it)
+    {
+        const std::string & id_str = it -> first;
+        CIOBase *           io_p   = it -> second;
+
+        if ( !copyIO<CInpImgFromFileVector> ( id_str, io_p, fr_frame.outputs, fr_frame.values_v, cache_p ) &&
+             !copyIO<CMatVector>            ( id_str, io_p, fr_frame.outputs, fr_frame.values_v, cache_p ) &&
+             !copyIO<cv::Mat>               ( id_str, io_p, fr_frame.outputs, fr_frame.values_v, cache_p ) &&
+             !copyIO<std::string>           ( id_str, io_p, fr_frame.outputs, fr_frame.values_v, cache_p ) &&
+             !copyIO<double>                ( id_str, io_p, fr_frame.outputs, fr_frame.values_v, cache_p ) &&
+             !copyIO<float>                 ( id_str, io_p, fr_frame.outputs, fr_frame.values_v, cache_p ) &&
+             !copyIO<int>                   ( id_str, io_p, fr_frame.outputs, fr_frame.values_v, cache_p ) &&
+             !copyIO<bool>                  ( id_str, io_p, fr_frame.outputs, fr_frame.values_v, cache_p ) )
+        {
+            if ( f_clone_b )
+                printf("%s:%i Device output \"%s\" cannot be copied for pipelined execution.\n",
+                       __FILE__, __LINE__, id_str.c_str() );
+            success_b = false;
+        }
+    }
+
+    return success_b;
+}
+
+void
+CFramePipeline::deleteFrame ( SFrame & fr_frame )
+{
+    for (IOMap_t::iterator it = fr_frame.outputs.begin(); it != fr_frame.outputs.end(); ++it)
+        delete it -> second;
+
+    for (unsigned int i = 0; i < fr_frame.values_v.size(); ++i)
+        delete fr_frame.values_v[i];
+
+    fr_frame.outputs.clear();
+    fr_frame.values_v.clear();
+}
@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose.
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+#ifndef __FRAMEPIPELINE_H
+#define __FRAMEPIPELINE_H
+
+/**
+ *******************************************************************************
+ *
+ * @file framePipeline.h
+ *
+ * \class CFramePipeline
+ * \author Hernan Badino (hernan.badino@gmail.com)
+ *
+ * \brief Runs the operator cycle in separate threads.
+ *
+ * The outputs of the device are copied into a bounded queue (push()) by
+ * the thread owning the device, so that the device can acquire the next
+ * frame while the previous one is processed. Every queued frame owns its
+ * copy of the device outputs (images are deep copied), so the device can
+ * overwrite its buffers at any time. The copy registered in the root
+ * operator is kept until the next frame is registered.
+ *
+ * The frames then go through two stages, each one in its own thread:
+ *  - The processing thread registers the copies as outputs of the root
+ *    operator and calls cycle() and show(). show() belongs to this stage
+ *    because it reads the state computed by cycle(). The drawing lists
+ *    written by show() are copied into a display frame (see
+ *    CDrawingListHandler::takeSnapshot()), which is queued in a second
+ *    bounded queue.
+ *  - The publishing thread encodes the color encoded images of the
+ *    display frames and publishes them. The GUI thread paints the last
+ *    published frame while the next ones are processed.
+ *
+ * The copies of the drawing lists share the image data with the 
+ * operators (reference counted). An image overwritten in place by the
+ * next cycle might be painted partly updated; images obtained with
+ * COperator::getPooledMat() are not reused while they are referenced.
+ *
+ * The operators are accessed by the processing thread while holding
+ * getOperatorMutex(). Operators must therefore write drawing lists only
+ * in show(). The draw mutex of the drawing list handler is only held to
+ * publish a frame, not while the operators run.
+ *
+ * frameProcessed() is emitted after a frame has been published, unless
+ * the previous signal has not been handled by updateDeviceOutput() yet.
+ * Neither stage waits for the GUI thread.
+ *
+ *******************************************************************************/
+
+/* INCLUDES */
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <QtCore/QThread>
+#include <QtCore/QMutex>
+#include <QtCore/QWaitCondition>
+
+/* CONSTANTS */
+
+namespace QCV
+{
+    /* PROTOTYPES */
+    class COperator;
+    class CSeqDeviceControl;
+    class CIOBase;
+    class CClock;
+
+    class CFramePipeline: public QThread
+    {
+        Q_OBJECT
+
+    /// Constructors, Destructors
+    public:
+        CFramePipeline ( COperator *         f_rootOp_p,
+                         CSeqDeviceControl * f_device_p,
+                         int                 f_queueSize_i = 1 );
+
+        virtual ~CFramePipeline();
+
+    /// Operations.
+    public:
+        /// Copy the current outputs of the device and queue them.
+        /// Blocks while the queue is full. Returns false if an output
+        /// could not be copied. The frame must then be processed by the
+        /// caller (after calling flush()).
+        bool        push ( );
+
+        /// Wait until all queued frames have been processed and
+        /// published.
+        void        flush ( );
+
+        /// Give the outputs of the root operator of the last published
+        /// frame to the device (see CSeqDeviceControl::updateOutput()).
+        /// Only outputs of the types copied by push() are given, images
+        /// share their data. Call after frameProcessed() in the thread 
+        /// owning the device.
+        void        updateDeviceOutput ( );
+
+    /// Get/Set
+    public:
+        /// Mutex held while the processing thread uses the operators.
+        QMutex *    getOperatorMutex ( ) { return &m_operatorMutex; }
+
+        /// Maximal number of frames waiting to be processed and of
+        /// frames waiting to be published.
+        bool        setQueueSize ( int f_size_i );
+        int         getQueueSize ( ) const { return m_queueSize_i; }
+
+    /// Signals
+    signals:
+        /// A frame has been processed.
+        void        frameProcessed ( );
+
+    /// Protected methods
+    protected:
+        virtual void run();
+
+    /// Private data types
+    private:
+        typedef std::map< std::string, CIOBase * > IOMap_t;
+
+        struct SFrame
+        {
+            /// I/O elements to register in the root operator.
+            IOMap_t                   outputs;
+
+            /// Copies of the device outputs.
+            std::vector<CIOBase *>    values_v;
+        };
+
+        /// Processed frame waiting to be published.
+        struct SDisplayFrame;
+
+        /// Thread running the publishing stage.
+        class CPublisher: public QThread
+        {
+        public:
+            CPublisher ( CFramePipeline * f_pipeline_p )
+                    : m_pipeline_p ( f_pipeline_p ) {}
+
+        protected:
+            virtual void run() { m_pipeline_p -> publishFrames(); }
+
+        private:
+            CFramePipeline *      m_pipeline_p;
+        };
+
+    /// Private methods
+    private:
+        /// Copy I/O elements. Images are deep copied if f_clone_b is
+        /// true. Returns false if an element could not be copied; the 
+        /// others are copied anyway.
+        static bool    copyOutputs ( const IOMap_t & f_src,
+                                     SFrame &        fr_frame,
+                                     bool            f_clone_b );
+
+        /// Delete the copies of a frame.
+        static void    deleteFrame ( SFrame & fr_frame );
+
+        /// Cycle and show a frame and copy the drawing lists.
+        void           process ( SFrame &        fr_frame,
+                                 SDisplayFrame & fr_display );
+
+        /// Loop of the publishing thread.
+        void           publishFrames ( );
+
+    /// Private members
+    private:
+        /// Root operator.
+        COperator *               m_rootOp_p;
+
+        /// Device.
+        CSeqDeviceControl *       m_device_p;
+
+        /// Frames waiting to be processed.
+        std::deque<SFrame>        m_queue;
+
+        /// Frame currently registered in the root operator.
+        SFrame                    m_current;
+
+        /// Frames waiting to be published.
+        std::deque<SDisplayFrame *>   m_displayQueue;
+
+        /// Display frames for reuse.
+        std::vector<SDisplayFrame *>  m_freeFrames_v;
+
+        /// Outputs of the root operator of the last published frame.
+        SFrame                    m_published;
+
+        /// Maximal number of frames in each queue.
+        int                       m_queueSize_i;
+
+        /// A frame is being processed.
+        bool                      m_busy_b;
+
+        /// A frame is being published.
+        bool                      m_publishing_b;
+
+        /// frameProcessed() has not been handled yet.
+        bool                      m_signalPending_b;
+
+        /// Terminate the threads.
+        bool                      m_quit_b;
+
+        /// Protects the queues and flags.
+        QMutex                    m_mutex;
+
+        /// Signaled when the queues or the flags change.
+        QWaitCondition            m_queueChanged;
+
+        /// Held while processing a frame.
+        QMutex                    m_operatorMutex;
+
+        /// Publishing thread.
+        CPublisher                m_publisher;
+
+        /// Clock of the publishing stage.
+        CClock *                  m_publishClock_p;
+    };
+}
+
+#endif // __FRAMEPIPELINE_H
@@ -0,0 +1,276 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose.
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+/*@@@**************************************************************************
+* \file  imagePrefetcher.cpp
+* \author Hernan Badino
+* \notes
+*******************************************************************************
+*****             (C) Hernan Badino 2012 - All Rights Reserved            *****
+******************************************************************************/
+
+/* INCLUDES */
+#include <set>
+
+#include <QtCore/QRunnable>
+#include <QtCore/QMutexLocker>
+#include <opencv/highgui.h>
+
+#include "imagePrefetcher.h"
+
+using namespace QCV;
+
+/// Decoding job of a single frame.
+class CImagePrefetcher::CDecodeTask: public QRunnable
+{
+public:
+    CDecodeTask ( CImagePrefetcher * f_owner_p,
+                  int                f_frame_i,
+                  unsigned int       f_ticket_ui )
+            : m_owner_p (     f_owner_p ),
+              m_frame_i (     f_frame_i ),
+              m_ticket_ui ( f_ticket_ui )
+    {
+    }
+
+    virtual void run()
+    {
+        m_owner_p -> decode ( m_frame_i, m_ticket_ui );
+    }
+
+private:
+    CImagePrefetcher *  m_owner_p;
+    int                 m_frame_i;
+    unsigned int        m_ticket_ui;
+};
+
+CImagePrefetcher::CImagePrefetcher ( int    f_numThreads_i,
+                                     size_t f_maxBytes_ui )
+        : m_ticket_ui (                0 ),
+          m_maxBytes_ui (   f_maxBytes_ui ),
+          m_usedBytes_ui (             0 ),
+          m_frameBytes_ui (            0 )
+{
+    setNumThreads ( f_numThreads_i );
+}
+
+CImagePrefetcher::~CImagePrefetcher()
+{
+    clear();
+    m_pool.waitForDone();
+}
+
+int
+CImagePrefetcher::schedule ( const std::vector<int> &                       f_frames_v,
+                             const std::vector<std::vector<std::string> > & f_paths_v )
+{
+    QMutexLocker locker ( &m_mutex );
+
+    std::set<int> wanted ( f_frames_v.begin(), f_frames_v.end() );
+
+    /// Drop the frames that are not needed anymore. Pending decodings
+    /// of these frames are cancelled when they do not find their
+    /// ticket.
+    int pending_i = 0;
+    for (FrameMap_t::iterator it = m_frames.begin(); it != m_frames.end(); )
+    {
+        if ( wanted.find ( it->first ) == wanted.end() )
+        {
+            if ( it->second.state_e == FS_READY )
+                m_usedBytes_ui -= it->second.bytes_ui;
+
+            m_frames.erase ( it++ );
+        }
+        else
+        {
+            if ( it->second.state_e != FS_READY )
+                ++pending_i;
+            ++it;
+        }
+    }
+
+    /// Queue new frames while the memory budget allows it. The size
+    /// of the frames being decoded is estimated from the last one.
+    size_t reserved_ui = m_usedBytes_ui + pending_i * m_frameBytes_ui;
+    int    queued_i    = 0;
+
+    for (unsigned int i = 0; i < f_frames_v.size() && i < f_paths_v.size(); ++i)
+    {
+        if ( m_frames.find ( f_frames_v[i] ) != m_frames.end() )
+            continue;
+
+        if ( m_frameBytes_ui == 0 ? pending_i > 0 :
+             reserved_ui + m_frameBytes_ui > m_maxBytes_ui )
+            break;
+
+        SFrame & frame = m_frames[f_frames_v[i]];
+        frame.state_e   = FS_QUEUED;
+        frame.ticket_ui = ++m_ticket_ui;
+        frame.paths_v   = f_paths_v[i];
+        frame.bytes_ui  = 0;
+
+        m_pool.start ( new CDecodeTask ( this, f_frames_v[i], frame.ticket_ui ) );
+
+        reserved_ui += m_frameBytes_ui;
+        ++pending_i;
+        ++queued_i;
+    }
+
+    return queued_i;
+}
+
+bool
+CImagePrefetcher::take ( int                    f_frame_i,
+                         std::vector<cv::Mat> & fr_images_v )
+{
+    QMutexLocker locker ( &m_mutex );
+
+    FrameMap_t::iterator it = m_frames.find ( f_frame_i );
+
+    if ( it == m_frames.end() )
+        return false;
+
+    /// Not started yet: the caller is faster reading it itself.
+    if ( it->second.state_e == FS_QUEUED )
+    {
+        m_frames.erase ( it );
+        return false;
+    }
+
+    while ( it->second.state_e == FS_DECODING )
+    {
+        m_decoded.wait ( &m_mutex );
+
+        it = m_frames.find ( f_frame_i );
+        if ( it == m_frames.end() )
+            return false;
+    }
+
+    fr_images_v     = it->second.images_v;
+    m_usedBytes_ui -= it->second.bytes_ui;
+    m_frames.erase ( it );
+
+    return true;
+}
+
+bool
+CImagePrefetcher::isAvailable ( int f_frame_i ) const
+{
+    QMutexLocker locker ( &m_mutex );
+
+    FrameMap_t::const_iterator it = m_frames.find ( f_frame_i );
+
+    return ( it != m_frames.end() && it->second.state_e != FS_QUEUED );
+}
+
+void
+CImagePrefetcher::clear ( )
+{
+    QMutexLocker locker ( &m_mutex );
+
+    m_frames.clear();
+    m_usedBytes_ui = 0;
+    m_decoded.wakeAll();
+}
+
+void
+CImagePrefetcher::decode ( int          f_frame_i,
+                           unsigned int f_ticket_ui )
+{
+    std::vector<std::string> paths_v;
+
+    {
+        QMutexLocker locker ( &m_mutex );
+
+        FrameMap_t::iterator it = m_frames.find ( f_frame_i );
+
+        /// Cancelled?
+        if ( it == m_frames.end() ||
+             it->second.ticket_ui != f_ticket_ui ||
+             it->second.state_e   != FS_QUEUED )
+            return;
+
+        it->second.state_e = FS_DECODING;
+        paths_v = it->second.paths_v;
+    }
+
+    std::vector<cv::Mat> images_v ( paths_v.size() );
+    size_t               bytes_ui = 0;
+
+    for (unsigned int i = 0; i < paths_v.size(); ++i)
+    {
+        if ( paths_v[i].empty() ) continue;
+
+        images_v[i] = cv::imread ( paths_v[i], -1 );
+        bytes_ui   += images_v[i].total() * images_v[i].elemSize();
+    }
+
+    QMutexLocker locker ( &m_mutex );
+
+    FrameMap_t::iterator it = m_frames.find ( f_frame_i );
+
+    if ( it != m_frames.end() && it->second.ticket_ui == f_ticket_ui )
+    {
+        it->second.state_e  = FS_READY;
+        it->second.images_v = images_v;
+        it->second.bytes_ui = bytes_ui;
+
+        m_usedBytes_ui     += bytes_ui;
+    }
+
+    if ( bytes_ui > 0 )
+        m_frameBytes_ui = bytes_ui;
+
+    m_decoded.wakeAll();
+}
+
+bool
+CImagePrefetcher::setNumThreads ( int f_numThreads_i )
+{
+    if ( f_numThreads_i < 1 )
+        return false;
+
+    m_pool.setMaxThreadCount ( f_numThreads_i );
+    return true;
+}
+
+int
+CImagePrefetcher::getNumThreads ( ) const
+{
+    return m_pool.maxThreadCount();
+}
+
+bool
+CImagePrefetcher::setMaxBytes ( size_t f_maxBytes_ui )
+{
+    QMutexLocker locker ( &m_mutex );
+
+    m_maxBytes_ui = f_maxBytes_ui;
+    return true;
+}
+
+size_t
+CImagePrefetcher::getUsedBytes ( ) const
+{
+    QMutexLocker locker ( &m_mutex );
+
+    return m_usedBytes_ui;
+}
@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose.
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+#ifndef __IMAGEPREFETCHER_H
+#define __IMAGEPREFETCHER_H
+
+/**
+ *******************************************************************************
+ *
+ * @file imagePrefetcher.h
+ *
+ * \class CImagePrefetcher
+ * \author Hernan Badino (hernan.badino@gmail.com)
+ *
+ * \brief Decodes the images of upcoming frames in background threads.
+ *
+ * The owner calls schedule() with the list of frames that will be
+ * requested next (nearest first) and take() when a frame is
+ * needed. Frames are decoded by a private thread pool. Frames not
+ * included in the last call to schedule() are dropped and their
+ * pending decodings are cancelled. The memory of the decoded images
+ * is bounded by setMaxBytes().
+ *
+ *******************************************************************************/
+
+/* INCLUDES */
+#include <map>
+#include <vector>
+#include <string>
+
+#include <QtCore/QMutex>
+#include <QtCore/QWaitCondition>
+#include <QtCore/QThreadPool>
+
+#include <opencv/cv.h>
+
+/* CONSTANTS */
+
+namespace QCV
+{
+    class CImagePrefetcher
+    {
+    /// Constructors, Destructors
+    public:
+        /// Constructor
+        CImagePrefetcher ( int    f_numThreads_i = 2,
+                           size_t f_maxBytes_ui  = 256 * 1024 * 1024 );
+
+        /// Destructor
+        virtual ~CImagePrefetcher();
+
+    /// Operations.
+    public:
+        /// Set the frames to prefetch. f_frames_v is sorted by priority
+        /// and f_paths_v holds the image paths of every frame (empty
+        /// paths are not decoded). Returns the number of frames queued.
+        int    schedule ( const std::vector<int> &                       f_frames_v,
+                          const std::vector<std::vector<std::string> > & f_paths_v );
+
+        /// Get the images of a frame if they have been decoded or are
+        /// being decoded. Returns false if the frame must be read by
+        /// the caller.
+        bool   take ( int                    f_frame_i,
+                      std::vector<cv::Mat> & fr_images_v );
+
+        /// Is the frame decoded or being decoded?
+        bool   isAvailable ( int f_frame_i ) const;
+
+        /// Remove all frames and cancel all pending work.
+        void   clear ( );
+
+    /// Get/Set
+    public:
+        /// Set the number of decoding threads.
+        bool   setNumThreads ( int f_numThreads_i );
+        int    getNumThreads ( ) const;
+
+        /// Set the maximal memory in bytes of the decoded images.
+        bool   setMaxBytes ( size_t f_maxBytes_ui );
+        size_t getMaxBytes ( ) const { return m_maxBytes_ui; }
+
+        /// Get the memory in bytes of the decoded images.
+        size_t getUsedBytes ( ) const;
+
+    /// Private data types.
+    private:
+        class CDecodeTask;
+        friend class CDecodeTask;
+
+        typedef enum
+        {
+            FS_QUEUED,
+            FS_DECODING,
+            FS_READY
+        } EFrameState;
+
+        struct SFrame
+        {
+            /// State of the frame.
+            EFrameState                  state_e;
+
+            /// Identifier of the request.
+            unsigned int                 ticket_ui;
+
+            /// Image paths.
+            std::vector<std::string>     paths_v;
+
+            /// Decoded images.
+            std::vector<cv::Mat>         images_v;
+
+            /// Size of the decoded images.
+            size_t                       bytes_ui;
+        };
+
+        typedef std::map<int, SFrame>    FrameMap_t;
+
+    /// Private methods.
+    private:
+        /// Run by the decoding threads.
+        void   decode ( int          f_frame_i,
+                        unsigned int f_ticket_ui );
+
+    /// Private members.
+    private:
+        /// Decoding threads.
+        QThreadPool                      m_pool;
+
+        /// Protects all members below.
+        mutable QMutex                   m_mutex;
+
+        /// Signaled when a frame has been decoded.
+        QWaitCondition                   m_decoded;
+
+        /// Scheduled frames.
+        FrameMap_t                       m_frames;
+
+        /// Next request identifier.
+        unsigned int                     m_ticket_ui;
+
+        /// Maximal memory of the decoded images.
+        size_t                           m_maxBytes_ui;
+
+        /// Memory of the decoded images.
+        size_t                           m_usedBytes_ui;
+
+        /// Size of the last decoded frame.
+        size_t                           m_frameBytes_ui;
+    };
+}
+
+#endif // __IMAGEPREFETCHER_H
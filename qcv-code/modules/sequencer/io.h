@@ -51,6 +51,20 @@ namespace QCV
     private:
         _T *  m_ptr;
     };
+
+    /// Entry of an I/O id in an operator. The slot is kept when the
+    /// element is removed so that pointers to it stay valid.
+    struct SIOSlot
+    {
+        SIOSlot ( ) : io_p ( 0 ), version_ui ( 0 ) {}
+
+        /// Element (NULL if not registered).
+        CIOBase *     io_p;
+
+        /// Version of the element. Every registration gets a new
+        /// version, unique over all slots.
+        unsigned int  version_ui;
+    };
 }
 
 #endif //  __IOBASE_H
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose. 
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+/*@@@**************************************************************************
+ * \file  ioPort
+ * \author Hernan Badino
+ * \notes 
+ *******************************************************************************
+ *****             (C) Hernan Badino 2012 - All Rights Reserved            *****
+ ******************************************************************************/
+
+/* INCLUDES */
+#include "ioPort.h"
+#include "operator.h"
+
+using namespace QCV;
+
+CIOPortBase::CIOPortBase ( )
+    : m_op_p (              NULL ),
+      m_id_str (                 ),
+      m_key_i (               -1 ),
+      m_slots_v (                ),
+      m_generation_i (         0 ),
+      m_resolved_b (       false ),
+      m_seenVersion_ui (       0 )
+{
+}
+
+void
+CIOPortBase::bind ( const COperator *   f_op_p,
+                    const std::string & f_id_str )
+{
+    if ( f_op_p == m_op_p && f_id_str == m_id_str )
+        return;
+
+    m_op_p       = f_op_p;
+    m_id_str     = f_id_str;
+    m_key_i      = f_op_p ? COperator::getIOKey ( f_id_str ) : -1;
+    m_resolved_b = false;
+    m_slots_v.clear();
+}
+
+void
+CIOPortBase::resolve ( )
+{
+    m_slots_v.clear();
+
+    for ( const COperator * op_p = m_op_p; op_p; op_p = op_p -> getParentOp() )
+    {
+        SIOSlot * slot_p = op_p -> findIOSlot ( m_key_i );
+
+        if ( slot_p )
+            m_slots_v.push_back ( slot_p );
+    }
+
+    m_generation_i  = COperator::m_ioGeneration;
+    m_resolved_b    = true;
+}
+
+CIOBase *
+CIOPortBase::find ( unsigned int & fr_version_ui )
+{
+    fr_version_ui = 0;
+
+    if ( !m_op_p )
+        return NULL;
+
+    /// The slots are looked up again under the lock only if an
+    /// operator added a slot or was deleted. Slots are never moved,
+    /// so the cached ones can be read without locking.
+    if ( !m_resolved_b || m_generation_i != (int) COperator::m_ioGeneration )
+    {
+        COperator::CIOLock locker;
+        resolve();
+    }
+
+    /// The nearest registered element, as in COperator::getInput().
+    for (unsigned int i = 0; i < m_slots_v.size(); ++i)
+    {
+        if ( m_slots_v[i] -> io_p )
+        {
+            fr_version_ui = m_slots_v[i] -> version_ui;
+            return m_slots_v[i] -> io_p;
+        }
+    }
+
+    return NULL;
+}
+
+unsigned int
+CIOPortBase::getVersion ( )
+{
+    unsigned int version_ui;
+    find ( version_ui );
+
+    return version_ui;
+}
+
+bool
+CIOPortBase::hasChanged ( )
+{
+    const unsigned int version_ui = getVersion();
+    const bool changed_b = ( version_ui != m_seenVersion_ui );
+
+    m_seenVersion_ui = version_ui;
+
+    return changed_b;
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose. 
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+#ifndef __IOPORT_H
+#define __IOPORT_H
+
+/**
+ *******************************************************************************
+ *
+ * @file ioPort.h
+ *
+ * \class CIOPortBase
+ * \author Hernan Badino (hernan.badino@gmail.com)
+ *
+ * \brief Cached access to an input of an operator.
+ *
+ * A port is bound once to an operator and an I/O id. The id is interned
+ * to an integer key and the slots holding it in the operator and its
+ * parents are looked up the first time the port is used, and again only
+ * when an operator adds a new id or is deleted. Reading the input
+ * afterwards does not involve any string comparison, map lookup or lock.
+ * Every registration of an output gets a new version, so that a
+ * consumer can check whether an input was produced again since the last
+ * cycle. The string based COperator::getInput() keeps working.
+ *
+ *******************************************************************************/
+
+/* INCLUDES */
+#include <string>
+#include <vector>
+
+#include "io.h"
+
+/* CONSTANTS */
+
+namespace QCV
+{
+    class COperator;
+
+    class CIOPortBase
+    {
+    /// Constructor.
+    public:
+        CIOPortBase ( );
+
+    /// Binding.
+    public:
+        /// Bind the port to the input f_id_str of the given operator.
+        /// Binding again to the same operator and id does nothing.
+        void              bind ( const COperator *   f_op_p,
+                                 const std::string & f_id_str );
+
+        /// Is the port bound?
+        bool              isBound ( ) const { return m_op_p != NULL; }
+
+        /// Get id.
+        const std::string & getId ( ) const { return m_id_str; }
+
+        /// Get interned key of the id (-1 if not bound).
+        int               getKey ( ) const { return m_key_i; }
+
+    /// Versions.
+    public:
+        /// Version of the input (0 if not available).
+        unsigned int      getVersion ( );
+
+        /// Has the input been registered again since the last call?
+        bool              hasChanged ( );
+
+    /// Protected methods.
+    protected:
+        /// Current element of the input (NULL if not available) and
+        /// its version.
+        CIOBase *         find ( unsigned int & fr_version_ui );
+
+    /// Private methods.
+    private:
+        /// Look up the slots of the id in the operator and its parents.
+        void              resolve ( );
+
+    /// Private members.
+    private:
+        /// Operator.
+        const COperator *         m_op_p;
+
+        /// Id.
+        std::string               m_id_str;
+
+        /// Interned id.
+        int                       m_key_i;
+
+        /// Slots of the id from the operator to the root.
+        std::vector<SIOSlot *>    m_slots_v;
+
+        /// I/O generation of the slots.
+        int                       m_generation_i;
+
+        /// Have the slots been looked up?
+        bool                      m_resolved_b;
+
+        /// Version returned by the last call to hasChanged().
+        unsigned int              m_seenVersion_ui;
+    };
+
+    /**
+     * \class CIOPort
+     * \brief Typed port. The element is cast once per version.
+     */
+    template <class _T>
+    class CIOPort: public CIOPortBase
+    {
+    public:
+        CIOPort ( )
+                : CIOPortBase (      ),
+                  m_io_p (      NULL ),
+                  m_version_ui (    0 )
+        {
+        }
+
+        /// Get the input (NULL if not available or of other type).
+        _T *              get ( )
+        {
+            unsigned int version_ui;
+            CIOBase * io_p = find ( version_ui );
+
+            if ( !io_p )
+                return NULL;
+
+            if ( version_ui != m_version_ui )
+            {
+                m_io_p       = dynamic_cast< CIO<_T> * > ( io_p );
+                m_version_ui = version_ui;
+            }
+
+            return m_io_p ? m_io_p -> getPtr() : NULL;
+        }
+
+        /// Get the input or the given default if not available.
+        const _T &        get ( const _T & f_default )
+        {
+            const _T * ptr_p = get();
+
+            return ptr_p ? *ptr_p : f_default;
+        }
+
+    private:
+        /// Element of the last version.
+        CIO<_T> *         m_io_p;
+
+        /// Version of m_io_p.
+        unsigned int      m_version_ui;
+    };
+}
+
+#endif // __IOPORT_H
@@ -32,6 +32,8 @@
 /* INCLUDES */
 #include <QSettings>
 #include <QFileInfo>
+#include <QMutexLocker>
+#include <QKeyEvent>
 
 #include "mainWindow.h"
 
@@ -45,6 +47,8 @@
 #include "displayWidget.h"
 #include "paramEditorDlg.h"
 #include "clockTreeDlg.h"
+#include "clockHandler.h"
+#include "framePipeline.h"
 #include "io.h"
 
 #if defined HAVE_QGLVIEWER
@@ -62,14 +66,22 @@ CMainWindow::CMainWindow ( CSeqDeviceControl * f_device_p,
       m_display_p (            NULL ),
       m_paramEditorDlg_p (     NULL ),
       m_clockTreeDlg_p (       NULL ),
-      m_autoPlay_b (          false )
+      m_autoPlay_b (          false ),
+      m_pipeline_p (           NULL ),
+      m_clockStatsFile_str (         )
 {
     QStringList list = QCoreApplication::arguments ();
 
+    bool pipelined_b = false;
+
     for (int i = 1; i < list.size(); ++i)
     {
         if ( list.at(i) == QString("--autoplay") )
             m_autoPlay_b = true;
+        else if ( list.at(i) == QString("--pipelined") )
+            pipelined_b = true;
+        else if ( list.at(i) == QString("--clock-stats") && i+1 < list.size() )
+            m_clockStatsFile_str = list.at(++i).toStdString();
     }
     
     setWindowTitle( tr("QCV Main Window") );
@@ -77,6 +89,8 @@ CMainWindow::CMainWindow ( CSeqDeviceControl * f_device_p,
 
     createBaseWidgets();
 
+    setPipelined ( pipelined_b );
+
     /// Load number of screens for this app
     QSettings qSettings;
     QString appName_str = QFileInfo( QCoreApplication::applicationFilePath() ).fileName();
@@ -96,6 +110,9 @@ CMainWindow::CMainWindow ( CSeqDeviceControl * f_device_p,
 
 CMainWindow::~CMainWindow( )
 {    
+    /// Stop the processing thread first.
+    setPipelined ( false );
+
     /// Save number of screens for this app
     QSettings qSettings;
     QString appName_str = QFileInfo( QCoreApplication::applicationFilePath() ).fileName();
@@ -149,6 +166,10 @@ void CMainWindow::createBaseWidgets()
     m_paramEditorDlg_p = new CParameterEditorDlg ( m_rootOp_p -> getParameterSet(),
                                                    NULL );
 
+    /// Register the device clocks before the tree is built.
+    m_device_p -> registerClocks ( m_rootOp_p -> getClockHandler(),
+                                   m_rootOp_p );
+
     /// Create clock tree dialog.
     m_clockTreeDlg_p   = new CClockTreeDlg ( NULL,
                                              m_rootOp_p -> getClockHandler() -> getRootNode() );
@@ -156,6 +177,7 @@ void CMainWindow::createBaseWidgets()
     /// Create the 3D viewer
 #if defined HAVE_QGLVIEWER
     m_3dViewer_p       = new CGLViewer;
+    m_3dViewer_p -> setDrawMutex ( m_rootOp_p -> getDrawingListHandler() -> getDrawMutex() );
     m_rootOp_p -> set3DViewer ( m_3dViewer_p );
 #endif
 
@@ -212,6 +234,9 @@ void CMainWindow::createBaseWidgets()
 void CMainWindow::initialize() 
 {     
     //exit(1);
+
+    if ( m_pipeline_p )
+        m_pipeline_p -> flush();
     
     if ( not m_device_p -> isInitialized() )
     {
@@ -246,6 +271,8 @@ void CMainWindow::initialize()
         m_rootOp_p -> startClock ( "Show" );
         m_rootOp_p -> show();
         m_rootOp_p -> stopClock ( "Show" );
+
+        publishDrawings();
     }
 
     m_display_p -> setScreenSize ( m_rootOp_p -> getScreenSize() );
@@ -287,6 +314,28 @@ void CMainWindow::cycle()
         return;
     }
 
+    /// Only frames delivered while playing are queued. Single steps
+    /// and seeks are processed here after the queued frames.
+    if ( m_pipeline_p && 
+         m_device_p -> getState() != CSeqDeviceControl::S_PAUSED )
+    {
+        m_rootOp_p -> startClock ( "Pipeline Push" );
+        bool queued_b = m_pipeline_p -> push();
+        m_rootOp_p -> stopClock ( "Pipeline Push" );
+        
+        if ( queued_b )
+        {
+            m_rootOp_p -> startClock ( "Out of cycle" );
+            return;
+        }
+
+        printf("%s:%i Pipelined execution disabled.\n", __FILE__, __LINE__);
+        setPipelined ( false );
+    }
+
+    if ( m_pipeline_p )
+        m_pipeline_p -> flush();
+
     bool success_b;
     
     std::map< std::string, CIOBase * > devOutput;
@@ -305,6 +354,8 @@ void CMainWindow::cycle()
         m_rootOp_p -> startClock ( "Show" );
         m_rootOp_p -> show();
         m_rootOp_p -> stopClock ( "Show" );
+
+        publishDrawings();
     }
 
     m_display_p -> setScreenSize ( m_rootOp_p -> getScreenSize() );
@@ -334,6 +385,9 @@ void CMainWindow::cycle()
 
 void CMainWindow::stop() 
 {
+    if ( m_pipeline_p )
+        m_pipeline_p -> flush();
+
     if ( not m_device_p -> isInitialized() )
     {
         printf("%s:%i Device %s not initialized\n", __FILE__, __LINE__, m_device_p ->getName().c_str());
@@ -366,6 +420,8 @@ void CMainWindow::stop()
         m_rootOp_p -> startClock ( "Show" );
         m_rootOp_p -> show();
         m_rootOp_p -> stopClock ( "Show" );
+
+        publishDrawings();
     } 
 
     m_display_p -> setScreenSize ( m_rootOp_p -> getScreenSize() );
@@ -391,6 +447,70 @@ void CMainWindow::stop()
     m_rootOp_p -> stopClock ( "Device output update" );
 }
 
+void CMainWindow::setPipelined ( bool f_val_b )
+{
+    if ( f_val_b == ( m_pipeline_p != NULL ) )
+        return;
+
+    if ( f_val_b )
+    {
+        m_pipeline_p = new CFramePipeline ( m_rootOp_p, m_device_p );
+
+        connect( m_pipeline_p, SIGNAL(frameProcessed()), 
+                 this,         SLOT(frameProcessed()), Qt::QueuedConnection );
+    }
+    else
+    {
+        /// Process the pending frames before deleting the pipeline.
+        m_pipeline_p -> flush();
+        delete m_pipeline_p;
+        m_pipeline_p = NULL;
+    }
+}
+
+QMutex * CMainWindow::getOperatorMutex() const
+{
+    return m_pipeline_p?m_pipeline_p->getOperatorMutex():NULL;
+}
+
+void CMainWindow::publishDrawings()
+{
+    m_rootOp_p -> getDrawingListHandler() -> publish();
+
+#if defined HAVE_QGLVIEWER
+    m_3dViewer_p -> publish();
+#endif
+}
+
+void CMainWindow::frameProcessed() 
+{
+    /// The pipeline might have been deleted since the signal was 
+    /// emitted.
+    if ( m_pipeline_p )
+    {
+        m_rootOp_p -> startClock ( "Device output update" );
+        m_pipeline_p -> updateDeviceOutput();
+        m_rootOp_p -> stopClock ( "Device output update" );
+    }
+
+    m_display_p -> setScreenSize ( m_rootOp_p -> getScreenSize() );
+
+    m_rootOp_p -> startClock ( "OpenGL Display" );
+    if ( m_display_p->isVisible() )
+    m_display_p -> update();
+    m_rootOp_p -> stopClock ( "OpenGL Display" );
+    
+#if defined HAVE_QGLVIEWER
+    m_rootOp_p -> startClock ( "3D Viewer" );
+    m_3dViewer_p -> update();
+    m_rootOp_p -> stopClock ( "3D Viewer" );
+#endif
+
+    m_rootOp_p -> startClock ( "Clock Update" );
+    m_clockTreeDlg_p -> updateTimes();
+    m_rootOp_p -> stopClock ( "Clock Update" );	
+}
+
 void CMainWindow::keyPressed ( CKeyEvent * const f_event_p )
 {
     if ( not m_device_p -> isInitialized() )
@@ -436,7 +556,11 @@ void CMainWindow::keyPressed ( CKeyEvent * const f_event_p )
         }
     }
 
-    m_rootOp_p -> keyPressed ( f_event_p );
+    {
+        QMutexLocker locker ( getOperatorMutex() );
+        m_rootOp_p -> keyPressed ( f_event_p );
+        publishDrawings();
+    }
     if ( m_display_p->isVisible() )
     m_display_p -> update ( false );
 }
@@ -447,7 +571,11 @@ CMainWindow::mousePressed   ( CMouseEvent *  f_event_p )
     if ( not m_device_p -> isInitialized() )
         return;
 
-    m_rootOp_p -> mousePressed ( f_event_p );
+    {
+        QMutexLocker locker ( getOperatorMutex() );
+        m_rootOp_p -> mousePressed ( f_event_p );
+        publishDrawings();
+    }
 
     if ( m_display_p->isVisible() )
     m_display_p -> update ( false );
@@ -462,7 +590,11 @@ CMainWindow::mouseReleased  ( CMouseEvent *  f_event_p )
         return;
     }
 
-    m_rootOp_p -> mouseReleased ( f_event_p );
+    {
+        QMutexLocker locker ( getOperatorMutex() );
+        m_rootOp_p -> mouseReleased ( f_event_p );
+        publishDrawings();
+    }
 
     if ( m_display_p->isVisible() )
     m_display_p -> update ( false );
@@ -476,7 +608,11 @@ void CMainWindow::mouseMoved     ( CMouseEvent *  f_event_p )
         return;
     }
 
-    m_rootOp_p -> mouseMoved ( f_event_p );
+    {
+        QMutexLocker locker ( getOperatorMutex() );
+        m_rootOp_p -> mouseMoved ( f_event_p );
+        publishDrawings();
+    }
 
     if ( m_display_p->isVisible() )
     m_display_p -> update ( false );
@@ -490,7 +626,11 @@ void CMainWindow::wheelTurned    ( CWheelEvent *  f_event_p )
         return;
     }
 
-    m_rootOp_p ->wheelTurned  ( f_event_p );
+    {
+        QMutexLocker locker ( getOperatorMutex() );
+        m_rootOp_p ->wheelTurned  ( f_event_p );
+        publishDrawings();
+    }
 
     if ( m_display_p->isVisible() )
     m_display_p -> update ( false );
@@ -504,7 +644,11 @@ void CMainWindow::regionSelected ( CRegionSelectedEvent *  f_event_p )
         return;
     }
 
-    m_rootOp_p -> regionSelected ( f_event_p );
+    {
+        QMutexLocker locker ( getOperatorMutex() );
+        m_rootOp_p -> regionSelected ( f_event_p );
+        publishDrawings();
+    }
 
     if ( m_display_p->isVisible() )
     m_display_p -> update ( false );
@@ -512,10 +656,15 @@ void CMainWindow::regionSelected ( CRegionSelectedEvent *  f_event_p )
 
 void CMainWindow::closeEvent ( QCloseEvent *  f_event_p)
 {
+    setPipelined ( false );
+
     m_rootOp_p -> startClock ( "Exit" );
     m_rootOp_p -> exit();
     m_rootOp_p -> stopClock ( "Exit" );
 
+    if ( !m_clockStatsFile_str.empty() )
+        COperator::getClockHandler() -> writeStatistics ( m_clockStatsFile_str );
+
     f_event_p->accept();
     qApp->quit();
 }
@@ -37,11 +37,21 @@
  * between all those components. A pointer to the root operator must be given 
  * in the instantiation of the object.
  *
+ * In pipelined mode (setPipelined() or --pipelined in the command line)
+ * the operators are cycled in a separate thread while the device
+ * acquires the next frame and the display shows the previous one (see
+ * CFramePipeline). Single steps, seeks and stops wait for the queued
+ * frames to be processed, so that they are applied in order. User events
+ * are passed to the operators between two frames.
+ *
  *******************************************************************************/
 
 /* INCLUDES */
 
 #include <QtCore/QObject>
+#include <QtCore/QMutex>
+
+#include <string>
 
 #include "simpleWindow.h"
 
@@ -64,6 +74,7 @@ namespace QCV
     class CWheelEvent;
     class CRegionSelectedEvent;
     class CGLViewer;
+    class CFramePipeline;
     
     class CMainWindow: public CSimpleWindow
     {
@@ -77,6 +88,12 @@ namespace QCV
                       int                     f_sy_i = 2 );
         
         virtual ~CMainWindow();
+
+        /// Enable/disable the pipelined execution of the operators.
+        void setPipelined ( bool f_val_b );
+
+        /// Is the pipelined execution enabled?
+        bool isPipelined ( ) const { return m_pipeline_p != NULL; }
         
     public slots:
         /// Cycle
@@ -100,6 +117,12 @@ namespace QCV
     //// Protected signals.
     protected:
         void closeEvent ( QCloseEvent *  f_event_p);
+
+    //// Private slots.
+    private slots:
+        /// Give the outputs to the device and update the displays after
+        /// a frame has been published by the pipeline.
+        void frameProcessed();
         
     //// Private methods.
     private:
@@ -107,6 +130,15 @@ namespace QCV
         /// Create Base Widget
         void createBaseWidgets();
 
+        /// Get the mutex to hold while accessing the operators from the
+        /// GUI thread (NULL if not pipelined).
+        QMutex * getOperatorMutex() const;
+
+        /// Paint the drawings of the operators from now on (see
+        /// CDrawingListHandler::publish()). Call after show() or after
+        /// the operators handled an event.
+        void publishDrawings();
+
     private:
 
         /// Input device.
@@ -132,6 +164,13 @@ namespace QCV
 
         // Auto play?
         bool                      m_autoPlay_b;
+
+        /// Pipeline (NULL if not pipelined).
+        CFramePipeline *          m_pipeline_p;
+
+        /// File where the clock statistics are written at exit (empty
+        /// if none).
+        std::string               m_clockStatsFile_str;
     };
 }
 
@@ -0,0 +1,224 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose.
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+/*@@@**************************************************************************
+ * \file  matPool
+ * \author Hernan Badino
+ * \notes
+ *******************************************************************************
+ *****             (C) Hernan Badino 2012 - All Rights Reserved            *****
+ ******************************************************************************/
+
+/* INCLUDES */
+#include "matPool.h"
+#include "clock.h"
+
+#include <QtCore/QMutexLocker>
+
+using namespace QCV;
+
+CMatPool::CMatPool ( )
+    : m_entries (                ),
+      m_frame_ui (             0 ),
+      m_maxIdleFrames_ui (     2 ),
+      m_allocations_ui (       0 ),
+      m_reuses_ui (            0 ),
+      m_buffers_ui (           0 ),
+      m_pooledBytes_ui (       0 ),
+      m_allocClock_p (      NULL ),
+      m_mutex (                  )
+{
+}
+
+CMatPool::~CMatPool ( )
+{
+}
+
+bool
+CMatPool::isFree ( const cv::Mat & f_mat )
+{
+    return f_mat.refcount && *f_mat.refcount == 1;
+}
+
+void
+CMatPool::get ( cv::Mat &  fr_mat,
+                cv::Size   f_size,
+                int        f_type_i )
+{
+    /// Drop the reference of fr_mat first, so that its own buffer can
+    /// be given back.
+    fr_mat.release();
+
+    f_type_i = CV_MAT_TYPE ( f_type_i );
+
+    if ( f_size.width <= 0 || f_size.height <= 0 )
+    {
+        fr_mat.create ( f_size, f_type_i );
+        return;
+    }
+
+    SKey key = { f_size.height, f_size.width, f_type_i };
+
+    QMutexLocker locker ( &m_mutex );
+
+    std::vector<SEntry> & entries_v = m_entries[key];
+
+    for (unsigned int i = 0; i < entries_v.size(); ++i)
+    {
+        if ( isFree ( entries_v[i].mat ) )
+        {
+            entries_v[i].lastFrame_ui = m_frame_ui;
+            fr_mat = entries_v[i].mat;
+            ++m_reuses_ui;
+            return;
+        }
+    }
+
+    SEntry entry;
+    entry.lastFrame_ui = m_frame_ui;
+
+    {
+        CScopedClock clock ( m_allocClock_p );
+        entry.mat.create ( f_size, f_type_i );
+    }
+
+    entries_v.push_back ( entry );
+    fr_mat = entry.mat;
+
+    ++m_allocations_ui;
+    ++m_buffers_ui;
+    m_pooledBytes_ui += entry.mat.step[0] * entry.mat.rows;
+}
+
+void
+CMatPool::nextFrame ( )
+{
+    QMutexLocker locker ( &m_mutex );
+
+    ++m_frame_ui;
+
+    TEntryMap::iterator it = m_entries.begin();
+
+    while ( it != m_entries.end() )
+    {
+        std::vector<SEntry> & entries_v = it -> second;
+
+        for (int i = entries_v.size() - 1; i >= 0; --i)
+        {
+            if ( m_frame_ui - entries_v[i].lastFrame_ui >= m_maxIdleFrames_ui &&
+                 isFree ( entries_v[i].mat ) )
+            {
+                --m_buffers_ui;
+                m_pooledBytes_ui -= entries_v[i].mat.step[0] * entries_v[i].mat.rows;
+                entries_v.erase ( entries_v.begin() + i );
+            }
+        }
+
+        if ( entries_v.empty() )
+            m_entries.erase ( it++ );
+        else
+            ++it;
+    }
+}
+
+void
+CMatPool::clear ( )
+{
+    QMutexLocker locker ( &m_mutex );
+
+    TEntryMap::iterator it = m_entries.begin();
+
+    while ( it != m_entries.end() )
+    {
+        std::vector<SEntry> & entries_v = it -> second;
+
+        for (int i = entries_v.size() - 1; i >= 0; --i)
+        {
+            if ( isFree ( entries_v[i].mat ) )
+            {
+                --m_buffers_ui;
+                m_pooledBytes_ui -= entries_v[i].mat.step[0] * entries_v[i].mat.rows;
+                entries_v.erase ( entries_v.begin() + i );
+            }
+        }
+
+        if ( entries_v.empty() )
+            m_entries.erase ( it++ );
+        else
+            ++it;
+    }
+}
+
+void
+CMatPool::setAllocationClock ( CClock * f_clock_p )
+{
+    QMutexLocker locker ( &m_mutex );
+    m_allocClock_p = f_clock_p;
+}
+
+CClock *
+CMatPool::getAllocationClock ( ) const
+{
+    QMutexLocker locker ( &m_mutex );
+    return m_allocClock_p;
+}
+
+void
+CMatPool::setMaxIdleFrames ( unsigned int f_frames_ui )
+{
+    QMutexLocker locker ( &m_mutex );
+    m_maxIdleFrames_ui = f_frames_ui > 0 ? f_frames_ui : 1;
+}
+
+unsigned int
+CMatPool::getMaxIdleFrames ( ) const
+{
+    QMutexLocker locker ( &m_mutex );
+    return m_maxIdleFrames_ui;
+}
+
+unsigned int
+CMatPool::getAllocationCount ( ) const
+{
+    QMutexLocker locker ( &m_mutex );
+    return m_allocations_ui;
+}
+
+unsigned int
+CMatPool::getReuseCount ( ) const
+{
+    QMutexLocker locker ( &m_mutex );
+    return m_reuses_ui;
+}
+
+unsigned int
+CMatPool::getBufferCount ( ) const
+{
+    QMutexLocker locker ( &m_mutex );
+    return m_buffers_ui;
+}
+
+size_t
+CMatPool::getPooledBytes ( ) const
+{
+    QMutexLocker locker ( &m_mutex );
+    return m_pooledBytes_ui;
+}
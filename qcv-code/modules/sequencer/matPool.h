@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose.
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+#ifndef __MATPOOL_H
+#define __MATPOOL_H
+
+/**
+ *******************************************************************************
+ *
+ * @file matPool.h
+ *
+ * \class CMatPool
+ * \author Hernan Badino (hernan.badino@gmail.com)
+ *
+ * \brief Pool of image buffers recycled from frame to frame.
+ *
+ * get() returns a buffer of the requested size and type. A buffer of the
+ * pool is reused if no cv::Mat outside the pool refers to it anymore.
+ * Otherwise a new buffer is allocated and added to the pool. Buffers
+ * not requested during the last getMaxIdleFrames() calls of nextFrame()
+ * are freed. The content of a returned buffer is undefined.
+ *
+ * Only holders of a cv::Mat copy, which increments the reference
+ * count, keep a buffer from being reused. Pointers to the cv::Mat of
+ * the operator are not counted: outputs registered as &m_member and
+ * drawing lists that got the image as a pointer see the buffer being
+ * refilled as soon as the operator requests it again. Such holders
+ * must not read the buffer after the operator's next cycle started,
+ * e.g. from the GUI thread while a pipelined frame is processed.
+ *
+ *******************************************************************************/
+
+/* INCLUDES */
+#include <map>
+#include <vector>
+
+#include <opencv/cv.h>
+
+#include <QtCore/QMutex>
+
+/* CONSTANTS */
+
+namespace QCV
+{
+    class CClock;
+
+    class CMatPool
+    {
+    /// Constructor/Destructor.
+    public:
+        CMatPool ( );
+        ~CMatPool ( );
+
+    /// Handling.
+    public:
+        /// Set fr_mat to a buffer of the given size and type.
+        void              get ( cv::Mat &  fr_mat,
+                                cv::Size   f_size,
+                                int        f_type_i );
+
+        /// Start a new frame. Frees the buffers not requested since
+        /// getMaxIdleFrames() calls and not referenced anymore.
+        void              nextFrame ( );
+
+        /// Free all buffers not referenced anymore.
+        void              clear ( );
+
+    /// Gets/Sets.
+    public:
+        /// Clock measuring every allocation of a new buffer (may be
+        /// NULL). Its count is the number of allocations.
+        void              setAllocationClock ( CClock * f_clock_p );
+        CClock *          getAllocationClock ( ) const;
+
+        /// Number of calls of nextFrame() an unused buffer is kept
+        /// (at least 1).
+        void              setMaxIdleFrames ( unsigned int f_frames_ui );
+        unsigned int      getMaxIdleFrames ( ) const;
+
+        /// Number of buffers allocated.
+        unsigned int      getAllocationCount ( ) const;
+
+        /// Number of requests served with a buffer of the pool.
+        unsigned int      getReuseCount ( ) const;
+
+        /// Number of buffers in the pool.
+        unsigned int      getBufferCount ( ) const;
+
+        /// Bytes of the buffers in the pool.
+        size_t            getPooledBytes ( ) const;
+
+    /// Private data types.
+    private:
+        struct SEntry
+        {
+            cv::Mat          mat;
+            unsigned int     lastFrame_ui;
+        };
+
+        /// Rows, columns and type.
+        struct SKey
+        {
+            int rows_i, cols_i, type_i;
+
+            bool operator < ( const SKey & f_other ) const
+            {
+                if ( rows_i != f_other.rows_i ) return rows_i < f_other.rows_i;
+                if ( cols_i != f_other.cols_i ) return cols_i < f_other.cols_i;
+                return type_i < f_other.type_i;
+            }
+        };
+
+        typedef std::map<SKey, std::vector<SEntry> > TEntryMap;
+
+        /// Is the buffer referenced only by the pool?
+        static bool       isFree ( const cv::Mat & f_mat );
+
+    /// Private members.
+    private:
+        /// Not copyable.
+        CMatPool ( const CMatPool & );
+        CMatPool & operator = ( const CMatPool & );
+
+        /// Buffers by size and type.
+        TEntryMap                 m_entries;
+
+        /// Current frame.
+        unsigned int              m_frame_ui;
+
+        /// Number of frames an unused buffer is kept.
+        unsigned int              m_maxIdleFrames_ui;
+
+        /// Counters.
+        unsigned int              m_allocations_ui;
+        unsigned int              m_reuses_ui;
+        unsigned int              m_buffers_ui;
+        size_t                    m_pooledBytes_ui;
+
+        /// Allocation clock.
+        CClock *                  m_allocClock_p;
+
+        /// Protects the pool when an operator requests buffers from
+        /// several threads.
+        mutable QMutex            m_mutex;
+    };
+}
+
+#endif // __MATPOOL_H
@@ -28,20 +28,137 @@
  ******************************************************************************/
 
 /* INCLUDES */
+#include <algorithm>
+
 #include "operator.h"
 #include "drawingList.h"
 #include "clock.h"
 #include "displayStateParam.h"
+#include "workStealingPool.h"
 
 using namespace QCV;
 
 CDrawingListHandler    COperator::m_drawingListHandler;
 CClockHandler          COperator::m_clockHandler;
-CGLViewer *            COperator::m_3dViewer_p = NULL;
+C3DViewerBase *        COperator::m_3dViewer_p = NULL;
+QMutex                 COperator::m_ioMutex ( QMutex::Recursive );
+QAtomicInt             COperator::m_parallelCycles ( 0 );
+QAtomicInt             COperator::m_ioGeneration ( 0 );
+unsigned int           COperator::m_ioVersion_ui = 0;
+
+/// Interned I/O ids.
+static std::map<std::string, int> &
+getIOKeyMap()
+{
+    static std::map<std::string, int> keys;
+    return keys;
+}
+
+/// I/O ids by key.
+static std::vector<std::string> &
+getIOIds()
+{
+    static std::vector<std::string> ids;
+    return ids;
+}
+
+/// Dependency graph of the children to cycle.
+class COperator::CCycleGraph: public CWorkStealingPool::CTaskGraph
+{
+public:
+    CCycleGraph ( const std::vector<COperator *> & f_children_v )
+            : m_children_v (                            f_children_v ),
+              m_results_v (                  f_children_v.size(), 1 )
+    {
+        const unsigned int count_ui = m_children_v.size();
+        
+        std::vector< std::vector<std::string> > inputs_v  ( count_ui );
+        std::vector< std::vector<std::string> > outputs_v ( count_ui );
+        std::vector<bool>                       known_v   ( count_ui );
+
+        for (unsigned int i = 0; i < count_ui; ++i)
+        {
+            known_v[i] = m_children_v[i] -> getCycleIO ( inputs_v[i], outputs_v[i] );
+            std::sort ( inputs_v[i].begin(),  inputs_v[i].end() );
+            std::sort ( outputs_v[i].begin(), outputs_v[i].end() );
+        }
+        
+        m_successors_v.resize   ( count_ui );
+        m_predecessors_v.resize ( count_ui, 0 );
+
+        /// j must run after i if any of them does not declare its I/O
+        /// or if they access the same id and at least one writes it.
+        for (unsigned int j = 1; j < count_ui; ++j)
+        {
+            for (unsigned int i = 0; i < j; ++i)
+            {
+                if ( !known_v[i] || !known_v[j] ||
+                     intersect ( outputs_v[i], inputs_v[j]  ) ||
+                     intersect ( inputs_v[i],  outputs_v[j] ) ||
+                     intersect ( outputs_v[i], outputs_v[j] ) )
+                {
+                    m_successors_v[i].push_back ( j );
+                    ++m_predecessors_v[j];
+                }
+            }
+        }
+    }
+    
+    virtual void execute ( int f_task_i )
+    {
+        COperator * child_p = m_children_v[f_task_i];
+
+        child_p -> m_cycleClock_p -> start();
+        m_results_v[f_task_i] = child_p -> cycle();
+        child_p -> m_cycleClock_p -> stop();
+    }
+
+    bool getResult ( ) const
+    {
+        return std::find ( m_results_v.begin(), m_results_v.end(), 0 ) == m_results_v.end();
+    }
+    
+private:
+    static bool intersect ( const std::vector<std::string> & f_a_v,
+                            const std::vector<std::string> & f_b_v )
+    {
+        std::vector<std::string>::const_iterator a = f_a_v.begin();
+        std::vector<std::string>::const_iterator b = f_b_v.begin();
+
+        while ( a != f_a_v.end() && b != f_b_v.end() )
+        {
+            if ( *a < *b )      ++a;
+            else if ( *b < *a ) ++b;
+            else return true;
+        }
+
+        return false;
+    }
+    
+    const std::vector<COperator *> &  m_children_v;
+
+    /// One char per child (std::vector<bool> is not safe for
+    /// concurrent writes).
+    std::vector<char>                 m_results_v;
+};
+
+/// Threads shared by all operators.
+static CWorkStealingPool &
+getCyclePool()
+{
+    static CWorkStealingPool pool;
+    return pool;
+}
 
 COperator::COperator (  COperator * const f_parent_p /* = NULL */, 
                                 const std::string f_name_str /* = "Unnamed Operator" */ )
     : CNode (      f_parent_p, f_name_str ),
+      m_executionMode_e ( EM_SEQUENTIAL ),
+      m_clocks (                         ),
+      m_clockMutex (                     ),
+      m_cycleClock_p (               NULL ),
+      m_showClock_p (                NULL ),
+      m_matPool (                        ),
       m_paramSet_p (                 NULL )
 {
     m_paramSet_p = new CParameterSet(NULL);
@@ -49,7 +166,7 @@ COperator::COperator (  COperator * const f_parent_p /* = NULL */,
 
     /// Register the ensure existance of root when the first CClockHandler::getClock
     /// is called.
-    registerClock ( "Cycle");
+    m_cycleClock_p = registerClock ( "Cycle");
 
     if ( m_parent_p )
         getParentOp() -> getParameterSet ()->addSubset ( m_paramSet_p );
@@ -61,25 +178,62 @@ COperator::~COperator ()
     if ( m_parent_p == NULL )
         delete m_paramSet_p;
 
+    /// Ports may point to the slots of this operator.
+    {
+        CIOLock locker;
+        m_ioGeneration.ref();
+    }
+
     deleteChildren ( );
 }
 
 bool 
 COperator::cycle()
 {
-    bool result_b = true;
+    std::vector<COperator *> children_v;
+    children_v.reserve ( m_children_v.size() );
 
     for (uint32_t i = 0; i < m_children_v.size(); ++i)
     {
         COperator *child_p = static_cast<COperator *>(m_children_v[i].ptr_p);
 
         if ( child_p )
-        {
-            child_p -> startClock ("Cycle");
-            bool res_b = child_p -> cycle();
-            child_p -> stopClock ("Cycle");
-            result_b &= res_b;
-        }
+            children_v.push_back ( child_p );
+    }
+
+    return cycleChildren ( children_v );
+}
+
+bool 
+COperator::cycleChildren ( const std::vector<COperator *> & f_children_v )
+{
+    if ( m_executionMode_e == EM_PARALLEL && f_children_v.size() > 1 )
+    {
+        CCycleGraph graph ( f_children_v );
+
+        /// The I/O maps are locked while the graph runs.
+        m_parallelCycles.ref();
+
+        /// The pool is busy if this is called from an operator already
+        /// running in it. Continue sequentially in that case.
+        const bool run_b = getCyclePool().run ( graph );
+
+        m_parallelCycles.deref();
+
+        if ( run_b )
+            return graph.getResult();
+    }
+
+    bool result_b = true;
+
+    for (uint32_t i = 0; i < f_children_v.size(); ++i)
+    {
+        COperator *child_p = f_children_v[i];
+
+        child_p -> m_cycleClock_p -> start();
+        bool res_b = child_p -> cycle();
+        child_p -> m_cycleClock_p -> stop();
+        result_b &= res_b;
     }
 
     return result_b;
@@ -94,9 +248,9 @@ COperator::cycle( COperator *f_child_p )
 
         if ( child_p == f_child_p && child_p )
         {
-            child_p -> startClock ("Cycle");
+            child_p -> m_cycleClock_p -> start();
             bool res_b = child_p -> cycle();
-            child_p -> stopClock ("Cycle");
+            child_p -> m_cycleClock_p -> stop();
             return res_b;
         }
     }
@@ -114,9 +268,12 @@ COperator::show()
 
         if ( child_p )
         {
-            child_p -> startClock ("Show");
+            if ( !child_p -> m_showClock_p )
+                child_p -> m_showClock_p = child_p -> registerClock ( "Show" );
+
+            child_p -> m_showClock_p -> start();
             bool res_b = child_p ->  show();
-            child_p -> stopClock ("Show");
+            child_p -> m_showClock_p -> stop();
             result_b &= res_b;
         }
     }
@@ -321,22 +478,38 @@ COperator::updateDisplay ( )
 
 /// Register a clock so that is visible and available from the 
 /// beginning.
-void
-COperator::registerClock ( std::string f_name_str )
+CClock *
+COperator::registerClock ( const std::string & f_name_str )
 {
-    getClock ( f_name_str );
+    QMutexLocker locker ( &m_clockMutex );
+
+    CClock * & clock_p = m_clocks[f_name_str];
+
+    if ( !clock_p )
+        clock_p = m_clockHandler.getClock ( f_name_str, this );
+
+    return clock_p;
 }
 
 /// Get a clock to measure computation time.
 CClock *
-COperator::getClock ( std::string f_id_str )
+COperator::getClock ( const std::string & f_id_str )
 {
-    return m_clockHandler.getClock ( f_id_str, this );
+    {
+        QMutexLocker locker ( &m_clockMutex );
+
+        std::map<std::string, CClock *>::const_iterator it = m_clocks.find ( f_id_str );
+
+        if ( it != m_clocks.end() )
+            return it -> second;
+    }
+
+    return registerClock ( f_id_str );
 }
 
 /// Start clock.
 void
-COperator::startClock ( std::string f_name_str )
+COperator::startClock ( const std::string & f_name_str )
 {
     CClock *  clock_p = getClock ( f_name_str );
     if ( clock_p ) clock_p -> start();
@@ -344,12 +517,23 @@ COperator::startClock ( std::string f_name_str )
 
 /// Start clock.
 void
-COperator::stopClock ( std::string f_name_str )
+COperator::stopClock ( const std::string & f_name_str )
 {
     CClock *  clock_p = getClock ( f_name_str );
     if ( clock_p ) clock_p -> stop();
 }
 
+void
+COperator::getPooledMat ( cv::Mat &  fr_mat,
+                          cv::Size   f_size,
+                          int        f_type_i )
+{
+    if ( !m_matPool.getAllocationClock() )
+        m_matPool.setAllocationClock ( registerClock ( "Pooled Mat Allocation" ) );
+
+    m_matPool.get ( fr_mat, f_size, f_type_i );
+}
+
 CParameterSet *
 COperator::getParameterSet() const
 {
@@ -396,24 +580,28 @@ S2D<unsigned int> COperator::getScreenSize (  ) const
 void
 COperator::clearIOMap ( )
 {
+    CIOLock locker;
+
     for (int i = m_children_v.size()-1; i >=0 ; --i)
     {
         COperator *child_p = static_cast<COperator *>(m_children_v[i].ptr_p);
         child_p->clearIOMap ( );
     }
 
-    // Clear elements
-    std::map<std::string, CIOBase*>::iterator 
-        it = m_ios.begin ();
+    // Clear elements. The slots are kept for the ports.
+    std::map<int, SIOSlot>::iterator 
+        it = m_ioSlots.begin ();
 
-    while (it != m_ios.end() )
+    while (it != m_ioSlots.end() )
     {
         /// Delete CIO object
-        delete it->second;
+        delete it->second.io_p;
+        it->second.io_p = NULL;
         ++it;
     }
 
-    m_ios.erase( m_ios.begin(), m_ios.end() );
+    /// A new frame starts.
+    m_matPool.nextFrame ( );
 }
 
 
@@ -422,10 +610,29 @@ COperator::clearIOMap ( )
 void
 COperator::registerOutputs ( const std::map< std::string, CIOBase * > &f_elements )
 {
-    m_ios.insert( f_elements.begin(), f_elements.end() ) ;   
-    
-    if (getParentOp())
-        getParentOp() -> m_ios.insert( f_elements.begin(), f_elements.end() ) ;
+    CIOLock locker;
+
+    std::map<std::string, CIOBase*>::const_iterator 
+        it = f_elements.begin ();
+
+    for (; it != f_elements.end(); ++it)
+    {
+        const int key_i = getIOKey ( it->first );
+
+        /// Existing elements are not overwritten.
+        SIOSlot & slot = getIOSlot ( key_i );
+
+        if ( !slot.io_p )
+            setIO ( slot, it->second );
+
+        if (getParentOp())
+        {
+            SIOSlot & parentSlot = getParentOp() -> getIOSlot ( key_i );
+
+            if ( !parentSlot.io_p )
+                setIO ( parentSlot, it->second );
+        }
+    }
 }
   
 /*      
@@ -441,13 +648,112 @@ COperator::registerOutputsTo ( COperator *f_other_p )
 void
 COperator::getOutputMap ( std::map< std::string, CIOBase* > &fr_elements ) const
 {
+    CIOLock locker;
+
     fr_elements.clear();
-    fr_elements.insert( m_ios.begin(), m_ios.end() );
+
+    std::map<int, SIOSlot>::const_iterator 
+        it = m_ioSlots.begin ();
+
+    for (; it != m_ioSlots.end(); ++it)
+        if ( it->second.io_p )
+            fr_elements[getIOId ( it->first )] = it->second.io_p;
+}
+
+/// Get the integer key of an I/O id.
+int
+COperator::getIOKey ( const std::string &f_id_str )
+{
+    CIOLock locker;
+
+    std::map<std::string, int> &          keys   = getIOKeyMap();
+    std::map<std::string, int>::iterator  it     = keys.find ( f_id_str );
+
+    if ( it != keys.end() )
+        return it->second;
+
+    const int key_i = getIOIds().size();
+
+    keys[f_id_str] = key_i;
+    getIOIds().push_back ( f_id_str );
+
+    return key_i;
+}
+
+/// Get the integer key of an I/O id without interning it.
+int
+COperator::lookupIOKey ( const std::string &f_id_str )
+{
+    CIOLock locker;
+
+    std::map<std::string, int> &          keys   = getIOKeyMap();
+    std::map<std::string, int>::iterator  it     = keys.find ( f_id_str );
+
+    return it == keys.end() ? -1 : it->second;
+}
+
+/// Get the I/O id of a key.
+std::string
+COperator::getIOId ( int f_key_i )
+{
+    CIOLock locker;
+
+    if ( f_key_i < 0 || f_key_i >= (int) getIOIds().size() )
+        return "";
+
+    return getIOIds()[f_key_i];
+}
+
+/// Slot of a key in this operator (NULL if none).
+SIOSlot *
+COperator::findIOSlot ( int f_key_i ) const
+{
+    std::map<int, SIOSlot>::iterator it = m_ioSlots.find ( f_key_i );
+
+    return it == m_ioSlots.end() ? NULL : &it->second;
+}
+
+/// Slot of a key in this operator, created if required.
+SIOSlot &
+COperator::getIOSlot ( int f_key_i )
+{
+    std::map<int, SIOSlot>::iterator it = m_ioSlots.find ( f_key_i );
+
+    if ( it != m_ioSlots.end() )
+        return it->second;
+
+    /// New slot: the ports must look up their slots again.
+    m_ioGeneration.ref();
+
+    return m_ioSlots[f_key_i];
+}
+
+/// Nearest registered element of a key in this operator or its parents.
+CIOBase *
+COperator::findIO ( int f_key_i ) const
+{
+    for ( const COperator * op_p = this; op_p; op_p = op_p -> getParentOp() )
+    {
+        const SIOSlot * slot_p = op_p -> findIOSlot ( f_key_i );
+
+        if ( slot_p && slot_p -> io_p )
+            return slot_p -> io_p;
+    }
+
+    return NULL;
+}
+
+/// Set the element of a slot and give it a new version.
+void
+COperator::setIO ( SIOSlot & fr_slot, CIOBase * f_io_p )
+{
+    fr_slot.io_p       = f_io_p;
+    fr_slot.version_ui = ++m_ioVersion_ui;
 }
 
 /// Set the 3D viewer
 void
-COperator::set3DViewer ( CGLViewer * f_viewer_p )
+COperator::set3DViewer ( C3DViewerBase * f_viewer_p )
 {
     m_3dViewer_p = f_viewer_p;
 }
@@ -63,19 +63,21 @@
 #include "paramBaseConnector.h"
 #include "node.h"
 #include "io.h"
+#include "ioPort.h"
+#include "matPool.h"
 
 #include "drawingListHandler.h"
 #include "clockHandler.h"
 
-#if defined HAVE_QGLVIEWER
-#include "glViewer.h"
-#endif
-
 //#include <iostream>
 #include <string>
 #include <vector>
 #include <map>
 
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QAtomicInt>
+
 #include "events.h"
 
 /* CONSTANTS */
@@ -96,11 +98,25 @@ namespace QCV
     class CDrawingListHandler;
     class CDrawingList;
     
-    class CGLViewer;
+    class C3DViewerBase;
 
     class COperator: public CNode
     {
         friend class CMainWindow;
+        friend class CFramePipeline;
+        friend class CBatchRunner;
+        friend class CIOPortBase;
+
+    /// Public data types
+    public:
+        /// Execution of the children in cycle().
+        typedef enum
+        {
+            /// One after the other in the order they were added.
+            EM_SEQUENTIAL,
+            /// Children without I/O dependencies run concurrently.
+            EM_PARALLEL
+        } EExecutionMode;
 
     /// Constructor, Desctructors
     public:    
@@ -175,7 +191,11 @@ namespace QCV
         }
 
         /// Set 3D viewer
-        static  void          set3DViewer ( CGLViewer * f_viewer_p );
+        static  void          set3DViewer ( C3DViewerBase * f_viewer_p );
+
+        /// Get 3D viewer
+        static  C3DViewerBase *
+                              get3DViewer ( ) { return m_3dViewer_p; }
 
         /// Get the input of this operator.
         virtual COperator*    getParentOp ( ) const { return static_cast<COperator *> (m_parent_p); }
@@ -196,6 +216,23 @@ namespace QCV
         template <class _OpType>
         _OpType               getChild ( int f_idx_i ) const;
 
+        /// Set the execution mode of the children.
+        void                  setExecutionMode ( EExecutionMode f_mode_e ) { m_executionMode_e = f_mode_e; }
+
+        /// Get the execution mode of the children.
+        EExecutionMode        getExecutionMode ( ) const { return m_executionMode_e; }
+
+        /// Get the I/O ids read and written by cycle(). Operators 
+        /// returning false (default) are not reordered with respect to
+        /// any other operator. Two operators writing the same id are
+        /// ordered as well, so siblings meant to run concurrently
+        /// need distinct output ids.
+        virtual bool          getCycleIO ( std::vector<std::string> & /* fr_inputs_v */,
+                                           std::vector<std::string> & /* fr_outputs_v */ ) const
+        {
+            return false;
+        }
+
     /// Public classes
     public: 
 
@@ -204,6 +241,10 @@ namespace QCV
        /// Cycle event only for one child
        virtual bool cycle( COperator * f_child_p);
 
+       /// Cycle event for a set of children. Children run in the given
+       /// order or, in parallel mode, following their I/O dependencies.
+       bool         cycleChildren ( const std::vector<COperator *> & f_children_v );
+
     /// I/O registration.
     public:
         
@@ -245,6 +286,32 @@ namespace QCV
         const _T &        getInput ( const std::string &f_id_str,
                                      const _T          &f_default ) const;
 
+        /// Get the integer key of an I/O id. Ids are interned the first
+        /// time they are registered or bound to a port.
+        static int        getIOKey ( const std::string &f_id_str );
+
+        /// Get the integer key of an I/O id without interning it (-1 if
+        /// the id has never been registered or bound).
+        static int        lookupIOKey ( const std::string &f_id_str );
+
+        /// Get the I/O id of a key.
+        static std::string getIOId ( int f_key_i );
+
+    /// I/O slots for internal use.
+    protected:
+
+        /// Slot of a key in this operator (NULL if none).
+        SIOSlot *         findIOSlot ( int f_key_i ) const;
+
+        /// Slot of a key in this operator, created if required.
+        SIOSlot &         getIOSlot ( int f_key_i );
+
+        /// Nearest registered element of a key in this operator or its
+        /// parents (NULL if none).
+        CIOBase *         findIO ( int f_key_i ) const;
+
+        /// Set the element of a slot and give it a new version.
+        static void       setIO ( SIOSlot & fr_slot, CIOBase * f_io_p );
 
     /// Parameter handling.
     public:
@@ -281,17 +348,33 @@ namespace QCV
         void           updateDisplay();
 
         /// Register a clock so that is visible and available from the 
-        /// beginning.
-        void           registerClock ( std::string f_name_str );
+        /// beginning. The returned clock is valid as long as the clock
+        /// handler exists, so that it can be kept and started and
+        /// stopped directly (or with CScopedClock) in every cycle.
+        CClock *       registerClock ( const std::string & f_name_str );
 
         /// Get a clock to measure computation time.
-        CClock *       getClock ( std::string f_id_str );
+        CClock *       getClock ( const std::string & f_id_str );
 
         /// Start clock.
-        void           startClock ( std::string f_id_str );
+        void           startClock ( const std::string & f_id_str );
 
         /// Stop clock.
-        void           stopClock ( std::string f_id_str );
+        void           stopClock ( const std::string & f_id_str );
+
+        /// Set fr_mat to a buffer of the given size and type from the
+        /// pool of this operator. The buffer is recycled in the next
+        /// frames once no other cv::Mat refers to it. Pointers to
+        /// fr_mat (registered outputs, drawing lists) do not count
+        /// (see CMatPool). The allocations
+        /// of new buffers are measured with the clock "Pooled Mat
+        /// Allocation".
+        void           getPooledMat ( cv::Mat &  fr_mat,
+                                      cv::Size   f_size,
+                                      int        f_type_i );
+
+        /// Image buffer pool.
+        CMatPool &     getMatPool ( ) { return m_matPool; }
 
     /// Support functions for internal use.
     protected:
@@ -299,7 +382,52 @@ namespace QCV
     /// Protected data types
     protected:
         /// 3D Viewer.
-        static CGLViewer *                m_3dViewer_p;
+        static C3DViewerBase *            m_3dViewer_p;
+
+    /// Private data types
+    private:
+        class CCycleGraph;
+        friend class CCycleGraph;
+
+        /// Locks m_ioMutex, but only while children are cycled in
+        /// parallel. Sequential execution does not pay for the lock.
+        class CIOLock
+        {
+        public:
+            CIOLock ( )
+                    : m_locked_b ( (int) m_parallelCycles > 0 )
+            {
+                if ( m_locked_b ) m_ioMutex.lock();
+            }
+
+            ~CIOLock ( )
+            {
+                if ( m_locked_b ) m_ioMutex.unlock();
+            }
+
+        private:
+            bool    m_locked_b;
+        };
+
+    /// Private members
+    private:
+        /// Execution mode of the children.
+        EExecutionMode                    m_executionMode_e;
+
+        /// Clocks of this operator already found in the clock handler.
+        std::map<std::string, CClock *>   m_clocks;
+
+        /// Protects m_clocks.
+        QMutex                            m_clockMutex;
+
+        /// Cycle clock (started by the parent).
+        CClock *                          m_cycleClock_p;
+
+        /// Show clock (started by the parent).
+        CClock *                          m_showClock_p;
+
+        /// Image buffers of this operator.
+        CMatPool                          m_matPool;
 
     /// Private static members
     private:
@@ -315,8 +443,22 @@ namespace QCV
     /// Protected static members
     protected:    
 
-        /// IO Map
-        std::map<std::string, CIOBase *>   m_ios;
+        /// Protects the IO maps when operators run concurrently.
+        static QMutex                      m_ioMutex;
+
+        /// Number of parallel cycles running (see CIOLock).
+        static QAtomicInt                  m_parallelCycles;
+
+        /// Incremented when a slot is added or an operator with slots
+        /// is deleted (CIOPortBase looks up its slots again). Atomic,
+        /// since ports compare it without locking.
+        static QAtomicInt                  m_ioGeneration;
+
+        /// Last version given to a registered element.
+        static unsigned int                m_ioVersion_ui;
+
+        /// IO Map (key of the id to slot).
+        mutable std::map<int, SIOSlot>     m_ioSlots;
         
         /// Operator's parameter handling.
         CParameterSet *                    m_paramSet_p;
@@ -425,18 +567,13 @@ namespace QCV
                                 _T *               f_ptr,
                                 COperator *        f_op )
     {
-        // Check if object already exists.
-        const std::map<std::string, CIOBase*>::iterator 
-            it = f_op->m_ios.find( f_id_str );
+        CIOLock locker;
 
-        if ( it != f_op->m_ios.end() )
-        {
-            /// Element exist. Overwrite it.
-            delete it->second;
-            it->second = new CIO<_T>(f_ptr);
-        }
-        else
-            f_op->m_ios[f_id_str] = new CIO<_T>(f_ptr);
+        SIOSlot & slot = f_op -> getIOSlot ( getIOKey ( f_id_str ) );
+
+        /// Overwrite the element if it exists.
+        delete slot.io_p;
+        setIO ( slot, new CIO<_T>(f_ptr) );
     }
     
 
@@ -445,30 +582,7 @@ namespace QCV
     _T *
     COperator::getOutput ( const std::string &f_id_str )
     {
-        // Find object.
-        const std::map<std::string, CIOBase*>::const_iterator 
-            it = m_ios.find( f_id_str );
-    
-        if ( it == m_ios.end() )    
-        {
-            // Return empty element.
-            printf("%s:%i Object with Id \"%s\" not found.\n", __FILE__, __LINE__, f_id_str.c_str());
-            return NULL;
-        }
-    
-        // Return corresponding element.
-        CIO<_T> * cio_p = dynamic_cast< CIO<_T> *> (it->second);
-        if ( cio_p )
-            return static_cast<_T *>(cio_p ->getPtr());
-        else
-        {
-            // Return empty element.
-            printf("%s:%i Object with Id \"%s\" is not of type %s.\n", __FILE__, __LINE__,
-                   f_id_str.c_str(),
-                   typeid(_T).name() );
-            
-            return NULL;
-        }
+        return const_cast<_T *> ( static_cast<const COperator *>(this) -> getOutput<_T> ( f_id_str ) );
     }
     
     /// Get output of this operator.
@@ -476,11 +590,12 @@ namespace QCV
     const _T * 
     COperator::getOutput ( const std::string &f_id_str ) const
     {
+        CIOLock locker;
+
         // Find object.
-        const std::map<std::string, CIOBase*>::const_iterator 
-            it = m_ios.find( f_id_str );
+        const SIOSlot * slot_p = findIOSlot ( lookupIOKey ( f_id_str ) );
         
-        if ( it == m_ios.end() )    
+        if ( !slot_p || !slot_p -> io_p )
         {
             // Return empty element.
             printf("%s:%i Object with Id \"%s\" not found.\n", __FILE__, __LINE__, f_id_str.c_str());
@@ -488,7 +603,7 @@ namespace QCV
         }
         
         // Return corresponding element.
-        CIO<_T> * cio_p = dynamic_cast< CIO<_T> *> (it->second);
+        CIO<_T> * cio_p = dynamic_cast< CIO<_T> *> (slot_p -> io_p);
         if ( cio_p )
             return static_cast<const _T *>( cio_p ->getPtr() );
         else
@@ -508,40 +623,9 @@ namespace QCV
     COperator::getInput ( const std::string &f_id_str,
                           const _T          & f_default) const
     {
-        // Find object.
-        const std::map<std::string, CIOBase*>::const_iterator 
-            it = m_ios.find( f_id_str );
-        
-        if ( it == m_ios.end() )
-        {
-            if ( getParentOp() )
-            {
-                // Check if the object is available at higher levels.
-                return getParentOp() -> getInput<_T> ( f_id_str, f_default );
-            }
-            else
-            {
-                // Return empty element.
-                printf("%s:%i Object with Id \"%s\" not found.\n", __FILE__, __LINE__,f_id_str.c_str());
-                return f_default;
-            }
-        }
-        else
-        { 
-            // Return corresponding element.
-            CIO<_T> * cio_p = dynamic_cast< CIO<_T> *> (it->second);
-            if ( cio_p )
-                return (const _T &) *( cio_p ->getPtr() );
-            else
-            {
-                // Return empty element.
-                printf("%s:%i Object with Id \"%s\" is not of type %s.\n", __FILE__, __LINE__,
-                       f_id_str.c_str(),
-                       typeid(_T).name() );
+        const _T * ptr_p = getInput<_T> ( f_id_str );
 
-                return f_default;
-            }
-        }
+        return ptr_p ? *ptr_p : f_default;
     }
 
     /// Get input for this operator
@@ -549,39 +633,30 @@ namespace QCV
     _T * 
     COperator::getInput ( const std::string &f_id_str ) const
     {
-        // Find object.
-        const std::map<std::string, CIOBase*>::const_iterator 
-            it = m_ios.find( f_id_str );
+        CIOLock locker;
+
+        // Find object here or at higher levels.
+        CIOBase * io_p = findIO ( lookupIOKey ( f_id_str ) );
         
-        if ( it == m_ios.end() )
+        if ( !io_p )
         {
-            if ( getParentOp() )
-            {
-                // Check if the object is available at higher levels.
-                return getParentOp() -> getInput<_T> ( f_id_str );
-            }
-            else
-            {
-                // Return empty element.
-                printf("%s:%i Object with Id \"%s\" not found.\n", __FILE__, __LINE__,f_id_str.c_str());
-                return NULL;
-            }
+            // Return empty element.
+            printf("%s:%i Object with Id \"%s\" not found.\n", __FILE__, __LINE__,f_id_str.c_str());
+            return NULL;
         }
+
+        // Return corresponding element.
+        CIO<_T> * cio_p = dynamic_cast< CIO<_T> *> (io_p);
+        if ( cio_p )
+            return static_cast<_T *> (cio_p ->getPtr() );
         else
-        { 
-            // Return corresponding element.
-            CIO<_T> * cio_p = dynamic_cast< CIO<_T> *> (it->second);
-            if ( cio_p )
-                return static_cast<_T *> (cio_p ->getPtr() );
-            else
-            {
-                // Return empty element.
-                printf("%s:%i Object with Id \"%s\" is not of type %s.\n", __FILE__, __LINE__,
-                       f_id_str.c_str(),
-                       typeid(_T).name() );
+        {
+            // Return empty element.
+            printf("%s:%i Object with Id \"%s\" is not of type %s.\n", __FILE__, __LINE__,
+                   f_id_str.c_str(),
+                   typeid(_T).name() );
 
-                return NULL;
-            }
+            return NULL;
         }
     }
 
@@ -590,41 +665,7 @@ namespace QCV
     _T * 
     COperator::getInput ( const std::string &f_id_str ) 
     {
-        // Find object.
-        const std::map<std::string, CIOBase*>::const_iterator 
-            it = m_ios.find( f_id_str );
-        
-        if ( it == m_ios.end() )
-        {
-            if ( getParentOp() )
-            {
-                // Check if the object is available at higher levels.
-                return getParentOp() -> getInput<_T> ( f_id_str );
-            }
-            else
-            {
-                // Return empty element.
-                printf("%s:%i Object with Id \"%s\" not found.\n", __FILE__, __LINE__, f_id_str.c_str());
-                return NULL;
-            }
-        }
-        else
-        {
-            // Return corresponding element.
-            CIO<_T> * io_p = dynamic_cast< CIO<_T> *> (it->second);
-            if (io_p)
-                return static_cast<_T *> ( io_p->getPtr() );
-            else
-            {
-                // Return empty element.
-                printf("%s:%i Object with Id \"%s\" is not of type %s.\n", __FILE__, __LINE__,
-                       f_id_str.c_str(),
-                       typeid(_T).name() );
-
-                return NULL;
-            }
-            
-        }
+        return static_cast<const COperator *>(this) -> getInput<_T> ( f_id_str );
     }
 } // Namespace VIC
 
@@ -0,0 +1,573 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose.
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+/*@@@**************************************************************************
+* \file  packedSequence.cpp
+* \author Hernan Badino
+* \notes
+*******************************************************************************
+*****             (C) Hernan Badino 2012 - All Rights Reserved            *****
+******************************************************************************/
+
+/* INCLUDES */
+#include <string.h>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#if defined ( HAVE_LZ4 )
+#include <lz4.h>
+#endif
+
+#include "packedSequence.h"
+
+using namespace QCV;
+
+/* CONSTANTS */
+static const char     g_magic_p[8]     = "QCVPSEQ";
+static const uint32_t g_version_ui     = 1;
+static const uint64_t g_alignment_ui   = 64;
+
+namespace
+{
+    /// Reference count and mapping of a view. The reference count
+    /// must be the first member: cv::Mat only knows its address.
+    struct SPlaneMapping
+    {
+        int       refcount_i;
+        void *    addr_p;
+        size_t    size_ui;
+    };
+
+    /// Allocator of the views. It unmaps the plane when the last
+    /// cv::Mat referring to it is released. Matrices created again
+    /// through a view (cv::Mat::create with another size) get heap
+    /// memory, recognizable by a NULL mapping.
+    class CPlaneMappingAllocator: public cv::MatAllocator
+    {
+    public:
+        void allocate ( int f_dims_i, const int * f_sizes_p, int f_type_i,
+                        int * & fr_refcount_p, uchar * & fr_datastart_p,
+                        uchar * & fr_data_p, size_t * fr_step_p )
+        {
+            size_t total_ui = CV_ELEM_SIZE ( f_type_i );
+
+            for (int i = f_dims_i - 1; i >= 0; --i)
+            {
+                fr_step_p[i] = total_ui;
+                total_ui    *= f_sizes_p[i];
+            }
+
+            SPlaneMapping * mapping_p = new SPlaneMapping;
+            mapping_p -> refcount_i = 1;
+            mapping_p -> addr_p     = NULL;
+            mapping_p -> size_ui    = 0;
+
+            fr_refcount_p  = &mapping_p -> refcount_i;
+            fr_datastart_p = fr_data_p = (uchar *) cv::fastMalloc ( total_ui );
+        }
+
+        void deallocate ( int * f_refcount_p, uchar * f_datastart_p,
+                          uchar * /* f_data_p */ )
+        {
+            SPlaneMapping * mapping_p = reinterpret_cast<SPlaneMapping *>(f_refcount_p);
+
+            if ( mapping_p -> addr_p )
+                munmap ( mapping_p -> addr_p, mapping_p -> size_ui );
+            else
+                cv::fastFree ( f_datastart_p );
+
+            delete mapping_p;
+        }
+    };
+
+    CPlaneMappingAllocator g_planeAllocator;
+}
+
+CPackedSeqWriter::CPackedSeqWriter()
+        : m_file_p (                  NULL ),
+          m_compression_e (       PSC_NONE ),
+          m_offset_ui (                  0 ),
+          m_camerasCount_ui (            0 )
+{
+}
+
+CPackedSeqWriter::~CPackedSeqWriter()
+{
+    close();
+}
+
+bool
+CPackedSeqWriter::open ( const std::string &   f_filePath_str,
+                         EPackedSeqCompression f_compression_e )
+{
+    close();
+
+#if !defined ( HAVE_LZ4 )
+    if ( f_compression_e == PSC_LZ4 )
+    {
+        printf("%s:%i QCV was compiled without LZ4 support\n", __FILE__, __LINE__);
+        return false;
+    }
+#endif
+
+    m_file_p = fopen ( f_filePath_str.c_str(), "wb" );
+
+    if ( not m_file_p )
+    {
+        printf("%s:%i File \"%s\" could not be created\n", __FILE__, __LINE__, f_filePath_str.c_str());
+        return false;
+    }
+
+    m_compression_e   = f_compression_e;
+    m_offset_ui       = 0;
+    m_camerasCount_ui = 0;
+    m_frames_v.clear();
+    m_planes_v.clear();
+    m_names_str.clear();
+
+    /// The header is written again when closing.
+    SPackedSeqHeader header;
+    memset ( &header, 0, sizeof(header) );
+
+    return write ( &header, sizeof(header) );
+}
+
+bool
+CPackedSeqWriter::addFrame ( const std::vector<cv::Mat> &     f_images_v,
+                             const std::vector<double> &      f_timeStamps_v,
+                             const std::vector<std::string> & f_names_v )
+{
+    if ( not m_file_p )
+        return false;
+
+    SPackedSeqFrame frame;
+    frame.firstPlane_ui = m_planes_v.size();
+    frame.cameras_ui    = f_images_v.size();
+    frame.reserved_ui   = 0;
+    frame.timeStamp_d   = f_timeStamps_v.empty()?-1:f_timeStamps_v[0];
+
+    for (unsigned int i = 0; i < f_images_v.size(); ++i)
+    {
+        /// Rows must be contiguous.
+        cv::Mat img = f_images_v[i];
+        if ( not img.isContinuous() )
+            img = img.clone();
+
+        SPackedSeqPlane plane;
+        memset ( &plane, 0, sizeof(plane) );
+
+        plane.rows_i        = img.rows;
+        plane.cols_i        = img.cols;
+        plane.type_i        = img.type();
+        plane.step_i        = img.cols * img.elemSize();
+        plane.timeStamp_d   = i<f_timeStamps_v.size()?f_timeStamps_v[i]:-1;
+        plane.nameOffset_ui = m_names_str.size();
+
+        if ( i < f_names_v.size() )
+        {
+            plane.nameLength_ui = f_names_v[i].size();
+            m_names_str += f_names_v[i];
+        }
+
+        const uint64_t rawSize_ui = (uint64_t)img.rows * plane.step_i;
+
+        if ( rawSize_ui > 0 )
+        {
+            if ( not align() )
+                return false;
+
+            plane.offset_ui = m_offset_ui;
+
+            const char * data_p   = (const char *) img.data;
+            uint64_t     stored_ui = rawSize_ui;
+
+#if defined ( HAVE_LZ4 )
+            if ( m_compression_e == PSC_LZ4 && rawSize_ui < (uint64_t)LZ4_MAX_INPUT_SIZE )
+            {
+                m_buffer_v.resize ( LZ4_compressBound ( (int)rawSize_ui ) );
+
+                int size_i = LZ4_compress_default ( data_p,
+                                                    &m_buffer_v[0],
+                                                    (int)rawSize_ui,
+                                                    (int)m_buffer_v.size() );
+
+                /// Incompressible planes are stored uncompressed.
+                if ( size_i > 0 && (uint64_t)size_i < rawSize_ui )
+                {
+                    data_p    = &m_buffer_v[0];
+                    stored_ui = size_i;
+                }
+            }
+#endif
+            plane.storedSize_ui = stored_ui;
+
+            if ( not write ( data_p, stored_ui ) )
+                return false;
+        }
+
+        m_planes_v.push_back ( plane );
+    }
+
+    m_camerasCount_ui = std::max ( m_camerasCount_ui, frame.cameras_ui );
+    m_frames_v.push_back ( frame );
+
+    return true;
+}
+
+bool
+CPackedSeqWriter::close ( )
+{
+    if ( not m_file_p )
+        return false;
+
+    SPackedSeqHeader header;
+    memset ( &header, 0, sizeof(header) );
+
+    memcpy ( header.magic_p, g_magic_p, sizeof(header.magic_p) );
+    header.version_ui      = g_version_ui;
+    header.compression_ui  = m_compression_e;
+    header.framesCount_ui  = m_frames_v.size();
+    header.camerasCount_ui = m_camerasCount_ui;
+
+    bool ok_b = align();
+
+    header.framesOffset_ui = m_offset_ui;
+    if ( ok_b && not m_frames_v.empty() )
+        ok_b = write ( &m_frames_v[0], m_frames_v.size() * sizeof(SPackedSeqFrame) );
+
+    header.planesOffset_ui = m_offset_ui;
+    header.planesCount_ui  = m_planes_v.size();
+    if ( ok_b && not m_planes_v.empty() )
+        ok_b = write ( &m_planes_v[0], m_planes_v.size() * sizeof(SPackedSeqPlane) );
+
+    header.namesOffset_ui = m_offset_ui;
+    header.namesSize_ui   = m_names_str.size();
+    if ( ok_b && not m_names_str.empty() )
+        ok_b = write ( m_names_str.data(), m_names_str.size() );
+
+    if ( ok_b )
+    {
+        ok_b = ( fseek ( m_file_p, 0, SEEK_SET ) == 0 &&
+                 fwrite ( &header, sizeof(header), 1, m_file_p ) == 1 );
+    }
+
+    if ( fclose ( m_file_p ) != 0 )
+        ok_b = false;
+
+    m_file_p = NULL;
+
+    if ( not ok_b )
+        printf("%s:%i Error writing packed sequence\n", __FILE__, __LINE__);
+
+    return ok_b;
+}
+
+bool
+CPackedSeqWriter::write ( const void * f_data_p,
+                          size_t       f_size_ui )
+{
+    if ( fwrite ( f_data_p, 1, f_size_ui, m_file_p ) != f_size_ui )
+    {
+        printf("%s:%i Error writing packed sequence\n", __FILE__, __LINE__);
+        return false;
+    }
+
+    m_offset_ui += f_size_ui;
+    return true;
+}
+
+bool
+CPackedSeqWriter::align ( )
+{
+    static const char zeros_p[g_alignment_ui] = {0};
+
+    const uint64_t rem_ui = m_offset_ui % g_alignment_ui;
+
+    if ( rem_ui == 0 )
+        return true;
+
+    return write ( zeros_p, g_alignment_ui - rem_ui );
+}
+
+CPackedSeqReader::CPackedSeqReader()
+        : m_fd_i (                      -1 ),
+          m_data_p (                  NULL ),
+          m_size_ui (                    0 ),
+          m_header_p (                NULL ),
+          m_frames_p (                NULL ),
+          m_planes_p (                NULL ),
+          m_names_p (                 NULL )
+{
+}
+
+CPackedSeqReader::~CPackedSeqReader()
+{
+    close();
+}
+
+bool
+CPackedSeqReader::open ( const std::string & f_filePath_str )
+{
+    close();
+
+    m_fd_i = ::open ( f_filePath_str.c_str(), O_RDONLY );
+
+    if ( m_fd_i < 0 )
+    {
+        printf("%s:%i File \"%s\" could not be opened\n", __FILE__, __LINE__, f_filePath_str.c_str());
+        return false;
+    }
+
+    struct stat st;
+
+    if ( fstat ( m_fd_i, &st ) != 0 ||
+         (uint64_t) st.st_size < sizeof(SPackedSeqHeader) )
+    {
+        printf("%s:%i File \"%s\" is not a packed sequence\n", __FILE__, __LINE__, f_filePath_str.c_str());
+        close();
+        return false;
+    }
+
+    m_size_ui = st.st_size;
+
+    /// Read-only: the images are handed out through their own
+    /// mappings (see getFrame).
+    void * data_p = mmap ( NULL, m_size_ui,
+                           PROT_READ, MAP_SHARED,
+                           m_fd_i, 0 );
+
+    if ( data_p == MAP_FAILED )
+    {
+        printf("%s:%i File \"%s\" could not be mapped\n", __FILE__, __LINE__, f_filePath_str.c_str());
+        close();
+        return false;
+    }
+
+    m_data_p   = (unsigned char *) data_p;
+    m_header_p = (const SPackedSeqHeader *) m_data_p;
+
+    const SPackedSeqHeader & h = *m_header_p;
+
+    bool ok_b = ( memcmp ( h.magic_p, g_magic_p, sizeof(h.magic_p) ) == 0 &&
+                  h.version_ui == g_version_ui );
+
+    /// Check that the tables are inside the file.
+    ok_b = ok_b &&
+        h.framesOffset_ui <= m_size_ui &&
+        h.framesCount_ui  <= (m_size_ui - h.framesOffset_ui) / sizeof(SPackedSeqFrame) &&
+        h.planesOffset_ui <= m_size_ui &&
+        h.planesCount_ui  <= (m_size_ui - h.planesOffset_ui) / sizeof(SPackedSeqPlane) &&
+        h.namesOffset_ui  <= m_size_ui &&
+        h.namesSize_ui    <= m_size_ui - h.namesOffset_ui;
+
+    if ( ok_b )
+    {
+        m_frames_p = (const SPackedSeqFrame *) (m_data_p + h.framesOffset_ui);
+        m_planes_p = (const SPackedSeqPlane *) (m_data_p + h.planesOffset_ui);
+        m_names_p  = (const char *)            (m_data_p + h.namesOffset_ui);
+
+        for (uint32_t f = 0; ok_b && f < h.framesCount_ui; ++f)
+        {
+            ok_b = ( m_frames_p[f].firstPlane_ui <= h.planesCount_ui &&
+                     m_frames_p[f].cameras_ui    <= h.planesCount_ui - m_frames_p[f].firstPlane_ui );
+        }
+
+        for (uint64_t p = 0; ok_b && p < h.planesCount_ui; ++p)
+        {
+            const SPackedSeqPlane & plane = m_planes_p[p];
+
+            ok_b = ( plane.offset_ui     <= m_size_ui &&
+                     plane.storedSize_ui <= m_size_ui - plane.offset_ui &&
+                     plane.nameOffset_ui <= h.namesSize_ui &&
+                     plane.nameLength_ui <= h.namesSize_ui - plane.nameOffset_ui &&
+                     plane.rows_i >= 0 && plane.cols_i >= 0 &&
+                     plane.step_i >= plane.cols_i * (int)CV_ELEM_SIZE(plane.type_i) );
+        }
+    }
+
+    if ( not ok_b )
+    {
+        printf("%s:%i File \"%s\" is not a valid packed sequence\n", __FILE__, __LINE__, f_filePath_str.c_str());
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void
+CPackedSeqReader::close ( )
+{
+    if ( m_data_p )
+        munmap ( m_data_p, m_size_ui );
+
+    if ( m_fd_i >= 0 )
+        ::close ( m_fd_i );
+
+    m_fd_i     = -1;
+    m_data_p   = NULL;
+    m_size_ui  = 0;
+    m_header_p = NULL;
+    m_frames_p = NULL;
+    m_planes_p = NULL;
+    m_names_p  = NULL;
+}
+
+bool
+CPackedSeqReader::getFrame ( int                        f_frame_i,
+                             std::vector<cv::Mat> &     fr_images_v,
+                             std::vector<double> &      fr_timeStamps_v,
+                             std::vector<std::string> & fr_names_v ) const
+{
+    if ( f_frame_i < 0 || f_frame_i >= getFramesCount() )
+        return false;
+
+    const SPackedSeqFrame & frame = m_frames_p[f_frame_i];
+
+    fr_images_v.resize     ( frame.cameras_ui );
+    fr_timeStamps_v.resize ( frame.cameras_ui );
+    fr_names_v.resize      ( frame.cameras_ui );
+
+    bool ok_b = true;
+
+    for (uint32_t i = 0; i < frame.cameras_ui; ++i)
+    {
+        const SPackedSeqPlane & plane = m_planes_p[frame.firstPlane_ui + i];
+
+        fr_timeStamps_v[i] = plane.timeStamp_d;
+        fr_names_v[i].assign ( m_names_p + plane.nameOffset_ui, plane.nameLength_ui );
+
+        const uint64_t rawSize_ui = (uint64_t)plane.rows_i * plane.step_i;
+
+        if ( plane.storedSize_ui == 0 )
+        {
+            fr_images_v[i] = cv::Mat();
+        }
+        else if ( plane.storedSize_ui == rawSize_ui )
+        {
+            /// Zero copy. A private mapping of the plane keeps the
+            /// writes of the operators out of the file and out of
+            /// later views of the same frame.
+            const long     pageSize_i = sysconf ( _SC_PAGESIZE );
+            const uint64_t start_ui   = plane.offset_ui - plane.offset_ui % pageSize_i;
+            const size_t   size_ui    = plane.offset_ui + rawSize_ui - start_ui;
+
+            void * addr_p = mmap ( NULL, size_ui,
+                                   PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                                   m_fd_i, start_ui );
+
+            if ( addr_p == MAP_FAILED )
+            {
+                printf("%s:%i Plane %i of frame %i could not be mapped\n", __FILE__, __LINE__, i, f_frame_i);
+                fr_images_v[i] = cv::Mat();
+                ok_b = false;
+                continue;
+            }
+
+            SPlaneMapping * mapping_p = new SPlaneMapping;
+            mapping_p -> refcount_i = 1;
+            mapping_p -> addr_p     = addr_p;
+            mapping_p -> size_ui    = size_ui;
+
+            cv::Mat view ( plane.rows_i, plane.cols_i, plane.type_i,
+                           (uchar *) addr_p + (plane.offset_ui - start_ui),
+                           plane.step_i );
+
+            /// The view owns the mapping from now on.
+            view.refcount  = &mapping_p -> refcount_i;
+            view.allocator = &g_planeAllocator;
+
+            fr_images_v[i] = view;
+        }
+        else
+        {
+#if defined ( HAVE_LZ4 )
+            /// A new matrix every time: operators might keep the
+            /// previous image.
+            cv::Mat img ( plane.rows_i, plane.cols_i, plane.type_i );
+
+            int size_i = LZ4_decompress_safe ( (const char *) m_data_p + plane.offset_ui,
+                                               (char *) img.data,
+                                               (int) plane.storedSize_ui,
+                                               (int) rawSize_ui );
+
+            if ( size_i != (int) rawSize_ui )
+            {
+                printf("%s:%i Plane %i of frame %i is corrupted\n", __FILE__, __LINE__, i, f_frame_i);
+                img = cv::Mat();
+                ok_b = false;
+            }
+
+            fr_images_v[i] = img;
+#else
+            printf("%s:%i QCV was compiled without LZ4 support\n", __FILE__, __LINE__);
+            fr_images_v[i] = cv::Mat();
+            ok_b = false;
+#endif
+        }
+    }
+
+    return ok_b;
+}
+
+void
+CPackedSeqReader::willNeed ( int f_frame_i ) const
+{
+    if ( f_frame_i < 0 || f_frame_i >= getFramesCount() )
+        return;
+
+    const SPackedSeqFrame & frame = m_frames_p[f_frame_i];
+    const long pageSize_i = sysconf ( _SC_PAGESIZE );
+
+    for (uint32_t i = 0; i < frame.cameras_ui; ++i)
+    {
+        const SPackedSeqPlane & plane = m_planes_p[frame.firstPlane_ui + i];
+
+        if ( plane.storedSize_ui == 0 ) continue;
+
+        const uint64_t start_ui = plane.offset_ui - plane.offset_ui % pageSize_i;
+
+        posix_madvise ( m_data_p + start_ui,
+                        plane.offset_ui + plane.storedSize_ui - start_ui,
+                        POSIX_MADV_WILLNEED );
+    }
+}
+
+int
+CPackedSeqReader::getFramesCount ( ) const
+{
+    return m_header_p?(int)m_header_p->framesCount_ui:0;
+}
+
+int
+CPackedSeqReader::getCamerasCount ( ) const
+{
+    return m_header_p?(int)m_header_p->camerasCount_ui:0;
+}
+
+EPackedSeqCompression
+CPackedSeqReader::getCompression ( ) const
+{
+    return m_header_p?(EPackedSeqCompression)m_header_p->compression_ui:PSC_NONE;
+}
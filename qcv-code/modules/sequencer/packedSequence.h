@@ -0,0 +1,258 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose.
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+#ifndef __PACKEDSEQUENCE_H
+#define __PACKEDSEQUENCE_H
+
+/**
+ *******************************************************************************
+ *
+ * @file packedSequence.h
+ *
+ * \class CPackedSeqWriter, CPackedSeqReader
+ * \author Hernan Badino (hernan.badino@gmail.com)
+ *
+ * \brief Single file container for image sequences.
+ *
+ * Layout of the file (host byte order):
+ *
+ *  - SPackedSeqHeader.
+ *  - Image planes, each one starting at a 64 byte aligned offset.
+ *    Planes are stored uncompressed or LZ4 compressed.
+ *  - Frame index: one SPackedSeqFrame per frame.
+ *  - Plane table: one SPackedSeqPlane per image of every frame.
+ *  - Name table: original file names of the images.
+ *
+ * The reader maps the file read-only in memory. Uncompressed planes are
+ * returned as cv::Mat views without copying. Every view gets its own
+ * private copy-on-write mapping of the plane, which is owned by the
+ * cv::Mat reference count: an operator writing into an image only
+ * changes its own pages, and the next view of the same frame shows the
+ * file content again. Views stay valid after the reader is closed or
+ * opens another file. LZ4 support requires HAVE_LZ4.
+ *
+ *******************************************************************************/
+
+/* INCLUDES */
+#include <stdio.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include <opencv/cv.h>
+
+/* CONSTANTS */
+
+namespace QCV
+{
+    /// Compression of the image planes.
+    typedef enum
+    {
+        PSC_NONE = 0,
+        PSC_LZ4  = 1
+    } EPackedSeqCompression;
+
+    /// File header.
+    struct SPackedSeqHeader
+    {
+        /// "QCVPSEQ".
+        char      magic_p[8];
+
+        /// Format version.
+        uint32_t  version_ui;
+
+        /// Compression (EPackedSeqCompression).
+        uint32_t  compression_ui;
+
+        /// Number of frames.
+        uint32_t  framesCount_ui;
+
+        /// Maximal number of images in a frame.
+        uint32_t  camerasCount_ui;
+
+        /// Offset of the frame index.
+        uint64_t  framesOffset_ui;
+
+        /// Offset and number of entries of the plane table.
+        uint64_t  planesOffset_ui;
+        uint64_t  planesCount_ui;
+
+        /// Offset and size of the name table.
+        uint64_t  namesOffset_ui;
+        uint64_t  namesSize_ui;
+    };
+
+    /// Entry of the frame index.
+    struct SPackedSeqFrame
+    {
+        /// Index of the first plane of the frame.
+        uint64_t  firstPlane_ui;
+
+        /// Number of images in the frame.
+        uint32_t  cameras_ui;
+
+        uint32_t  reserved_ui;
+
+        /// Time stamp of the first image [s].
+        double    timeStamp_d;
+    };
+
+    /// Entry of the plane table.
+    struct SPackedSeqPlane
+    {
+        /// Offset and size of the stored data. A size of 0 means
+        /// no image. The plane is uncompressed if the size is equal
+        /// to rows * step.
+        uint64_t  offset_ui;
+        uint64_t  storedSize_ui;
+
+        /// Offset of the file name in the name table.
+        uint64_t  nameOffset_ui;
+
+        /// Image format.
+        int32_t   rows_i;
+        int32_t   cols_i;
+        int32_t   type_i;
+        int32_t   step_i;
+
+        /// Length of the file name.
+        uint32_t  nameLength_ui;
+
+        uint32_t  reserved_ui;
+
+        /// Time stamp [s].
+        double    timeStamp_d;
+    };
+
+    class CPackedSeqWriter
+    {
+    /// Constructors, Destructors
+    public:
+        CPackedSeqWriter();
+        virtual ~CPackedSeqWriter();
+
+    /// Operations.
+    public:
+        /// Create the file.
+        bool    open ( const std::string &   f_filePath_str,
+                       EPackedSeqCompression f_compression_e = PSC_NONE );
+
+        /// Append a frame. Empty images are allowed.
+        bool    addFrame ( const std::vector<cv::Mat> &     f_images_v,
+                           const std::vector<double> &      f_timeStamps_v,
+                           const std::vector<std::string> & f_names_v );
+
+        /// Write the index and close the file.
+        bool    close ( );
+
+        /// Is the file open?
+        bool    isOpen ( ) const { return m_file_p != NULL; }
+
+    /// Private methods.
+    private:
+        bool    write ( const void * f_data_p,
+                        size_t       f_size_ui );
+
+        bool    align ( );
+
+    /// Private members.
+    private:
+        /// Output file.
+        FILE *                        m_file_p;
+
+        /// Compression of the planes.
+        EPackedSeqCompression         m_compression_e;
+
+        /// Current write position.
+        uint64_t                      m_offset_ui;
+
+        /// Maximal number of images in a frame.
+        uint32_t                      m_camerasCount_ui;
+
+        /// Frame index.
+        std::vector<SPackedSeqFrame>  m_frames_v;
+
+        /// Plane table.
+        std::vector<SPackedSeqPlane>  m_planes_v;
+
+        /// Name table.
+        std::string                   m_names_str;
+
+        /// Compression buffer.
+        std::vector<char>             m_buffer_v;
+    };
+
+    class CPackedSeqReader
+    {
+    /// Constructors, Destructors
+    public:
+        CPackedSeqReader();
+        virtual ~CPackedSeqReader();
+
+    /// Operations.
+    public:
+        /// Map the file.
+        bool    open ( const std::string & f_filePath_str );
+
+        /// Unmap the file. Views returned by getFrame stay valid.
+        void    close ( );
+
+        /// Get the images, time stamps and file names of a frame.
+        bool    getFrame ( int                        f_frame_i,
+                           std::vector<cv::Mat> &     fr_images_v,
+                           std::vector<double> &      fr_timeStamps_v,
+                           std::vector<std::string> & fr_names_v ) const;
+
+        /// Advise the kernel to read the data of a frame in advance.
+        void    willNeed ( int f_frame_i ) const;
+
+    /// Get/Set
+    public:
+        bool    isOpen ( ) const { return m_data_p != NULL; }
+
+        int     getFramesCount ( ) const;
+
+        int     getCamerasCount ( ) const;
+
+        EPackedSeqCompression
+                getCompression ( ) const;
+
+    /// Private members.
+    private:
+        /// File descriptor.
+        int                           m_fd_i;
+
+        /// Mapped memory.
+        unsigned char *               m_data_p;
+
+        /// Size of the mapping.
+        size_t                        m_size_ui;
+
+        /// Header, frame index and plane table in the mapped memory.
+        const SPackedSeqHeader *      m_header_p;
+        const SPackedSeqFrame *       m_frames_p;
+        const SPackedSeqPlane *       m_planes_p;
+        const char *                  m_names_p;
+    };
+}
+
+#endif // __PACKEDSEQUENCE_H
@@ -28,12 +28,18 @@
 ******************************************************************************/
 
 /* INCLUDES */
-#include <QApplication>
+#include <QCoreApplication>
 #include <QDir>
 #include <QTimer>
 #include <opencv/highgui.h>
 
+#include <algorithm>
+#include <stdlib.h>
+
 #include "seqDevHDImg.h"
+#include "imagePrefetcher.h"
+#include "clockHandler.h"
+#include "clock.h"
 #include "paramIOXmlFile.h"
 
 using namespace QCV;
@@ -50,8 +56,14 @@ CSeqDevHDImg::CSeqDevHDImg(const std::string &f_confFilePath_str)
           m_printDebug_b (                      true ),
           m_fskip_i (                              0 ),
           m_loopMode_b (                       false ),
-          m_exitOnLastFrame_b (                false )
+          m_exitOnLastFrame_b (                false ),
+          m_prefetcher_p (                      NULL ),
+          m_prefetchWindow_i (                     4 ),
+          m_hitClock_p (                        NULL ),
+          m_missClock_p (                       NULL )
 {
+    m_prefetcher_p = new CImagePrefetcher ( 2, 256 * 1024 * 1024 );
+
     m_qtPlay_p = new QTimer ( this );
     connect(m_qtPlay_p, SIGNAL(timeout()), this, SLOT(timeOut()));
 
@@ -66,6 +78,7 @@ CSeqDevHDImg::CSeqDevHDImg(const std::string &f_confFilePath_str)
 /// Destructor
 CSeqDevHDImg::~CSeqDevHDImg()
 {
+    delete m_prefetcher_p;
 }
 
 void
@@ -114,7 +127,7 @@ bool CSeqDevHDImg::nextFrame()
             pause();
 
         if ( m_exitOnLastFrame_b )
-            QApplication::exit(1);
+            QCoreApplication::exit(1);
     }
     
     return loadCurrentFrame();
@@ -134,6 +147,18 @@ bool CSeqDevHDImg::loadCurrentFrame()
     if ( m_imageData_v.size() != m_imagesPerFrame_uc )
         m_imageData_v.resize( m_imagesPerFrame_uc );
 
+    /// Frames being decoded or already decoded in background are
+    /// hits. Queued frames are read here and count as misses.
+    std::vector<cv::Mat> images_v;
+    bool hit_b = ( m_prefetchWindow_i > 0 && 
+                   m_prefetcher_p -> isAvailable ( m_currentFrame_i ) );
+
+    CClock * clock_p = hit_b ? m_hitClock_p : m_missClock_p;
+
+    if ( clock_p ) clock_p -> start();
+
+    bool prefetched_b = m_prefetcher_p -> take ( m_currentFrame_i, images_v );
+
     for (int i = 0 ; i < m_imagesPerFrame_uc; ++i)
     {
         if ( (unsigned int) m_currentFrame_i < m_fileName_p[i].size()  )
@@ -144,7 +169,18 @@ bool CSeqDevHDImg::loadCurrentFrame()
 
             m_filePaths_p[i] = (std::string) fullPathFile_str;
 
-            if (!loadImageFile ( fullPathFile_str, m_imageData_v[i].image ))
+            bool loaded_b;
+
+            if ( prefetched_b && i < (int) images_v.size() )
+            {
+                m_imageData_v[i].image = images_v[i];
+                loaded_b = ( images_v[i].size().width  > 0 && 
+                             images_v[i].size().height > 0 );
+            }
+            else
+                loaded_b = loadImageFile ( fullPathFile_str, m_imageData_v[i].image );
+
+            if (!loaded_b)
             {
                 res_b = false;
                 printf("File \"%s\" could not be read", fullPathFile_str.c_str() );
@@ -158,9 +194,121 @@ bool CSeqDevHDImg::loadCurrentFrame()
         }
     }
 
+    if ( clock_p ) clock_p -> stop();
+
+    prefetchFrames();
+
     return res_b;
 }
 
+/// Get the image paths of a frame. Empty if the frame does not
+/// exist for a camera.
+void
+CSeqDevHDImg::getFramePaths ( int                        f_frame_i,
+                              std::vector<std::string> & fr_paths_v ) const
+{
+    fr_paths_v.resize ( m_imagesPerFrame_uc );
+
+    for (int i = 0 ; i < m_imagesPerFrame_uc; ++i)
+    {
+        if ( f_frame_i >= 0 && (unsigned int) f_frame_i < m_fileName_p[i].size() )
+            fr_paths_v[i] = m_directoryPath_p[i] + "/" + m_fileName_p[i][f_frame_i];
+        else
+            fr_paths_v[i] = "";
+    }
+}
+
+/// Frame loaded after f_frame_i in the current play direction,
+/// following the same rules as nextFrame/prevFrame. Returns -1 if
+/// the sequence stops at f_frame_i.
+int
+CSeqDevHDImg::getFollowingFrame ( int f_frame_i ) const
+{
+    int frame_i = f_frame_i;
+
+    if ( m_backward_b )
+    {
+        frame_i -= m_fskip_i + 1;
+        
+        if ( frame_i < 0 )
+            frame_i = m_loopMode_b ? m_framesCount_i-1 : 0;
+    }
+    else
+    {
+        frame_i += m_fskip_i + 1;
+
+        if ( frame_i >= m_framesCount_i )
+            frame_i = m_loopMode_b ? 0 : m_framesCount_i-1;
+    }
+
+    return frame_i == f_frame_i ? -1 : frame_i;
+}
+
+/// Schedule the decoding of the frames following the current one.
+void
+CSeqDevHDImg::prefetchFrames ( )
+{
+    if ( m_prefetchWindow_i <= 0 )
+        return;
+
+    std::vector<int>                        frames_v;
+    std::vector<std::vector<std::string> >  paths_v;
+
+    int frame_i = m_currentFrame_i;
+
+    for (int k = 0; k < m_prefetchWindow_i; ++k)
+    {
+        frame_i = getFollowingFrame ( frame_i );
+
+        if ( frame_i < 0 || 
+             frame_i == m_currentFrame_i ||
+             std::find ( frames_v.begin(), frames_v.end(), frame_i ) != frames_v.end() )
+            break;
+
+        frames_v.push_back ( frame_i );
+        paths_v.push_back ( std::vector<std::string>() );
+        getFramePaths ( frame_i, paths_v.back() );
+    }
+
+    m_prefetcher_p -> schedule ( frames_v, paths_v );
+}
+
+bool
+CSeqDevHDImg::setPrefetchWindow ( int f_frames_i )
+{
+    if ( f_frames_i < 0 )
+        return false;
+
+    m_prefetchWindow_i = f_frames_i;
+
+    if ( m_prefetchWindow_i == 0 )
+        m_prefetcher_p -> clear();
+
+    return true;
+}
+
+bool
+CSeqDevHDImg::setPrefetchMemory ( size_t f_bytes_ui )
+{
+    return m_prefetcher_p -> setMaxBytes ( f_bytes_ui );
+}
+
+bool
+CSeqDevHDImg::setPrefetchThreads ( int f_threads_i )
+{
+    return m_prefetcher_p -> setNumThreads ( f_threads_i );
+}
+
+void
+CSeqDevHDImg::registerClocks ( CClockHandler * f_handler_p,
+                               CNode *         f_node_p )
+{
+    if ( not f_handler_p ) return;
+
+    m_hitClock_p  = f_handler_p -> getClock ( "Prefetch Hit",  f_node_p );
+    m_missClock_p = f_handler_p -> getClock ( "Prefetch Miss", f_node_p );
+}
+
 double CSeqDevHDImg::getTimeStampFromFilename( std::string f_fileName_p )
 {
 #if 0
@@ -250,6 +398,9 @@ bool CSeqDevHDImg::startPlaying()
     m_currentState_e = S_PLAYING;
     m_backward_b = false;
 
+    /// Direction might have changed.
+    prefetchFrames();
+
     if ( not m_qtPlay_p -> isActive() )
         m_qtPlay_p -> start(1);
 
@@ -262,6 +413,9 @@ bool CSeqDevHDImg::startPlayingBackward()
     m_currentState_e = S_PLAYING_BACKWARD;
     m_backward_b = true;
 
+    /// Direction might have changed.
+    prefetchFrames();
+
     if ( not m_qtPlay_p -> isActive() )
         m_qtPlay_p -> start(1);
 
@@ -366,6 +520,21 @@ CSeqDevHDImg::loadNewSequence ( const std::string &f_confFilePath_str )
         
             findFiles ( m_directoryPath_p[i], filter_str, m_fileName_p[i] );
         }
+
+        /// Optional prefetching parameters.
+        std::string value_str;
+
+        if ( paraReader.get ( "Prefetch Window", value_str ) )
+            setPrefetchWindow ( atoi ( value_str.c_str() ) );
+
+        if ( paraReader.get ( "Prefetch Memory MB", value_str ) )
+            setPrefetchMemory ( (size_t) atoi ( value_str.c_str() ) * 1024 * 1024 );
+
+        if ( paraReader.get ( "Prefetch Threads", value_str ) )
+            setPrefetchThreads ( atoi ( value_str.c_str() ) );
+
+        /// Frames of a previous sequence.
+        m_prefetcher_p -> clear();
         
         if (i == 0)
         {
@@ -64,6 +64,8 @@ namespace QCV
 
     /* PROTOTYPES */
     class CSeqDevHDImgDlg;
+    class CImagePrefetcher;
+    class CClock;
     
     class CSeqDevHDImg: public CSeqDeviceControl
     {
@@ -120,6 +122,26 @@ namespace QCV
 
         virtual bool     setExitOnLastFrame( bool f_val_b )  { m_exitOnLastFrame_b = f_val_b; return true; };
 
+        /// Set the number of frames to decode in advance (0 disables
+        /// the prefetching).
+        bool             setPrefetchWindow ( int f_frames_i );
+        int              getPrefetchWindow ( ) const { return m_prefetchWindow_i; }
+
+        /// Set the maximal memory of the prefetched images in bytes.
+        bool             setPrefetchMemory ( size_t f_bytes_ui );
+
+        /// Set the number of prefetching threads.
+        bool             setPrefetchThreads ( int f_threads_i );
+
+        /// Get the image paths of a frame (0-based). Paths are empty
+        /// for cameras with less images.
+        void             getFramePaths ( int                        f_frame_i,
+                                         std::vector<std::string> & fr_paths_v ) const;
+
+        /// Register the prefetch hit and miss clocks.
+        virtual void     registerClocks ( CClockHandler * f_handler_p,
+                                          CNode *         f_node_p );
+
         /// Get number of frames in this sequence.
         virtual int getNumberOfFrames() const;
  
@@ -164,6 +186,10 @@ namespace QCV
         
         bool   loadCurrentFrame();
 
+        int    getFollowingFrame ( int f_frame_i ) const;
+
+        void   prefetchFrames ( );
+
         bool   loadImageFile( std::string f_filePath_str, cv::Mat &fr_image_p );
 
         double getTimeStampFromFilename( std::string f_fileName_p );
@@ -226,6 +252,18 @@ namespace QCV
 
         /// Exit on last frame.
         bool                          m_exitOnLastFrame_b;
+
+        /// Background image decoder.
+        CImagePrefetcher *            m_prefetcher_p;
+
+        /// Number of frames to decode in advance.
+        int                           m_prefetchWindow_i;
+
+        /// Clock of the frames served by the prefetcher.
+        CClock *                      m_hitClock_p;
+
+        /// Clock of the frames read synchronously.
+        CClock *                      m_missClock_p;
     };
 }
 
@@ -0,0 +1,311 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose.
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+/*@@@**************************************************************************
+* \file  seqDevPackedSeq.cpp
+* \author Hernan Badino
+* \notes
+*******************************************************************************
+*****             (C) Hernan Badino 2012 - All Rights Reserved            *****
+******************************************************************************/
+
+/* INCLUDES */
+#include <QCoreApplication>
+#include <QTimer>
+
+#include "seqDevPackedSeq.h"
+
+using namespace QCV;
+
+CSeqDevPackedSeq::CSeqDevPackedSeq(const std::string &f_filePath_str)
+        : m_qtPlay_p (                          NULL ),
+          m_directory_str (                      "." ),
+          m_currentFrame_i (                      -1 ),
+          m_framesCount_i (                        0 ),
+          m_backward_b (                       false ),
+          m_fskip_i (                              0 ),
+          m_loopMode_b (                       false ),
+          m_exitOnLastFrame_b (                false )
+{
+    m_qtPlay_p = new QTimer ( this );
+    connect(m_qtPlay_p, SIGNAL(timeout()), this, SLOT(timeOut()));
+
+    m_currentState_e = S_PAUSED;
+
+    if ( f_filePath_str != "" )
+        loadNewSequence ( f_filePath_str );
+}
+
+/// Destructor
+CSeqDevPackedSeq::~CSeqDevPackedSeq()
+{
+}
+
+void
+CSeqDevPackedSeq::timeOut()
+{
+    if (m_backward_b)
+        prevFrame();
+    else
+        nextFrame();
+
+    emit cycle( );
+}
+
+/// Initialize Device.
+bool
+CSeqDevPackedSeq::initialize()
+{
+    m_currentFrame_i = 0;
+
+    return loadCurrentFrame();
+}
+
+/// Load next frame
+bool CSeqDevPackedSeq::nextFrame()
+{
+    ++m_currentFrame_i;
+    m_currentFrame_i += m_fskip_i;
+
+    if (m_currentFrame_i >= m_framesCount_i)
+    {
+        if ( !m_loopMode_b )
+            m_currentFrame_i  =  m_framesCount_i-1;
+        else
+            m_currentFrame_i  =  0;
+    }
+
+    if (m_currentFrame_i == m_framesCount_i-1)
+    {
+        if ( !m_loopMode_b )
+            pause();
+
+        if ( m_exitOnLastFrame_b )
+            QCoreApplication::exit(1);
+    }
+
+    return loadCurrentFrame();
+}
+
+/// Load previous frame
+bool CSeqDevPackedSeq::prevFrame()
+{
+    --m_currentFrame_i;
+    m_currentFrame_i -= m_fskip_i;
+
+    if (m_currentFrame_i < 0 )
+    {
+        if ( !m_loopMode_b )
+            m_currentFrame_i  =  0;
+        else
+            m_currentFrame_i  =  m_framesCount_i-1;
+    }
+
+    if (m_currentFrame_i == 0)
+    {
+        if ( !m_loopMode_b )
+            pause();
+    }
+
+    return loadCurrentFrame();
+}
+
+/// Load next frame
+bool CSeqDevPackedSeq::reloadFrame()
+{
+    return loadCurrentFrame();
+}
+
+/// Load the current frame from the mapped file.
+bool CSeqDevPackedSeq::loadCurrentFrame()
+{
+    if ( (int) m_imageData_v.size() != m_reader.getCamerasCount() )
+        m_imageData_v.resize( m_reader.getCamerasCount() );
+
+    bool res_b = m_reader.getFrame ( m_currentFrame_i,
+                                     m_images_v,
+                                     m_timeStamps_v,
+                                     m_names_v );
+
+    if ( !res_b )
+        printf("Frame %i could not be read\n", m_currentFrame_i );
+
+    for (unsigned int i = 0 ; i < m_imageData_v.size(); ++i)
+    {
+        if ( i < m_images_v.size() )
+        {
+            m_imageData_v[i].image       = m_images_v[i];
+            m_imageData_v[i].timeStamp_d = m_timeStamps_v[i];
+            m_imageData_v[i].path_str    = m_directory_str + "/" + m_names_v[i];
+        }
+        else
+        {
+            /// This frame has less images: do not keep the ones of
+            /// a previous frame.
+            m_imageData_v[i].image       = cv::Mat();
+            m_imageData_v[i].timeStamp_d = 0.;
+            m_imageData_v[i].path_str    = "";
+        }
+    }
+
+    /// Ask the kernel to read the following frame.
+    int step_i = m_fskip_i + 1;
+    m_reader.willNeed ( m_currentFrame_i + (m_backward_b?-step_i:step_i) );
+
+    return res_b;
+}
+
+/// Load next frame
+bool CSeqDevPackedSeq::goToFrame( int f_frameNumber_i )
+{
+    if ( f_frameNumber_i > 0 && f_frameNumber_i <= m_framesCount_i )
+    {
+        m_currentFrame_i = f_frameNumber_i - 1;
+        return loadCurrentFrame();
+    }
+
+    return false;
+}
+
+/// Stop/Stand
+bool CSeqDevPackedSeq::stop()
+{
+    m_currentFrame_i = 0;
+    m_currentState_e = S_PAUSED;
+    // Stop timer.
+    m_qtPlay_p -> stop();
+    return true;
+}
+
+/// Play
+bool CSeqDevPackedSeq::startPlaying()
+{
+    m_currentState_e = S_PLAYING;
+    m_backward_b = false;
+
+    if ( not m_qtPlay_p -> isActive() )
+        m_qtPlay_p -> start(1);
+
+    return true;
+}
+
+/// Play Backwards
+bool CSeqDevPackedSeq::startPlayingBackward()
+{
+    m_currentState_e = S_PLAYING_BACKWARD;
+    m_backward_b = true;
+
+    if ( not m_qtPlay_p -> isActive() )
+        m_qtPlay_p -> start(1);
+
+    return true;
+}
+
+/// Pause
+bool CSeqDevPackedSeq::pause()
+{
+    m_currentState_e = S_PAUSED;
+    m_qtPlay_p -> stop();
+    return true;
+}
+
+/// Get number of frames in this sequence.
+int CSeqDevPackedSeq::getNumberOfFrames() const
+{
+    return m_framesCount_i;
+}
+
+/// Get current frame in the sequence.
+int CSeqDevPackedSeq::getCurrentFrame() const
+{
+    return m_currentFrame_i+1;
+}
+
+/// Is a forward/backward device?
+bool CSeqDevPackedSeq::isBidirectional() const
+{
+    return true;
+}
+
+bool
+CSeqDevPackedSeq::loadNewSequence ( const std::string &f_filePath_str )
+{
+    /// The views of the previous file keep their own mappings, so
+    /// operators still holding them are not affected.
+    m_imageData_v.clear();
+    m_imageVector_v.clear();
+    m_images_v.clear();
+
+    m_framesCount_i  = 0;
+    m_currentFrame_i = -1;
+
+    if ( !m_reader.open ( f_filePath_str ) )
+        return false;
+
+    m_framesCount_i = m_reader.getFramesCount();
+
+    int pos_i = f_filePath_str.find_last_of ("/\\");
+
+    if ( pos_i != -1 )
+        m_directory_str = f_filePath_str.substr ( 0, pos_i );
+    else
+        m_directory_str = std::string(".");
+
+    printf("Packed sequence %s: %i frames, %i images per frame%s\n",
+           f_filePath_str.c_str(),
+           m_framesCount_i,
+           m_reader.getCamerasCount(),
+           m_reader.getCompression() == PSC_LZ4?", LZ4 compressed":"" );
+
+    emit start();
+
+    return m_framesCount_i > 0;
+}
+
+bool
+CSeqDevPackedSeq::registerOutputs (
+    std::map< std::string, CIOBase* > &fr_map )
+{
+    fr_map[ "Device Images" ] = new CIO<CInpImgFromFileVector>(&m_imageData_v);
+
+    m_imageVector_v = m_imageData_v;
+
+    fr_map[ "Input Images" ] = new CIO<CMatVector>(&m_imageVector_v);
+
+    char txt[256];
+
+    for ( uint8_t i = 0 ; i < m_imageData_v.size() ; ++i)
+    {
+        sprintf(txt, "Image %i", i);
+        fr_map[txt] = new CIO<cv::Mat>(&m_imageData_v[i].image);
+
+        sprintf(txt, "Image %i Timestamp", i);
+        fr_map[txt] = new CIO<double>(&m_imageData_v[i].timeStamp_d);
+
+        sprintf(txt, "Image %i Path", i);
+        fr_map[txt] = new CIO<std::string>(&m_imageData_v[i].path_str);
+    }
+
+    fr_map[ "Frame Number" ] = new CIO<int>(&m_currentFrame_i);
+    fr_map[ "Frame Count" ]  = new CIO<int>(&m_framesCount_i);
+
+    return true;
+}
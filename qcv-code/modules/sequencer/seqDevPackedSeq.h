@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose.
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+#ifndef __SEQDEVPACKEDSEQ_H
+#define __SEQDEVPACKEDSEQ_H
+
+/**
+ *******************************************************************************
+ *
+ * @file seqDevPackedSeq.h
+ *
+ * \class CSeqDevPackedSeq
+ * \author Hernan Badino (hernan.badino@gmail.com)
+ *
+ * \brief Device control class for reading packed sequence files.
+ *
+ * This class is derived from CSeqDeviceControl and plays sequences
+ * stored in a single file (see packedSequence.h) with the same outputs
+ * as CSeqDevHDImg. The file is memory mapped and uncompressed images
+ * are not copied. The image paths point to the directory of the
+ * packed file, so that files like camera.xml can be placed next to it.
+ *
+ *******************************************************************************/
+
+/* INCLUDES */
+#include "seqDeviceControl.h"
+#include "imageFromFile.h"
+#include "matVector.h"
+#include "packedSequence.h"
+#include "io.h"
+
+#include <vector>
+#include <map>
+#include <QtCore/QObject>
+
+/* PROTOTYPES */
+class QTimer;
+class QWidget;
+
+namespace QCV
+{
+    class CSeqDevPackedSeq: public CSeqDeviceControl
+    {
+        Q_OBJECT
+
+    /// Constructors, Destructors
+    public:
+        /// Constructor
+        CSeqDevPackedSeq( const std::string &f_filePath_str = "" );
+
+        /// Destructor
+        virtual ~CSeqDevPackedSeq();
+
+    /// Sequence Handling.
+    public:
+        /// Initialize Device.
+        virtual bool initialize();
+
+        /// Load next frame
+        virtual bool nextFrame();
+
+        /// Load previous frame
+        virtual bool prevFrame();
+
+        /// Load next frame
+        virtual bool reloadFrame();
+
+        /// Load next frame
+        virtual bool goToFrame( int f_frameNumber_i );
+
+        /// Stop/Stand
+        virtual bool stop();
+
+         /// Play
+        virtual bool startPlaying();
+
+         /// Play Backwards
+        virtual bool startPlayingBackward();
+
+         /// Pause
+        virtual bool pause();
+
+    /// Get/Set
+    public:
+
+        /// Set the number of frames to skip.
+        virtual bool     setFrameSkip(int f_skip_i ) { m_fskip_i = f_skip_i; return true; };
+
+        /// Set loop mode.
+        virtual bool     setLoopMode( bool f_val_b ) { m_loopMode_b = f_val_b; return true; };
+
+        virtual bool     setExitOnLastFrame( bool f_val_b )  { m_exitOnLastFrame_b = f_val_b; return true; };
+
+        /// Get number of frames in this sequence.
+        virtual int getNumberOfFrames() const;
+
+        /// Get current frame in the sequence.
+        virtual int getCurrentFrame() const;
+
+        /// Is a forward/backward device?
+        virtual bool isBidirectional() const;
+
+        /// Derived from CSeqDeviceControl
+        bool     isInitialized() const { return m_framesCount_i > 0; }
+
+    /// Register outputs
+    public:
+        virtual bool registerOutputs (
+                std::map< std::string, CIOBase* > &fr_map );
+
+    /// Register outputs
+    public slots:
+        virtual bool loadNewSequence ( const std::string &f_filePath_str );
+
+        /// Get current frame in the sequence.
+        virtual void timeOut();
+
+    /// Virtual signals
+    signals:
+        void start();
+        void cycle();
+        void reset();
+
+    /// Private methods.
+    private:
+        bool   loadCurrentFrame();
+
+    /// Protected members
+    private:
+        /// Timer for handling play actions.
+        QTimer *                      m_qtPlay_p;
+
+        /// Packed sequence file.
+        CPackedSeqReader              m_reader;
+
+        /// Directory of the packed sequence file.
+        std::string                   m_directory_str;
+
+        /// Current frame
+        int                           m_currentFrame_i;
+
+        /// Number of frames of the sequence.
+        int                           m_framesCount_i;
+
+        /// Backward play.
+        bool                          m_backward_b;
+
+        /// Vector containing current image data, paths and timestamps
+        CInpImgFromFileVector         m_imageData_v;
+
+        /// Vector containing only current image data
+        CMatVector                    m_imageVector_v;
+
+        /// Buffers for reading a frame.
+        std::vector<cv::Mat>          m_images_v;
+        std::vector<double>           m_timeStamps_v;
+        std::vector<std::string>      m_names_v;
+
+        /// Frame skip.
+        int                           m_fskip_i;
+
+        /// Loop mode.
+        bool                          m_loopMode_b;
+
+        /// Exit on last frame.
+        bool                          m_exitOnLastFrame_b;
+    };
+}
+
+#endif // __SEQDEVPACKEDSEQ_H
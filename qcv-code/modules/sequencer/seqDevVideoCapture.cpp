@@ -90,7 +90,7 @@ bool CSeqDevVideoCapture::nextFrame()
     /// Get image.
     (*m_capture_p) >> frame; // get a new frame from camera
 
-    if ( frame.size().width < 0 ) return false;
+    if ( frame.empty() ) return false;
 
     m_imageData_v.resize(1);
     frame.copyTo(m_imageData_v[0].image);
@@ -45,6 +45,8 @@ namespace QCV
     /* PROTOTYPES */
     class CParameterSet;
     class CIOBase;
+    class CClockHandler;
+    class CNode;
     
     class CSeqDeviceControl: public QObject
     {
@@ -115,6 +117,10 @@ namespace QCV
         /// Set loop mode.
         virtual bool     setExitOnLastFrame( bool /* f_val_b */ ) { return false; };
 
+        /// Register the clocks of the device under the given node.
+        virtual void     registerClocks ( CClockHandler * /* f_handler_p */,
+                                          CNode *         /* f_node_p */ ) { };
+
    /// Get/Set 
     public slots:
         
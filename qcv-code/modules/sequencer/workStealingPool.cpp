@@ -0,0 +1,314 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose.
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+/*@@@**************************************************************************
+* \file  workStealingPool.cpp
+* \author Hernan Badino
+* \notes
+*******************************************************************************
+*****             (C) Hernan Badino 2012 - All Rights Reserved            *****
+******************************************************************************/
+
+/* INCLUDES */
+#include <QtCore/QThread>
+#include <QtCore/QMutexLocker>
+
+#include "workStealingPool.h"
+
+using namespace QCV;
+
+/// Pool thread.
+class CWorkStealingPool::CWorker: public QThread
+{
+public:
+    CWorker ( CWorkStealingPool * f_owner_p,
+              int                 f_worker_i )
+            : m_owner_p ( f_owner_p ),
+              m_worker_i ( f_worker_i )
+    {
+    }
+
+protected:
+    virtual void run()
+    {
+        m_owner_p -> workerLoop ( m_worker_i );
+    }
+
+private:
+    CWorkStealingPool *  m_owner_p;
+    int                  m_worker_i;
+};
+
+CWorkStealingPool::CWorkStealingPool ( int f_numThreads_i )
+        : m_active_i (                 0 ),
+          m_graph_p (               NULL ),
+          m_remaining (                0 ),
+          m_generation_i (             0 ),
+          m_quit_b (               false )
+{
+    int threads_i = f_numThreads_i;
+
+    if ( threads_i <= 0 )
+        threads_i = QThread::idealThreadCount();
+
+    if ( threads_i < 1 )
+        threads_i = 1;
+
+    m_queues_v.resize ( threads_i );
+
+    for (int i = 0; i < threads_i; ++i)
+        m_queueMutexes_v.push_back ( new QMutex() );
+
+    /// Worker 0 is the thread calling run().
+    for (int i = 1; i < threads_i; ++i)
+    {
+        CWorker * worker_p = new CWorker ( this, i );
+        m_workers_v.push_back ( worker_p );
+        worker_p -> start();
+    }
+}
+
+CWorkStealingPool::~CWorkStealingPool()
+{
+    m_mutex.lock();
+    m_quit_b = true;
+    m_wakeUp.wakeAll();
+    m_mutex.unlock();
+
+    for (unsigned int i = 0; i < m_workers_v.size(); ++i)
+    {
+        m_workers_v[i] -> wait();
+        delete m_workers_v[i];
+    }
+
+    for (unsigned int i = 0; i < m_queueMutexes_v.size(); ++i)
+        delete m_queueMutexes_v[i];
+}
+
+bool
+CWorkStealingPool::run ( CTaskGraph & f_graph )
+{
+    if ( !m_runMutex.tryLock() )
+        return false;
+
+    const int tasks_i = f_graph.m_predecessors_v.size();
+
+    if ( tasks_i == 0 ||
+         (int) f_graph.m_successors_v.size() != tasks_i )
+    {
+        m_runMutex.unlock();
+        return tasks_i == 0;
+    }
+
+    m_pending_v.resize ( tasks_i );
+
+    for (int i = 0; i < tasks_i; ++i)
+        m_pending_v[i] = f_graph.m_predecessors_v[i];
+
+    m_remaining = tasks_i;
+
+    m_mutex.lock();
+    m_graph_p = &f_graph;
+    ++m_generation_i;
+    m_mutex.unlock();
+
+    /// Distribute the tasks without dependencies.
+    const int threads_i = m_queues_v.size();
+    int next_i = 0;
+
+    for (int i = 0; i < tasks_i; ++i)
+    {
+        if ( f_graph.m_predecessors_v[i] == 0 )
+        {
+            pushTask ( next_i, i );
+            next_i = (next_i + 1) % threads_i;
+        }
+    }
+
+    m_mutex.lock();
+    m_wakeUp.wakeAll();
+    m_mutex.unlock();
+
+    process ( 0 );
+
+    /// Wait for the pool threads to leave the graph before it goes
+    /// out of scope.
+    m_mutex.lock();
+    while ( m_active_i > 0 )
+        m_idle.wait ( &m_mutex );
+    m_graph_p = NULL;
+    m_mutex.unlock();
+
+    m_runMutex.unlock();
+
+    return true;
+}
+
+void
+CWorkStealingPool::workerLoop ( int f_worker_i )
+{
+    int generation_i = 0;
+
+    m_mutex.lock();
+
+    while ( 1 )
+    {
+        while ( !m_quit_b &&
+                ( m_graph_p == NULL || m_generation_i == generation_i ) )
+            m_wakeUp.wait ( &m_mutex );
+
+        if ( m_quit_b )
+            break;
+
+        generation_i = m_generation_i;
+        ++m_active_i;
+        m_mutex.unlock();
+
+        process ( f_worker_i );
+
+        m_mutex.lock();
+        --m_active_i;
+        m_idle.wakeAll();
+    }
+
+    m_mutex.unlock();
+}
+
+void
+CWorkStealingPool::process ( int f_worker_i )
+{
+    int task_i;
+
+    while ( (int) m_remaining > 0 )
+    {
+        if ( popTask ( f_worker_i, task_i ) )
+            executeTask ( f_worker_i, task_i );
+        else
+        {
+            /// Nothing to do. Tasks that other threads can take are
+            /// announced with m_wakeUp while holding m_mutex, so
+            /// checking the queues under m_mutex loses no wake up.
+            m_mutex.lock();
+            while ( (int) m_remaining > 0 && !hasTasks() )
+                m_wakeUp.wait ( &m_mutex );
+            m_mutex.unlock();
+        }
+    }
+}
+
+bool
+CWorkStealingPool::popTask ( int   f_worker_i,
+                             int & fr_task_i )
+{
+    const int threads_i = m_queues_v.size();
+
+    /// Own queue: last in, first out.
+    {
+        QMutexLocker locker ( m_queueMutexes_v[f_worker_i] );
+        std::deque<int> & queue = m_queues_v[f_worker_i];
+
+        if ( !queue.empty() )
+        {
+            fr_task_i = queue.back();
+            queue.pop_back();
+            return true;
+        }
+    }
+
+    /// Steal the oldest task of another worker.
+    for (int i = 1; i < threads_i; ++i)
+    {
+        const int victim_i = (f_worker_i + i) % threads_i;
+
+        QMutexLocker locker ( m_queueMutexes_v[victim_i] );
+        std::deque<int> & queue = m_queues_v[victim_i];
+
+        if ( !queue.empty() )
+        {
+            fr_task_i = queue.front();
+            queue.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool
+CWorkStealingPool::hasTasks ( )
+{
+    for (unsigned int i = 0; i < m_queues_v.size(); ++i)
+    {
+        QMutexLocker locker ( m_queueMutexes_v[i] );
+
+        if ( !m_queues_v[i].empty() )
+            return true;
+    }
+
+    return false;
+}
+
+void
+CWorkStealingPool::pushTask ( int f_worker_i,
+                              int f_task_i )
+{
+    QMutexLocker locker ( m_queueMutexes_v[f_worker_i] );
+    m_queues_v[f_worker_i].push_back ( f_task_i );
+}
+
+void
+CWorkStealingPool::executeTask ( int f_worker_i,
+                                 int f_task_i )
+{
+    m_graph_p -> execute ( f_task_i );
+
+    const std::vector<int> & successors_v = m_graph_p -> m_successors_v[f_task_i];
+    int ready_i = 0;
+
+    for (unsigned int i = 0; i < successors_v.size(); ++i)
+    {
+        /// deref returns false when the counter reaches 0.
+        if ( !m_pending_v[successors_v[i]].deref() )
+        {
+            pushTask ( f_worker_i, successors_v[i] );
+            ++ready_i;
+        }
+    }
+
+    const bool done_b = !m_remaining.deref();
+
+    /// This thread continues with one of the new tasks, the others
+    /// can be stolen.
+    bool spare_b = ready_i > 1;
+
+    if ( ready_i == 1 )
+    {
+        QMutexLocker locker ( m_queueMutexes_v[f_worker_i] );
+        spare_b = m_queues_v[f_worker_i].size() > 1;
+    }
+
+    if ( done_b || spare_b )
+    {
+        m_mutex.lock();
+        m_wakeUp.wakeAll();
+        m_mutex.unlock();
+    }
+}
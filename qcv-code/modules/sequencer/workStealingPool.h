@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose.
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+#ifndef __WORKSTEALINGPOOL_H
+#define __WORKSTEALINGPOOL_H
+
+/**
+ *******************************************************************************
+ *
+ * @file workStealingPool.h
+ *
+ * \class CWorkStealingPool
+ * \author Hernan Badino (hernan.badino@gmail.com)
+ *
+ * \brief Thread pool for executing graphs of dependent tasks.
+ *
+ * Every thread has its own queue of ready tasks. Tasks that become
+ * ready are pushed to the queue of the thread that completed their
+ * last dependency and are taken from the back (the data is likely
+ * still in cache). Idle threads steal tasks from the front of the
+ * queues of the other threads. The thread calling run() takes part
+ * in the execution.
+ *
+ *******************************************************************************/
+
+/* INCLUDES */
+#include <vector>
+#include <deque>
+
+#include <QtCore/QMutex>
+#include <QtCore/QWaitCondition>
+#include <QtCore/QAtomicInt>
+
+/* CONSTANTS */
+
+namespace QCV
+{
+    class CWorkStealingPool
+    {
+    /// Public data types
+    public:
+        /// Graph of tasks to execute.
+        class CTaskGraph
+        {
+        public:
+            virtual ~CTaskGraph() {}
+
+            /// Execute a task. Called from any thread of the pool.
+            virtual void execute ( int f_task_i ) = 0;
+
+            /// Tasks depending on every task.
+            std::vector< std::vector<int> >  m_successors_v;
+
+            /// Number of tasks every task depends on.
+            std::vector<int>                 m_predecessors_v;
+        };
+
+    /// Constructors, Destructors
+    public:
+        /// Constructor. The number of threads includes the calling
+        /// thread. 0 means one thread per core.
+        CWorkStealingPool ( int f_numThreads_i = 0 );
+
+        /// Destructor
+        virtual ~CWorkStealingPool();
+
+    /// Operations
+    public:
+        /// Execute all tasks of the graph. Returns false without
+        /// executing anything if the pool is already executing a
+        /// graph (for example when called from a task). In that case
+        /// the caller must execute the graph itself.
+        bool   run ( CTaskGraph & f_graph );
+
+        /// Get the number of threads (including the calling thread).
+        int    getNumThreads ( ) const { return m_queues_v.size(); }
+
+    /// Private data types
+    private:
+        class CWorker;
+        friend class CWorker;
+
+    /// Private methods
+    private:
+        /// Loop of the pool threads.
+        void   workerLoop ( int f_worker_i );
+
+        /// Execute tasks until the graph is completed.
+        void   process ( int f_worker_i );
+
+        /// Get a task from the own queue or steal one.
+        bool   popTask ( int   f_worker_i,
+                         int & fr_task_i );
+
+        /// Is any task waiting in a queue?
+        bool   hasTasks ( );
+
+        /// Push a ready task in a queue.
+        void   pushTask ( int f_worker_i,
+                          int f_task_i );
+
+        /// Execute a task and release its successors.
+        void   executeTask ( int f_worker_i,
+                             int f_task_i );
+
+    /// Private members
+    private:
+        /// Pool threads (the calling thread is worker 0).
+        std::vector<CWorker *>            m_workers_v;
+
+        /// Ready tasks of every worker.
+        std::vector< std::deque<int> >    m_queues_v;
+
+        /// Protection of every queue.
+        std::vector<QMutex *>             m_queueMutexes_v;
+
+        /// Held while a graph is being executed.
+        QMutex                            m_runMutex;
+
+        /// Protects the graph pointer, generation and quit flag.
+        QMutex                            m_mutex;
+
+        /// Wakes up the workers (new graph, new tasks, graph done).
+        QWaitCondition                    m_wakeUp;
+
+        /// Signaled when a worker leaves the current graph.
+        QWaitCondition                    m_idle;
+
+        /// Number of pool threads working on the current graph.
+        int                               m_active_i;
+
+        /// Graph being executed.
+        CTaskGraph *                      m_graph_p;
+
+        /// Number of unfinished predecessors of every task.
+        std::vector<QAtomicInt>           m_pending_v;
+
+        /// Number of unfinished tasks.
+        QAtomicInt                        m_remaining;
+
+        /// Incremented with every new graph.
+        int                               m_generation_i;
+
+        /// Terminate the threads.
+        bool                              m_quit_b;
+    };
+}
+
+#endif // __WORKSTEALINGPOOL_H
@@ -22,11 +22,34 @@
 #ifndef NUMERICALSOLVER_H
 #define NUMERICALSOLVER_H
 
+/* INCLUDES */
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <limits>
+
+#if defined ( _OPENMP )
+#include <omp.h>
+#endif
+
 namespace QCV
 {
    
 namespace NumericalSolver
 {
+   /// Counters of a minimization.
+   struct SSolverStatistics
+   {
+      SSolverStatistics() : iterations_i ( 0 ), evaluations_i ( 0 ) {}
+
+      /// Number of iterations.
+      int     iterations_i;
+
+      /// Number of evaluations of the cost function (or of the normal
+      /// equations of a least squares problem).
+      int     evaluations_i;
+   };
    
    template <typename TCostFunction>
    double 
@@ -48,8 +71,32 @@ namespace NumericalSolver
                    const int            f_m_i,
                    const int            f_maxIters_i,
                    const double         f_resTolerance_d,
-                   TCostFunction       &f_costFunction );
+                   TCostFunction       &f_costFunction,
+                   SSolverStatistics   *fr_stats_p = NULL );
 
+   /// Minimizes sum_i |r_i(x)|^2 with the Levenberg-Marquardt method using
+   /// the Jacobian J of the residuals. TLeastSquaresProblem must implement
+   ///
+   ///   double computeNormalEquations ( const double * f_state_p,
+   ///                                   double *       fr_jtr_p,
+   ///                                   double *       fr_jtj_p,
+   ///                                   const int      f_n_i ) const;
+   ///
+   /// returning sum_i |r_i|^2 at f_state_p and computing J^T r (n) and 
+   /// J^T J (n x n, row major). As with solveByNewton, the gradient and 
+   /// the Hesse matrix (approximated with 2 J^T J) at the solution are 
+   /// returned in f_gradient_p and f_hesseMatrix_p (m x m).
+   template <typename TLeastSquaresProblem>
+   double 
+   solveByLevenbergMarquardt ( double * const       f_state_p,
+                               double * const       f_gradient_p,
+                               double * const       f_hesseMatrix_p,
+                               const int            f_n_i,
+                               const int            f_m_i,
+                               const int            f_maxIters_i,
+                               const double         f_resTolerance_d,
+                               TLeastSquaresProblem &f_problem,
+                               SSolverStatistics   *fr_stats_p = NULL );
 
 }
 
@@ -118,10 +118,15 @@ namespace NumericalSolver
                           const int            f_m_i,
                           const int            f_maxIters_i,
                           const double         f_resTolerance_d,
-                          TCostFunction       &f_compMahalanobis )
+                          TCostFunction       &f_compMahalanobis,
+                          SSolverStatistics   *fr_stats_p )
    {
       if (f_n_i < 1 || f_m_i < f_n_i || f_maxIters_i < 1) return -1.;
 
+      /// Cost evaluations of computeGradientAndHesseMatrix.
+      const int evalsPerCall_i = 1 + 2 * f_n_i + 2 * f_n_i * (f_n_i - 1);
+      int       calls_i        = 0;
+
       double *dtemp_p     = new double[f_m_i*f_m_i];
       double *prevState_p = new double[f_m_i];
 
@@ -142,6 +147,7 @@ namespace NumericalSolver
                                                      f_n_i,
                                                      f_m_i,
                                                      f_compMahalanobis );
+         ++calls_i;
         
          if ( fabs(prevResidual_d - residual_d) < f_resTolerance_d )
          {
@@ -177,9 +183,187 @@ namespace NumericalSolver
                                                   f_n_i,
                                                   f_m_i,
                                                   f_compMahalanobis );
+      ++calls_i;
+
+      if ( fr_stats_p )
+      {
+         fr_stats_p -> iterations_i  += std::min(it + 1, f_maxIters_i);
+         fr_stats_p -> evaluations_i += calls_i * evalsPerCall_i;
+      }
+
       delete [] dtemp_p;
       delete [] prevState_p;
    
       return residual_d;
    }
+
+   /// Solves the symmetric positive definite system A x = b (n x n, row
+   /// major) with a Cholesky decomposition. A is overwritten. Returns 
+   /// false if A is not positive definite.
+   inline bool
+   solveCholesky ( double * const       f_a_p,
+                   const double * const f_b_p,
+                   double * const       fr_x_p,
+                   const int            f_n_i )
+   {
+      /// Lower triangle of A = L L^T.
+      for (int j = 0; j < f_n_i; ++j)
+      {
+         double sum_d = f_a_p[j*f_n_i+j];
+
+         for (int k = 0; k < j; ++k)
+            sum_d -= f_a_p[j*f_n_i+k] * f_a_p[j*f_n_i+k];
+
+         if ( !(sum_d > 0) )
+            return false;
+
+         const double ljj_d = sqrt(sum_d);
+         f_a_p[j*f_n_i+j] = ljj_d;
+
+         for (int i = j+1; i < f_n_i; ++i)
+         {
+            sum_d = f_a_p[i*f_n_i+j];
+
+            for (int k = 0; k < j; ++k)
+               sum_d -= f_a_p[i*f_n_i+k] * f_a_p[j*f_n_i+k];
+
+            f_a_p[i*f_n_i+j] = sum_d / ljj_d;
+         }
+      }
+
+      /// L y = b
+      for (int i = 0; i < f_n_i; ++i)
+      {
+         double sum_d = f_b_p[i];
+
+         for (int k = 0; k < i; ++k)
+            sum_d -= f_a_p[i*f_n_i+k] * fr_x_p[k];
+
+         fr_x_p[i] = sum_d / f_a_p[i*f_n_i+i];
+      }
+
+      /// L^T x = y
+      for (int i = f_n_i-1; i >= 0; --i)
+      {
+         double sum_d = fr_x_p[i];
+
+         for (int k = i+1; k < f_n_i; ++k)
+            sum_d -= f_a_p[k*f_n_i+i] * fr_x_p[k];
+
+         fr_x_p[i] = sum_d / f_a_p[i*f_n_i+i];
+      }
+
+      return true;
+   }
+
+   template <typename TLeastSquaresProblem>
+   double 
+   solveByLevenbergMarquardt ( double * const       f_state_p,
+                               double * const       f_gradient_p,
+                               double * const       f_hesseMatrix_p,
+                               const int            f_n_i,
+                               const int            f_m_i,
+                               const int            f_maxIters_i,
+                               const double         f_resTolerance_d,
+                               TLeastSquaresProblem &f_problem,
+                               SSolverStatistics   *fr_stats_p )
+   {
+      if (f_n_i < 1 || f_m_i < f_n_i || f_maxIters_i < 1) return -1.;
+
+      const int n_i  = f_n_i;
+      const int nn_i = f_n_i * f_n_i;
+
+      /// Current and trial state with their normal equations. 
+      double *data_p     = new double[f_m_i + 3*n_i + 3*nn_i];
+      double *newState_p = data_p;
+      double *jtr_p      = newState_p + f_m_i;
+      double *newJtr_p   = jtr_p + n_i;
+      double *delta_p    = newJtr_p + n_i;
+      double *jtj_p      = delta_p + n_i;
+      double *newJtj_p   = jtj_p + nn_i;
+      double *system_p   = newJtj_p + nn_i;
+
+      double residual_d  = f_problem.computeNormalEquations ( f_state_p, jtr_p, jtj_p, n_i );
+      double lambda_d    = 1.e-3;
+      int    evals_i     = 1;
+      int    it;
+
+      for (it = 0; it < f_maxIters_i; ++it)
+      {
+         /// Damped normal equations (J^T J + lambda diag(J^T J)) delta = -J^T r
+         memcpy(system_p, jtj_p, sizeof(double) * nn_i);
+
+         for (int i = 0; i < n_i; ++i)
+         {
+            system_p[i*n_i+i] += lambda_d * std::max(jtj_p[i*n_i+i], 1.e-12);
+            newJtr_p[i]        = -jtr_p[i];
+         }
+
+         if ( !solveCholesky ( system_p, newJtr_p, delta_p, n_i ) )
+         {
+            lambda_d *= 10;
+            continue;
+         }
+
+         memcpy(newState_p, f_state_p, sizeof(double) * f_m_i);
+         for (int i = 0; i < n_i; ++i)
+            newState_p[i] += delta_p[i];
+
+         const double newResidual_d = f_problem.computeNormalEquations ( newState_p, newJtr_p, newJtj_p, n_i );
+         ++evals_i;
+
+         if ( newResidual_d < residual_d )
+         {
+            const double decrease_d = residual_d - newResidual_d;
+
+            memcpy(f_state_p, newState_p, sizeof(double) * n_i);
+            std::swap ( jtr_p, newJtr_p );
+            std::swap ( jtj_p, newJtj_p );
+            residual_d = newResidual_d;
+            lambda_d   = std::max(lambda_d / 10, 1.e-9);
+
+            if ( decrease_d < f_resTolerance_d )
+            {
+               ++it;
+               break;
+            }
+         }
+         else
+         {
+            lambda_d *= 10;
+
+            /// No further decrease possible.
+            if ( lambda_d > 1.e9 )
+            {
+               ++it;
+               break;
+            }
+         }
+      }
+
+      /// Gradient and Gauss-Newton Hesse matrix of sum_i |r_i|^2.
+      memset(f_gradient_p,    0, sizeof(double)*f_m_i);
+      memset(f_hesseMatrix_p, 0, sizeof(double)*f_m_i*f_m_i);
+
+      for (int i = 0; i < f_m_i; ++i)
+         f_hesseMatrix_p[f_m_i*i+i] = 1;
+
+      for (int i = 0; i < n_i; ++i)
+      {
+         f_gradient_p[i] = 2 * jtr_p[i];
+
+         for (int j = 0; j < n_i; ++j)
+            f_hesseMatrix_p[i*f_m_i+j] = 2 * jtj_p[i*n_i+j];
+      }
+
+      if ( fr_stats_p )
+      {
+         fr_stats_p -> iterations_i  += it;
+         fr_stats_p -> evaluations_i += evals_i;
+      }
+
+      delete [] data_p;
+
+      return residual_d;
+   }
 }
@@ -29,7 +29,7 @@
 
 /* INCLUDES */
 #include "polygonList.h"
-#include "glheader.h"
+#include "rasterizer.h"
 #include <stdio.h>
 
 
@@ -106,51 +106,6 @@ CPolygonList::clear ()
     return m_polygon_v.size();
 }
 
-// Draw all polygons.
-bool
-CPolygonList::show () const
-{
-    std::vector< SPolygon >::const_iterator last = m_polygon_v.end();
-
-    for (std::vector< SPolygon >::const_iterator i = m_polygon_v.begin(); 
-         i != last; ++i )
-    {
-        glLineWidth( i->lineWidth_f );
-        
-        /// If not complete transparent.
-        if ( i->fillColor.a != 0 )
-        {
-            glColor4ub( i->fillColor.r, 
-                        i->fillColor.g, 
-                        i->fillColor.b, 
-                        i->fillColor.a );
-            
-            glBegin(GL_POLYGON);
-
-            for (unsigned int v = 0; v < i->vertex_v.size(); ++v )
-                glVertex2f ( i->vertex_v[v].x, 
-                             i->vertex_v[v].y );
-            glEnd();
-        }       
-
-        glColor4ub( i->outlineColor.r, 
-                    i->outlineColor.g, 
-                    i->outlineColor.b, 
-                    i->outlineColor.a );
-        
-        glBegin ( GL_LINE_LOOP ) ;
-
-        for (unsigned int v = 0; v < i->vertex_v.size(); ++v )
-            glVertex2f ( i->vertex_v[v].x, 
-                         i->vertex_v[v].y );
-        glEnd();
-
-    }
-
-    /// Todo: Check GL status and return value.
-    return true;
-}
-
 bool
 CPolygonList::write ( FILE*                f_file_p,
                       const float          f_offsetU_f /* = 0.0 */,
@@ -205,6 +160,24 @@ CPolygonList::write ( FILE*                f_file_p,
     return true;
 }
 
+// Render all polygons.
+bool
+CPolygonList::render ( CRasterTile & fr_tile ) const
+{
+    std::vector< SPolygon >::const_iterator last = m_polygon_v.end();
+
+    for (std::vector< SPolygon >::const_iterator i = m_polygon_v.begin(); 
+         i != last; ++i )
+    {
+        fr_tile.polygon ( i->vertex_v, 
+                          i->outlineColor, 
+                          i->fillColor, 
+                          i->lineWidth_f );
+    }
+
+    return true;
+}
+
 /// Return number of elements.
 int
 CPolygonList::getSize () const
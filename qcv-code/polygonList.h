@@ -86,8 +86,8 @@ namespace QCV
         // Clear all polygons.
         virtual bool clear ();
 
-        // Draw all polygons.
-        virtual bool show () const;
+        // Draw all polygons (OpenGL, defined in polygonListGL.cpp).
+        bool show () const;
 
         // Write polygon in a SVG file.
         virtual bool write ( FILE*                f_file_p,
@@ -95,6 +95,9 @@ namespace QCV
                              const float          f_offsetV_f = 0.0,
                              const std::string    f_parameters_str = "") const;
 
+        // Render polygons into an image tile.
+        virtual bool render ( CRasterTile &      fr_tile ) const;
+
         // Return number of elements.
         virtual int  getSize () const;
 
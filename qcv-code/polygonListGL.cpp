@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose. 
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+/*@@@**************************************************************************
+ * \file  polygonListGL.cpp
+ * \author Hernan Badino
+ * \notes 
+ *******************************************************************************
+ *****             (C) Hernan Badino 2012 - All Rights Reserved            *****
+ ******************************************************************************/
+
+/* INCLUDES */
+#include "polygonList.h"
+#include "glheader.h"
+
+using namespace QCV;
+
+// Draw all polygons.
+bool
+CPolygonList::show () const
+{
+    std::vector< SPolygon >::const_iterator last = m_polygon_v.end();
+
+    for (std::vector< SPolygon >::const_iterator i = m_polygon_v.begin(); 
+         i != last; ++i )
+    {
+        glLineWidth( i->lineWidth_f );
+        
+        /// If not complete transparent.
+        if ( i->fillColor.a != 0 )
+        {
+            glColor4ub( i->fillColor.r, 
+                        i->fillColor.g, 
+                        i->fillColor.b, 
+                        i->fillColor.a );
+            
+            glBegin(GL_POLYGON);
+
+            for (unsigned int v = 0; v < i->vertex_v.size(); ++v )
+                glVertex2f ( i->vertex_v[v].x, 
+                             i->vertex_v[v].y );
+            glEnd();
+        }       
+
+        glColor4ub( i->outlineColor.r, 
+                    i->outlineColor.g, 
+                    i->outlineColor.b, 
+                    i->outlineColor.a );
+        
+        glBegin ( GL_LINE_LOOP ) ;
+
+        for (unsigned int v = 0; v < i->vertex_v.size(); ++v )
+            glVertex2f ( i->vertex_v[v].x, 
+                         i->vertex_v[v].y );
+        glEnd();
+
+    }
+
+    /// Todo: Check GL status and return value.
+    return true;
+}
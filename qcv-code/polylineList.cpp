@@ -0,0 +1,401 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose. 
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+/*@@@**************************************************************************
+ * \file  polylineList.cpp
+ * \author Hernan Badino
+ * \notes 
+ *******************************************************************************
+ *****             (C) Hernan Badino 2012 - All Rights Reserved            *****
+ ******************************************************************************/
+
+/* INCLUDES */
+#include "polylineList.h"
+#include "rasterizer.h"
+#include <stdio.h>
+
+using namespace QCV;
+
+CPolyline::CPolyline( SRgba f_color,
+                      float f_lineWidth_f )
+        : m_color (                   f_color ),
+          m_lineWidth_f (       f_lineWidth_f ),
+          m_vertex_v (                        ),
+          m_screen_v (                        ),
+          m_scale (                    1., 1. ),
+          m_origin (                   0., 0. ),
+          m_offset (                   0., 0. )
+{}
+
+/// Destructor.
+CPolyline::~CPolyline()
+{}
+
+// Append a vertex.
+void
+CPolyline::addVertex ( float   f_x_f,
+                       float   f_y_f )
+{
+    m_vertex_v.push_back ( S2D<float>( f_x_f, f_y_f ) );
+    m_screen_v.push_back ( toScreen ( m_vertex_v.back() ) );
+}
+
+// Set the transformation to screen.
+void
+CPolyline::setTransformation ( double f_scaleX_d,
+                               double f_scaleY_d,
+                               double f_originX_d,
+                               double f_originY_d,
+                               double f_offsetX_d,
+                               double f_offsetY_d )
+{
+    S2D<double> scale  ( f_scaleX_d,  f_scaleY_d  );
+    S2D<double> origin ( f_originX_d, f_originY_d );
+    S2D<double> offset ( f_offsetX_d, f_offsetY_d );
+    
+    if ( scale  == m_scale  && 
+         origin == m_origin && 
+         offset == m_offset )
+        return;
+
+    m_scale  = scale;
+    m_origin = origin;
+    m_offset = offset;
+
+    for (size_t i = 0; i < m_vertex_v.size(); ++i)
+        m_screen_v[i] = toScreen ( m_vertex_v[i] );
+}
+
+// Remove all vertices.
+void
+CPolyline::clear ()
+{
+    m_vertex_v.clear();
+    m_screen_v.clear();
+}
+
+// Map a vertex to screen.
+S2D<float>
+CPolyline::toScreen ( const S2D<float> & f_vertex ) const
+{
+    return S2D<float> ( m_scale.x * ( f_vertex.x - m_origin.x ) + m_offset.x,
+                        m_scale.y * ( f_vertex.y - m_origin.y ) + m_offset.y );
+}
+
+CSquareTrail::CSquareTrail( float f_halfSize_f,
+                            float f_lineWidth_f,
+                            CColorEncoding::EColorEncodingType_t f_encoding_e )
+        : CPolyline ( SRgba(255, 255, 255, 255), 
+                      f_lineWidth_f ),
+          m_halfSize_f (         f_halfSize_f ),
+          m_colorEnc (           f_encoding_e )
+{}
+
+/// Destructor.
+CSquareTrail::~CSquareTrail()
+{}
+
+// Color of a vertex.
+SRgba
+CSquareTrail::getVertexColor ( int f_idx_i ) const
+{
+    SRgb color;
+    m_colorEnc.colorFromValue ( f_idx_i, 0.f, getSize(), color );
+    return SRgba ( color );
+}
+
+CPolylineList::CPolylineList( int /* f_bufferSize_i */ )
+{}
+
+/// Destructor.
+CPolylineList::~CPolylineList()
+{
+    for (unsigned int i = 0; i < m_copies_v.size(); ++i)
+        delete m_copies_v[i];
+}
+
+// Add polylines from other list.
+bool
+CPolylineList::add ( const CPolylineList &f_otherList )
+{
+    m_polyline_v.insert( m_polyline_v.begin(), 
+                         f_otherList.m_polyline_v.begin(),
+                         f_otherList.m_polyline_v.end() );
+
+    return true;
+}
+
+// Add polyline.
+bool
+CPolylineList::add ( const CPolyline * f_polyline_p )
+{
+    if ( !f_polyline_p )
+        return false;
+
+    m_polyline_v.push_back(f_polyline_p);
+
+    return true;
+}
+
+// Clear all polylines.
+bool
+CPolylineList::clear ()
+{
+    m_polyline_v.clear();
+    return m_polyline_v.size();
+}
+
+// Replace the polylines by copies owned by the list.
+bool
+CPolylineList::detach ()
+{
+    for (unsigned int i = 0; i < m_polyline_v.size(); ++i)
+    {
+        if ( i == m_copies_v.size() )
+            m_copies_v.push_back ( new CPolyline );
+
+        /// The vertex vectors of the copies keep their capacity.
+        if ( m_polyline_v[i] != m_copies_v[i] )
+            *m_copies_v[i] = *m_polyline_v[i];
+
+        m_polyline_v[i] = m_copies_v[i];
+    }
+
+    return true;
+}
+
+bool
+CPolylineList::write ( FILE*                f_file_p,
+                       const float          f_offsetU_f /* = 0.0 */,
+                       const float          f_offsetV_f /* = 0.0 */,
+                       const std::string    f_prefix_str /* = "" */) const
+{
+    std::vector< const CPolyline * >::const_iterator last = m_polyline_v.end();
+    
+    int count_i = 0;
+    
+    for (std::vector< const CPolyline * >::const_iterator i = m_polyline_v.begin(); 
+         i != last; ++i, ++count_i )
+    {
+        const std::vector< S2D<float> > & screen_v = (*i)->getScreenVertices();
+        const SRgba color = (*i)->getColor();
+
+        fprintf( f_file_p,
+                 "        <polyline id=\"polyline_%s_%i\"\n"
+                 "                  points=\"",
+                 f_prefix_str.c_str(), count_i );
+        
+        for (size_t v = 0; v < screen_v.size(); ++v )
+        {
+            fprintf( f_file_p,
+                     "%f,%f ",
+                     screen_v[v].x + f_offsetU_f,
+                     screen_v[v].y + f_offsetV_f );
+        }
+
+        fprintf( f_file_p,
+                 "\"\n"
+                 "                  fill=\"none\"\n"
+                 "                  stroke-width=\"%f\"\n"
+                 "                  stroke=\"#%02x%02x%02x\"\n"
+                 "                  opacity=\"%f\" />\n",
+                 1+(*i)->getLineWidth(),
+                 color.r, color.g, color.b, color.a/255.f );
+    }
+    
+    return true;
+}
+
+// Render all polylines.
+bool
+CPolylineList::render ( CRasterTile & fr_tile ) const
+{
+    std::vector< const CPolyline * >::const_iterator last = m_polyline_v.end();
+
+    for (std::vector< const CPolyline * >::const_iterator i = m_polyline_v.begin(); 
+         i != last; ++i )
+    {
+        const std::vector< S2D<float> > & screen_v = (*i)->getScreenVertices();
+
+        for (size_t v = 1; v < screen_v.size(); ++v)
+            fr_tile.line ( screen_v[v  ].x, screen_v[v  ].y,
+                           screen_v[v-1].x, screen_v[v-1].y,
+                           (*i)->getColor(), 
+                           (*i)->getLineWidth() );
+    }
+
+    return true;
+}
+
+/// Return number of elements.
+int
+CPolylineList::getSize () const
+{
+    return m_polyline_v.size();    
+}
+
+CSquareTrailList::CSquareTrailList( int /* f_bufferSize_i */ )
+{}
+
+/// Destructor.
+CSquareTrailList::~CSquareTrailList()
+{
+    for (unsigned int i = 0; i < m_copies_v.size(); ++i)
+        delete m_copies_v[i];
+}
+
+// Add trails from other list.
+bool
+CSquareTrailList::add ( const CSquareTrailList &f_otherList )
+{
+    m_trail_v.insert( m_trail_v.begin(), 
+                      f_otherList.m_trail_v.begin(),
+                      f_otherList.m_trail_v.end() );
+
+    return true;
+}
+
+// Add trail.
+bool
+CSquareTrailList::add ( const CSquareTrail * f_trail_p )
+{
+    if ( !f_trail_p )
+        return false;
+
+    m_trail_v.push_back(f_trail_p);
+
+    return true;
+}
+
+// Clear all trails.
+bool
+CSquareTrailList::clear ()
+{
+    m_trail_v.clear();
+    return m_trail_v.size();
+}
+
+// Replace the trails by copies owned by the list.
+bool
+CSquareTrailList::detach ()
+{
+    for (unsigned int i = 0; i < m_trail_v.size(); ++i)
+    {
+        if ( i == m_copies_v.size() )
+            m_copies_v.push_back ( new CSquareTrail );
+
+        /// The vertex vectors of the copies keep their capacity.
+        if ( m_trail_v[i] != m_copies_v[i] )
+            *m_copies_v[i] = *m_trail_v[i];
+
+        m_trail_v[i] = m_copies_v[i];
+    }
+
+    return true;
+}
+
+bool
+CSquareTrailList::write ( FILE*                f_file_p,
+                          const float          f_offsetU_f /* = 0.0 */,
+                          const float          f_offsetV_f /* = 0.0 */,
+                          const std::string    f_prefix_str /* = "" */) const
+{
+    std::vector< const CSquareTrail * >::const_iterator last = m_trail_v.end();
+    
+    int count_i = 0;
+    
+    for (std::vector< const CSquareTrail * >::const_iterator i = m_trail_v.begin(); 
+         i != last; ++i )
+    {
+        const std::vector< S2D<float> > & screen_v = (*i)->getScreenVertices();
+        const float halfSize_f = (*i)->getHalfSize();
+
+        for (size_t v = 0; v < screen_v.size(); ++v, ++count_i )
+        {
+            const SRgba color = (*i)->getVertexColor ( v );
+            const float u1_f  = screen_v[v].x - halfSize_f;
+            const float v1_f  = screen_v[v].y - halfSize_f;
+            const float u2_f  = screen_v[v].x + halfSize_f;
+            const float v2_f  = screen_v[v].y + halfSize_f;
+
+            fprintf( f_file_p,
+                     "        <rect id=\"squaretrail_%s_%i\"\n"
+                     "                 x=\"%f\" y=\"%f\"\n"
+                     "                 width=\"%f\" height=\"%f\"\n"
+                     "                 stroke-width=\"%f\"\n"
+                     "                 stroke=\"#%02x%02x%02x\"\n"
+                     "                 opacity=\"%f\"\n"
+                     "                 fill=\"none\" />\n",
+                     f_prefix_str.c_str(), count_i,
+                     u1_f + f_offsetU_f, v1_f + f_offsetV_f,
+                     u2_f - u1_f, v2_f - v1_f,
+                     1.f+(*i)->getLineWidth(),
+                     color.r, color.g, color.b, color.a/255.f);
+        }
+    }
+    
+    return true;
+}
+
+// Render all trails.
+bool
+CSquareTrailList::render ( CRasterTile & fr_tile ) const
+{
+    std::vector< const CSquareTrail * >::const_iterator last = m_trail_v.end();
+    std::vector< S2D<float> > vertex_v ( 4 );
+
+    /// Transparent filling.
+    const SRgba fillColor;
+
+    for (std::vector< const CSquareTrail * >::const_iterator i = m_trail_v.begin(); 
+         i != last; ++i )
+    {
+        const std::vector< S2D<float> > & screen_v = (*i)->getScreenVertices();
+        const float halfSize_f = (*i)->getHalfSize();
+
+        for (size_t v = 0; v < screen_v.size(); ++v)
+        {
+            const float u1_f  = screen_v[v].x - halfSize_f;
+            const float v1_f  = screen_v[v].y - halfSize_f;
+            const float u2_f  = screen_v[v].x + halfSize_f;
+            const float v2_f  = screen_v[v].y + halfSize_f;
+
+            vertex_v[0] = S2D<float> ( u1_f, v1_f );
+            vertex_v[1] = S2D<float> ( u2_f, v1_f );
+            vertex_v[2] = S2D<float> ( u2_f, v2_f );
+            vertex_v[3] = S2D<float> ( u1_f, v2_f );
+
+            fr_tile.polygon ( vertex_v, 
+                              (*i)->getVertexColor ( v ), 
+                              fillColor, 
+                              (*i)->getLineWidth() );
+        }
+    }
+
+    return true;
+}
+
+/// Return number of elements.
+int
+CSquareTrailList::getSize () const
+{
+    return m_trail_v.size();    
+}
@@ -0,0 +1,283 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose. 
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+#ifndef __POLYLINELIST_H
+#define __POLYLINELIST_H
+
+/**
+ *******************************************************************************
+ *
+ * @file polylineList.h
+ *
+ * \class CPolylineList
+ * \author Hernan Badino (hernan.badino@gmail.com)
+ *
+ * \brief Handles a list of append-only polylines for displaying in screen 
+ * or writing in file.
+ *
+ * A CPolyline is owned by the caller and keeps its vertices in its own
+ * (e.g. world) coordinates together with a scale and offset transformation 
+ * to screen. The screen positions are computed when a vertex is appended
+ * and recomputed only if the transformation changes, so that a trajectory 
+ * growing by one vertex per frame costs a single vertex transformation per
+ * frame. 
+ *
+ * CPolylineList is derived from CDrawingElementList and stores only
+ * pointers to the polylines: adding a polyline to a drawing list does not
+ * copy its vertices, and the polyline must live until the list is cleared.
+ * Segments are drawn from the newer to the older vertex as independent 
+ * lines, so the output is the same as adding them to a CLineList.
+ * detach() replaces the pointers by copies owned by the list, so that the
+ * list can be painted while the polylines change. The copies are kept 
+ * when the list is cleared and reused by the next detach().
+ *
+ * CSquareTrail is an append-only polyline whose vertices are drawn as
+ * squares, colored by encoding the vertex index over the number of
+ * vertices. CSquareTrailList is drawn right after the rectangles and
+ * the output is the same as adding the squares with 
+ * CDrawingList::addSquare.
+ *
+ *******************************************************************************/
+
+/* INCLUDES */
+#include "drawingElementList.h"
+#include "colors.h"
+#include "colorEncoding.h"
+#include "standardTypes.h"
+
+#include <vector>
+
+/* CONSTANTS */
+
+
+namespace QCV
+{
+    class CPolyline
+    {
+    /// Constructor, Destructor
+    public:
+        /// Constructor
+        CPolyline( SRgba f_color = SRgba(255, 255, 255, 255),
+                   float f_lineWidth_f = 1.f );
+
+        /// Destructor.
+        virtual ~CPolyline();
+
+    /// Operations.
+    public:
+        // Append a vertex.
+        void addVertex ( float   f_x_f,
+                         float   f_y_f );
+
+        // Set the transformation to screen: 
+        // u = scaleX * (x - originX) + offsetX, 
+        // v = scaleY * (y - originY) + offsetY.
+        void setTransformation ( double f_scaleX_d,
+                                 double f_scaleY_d,
+                                 double f_originX_d,
+                                 double f_originY_d,
+                                 double f_offsetX_d,
+                                 double f_offsetY_d );
+
+        // Remove all vertices.
+        void clear ();
+
+        // Number of vertices.
+        int  getSize () const { return m_vertex_v.size(); }
+
+        /// Set/Get color and line width.
+        void  setColor ( SRgba f_color ) { m_color = f_color; }
+        SRgba getColor ( ) const { return m_color; }
+        void  setLineWidth ( float f_width_f ) { m_lineWidth_f = f_width_f; }
+        float getLineWidth ( ) const { return m_lineWidth_f; }
+
+        /// Vertices in screen coordinates.
+        const std::vector< S2D<float> > & getScreenVertices ( ) const { return m_screen_v; }
+
+    protected:
+        // Map a vertex to screen.
+        S2D<float>   toScreen ( const S2D<float> & f_vertex ) const;
+
+    /// Private Members
+    private:
+        /// Color information
+        SRgba                      m_color;
+
+        /// Line width
+        float                      m_lineWidth_f;
+
+        /// Vertices in polyline coordinates.
+        std::vector< S2D<float> >  m_vertex_v;
+
+        /// Vertices in screen coordinates.
+        std::vector< S2D<float> >  m_screen_v;
+
+        /// Scale of the transformation to screen.
+        S2D<double>                m_scale;
+
+        /// Origin of the transformation to screen.
+        S2D<double>                m_origin;
+
+        /// Offset of the transformation to screen.
+        S2D<double>                m_offset;
+    };
+
+    class CSquareTrail: public CPolyline
+    {
+    /// Constructor, Destructor
+    public:
+        /// Constructor
+        CSquareTrail( float f_halfSize_f = 2.f,
+                      float f_lineWidth_f = 1.f,
+                      CColorEncoding::EColorEncodingType_t f_encoding_e = CColorEncoding::CET_HUE );
+
+        /// Destructor.
+        virtual ~CSquareTrail();
+
+    /// Operations.
+    public:
+        /// Set/Get half size of the squares.
+        void  setHalfSize ( float f_halfSize_f ) { m_halfSize_f = f_halfSize_f; }
+        float getHalfSize ( ) const { return m_halfSize_f; }
+
+        // Color of a vertex: its index encoded over [0, getSize()].
+        SRgba getVertexColor ( int f_idx_i ) const;
+
+    /// Private Members
+    private:
+        /// Half size of the squares
+        float                      m_halfSize_f;
+
+        /// Color encoding of the vertex index
+        CColorEncoding             m_colorEnc;
+    };
+
+    class CPolylineList: public CDrawingElementList
+    {
+    /// Constructor, Destructor
+    public:
+        /// Constructor
+        CPolylineList( int f_bufferSize_i = -1);
+
+        /// Destructor.
+        virtual ~CPolylineList();
+
+    /// Operations.
+    public:
+
+        // Add polylines from other list.
+        virtual bool add (  const CPolylineList & f_otherList );
+
+        // Add polyline (not copied).
+        virtual bool add (  const CPolyline * f_polyline_p );
+
+        // Is blendable.
+        virtual bool isBlendable () { return true; }
+
+        // Clear all polylines.
+        virtual bool clear ();
+
+        // Replace the polylines by copies owned by the list.
+        virtual bool detach ();
+
+        // Draw all polylines (OpenGL, defined in polylineListGL.cpp).
+        bool show () const;
+
+        // Write polylines in a SVG file.
+        virtual bool write ( FILE*                f_file_p,
+                             const float          f_offsetU_f = 0.0,
+                             const float          f_offsetV_f = 0.0,
+                             const std::string    f_parameters_str = "") const;
+
+        // Render polylines into an image tile.
+        virtual bool render ( CRasterTile &      fr_tile ) const;
+
+        // Return number of elements.
+        virtual int  getSize () const;
+
+        // Element names.
+        virtual std::string  getGroupName() const { return "Polylines"; };
+
+    /// Private Members
+    private:
+        std::vector<const CPolyline *>    m_polyline_v;
+
+        /// Copies made by detach().
+        std::vector<CPolyline *>          m_copies_v;
+    };
+
+    class CSquareTrailList: public CDrawingElementList
+    {
+    /// Constructor, Destructor
+    public:
+        /// Constructor
+        CSquareTrailList( int f_bufferSize_i = -1);
+
+        /// Destructor.
+        virtual ~CSquareTrailList();
+
+    /// Operations.
+    public:
+
+        // Add trails from other list.
+        virtual bool add (  const CSquareTrailList & f_otherList );
+
+        // Add trail (not copied).
+        virtual bool add (  const CSquareTrail * f_trail_p );
+
+        // Is blendable.
+        virtual bool isBlendable () { return true; }
+
+        // Clear all trails.
+        virtual bool clear ();
+
+        // Replace the trails by copies owned by the list.
+        virtual bool detach ();
+
+        // Draw all trails (OpenGL, defined in polylineListGL.cpp).
+        bool show () const;
+
+        // Write trails in a SVG file.
+        virtual bool write ( FILE*                f_file_p,
+                             const float          f_offsetU_f = 0.0,
+                             const float          f_offsetV_f = 0.0,
+                             const std::string    f_parameters_str = "") const;
+
+        // Render trails into an image tile.
+        virtual bool render ( CRasterTile &      fr_tile ) const;
+
+        // Return number of elements.
+        virtual int  getSize () const;
+
+        // Element names.
+        virtual std::string  getGroupName() const { return "Square Trails"; };
+
+    /// Private Members
+    private:
+        std::vector<const CSquareTrail *> m_trail_v;
+
+        /// Copies made by detach().
+        std::vector<CSquareTrail *>       m_copies_v;
+    };
+} // Namespace QCV
+
+
+#endif // __POLYLINELIST_H
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose. 
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+/*@@@**************************************************************************
+ * \file  polylineListGL.cpp
+ * \author Hernan Badino
+ * \notes 
+ *******************************************************************************
+ *****             (C) Hernan Badino 2012 - All Rights Reserved            *****
+ ******************************************************************************/
+
+/* INCLUDES */
+#include "polylineList.h"
+#include "glheader.h"
+
+using namespace QCV;
+
+// Draw all polylines.
+bool
+CPolylineList::show () const
+{
+    std::vector< const CPolyline * >::const_iterator last = m_polyline_v.end();
+
+    for (std::vector< const CPolyline * >::const_iterator i = m_polyline_v.begin(); 
+         i != last; ++i )
+    {   
+        const std::vector< S2D<float> > & screen_v = (*i)->getScreenVertices();
+        const SRgba color = (*i)->getColor();
+
+        glLineWidth( (*i)->getLineWidth() );
+        glColor4ub(color.r, color.g, color.b, color.a);
+
+        glBegin(GL_LINES);
+        for (size_t v = 1; v < screen_v.size(); ++v)
+        {
+            glVertex2f(screen_v[v  ].x, screen_v[v  ].y);
+            glVertex2f(screen_v[v-1].x, screen_v[v-1].y);
+        }
+        glEnd();
+    }
+
+    /// Todo: Check GL status and return value.
+    return true;
+}
+
+// Draw all trails.
+bool
+CSquareTrailList::show () const
+{
+    std::vector< const CSquareTrail * >::const_iterator last = m_trail_v.end();
+
+    for (std::vector< const CSquareTrail * >::const_iterator i = m_trail_v.begin(); 
+         i != last; ++i )
+    {   
+        const std::vector< S2D<float> > & screen_v = (*i)->getScreenVertices();
+        const float halfSize_f = (*i)->getHalfSize();
+
+        glLineWidth( (*i)->getLineWidth() );
+
+        for (size_t v = 0; v < screen_v.size(); ++v)
+        {
+            const SRgba color = (*i)->getVertexColor ( v );
+            const float u1_f  = screen_v[v].x - halfSize_f;
+            const float v1_f  = screen_v[v].y - halfSize_f;
+            const float u2_f  = screen_v[v].x + halfSize_f;
+            const float v2_f  = screen_v[v].y + halfSize_f;
+
+            glColor4ub(color.r, color.g, color.b, color.a);
+
+            glBegin ( GL_LINE_LOOP ) ;
+            glVertex2f ( u1_f, v1_f );
+            glVertex2f ( u2_f, v1_f );
+            glVertex2f ( u2_f, v2_f );
+            glVertex2f ( u1_f, v2_f );
+            glEnd();
+        }
+    }
+
+    /// Todo: Check GL status and return value.
+    return true;
+}
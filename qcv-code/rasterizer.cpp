@@ -0,0 +1,581 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose. 
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+/*@@@**************************************************************************
+ * \file  rasterizer.cpp
+ * \author Hernan Badino
+ * \notes 
+ *******************************************************************************
+ *****             (C) Hernan Badino 2012 - All Rights Reserved            *****
+ ******************************************************************************/
+
+/* INCLUDES */
+#include <math.h>
+#include <algorithm>
+
+#include "rasterizer.h"
+#include "drawingList.h"
+#include "drawingListHandler.h"
+#include "displayTreeNode.h"
+#include "clipLine.h"
+
+using namespace QCV;
+
+/// Sub-pixel precision of the OpenCV drawing functions (1/16 px).
+static const int   SUBPIXEL_SHIFT = 4;
+static const float SUBPIXEL_SCALE = 16.f;
+
+/// Coordinates are clamped to this range before converting them to
+/// fixed point.
+static const float MAX_COORDINATE = 1.e6f;
+
+/// Height of the Hershey simplex font at scale 1. The GLUT stroke fonts
+/// used by CTextList are about fontSize pixels high.
+static const float HERSHEY_HEIGHT = 22.f;
+
+static inline cv::Point toFixed ( const cv::Point2f & f_point,
+                                  const cv::Point &   f_origin )
+{
+    const float x_f = std::max(std::min(f_point.x - f_origin.x, MAX_COORDINATE), -MAX_COORDINATE);
+    const float y_f = std::max(std::min(f_point.y - f_origin.y, MAX_COORDINATE), -MAX_COORDINATE);
+
+    return cv::Point ( cvRound ( x_f * SUBPIXEL_SCALE ),
+                       cvRound ( y_f * SUBPIXEL_SCALE ) );
+}
+
+static inline cv::Scalar toScalar ( const SRgba & f_color )
+{
+    return cv::Scalar ( f_color.b, f_color.g, f_color.r );
+}
+
+static inline int toThickness ( float f_width_f )
+{
+    return std::max ( 1, cvRound ( f_width_f ) );
+}
+
+CRasterTile::CRasterTile ( cv::Mat &  fr_image,
+                           cv::Rect   f_region )
+        : m_image (    fr_image ( f_region ) ),
+          m_origin (          f_region.tl() )
+{
+    setTransform ( S2D<float>(0.f, 0.f), 
+                   S2D<float>(1.f, 1.f), 
+                   S2D<float>(0.f, 0.f), 
+                   0., 
+                   S2D<float>(0.f, 0.f) );
+}
+
+void
+CRasterTile::setTransform ( S2D<float> f_position,
+                            S2D<float> f_scale,
+                            S2D<float> f_offset,
+                            double     f_rotation_d,
+                            S2D<float> f_center )
+{
+    /// Same order as CDisplay: translate to the screen, scale, offset
+    /// and rotate around the center of the screen.
+    double r00_d = 1., r01_d = 0., r10_d = 0., r11_d = 1.;
+    double tx_d  = 0., ty_d  = 0.;
+
+    if ( fabs ( f_rotation_d ) > 1.e-4 )
+    {
+        const double angle_d = f_rotation_d * M_PI / 180.;
+        r00_d =  cos ( angle_d ); r01_d = -sin ( angle_d );
+        r10_d =  sin ( angle_d ); r11_d =  cos ( angle_d );
+        tx_d  = f_center.x - ( r00_d * f_center.x + r01_d * f_center.y );
+        ty_d  = f_center.y - ( r10_d * f_center.x + r11_d * f_center.y );
+    }
+
+    /// OpenGL coordinates address pixel corners, OpenCV pixel centers.
+    m_affine_p[0] = f_scale.x * r00_d;
+    m_affine_p[1] = f_scale.x * r01_d;
+    m_affine_p[2] = f_position.x + f_scale.x * ( f_offset.x + tx_d ) - m_origin.x - .5;
+    m_affine_p[3] = f_scale.y * r10_d;
+    m_affine_p[4] = f_scale.y * r11_d;
+    m_affine_p[5] = f_position.y + f_scale.y * ( f_offset.y + ty_d ) - m_origin.y - .5;
+}
+
+cv::Point2f
+CRasterTile::map ( float f_u_f, float f_v_f ) const
+{
+    return cv::Point2f ( m_affine_p[0] * f_u_f + m_affine_p[1] * f_v_f + m_affine_p[2],
+                         m_affine_p[3] * f_u_f + m_affine_p[4] * f_v_f + m_affine_p[5] );
+}
+
+cv::Rect
+CRasterTile::boundingBox ( const std::vector<cv::Point2f> & f_point_v,
+                           float                            f_margin_f ) const
+{
+    if ( f_point_v.empty() )
+        return cv::Rect();
+
+    float minX_f = f_point_v[0].x, maxX_f = f_point_v[0].x;
+    float minY_f = f_point_v[0].y, maxY_f = f_point_v[0].y;
+
+    for (unsigned int i = 1; i < f_point_v.size(); ++i)
+    {
+        minX_f = std::min ( minX_f, f_point_v[i].x );
+        maxX_f = std::max ( maxX_f, f_point_v[i].x );
+        minY_f = std::min ( minY_f, f_point_v[i].y );
+        maxY_f = std::max ( maxY_f, f_point_v[i].y );
+    }
+
+    /// Clip before converting to int.
+    minX_f = std::max ( minX_f - f_margin_f, -1.f );
+    minY_f = std::max ( minY_f - f_margin_f, -1.f );
+    maxX_f = std::min ( maxX_f + f_margin_f, (float) m_image.cols + 1.f );
+    maxY_f = std::min ( maxY_f + f_margin_f, (float) m_image.rows + 1.f );
+
+    if ( !( minX_f <= maxX_f && minY_f <= maxY_f ) )
+        return cv::Rect();
+
+    cv::Rect box ( cv::Point ( (int) floor ( minX_f ),  (int) floor ( minY_f ) ),
+                   cv::Point ( (int) ceil  ( maxX_f ) + 1, (int) ceil ( maxY_f ) + 1 ) );
+
+    return box & cv::Rect ( 0, 0, m_image.cols, m_image.rows );
+}
+
+cv::Mat
+CRasterTile::beginDraw ( const cv::Rect & f_box, 
+                         int              f_alpha_i )
+{
+    if ( f_alpha_i >= 255 )
+        return m_image ( f_box );
+
+    return m_image ( f_box ).clone();
+}
+
+void
+CRasterTile::endDraw ( cv::Mat &        fr_canvas,
+                       const cv::Rect & f_box, 
+                       int              f_alpha_i )
+{
+    if ( f_alpha_i >= 255 )
+        return;
+
+    cv::Mat roi = m_image ( f_box );
+    const double alpha_d = f_alpha_i / 255.;
+
+    cv::addWeighted ( fr_canvas, alpha_d, roi, 1. - alpha_d, 0., roi );
+}
+
+void
+CRasterTile::line ( float         f_u1_f, 
+                    float         f_v1_f,
+                    float         f_u2_f, 
+                    float         f_v2_f,
+                    const SRgba & f_color,
+                    float         f_width_f )
+{
+    if ( f_color.a == 0 )
+        return;
+
+    cv::Point2f p1 = map ( f_u1_f, f_v1_f );
+    cv::Point2f p2 = map ( f_u2_f, f_v2_f );
+
+    const float margin_f = f_width_f / 2.f + 2.f;
+
+    if ( !clipLine ( p1.x, p1.y, p2.x, p2.y, 
+                     -margin_f, -margin_f, 
+                     m_image.cols + margin_f, m_image.rows + margin_f ) )
+        return;
+
+    std::vector<cv::Point2f> point_v ( 2 );
+    point_v[0] = p1;
+    point_v[1] = p2;
+
+    const cv::Rect box = boundingBox ( point_v, margin_f );
+
+    if ( box.area() <= 0 )
+        return;
+
+    cv::Mat canvas = beginDraw ( box, f_color.a );
+
+    cv::line ( canvas, 
+               toFixed ( p1, box.tl() ),
+               toFixed ( p2, box.tl() ),
+               toScalar ( f_color ), 
+               toThickness ( f_width_f ), 
+               CV_AA, 
+               SUBPIXEL_SHIFT );
+
+    endDraw ( canvas, box, f_color.a );
+}
+
+void
+CRasterTile::polygon ( const std::vector< S2D<float> > & f_vertex_v,
+                       const SRgba &                     f_outlineColor,
+                       const SRgba &                     f_fillColor,
+                       float                             f_width_f )
+{
+    if ( f_vertex_v.size() < 2 ||
+         ( f_outlineColor.a == 0 && f_fillColor.a == 0 ) )
+        return;
+
+    std::vector<cv::Point2f> point_v ( f_vertex_v.size() );
+
+    for (unsigned int i = 0; i < f_vertex_v.size(); ++i)
+        point_v[i] = map ( f_vertex_v[i].x, f_vertex_v[i].y );
+
+    const cv::Rect box = boundingBox ( point_v, f_width_f / 2.f + 2.f );
+
+    if ( box.area() <= 0 )
+        return;
+
+    std::vector<cv::Point> fixed_v ( point_v.size() );
+
+    for (unsigned int i = 0; i < point_v.size(); ++i)
+        fixed_v[i] = toFixed ( point_v[i], box.tl() );
+
+    const cv::Point * points_p = &fixed_v[0];
+    const int         count_i  = fixed_v.size();
+
+    if ( f_fillColor.a != 0 && count_i > 2 )
+    {
+        cv::Mat canvas = beginDraw ( box, f_fillColor.a );
+
+        cv::fillPoly ( canvas, &points_p, &count_i, 1, 
+                       toScalar ( f_fillColor ), 
+                       CV_AA, 
+                       SUBPIXEL_SHIFT );
+
+        endDraw ( canvas, box, f_fillColor.a );
+    }
+
+    if ( f_outlineColor.a != 0 )
+    {
+        cv::Mat canvas = beginDraw ( box, f_outlineColor.a );
+
+        cv::polylines ( canvas, &points_p, &count_i, 1, true,
+                        toScalar ( f_outlineColor ), 
+                        toThickness ( f_width_f ), 
+                        CV_AA, 
+                        SUBPIXEL_SHIFT );
+
+        endDraw ( canvas, box, f_outlineColor.a );
+    }
+}
+
+void
+CRasterTile::text ( const char *  f_text_p,
+                    float         f_u_f, 
+                    float         f_v_f,
+                    const SRgba & f_color,
+                    float         f_fontSize_f,
+                    float         f_width_f )
+{
+    if ( f_color.a == 0 || !f_text_p || !f_text_p[0] )
+        return;
+
+    /// Text is scaled with the list but not rotated.
+    const double scale_d = sqrt ( fabs ( m_affine_p[0] * m_affine_p[4] - 
+                                         m_affine_p[1] * m_affine_p[3] ) );
+
+    const double fontScale_d = f_fontSize_f * scale_d / HERSHEY_HEIGHT;
+    const int    thickness_i = toThickness ( f_width_f );
+
+    if ( fontScale_d <= 0 )
+        return;
+
+    int baseline_i = 0;
+    const cv::Size size = cv::getTextSize ( f_text_p, 
+                                            cv::FONT_HERSHEY_SIMPLEX, 
+                                            fontScale_d, 
+                                            thickness_i, 
+                                            &baseline_i );
+    
+    const cv::Point2f origin = map ( f_u_f, f_v_f );
+
+    std::vector<cv::Point2f> point_v ( 2 );
+    point_v[0] = cv::Point2f ( origin.x, origin.y - size.height );
+    point_v[1] = cv::Point2f ( origin.x + size.width, origin.y + baseline_i );
+
+    const cv::Rect box = boundingBox ( point_v, thickness_i + 2.f );
+
+    if ( box.area() <= 0 )
+        return;
+
+    cv::Mat canvas = beginDraw ( box, f_color.a );
+
+    cv::putText ( canvas, 
+                  f_text_p, 
+                  cv::Point ( cvRound ( origin.x ) - box.x, 
+                              cvRound ( origin.y ) - box.y ),
+                  cv::FONT_HERSHEY_SIMPLEX, 
+                  fontScale_d,
+                  toScalar ( f_color ),
+                  thickness_i,
+                  CV_AA );
+
+    endDraw ( canvas, box, f_color.a );
+}
+
+cv::Rect
+CRasterTile::visibleRegion ( cv::Size f_size,
+                             float    f_u_f, 
+                             float    f_v_f,
+                             float    f_width_f,
+                             float    f_height_f ) const
+{
+    const double det_d = ( m_affine_p[0] * m_affine_p[4] - 
+                           m_affine_p[1] * m_affine_p[3] );
+
+    if ( f_size.width <= 0 || f_size.height <= 0 ||
+         fabs ( f_width_f ) < 1.e-6 || fabs ( f_height_f ) < 1.e-6 ||
+         fabs ( det_d ) < 1.e-12 )
+        return cv::Rect();
+
+    /// Map the corners of the tile back to image pixels.
+    const float corners_p[4][2] = { { -.5f,                -.5f },
+                                    { m_image.cols - .5f,  -.5f },
+                                    { -.5f,                m_image.rows - .5f },
+                                    { m_image.cols - .5f,  m_image.rows - .5f } };
+
+    const double sx_d = f_size.width  / f_width_f;
+    const double sy_d = f_size.height / f_height_f;
+
+    double minX_d =  HUGE_VAL, maxX_d = -HUGE_VAL;
+    double minY_d =  HUGE_VAL, maxY_d = -HUGE_VAL;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        const double x_d = corners_p[i][0] - m_affine_p[2];
+        const double y_d = corners_p[i][1] - m_affine_p[5];
+
+        /// Corner in list coordinates.
+        const double u_d = (  m_affine_p[4] * x_d - m_affine_p[1] * y_d ) / det_d;
+        const double v_d = ( -m_affine_p[3] * x_d + m_affine_p[0] * y_d ) / det_d;
+
+        const double j_d = ( u_d - f_u_f ) * sx_d;
+        const double i_d = ( v_d - f_v_f ) * sy_d;
+
+        minX_d = std::min ( minX_d, j_d ); maxX_d = std::max ( maxX_d, j_d );
+        minY_d = std::min ( minY_d, i_d ); maxY_d = std::max ( maxY_d, i_d );
+    }
+
+    minX_d = std::max ( minX_d - 1., 0. );
+    minY_d = std::max ( minY_d - 1., 0. );
+    maxX_d = std::min ( maxX_d + 1., (double) f_size.width );
+    maxY_d = std::min ( maxY_d + 1., (double) f_size.height );
+
+    if ( minX_d >= maxX_d || minY_d >= maxY_d )
+        return cv::Rect();
+
+    return cv::Rect ( cv::Point ( (int) floor ( minX_d ), (int) floor ( minY_d ) ),
+                      cv::Point ( (int) ceil  ( maxX_d ), (int) ceil  ( maxY_d ) ) );
+}
+
+void
+CRasterTile::image ( const cv::Mat & f_img,
+                     cv::Rect        f_region,
+                     cv::Size        f_size,
+                     float           f_u_f, 
+                     float           f_v_f,
+                     float           f_width_f,
+                     float           f_height_f,
+                     float           f_alpha_f )
+{
+    const int alpha_i = cvRound ( std::min ( f_alpha_f, 1.f ) * 255.f );
+
+    if ( alpha_i <= 0 || f_img.empty() )
+        return;
+
+    /// Center of pixel (j,i) of f_img is at list coordinates 
+    /// u + (j + region.x + .5) * sx, v + (i + region.y + .5) * sy.
+    const double sx_d = f_width_f  / f_size.width;
+    const double sy_d = f_height_f / f_size.height;
+    const double u0_d = f_u_f + ( f_region.x + .5 ) * sx_d;
+    const double v0_d = f_v_f + ( f_region.y + .5 ) * sy_d;
+
+    cv::Mat affine ( 2, 3, CV_64F );
+
+    affine.at<double>(0,0) = m_affine_p[0] * sx_d;
+    affine.at<double>(0,1) = m_affine_p[1] * sy_d;
+    affine.at<double>(0,2) = m_affine_p[0] * u0_d + m_affine_p[1] * v0_d + m_affine_p[2];
+    affine.at<double>(1,0) = m_affine_p[3] * sx_d;
+    affine.at<double>(1,1) = m_affine_p[4] * sy_d;
+    affine.at<double>(1,2) = m_affine_p[3] * u0_d + m_affine_p[4] * v0_d + m_affine_p[5];
+
+    /// Destination region.
+    std::vector<cv::Point2f> point_v ( 4 );
+    const float x1_f = -.5f, x2_f = f_img.cols - .5f;
+    const float y1_f = -.5f, y2_f = f_img.rows - .5f;
+    const float xs_p[4] = { x1_f, x2_f, x1_f, x2_f };
+    const float ys_p[4] = { y1_f, y1_f, y2_f, y2_f };
+
+    for (int i = 0; i < 4; ++i)
+    {
+        point_v[i].x = affine.at<double>(0,0) * xs_p[i] + affine.at<double>(0,1) * ys_p[i] + affine.at<double>(0,2);
+        point_v[i].y = affine.at<double>(1,0) * xs_p[i] + affine.at<double>(1,1) * ys_p[i] + affine.at<double>(1,2);
+    }
+
+    const cv::Rect box = boundingBox ( point_v, 1.f );
+
+    if ( box.area() <= 0 )
+        return;
+
+    affine.at<double>(0,2) -= box.x;
+    affine.at<double>(1,2) -= box.y;
+
+    cv::Mat canvas = beginDraw ( box, alpha_i );
+
+    /// Pixels outside of the image are not modified.
+    cv::warpAffine ( f_img, canvas, affine, canvas.size(),
+                     cv::INTER_NEAREST, cv::BORDER_TRANSPARENT );
+
+    endDraw ( canvas, box, alpha_i );
+}
+
+////////////////////////////
+
+CRasterizer::CRasterizer ( )
+        : m_screenSize (        640, 480 ),
+          m_screenCount (           1, 1 ),
+          m_background (         0, 0, 0 ),
+          m_tileHeight_i (            32 )
+{
+}
+
+CRasterizer::~CRasterizer ( )
+{
+}
+
+bool
+CRasterizer::setTileHeight ( int f_height_i )
+{
+    if ( f_height_i < 1 )
+        return false;
+
+    m_tileHeight_i = f_height_i;
+    return true;
+}
+
+bool
+CRasterizer::render ( const CDrawingList & f_list,
+                      cv::Mat &            fr_image ) const
+{
+    fr_image.create ( m_screenSize.height, m_screenSize.width, CV_8UC3 );
+
+    std::vector<const CDrawingList *> list_v ( 1, &f_list );
+
+    return renderTiles ( list_v, false, fr_image );
+}
+
+bool
+CRasterizer::render ( const std::vector<const CDrawingList *> & f_list_v,
+                      cv::Mat &                                 fr_image ) const
+{
+    fr_image.create ( m_screenSize.height * m_screenCount.height, 
+                      m_screenSize.width  * m_screenCount.width, 
+                      CV_8UC3 );
+
+    return renderTiles ( f_list_v, true, fr_image );
+}
+
+bool
+CRasterizer::render ( const CDrawingListHandler & f_handler,
+                      cv::Mat &                   fr_image ) const
+{
+    std::vector<const CDrawingList *> list_v;
+    collectLists ( f_handler.getRootNode(), list_v );
+
+    return render ( list_v, fr_image );
+}
+
+void
+CRasterizer::collectLists ( const CDisplayOpNode *              f_node_p,
+                            std::vector<const CDrawingList *> & fr_list_v )
+{
+    if ( f_node_p == NULL ) return;
+
+    for (unsigned int i = 0; i < f_node_p -> getDisplayCount(); ++i)
+        fr_list_v.push_back ( f_node_p -> getDisplayChild ( i ) -> getDrawingList() );
+
+    for (unsigned int i = 0; i < f_node_p -> getOpCount(); ++i)
+        collectLists ( f_node_p -> getOpChild ( i ), fr_list_v );
+}
+
+bool
+CRasterizer::renderTiles ( const std::vector<const CDrawingList *> & f_list_v,
+                           bool                                      f_usePosition_b,
+                           cv::Mat &                                 fr_image ) const
+{
+    fr_image.setTo ( cv::Scalar ( m_background.b, m_background.g, m_background.r ) );
+
+    /// Visible lists in drawing order.
+    std::vector<const CDrawingList *> list_v;
+
+    for (int l = 0; l < MAX_OVERLAY_LEVELS; ++l)
+    {
+        for (unsigned int i = 0; i < f_list_v.size(); ++i)
+        {
+            const CDrawingList * list_p = f_list_v[i];
+
+            if ( !list_p || !list_p -> isVisible() || 
+                 list_p -> getOverlayLevel() != l )
+                continue;
+
+            if ( f_usePosition_b )
+            {
+                const S2D<int> pos = list_p -> getPosition();
+
+                if ( pos.x < 0 || pos.x >= (int) m_screenCount.width ||
+                     pos.y < 0 || pos.y >= (int) m_screenCount.height )
+                    continue;
+            }
+
+            list_v.push_back ( list_p );
+        }
+    }
+
+    const int tiles_i = ( fr_image.rows + m_tileHeight_i - 1 ) / m_tileHeight_i;
+    bool success_b = true;
+
+#pragma omp parallel for schedule(dynamic) reduction(&&:success_b)
+    for (int t = 0; t < tiles_i; ++t)
+    {
+        const int y_i = t * m_tileHeight_i;
+        CRasterTile tile ( fr_image, 
+                           cv::Rect ( 0, y_i, 
+                                      fr_image.cols, 
+                                      std::min ( m_tileHeight_i, fr_image.rows - y_i ) ) );
+
+        for (unsigned int i = 0; i < list_v.size(); ++i)
+        {
+            const CDrawingList * list_p = list_v[i];
+            S2D<float> position ( 0.f, 0.f );
+
+            if ( f_usePosition_b )
+                position = S2D<float> ( list_p -> getPosition().x * (float) m_screenSize.width,
+                                        list_p -> getPosition().y * (float) m_screenSize.height );
+
+            tile.setTransform ( position,
+                                S2D<float> ( list_p -> getScaleX(),  list_p -> getScaleY() ),
+                                S2D<float> ( list_p -> getOffsetX(), list_p -> getOffsetY() ),
+                                list_p -> getRotation(),
+                                S2D<float> ( m_screenSize.width / 2.f, m_screenSize.height / 2.f ) );
+
+            success_b = list_p -> render ( tile ) && success_b;
+        }
+    }
+
+    return success_b;
+}
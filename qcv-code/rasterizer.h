@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose. 
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+#ifndef __RASTERIZER_H
+#define __RASTERIZER_H
+
+/**
+ *******************************************************************************
+ *
+ * @file rasterizer.h
+ *
+ * \class CRasterizer
+ * \author Hernan Badino (hernan.badino@gmail.com)
+ *
+ * \brief Renders drawing lists into a cv::Mat without OpenGL.
+ *
+ * The output image (CV_8UC3, BGR) is divided in horizontal tiles that are
+ * rendered in parallel. Every tile renders all drawing lists in the same
+ * order as CDisplay (overlay levels, then the order of the display tree),
+ * so that the result does not depend on the number of threads. The
+ * screen position, scale, offset and rotation of every list are applied
+ * as in CDisplay.
+ *
+ * Lines and outlines are anti-aliased, primitives with alpha lower than
+ * 255 are blended, images are mapped with nearest neighbor interpolation.
+ * Text is rendered with the Hershey font of OpenCV and is not rotated.
+ *
+ * \class CRasterTile
+ *
+ * \brief Region of the output image rendered by one thread.
+ *
+ * Drawing element lists render their elements into a tile with
+ * CDrawingElementList::render(). The tile maps the drawing list
+ * coordinates to its pixels and clips everything to its region.
+ *
+ *******************************************************************************/
+
+/* INCLUDES */
+#include <vector>
+
+#include <opencv/cv.h>
+
+#include "colors.h"
+#include "standardTypes.h"
+
+/* CONSTANTS */
+
+namespace QCV
+{
+    /* PROTOTYPES */
+    class CDrawingList;
+    class CDrawingListHandler;
+    class CDisplayOpNode;
+
+    class CRasterTile
+    {
+    /// Constructors, Destructors
+    public:
+        /// Tile covering the region f_region of f_image.
+        CRasterTile ( cv::Mat &  fr_image,
+                      cv::Rect   f_region );
+
+    /// Transformation
+    public:
+        /// Set the transformation of the current drawing list (screen
+        /// position in pixels, scale, offset and rotation in degrees 
+        /// around f_center).
+        void        setTransform ( S2D<float> f_position,
+                                   S2D<float> f_scale,
+                                   S2D<float> f_offset,
+                                   double     f_rotation_d,
+                                   S2D<float> f_center );
+
+        /// Map a point of the drawing list to the pixel coordinates of 
+        /// the tile.
+        cv::Point2f map ( float f_u_f, float f_v_f ) const;
+
+    /// Drawing
+    public:
+        /// Anti-aliased line.
+        void        line ( float         f_u1_f, 
+                           float         f_v1_f,
+                           float         f_u2_f, 
+                           float         f_v2_f,
+                           const SRgba & f_color,
+                           float         f_width_f );
+
+        /// Polygon with optional fill (fill alpha 0 means no fill).
+        void        polygon ( const std::vector< S2D<float> > & f_vertex_v,
+                              const SRgba &                     f_outlineColor,
+                              const SRgba &                     f_fillColor,
+                              float                             f_width_f );
+
+        /// Text with the baseline starting at the given point.
+        void        text ( const char *  f_text_p,
+                           float         f_u_f, 
+                           float         f_v_f,
+                           const SRgba & f_color,
+                           float         f_fontSize_f,
+                           float         f_width_f );
+
+        /// Region of an image of size f_size displayed at (u,v) with
+        /// size (w,h) that is visible in this tile. Empty if the image
+        /// is not visible.
+        cv::Rect    visibleRegion ( cv::Size f_size,
+                                    float    f_u_f, 
+                                    float    f_v_f,
+                                    float    f_width_f,
+                                    float    f_height_f ) const;
+
+        /// Image. f_region is the visible region of the image of size
+        /// f_size and f_img its content converted to CV_8UC3.
+        void        image ( const cv::Mat & f_img,
+                            cv::Rect        f_region,
+                            cv::Size        f_size,
+                            float           f_u_f, 
+                            float           f_v_f,
+                            float           f_width_f,
+                            float           f_height_f,
+                            float           f_alpha_f );
+
+    /// Get/Set
+    public:
+        /// Pixels of the tile.
+        cv::Mat &   getImage ( ) { return m_image; }
+
+    /// Private methods
+    private:
+        /// Bounding box in tile pixels of the given points, enlarged by
+        /// f_margin_f and clipped to the tile.
+        cv::Rect    boundingBox ( const std::vector<cv::Point2f> & f_point_v,
+                                  float                            f_margin_f ) const;
+
+        /// Get the canvas where to draw the region f_box with the given
+        /// alpha and blend it back after drawing.
+        cv::Mat     beginDraw ( const cv::Rect & f_box, 
+                                int              f_alpha_i );
+        void        endDraw   ( cv::Mat &        fr_canvas,
+                                const cv::Rect & f_box, 
+                                int              f_alpha_i );
+
+    /// Private members
+    private:
+        /// Pixels of the tile.
+        cv::Mat              m_image;
+
+        /// Position of the tile in the output image.
+        cv::Point            m_origin;
+
+        /// Affine transformation from list coordinates to tile pixels.
+        double               m_affine_p[6];
+    };
+
+    class CRasterizer
+    {
+    /// Constructors, Destructors
+    public:
+        CRasterizer ( );
+        virtual ~CRasterizer ( );
+
+    /// Operations
+    public:
+        /// Render a single list into an image of the screen size. The
+        /// screen position of the list is ignored.
+        bool        render ( const CDrawingList & f_list,
+                             cv::Mat &            fr_image ) const;
+
+        /// Render the visible lists at their screen positions into an
+        /// image of screen count times screen size pixels.
+        bool        render ( const std::vector<const CDrawingList *> & f_list_v,
+                             cv::Mat &                                 fr_image ) const;
+
+        /// Render all visible lists of a drawing list handler.
+        bool        render ( const CDrawingListHandler & f_handler,
+                             cv::Mat &                   fr_image ) const;
+
+    /// Get/Set
+    public:
+        /// Size of every screen.
+        void              setScreenSize ( S2D<unsigned int> f_size ) { m_screenSize = f_size; }
+        S2D<unsigned int> getScreenSize ( ) const { return m_screenSize; }
+
+        /// Number of screens.
+        void              setScreenCount ( S2D<unsigned int> f_count ) { m_screenCount = f_count; }
+        S2D<unsigned int> getScreenCount ( ) const { return m_screenCount; }
+
+        /// Background color.
+        void              setBackgroundColor ( SRgb f_color ) { m_background = f_color; }
+        SRgb              getBackgroundColor ( ) const { return m_background; }
+
+        /// Height of the tiles in pixels.
+        bool              setTileHeight ( int f_height_i );
+        int               getTileHeight ( ) const { return m_tileHeight_i; }
+
+    /// Private methods
+    private:
+        /// Render the lists into the tiles of the image.
+        bool        renderTiles ( const std::vector<const CDrawingList *> & f_list_v,
+                                  bool                                      f_usePosition_b,
+                                  cv::Mat &                                 fr_image ) const;
+
+        /// Collect the drawing lists of the display tree.
+        static void collectLists ( const CDisplayOpNode *              f_node_p,
+                                   std::vector<const CDrawingList *> & fr_list_v );
+
+    /// Private members
+    private:
+        /// Size of every screen.
+        S2D<unsigned int>       m_screenSize;
+
+        /// Number of screens.
+        S2D<unsigned int>       m_screenCount;
+
+        /// Background color.
+        SRgb                    m_background;
+
+        /// Tile height.
+        int                     m_tileHeight_i;
+    };
+}
+
+#endif // __RASTERIZER_H
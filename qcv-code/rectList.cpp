@@ -29,7 +29,7 @@
 
 /* INCLUDES */
 #include "rectList.h"
-#include "glheader.h"
+#include "rasterizer.h"
 #include <stdio.h>
 
 
@@ -114,51 +114,6 @@ CRectangleList::clear ()
     return m_rect_v.size();
 }
 
-// Draw all rectangles.
-bool
-CRectangleList::show () const
-{
-    std::vector< SRectangle >::const_iterator last = m_rect_v.end();
-
-    for (std::vector< SRectangle >::const_iterator i = m_rect_v.begin(); 
-         i != last; ++i )
-    {
-        glLineWidth( i->lineWidth_f );
-        
-        /// If not complete transparent.
-        if ( i->fillColor.a != 0 )
-        {
-            glColor4ub( i->fillColor.r, 
-                        i->fillColor.g, 
-                        i->fillColor.b, 
-                        i->fillColor.a );
-            
-            glBegin(GL_POLYGON);
-            glVertex2f ( i->u1_f, i->v1_f );
-            glVertex2f ( i->u2_f, i->v1_f );
-            glVertex2f ( i->u2_f, i->v2_f );
-            glVertex2f ( i->u1_f, i->v2_f );
-            glEnd();
-        }       
-
-        glColor4ub( i->outlineColor.r, 
-                    i->outlineColor.g, 
-                    i->outlineColor.b, 
-                    i->outlineColor.a );
-        
-        glBegin ( GL_LINE_LOOP ) ;
-        glVertex2f ( i->u1_f, i->v1_f );
-        glVertex2f ( i->u2_f, i->v1_f );
-        glVertex2f ( i->u2_f, i->v2_f );
-        glVertex2f ( i->u1_f, i->v2_f );
-        glEnd();
-
-    }
-
-    /// Todo: Check GL status and return value.
-    return true;
-}
-
 bool
 CRectangleList::write ( FILE*                f_file_p,
                         const float          f_offsetU_f /* = 0.0 */,
@@ -212,6 +167,30 @@ CRectangleList::write ( FILE*                f_file_p,
     return true;
 }
 
+// Render all rectangles.
+bool
+CRectangleList::render ( CRasterTile & fr_tile ) const
+{
+    std::vector< SRectangle >::const_iterator last = m_rect_v.end();
+    std::vector< S2D<float> > vertex_v ( 4 );
+
+    for (std::vector< SRectangle >::const_iterator i = m_rect_v.begin(); 
+         i != last; ++i )
+    {
+        vertex_v[0] = S2D<float> ( i->u1_f, i->v1_f );
+        vertex_v[1] = S2D<float> ( i->u2_f, i->v1_f );
+        vertex_v[2] = S2D<float> ( i->u2_f, i->v2_f );
+        vertex_v[3] = S2D<float> ( i->u1_f, i->v2_f );
+
+        fr_tile.polygon ( vertex_v, 
+                          i->outlineColor, 
+                          i->fillColor, 
+                          i->lineWidth_f );
+    }
+
+    return true;
+}
+
 /// Return number of elements.
 int
 CRectangleList::getSize () const
@@ -91,8 +91,8 @@ namespace QCV
         // Clear all rects.
         virtual bool clear ();
 
-        // Draw all rects.
-        virtual bool show () const;
+        // Draw all rects (OpenGL, defined in rectListGL.cpp).
+        bool show () const;
 
         // Write rect in a SVG file.
         virtual bool write ( FILE*                f_file_p,
@@ -100,6 +100,9 @@ namespace QCV
                              const float          f_offsetV_f = 0.0,
                              const std::string    f_parameters_str = "") const;
 
+        // Render rectangles into an image tile.
+        virtual bool render ( CRasterTile &      fr_tile ) const;
+
         // Return number of elements.
         virtual int  getSize () const;
 
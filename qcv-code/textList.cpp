@@ -29,9 +29,8 @@
 
 /* INCLUDES */
 #include "textList.h"
-#include "glheader.h"
+#include "rasterizer.h"
 #include <stdio.h>
-#include <GL/glut.h>
 #include <string.h>
 
 using namespace QCV;
@@ -90,66 +89,6 @@ CTextList::clear ()
     return m_text_v.size();
 }
 
-// Draw all texts.
-bool
-CTextList::show () const
-{
-    std::vector< SText >::const_iterator last = m_text_v.end();
-
-    glEnable(GL_LINE_SMOOTH);
-    
-    glDisable(GL_TEXTURE_2D);
-    for (std::vector< SText >::const_iterator i = m_text_v.begin(); 
-         i != last; ++i )
-    {   
-        // glLineWidth(i->lineWidth_f);
-        // glColor4ub( i->color.r, i->color.g, i->color.b, i->color.a );
-        // glRasterPos3f(i->u_f, i->v_f, 0.0);
-
-        // for(int j=0; i->text_str[j]!='\0'; j++)
-        // {
-        //     glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, i->text_str[j]);
-        //     //printf("%c\n",  i->text_str[j]);
-        // }
-
-        double iScale = ((i->fontSize_f)/101.0);
-        glPushMatrix ();
-        glTranslatef ((i->u_f),(i->v_f),0.0);
-
-        glLineWidth(i->lineWidth_f);
-        glColor4ub( i->color.r, i->color.g, i->color.b, i->color.a );
-        glScalef(iScale,iScale,iScale);
-        glRotatef(180.0,1.0,0.0,0.0);
-
-        if ( i->fixSize_b)
-        {
-            for(int j=0; i->text_str[j]!='\0'; j++)
-            {
-                glutStrokeCharacter (GLUT_STROKE_MONO_ROMAN, i->text_str[j]);
-            }
-        }
-
-        else
-        {
-            for(int j=0; i->text_str[j]!='\0'; j++)
-            {
-                glutStrokeCharacter (GLUT_STROKE_ROMAN, i->text_str[j]);
-            }
-        }
-
-        glLineWidth(1.0);
-        glRotatef(180.0,1.0,0.0,0.0);
-        glPopMatrix();
-        glFlush();
-    }
-    glEnable(GL_TEXTURE_2D);
-
-    glDisable(GL_LINE_SMOOTH);
-
-    /// Todo: Check GL status and return value.
-    return true;
-}
-
 bool
 CTextList::write ( FILE*                f_file_p,
                    const float          f_offsetU_f /* = 0.0 */,
@@ -200,6 +139,25 @@ CTextList::write ( FILE*                f_file_p,
     return true;
 }
 
+// Render all texts.
+bool
+CTextList::render ( CRasterTile & fr_tile ) const
+{
+    std::vector< SText >::const_iterator last = m_text_v.end();
+
+    for (std::vector< SText >::const_iterator i = m_text_v.begin(); 
+         i != last; ++i )
+    {
+        fr_tile.text ( i->text_str, 
+                       i->u_f, i->v_f, 
+                       i->color, 
+                       i->fontSize_f,
+                       i->lineWidth_f );
+    }
+
+    return true;
+}
+
 /// Return number of elements.
 int
 CTextList::getSize () const
@@ -82,8 +82,8 @@ namespace QCV
         // Clear all texts.
         virtual bool clear ();
 
-        // Draw all texts.
-        virtual bool show () const;
+        // Draw all texts (OpenGL, defined in textListGL.cpp).
+        bool show () const;
 
         // Write text in a SVG file.
         virtual bool write ( FILE*                f_file_p,
@@ -91,6 +91,9 @@ namespace QCV
                              const float          f_offsetV_f = 0.0,
                              const std::string    f_parameters_str = "") const;
 
+        // Render texts into an image tile.
+        virtual bool render ( CRasterTile &      fr_tile ) const;
+
         // Return number of elements.
         virtual int  getSize () const;
 
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2012 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of QCV
+ *
+ * QCV is under the terms of the GNU Lesser General Public License
+ * version 2.1. See the GNU LGPL version 2.1 for details.
+ * QCV is distributed "AS IS" without ANY WARRANTY, without even the
+ * implied warranty of merchantability or fitness for a particular
+ * purpose. 
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+/*@@@**************************************************************************
+ * \file  textListGL.cpp
+ * \author Hernan Badino
+ * \notes 
+ *******************************************************************************
+ *****             (C) Hernan Badino 2012 - All Rights Reserved            *****
+ ******************************************************************************/
+
+/* INCLUDES */
+#include "textList.h"
+#include "glheader.h"
+#include <GL/glut.h>
+
+using namespace QCV;
+
+// Draw all texts.
+bool
+CTextList::show () const
+{
+    std::vector< SText >::const_iterator last = m_text_v.end();
+
+    glEnable(GL_LINE_SMOOTH);
+    
+    glDisable(GL_TEXTURE_2D);
+    for (std::vector< SText >::const_iterator i = m_text_v.begin(); 
+         i != last; ++i )
+    {   
+        // glLineWidth(i->lineWidth_f);
+        // glColor4ub( i->color.r, i->color.g, i->color.b, i->color.a );
+        // glRasterPos3f(i->u_f, i->v_f, 0.0);
+
+        // for(int j=0; i->text_str[j]!='\0'; j++)
+        // {
+        //     glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, i->text_str[j]);
+        //     //printf("%c\n",  i->text_str[j]);
+        // }
+
+        double iScale = ((i->fontSize_f)/101.0);
+        glPushMatrix ();
+        glTranslatef ((i->u_f),(i->v_f),0.0);
+
+        glLineWidth(i->lineWidth_f);
+        glColor4ub( i->color.r, i->color.g, i->color.b, i->color.a );
+        glScalef(iScale,iScale,iScale);
+        glRotatef(180.0,1.0,0.0,0.0);
+
+        if ( i->fixSize_b)
+        {
+            for(int j=0; i->text_str[j]!='\0'; j++)
+            {
+                glutStrokeCharacter (GLUT_STROKE_MONO_ROMAN, i->text_str[j]);
+            }
+        }
+
+        else
+        {
+            for(int j=0; i->text_str[j]!='\0'; j++)
+            {
+                glutStrokeCharacter (GLUT_STROKE_ROMAN, i->text_str[j]);
+            }
+        }
+
+        glLineWidth(1.0);
+        glRotatef(180.0,1.0,0.0,0.0);
+        glPopMatrix();
+        glFlush();
+    }
+    glEnable(GL_TEXTURE_2D);
+
+    glDisable(GL_LINE_SMOOTH);
+
+    /// Todo: Check GL status and return value.
+    return true;
+}
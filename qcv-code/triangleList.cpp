@@ -29,7 +29,7 @@
 
 /* INCLUDES */
 #include "triangleList.h"
-#include "glheader.h"
+#include "rasterizer.h"
 #include <stdio.h>
 
 using namespace QCV;
@@ -168,49 +168,6 @@ CTriangleList::clear ()
     return m_triangle_v.size();
 }
 
-// Draw all triangles.
-bool 
-CTriangleList::show () const
-{
-    std::vector< STriangle >::const_iterator last = m_triangle_v.end();
-
-    for (std::vector< STriangle >::const_iterator i = m_triangle_v.begin(); 
-         i != last; ++i )
-    {
-        glLineWidth( i->lineWidth_f );
-        
-        /// If not complete transparent.
-        if ( i->fillColor.a != 0 )
-        {
-            glColor4ub( i->fillColor.r, 
-                        i->fillColor.g, 
-                        i->fillColor.b, 
-                        i->fillColor.a );
-            
-            glBegin(GL_POLYGON);
-            for (int v = 0; v < 3; ++v)
-                glVertex2f ( i->vertices[v].x, 
-                             i->vertices[v].y );
-            glEnd();
-        }       
-
-        glColor4ub( i->outlineColor.r, 
-                    i->outlineColor.g, 
-                    i->outlineColor.b, 
-                    i->outlineColor.a );
-        
-        glBegin ( GL_LINE_LOOP ) ;
-        for (int v = 0; v < 3; ++v)
-            glVertex2f ( i->vertices[v].x, 
-                         i->vertices[v].y );
-        glEnd();
-
-    }
-
-    /// Todo: Check GL status and return value.
-    return true;
-}
-
 bool 
 CTriangleList::write ( FILE*                f_file_p,
                        const float          f_offsetU_f /* = 0.0 */,
@@ -279,6 +236,29 @@ CTriangleList::write ( FILE*                f_file_p,
     
 }
 
+// Render all triangles.
+bool
+CTriangleList::render ( CRasterTile & fr_tile ) const
+{
+    std::vector< STriangle >::const_iterator last = m_triangle_v.end();
+    std::vector< S2D<float> > vertex_v ( 3 );
+
+    for (std::vector< STriangle >::const_iterator i = m_triangle_v.begin(); 
+         i != last; ++i )
+    {
+        vertex_v[0] = i->vertices[0];
+        vertex_v[1] = i->vertices[1];
+        vertex_v[2] = i->vertices[2];
+
+        fr_tile.polygon ( vertex_v, 
+                          i->outlineColor, 
+                          i->fillColor, 
+                          i->lineWidth_f );
+    }
+
+    return true;
+}
+
 /// Return number of elements.
 int
 CTriangleList::getSize () const
@@ -111,8 +111,8 @@ namespace QCV
         // Clear all triangles.
         virtual bool clear ();
 
-        // Draw all triangles.
-        virtual bool show () const;
+        // Draw all triangles (OpenGL, defined in triangleListGL.cpp).
+        bool show () const;
 
         // Write triangle in a SVG file.
         virtual bool write ( FILE*                f_file_p,
@@ -120,6 +120,9 @@ namespace QCV
                              const float          f_offsetV_f = 0.0,
                              const std::string    f_parameters_str = "") const;
 
+        // Render triangles into an image tile.
+        virtual bool render ( CRasterTile &      fr_tile ) const;
+
         // Return number of elements.
         virtual int  getSize () const;
 
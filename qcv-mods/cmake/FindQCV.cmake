@@ -84,6 +84,11 @@ else (QCV_LIBRARIES AND QCV_INCLUDE_DIRS)
         PATHS "$ENV{QCV_DIR}" "$ENV{QCV_DIR}/build/" "$ENV{QCV_DIR}/lib" "$ENV{QCV_DIR}/build/lib" "$ENV{QCV_DIR}/build/lib" "${CMAKE_SOURCE_DIR}/external/install/qcv/lib" "${CMAKE_SOURCE_DIR}/../qcv-code/build/"
     )
     # find library paths
+    find_library (QCV_CORE_LIB
+        NAMES qcvcore
+        PATHS "$ENV{QCV_DIR}" "$ENV{QCV_DIR}/build/" "$ENV{QCV_DIR}/lib" "$ENV{QCV_DIR}/build/lib" "$ENV{QCV_DIR}/build/lib" "${CMAKE_SOURCE_DIR}/external/install/qcv/lib" "${CMAKE_SOURCE_DIR}/../qcv-code/build/"
+    )
+    # find library paths
     find_library (QCV_OP_LIB
         NAMES qcvoperators
         PATHS "$ENV{QCV_DIR}" "$ENV{QCV_DIR}/build/modules/operators" "$ENV{QCV_DIR}/build/lib" "$ENV{QCV_DIR}/lib" "${CMAKE_SOURCE_DIR}/external/install/qcv/lib"  "${CMAKE_SOURCE_DIR}/../qcv-code/build/modules/operators"
@@ -94,11 +99,21 @@ else (QCV_LIBRARIES AND QCV_INCLUDE_DIRS)
         PATHS "$ENV{QCV_DIR}" "$ENV{QCV_DIR}/build/modules/sequencer" "$ENV{QCV_DIR}/lib" "$ENV{QCV_DIR}/build/lib" "${CMAKE_SOURCE_DIR}/external/install/qcv/lib"  "${CMAKE_SOURCE_DIR}/../qcv-code/build/modules/sequencer"
     )
     # find library paths
+    find_library (QCV_SEQCORE_LIB
+        NAMES qcvsequencercore
+        PATHS "$ENV{QCV_DIR}" "$ENV{QCV_DIR}/build/modules/sequencer" "$ENV{QCV_DIR}/lib" "$ENV{QCV_DIR}/build/lib" "${CMAKE_SOURCE_DIR}/external/install/qcv/lib"  "${CMAKE_SOURCE_DIR}/../qcv-code/build/modules/sequencer"
+    )
+    # find library paths
     find_library (QCV_PEDT_LIB
         NAMES qcvpeditor
         PATHS "$ENV{QCV_DIR}" "$ENV{QCV_DIR}/build/modules/paramEditor" "$ENV{QCV_DIR}/lib" "$ENV{QCV_DIR}/build/lib" "${CMAKE_SOURCE_DIR}/external/install/qcv/lib"  "${CMAKE_SOURCE_DIR}/../qcv-code/build/modules/paramEditor"
     )
     # find library paths
+    find_library (QCV_PARAM_LIB
+        NAMES qcvparam
+        PATHS "$ENV{QCV_DIR}" "$ENV{QCV_DIR}/build/modules/paramEditor" "$ENV{QCV_DIR}/lib" "$ENV{QCV_DIR}/build/lib" "${CMAKE_SOURCE_DIR}/external/install/qcv/lib"  "${CMAKE_SOURCE_DIR}/../qcv-code/build/modules/paramEditor"
+    )
+    # find library paths
     find_library (QCV_MISC_LIB
         NAMES qcvmisc
         PATHS "$ENV{QCV_DIR}" "$ENV{QCV_DIR}/build/modules/misc"  "$ENV{QCV_DIR}/lib" "$ENV{QCV_DIR}/build/lib" "${CMAKE_SOURCE_DIR}/external/install/qcv/lib" "${CMAKE_SOURCE_DIR}/../qcv-code/build/modules/misc"
@@ -117,13 +132,17 @@ else (QCV_LIBRARIES AND QCV_INCLUDE_DIRS)
 	 ${QCV_OP_LIB} 
 	 ${QCV_SEQ_LIB} 
 	 ${QCV_PEDT_LIB}
-	 ${QCV_MISC_LIB} )
+	 ${QCV_MISC_LIB}
+	 ${QCV_SEQCORE_LIB}
+	 ${QCV_PARAM_LIB}
+	 ${QCV_CORE_LIB} )
 
 
        MESSAGE(STATUS "${QCV_LIBRARIES}")
     # set FOUND variable
     if ( QCV_INC_DIR AND QCV_OP_DIR AND QCV_SEQ_DIR AND QCV_PEDT_DIR AND QCV_MISC_DIR AND 
-         QCV_MAIN_LIB AND QCV_OP_LIB AND  QCV_SEQ_LIB AND QCV_PEDT_LIB AND QCV_MISC_LIB )
+         QCV_MAIN_LIB AND QCV_OP_LIB AND  QCV_SEQ_LIB AND QCV_PEDT_LIB AND QCV_MISC_LIB AND
+         QCV_CORE_LIB AND QCV_SEQCORE_LIB AND QCV_PARAM_LIB )
         set(QCV_FOUND TRUE)
 
         set (QCV_LIBRARIES_OPTIONAL ${QCV_LIBRARIES}) 
@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2015 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of StereoSFM
+ *
+ * StereoSFM is under the terms of the GNU General Public License v2.
+ * See the GNU GPL version 2.0 for details.
+ * StereoSFM uses dual licensing. Contact the author to get information
+ * for a commercial/proprietary license.
+ *
+ * StereoSFM is distributed "AS IS" without ANY WARRANTY, without even 
+ * the implied warranty of merchantability or fitness for a particular
+ * purpose.
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+/*
+
+This project is an implementation of the method presented in the paper:
+
+Hernan Badino and Takeo Kanade. A Head-Wearable Short-Baseline Stereo System for the Simultaneous Estimation of Structure and Motion. In IAPR Conference on Machine Vision Applications (MVA), Nara, Japan, June 2011.
+*/
+
+/**
+ * Compares the minimization of the ego-motion cost with 
+ * NumericalSolver::solveByNewton (numerical derivatives) and with 
+ * NumericalSolver::solveByLevenbergMarquardt (analytic Jacobian) on 
+ * synthetic data.
+ *
+ * Usage: egoMotionBenchmark [features [trials [noise]]]
+ *
+ * For every trial random 3D points are transformed with a known motion,
+ * projected into a synthetic stereo camera and perturbed with gaussian 
+ * noise of the given standard deviation [px]. The number of iterations,
+ * cost evaluations, the wall time, the final residuum and the error of
+ * the estimated motion are printed for both solvers.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+#include <opencv2/core/core.hpp>
+
+#include "clock.h"
+#include "numericalSolver.h"
+#include "stereoEgoMotionCost.h"
+
+using namespace QCV;
+
+namespace
+{
+   struct SResult
+   {
+      SResult() : iterations_i ( 0 ), evaluations_i ( 0 ), 
+                  residuum_d ( 0 ), error_d ( 0 ) {}
+
+      int       iterations_i;
+      int       evaluations_i;
+      double    residuum_d;
+      double    error_d;
+   };
+
+   double stateError ( const double * f_state_p, const double * f_truth_p )
+   {
+      double sum_d = 0;
+      for (int i = 0; i < 6; ++i)
+         sum_d += (f_state_p[i] - f_truth_p[i]) * (f_state_p[i] - f_truth_p[i]);
+      return sqrt(sum_d);
+   }
+
+   void print ( const char * f_name_p, 
+                const SResult & f_result, 
+                const CClock & f_clock, 
+                int f_trials_i )
+   {
+      printf("%-22s %10.2f %12.1f %12.4f %12.6f %14.8f\n",
+             f_name_p,
+             f_result.iterations_i  / (double) f_trials_i,
+             f_result.evaluations_i / (double) f_trials_i,
+             f_clock.getTotalTime() / f_trials_i,
+             f_result.residuum_d    / f_trials_i,
+             f_result.error_d       / f_trials_i );
+   }
+}
+
+int main(int f_argc_i, char *f_argv_p[])
+{
+   int    features_i = f_argc_i > 1 ? atoi(f_argv_p[1]) : 1500;
+   int    trials_i   = f_argc_i > 2 ? atoi(f_argv_p[2]) : 100;
+   double noise_d    = f_argc_i > 3 ? atof(f_argv_p[3]) : 0.5;
+
+   if ( features_i < 6 || trials_i < 1 || noise_d < 0 )
+   {
+      printf("Usage: %s [features [trials [noise]]]\n", f_argv_p[0]);
+      return 1;
+   }
+
+   const int    maxIters_i = 5;
+   const double tolerance_d = 1.e-5;
+
+   CStereoCamera camera;
+   camera.setFocalLength    ( 500. );
+   camera.setPrincipalPoint ( 320., 240. );
+   camera.setBaseline       ( 0.12 );
+
+   /// Ground truth motion: rotation axis scaled by angle and translation.
+   const double truth_p[6] = { 0.01, 0.02, -0.005, 0.05, -0.01, 0.5 };
+
+   C3DMatrix rotation;
+   rotation.loadIdentity();
+   C3DVector axis ( truth_p[0], truth_p[1], truth_p[2] );
+   double angle_d = axis.magnitude();
+   axis /= angle_d;
+   rotation.rotateAxis ( axis, angle_d );
+   C3DVector translation ( truth_p[3], truth_p[4], truth_p[5] );
+
+   cv::RNG rng ( 12345 );
+
+   SResult newton, lm;
+   CClock  newtonClock ( "Newton" );
+   CClock  lmClock ( "Levenberg-Marquardt" );
+
+   for (int t = 0; t < trials_i; ++t)
+   {
+      CFeatureVector         curr;
+      std::vector<C3DVector> prev3D_v;
+      std::vector<double>    weight_v;
+
+      while ( (int) curr.size() < features_i )
+      {
+         C3DVector p ( rng.uniform(-10., 10.),
+                       rng.uniform(-3., 3.),
+                       rng.uniform(3., 40.) );
+
+         C3DVector proj;
+         if ( !camera.local2Image ( rotation * p + translation, proj ) )
+            continue;
+
+         SFeature feat;
+         feat.u = proj.x() + rng.gaussian(noise_d);
+         feat.v = proj.y() + rng.gaussian(noise_d);
+         feat.d = proj.z() + rng.gaussian(noise_d);
+         feat.state = SFeature::FS_TRACKED;
+
+         curr.push_back     ( feat );
+         prev3D_v.push_back ( p );
+         weight_v.push_back ( 1. );
+      }
+
+      CStereoEgoMotionCost cost ( camera, curr, prev3D_v, weight_v );
+      double gradient_p[6], hesse_p[36];
+
+      /// Newton with numerical derivatives (steps as in CStereoEgoMotionOp).
+      {
+         double x_p[6] = { 0, 0, 0, 0, 0, 0 };
+         double steps_p[6] = { 0.0015, 0.0015, 0.0015, 0.01, 0.01, 0.01 };
+         NumericalSolver::SSolverStatistics stats;
+
+         newtonClock.start();
+         double res_d = NumericalSolver::solveByNewton ( x_p, gradient_p, hesse_p,
+                                                         steps_p, 6, 6,
+                                                         maxIters_i, tolerance_d,
+                                                         cost, &stats );
+         newtonClock.stop();
+
+         newton.iterations_i  += stats.iterations_i;
+         newton.evaluations_i += stats.evaluations_i;
+         newton.residuum_d    += res_d;
+         newton.error_d       += stateError ( x_p, truth_p );
+      }
+
+      /// Levenberg-Marquardt with analytic Jacobian.
+      {
+         double x_p[6] = { 0, 0, 0, 0, 0, 0 };
+         NumericalSolver::SSolverStatistics stats;
+
+         lmClock.start();
+         double res_d = NumericalSolver::solveByLevenbergMarquardt ( x_p, gradient_p, hesse_p,
+                                                                     6, 6,
+                                                                     maxIters_i, tolerance_d,
+                                                                     cost, &stats );
+         lmClock.stop();
+
+         lm.iterations_i  += stats.iterations_i;
+         lm.evaluations_i += stats.evaluations_i;
+         lm.residuum_d    += res_d;
+         lm.error_d       += stateError ( x_p, truth_p );
+      }
+   }
+
+   printf("%i features, %i trials, noise %f px (averages per trial)\n\n", 
+          features_i, trials_i, noise_d );
+   printf("%-22s %10s %12s %12s %12s %14s\n",
+          "Solver", "Iterations", "Evaluations", "Time [ms]", "Residuum", "Motion error");
+   print ( "Newton (numerical)",     newton, newtonClock, trials_i );
+   print ( "LM (analytic Jacobian)", lm,     lmClock,     trials_i );
+
+   return 0;
+}
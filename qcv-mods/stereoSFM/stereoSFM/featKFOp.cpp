@@ -67,7 +67,7 @@ CFeatureKFOp::CFeatureKFOp ( COperator * const f_parent_p )
      m_egoMInpId_str (          "Ego-Motion Estimation" ),
      m_initialized_b (                            false ),
      m_kfCommon (                                       ),
-     m_kfVector (                                       ),
+     m_kfBank (                                         ),
           
      m_maxNoMeasCount_i (                             2 ),
 
@@ -79,6 +79,8 @@ CFeatureKFOp::CFeatureKFOp ( COperator * const f_parent_p )
 {
    addChild ( new  CFeatureKFDisplayOp        ( this ) );
 
+   m_kfBank.setCommonData ( &m_kfCommon );
+
    /// Some default values.
    registerDrawingLists();
    registerParameters();
@@ -207,37 +209,6 @@ CFeatureKFOp::~CFeatureKFOp ()
 }
 
                            
-/// Cycle event.
-C3DVector CFeatureKFOp::getClosestSpeed( const SFeature       &f_feat,
-                                         const CFeatureVector &f_featVector_v  )
-{
-   const float maxFeatDist_f = 20*20;
-   const int   ageTh_i = 3; 
-   float minDist_f = maxFeatDist_f;
-
-   C3DVector p0 ( f_feat.u, f_feat.v, f_feat.d );
-   C3DVector vel ( 0, 0, 0);
-   
-   for (size_t j = 0; j < f_featVector_v.size(); ++j)
-   {
-      int age_i = m_kfVector[j].getAge();
-      
-      if (age_i > ageTh_i)
-      {
-         C3DVector p1 (f_featVector_v[j].u,f_featVector_v[j].v,f_featVector_v[j].d);
-         float dist_f = (p1 - p0).sumOfSquares();
-         if ( dist_f  < maxFeatDist_f &&
-              dist_f < minDist_f )
-         {
-            minDist_f = dist_f;
-            vel = m_kfVector[j].getVelocity();
-         }
-      }
-   }
-
-   return vel;
-}
-
 /// Cycle event.
 bool CFeatureKFOp::cycle()
 {
@@ -257,11 +228,8 @@ bool CFeatureKFOp::cycle()
 
    if ( featVector_p && camera_p && egoMotion_p )
    {
-      if ( m_kfVector.size() != featVector_p->size() )
-      {
-         m_kfVector.resize ( featVector_p->size() );
-         m_kfVector[0].setCommonData( &m_kfCommon );            
-      }
+      if ( m_kfBank.size() != featVector_p->size() )
+         m_kfBank.resize ( featVector_p->size() );
 
       C3DMatrix covVar;
       covVar.diagonalize( m_measVariance );
@@ -278,62 +246,18 @@ bool CFeatureKFOp::cycle()
             
          m_kfCommon.setEnvironmentMotion ( rotation, translation, cycleTime_d );
 
-         for (unsigned int i = 0 ; i < featVector_p->size(); ++i )
-         {
-            if ( m_kfVector[i].getStatus() != CKF3DStereoPoint::KFS_PREDICTED )
-               m_kfVector[i].predict();
-         }
-
-         for (unsigned int i = 0 ; i < featVector_p->size(); ++i )
-         {
-            const SFeature &feat = (*featVector_p)[i];
-
-            if ( feat.state != SFeature::FS_NEW  && 
-                 feat.state != SFeature::FS_TRACKED  )
-            {
-               m_kfVector[i].reset();
-            }
-            else
-            {
-               if ( m_kfVector[i].getAge() <= 0 )
-               {
-                  if ( feat.d > 1.e-3 )
-                  {
-                     C3DVector vel = getClosestSpeed(feat, *featVector_p);
-                     m_kfVector[i].initialize ( feat.u, feat.v, feat.d );
-                  }
-               }
-               else 
-               {
-                  if ( feat.state == SFeature::FS_NEW && feat.d > 1.e-3 )
-                  {
-                     m_kfVector[i].initialize ( feat.u, feat.v, feat.d );
-                  }                    
-                  else
-                  {
-                     bool success_b = false;
-                            
-                     if ( feat.d > 1.e-3 )
-                        success_b = m_kfVector[i].update ( feat.u, feat.v, feat.d );
-                     else
-                     {
-                        if ( m_kfVector[i].getNoMeasurementCount() <= m_maxNoMeasCount_i )
-                           success_b = m_kfVector[i].update ( feat.u, feat.v );
-                     }
-
-                     if ( !success_b )
-                     {
-                        m_kfVector[i].reset();   
-                     }
-                  }
-               }
-            }
-         }
+         startClock("Prediction");
+         m_kfBank.predictAll();
+         stopClock("Prediction");
+
+         startClock("Update");
+         m_kfBank.updateAll ( *featVector_p, m_maxNoMeasCount_i );
+         stopClock("Update");
       }
    }
     
    /// Set output.
-   registerOutput ( "KF 3D Stereo Point Vector",       &m_kfVector );
+   registerOutput ( "KF 3D Stereo Point Bank",         &m_kfBank );
    registerOutput ( "KF 3D Stereo Point Common Data",  &m_kfCommon );
 
    return COperator::cycle();
@@ -350,7 +274,7 @@ bool CFeatureKFOp::show()
 bool CFeatureKFOp::initialize()
 {
    /// Set output.
-   registerOutput ( "KF 3D Stereo Point Vector",       &m_kfVector );
+   registerOutput ( "KF 3D Stereo Point Bank",         &m_kfBank );
    registerOutput ( "KF 3D Stereo Point Common Data",  &m_kfCommon );
 
    return COperator::initialize();
@@ -54,8 +54,7 @@ Hernan Badino and Takeo Kanade. A Head-Wearable Short-Baseline Stereo System for
 #include "feature.h"
 
 #include "kf3DStereoPointCommon.h"
-#include "kf3DStereoPointVector.h"
-#include "kf3DStereoPoint.h"
+#include "kf3DStereoPointBank.h"
 
 /* PROTOTYPES */
 
@@ -118,8 +117,6 @@ namespace QCV
 
       void registerDrawingLists();
       void registerParameters();
-      C3DVector getClosestSpeed(const SFeature       &f_feat ,
-                                const CFeatureVector &f_featVector_v );
         
    private:
         
@@ -138,8 +135,8 @@ namespace QCV
       /// Common data structures for the kalman filter.
       CKF3DStereoPointCommon         m_kfCommon;
 
-      /// Common data structures for the kalman filter.
-      CKF3DStereoPointVector         m_kfVector;        
+      /// Kalman filters, one per feature.
+      CKF3DStereoPointBank           m_kfBank;        
 
       /// Maximum no measurement count.
       int                            m_maxNoMeasCount_i;
@@ -44,6 +44,8 @@ Hernan Badino and Takeo Kanade. A Head-Wearable Short-Baseline Stereo System for
 
 /* INCLUDES */
 
+#include <QtGui/QMouseEvent>
+
 #include "featVisKFOp.h"
 #include "drawingList.h"
 #include "stereoCamera.h"
@@ -51,10 +53,10 @@ Hernan Badino and Takeo Kanade. A Head-Wearable Short-Baseline Stereo System for
 #include "rigidMotion.h"
 
 #ifdef HAVE_QGLVIEWER
-#include "glViewer.h"
+#include "3DViewerBase.h"
 #endif
 
-#include "kf3DStereoPointVector.h"
+#include "kf3DStereoPointBank.h"
 #include "ceParameter.h"
 
 using namespace QCV;
@@ -474,27 +476,34 @@ bool CFeatureKFDisplayOp::cycle()
 
    if (egoMotion_p)
    {
-      C3DVector translation = egoMotion_p->translation;       
-      C3DMatrix rotation = egoMotion_p->rotation;
-        
+      /// The motion is applied to the positions when they are
+      /// displayed (see updateEgoPositions). A new position receives 
+      /// the motions from this one on.
       if ( m_egoPositions.size() <= imgNr_ui )
+      {
          m_egoPositions.push_back(C3DVector(0,0,0));
+         m_egoFirstMotion_v.push_back(m_egoMotions_v.size());
+      }
       else
+      {
          m_egoPositions[imgNr_ui].clear();
+         m_egoFirstMotion_v[imgNr_ui] = m_egoMotions_v.size();
+      }
 
-      for (unsigned int i = 0; i < m_egoPositions.size(); ++i)
-      {
-         m_egoPositions[i] = rotation * m_egoPositions[i] + translation;
-      } 
+      m_egoMotions_v.push_back(*egoMotion_p);
+
+      /// Bound the pending motions if the positions are not displayed.
+      if ( m_egoMotions_v.size() >= (unsigned int) m_maxEgoPositions_i )
+         updateEgoPositions();
    }
 
-   CKF3DStereoPointVector * pvector_p = getInput<CKF3DStereoPointVector>( "KF 3D Stereo Point Vector" );
+   CKF3DStereoPointBank * pbank_p = getInput<CKF3DStereoPointBank>( "KF 3D Stereo Point Bank" );
 
-   if ( pvector_p && 
+   if ( pbank_p && 
         m_selIdx_i >= 0 && 
-        m_selIdx_i < (signed) (*pvector_p).size() &&
-        (*pvector_p)[m_selIdx_i].getAge() > 0)
-      printTrackedPoint(m_selIdx_i, (*pvector_p)[m_selIdx_i]);
+        m_selIdx_i < (signed) pbank_p->size() &&
+        pbank_p->getAge(m_selIdx_i) > 0)
+      printTrackedPoint(m_selIdx_i, *pbank_p);
    else
       m_selIdx_i = -1;
     
@@ -510,7 +519,7 @@ bool CFeatureKFDisplayOp::show()
       const float scrHeight_f = getScreenSize().height;
 
       /// Obtain input data
-      CKF3DStereoPointVector * pvector_p = getInput<CKF3DStereoPointVector>( "KF 3D Stereo Point Vector" );
+      CKF3DStereoPointBank * pbank_p = getInput<CKF3DStereoPointBank>( "KF 3D Stereo Point Bank" );
 
       CStereoCamera * camera_p = getInput<CStereoCamera> ( "Rectified Camera" );
 
@@ -521,9 +530,9 @@ bool CFeatureKFDisplayOp::show()
         
       CDrawingList *list_p;    
 
-      if ( camera_p && pvector_p && imgL_p )
+      if ( camera_p && pbank_p && imgL_p )
       {
-         CKF3DStereoPointVector &kfVector = *pvector_p;
+         CKF3DStereoPointBank &kfBank = *pbank_p;
 
          float scaleFactor_f = scrWidth_f/imgL_p->cols;
 
@@ -563,21 +572,21 @@ bool CFeatureKFDisplayOp::show()
                float sqMinSpeed_f     = m_3dVisMinFeatSpeed_f*m_3dVisMinFeatSpeed_f;
                
                list_p -> addImage ( *imgs_p[view_i], 0, 0, scrWidth_f, scrHeight_f );
-               for (unsigned int i = 0 ; i < kfVector.size(); ++i )
+               for (unsigned int i = 0 ; i < kfBank.size(); ++i )
                {                    
                   C3DVector pos, vel, p1, p2;
-                  kfVector[i].getCurrentState ( pos, vel );
+                  kfBank.getCurrentState ( i, pos, vel );
 
                   if ( view_i == 1 ) pos.at(0) -= camera_p -> getBaseline();
 
                   double pspeed_d = vel.sumOfSquares();
 
                   double nis_d;
-                  nis_d = kfVector[i].getNIS();
+                  nis_d = kfBank.getNIS(i);
 
                   if (0)
                      printf("%i >= %i - %f >= %f - %f <= %f - %f >= %f - %f <= %f - %f >= %f - %f <= %f - %f <= %f\n",
-                            kfVector[i].getAge() , m_minAge_i ,
+                            kfBank.getAge(i) , m_minAge_i ,
                             fabs(vel.z()) , m_velZRange.min , 
                             fabs(vel.z()) , m_velZRange.max , 
                             fabs(vel.x()) , m_velXRange.min , 
@@ -586,7 +595,7 @@ bool CFeatureKFDisplayOp::show()
                             fabs(vel.y()) , m_velYRange.max ,
                             nis_d , m_maxNis_d );
                         
-                  if ( kfVector[i].getAge() >= m_minAge_i &&
+                  if ( kfBank.getAge(i) >= m_minAge_i &&
                        fabs(vel.z()) >= m_velZRange.min && 
                        fabs(vel.z()) <= m_velZRange.max && 
                        fabs(vel.x()) >= m_velXRange.min && 
@@ -594,7 +603,7 @@ bool CFeatureKFDisplayOp::show()
                        fabs(vel.y()) >= m_velYRange.min && 
                        fabs(vel.y()) <= m_velYRange.max &&
                        nis_d <= m_maxNis_d &&
-                       kfVector[i].getNoMeasurementCount() == 0 &&
+                       kfBank.getNoMeasurementCount(i) == 0 &&
                        pspeed_d >= sqMinSpeed_f )
                   {
                      camera_p -> local2Image ( pos, p1 );
@@ -628,7 +637,7 @@ bool CFeatureKFDisplayOp::show()
                               C3DMatrix cov;
                               double val_d = 0;
                             
-                              kfVector[i].getPositionCovMatrix ( cov );
+                              kfBank.getPositionCovMatrix ( i, cov );
 
                               if ( m_colorEncMode_e == CEM_POSVARIANCE )
                                  val_d = cov.trace()/3.;
@@ -646,7 +655,7 @@ bool CFeatureKFDisplayOp::show()
                               C3DMatrix cov;
                               double val_d = 0;
                             
-                              kfVector[i].getVelocityCovMatrix ( cov );
+                              kfBank.getVelocityCovMatrix ( i, cov );
 
                               if ( m_colorEncMode_e == CEM_VELVARIANCE )
                                  val_d = cov.trace()/3.;
@@ -778,14 +787,14 @@ void CFeatureKFDisplayOp::show3D()
    SRigidMotion *egoMotion_p = getInput<SRigidMotion> ( m_egoMInpId_str );
 
    /// Obtain input data.
-   CKF3DStereoPointVector * pvector_p =  getInput<CKF3DStereoPointVector> ( "KF 3D Stereo Point Vector" );
+   CKF3DStereoPointBank * pbank_p =  getInput<CKF3DStereoPointBank> ( "KF 3D Stereo Point Bank" );
 
-   if ( pvector_p && 
+   if ( pbank_p && 
         egoMotion_p )
    {
-      int maxPoints_i = std::max(m_3dVisMaxPoints_i, (int)pvector_p->size());
+      int maxPoints_i = std::max(m_3dVisMaxPoints_i, (int)pbank_p->size());
 
-      CKF3DStereoPointVector &kfVector = *pvector_p;
+      CKF3DStereoPointBank &kfBank = *pbank_p;
 
       if (maxPoints_i != (int)m_3dVisDataVector_v.size())
       {
@@ -799,7 +808,7 @@ void CFeatureKFDisplayOp::show3D()
          m_3dVisColorVector_v.resize(maxPoints_i, color);
       }
         
-      if ( m_3dVisFeatMap_v.size() != kfVector.size() )
+      if ( m_3dVisFeatMap_v.size() != kfBank.size() )
       {
          m_3dVisFeatMap_v.resize( maxPoints_i, -1 );
       }
@@ -813,13 +822,13 @@ void CFeatureKFDisplayOp::show3D()
 
       if ( 1 ) // Accumulate 3D points
       {       
-         for (unsigned int i = 0 ; i < kfVector.size(); ++i )
+         for (unsigned int i = 0 ; i < kfBank.size(); ++i )
          {
             C3DVector pos, vel;
             
-            kfVector[i].getCurrentState(pos, vel);
+            kfBank.getCurrentState ( i, pos, vel );
             
-            if ( kfVector[i].getAge() >= m_3dVisMinAge_i && 
+            if ( kfBank.getAge(i) >= m_3dVisMinAge_i && 
                  pos.z() <= m_3dVisMaxDist_f )
             {
                if ( m_3dVisFeatMap_v[i] == -1 )
@@ -878,13 +887,13 @@ void CFeatureKFDisplayOp::show3D()
          m_3dVisCurrIdx_i = 0;
          m_3dVisTotalPoints_i = 0;
             
-         for (unsigned int i = 0 ; i < kfVector.size(); ++i )
+         for (unsigned int i = 0 ; i < kfBank.size(); ++i )
          {
             C3DVector pos, vel;
             
-            kfVector[i].getCurrentState(pos, vel);
+            kfBank.getCurrentState ( i, pos, vel );
 
-            if ( kfVector[i].getAge() >= m_3dVisMinAge_i && 
+            if ( kfBank.getAge(i) >= m_3dVisMinAge_i && 
                  pos.z() <= m_3dVisMaxDist_f &&
                  vel.z() < m_3dVisMaxVel_f )
             {
@@ -971,6 +980,8 @@ void CFeatureKFDisplayOp::show3D()
          }
       }
         
+      updateEgoPositions();
+
       m_3dCeCount.setMaximum ( m_egoPositions.size() );
       m_3dViewer_p -> setPointSize ( m_3dEgoPosPointSize_f );
 
@@ -988,6 +999,28 @@ void CFeatureKFDisplayOp::show3D()
 #endif
 }
 
+/// Apply the pending ego-motions to the ego-positions. Every position
+/// receives the motions one after the other as if it had been updated 
+/// in every cycle, so that the result is the same.
+void CFeatureKFDisplayOp::updateEgoPositions()
+{
+   if ( m_egoMotions_v.empty() )
+      return;
+
+   for (unsigned int i = 0; i < m_egoPositions.size(); ++i)
+   {
+      C3DVector p = m_egoPositions[i];
+
+      for (unsigned int j = m_egoFirstMotion_v[i]; j < m_egoMotions_v.size(); ++j)
+         p = m_egoMotions_v[j].rotation * p + m_egoMotions_v[j].translation;
+
+      m_egoPositions[i]     = p;
+      m_egoFirstMotion_v[i] = 0;
+   }
+
+   m_egoMotions_v.clear();
+}
+
 /// Init event.
 bool
 CFeatureKFDisplayOp::initialize()
@@ -1000,6 +1033,8 @@ CFeatureKFDisplayOp::initialize()
    m_3dVisColorVector_v.resize(0);
    m_3dVisColorVector_v.resize(m_3dVisMaxPoints_i, color);
    m_egoPositions.resize(0);
+   m_egoFirstMotion_v.resize(0);
+   m_egoMotions_v.resize(0);
 
    m_3dVisCurrIdx_i = 0;
    m_3dVisTotalPoints_i = 0;
@@ -1041,13 +1076,13 @@ CFeatureKFDisplayOp::mousePressed ( CMouseEvent * f_event_p )
       if ( list_p-> getPosition() == f_event_p -> displayScreen )
       {
          /// Obtain input data.
-         CKF3DStereoPointVector * pvector_p =  getInput<CKF3DStereoPointVector>("KF 3D Stereo Point Vector");
+         CKF3DStereoPointBank * pbank_p =  getInput<CKF3DStereoPointBank>("KF 3D Stereo Point Bank");
     
          CStereoCamera *     camera_p = getInput<CStereoCamera>("Rectified Camera" );
 
          cv::Mat * imgL_p = getInput<cv::Mat>("Image 0" );
     
-         if ( camera_p && pvector_p )
+         if ( camera_p && pbank_p )
          {
             float scaleX_f = getScreenSize().width / (float)imgL_p->cols;
             float scaleY_f = getScreenSize().height / (float)imgL_p->rows;
@@ -1058,7 +1093,7 @@ CFeatureKFDisplayOp::mousePressed ( CMouseEvent * f_event_p )
             printf("Mouse pressed at %f %f\n",
                    mPos.x(), mPos.y());
         
-            CKF3DStereoPointVector &kfVector = *pvector_p;
+            CKF3DStereoPointBank &kfBank = *pbank_p;
         
             //const float scrWidth_f  = getScreenWidth();
             //const float scrHeight_f = getScreenHeight();
@@ -1066,10 +1101,10 @@ CFeatureKFDisplayOp::mousePressed ( CMouseEvent * f_event_p )
             //float scaleFactor_f =  scrWidth_f/imgL_p->cols;
         
             printf("\n\n");
-            for (unsigned int i = 0 ; i < kfVector.size(); ++i )
+            for (unsigned int i = 0 ; i < kfBank.size(); ++i )
             {
                C3DVector pos, vel, p1;
-               kfVector[i].getCurrentState ( pos, vel );
+               kfBank.getCurrentState ( i, pos, vel );
             
                camera_p -> local2Image ( pos, p1 );
                 
@@ -1079,7 +1114,7 @@ CFeatureKFDisplayOp::mousePressed ( CMouseEvent * f_event_p )
                if ( diff.magnitude() < 3 )
                {
                   m_selIdx_i = i;
-                  printTrackedPoint(m_selIdx_i, kfVector[m_selIdx_i]);
+                  printTrackedPoint(m_selIdx_i, kfBank);
                   break;
                }
             }
@@ -1091,13 +1126,13 @@ CFeatureKFDisplayOp::mousePressed ( CMouseEvent * f_event_p )
 }
 
 void CFeatureKFDisplayOp::printTrackedPoint( const int f_idx_i,
-                                             const CKF3DStereoPoint & f_point ) const
+                                             const CKF3DStereoPointBank & f_bank ) const
 {
    double cov_p[36];
    C3DVector pos, vel;
-   f_point.getCurrentState ( pos, vel );
+   f_bank.getCurrentState ( f_idx_i, pos, vel );
 
-   f_point.getCovarianceMatrix (cov_p);
+   f_bank.getCovarianceMatrix ( f_idx_i, cov_p );
 
    printf("------------------------------------\n"
           "Tracked Point %i\n"
@@ -1109,13 +1144,13 @@ void CFeatureKFDisplayOp::printTrackedPoint( const int f_idx_i,
           "  Status: %i\n"
           "  NIS: %f\n",
           f_idx_i,
-          f_point.getAge(),
+          f_bank.getAge(f_idx_i),
           pos.x(), pos.y(), pos.z(), 
           vel.x(), vel.y(), vel.z(),
           cov_p[0], cov_p[7], cov_p[14], cov_p[21], cov_p[28], cov_p[35],
-          f_point.getNoMeasurementCount(),
-          (int)f_point.getStatus (),
-          f_point.getNIS() );
+          f_bank.getNoMeasurementCount(f_idx_i),
+          (int)f_bank.getStatus(f_idx_i),
+          f_bank.getNIS(f_idx_i) );
    
    for (int j = 0; j < 6; ++j)
       printf("|  %10f %10f %10f %10f %10f %10f |\n",
@@ -54,9 +54,10 @@ Hernan Badino and Takeo Kanade. A Head-Wearable Short-Baseline Stereo System for
 #include "feature.h"
 #include "colorEncoding.h"
 #include "3DPointVector.h"
+#include "rigidMotion.h"
 
 #include "kf3DStereoPointCommon.h"
-#include "kf3DStereoPoint.h"
+#include "kf3DStereoPointBank.h"
 
 /* PROTOTYPES */
 
@@ -196,7 +197,8 @@ namespace QCV
       void registerDrawingLists();
       void registerParameters(); 
       void show3D();
-      void printTrackedPoint ( const int f_idx_i, const CKF3DStereoPoint & f_point ) const;
+      void updateEgoPositions();
+      void printTrackedPoint ( const int f_idx_i, const CKF3DStereoPointBank & f_bank ) const;
        
    private:
         
@@ -329,9 +331,16 @@ namespace QCV
       /// Show Anaglyph?
       bool                           m_show3dAnaglyph_b;
 
-      /// Ego-position.
+      /// Ego-positions. They are in the current frame after calling 
+      /// updateEgoPositions.
       C3DPointDataVector             m_egoPositions;
 
+      /// Index of the first pending motion to apply to each ego-position.
+      std::vector<unsigned int>      m_egoFirstMotion_v;
+
+      /// Ego-motions not yet applied to the ego-positions.
+      std::vector<SRigidMotion>      m_egoMotions_v;
+
       /// Max egopositions
       int                            m_maxEgoPositions_i;
 
@@ -0,0 +1,877 @@
+/*
+ * Copyright (C) 2015 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of StereoSFM
+ *
+ * StereoSFM is under the terms of the GNU General Public License v2.
+ * See the GNU GPL version 2.0 for details.
+ * StereoSFM uses dual licensing. Contact the author to get information
+ * for a commercial/proprietary license.
+ *
+ * StereoSFM is distributed "AS IS" without ANY WARRANTY, without even 
+ * the implied warranty of merchantability or fitness for a particular
+ * purpose.
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+/*
+
+This project is an implementation of the method presented in the paper:
+
+Hernan Badino and Takeo Kanade. A Head-Wearable Short-Baseline Stereo System for the Simultaneous Estimation of Structure and Motion. In IAPR Conference on Machine Vision Applications (MVA), Nara, Japan, June 2011.
+*/
+
+/* INCLUDES */
+#include "kf3DStereoPointBank.h"
+
+#if defined ( __AVX2__ )
+#include <immintrin.h>
+#elif defined ( __SSE2__ )
+#include <emmintrin.h>
+#endif
+
+using namespace QCV;
+
+namespace
+{
+   /// The kernels are written once for a generic lane type holding one 
+   /// (SLane1), two (SLane2) or four (SLane4) filters. All lane types 
+   /// perform exactly the same operations in the same order as the 
+   /// scalar implementation of CKF3DStereoPoint.
+
+   struct SLane1
+   {
+      static const int SIZE = 1;
+
+      SLane1 ( ) {}
+      explicit SLane1 ( double f_v_d ) : v ( f_v_d ) {}
+
+      static SLane1 load ( const double * f_p ) { return SLane1 ( *f_p ); }
+      void store ( double * f_p ) const { *f_p = v; }
+
+      /// Returns f_new where *f_mask_p != 0 and f_old elsewhere.
+      static SLane1 select ( const double * f_mask_p, SLane1 f_new, SLane1 f_old )
+      {
+         return *f_mask_p != 0. ? f_new : f_old;
+      }
+
+      double v;
+   };
+
+   inline SLane1 operator + ( SLane1 a, SLane1 b ) { return SLane1 ( a.v + b.v ); }
+   inline SLane1 operator - ( SLane1 a, SLane1 b ) { return SLane1 ( a.v - b.v ); }
+   inline SLane1 operator * ( SLane1 a, SLane1 b ) { return SLane1 ( a.v * b.v ); }
+   inline SLane1 operator / ( SLane1 a, SLane1 b ) { return SLane1 ( a.v / b.v ); }
+   inline SLane1 operator - ( SLane1 a )           { return SLane1 ( -a.v ); }
+
+#if defined ( __AVX2__ )
+   struct SLane4
+   {
+      static const int SIZE = 4;
+
+      SLane4 ( ) {}
+      explicit SLane4 ( double f_v_d ) : v ( _mm256_set1_pd ( f_v_d ) ) {}
+      SLane4 ( __m256d f_v ) : v ( f_v ) {}
+
+      static SLane4 load ( const double * f_p ) { return _mm256_loadu_pd ( f_p ); }
+      void store ( double * f_p ) const { _mm256_storeu_pd ( f_p, v ); }
+
+      static SLane4 select ( const double * f_mask_p, SLane4 f_new, SLane4 f_old )
+      {
+         __m256d mask = _mm256_cmp_pd ( _mm256_loadu_pd ( f_mask_p ), 
+                                        _mm256_setzero_pd(), _CMP_NEQ_OQ );
+         return _mm256_blendv_pd ( f_old.v, f_new.v, mask );
+      }
+
+      __m256d v;
+   };
+
+   inline SLane4 operator + ( SLane4 a, SLane4 b ) { return _mm256_add_pd ( a.v, b.v ); }
+   inline SLane4 operator - ( SLane4 a, SLane4 b ) { return _mm256_sub_pd ( a.v, b.v ); }
+   inline SLane4 operator * ( SLane4 a, SLane4 b ) { return _mm256_mul_pd ( a.v, b.v ); }
+   inline SLane4 operator / ( SLane4 a, SLane4 b ) { return _mm256_div_pd ( a.v, b.v ); }
+   inline SLane4 operator - ( SLane4 a )           { return _mm256_xor_pd ( a.v, _mm256_set1_pd ( -0. ) ); }
+
+   typedef SLane4 SLane_t;
+
+#elif defined ( __SSE2__ )
+   struct SLane2
+   {
+      static const int SIZE = 2;
+
+      SLane2 ( ) {}
+      explicit SLane2 ( double f_v_d ) : v ( _mm_set1_pd ( f_v_d ) ) {}
+      SLane2 ( __m128d f_v ) : v ( f_v ) {}
+
+      static SLane2 load ( const double * f_p ) { return _mm_loadu_pd ( f_p ); }
+      void store ( double * f_p ) const { _mm_storeu_pd ( f_p, v ); }
+
+      static SLane2 select ( const double * f_mask_p, SLane2 f_new, SLane2 f_old )
+      {
+         __m128d mask = _mm_cmpneq_pd ( _mm_loadu_pd ( f_mask_p ), _mm_setzero_pd() );
+         return _mm_or_pd ( _mm_and_pd ( mask, f_new.v ), 
+                            _mm_andnot_pd ( mask, f_old.v ) );
+      }
+
+      __m128d v;
+   };
+
+   inline SLane2 operator + ( SLane2 a, SLane2 b ) { return _mm_add_pd ( a.v, b.v ); }
+   inline SLane2 operator - ( SLane2 a, SLane2 b ) { return _mm_sub_pd ( a.v, b.v ); }
+   inline SLane2 operator * ( SLane2 a, SLane2 b ) { return _mm_mul_pd ( a.v, b.v ); }
+   inline SLane2 operator / ( SLane2 a, SLane2 b ) { return _mm_div_pd ( a.v, b.v ); }
+   inline SLane2 operator - ( SLane2 a )           { return _mm_xor_pd ( a.v, _mm_set1_pd ( -0. ) ); }
+
+   typedef SLane2 SLane_t;
+
+#else
+   typedef SLane1 SLane_t;
+#endif
+
+   const int BS = CKF3DStereoPointBank::BLOCK_SIZE;
+
+   /// C = A * B for 3x3 matrices as in C3DMatrix::operator *.
+   template <class T>
+   inline void mult3x3 ( const T * f_a_p, const T * f_b_p, T * fr_c_p )
+   {
+      for (int i = 0; i < 3; ++i)
+         for (int j = 0; j < 3; ++j)
+            fr_c_p[i*3+j] = ( ( f_a_p[i*3+0] * f_b_p[0*3+j] + 
+                                f_a_p[i*3+1] * f_b_p[1*3+j] ) + 
+                              f_a_p[i*3+2] * f_b_p[2*3+j] );
+   }
+
+   /// Inverse of a 3x3 matrix as in C3DMatrix::getInverse.
+   template <class T>
+   inline void invert3x3 ( const T * f_m_p, T * fr_inv_p )
+   {
+      T aux_p[9];
+
+      for (int i = 0; i < 9; ++i)
+      {
+         aux_p[i]    = f_m_p[i];
+         fr_inv_p[i] = T ( (i%4)?0.:1. );
+      }
+
+      for (int i = 0; i < 3; i++)
+      {
+         T e = aux_p[i*3+i];
+         for (int j = 0; j < 3; j++)
+         {
+            aux_p[i*3+j]    = aux_p[i*3+j] / e;
+            fr_inv_p[i*3+j] = fr_inv_p[i*3+j] / e;
+         }
+        
+         for (int k = 0; k < 3; k++)
+         {
+            if (k != i)
+            {
+               e = -aux_p[k*3+i];
+               for (int j = 0; j < 3; j++)
+               {
+                  aux_p[k*3+j]    = aux_p[k*3+j]    + e * aux_p[i*3+j];
+                  fr_inv_p[k*3+j] = fr_inv_p[k*3+j] + e * fr_inv_p[i*3+j];
+               }
+            }
+         }
+      }
+   }
+
+   /// Prediction of the filters of a block starting at lane f_state_p.
+   /// The element e of the lanes is at f_state_p[e*BS] (f_cov_p[e*BS]).
+   template <class T>
+   void predictLanes ( const double * f_A_p,
+                       const double * f_B_p,
+                       const double * f_Q_p,
+                       double *       fr_state_p,
+                       double *       fr_cov_p,
+                       const double * f_mask_p )
+   {
+      T s_p[6];
+      for (int i = 0; i < 6; ++i)
+         s_p[i] = T::load ( fr_state_p + i*BS );
+
+      for (int i = 0; i < 6; ++i)
+      {
+         T newState = ( ( T(f_A_p[i*6+0]) * s_p[0] + 
+                          T(f_A_p[i*6+1]) * s_p[1] + 
+                          T(f_A_p[i*6+2]) * s_p[2] + 
+                          T(f_A_p[i*6+3]) * s_p[3] + 
+                          T(f_A_p[i*6+4]) * s_p[4] + 
+                          T(f_A_p[i*6+5]) * s_p[5] ) + 
+                        T(f_B_p[i]) );
+
+         T::select ( f_mask_p, newState, s_p[i] ).store ( fr_state_p + i*BS );
+      }
+
+      T c_p[36];
+      for (int i = 0; i < 36; ++i)
+         c_p[i] = T::load ( fr_cov_p + i*BS );
+
+      /// A P
+      T AP_p[36];
+      for (int j = 0; j < 6; ++j)
+         for (int i = 0; i < 6; ++i)
+            AP_p[i*6+j] = ( T(f_A_p[i*6+0]) * c_p[0*6+j] + 
+                            T(f_A_p[i*6+1]) * c_p[1*6+j] + 
+                            T(f_A_p[i*6+2]) * c_p[2*6+j] + 
+                            T(f_A_p[i*6+3]) * c_p[3*6+j] + 
+                            T(f_A_p[i*6+4]) * c_p[4*6+j] + 
+                            T(f_A_p[i*6+5]) * c_p[5*6+j] );
+
+      /// A P A^T + Q
+      for (int i = 0; i < 6; ++i)
+         for (int j = 0; j < 6; ++j)
+         {
+            T APAt = ( AP_p[i*6+0] * T(f_A_p[j*6+0]) + 
+                       AP_p[i*6+1] * T(f_A_p[j*6+1]) + 
+                       AP_p[i*6+2] * T(f_A_p[j*6+2]) +
+                       AP_p[i*6+3] * T(f_A_p[j*6+3]) +
+                       AP_p[i*6+4] * T(f_A_p[j*6+4]) +
+                       AP_p[i*6+5] * T(f_A_p[j*6+5]) );
+
+            T::select ( f_mask_p, 
+                        APAt + T(f_Q_p[i*6+j]), 
+                        c_p[i*6+j] ).store ( fr_cov_p + (i*6+j)*BS );
+         }
+   }
+
+   /// Scalar data needed by the update of the filters.
+   struct SUpdateData
+   {
+      double    fu_d;
+      double    fv_d;
+      double    u0_d;
+      double    v0_d;
+      double    Bfu_d;
+      double    R_p[9];
+      bool      checkNSigmaTest_b;
+      int       minAge4NSigmaTest_i;
+      double    maxSqNSigma_d;
+      double    nisAlpha_d;
+   };
+   
+   /// Update of the filters of a block starting at lane f_state_p (see
+   /// CKF3DStereoPoint::updateFilter). f_age_p and fr_nis_p point to 
+   /// the first filter of the lanes. fr_update_p is the update mask 
+   /// and is cleared for the filters failing the N sigma test.
+   template <class T>
+   void updateLanes ( const SUpdateData & f_data,
+                      const int *         f_age_p,
+                      double *            fr_nis_p,
+                      double *            fr_state_p,
+                      double *            fr_cov_p,
+                      const double *      f_meas_p,
+                      double *            fr_update_p )
+   {
+      T s_p[6];
+      for (int i = 0; i < 6; ++i)
+         s_p[i] = T::load ( fr_state_p + i*BS );
+
+      /// Error vector v = z - h(x).
+      T hx_p[3];
+      hx_p[0] = s_p[0] / s_p[2] * T(f_data.fu_d) + T(f_data.u0_d);
+      hx_p[1] = T(f_data.v0_d) - s_p[1] / s_p[2] * T(f_data.fv_d);
+      hx_p[2] = T(f_data.Bfu_d) / s_p[2];
+
+      T v_p[3];
+      for (int i = 0; i < 3; ++i)
+         v_p[i] = T::load ( f_meas_p + i*BS ) - hx_p[i];
+
+      /// F = H P H^T + R
+      const T zero ( 0. );
+      T Z2 = s_p[2] * s_p[2];
+      T H_p[9], Ht_p[9];
+
+      H_p[0] = T(f_data.fu_d) / s_p[2];
+      H_p[1] = zero;
+      H_p[2] = T(-f_data.fu_d) * s_p[0] / Z2;
+      H_p[3] = zero;
+      H_p[4] = T(-f_data.fv_d) / s_p[2];
+      H_p[5] = T(f_data.fv_d) * s_p[1] / Z2;
+      H_p[6] = zero;
+      H_p[7] = zero;
+      H_p[8] = T(-f_data.Bfu_d) / Z2;
+
+      for (int i = 0; i < 3; ++i)
+         for (int j = 0; j < 3; ++j)
+            Ht_p[i*3+j] = H_p[j*3+i];
+
+      T c_p[36];
+      for (int i = 0; i < 36; ++i)
+         c_p[i] = T::load ( fr_cov_p + i*BS );
+
+      T P_p[9];
+      P_p[0] = c_p[0*6+0];
+      P_p[1] = P_p[3] = c_p[0*6+1];
+      P_p[2] = P_p[6] = c_p[0*6+2];
+      P_p[4] = c_p[1*6+1];
+      P_p[5] = P_p[7] = c_p[1*6+2];
+      P_p[8] = c_p[2*6+2];
+
+      T HP_p[9], F_p[9], FInv_p[9];
+      mult3x3 ( H_p, P_p, HP_p );
+      mult3x3 ( HP_p, Ht_p, F_p );
+      for (int i = 0; i < 9; ++i)
+         F_p[i] = F_p[i] + T(f_data.R_p[i]);
+
+      invert3x3 ( F_p, FInv_p );
+
+      /// N sigma test with v^T F^-1 v.
+      T FInvV_p[3];
+      for (int i = 0; i < 3; ++i)
+         FInvV_p[i] = ( FInv_p[i*3+0] * v_p[0] + 
+                        FInv_p[i*3+1] * v_p[1] ) + FInv_p[i*3+2] * v_p[2];
+
+      double mahalanobis_p[T::SIZE];
+      ( v_p[0] * FInvV_p[0] + 
+        v_p[1] * FInvV_p[1] + 
+        v_p[2] * FInvV_p[2] ).store ( mahalanobis_p );
+
+      bool any_b = false;
+
+      for (int l = 0; l < T::SIZE; ++l)
+      {
+         if ( fr_update_p[l] == 0. )
+            continue;
+
+         const int    age_i         = f_age_p[l];
+         const double mahalanobis_d = mahalanobis_p[l];
+         double &     nis_d         = fr_nis_p[l];
+
+         if ( f_data.checkNSigmaTest_b && 
+              age_i >= f_data.minAge4NSigmaTest_i &&
+              mahalanobis_d > f_data.maxSqNSigma_d )
+         {
+            fr_update_p[l] = 0.;
+            continue;
+         }
+
+         if ( age_i == 2 )
+            nis_d = mahalanobis_d;
+         else if ( age_i < f_data.minAge4NSigmaTest_i )
+            nis_d = (nis_d * (age_i-1) + mahalanobis_d)/age_i;
+         else
+            nis_d = ( ( nis_d         * f_data.nisAlpha_d) + 
+                      ( mahalanobis_d * (1.-f_data.nisAlpha_d) ) );
+
+         any_b = true;
+      }
+
+      if ( !any_b )
+         return;
+
+      /// K = P (H^T F^-1)
+      T HtFInv_p[9];
+      mult3x3 ( Ht_p, FInv_p, HtFInv_p );
+
+      T K_p[18];
+      for (int i = 0; i < 6; ++i)
+         for (int j = 0; j < 3; ++j)
+            K_p[i*3+j] = ( c_p[i*6+0] * HtFInv_p[0*3+j] + 
+                           c_p[i*6+1] * HtFInv_p[1*3+j] + 
+                           c_p[i*6+2] * HtFInv_p[2*3+j] );
+
+      /// x_k = x'_k + K (z_k - h(x'_k))
+      for (int i = 0; i < 6; ++i)
+      {
+         T newState = s_p[i] + ( K_p[i*3+0] * v_p[0] + 
+                                 K_p[i*3+1] * v_p[1] + 
+                                 K_p[i*3+2] * v_p[2] );
+
+         T::select ( fr_update_p, newState, s_p[i] ).store ( fr_state_p + i*BS );
+      }
+
+      /// P_k = (I - K H) P. Only the left 6x3 block of (I - K H) 
+      /// differs from the identity.
+      T IKH_p[18];
+      for (int i = 0; i < 6; ++i)
+      {
+         IKH_p[i*3+0] = -K_p[i*3+0] * H_p[0*3+0];
+         IKH_p[i*3+1] = -K_p[i*3+1] * H_p[1*3+1];
+         IKH_p[i*3+2] = -( K_p[i*3+0] * H_p[0*3+2] + 
+                           K_p[i*3+1] * H_p[1*3+2] + 
+                           K_p[i*3+2] * H_p[2*3+2] );
+      }
+
+      for (int i = 0; i < 3; ++i)
+         IKH_p[i*3+i] = T(1.) + IKH_p[i*3+i];
+
+      /// Lower triangle and diagonal, copied to the upper triangle.
+      for (int j = 0; j < 6; ++j)
+      {
+         for (int i = j; i < 6; ++i)
+         {
+            T newCov = ( IKH_p[i*3+0] * c_p[0*6+j] + 
+                         IKH_p[i*3+1] * c_p[1*6+j] + 
+                         IKH_p[i*3+2] * c_p[2*6+j] );
+
+            if ( i >= 3 )
+               newCov = newCov + c_p[i*6+j];
+
+            newCov = T::select ( fr_update_p, newCov, c_p[i*6+j] );
+
+            newCov.store ( fr_cov_p + (i*6+j)*BS );
+
+            if ( i != j )
+               newCov.store ( fr_cov_p + (j*6+i)*BS );
+         }
+      }
+   }
+}
+
+CKF3DStereoPointBank::CKF3DStereoPointBank ( )
+   : m_state_v (                    ),
+     m_cov_v (                      ),
+     m_age_v (                      ),
+     m_noMeasCount_v (              ),
+     m_nis_v (                      ),
+     m_status_v (                   ),
+     m_commonData_p (          NULL )
+{
+}
+
+CKF3DStereoPointBank::~CKF3DStereoPointBank ( )
+{
+}
+
+void
+CKF3DStereoPointBank::resize ( size_t f_size )
+{
+   const size_t prevSize = size();
+   const size_t blocks   = (f_size + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+   m_state_v.resize       ( blocks * 6  * BLOCK_SIZE, 0. );
+   m_cov_v.resize         ( blocks * 36 * BLOCK_SIZE, 0. );
+   m_age_v.resize         ( f_size, -1 );
+   m_noMeasCount_v.resize ( f_size,  0 );
+   m_nis_v.resize         ( f_size,  0. );
+   m_status_v.resize      ( f_size, CKF3DStereoPoint::KFS_UNINITIALIZED );
+
+   /// Lanes of a partial block might contain old data.
+   for (size_t i = prevSize; i < f_size; ++i)
+   {
+      for (int e = 0; e < 6; ++e)
+         state(i, e) = 0.;
+
+      for (int e = 0; e < 36; ++e)
+         cov(i, e) = 0.;
+   }
+}
+
+/// Initialize with new measurement
+bool
+CKF3DStereoPointBank::initialize  ( size_t f_idx,
+                                    float  f_u_f, 
+                                    float  f_v_f,
+                                    float  f_d_f )
+{
+   if ( !m_commonData_p ) return false;
+
+   return initializeFilter( f_idx,
+                            f_u_f, f_v_f, f_d_f,
+                            m_commonData_p->m_R );
+}
+
+/// Initialize with new measurement and covariance matrix
+bool
+CKF3DStereoPointBank::initialize  ( size_t f_idx,
+                                    float  f_u_f, 
+                                    float  f_v_f,
+                                    float  f_d_f,
+                                    const C3DMatrix &f_covMatrix )
+{
+   return initializeFilter( f_idx,
+                            f_u_f, f_v_f, f_d_f,
+                            f_covMatrix );
+}
+
+/// Initialize with measurement and covariance matrix (see 
+/// CKF3DStereoPoint::initializeFilter).
+bool
+CKF3DStereoPointBank::initializeFilter  ( size_t           f_idx,
+                                          float            f_u_f, 
+                                          float            f_v_f,
+                                          float            f_d_f,
+                                          const C3DMatrix &f_R )
+{
+   if ( !m_commonData_p ) return false;
+
+   double x_d, y_d, z_d;
+    
+   /// Initialize state: position first.
+   m_commonData_p -> m_camera.image2Local ( f_u_f,
+                                            f_v_f,
+                                            f_d_f,
+                                            x_d, y_d, z_d );
+
+   state(f_idx, 0) = x_d;
+   state(f_idx, 1) = y_d;
+   state(f_idx, 2) = z_d;
+
+   /// velocity now.
+   state(f_idx, 3) = 0.;
+   state(f_idx, 4) = 0.;
+   state(f_idx, 5) = 0.;
+
+   for (int e = 0; e < 36; ++e)
+      cov(f_idx, e) = 0.;
+
+   /// Initialize covariance: position first
+   /// Equation is G R G^T with G partial derivatives of triangulation equation and R
+   /// covariance matrix of measurement.
+   double d2_d = (double) f_d_f * f_d_f;
+    
+   C3DMatrix G;
+
+   G.at(0,0) = m_commonData_p->m_B_d / f_d_f;
+   G.at(0,1) = 0;
+   G.at(0,2) = -f_u_f * m_commonData_p->m_B_d / d2_d;
+   G.at(1,0) = 0;
+   G.at(1,1) = -m_commonData_p->m_Bsvu_d / f_d_f;
+   G.at(1,2) = +f_v_f * m_commonData_p->m_Bsvu_d / d2_d;
+   G.at(2,0) = 0;
+   G.at(2,1) = 0;
+   G.at(2,2) = -m_commonData_p->m_Bfu_d / d2_d;
+
+   C3DMatrix Gt = G.getTranspose();
+    
+   C3DMatrix covMatPos = G * f_R * Gt;
+
+   for (int i = 0; i < 3; ++i)
+      for (int j = 0; j < 3; ++j)
+         cov(f_idx, i*6+j) = covMatPos.at(i,j);
+
+   /// velocity now.
+   cov(f_idx, 3*6+3) = m_commonData_p -> m_iniVarVelX_d;
+   cov(f_idx, 4*6+4) = m_commonData_p -> m_iniVarVelY_d;
+   cov(f_idx, 5*6+5) = m_commonData_p -> m_iniVarVelZ_d;
+
+   m_age_v[f_idx]         = 1;
+   m_noMeasCount_v[f_idx] = 0;
+   m_status_v[f_idx]      = CKF3DStereoPoint::KFS_INITIALIED;
+    
+   return true;
+}
+
+/// Reset filter.
+bool
+CKF3DStereoPointBank::reset ( size_t f_idx )
+{
+   for (int e = 0; e < 6; ++e)
+      state(f_idx, e) = 0.;
+
+   for (int e = 0; e < 36; ++e)
+      cov(f_idx, e) = 0.;
+
+   m_age_v[f_idx]    = -1;
+   m_status_v[f_idx] = CKF3DStereoPoint::KFS_UNINITIALIZED;
+
+   return true;
+}
+
+/// Predict all filters.
+bool
+CKF3DStereoPointBank::predictAll ( )
+{
+   if ( !m_commonData_p )
+      return false;
+
+   const int blocks_i = (int) ( (size() + BLOCK_SIZE - 1) / BLOCK_SIZE );
+
+   const double * A_p = m_commonData_p -> m_A_p;
+   const double * B_p = m_commonData_p -> m_B_p;
+   const double * Q_p = m_commonData_p -> m_Q_p;
+
+#pragma omp parallel for schedule(static) if (blocks_i > 64)
+   for (int b = 0; b < blocks_i; ++b)
+   {
+      const size_t first = (size_t) b * BLOCK_SIZE;
+      double mask_p[BLOCK_SIZE];
+      bool   any_b = false;
+
+      for (int l = 0; l < BLOCK_SIZE; ++l)
+      {
+         const size_t i = first + l;
+
+         mask_p[l] = ( i < size() && 
+                       m_age_v[i] > 0 && 
+                       m_status_v[i] != CKF3DStereoPoint::KFS_PREDICTED ) ? 1. : 0.;
+
+         if ( mask_p[l] != 0. )
+         {
+            m_status_v[i] = CKF3DStereoPoint::KFS_PREDICTED;
+            any_b = true;
+         }
+      }
+
+      if ( !any_b )
+         continue;
+
+      double * state_p = &m_state_v[b * 6  * BLOCK_SIZE];
+      double * cov_p   = &m_cov_v  [b * 36 * BLOCK_SIZE];
+
+      for (int l = 0; l < BLOCK_SIZE; l += SLane_t::SIZE)
+         predictLanes<SLane_t> ( A_p, B_p, Q_p,
+                                 state_p + l, cov_p + l, mask_p + l );
+   }
+
+   return true;
+}
+
+/// Update all filters with the corresponding features.
+bool
+CKF3DStereoPointBank::updateAll ( const CFeatureVector & f_features,
+                                  int                    f_maxNoMeasCount_i )
+{
+   if ( !m_commonData_p || f_features.size() != size() )
+      return false;
+
+   const int blocks_i = (int) ( (size() + BLOCK_SIZE - 1) / BLOCK_SIZE );
+
+#pragma omp parallel for schedule(static) if (blocks_i > 64)
+   for (int b = 0; b < blocks_i; ++b)
+   {
+      const size_t first = (size_t) b * BLOCK_SIZE;
+      double meas_p[3 * BLOCK_SIZE];
+      double update_p[BLOCK_SIZE];
+      bool   updated_p[BLOCK_SIZE];
+      bool   any_b = false;
+
+      memset ( meas_p, 0, sizeof(meas_p) );
+
+      /// Same decisions as the per filter loop of CFeatureKFOp.
+      for (int l = 0; l < BLOCK_SIZE; ++l)
+      {
+         const size_t i = first + l;
+
+         update_p[l]  = 0.;
+         updated_p[l] = false;
+
+         if ( i >= size() )
+            continue;
+
+         const SFeature &feat = f_features[i];
+
+         /// The filters take single precision measurements.
+         const float u_f = feat.u;
+         const float v_f = feat.v;
+         float       d_f = feat.d;
+         
+         if ( feat.state != SFeature::FS_NEW  && 
+              feat.state != SFeature::FS_TRACKED  )
+         {
+            reset ( i );
+         }
+         else if ( m_age_v[i] <= 0 )
+         {
+            if ( feat.d > 1.e-3 )
+               initialize ( i, u_f, v_f, d_f );
+         }
+         else if ( feat.state == SFeature::FS_NEW && feat.d > 1.e-3 )
+         {
+            initialize ( i, u_f, v_f, d_f );
+         }
+         else
+         {
+            if ( feat.d > 1.e-3 )
+            {
+               m_noMeasCount_v[i] = 0;
+            }
+            else if ( m_noMeasCount_v[i] <= f_maxNoMeasCount_i )
+            {
+               d_f = m_commonData_p->m_Bfu_d / state(i, 2);
+               ++m_noMeasCount_v[i];
+            }
+            else
+            {
+               reset ( i );
+               continue;
+            }
+
+            ++m_age_v[i];
+
+            meas_p[0*BLOCK_SIZE + l] = u_f;
+            meas_p[1*BLOCK_SIZE + l] = v_f;
+            meas_p[2*BLOCK_SIZE + l] = d_f;
+            update_p[l]  = 1.;
+            updated_p[l] = true;
+            any_b = true;
+         }
+      }
+
+      if ( !any_b )
+         continue;
+      
+      updateBlock ( b, meas_p, update_p );
+
+      for (int l = 0; l < BLOCK_SIZE; ++l)
+      {
+         if ( !updated_p[l] )
+            continue;
+
+         if ( update_p[l] != 0. )
+            m_status_v[first + l] = CKF3DStereoPoint::KFS_UPDATED;
+         else
+            reset ( first + l );
+      }
+   }
+
+   return true;
+}
+
+/// Update the filters of a block.
+void
+CKF3DStereoPointBank::updateBlock ( size_t         f_block_i,
+                                    const double * f_meas_p,
+                                    double *       fr_update_p )
+{
+   SUpdateData data;
+
+   data.fu_d                = m_commonData_p -> m_fu_d;
+   data.fv_d                = m_commonData_p -> m_fv_d;
+   data.u0_d                = m_commonData_p -> m_camera.getU0();
+   data.v0_d                = m_commonData_p -> m_camera.getV0();
+   data.Bfu_d               = m_commonData_p -> m_Bfu_d;
+   data.checkNSigmaTest_b   = m_commonData_p -> m_checkNSigmaTest_b;
+   data.minAge4NSigmaTest_i = m_commonData_p -> m_minAge4NSigmaTest_i;
+   data.maxSqNSigma_d       = m_commonData_p -> m_maxSqNSigma_d;
+   data.nisAlpha_d          = m_commonData_p -> m_nisAlpha_d;
+
+   for (int i = 0; i < 9; ++i)
+      data.R_p[i] = m_commonData_p -> m_R.at(i);
+
+   const size_t first   = f_block_i * BLOCK_SIZE;
+   double *     state_p = &m_state_v[f_block_i * 6  * BLOCK_SIZE];
+   double *     cov_p   = &m_cov_v  [f_block_i * 36 * BLOCK_SIZE];
+
+   /// The age and NIS vectors are not padded to full blocks.
+   int    age_p[BLOCK_SIZE];
+   double nis_p[BLOCK_SIZE];
+
+   for (int l = 0; l < BLOCK_SIZE; ++l)
+   {
+      const bool valid_b = first + l < size();
+      age_p[l] = valid_b ? m_age_v[first + l] : 0;
+      nis_p[l] = valid_b ? m_nis_v[first + l] : 0.;
+   }
+
+   for (int l = 0; l < BLOCK_SIZE; l += SLane_t::SIZE)
+      updateLanes<SLane_t> ( data, 
+                             age_p + l, 
+                             nis_p + l, 
+                             state_p + l, 
+                             cov_p + l, 
+                             f_meas_p + l, 
+                             fr_update_p + l );
+
+   for (int l = 0; l < BLOCK_SIZE && first + l < size(); ++l)
+      m_nis_v[first + l] = nis_p[l];
+}
+
+/// Get current state
+void
+CKF3DStereoPointBank::getStateVector ( size_t   f_idx, 
+                                       double * f_state_p ) const
+{
+   for (int e = 0; e < 6; ++e)
+      f_state_p[e] = state(f_idx, e);
+}
+
+/// Get current covariance
+void
+CKF3DStereoPointBank::getCovarianceMatrix  ( size_t   f_idx,
+                                             double * f_covariance_p ) const
+{
+   for (int e = 0; e < 36; ++e)
+      f_covariance_p[e] = cov(f_idx, e);
+}
+
+/// Get current state
+void
+CKF3DStereoPointBank::getCurrentState ( size_t     f_idx,
+                                        C3DVector &fr_pos,
+                                        C3DVector &fr_vel ) const
+{
+   fr_pos.set( state(f_idx, 0), 
+               state(f_idx, 1), 
+               state(f_idx, 2) );
+
+   fr_vel.set( state(f_idx, 3), 
+               state(f_idx, 4), 
+               state(f_idx, 5) );
+}
+
+/// Get current position
+C3DVector
+CKF3DStereoPointBank::getPosition ( size_t f_idx ) const
+{
+   return C3DVector ( state(f_idx, 0),
+                      state(f_idx, 1), 
+                      state(f_idx, 2) );
+}
+
+/// Get current velocity
+C3DVector
+CKF3DStereoPointBank::getVelocity ( size_t f_idx ) const
+{
+   return C3DVector ( state(f_idx, 3),
+                      state(f_idx, 4), 
+                      state(f_idx, 5) );
+}
+
+/// Get predicted measurement.
+C3DVector
+CKF3DStereoPointBank::getPredictedMeasurement ( size_t f_idx ) const
+{
+   C3DVector vec;
+   m_commonData_p->m_camera.local2Image ( state(f_idx, 0),
+                                          state(f_idx, 1),
+                                          state(f_idx, 2),
+                                          vec.at(0),
+                                          vec.at(1),
+                                          vec.at(2) );
+
+   return vec;
+}
+
+/// Get position covariance matrix.
+void
+CKF3DStereoPointBank::getPositionCovMatrix ( size_t     f_idx,
+                                             C3DMatrix &fr_cov ) const
+{
+   fr_cov.at(0,0) = cov(f_idx, 0*6+0);
+   fr_cov.at(0,1) = fr_cov.at(1,0) = cov(f_idx, 0*6+1);
+   fr_cov.at(0,2) = fr_cov.at(2,0) = cov(f_idx, 0*6+2);
+   fr_cov.at(1,1) = cov(f_idx, 1*6+1);
+   fr_cov.at(1,2) = fr_cov.at(2,1) = cov(f_idx, 1*6+2);
+   fr_cov.at(2,2) = cov(f_idx, 2*6+2);
+}
+
+/// Get velocity covariance matrix.
+void
+CKF3DStereoPointBank::getVelocityCovMatrix ( size_t     f_idx,
+                                             C3DMatrix &fr_cov ) const
+{
+   fr_cov.at(0,0) = cov(f_idx, 3*6+3);
+   fr_cov.at(0,1) = fr_cov.at(1,0) = cov(f_idx, 3*6+4);
+   fr_cov.at(0,2) = fr_cov.at(2,0) = cov(f_idx, 3*6+5);
+   fr_cov.at(1,1) = cov(f_idx, 4*6+4);
+   fr_cov.at(1,2) = fr_cov.at(2,1) = cov(f_idx, 4*6+5);
+   fr_cov.at(2,2) = cov(f_idx, 5*6+5);
+}
+
+/// Set common object.
+void
+CKF3DStereoPointBank::setCommonData ( CKF3DStereoPointCommon * f_ptr_p )
+{
+   m_commonData_p = f_ptr_p;
+}
@@ -0,0 +1,230 @@
+/*
+ * Copyright (C) 2015 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of StereoSFM
+ *
+ * StereoSFM is under the terms of the GNU General Public License v2.
+ * See the GNU GPL version 2.0 for details.
+ * StereoSFM uses dual licensing. Contact the author to get information
+ * for a commercial/proprietary license.
+ *
+ * StereoSFM is distributed "AS IS" without ANY WARRANTY, without even 
+ * the implied warranty of merchantability or fitness for a particular
+ * purpose.
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+/*
+
+This project is an implementation of the method presented in the paper:
+
+Hernan Badino and Takeo Kanade. A Head-Wearable Short-Baseline Stereo System for the Simultaneous Estimation of Structure and Motion. In IAPR Conference on Machine Vision Applications (MVA), Nara, Japan, June 2011.
+*/
+
+#ifndef __KF3DSTEREOPOINTBANK_H
+#define __KF3DSTEREOPOINTBANK_H
+
+/*@@@**************************************************************************
+** \file  kf3DStereoPointBank
+* \author Hernan Badino
+* \notes  Bank of CKF3DStereoPoint filters stored as structure of arrays.
+*         The states and covariances are stored in blocks of BLOCK_SIZE 
+*         filters, where the same element of all filters of a block is 
+*         contiguous. predictAll() and updateAll() process the filters of 
+*         a block in parallel (AVX2 or SSE2 lanes) and the blocks in 
+*         parallel with OpenMP. The results are the same as the ones of 
+*         CKF3DStereoPoint.
+*******************************************************************************
+*****          (C) COPYRIGHT Hernan Badino - All Rights Reserved          *****
+******************************************************************************/
+
+/* INCLUDES */
+
+#include <vector>
+
+#include "3DRowVector.h"
+#include "3DMatrix.h"
+#include "feature.h"
+#include "kf3DStereoPoint.h"
+#include "kf3DStereoPointCommon.h"
+
+/* CONSTANTS */
+
+namespace QCV
+{
+    
+   class CKF3DStereoPointBank
+   {
+   /// Public data types
+   public:
+      typedef CKF3DStereoPoint::EKFStatus EKFStatus;
+
+      /// Number of filters per block.
+      static const int BLOCK_SIZE = 4;
+
+   /// Constructors/Destructor
+   public:
+      CKF3DStereoPointBank ( );
+      virtual ~CKF3DStereoPointBank ( );
+
+   /// Size
+   public:
+      /// Set the number of filters. New filters are uninitialized.
+      void   resize ( size_t f_size );
+
+      /// Get the number of filters.
+      size_t size ( ) const { return m_age_v.size(); }
+
+   /// Single filter operations
+   public:
+      /// Initialize filter with new measurement.
+      bool initialize  ( size_t f_idx,
+                         float  f_u_f, 
+                         float  f_v_f,
+                         float  f_d_f );
+
+      /// Initialize filter with new measurement and covariance matrix.
+      bool initialize  ( size_t f_idx,
+                         float  f_u_f, 
+                         float  f_v_f,
+                         float  f_d_f,
+                         const C3DMatrix &f_covMatrix );
+
+      /// Reset filter.
+      bool reset       ( size_t f_idx );
+
+   /// Operations on all filters
+   public:
+      /// Predict all initialized filters not predicted yet.
+      bool predictAll  ( );
+
+      /// Update filter i with feature i. Lost features reset the 
+      /// filter, new features (re)initialize it and tracked features
+      /// update it. Features without disparity update the filter
+      /// with the predicted disparity at most f_maxNoMeasCount_i 
+      /// consecutive times. Filters failing the N sigma test are reset.
+      bool updateAll   ( const CFeatureVector & f_features,
+                         int                    f_maxNoMeasCount_i );
+
+   /// Gets and Sets
+   public:
+      /// Get current state
+      void getStateVector       ( size_t f_idx, 
+                                  double * f_state_p ) const;
+
+      /// Get current covariance
+      void getCovarianceMatrix  ( size_t f_idx, 
+                                  double *f_covariance_p ) const;
+    
+      /// Get current state
+      void getCurrentState      ( size_t f_idx, 
+                                  C3DVector &fr_pos,
+                                  C3DVector &fr_vel ) const;
+        
+      /// Get current position
+      C3DVector getPosition     ( size_t f_idx ) const;
+
+      /// Get current velocity
+      C3DVector getVelocity     ( size_t f_idx ) const;
+
+      /// Get predicted measurement.
+      C3DVector getPredictedMeasurement ( size_t f_idx ) const;
+
+      /// Get position covariance matrix.
+      void getPositionCovMatrix ( size_t f_idx, 
+                                  C3DMatrix &fr_cov ) const;
+
+      /// Get velocity covariance matrix.
+      void getVelocityCovMatrix ( size_t f_idx, 
+                                  C3DMatrix &fr_cov ) const;
+
+      /// Set common object.
+      void setCommonData        ( CKF3DStereoPointCommon * f_ptr_p );
+
+      /// Get Age
+      int getAge ( size_t f_idx ) const { return m_age_v[f_idx]; }
+            
+      /// Get no measurement count
+      int getNoMeasurementCount ( size_t f_idx ) const { return m_noMeasCount_v[f_idx]; }
+
+      /// Get normalized innovation squared
+      double getNIS ( size_t f_idx ) const { return m_nis_v[f_idx]; }
+            
+      /// Get status
+      EKFStatus getStatus ( size_t f_idx ) const { return (EKFStatus) m_status_v[f_idx]; }
+
+   /// Protected methods
+   protected:
+      /// Element f_elem_i of the state of filter f_idx.
+      double & state ( size_t f_idx, int f_elem_i )
+      {
+         return m_state_v[(f_idx/BLOCK_SIZE)*6*BLOCK_SIZE + f_elem_i*BLOCK_SIZE + f_idx%BLOCK_SIZE];
+      }
+
+      double   state ( size_t f_idx, int f_elem_i ) const
+      {
+         return m_state_v[(f_idx/BLOCK_SIZE)*6*BLOCK_SIZE + f_elem_i*BLOCK_SIZE + f_idx%BLOCK_SIZE];
+      }
+
+      /// Element f_elem_i of the covariance matrix of filter f_idx.
+      double & cov ( size_t f_idx, int f_elem_i )
+      {
+         return m_cov_v[(f_idx/BLOCK_SIZE)*36*BLOCK_SIZE + f_elem_i*BLOCK_SIZE + f_idx%BLOCK_SIZE];
+      }
+
+      double   cov ( size_t f_idx, int f_elem_i ) const
+      {
+         return m_cov_v[(f_idx/BLOCK_SIZE)*36*BLOCK_SIZE + f_elem_i*BLOCK_SIZE + f_idx%BLOCK_SIZE];
+      }
+
+      /// The measurement is passed as separate values: GCC 12 SLP 
+      /// drops the float rounding when it is packed in a C3DVector.
+      bool initializeFilter ( size_t           f_idx,
+                              float            f_u_f, 
+                              float            f_v_f,
+                              float            f_d_f,
+                              const C3DMatrix &f_R );
+
+      /// Update the filters of block f_block_i with the given 
+      /// measurements (3 x BLOCK_SIZE). Lanes with f_update_p[l] == 0 
+      /// are not modified. On return f_update_p[l] is 0 for the filters
+      /// that failed the N sigma test.
+      void updateBlock      ( size_t           f_block_i,
+                              const double *   f_meas_p,
+                              double *         fr_update_p );
+
+   /// Protected members.
+   protected:
+      /// States (6 x BLOCK_SIZE per block).
+      std::vector<double>               m_state_v;
+
+      /// Covariance matrices (36 x BLOCK_SIZE per block).
+      std::vector<double>               m_cov_v;
+
+      /// Ages.
+      std::vector<int>                  m_age_v;
+
+      /// No measurement counts.
+      std::vector<int>                  m_noMeasCount_v;
+
+      /// Normalized innovations squared.
+      std::vector<double>               m_nis_v;
+
+      /// Status.
+      std::vector<unsigned char>        m_status_v;
+
+      /// Common data
+      CKF3DStereoPointCommon *          m_commonData_p;
+   };
+
+}
+
+#endif // __KF3DSTEREOPOINTBANK_H
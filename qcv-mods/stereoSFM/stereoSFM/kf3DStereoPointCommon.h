@@ -58,6 +58,7 @@ namespace QCV
    {
    /// Friend Class
       friend class CKF3DStereoPoint;
+      friend class CKF3DStereoPointBank;
 
    /// Constructors/Destructor
    public:
@@ -0,0 +1,246 @@
+/*
+ * Copyright (C) 2015 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of StereoSFM
+ *
+ * StereoSFM is under the terms of the GNU General Public License v2.
+ * See the GNU GPL version 2.0 for details.
+ * StereoSFM uses dual licensing. Contact the author to get information
+ * for a commercial/proprietary license.
+ *
+ * StereoSFM is distributed "AS IS" without ANY WARRANTY, without even 
+ * the implied warranty of merchantability or fitness for a particular
+ * purpose.
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+/*
+
+This project is an implementation of the method presented in the paper:
+
+Hernan Badino and Takeo Kanade. A Head-Wearable Short-Baseline Stereo System for the Simultaneous Estimation of Structure and Motion. In IAPR Conference on Machine Vision Applications (MVA), Nara, Japan, June 2011.
+*/
+
+/*@@@**************************************************************************
+ * \file  stereoEgoMotionCost
+ * \author Hernan Badino
+ * \notes 
+ ******************************************************************************/
+
+/* INCLUDES */
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <limits>
+
+#include "stereoEgoMotionCost.h"
+
+using namespace QCV;
+
+/// Rotation matrix R of the rotation vector f_axis_p (axis scaled by the
+/// angle) and matrix M such that d(R p)/d(axis) = -R [p]x M, with [p]x
+/// the cross product matrix of p. See G. Gallego and A. Yezzi, "A compact
+/// formula for the derivative of a 3-D rotation in exponential
+/// coordinates", 2015.
+static void
+rotationAndDerivative ( const double * f_axis_p,
+                        C3DMatrix &    fr_rotation,
+                        C3DMatrix &    fr_m )
+{
+   C3DVector axis ( f_axis_p[0],
+                    f_axis_p[1],
+                    f_axis_p[2] );
+
+   const double sqAngle_d = axis.sumOfSquares();
+   
+   fr_rotation.loadIdentity();
+   fr_m.loadIdentity();
+
+   if ( !sqAngle_d )
+      return;
+
+   const double angle_d = sqrt(sqAngle_d);
+
+   fr_rotation.rotateAxis ( axis / angle_d, angle_d );
+
+   /// For very small angles R ~ I and M ~ I.
+   if ( angle_d < 1.e-7 )
+      return;
+
+   const double skew_p[9] = {         0., -axis.z(),  axis.y(),
+                               axis.z(),         0., -axis.x(),
+                              -axis.y(),  axis.x(),         0. };
+   C3DMatrix skew ( skew_p );
+
+   C3DMatrix rtMinusI = fr_rotation.getTranspose();
+   rtMinusI.at(0,0) -= 1.;
+   rtMinusI.at(1,1) -= 1.;
+   rtMinusI.at(2,2) -= 1.;
+
+   fr_m = rtMinusI * skew;
+
+   for (int i = 0; i < 3; ++i)
+      for (int j = 0; j < 3; ++j)
+         fr_m.at(i,j) = (fr_m.at(i,j) + axis.at(i) * axis.at(j)) / sqAngle_d;
+}
+
+CStereoEgoMotionCost::CStereoEgoMotionCost ( const CStereoCamera &          f_camera,
+                                             const CFeatureVector &         f_currFeatures,
+                                             const std::vector<C3DVector> & f_prev3D_v,
+                                             const std::vector<double> &    f_weight_v )
+   : m_camera (                f_camera ),
+     m_currFeatures (    f_currFeatures ),
+     m_prev3D_v (            f_prev3D_v ),
+     m_weight_v (            f_weight_v )
+{
+}
+
+double CStereoEgoMotionCost::operator () ( const double *f_params_p, int  ) const
+{
+   const CFeatureVector &curr = m_currFeatures;
+
+   double residuum_f = 0;
+   C3DMatrix m;
+   m.loadIdentity();
+
+   C3DVector t ( f_params_p[3],
+                 f_params_p[4],
+                 f_params_p[5] );
+    
+   C3DVector axis (  f_params_p[0], 
+                     f_params_p[1], 
+                     f_params_p[2] );
+
+   double angle_d = axis.magnitude();
+
+   if ( angle_d )
+   {
+      axis /= angle_d;
+      m.rotateAxis ( axis, angle_d );
+   }
+
+   double count_d = 0.;
+
+   const std::vector<double> &u_v = curr.getU();
+   const std::vector<double> &v_v = curr.getV();
+   const std::vector<double> &d_v = curr.getD();
+
+   for (int i = 0 ; i < (int)curr.size(); ++i)
+   {
+      C3DVector w2;
+      C3DVector w3 ( u_v[i], v_v[i], d_v[i] );
+
+      C3DVector p2 = m * m_prev3D_v[i] + t;
+        
+      if ( m_camera.local2Image ( p2,
+                                  w2 ) )
+      {
+         C3DVector diff = w2-w3;
+           
+         double sqDist_f = diff.sumOfSquares();
+         count_d    += m_weight_v[i];
+         residuum_f += sqDist_f * m_weight_v[i];
+      }
+   }
+
+   return residuum_f / count_d;
+}
+
+double 
+CStereoEgoMotionCost::computeNormalEquations ( const double * f_state_p,
+                                               double *       fr_jtr_p,
+                                               double *       fr_jtj_p,
+                                               const int      f_n_i ) const
+{
+   const CFeatureVector &curr = m_currFeatures;
+   const int             n_i  = std::min(f_n_i, 6);
+
+   memset(fr_jtr_p, 0, sizeof(double) * f_n_i);
+   memset(fr_jtj_p, 0, sizeof(double) * f_n_i * f_n_i);
+
+   C3DMatrix rotation, m;
+   rotationAndDerivative ( f_state_p, rotation, m );
+
+   C3DVector t ( f_state_p[3],
+                 f_state_p[4],
+                 f_state_p[5] );
+
+   double residuum_d = 0.;
+   double count_d    = 0.;
+
+   const std::vector<double> &u_v = curr.getU();
+   const std::vector<double> &v_v = curr.getV();
+   const std::vector<double> &d_v = curr.getD();
+
+   for (int i = 0 ; i < (int)curr.size(); ++i)
+   {
+      const C3DVector & p = m_prev3D_v[i];
+
+      C3DVector w2;
+      C3DVector w3 ( u_v[i], v_v[i], d_v[i] );
+      C3DMatrix jProj;
+
+      if ( !m_camera.local2Image ( rotation * p + t,
+                                   w2,
+                                   jProj ) )
+         continue;
+
+      const C3DVector diff     = w2-w3;
+      const double    weight_d = m_weight_v[i];
+
+      count_d    += weight_d;
+      residuum_d += diff.sumOfSquares() * weight_d;
+
+      /// Jacobian of the projection with respect to the state:
+      /// J = Jproj [ -R [p]x M | I ]
+      const double skew_p[9] = {       0., -p.z(),  p.y(),
+                                   p.z(),       0., -p.x(),
+                                  -p.y(),  p.x(),       0. };
+
+      const C3DMatrix jRot = (jProj * rotation) * C3DMatrix ( skew_p ) * m;
+
+      double j_p[3][6];
+
+      for (int r = 0; r < 3; ++r)
+      {
+         for (int c = 0; c < 3; ++c)
+         {
+            j_p[r][c]   = -jRot.at(r,c);
+            j_p[r][c+3] = jProj.at(r,c);
+         }
+      }
+
+      for (int a = 0; a < n_i; ++a)
+      {
+         fr_jtr_p[a] += weight_d * ( j_p[0][a] * diff.x() + 
+                                     j_p[1][a] * diff.y() + 
+                                     j_p[2][a] * diff.z() );
+
+         for (int b = a; b < n_i; ++b)
+            fr_jtj_p[a*f_n_i+b] += weight_d * ( j_p[0][a] * j_p[0][b] + 
+                                                j_p[1][a] * j_p[1][b] + 
+                                                j_p[2][a] * j_p[2][b] );
+      }
+   }
+
+   if ( !count_d )
+      return std::numeric_limits<double>::max();
+
+   for (int a = 0; a < n_i; ++a)
+   {
+      fr_jtr_p[a] /= count_d;
+
+      for (int b = a; b < n_i; ++b)
+         fr_jtj_p[b*f_n_i+a] = fr_jtj_p[a*f_n_i+b] /= count_d;
+   }
+
+   return residuum_d / count_d;
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2015 Hernan Badino <hernan.badino@gmail.com>
+ *
+ * This file is part of StereoSFM
+ *
+ * StereoSFM is under the terms of the GNU General Public License v2.
+ * See the GNU GPL version 2.0 for details.
+ * StereoSFM uses dual licensing. Contact the author to get information
+ * for a commercial/proprietary license.
+ *
+ * StereoSFM is distributed "AS IS" without ANY WARRANTY, without even 
+ * the implied warranty of merchantability or fitness for a particular
+ * purpose.
+ *
+ * In no event shall the authors or contributors be liable
+ * for any direct, indirect, incidental, special, exemplary, or
+ * consequential damages arising in any way out of the use of this
+ * software.
+ *
+ * By downloading, copying, installing or using the software you agree
+ * to this license. Do not download, install, copy or use the
+ * software, if you do not agree to this license.
+ */
+
+/*
+
+This project is an implementation of the method presented in the paper:
+
+Hernan Badino and Takeo Kanade. A Head-Wearable Short-Baseline Stereo System for the Simultaneous Estimation of Structure and Motion. In IAPR Conference on Machine Vision Applications (MVA), Nara, Japan, June 2011.
+*/
+
+#ifndef __STEREOEGOMOTIONCOST_H
+#define __STEREOEGOMOTIONCOST_H
+
+/**
+*******************************************************************************
+*
+* @file stereoEgoMotionCost.h
+*
+* \class CStereoEgoMotionCost
+* \author Hernan Badino (hernan.badino@gmail.com)
+*
+* \brief Reprojection cost of the ego-motion between two stereo frames.
+*
+* The state is the motion (rotation axis scaled by the rotation angle and
+* translation) transforming the 3D points of the previous frame into the
+* current frame. The cost is the weighted mean of the squared differences 
+* between the projections (u, v, d) of the transformed points and the 
+* current features. 
+*
+* The cost can be minimized with NumericalSolver::solveByNewton (numerical
+* derivatives) or with NumericalSolver::solveByLevenbergMarquardt 
+* (analytic Jacobian).
+*
+*******************************************************************************/
+
+/* INCLUDES */
+#include <vector>
+
+#include "feature.h"
+#include "3DMatrix.h"
+#include "3DRowVector.h"
+#include "stereoCamera.h"
+
+/* CONSTANTS */
+
+namespace QCV
+{
+   class CStereoEgoMotionCost
+   {
+   /// Constructors/Destructor
+   public:
+      /// The vectors are referenced, not copied.
+      CStereoEgoMotionCost ( const CStereoCamera &          f_camera,
+                             const CFeatureVector &         f_currFeatures,
+                             const std::vector<C3DVector> & f_prev3D_v,
+                             const std::vector<double> &    f_weight_v );
+
+   /// Cost evaluation.
+   public:
+      /// Cost function for NumericalSolver::solveByNewton.
+      double operator() ( const double *f_params_p, int ) const;
+
+      /// Normal equations for NumericalSolver::solveByLevenbergMarquardt.
+      double computeNormalEquations ( const double * f_state_p,
+                                      double *       fr_jtr_p,
+                                      double *       fr_jtj_p,
+                                      const int      f_n_i ) const;
+
+   /// Private members
+   private:
+      /// Stereo camera.
+      const CStereoCamera &             m_camera;
+
+      /// Current features.
+      const CFeatureVector &            m_currFeatures;
+
+      /// 3D position of the features in the previous frame.
+      const std::vector<C3DVector> &    m_prev3D_v;
+
+      /// Weights of the features.
+      const std::vector<double> &       m_weight_v;
+   };
+}
+
+#endif // __STEREOEGOMOTIONCOST_H
@@ -88,6 +88,7 @@ CStereoEgoMotionOp::CStereoEgoMotionOp ( COperator * const f_parent_p,
      m_varTolerance_f (                                  16.f ),
      m_tolerance_f (                                   1.e-5f ),
      m_forceReevaluation_b (                             true ),
+     m_analyticJacobian_b (                              true ),
      m_minPoints_i (                                       12 ),
      m_transCompStep_f (                                 0.01 ),
      m_rotCompStep_f (                                 0.0015 ),
@@ -96,7 +97,7 @@ CStereoEgoMotionOp::CStereoEgoMotionOp ( COperator * const f_parent_p,
      m_cIdx_i (                                             1 ),
      m_predRotAxis (                                  0, 0, 0 ),
      m_predTrans (                                    0, 0, 0 ),
-     m_trackHistoryACTUAL_v (                               2 ),
+     m_featureHistory (                                     2 ),
      m_trackHistory_v (                                     2 ),
      m_colorEnc ( CColorEncoding::CET_HUE,S2D<float>(0.f,5.f) ),
      m_inclDispInColorEnc_b (                            true ),
@@ -221,6 +222,14 @@ CStereoEgoMotionOp::registerParameters()
                        ForceReevaluation, 
                        CStereoEgoMotionOp );
       
+   ADD_BOOL_PARAMETER( "Analytic Jacobian", 
+                       "Minimize with Levenberg-Marquardt and analytic derivatives "
+                       "instead of Newton with numerical derivatives.",
+                       m_analyticJacobian_b,
+                       this,
+                       AnalyticJacobian, 
+                       CStereoEgoMotionOp );
+      
    ADD_FLOAT_PARAMETER( "Initial Sigma Tolerance",
                         "Sigma tolerance to use for initial feature selection [px]",
                         m_initialSigmaTol_f,
@@ -386,39 +395,40 @@ bool CStereoEgoMotionOp::cycle()
       m_pIdx_i = m_cIdx_i;
       m_cIdx_i++; m_cIdx_i %= 2;
         
-      m_trackHistoryACTUAL_v[m_cIdx_i] = *featureVector_p;
+      m_featureHistory.push ( *featureVector_p );
 
-      if ( m_trackHistoryACTUAL_v[m_cIdx_i].size() == m_trackHistoryACTUAL_v[m_pIdx_i].size() )
+      CFeatureVector &       currVec = m_featureHistory[0];
+      const CFeatureVector & prevVec = m_featureHistory[1];
+
+      if ( currVec.size() == prevVec.size() )
       {
          m_trackHistory_v[m_cIdx_i].clear();
          m_trackHistory_v[m_pIdx_i].clear();
          m_trackPrev3D_v.clear();
          m_weightACTUAL.clear();
            
-         for (int i = 0; i < (signed)m_trackHistoryACTUAL_v[m_cIdx_i].size(); ++i)
+         /// Only the new and tracked features of the current frame are used.
+         for (int i = currVec.firstLive(); i < (signed)currVec.size(); i = currVec.nextLive(i))
          {
-            if ( ( m_trackHistoryACTUAL_v[m_cIdx_i][i].state == SFeature::FS_TRACKED ||
-                   m_trackHistoryACTUAL_v[m_cIdx_i][i].state == SFeature::FS_NEW ) &&
-                 m_trackHistoryACTUAL_v[m_pIdx_i][i].state == SFeature::FS_LOST )
+            if ( prevVec.getState()[i] == SFeature::FS_LOST )
             {
-               m_trackHistoryACTUAL_v[m_cIdx_i][i].state =  SFeature::FS_NEW;
-               m_trackHistoryACTUAL_v[m_cIdx_i][i].t = 0;
+               currVec[i].state =  SFeature::FS_NEW;
+               currVec[i].t = 0;
             }
             else   
-               if ( m_trackHistoryACTUAL_v[m_cIdx_i][i].state == SFeature::FS_TRACKED &&
-                    ( m_trackHistoryACTUAL_v[m_pIdx_i][i].state == SFeature::FS_TRACKED ||
-                      m_trackHistoryACTUAL_v[m_pIdx_i][i].state == SFeature::FS_NEW ) && 
-                    m_trackHistoryACTUAL_v[m_pIdx_i][i].d > minDisparity_f )
+               if ( currVec.getState()[i] == SFeature::FS_TRACKED &&
+                    prevVec.isLive(i) && 
+                    prevVec.getD()[i] > minDisparity_f )
                {
                   C3DVector c3d;
-                  const SFeature &curr = m_trackHistoryACTUAL_v[m_cIdx_i][i];
+                  const SFeature &curr = currVec[i];
                   if (curr.t >= 1 && curr.d > minDisparity_f &&
                       m_camera.image2Local ( curr.u,
                                              curr.v,
                                              curr.d,
                                              c3d ) )
                   {
-                     const SFeature &prev = m_trackHistoryACTUAL_v[m_pIdx_i][i];
+                     const SFeature &prev = prevVec[i];
                      
                      C3DVector p3d;
                      if ( m_camera.image2Local ( prev.u,
@@ -526,18 +536,32 @@ bool CStereoEgoMotionOp::cycle()
                             ( (newSigmaTol_d > maxSigma_d ) ||
                               (it < 2 && m_forceReevaluation_b ) ) ); ++it)
             {
-               startClock("Newton minimization");
-
-               ret_d = NumericalSolver::solveByNewton ( x_p, 
-                                                        gradient_p, 
-                                                        hesse_p,
-                                                        steps_p,
-                                                        6, 6,
-                                                        m_maxMinIters_i,
-                                                        m_tolerance_f,
-                                                        *this);
+               startClock("Minimization");
+
+               CStereoEgoMotionCost cost ( m_camera,
+                                           m_selectedFeaturesCurr,
+                                           m_selectedPrev3D_v,
+                                           m_weight );
+
+               if ( m_analyticJacobian_b )
+                  ret_d = NumericalSolver::solveByLevenbergMarquardt ( x_p, 
+                                                                       gradient_p, 
+                                                                       hesse_p,
+                                                                       6, 6,
+                                                                       m_maxMinIters_i,
+                                                                       m_tolerance_f,
+                                                                       cost );
+               else
+                  ret_d = NumericalSolver::solveByNewton ( x_p, 
+                                                           gradient_p, 
+                                                           hesse_p,
+                                                           steps_p,
+                                                           6, 6,
+                                                           m_maxMinIters_i,
+                                                           m_tolerance_f,
+                                                           cost );
 
-               stopClock("Newton minimization");
+               stopClock("Minimization");
 
                newSigmaTol_d = m_varTolerance_f * ret_d;
 
@@ -939,8 +963,7 @@ CStereoEgoMotionOp::initialize()
    m_intRotation.loadIdentity();
    m_intTranslation.clear();
     
-   m_trackHistoryACTUAL_v.clear();
-   m_trackHistoryACTUAL_v.resize ( 2 );
+   m_featureHistory.clear();
    m_trackHistory_v.clear();
    m_trackHistory_v.resize       ( 2 );
 
@@ -966,52 +989,14 @@ CStereoEgoMotionOp::keyPressed ( CKeyEvent * f_event_p )
    return COperator::keyPressed ( f_event_p );    
 }
 
-double CStereoEgoMotionOp::operator () ( const double *f_params_p, int  ) const
+double CStereoEgoMotionOp::operator () ( const double *f_params_p, int f_n_i ) const
 {
-   const CFeatureVector &curr = m_selectedFeaturesCurr;
-
-   double residuum_f = 0;
-   C3DMatrix m;
-   m.loadIdentity();
-
-   C3DVector t ( f_params_p[3],
-                 f_params_p[4],
-                 f_params_p[5] );
-    
-   C3DVector axis (  f_params_p[0], 
-                     f_params_p[1], 
-                     f_params_p[2] );
-
-   double angle_d = axis.magnitude();
-
-   if ( angle_d )
-   {
-      axis /= angle_d;
-      m.rotateAxis ( axis, angle_d );
-   }
-
-   double count_d = 0.;
-
-   for (int i = 0 ; i < (int)curr.size(); ++i)
-   {
-      //C3DVector w1 ( prev[i].u, prev[i].v, prev[i].d );
-      C3DVector w2;
-      C3DVector w3 ( curr[i].u, curr[i].v, curr[i].d );
-
-      C3DVector p2 = m * m_selectedPrev3D_v[i] + t;
-        
-      if ( m_camera.local2Image ( p2,
-                                  w2 ) )
-      {
-         C3DVector diff = w2-w3;
-           
-         double sqDist_f = diff.sumOfSquares();
-         count_d    += m_weight[i];
-         residuum_f += sqDist_f * m_weight[i];
-      }
-   }
+   CStereoEgoMotionCost cost ( m_camera,
+                               m_selectedFeaturesCurr,
+                               m_selectedPrev3D_v,
+                               m_weight );
 
-   return residuum_f / count_d;
+   return cost ( f_params_p, f_n_i );
 }
 
 
@@ -58,6 +58,7 @@ Hernan Badino and Takeo Kanade. A Head-Wearable Short-Baseline Stereo System for
 #include "colorEncoding.h"
 #include "rigidMotion.h"
 #include "numericalSolver.h"
+#include "stereoEgoMotionCost.h"
 #include "stereoCamera.h"
 
 /* PROTOTYPES */
@@ -128,6 +129,7 @@ namespace QCV
 
       ADD_PARAM_ACCESS (bool,          m_showOutliers_b,        ShowOutliers );
       ADD_PARAM_ACCESS (bool,          m_forceReevaluation_b,   ForceReevaluation );
+      ADD_PARAM_ACCESS (bool,          m_analyticJacobian_b,    AnalyticJacobian );
 
       ADD_PARAM_ACCESS(int,            m_minPoints_i,           MinPoints );
 
@@ -200,6 +202,10 @@ namespace QCV
       /// Force one reevaluation in the optimization step.
       bool                              m_forceReevaluation_b;
 
+      /// Minimize with Levenberg-Marquardt and analytic derivatives
+      /// instead of Newton with numerical derivatives.
+      bool                              m_analyticJacobian_b;
+
       /// Minimum amount of points for computation.
       int                               m_minPoints_i;
 
@@ -230,8 +236,8 @@ namespace QCV
       /// Output of the operator
       SRigidMotion                      m_integratedMotion;
 
-      /// previous feature vector.
-      std::vector<CFeatureVector>       m_trackHistoryACTUAL_v;
+      /// Input feature vectors of the current and previous frames.
+      CFeatureHistory                   m_featureHistory;
 
       /// previous feature vector.
       std::vector<CFeatureVector>       m_trackHistory_v;